@@ -1538,6 +1538,15 @@ DVZ_FRONT_FACE_COUNTER_CLOCKWISE = DvzFrontFace.DVZ_FRONT_FACE_COUNTER_CLOCKWISE
 DVZ_FRONT_FACE_CLOCKWISE = DvzFrontFace.DVZ_FRONT_FACE_CLOCKWISE
 
 
+class DvzGeometryDescFlags(CtypesEnum):
+    DVZ_GEOMETRY_DESC_NONE = 0
+    DVZ_GEOMETRY_DESC_F32 = 1
+
+
+DVZ_GEOMETRY_DESC_NONE = DvzGeometryDescFlags.DVZ_GEOMETRY_DESC_NONE
+DVZ_GEOMETRY_DESC_F32 = DvzGeometryDescFlags.DVZ_GEOMETRY_DESC_F32
+
+
 class DvzGeometryEdgeFlags(CtypesEnum):
     DVZ_GEOMETRY_EDGE_NONE = 0
     DVZ_GEOMETRY_EDGE_BOUNDARY = 1
@@ -1562,6 +1571,15 @@ DVZ_GEOMETRY_INDEXING_SURFACE_GRID = DvzGeometryIndexingFlags.DVZ_GEOMETRY_INDEX
 DVZ_GEOMETRY_INDEXING_TRIANGULATION = DvzGeometryIndexingFlags.DVZ_GEOMETRY_INDEXING_TRIANGULATION
 
 
+class DvzGeometryPrecision(CtypesEnum):
+    DVZ_GEOMETRY_PRECISION_F64 = 0
+    DVZ_GEOMETRY_PRECISION_F32 = 1
+
+
+DVZ_GEOMETRY_PRECISION_F64 = DvzGeometryPrecision.DVZ_GEOMETRY_PRECISION_F64
+DVZ_GEOMETRY_PRECISION_F32 = DvzGeometryPrecision.DVZ_GEOMETRY_PRECISION_F32
+
+
 class DvzGeometryType(CtypesEnum):
     DVZ_GEOMETRY_NONE = 0
     DVZ_GEOMETRY_CUSTOM = 1
@@ -3331,6 +3349,17 @@ DVZ_VIDEO_MUX_MP4_STREAMING = DvzVideoMux.DVZ_VIDEO_MUX_MP4_STREAMING
 DVZ_VIDEO_MUX_MP4_POST = DvzVideoMux.DVZ_VIDEO_MUX_MP4_POST
 
 
+class DvzVideoQueuePolicy(CtypesEnum):
+    DVZ_VIDEO_QUEUE_BLOCK = 0
+    DVZ_VIDEO_QUEUE_DROP_NEWEST = 1
+    DVZ_VIDEO_QUEUE_DROP_OLDEST = 2
+
+
+DVZ_VIDEO_QUEUE_BLOCK = DvzVideoQueuePolicy.DVZ_VIDEO_QUEUE_BLOCK
+DVZ_VIDEO_QUEUE_DROP_NEWEST = DvzVideoQueuePolicy.DVZ_VIDEO_QUEUE_DROP_NEWEST
+DVZ_VIDEO_QUEUE_DROP_OLDEST = DvzVideoQueuePolicy.DVZ_VIDEO_QUEUE_DROP_OLDEST
+
+
 class DvzViewKind(CtypesEnum):
     DVZ_VIEW_OFFSCREEN = 0
     DVZ_VIEW_WINDOW = 1
@@ -3726,6 +3755,14 @@ class DvzDepthCueDesc(ctypes.Structure):
     pass
 
 
+class DvzDescriptorAllocator(ctypes.Structure):
+    pass
+
+
+class DvzDescriptorAllocatorStats(ctypes.Structure):
+    pass
+
+
 class DvzDescriptors(ctypes.Structure):
     pass
 
@@ -4214,6 +4251,10 @@ class DvzMaterialDesc(ctypes.Structure):
     pass
 
 
+class DvzMemoryBudget(ctypes.Structure):
+    pass
+
+
 class DvzMsaaDesc(ctypes.Structure):
     pass
 
@@ -4912,6 +4953,7 @@ DvzAppCaptureConfig._fields_ = [
     ('fps', ctypes.c_double),
     ('video_backend', ctypes.c_char_p),
     ('video_capture_mode', ctypes.c_int),
+    ('video_queue_depth', ctypes.c_uint32),
 ]
 
 
@@ -5252,6 +5294,16 @@ DvzDepthCueDesc._fields_ = [
 ]
 
 
+DvzDescriptorAllocatorStats._fields_ = [
+    ('layout_count', ctypes.c_uint32),
+    ('pool_count', ctypes.c_uint32),
+    ('live_groups', ctypes.c_uint64),
+    ('free_groups', ctypes.c_uint64),
+    ('allocations', ctypes.c_uint64),
+    ('recycled', ctypes.c_uint64),
+]
+
+
 DvzDeviceQueueRequest._fields_ = [
     ('family', ctypes.c_uint32),
     ('count', ctypes.c_uint32),
@@ -5695,6 +5747,7 @@ DvzGeometryObjDesc._fields_ = [
     ('struct_size', ctypes.c_uint32),
     ('flags', ctypes.c_uint32),
     ('color', DvzColor),
+    ('cache_path', ctypes.c_char_p),
 ]
 
 
@@ -6238,6 +6291,14 @@ DvzMaterialDesc._fields_ = [
 ]
 
 
+DvzMemoryBudget._fields_ = [
+    ('device_usage', ctypes.c_uint64),
+    ('device_budget', ctypes.c_uint64),
+    ('host_usage', ctypes.c_uint64),
+    ('host_budget', ctypes.c_uint64),
+]
+
+
 DvzMsaaDesc._fields_ = [
     ('struct_size', ctypes.c_uint32),
     ('flags', ctypes.c_uint32),
@@ -7121,6 +7182,9 @@ DvzVideoSinkConfig._fields_ = [
     ('capture_rgba', DvzVideoSinkCaptureFn),
     ('release_rgba', DvzVideoSinkReleaseFn),
     ('capture_user_data', ctypes.c_void_p),
+    ('flush_rgba', DvzVideoSinkCaptureFn),
+    ('queue_depth', ctypes.c_uint32),
+    ('queue_policy', ctypes.c_int),
 ]
 
 
@@ -7457,6 +7521,25 @@ else:
     dvz_allocation_size.restype = ctypes.c_uint64
 
 
+try:
+    dvz_allocator_budget = dvz.dvz_allocator_budget
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_allocator_budget')
+else:
+    dvz_allocator_budget.__doc__ = """/**
+ * Query the current memory usage and budget of an allocator, summed per heap class.
+ *
+ * The allocator is created with VK_EXT_memory_budget support when the device exposes it; without
+ * the extension, VMA estimates the budget from the heap sizes and tracks its own allocations.
+ *
+ * @param allocator the allocator
+ * @param[out] budget usage and budget of the device-local heaps and of the other heaps
+ * @return 0 on success, non-zero when the allocator is not initialized
+ */"""
+    dvz_allocator_budget.argtypes = [ctypes.POINTER(DvzVma), ctypes.POINTER(DvzMemoryBudget)]
+    dvz_allocator_budget.restype = ctypes.c_int
+
+
 try:
     dvz_allocator_buffer = dvz.dvz_allocator_buffer
 except AttributeError:
@@ -11230,6 +11313,27 @@ else:
     dvz_cmd_submit.restype = None
 
 
+try:
+    dvz_cmd_submit_async = dvz.dvz_cmd_submit_async
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_cmd_submit_async')
+else:
+    dvz_cmd_submit_async.__doc__ = """/**
+ * Submit a command buffer on its queue without waiting for completion.
+ *
+ * The submission signals `signal_value` on the timeline semaphore once the command buffer has
+ * completed. The caller must keep the command buffer, and every resource it references, alive
+ * until the semaphore reaches that value.
+ *
+ * @param cmds the set of command buffers
+ * @param timeline the timeline semaphore to signal
+ * @param signal_value the timeline value to signal on completion
+ * @return 0 on success, non-zero on Vulkan or state failure
+ */"""
+    dvz_cmd_submit_async.argtypes = [ctypes.POINTER(DvzCommands), ctypes.POINTER(DvzSemaphore), ctypes.c_uint64]
+    dvz_cmd_submit_async.restype = ctypes.c_int
+
+
 try:
     dvz_cmd_submit_result = dvz.dvz_cmd_submit_result
 except AttributeError:
@@ -12293,6 +12397,75 @@ else:
     dvz_depth_cue_desc.restype = DvzDepthCueDesc
 
 
+try:
+    dvz_descriptor_allocator = dvz.dvz_descriptor_allocator
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_descriptor_allocator')
+else:
+    dvz_descriptor_allocator.__doc__ = """/**
+ * Create a growable descriptor allocator.
+ *
+ * The allocator keeps one chain of descriptor pools per slots object. Each chain is sized from
+ * the slots bindings, grows by appending larger pools instead of failing when a pool is
+ * exhausted, and recycles the sets of freed wrappers for later allocations with the same slots.
+ *
+ * @param device the device
+ * @return owned allocator, or NULL on allocation failure
+ */"""
+    dvz_descriptor_allocator.argtypes = [ctypes.POINTER(DvzDevice)]
+    dvz_descriptor_allocator.restype = ctypes.POINTER(DvzDescriptorAllocator)
+
+
+try:
+    dvz_descriptor_allocator_destroy = dvz.dvz_descriptor_allocator_destroy
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_descriptor_allocator_destroy')
+else:
+    dvz_descriptor_allocator_destroy.__doc__ = """/**
+ * Destroy a descriptor allocator and all its pools.
+ *
+ * Every wrapper allocated from the allocator must be freed first.
+ *
+ * @param allocator the descriptor allocator
+ */"""
+    dvz_descriptor_allocator_destroy.argtypes = [ctypes.POINTER(DvzDescriptorAllocator)]
+    dvz_descriptor_allocator_destroy.restype = None
+
+
+try:
+    dvz_descriptor_allocator_release = dvz.dvz_descriptor_allocator_release
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_descriptor_allocator_release')
+else:
+    dvz_descriptor_allocator_release.__doc__ = """/**
+ * Release the pool chain of a slots object before the slots are destroyed.
+ *
+ * Recycled sets are dropped immediately. Pools still backing live wrappers are destroyed when
+ * the last of these wrappers is freed. A later allocation with the same slots pointer starts a
+ * new chain.
+ *
+ * @param allocator the descriptor allocator
+ * @param slots the slots about to be destroyed
+ */"""
+    dvz_descriptor_allocator_release.argtypes = [ctypes.POINTER(DvzDescriptorAllocator), ctypes.POINTER(DvzSlots)]
+    dvz_descriptor_allocator_release.restype = None
+
+
+try:
+    dvz_descriptor_allocator_stats = dvz.dvz_descriptor_allocator_stats
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_descriptor_allocator_stats')
+else:
+    dvz_descriptor_allocator_stats.__doc__ = """/**
+ * Return descriptor allocator counters.
+ *
+ * @param allocator the descriptor allocator
+ * @return the allocator statistics
+ */"""
+    dvz_descriptor_allocator_stats.argtypes = [ctypes.POINTER(DvzDescriptorAllocator)]
+    dvz_descriptor_allocator_stats.restype = DvzDescriptorAllocatorStats
+
+
 try:
     dvz_descriptors = dvz.dvz_descriptors
 except AttributeError:
@@ -12362,7 +12535,8 @@ else:
  * Free a descriptor wrapper allocated by dvz_descriptors_create().
  *
  * This releases the CPU-side wrapper and returns its Vulkan descriptor sets to the parent
- * device-owned descriptor pool. The wrapper must be freed before the parent device is destroyed.
+ * device-owned descriptor pool, or to the allocator free list for dvz_descriptors_pooled()
+ * wrappers. The wrapper must be freed before the parent device is destroyed.
  *
  * @param descriptors descriptor wrapper to free
  */"""
@@ -12406,6 +12580,27 @@ else:
     dvz_descriptors_image.restype = None
 
 
+try:
+    dvz_descriptors_pooled = dvz.dvz_descriptors_pooled
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_descriptors_pooled')
+else:
+    dvz_descriptors_pooled.__doc__ = """/**
+ * Allocate descriptors from a growable allocator.
+ *
+ * Like dvz_descriptors(), the wrapper must be fresh. dvz_descriptors_free() hands the sets back
+ * to the allocator free list instead of the device pool, so the caller must only free the
+ * wrapper once the GPU no longer uses its sets.
+ *
+ * @param allocator the descriptor allocator
+ * @param slots the slots
+ * @param[out] descriptors the created descriptors
+ * @return 0 on success, nonzero on failure
+ */"""
+    dvz_descriptors_pooled.argtypes = [ctypes.POINTER(DvzDescriptorAllocator), ctypes.POINTER(DvzSlots), ctypes.POINTER(DvzDescriptors)]
+    dvz_descriptors_pooled.restype = ctypes.c_int
+
+
 try:
     dvz_descriptors_set_count = dvz.dvz_descriptors_set_count
 except AttributeError:
@@ -12503,6 +12698,21 @@ else:
     dvz_device_features10.restype = ctypes.c_void_p
 
 
+try:
+    dvz_device_features12 = dvz.dvz_device_features12
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_device_features12')
+else:
+    dvz_device_features12.__doc__ = """/**
+ * Return the Vulkan 1.2 feature set enabled on this device.
+ *
+ * @param device the device
+ * @return borrowed immutable enabled-feature storage, valid until device destruction
+ */"""
+    dvz_device_features12.argtypes = [ctypes.POINTER(DvzDevice)]
+    dvz_device_features12.restype = ctypes.c_void_p
+
+
 try:
     dvz_device_handle = dvz.dvz_device_handle
 except AttributeError:
@@ -14408,6 +14618,27 @@ else:
     dvz_drp2_stream_end_render_pass.restype = ctypes.c_bool
 
 
+try:
+    dvz_drp2_stream_fingerprint = dvz.dvz_drp2_stream_fingerprint
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_drp2_stream_fingerprint')
+else:
+    dvz_drp2_stream_fingerprint.__doc__ = """/**
+ * Return the fingerprint accumulated while the stream was built.
+ *
+ * Commands are folded as they are appended: each record in packet layout, plus the declared
+ * payload version of writes, or the payload itself for unversioned writes up to 256 bytes.
+ * Larger unversioned payloads are not read; the fingerprint is then reported as unreliable.
+ * `dvz_drp2_packet_fingerprint()` remains the byte-exact variant for debugging.
+ *
+ * @param stream the command stream
+ * @param[out] fingerprint the stream fingerprint
+ * @return false when the stream is NULL or carries a large unversioned payload
+ */"""
+    dvz_drp2_stream_fingerprint.argtypes = [ctypes.POINTER(DvzDrp2CommandStream), ctypes.POINTER(ctypes.c_uint64)]
+    dvz_drp2_stream_fingerprint.restype = ctypes.c_bool
+
+
 try:
     dvz_drp2_stream_finish_command_encoder = dvz.dvz_drp2_stream_finish_command_encoder
 except AttributeError:
@@ -14903,6 +15134,25 @@ else:
     dvz_drp2_stream_set_label.restype = ctypes.c_bool
 
 
+try:
+    dvz_drp2_stream_set_payload_version = dvz.dvz_drp2_stream_set_payload_version
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_drp2_stream_set_payload_version')
+else:
+    dvz_drp2_stream_set_payload_version.__doc__ = """/**
+ * Declare the content version of the most recently appended WriteBuffer or WriteTexture payload.
+ *
+ * Emitters that version their resources set this so that `dvz_drp2_stream_fingerprint()` hashes
+ * the version instead of the payload. Equal versions of a resource must carry equal bytes.
+ *
+ * @param stream the command stream
+ * @param version content version, or 0 to hash the payload
+ * @return whether the most recent command was a write and was updated
+ */"""
+    dvz_drp2_stream_set_payload_version.argtypes = [ctypes.POINTER(DvzDrp2CommandStream), ctypes.c_uint64]
+    dvz_drp2_stream_set_payload_version.restype = ctypes.c_bool
+
+
 try:
     dvz_drp2_stream_set_pipeline = dvz.dvz_drp2_stream_set_pipeline
 except AttributeError:
@@ -17552,6 +17802,10 @@ else:
     dvz_geometry_compute_normals.__doc__ = """/**
  * Recompute smooth vertex normals from triangle indices.
  *
+ * On large meshes the vertex-to-triangle adjacency is built once, cached on the geometry, and
+ * reused while the index buffer is unchanged; normals are then gathered per vertex on a thread
+ * pool created for the call. Results are identical to the serial accumulation.
+ *
  * @param geometry indexed triangle geometry to update; must not be NULL
  * @return DVZ_OK on success, DVZ_ERROR on invalid input
  */"""
@@ -17596,7 +17850,15 @@ else:
     dvz_geometry_contours.__doc__ = """/**
  * Extract contour line segments from indexed triangle geometry and per-vertex scalar values.
  *
- * @param geometry borrowed indexed triangle geometry; must not be NULL
+ * Segments are ordered by triangle, then by level. The cost is proportional to the number of
+ * triangles; with ascending levels, each triangle only visits the levels inside its value range.
+ * Large meshes are processed in triangle blocks on a thread pool created for the call. The
+ * geometry is non-const because its cached topology is refreshed, so calls on the same geometry
+ * must not run concurrently. Neighboring triangles produce bitwise identical endpoints on their
+ * shared edge.
+ *
+ * @param geometry borrowed indexed triangle geometry, whose topology cache may be refreshed; must
+ * not be NULL
  * @param values array containing one scalar per geometry vertex; must not be NULL
  * @param value_count number of values; must equal the geometry vertex count
  * @param levels array of contour levels; must not be NULL
@@ -17753,6 +18015,27 @@ else:
     dvz_geometry_edges_destroy.restype = None
 
 
+try:
+    dvz_geometry_f32 = dvz.dvz_geometry_f32
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_geometry_f32')
+else:
+    dvz_geometry_f32.__doc__ = """/**
+ * Allocate a geometry object with owned single-precision vertex arrays.
+ *
+ * The geometry uses `DVZ_GEOMETRY_PRECISION_F32`: `positions_f32`, `normals_f32`, and
+ * `texcoords_f32` are allocated and the F64 arrays are NULL. This halves the host memory of
+ * positions, normals, and texture coordinates, and `dvz_mesh_set_geometry()` uploads these arrays
+ * without a conversion pass. Destroy it with `dvz_geometry_destroy()`.
+ *
+ * @param vertex_count number of vertices to allocate; may be zero for an empty geometry
+ * @param index_count number of indices to allocate; may be zero for non-indexed geometry
+ * @return new owned geometry, or NULL on invalid input or allocation failure
+ */"""
+    dvz_geometry_f32.argtypes = [ctypes.c_uint32, ctypes.c_uint32]
+    dvz_geometry_f32.restype = ctypes.POINTER(DvzGeometry)
+
+
 try:
     dvz_geometry_merge = dvz.dvz_geometry_merge
 except AttributeError:
@@ -17782,6 +18065,11 @@ else:
  * indices. Faces are triangulated as fans. Missing texture coordinates default to `(0, 0)` and
  * missing normals are computed. Materials, objects, groups, and smoothing records are ignored.
  *
+ * Large files are memory-mapped and parsed in line-aligned chunks on a temporary thread pool.
+ * When `desc->cache_path` is set, the loaded vertex arrays are written to that binary cache file,
+ * keyed by the size and modification time of @p filename, and later loads with the same precision
+ * read the cache instead of parsing the OBJ file.
+ *
  * @param filename OBJ file path; must not be NULL
  * @param desc optional borrowed loader descriptor, or NULL for defaults
  * @return new owned geometry, or NULL on unsupported input, allocation, or I/O failure; destroy
@@ -17907,6 +18195,26 @@ else:
     dvz_geometry_sector_desc.restype = DvzGeometrySectorDesc
 
 
+try:
+    dvz_geometry_set_precision = dvz.dvz_geometry_set_precision
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_geometry_set_precision')
+else:
+    dvz_geometry_set_precision.__doc__ = """/**
+ * Convert the vertex attributes of a geometry to another storage precision in place.
+ *
+ * Positions, normals, and texture coordinates are reallocated in the target precision and the
+ * previous arrays are released, so pointers to them become invalid. Converting to F32 rounds each
+ * value to the nearest float. On failure the geometry is left unchanged.
+ *
+ * @param geometry geometry to convert; must not be NULL
+ * @param precision target storage precision
+ * @return DVZ_OK on success, DVZ_ERROR on invalid input or allocation failure
+ */"""
+    dvz_geometry_set_precision.argtypes = [ctypes.POINTER(DvzGeometry), ctypes.c_int]
+    dvz_geometry_set_precision.restype = ctypes.c_int32
+
+
 try:
     dvz_geometry_sphere = dvz.dvz_geometry_sphere
 except AttributeError:
@@ -22598,6 +22906,30 @@ else:
     dvz_mesh_set_geometry.restype = ctypes.c_int32
 
 
+try:
+    dvz_mesh_set_surface_field = dvz.dvz_mesh_set_surface_field
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_mesh_set_surface_field')
+else:
+    dvz_mesh_set_surface_field.__doc__ = """/**
+ * Drive a mesh visual from a surface grid whose heights live in a sampled field.
+ *
+ * The grid must come from `dvz_geometry_surface_grid()` and the field must be a 2D R32_FLOAT
+ * field of `cols x rows` texels. Positions and normals are computed on the GPU by the returned
+ * scene compute pass, which the caller attaches with `dvz_figure_add_compute()`. Later field
+ * updates only upload the changed rows, so scrolling one row of a large surface costs one row
+ * upload per frame. Calling `dvz_mesh_set_geometry()` leaves this mode.
+ *
+ * @param visual the mesh visual
+ * @param grid the surface grid geometry providing the grid layout, colors, and texcoords
+ * @param heights the 2D R32_FLOAT height field
+ * @param shader_format the compute shader language matching the runtime backend
+ * @return the owned compute pass, or NULL on invalid input
+ */"""
+    dvz_mesh_set_surface_field.argtypes = [ctypes.POINTER(DvzVisual), ctypes.POINTER(DvzGeometry), ctypes.POINTER(DvzSampledField), ctypes.c_int]
+    dvz_mesh_set_surface_field.restype = ctypes.POINTER(DvzSceneCompute)
+
+
 try:
     dvz_min_max = dvz.dvz_min_max
 except AttributeError:
@@ -26273,6 +26605,32 @@ else:
     dvz_sampled_field_set_geometry.restype = ctypes.c_int32
 
 
+try:
+    dvz_sampled_field_set_ring_origin = dvz.dvz_sampled_field_set_ring_origin
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_sampled_field_set_ring_origin')
+else:
+    dvz_sampled_field_set_ring_origin.__doc__ = """/**
+ * Set the physical sample holding the logical origin of a circular field.
+ *
+ * Rolling acquisitions keep a fixed-size field and overwrite the oldest samples in place. Logical
+ * sample `i` along each axis lives at physical sample `(i + origin) % extent`: to append one row,
+ * advance `y` by one and write the last logical row with dvz_sampled_field_update_region(). Image,
+ * textured mesh, and volume shaders, their sample queries, and GPU mesh surfaces honor the origin.
+ * Moving it uploads no sample data. Samplers still clamp in physical space, so linear filtering
+ * does not blend across the ring seam. dvz_sampled_field_set_data() and
+ * dvz_sampled_field_resize() take logical payloads and reset the origin to zero.
+ *
+ * @param field the sampled field
+ * @param x physical column of logical column 0
+ * @param y physical row of logical row 0
+ * @param z physical slice of logical slice 0 (must be 0 for 2D fields)
+ * @return DVZ_OK on success, DVZ_ERROR when the origin is outside the field extent
+ */"""
+    dvz_sampled_field_set_ring_origin.argtypes = [ctypes.POINTER(DvzSampledField), ctypes.c_uint32, ctypes.c_uint32, ctypes.c_uint32]
+    dvz_sampled_field_set_ring_origin.restype = ctypes.c_int32
+
+
 try:
     dvz_sampled_field_update_region = dvz.dvz_sampled_field_update_region
 except AttributeError:
@@ -26283,7 +26641,8 @@ else:
  *
  * `region` must be non-empty and fully inside the current field extent. `view->data` must cover the
  * subregion and is copied before return. This operation is unavailable while the field borrows an
- * external buffer.
+ * external buffer. The region is logical: with a ring origin, it is written at its physical
+ * samples and split where it crosses the ring seam.
  *
  * @param field the sampled field
  * @param region the updated sample-space region
@@ -26986,6 +27345,29 @@ else:
     dvz_scene_buffer_set_data.restype = ctypes.c_int32
 
 
+try:
+    dvz_scene_buffer_update_data = dvz.dvz_scene_buffer_update_data
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_scene_buffer_update_data')
+else:
+    dvz_scene_buffer_update_data.__doc__ = """/**
+ * Overwrite a byte range of a scene-owned buffer resource.
+ *
+ * The buffer must already hold a full payload from `dvz_scene_buffer_set_data()`. The range is
+ * copied before this function returns and must lie inside the buffer and be aligned to its stride.
+ * Only the dirty range is uploaded on the next frame; several updates before that frame coalesce
+ * into their enclosing range.
+ *
+ * @param buffer the buffer
+ * @param byte_offset first byte to overwrite
+ * @param data the packed payload borrowed for the duration of the call
+ * @param byte_size the payload size in bytes
+ * @return DVZ_OK on success, DVZ_ERROR on error
+ */"""
+    dvz_scene_buffer_update_data.argtypes = [ctypes.POINTER(DvzSceneBuffer), ctypes.c_uint64, ctypes.c_void_p, ctypes.c_uint64]
+    dvz_scene_buffer_update_data.restype = ctypes.c_int32
+
+
 try:
     dvz_scene_clock_dt = dvz.dvz_scene_clock_dt
 except AttributeError:
@@ -27466,6 +27848,30 @@ else:
     dvz_scene_set_fps.restype = ctypes.c_int32
 
 
+try:
+    dvz_scene_set_query_latency = dvz.dvz_scene_set_query_latency
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_scene_set_query_latency')
+else:
+    dvz_scene_set_query_latency.__doc__ = """/**
+ * Pipeline query readbacks over several frames instead of waiting for them.
+ *
+ * With a nonzero latency, `dvz_figure_process_queries()` submits queued queries into a ring of
+ * readback buffers and delivers each result `frames` calls later, so the frame does not wait for
+ * the buffer download. Each query still records and submits its own ID render pass, which blocks
+ * until it completes: there is no persistent ID/depth target yet. When the topmost visual misses,
+ * the query is submitted again for the next visual in z-order, adding `frames` calls per fallback.
+ * Results keep their request ids and freshness serials; superseded ones are dropped as usual.
+ * `dvz_panel_query_now_px()` always resolves synchronously.
+ *
+ * @param scene the scene
+ * @param frames the number of frames a query stays in flight, 0 (default) for synchronous
+ * @return 0 on success, -1 when `frames` does not fit the readback ring (at most 3)
+ */"""
+    dvz_scene_set_query_latency.argtypes = [ctypes.POINTER(DvzScene), ctypes.c_uint32]
+    dvz_scene_set_query_latency.restype = ctypes.c_int32
+
+
 try:
     dvz_scene_step_external = dvz.dvz_scene_step_external
 except AttributeError:
@@ -32053,6 +32459,20 @@ else:
     dvz_visual_clear_item_range.restype = ctypes.c_int32
 
 
+try:
+    dvz_visual_clear_region_selection = dvz.dvz_visual_clear_region_selection
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_clear_region_selection')
+else:
+    dvz_visual_clear_region_selection.__doc__ = """/**
+ * Clear the region selection of a visual.
+ *
+ * @param visual the visual
+ */"""
+    dvz_visual_clear_region_selection.argtypes = [ctypes.POINTER(DvzVisual)]
+    dvz_visual_clear_region_selection.restype = None
+
+
 try:
     dvz_visual_clear_transform = dvz.dvz_visual_clear_transform
 except AttributeError:
@@ -32215,6 +32635,170 @@ else:
     dvz_visual_id.restype = ctypes.c_uint64
 
 
+try:
+    dvz_visual_query_lasso = dvz.dvz_visual_query_lasso
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_query_lasso')
+else:
+    dvz_visual_query_lasso.__doc__ = """/**
+ * Select the items inside a lasso polygon with the visual CPU spatial index.
+ *
+ * The polygon is closed implicitly and uses the even-odd rule. Output conventions follow
+ * `dvz_visual_query_rect()`.
+ *
+ * @param visual the visual, with a spatial index enabled
+ * @param polygon polygon vertices as xy pairs in position coordinates
+ * @param vertex_count number of polygon vertices, at least 3
+ * @param out_items output item ids, or NULL
+ * @param capacity number of entries `out_items` can hold
+ * @param out_count output number of selected items
+ * @return 0 on success, -1 on error
+ */"""
+    dvz_visual_query_lasso.argtypes = [ctypes.POINTER(DvzVisual), ctypes.POINTER(ctypes.c_double), ctypes.c_uint32, ctypes.POINTER(ctypes.c_uint64), ctypes.c_uint64, ctypes.POINTER(ctypes.c_uint64)]
+    dvz_visual_query_lasso.restype = ctypes.c_int32
+
+
+try:
+    dvz_visual_query_nearest = dvz.dvz_visual_query_nearest
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_query_nearest')
+else:
+    dvz_visual_query_nearest.__doc__ = """/**
+ * Find the item nearest to a point with the visual CPU spatial index.
+ *
+ * The point and distance use the xy coordinates of the visual positions, which are panel data
+ * coordinates for visuals attached in DATA space. Triangle geometry reports a zero distance for
+ * points inside a triangle and fills `primitive_id` with the triangle index.
+ *
+ * @param visual the visual, with a spatial index enabled
+ * @param point the query point
+ * @param max_distance the largest accepted distance, INFINITY for no limit
+ * @param out_result output result, with status DVZ_QUERY_STATUS_HIT or DVZ_QUERY_STATUS_MISS
+ * @return 0 on success, -1 on error
+ */"""
+    dvz_visual_query_nearest.argtypes = [ctypes.POINTER(DvzVisual), (ctypes.c_double * 2), ctypes.c_double, ctypes.POINTER(DvzQueryResult)]
+    dvz_visual_query_nearest.restype = ctypes.c_int32
+
+
+try:
+    dvz_visual_query_rect = dvz.dvz_visual_query_rect
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_query_rect')
+else:
+    dvz_visual_query_rect.__doc__ = """/**
+ * Select the items inside a rectangle with the visual CPU spatial index.
+ *
+ * Point-like items are selected by position, triangle geometry by triangle centroid. Item ids are
+ * written in increasing order; `out_count` receives the full selection size even when it exceeds
+ * `capacity`, so a first call with a NULL `out_items` sizes the buffer.
+ *
+ * @param visual the visual, with a spatial index enabled
+ * @param min one rectangle corner in position coordinates
+ * @param max the opposite rectangle corner
+ * @param out_items output item ids, or NULL
+ * @param capacity number of entries `out_items` can hold
+ * @param out_count output number of selected items
+ * @return 0 on success, -1 on error
+ */"""
+    dvz_visual_query_rect.argtypes = [ctypes.POINTER(DvzVisual), (ctypes.c_double * 2), (ctypes.c_double * 2), ctypes.POINTER(ctypes.c_uint64), ctypes.c_uint64, ctypes.POINTER(ctypes.c_uint64)]
+    dvz_visual_query_rect.restype = ctypes.c_int32
+
+
+try:
+    dvz_visual_region_selection_count = dvz.dvz_visual_region_selection_count
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_region_selection_count')
+else:
+    dvz_visual_region_selection_count.__doc__ = """/**
+ * Return the number of items in the region selection of a visual.
+ *
+ * @param visual the visual
+ * @return the number of selected items
+ */"""
+    dvz_visual_region_selection_count.argtypes = [ctypes.POINTER(DvzVisual)]
+    dvz_visual_region_selection_count.restype = ctypes.c_uint64
+
+
+try:
+    dvz_visual_region_selection_items = dvz.dvz_visual_region_selection_items
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_region_selection_items')
+else:
+    dvz_visual_region_selection_items.__doc__ = """/**
+ * Copy the selected item ids of a visual in increasing order.
+ *
+ * Output conventions follow `dvz_visual_query_rect()`.
+ *
+ * @param visual the visual
+ * @param out_items output item ids, or NULL
+ * @param capacity number of entries `out_items` can hold
+ * @param out_count output number of selected items
+ * @return 0 on success, -1 on error
+ */"""
+    dvz_visual_region_selection_items.argtypes = [ctypes.POINTER(DvzVisual), ctypes.POINTER(ctypes.c_uint64), ctypes.c_uint64, ctypes.POINTER(ctypes.c_uint64)]
+    dvz_visual_region_selection_items.restype = ctypes.c_int32
+
+
+try:
+    dvz_visual_region_selection_mask = dvz.dvz_visual_region_selection_mask
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_region_selection_mask')
+else:
+    dvz_visual_region_selection_mask.__doc__ = """/**
+ * Return the region selection bitmask of a visual.
+ *
+ * Bit `i % 64` of word `i / 64` is set when item `i` is selected. The mask is owned by the visual
+ * and stays valid until the next selection call on it.
+ *
+ * @param visual the visual
+ * @param out_item_count output number of items the mask covers, or NULL
+ * @return the mask, or NULL before the first selection
+ */"""
+    dvz_visual_region_selection_mask.argtypes = [ctypes.POINTER(DvzVisual), ctypes.POINTER(ctypes.c_uint64)]
+    dvz_visual_region_selection_mask.restype = ctypes.POINTER(ctypes.c_uint64)
+
+
+try:
+    dvz_visual_select_lasso = dvz.dvz_visual_select_lasso
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_select_lasso')
+else:
+    dvz_visual_select_lasso.__doc__ = """/**
+ * Replace the region selection of a visual with the items inside a lasso polygon.
+ *
+ * The polygon is closed implicitly and uses the even-odd rule. When it extends the previous lasso
+ * of the visual by appending vertices, only the items in the added wedge are tested, so a lasso
+ * redrawn on every pointer move costs the area it grew by rather than the whole polygon.
+ *
+ * @param visual a point, pixel, or marker visual
+ * @param polygon polygon vertices as xy pairs in position coordinates
+ * @param vertex_count number of polygon vertices, at least 3
+ * @return 0 on success, -1 on error
+ */"""
+    dvz_visual_select_lasso.argtypes = [ctypes.POINTER(DvzVisual), ctypes.POINTER(ctypes.c_double), ctypes.c_uint32]
+    dvz_visual_select_lasso.restype = ctypes.c_int32
+
+
+try:
+    dvz_visual_select_rect = dvz.dvz_visual_select_rect
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_select_rect')
+else:
+    dvz_visual_select_rect.__doc__ = """/**
+ * Replace the region selection of a visual with the items inside a rectangle.
+ *
+ * The selection is kept as a bitmask with one bit per item, set for the drawn items whose xy
+ * position lies in the rectangle, and read back with `dvz_visual_region_selection_mask()`.
+ *
+ * @param visual a point, pixel, or marker visual
+ * @param min one rectangle corner in position coordinates
+ * @param max the opposite rectangle corner
+ * @return 0 on success, -1 on error
+ */"""
+    dvz_visual_select_rect.argtypes = [ctypes.POINTER(DvzVisual), (ctypes.c_double * 2), (ctypes.c_double * 2)]
+    dvz_visual_select_rect.restype = ctypes.c_int32
+
+
 try:
     dvz_visual_set_alpha_mode = dvz.dvz_visual_set_alpha_mode
 except AttributeError:
@@ -32654,6 +33238,26 @@ else:
     dvz_visual_set_query_capabilities.restype = ctypes.c_int32
 
 
+try:
+    dvz_visual_set_region_selection_runtime = dvz.dvz_visual_set_region_selection_runtime
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_set_region_selection_runtime')
+else:
+    dvz_visual_set_region_selection_runtime.__doc__ = """/**
+ * Run the region selections of a visual as a GPU compute pass.
+ *
+ * The pass uses a private runtime on the device of `runtime`, which may be destroyed afterwards.
+ * Without a runtime, region selections scan the positions on the CPU worker pool of the scene, or
+ * use the visual spatial index when it is enabled.
+ *
+ * @param visual a point, pixel, or marker visual
+ * @param runtime a device-backed runtime, or NULL for the CPU path
+ * @return 0 on success, -1 on error
+ */"""
+    dvz_visual_set_region_selection_runtime.argtypes = [ctypes.POINTER(DvzVisual), ctypes.POINTER(DvzDrp2Runtime)]
+    dvz_visual_set_region_selection_runtime.restype = ctypes.c_int32
+
+
 try:
     dvz_visual_set_scale = dvz.dvz_visual_set_scale
 except AttributeError:
@@ -32728,6 +33332,29 @@ else:
     dvz_visual_set_shader_desc.restype = ctypes.c_int32
 
 
+try:
+    dvz_visual_set_spatial_index = dvz.dvz_visual_set_spatial_index
+except AttributeError:
+    _MISSING_FUNCTIONS.append('dvz_visual_set_spatial_index')
+else:
+    dvz_visual_set_spatial_index.__doc__ = """/**
+ * Enable or disable the CPU spatial index of a visual.
+ *
+ * Point, pixel, and marker visuals are indexed with a uniform grid over their xy positions; mesh
+ * and primitive visuals with triangle topology use a bounding-volume hierarchy over their
+ * triangles. Once enabled, item queries on the visual resolve on the CPU without a GPU query
+ * render and readback, and `dvz_visual_query_nearest()`, `dvz_visual_query_rect()`, and
+ * `dvz_visual_query_lasso()` become available. The index is built on the first query and then
+ * refreshed from the ranges passed to `dvz_visual_set_data_range()`.
+ *
+ * @param visual the visual
+ * @param enabled whether to keep a spatial index for the visual
+ * @return 0 on success, -1 when the visual type has no spatial index
+ */"""
+    dvz_visual_set_spatial_index.argtypes = [ctypes.POINTER(DvzVisual), ctypes.c_bool]
+    dvz_visual_set_spatial_index.restype = ctypes.c_int32
+
+
 try:
     dvz_visual_set_strings = dvz.dvz_visual_set_strings
 except AttributeError:
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* drp2_bind_group_churn - descriptor allocation throughput under bind-group churn.
+ *
+ * Build:  cmake --build build --target example_c_lab_drp2_bind_group_churn
+ * Run:    ./build/examples/c/lab/drp2_bind_group_churn --count 100000 --batch 1000
+ *
+ * Allocates and frees --count uniform descriptor wrappers in batches of --batch, first from the
+ * device-owned descriptor pool, then from the growable recycling allocator. Then creates and
+ * destroys --count DRP2 bind groups through the vklite runtime in streams of --batch bind groups.
+ * Every line reports allocations/s and the pools the allocator ended with.
+ */
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "_runtime.h"
+#include "datoviz/common/functions.h"
+#include "datoviz/drp2.h"
+#include "datoviz/vk/device.h"
+#include "datoviz/vk/gpu_ctx.h"
+#include "datoviz/vklite/descriptors.h"
+#include "datoviz/vklite/slots.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define LAYOUT_ID     1
+#define BUFFER_ID     2
+#define BIND_GROUP_ID 100
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct ChurnConfig
+{
+    uint32_t count;
+    uint32_t batch;
+} ChurnConfig;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Parse an unsigned integer argument.
+ *
+ * @param text argument text
+ * @param value output value
+ * @return whether the argument is a valid 32-bit unsigned integer
+ */
+static bool parse_u32(const char* text, uint32_t* value)
+{
+    char* end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*text == '\0' || end == NULL || *end != '\0' || parsed > UINT32_MAX)
+        return false;
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+
+
+/**
+ * Parse the command line.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param cfg output configuration
+ * @return whether every argument was recognized
+ */
+static bool parse_args(int argc, char** argv, ChurnConfig* cfg)
+{
+    // The device pool holds DVZ_MAX_DESCRIPTOR_SETS sets per descriptor type.
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--count") == 0)
+            ok = parse_u32(argv[++i], &cfg->count) && cfg->count > 0;
+        else if (ok && strcmp(argv[i], "--batch") == 0)
+            ok = parse_u32(argv[++i], &cfg->batch) && cfg->batch > 0 &&
+                 cfg->batch <= DVZ_MAX_DESCRIPTOR_SETS;
+        else
+            ok = false;
+        if (!ok)
+        {
+            fprintf(stderr, "usage: %s [--count N] [--batch N<=1024]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+/**
+ * Report one throughput line.
+ *
+ * @param name configuration name
+ * @param count number of allocations
+ * @param start start timestamp in nanoseconds
+ * @param pools descriptor pools left in the recycling allocator, 0 for the device pool
+ */
+static void report(const char* name, uint32_t count, uint64_t start, uint32_t pools)
+{
+    double seconds = (double)(dvz_time_monotonic_ns() - start) * 1e-9;
+    printf(
+        "%-12s %9.3f s %12.0f allocs/s %4u pools\n", name, seconds,
+        seconds > 0 ? count / seconds : 0.0, pools);
+}
+
+
+
+/**
+ * Allocate and free uniform descriptor wrappers in batches.
+ *
+ * @param slots uniform-buffer slots
+ * @param allocator growable allocator, or NULL for the device-owned pool
+ * @param cfg benchmark configuration
+ * @return whether every allocation succeeded
+ */
+static bool churn_descriptors(
+    DvzSlots* slots, DvzDescriptorAllocator* allocator, const ChurnConfig* cfg)
+{
+    DvzDescriptors** batch = (DvzDescriptors**)calloc(cfg->batch, sizeof(DvzDescriptors*));
+    if (batch == NULL)
+        return false;
+    bool ok = true;
+    for (uint32_t done = 0; done < cfg->count && ok;)
+    {
+        uint32_t n = cfg->count - done < cfg->batch ? cfg->count - done : cfg->batch;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            batch[i] = dvz_descriptors_create_wrapper();
+            if (batch[i] == NULL)
+                ok = false;
+            else if (allocator != NULL)
+                ok = dvz_descriptors_pooled(allocator, slots, batch[i]) == 0 && ok;
+            else
+                dvz_descriptors(slots, batch[i]);
+        }
+        for (uint32_t i = 0; i < n; i++)
+            dvz_descriptors_free(batch[i]);
+        done += n;
+    }
+    free(batch);
+    return ok;
+}
+
+
+
+/**
+ * Create and destroy DRP2 bind groups through the vklite runtime.
+ *
+ * @param runtime the vklite runtime
+ * @param cfg benchmark configuration
+ * @return whether every stream executed
+ */
+static bool churn_bind_groups(DvzDrp2Runtime* runtime, const ChurnConfig* cfg)
+{
+    DvzDrp2CommandStream* stream = dvz_drp2_stream();
+    bool ok = dvz_drp2_stream_hello_renderer(stream, "drp2_bind_group_churn") &&
+              dvz_drp2_stream_renderer_hello_reply(stream, "vklite") &&
+              dvz_drp2_stream_create_uniform_bind_group_layout(stream, LAYOUT_ID) &&
+              dvz_drp2_stream_create_buffer(
+                  stream, BUFFER_ID, 256, DVZ_DRP2_BUFFER_USAGE_UNIFORM);
+    ok = ok && dvz_drp2_runtime_execute(runtime, stream).ok;
+    dvz_drp2_stream_destroy(stream);
+
+    for (uint32_t done = 0; done < cfg->count && ok;)
+    {
+        uint32_t n = cfg->count - done < cfg->batch ? cfg->count - done : cfg->batch;
+        stream = dvz_drp2_stream();
+        for (uint32_t i = 0; i < n && ok; i++)
+            ok = dvz_drp2_stream_create_uniform_bind_group(
+                stream, BIND_GROUP_ID + i, LAYOUT_ID, BUFFER_ID, 0, 16);
+        for (uint32_t i = 0; i < n && ok; i++)
+            ok = dvz_drp2_stream_destroy_bind_group(stream, BIND_GROUP_ID + i);
+        ok = ok && dvz_drp2_runtime_execute(runtime, stream).ok;
+        dvz_drp2_stream_destroy(stream);
+        done += n;
+    }
+    return ok;
+}
+
+
+
+/*************************************************************************************************/
+/*  Entry-point                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Report descriptor allocation throughput for the device pool, the recycling allocator, and DRP2
+ * bind-group churn.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @return process exit code
+ */
+int main(int argc, char** argv)
+{
+    ChurnConfig cfg = {
+        .count = 100000,
+        .batch = 1000,
+    };
+    if (!parse_args(argc, argv, &cfg))
+        return 1;
+
+    DvzGpuCtxConfig ctx_cfg = dvz_gpu_ctx_config();
+    VkPhysicalDeviceVulkan13Features features13 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        .dynamicRendering = true,
+        .synchronization2 = true,
+    };
+    dvz_gpu_ctx_config_features13(&ctx_cfg, &features13);
+    DvzGpuCtx* ctx = dvz_gpu_ctx(&ctx_cfg);
+    if (ctx == NULL)
+    {
+        fprintf(stderr, "could not create a GPU context\n");
+        return 1;
+    }
+    DvzDevice* device = dvz_gpu_ctx_device(ctx);
+    printf("%u allocations in batches of %u\n", cfg.count, cfg.batch);
+
+    DvzSlots* slots = dvz_slots_create_wrapper();
+    dvz_slots(device, slots);
+    dvz_slots_binding(slots, 0, 0, 1, VK_SHADER_STAGE_ALL, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    bool ok = dvz_slots_create(slots) == 0;
+
+    uint64_t start = dvz_time_monotonic_ns();
+    ok = ok && churn_descriptors(slots, NULL, &cfg);
+    if (ok)
+        report("device pool", cfg.count, start, 0);
+
+    DvzDescriptorAllocator* allocator = dvz_descriptor_allocator(device);
+    start = dvz_time_monotonic_ns();
+    ok = ok && allocator != NULL && churn_descriptors(slots, allocator, &cfg);
+    if (ok)
+    {
+        DvzDescriptorAllocatorStats stats = dvz_descriptor_allocator_stats(allocator);
+        report("recycling", cfg.count, start, stats.pool_count);
+    }
+    dvz_descriptor_allocator_release(allocator, slots);
+    dvz_descriptor_allocator_destroy(allocator);
+    dvz_slots_destroy(slots);
+    dvz_slots_free(slots);
+
+    DvzDrp2RuntimeConfig runtime_cfg =
+        dvz_drp2_runtime_vklite_config(device, dvz_gpu_ctx_alloc(ctx));
+    DvzDrp2Runtime* runtime = dvz_drp2_runtime_vklite(&runtime_cfg);
+    start = dvz_time_monotonic_ns();
+    ok = ok && runtime != NULL && churn_bind_groups(runtime, &cfg);
+    if (ok)
+    {
+        DvzDescriptorAllocator* pools = runtime->vklite_state->descriptor_allocator;
+        report("drp2", cfg.count, start, dvz_descriptor_allocator_stats(pools).pool_count);
+    }
+    else
+        fprintf(stderr, "descriptor allocation or stream execution failed\n");
+
+    dvz_drp2_runtime_destroy(runtime);
+    dvz_gpu_ctx_destroy(ctx);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* drp2_transfer_throughput - headless DRP2 upload throughput, blocking vs timeline transfers.
+ *
+ * Build:  cmake --build build --target example_c_lab_drp2_transfer_throughput
+ * Run:    ./build/examples/c/lab/drp2_transfer_throughput --tiles 64 --tile 64 --frames 120
+ *
+ * Every frame writes --tiles texture tiles of --tile x --tile RGBA8 texels and copies the texture
+ * into a readback buffer. The same frames run with blocking transfer submissions, then with
+ * transfers signaling the runtime timeline semaphore. Every line reports ms/frame and MB/s of
+ * uploaded texels; the readback is checked after each run.
+ */
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "_runtime.h"
+#include "datoviz/common/functions.h"
+#include "datoviz/drp2.h"
+#include "datoviz/vk/device.h"
+#include "datoviz/vk/gpu_ctx.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define TEXTURE_ID  1
+#define READBACK_ID 2
+#define ENCODER_ID  10
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct ThroughputConfig
+{
+    uint32_t tiles;
+    uint32_t tile;
+    uint32_t frames;
+} ThroughputConfig;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Parse an unsigned integer argument.
+ *
+ * @param text argument text
+ * @param value output value
+ * @return whether the argument is a valid 32-bit unsigned integer
+ */
+static bool parse_u32(const char* text, uint32_t* value)
+{
+    char* end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*text == '\0' || end == NULL || *end != '\0' || parsed > UINT32_MAX)
+        return false;
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+
+
+/**
+ * Parse the command line.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param cfg output configuration
+ * @return whether every argument was recognized
+ */
+static bool parse_args(int argc, char** argv, ThroughputConfig* cfg)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--tiles") == 0)
+            ok = parse_u32(argv[++i], &cfg->tiles) && cfg->tiles > 0;
+        else if (ok && strcmp(argv[i], "--tile") == 0)
+            ok = parse_u32(argv[++i], &cfg->tile) && cfg->tile > 0 && cfg->tile <= 1024;
+        else if (ok && strcmp(argv[i], "--frames") == 0)
+            ok = parse_u32(argv[++i], &cfg->frames) && cfg->frames > 0;
+        else
+            ok = false;
+        if (!ok)
+        {
+            fprintf(stderr, "usage: %s [--tiles N] [--tile PX] [--frames N]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+/**
+ * Create the GPU context with the features the DRP2 runtime and its transfer timeline use.
+ *
+ * @return owned GPU context, or NULL on failure
+ */
+static DvzGpuCtx* create_ctx(void)
+{
+    DvzGpuCtxConfig cfg = dvz_gpu_ctx_config();
+    VkPhysicalDeviceVulkan12Features features12 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .timelineSemaphore = true,
+    };
+    dvz_gpu_ctx_config_features12(&cfg, &features12);
+    VkPhysicalDeviceVulkan13Features features13 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        .dynamicRendering = true,
+        .synchronization2 = true,
+    };
+    dvz_gpu_ctx_config_features13(&cfg, &features13);
+    return dvz_gpu_ctx(&cfg);
+}
+
+
+
+/**
+ * Create the tiled texture and its readback buffer.
+ *
+ * @param runtime the vklite runtime
+ * @param side texture side in texels
+ * @return whether the setup stream executed
+ */
+static bool setup(DvzDrp2Runtime* runtime, uint32_t side)
+{
+    DvzDrp2CommandStream* stream = dvz_drp2_stream();
+    bool ok = dvz_drp2_stream_hello_renderer(stream, "drp2_transfer_throughput") &&
+              dvz_drp2_stream_renderer_hello_reply(stream, "vklite") &&
+              dvz_drp2_stream_create_texture_2d_usage(
+                  stream, TEXTURE_ID, side, side,
+                  DVZ_DRP2_TEXTURE_USAGE_COPY_DST | DVZ_DRP2_TEXTURE_USAGE_COPY_SRC) &&
+              dvz_drp2_stream_create_buffer(
+                  stream, READBACK_ID, (uint64_t)side * side * 4,
+                  DVZ_DRP2_BUFFER_USAGE_COPY_DST | DVZ_DRP2_BUFFER_USAGE_MAP_READ);
+    ok = ok && dvz_drp2_runtime_execute(runtime, stream).ok;
+    dvz_drp2_stream_destroy(stream);
+    return ok;
+}
+
+
+
+/**
+ * Run the upload frames in one transfer mode and report ms/frame and MB/s.
+ *
+ * @param runtime the vklite runtime
+ * @param cfg benchmark configuration
+ * @param name transfer mode name
+ * @param async whether transfers signal the timeline instead of blocking
+ * @param pixels one tile of RGBA8 texels per tile slot
+ * @return whether every frame executed and the readback matches the last frame
+ */
+static bool bench_frames(
+    DvzDrp2Runtime* runtime, const ThroughputConfig* cfg, const char* name, bool async,
+    uint8_t* pixels)
+{
+    const uint32_t grid = (uint32_t)ceil(sqrt((double)cfg->tiles));
+    const uint32_t side = grid * cfg->tile;
+    const uint64_t tile_bytes = (uint64_t)cfg->tile * cfg->tile * 4;
+    _dvz_drp2_runtime_async_transfers(runtime, async);
+
+    bool ok = true;
+    uint64_t start = dvz_time_monotonic_ns();
+    for (uint32_t frame = 0; frame < cfg->frames && ok; frame++)
+    {
+        DvzDrp2CommandStream* stream = dvz_drp2_stream();
+        for (uint32_t t = 0; t < cfg->tiles && ok; t++)
+        {
+            uint8_t* tile = pixels + t * tile_bytes;
+            memset(tile, (int)((frame + t) & 0xFF), tile_bytes);
+            ok = dvz_drp2_stream_write_texture_2d_region_borrowed(
+                stream, TEXTURE_ID, 0, (t % grid) * cfg->tile, (t / grid) * cfg->tile,
+                cfg->tile, cfg->tile, cfg->tile * 4, cfg->tile, tile);
+        }
+        ok = ok && dvz_drp2_stream_begin_command_encoder(stream, ENCODER_ID) &&
+             dvz_drp2_stream_copy_texture_to_buffer(
+                 stream, ENCODER_ID, TEXTURE_ID, READBACK_ID, 0, side, side, side * 4, side) &&
+             dvz_drp2_stream_finish_command_encoder(stream, ENCODER_ID, ENCODER_ID + 1) &&
+             dvz_drp2_stream_queue_submit(stream, ENCODER_ID + 1, ENCODER_ID + 2);
+        ok = ok && dvz_drp2_runtime_execute(runtime, stream).ok;
+        dvz_drp2_stream_destroy(stream);
+    }
+
+    // The readback waits for the last copy, so the timing includes every pending transfer.
+    uint8_t first = 0;
+    ok = ok && dvz_drp2_runtime_download_buffer(runtime, READBACK_ID, 0, 1, &first);
+    double seconds = (double)(dvz_time_monotonic_ns() - start) * 1e-9;
+    ok = ok && first == (uint8_t)((cfg->frames - 1) & 0xFF);
+    if (!ok)
+    {
+        fprintf(stderr, "%s: frame execution or readback failed\n", name);
+        return false;
+    }
+    printf(
+        "%-10s %9.3f ms/frame %9.1f MB/s\n", name, seconds * 1e3 / cfg->frames,
+        seconds > 0 ? (double)tile_bytes * cfg->tiles * cfg->frames / seconds / 1e6 : 0.0);
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Entry-point                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Report DRP2 transfer throughput with blocking and timeline submissions.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @return process exit code
+ */
+int main(int argc, char** argv)
+{
+    ThroughputConfig cfg = {
+        .tiles = 64,
+        .tile = 64,
+        .frames = 120,
+    };
+    if (!parse_args(argc, argv, &cfg))
+        return 1;
+
+    DvzGpuCtx* ctx = create_ctx();
+    if (ctx == NULL)
+    {
+        fprintf(stderr, "could not create a GPU context\n");
+        return 1;
+    }
+    DvzDrp2RuntimeConfig runtime_cfg =
+        dvz_drp2_runtime_vklite_config(dvz_gpu_ctx_device(ctx), dvz_gpu_ctx_alloc(ctx));
+    DvzDrp2Runtime* runtime = dvz_drp2_runtime_vklite(&runtime_cfg);
+    const uint32_t grid = (uint32_t)ceil(sqrt((double)cfg.tiles));
+    uint8_t* pixels = (uint8_t*)malloc((size_t)cfg.tiles * cfg.tile * cfg.tile * 4);
+    bool ok = runtime != NULL && pixels != NULL && setup(runtime, grid * cfg.tile);
+    printf(
+        "%u tiles of %ux%u RGBA8 per frame, %u frames, %s\n", cfg.tiles, cfg.tile, cfg.tile,
+        cfg.frames,
+        dvz_device_features12(dvz_gpu_ctx_device(ctx))->timelineSemaphore
+            ? "timeline semaphores enabled"
+            : "timeline semaphores unavailable");
+
+    ok = ok && bench_frames(runtime, &cfg, "blocking", false, pixels);
+    ok = ok && bench_frames(runtime, &cfg, "timeline", true, pixels);
+
+    free(pixels);
+    dvz_drp2_runtime_destroy(runtime);
+    dvz_gpu_ctx_destroy(ctx);
+    return ok ? 0 : 1;
+}
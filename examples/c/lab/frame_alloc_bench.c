@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* frame_alloc_bench - heap allocations made by one figure emission.
+ *
+ * Build:  cmake --build build --target example_c_lab_frame_alloc_bench
+ * Run:    ./build/examples/c/lab/frame_alloc_bench --visuals 16 --frames 240
+ *
+ * A figure with several point visuals emits frame artifacts while a counting allocator is
+ * installed. Camera-only frames change the panel domain between emissions; data frames also
+ * rewrite a few positions of every visual. Every line reports heap allocations, requested bytes,
+ * and ms per frame. Only allocations made through the datoviz allocator are counted.
+ */
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "_alloc.h"
+#include "datoviz/common/functions.h"
+#include "datoviz/scene.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define POINTS_PER_VISUAL 1024
+#define WARMUP_FRAMES     8
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct AllocConfig
+{
+    uint32_t visuals;
+    uint32_t frames;
+} AllocConfig;
+
+typedef struct AllocCounter
+{
+    const DvzAllocator* inner;
+    uint64_t allocs;
+    uint64_t bytes;
+} AllocCounter;
+
+
+
+/*************************************************************************************************/
+/*  Counting allocator                                                                           */
+/*************************************************************************************************/
+
+static AllocCounter COUNTER;
+
+static void* _count_malloc(DvzSize size)
+{
+    COUNTER.allocs++;
+    COUNTER.bytes += size;
+    return COUNTER.inner->malloc_fn(size);
+}
+
+static void* _count_calloc(DvzSize count, DvzSize size)
+{
+    COUNTER.allocs++;
+    COUNTER.bytes += count * size;
+    return COUNTER.inner->calloc_fn(count, size);
+}
+
+static void* _count_realloc(void* pointer, DvzSize size)
+{
+    COUNTER.allocs++;
+    COUNTER.bytes += size;
+    return COUNTER.inner->realloc_fn(pointer, size);
+}
+
+static void _count_free(void* pointer) { COUNTER.inner->free_fn(pointer); }
+
+static void* _count_aligned_alloc(DvzSize alignment, DvzSize size)
+{
+    COUNTER.allocs++;
+    COUNTER.bytes += size;
+    return COUNTER.inner->aligned_alloc_fn(alignment, size);
+}
+
+static void _count_aligned_free(void* pointer) { COUNTER.inner->aligned_free_fn(pointer); }
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Parse an unsigned integer argument.
+ *
+ * @param text argument text
+ * @param value output value
+ * @return whether the argument is a valid 32-bit unsigned integer
+ */
+static bool parse_u32(const char* text, uint32_t* value)
+{
+    char* end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*text == '\0' || end == NULL || *end != '\0' || parsed > UINT32_MAX)
+        return false;
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+
+
+/**
+ * Parse the command line.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param cfg output configuration
+ * @return whether every argument was recognized
+ */
+static bool parse_args(int argc, char** argv, AllocConfig* cfg)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--visuals") == 0)
+            ok = parse_u32(argv[++i], &cfg->visuals) && cfg->visuals > 0;
+        else if (ok && strcmp(argv[i], "--frames") == 0)
+            ok = parse_u32(argv[++i], &cfg->frames) && cfg->frames > 0;
+        else
+            ok = false;
+        if (!ok)
+        {
+            fprintf(stderr, "usage: %s [--visuals N] [--frames N]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+/**
+ * Fill the positions of one visual on a circle.
+ *
+ * @param position output positions
+ * @param phase rotation of the circle
+ */
+static void fill_positions(vec3* position, double phase)
+{
+    for (uint32_t i = 0; i < POINTS_PER_VISUAL; i++)
+    {
+        double angle = phase + 2.0 * DVZ_PI * i / POINTS_PER_VISUAL;
+        position[i][0] = (float)(0.8 * cos(angle));
+        position[i][1] = (float)(0.8 * sin(angle));
+        position[i][2] = 0.0f;
+    }
+}
+
+
+
+/**
+ * Emit one frame artifact and release it.
+ *
+ * @param figure the figure
+ * @return whether the emission succeeded
+ */
+static bool emit_frame(DvzFigure* figure)
+{
+    DvzCapabilitySnapshot caps = dvz_capability_snapshot();
+    DvzDiagnosticReport report;
+    dvz_diagnostic_report_init(&report);
+    DvzSceneFrameArtifact* artifact = dvz_figure_emit_frame(figure, &caps, &report, NULL);
+    bool ok = artifact != NULL &&
+              dvz_scene_frame_artifact_status(artifact) == DVZ_SCENE_FRAME_ARTIFACT_STATUS_OK;
+    dvz_scene_frame_artifact_destroy(artifact);
+    return ok;
+}
+
+
+
+/**
+ * Time camera-only or data-update frames and count their heap allocations.
+ *
+ * @param cfg benchmark configuration
+ * @param mode frame kind name
+ * @param data whether every frame also rewrites visual positions
+ * @return whether every emission succeeded
+ */
+static bool bench_mode(const AllocConfig* cfg, const char* mode, bool data)
+{
+    DvzScene* scene = dvz_scene();
+    DvzFigure* figure = scene != NULL ? dvz_figure(scene, 800, 600, 0) : NULL;
+    DvzPanel* panel = figure != NULL ? dvz_panel_full(figure) : NULL;
+    DvzVisual** points = (DvzVisual**)calloc(cfg->visuals, sizeof(DvzVisual*));
+    vec3* position = (vec3*)calloc(POINTS_PER_VISUAL, sizeof(vec3));
+    bool ok = panel != NULL && points != NULL && position != NULL;
+    for (uint32_t v = 0; ok && v < cfg->visuals; v++)
+    {
+        points[v] = dvz_point(scene, 0);
+        fill_positions(position, (double)v);
+        ok = points[v] != NULL &&
+             dvz_visual_set_data(points[v], "position", position, POINTS_PER_VISUAL) == DVZ_OK &&
+             dvz_panel_add_visual(panel, points[v], NULL) == DVZ_OK;
+    }
+
+    uint64_t allocs = 0;
+    uint64_t bytes = 0;
+    uint64_t elapsed = 0;
+    for (uint32_t frame = 0; ok && frame < WARMUP_FRAMES + cfg->frames; frame++)
+    {
+        // The domain change is the camera motion; positions are only rewritten in data mode.
+        double shift = 0.01 * (double)(frame % 64);
+        ok = dvz_panel_set_domain(panel, DVZ_DIM_X, -1.0 + shift, 1.0 + shift) == DVZ_OK;
+        for (uint32_t v = 0; ok && data && v < cfg->visuals; v++)
+        {
+            fill_positions(position, 0.01 * (double)frame + (double)v);
+            ok = dvz_visual_set_data(points[v], "position", position, POINTS_PER_VISUAL) ==
+                 DVZ_OK;
+        }
+
+        uint64_t allocs_before = COUNTER.allocs;
+        uint64_t bytes_before = COUNTER.bytes;
+        uint64_t start = dvz_time_monotonic_ns();
+        ok = ok && emit_frame(figure);
+        if (frame >= WARMUP_FRAMES)
+        {
+            elapsed += dvz_time_monotonic_ns() - start;
+            allocs += COUNTER.allocs - allocs_before;
+            bytes += COUNTER.bytes - bytes_before;
+        }
+    }
+    if (ok)
+    {
+        double n = (double)cfg->frames;
+        printf(
+            "%-7s %10.1f allocs/frame %12.1f bytes/frame %8.3f ms/frame\n", mode,
+            (double)allocs / n, (double)bytes / n, (double)elapsed * 1e-6 / n);
+    }
+    else
+    {
+        fprintf(stderr, "%s: emission failed\n", mode);
+    }
+
+    free(position);
+    free(points);
+    if (scene != NULL)
+        dvz_scene_destroy(scene);
+    return ok;
+}
+
+
+
+/*************************************************************************************************/
+/*  Entry-point                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Report the heap allocations of camera-only frames and of data-update frames.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @return process exit code
+ */
+int main(int argc, char** argv)
+{
+    AllocConfig cfg = {
+        .visuals = 16,
+        .frames = 240,
+    };
+    if (!parse_args(argc, argv, &cfg))
+        return 1;
+    printf("%u visuals, %u frames\n", cfg.visuals, cfg.frames);
+
+    COUNTER.inner = dvz_get_allocator();
+    DvzAllocator counting = {
+        .malloc_fn = _count_malloc,
+        .calloc_fn = _count_calloc,
+        .realloc_fn = _count_realloc,
+        .free_fn = _count_free,
+        .aligned_alloc_fn = COUNTER.inner->aligned_alloc_fn ? _count_aligned_alloc : NULL,
+        .aligned_free_fn = COUNTER.inner->aligned_free_fn ? _count_aligned_free : NULL,
+    };
+    dvz_set_allocator(&counting);
+
+    bool ok = bench_mode(&cfg, "camera", false);
+    ok = bench_mode(&cfg, "data", true) && ok;
+
+    dvz_set_allocator(COUNTER.inner);
+    return ok ? 0 : 1;
+}
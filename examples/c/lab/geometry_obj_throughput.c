@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* geometry_obj_throughput - Wavefront OBJ parse and binary mesh cache throughput.
+ *
+ * Build:  cmake --build build --target example_c_lab_geometry_obj_throughput
+ * Run:    ./build/examples/c/lab/geometry_obj_throughput --grid 1000 --iterations 3
+ *
+ * Writes a synthetic grid mesh with positions, texture coordinates, normals, and quad faces, or
+ * uses the OBJ file passed with --obj. Loads it repeatedly with the chunked parser, then writes
+ * and reloads the binary mesh cache. Every line reports MB/s of OBJ text.
+ */
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "datoviz/common/functions.h"
+#include "datoviz/geom.h"
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct ThroughputConfig
+{
+    uint32_t grid;
+    uint32_t iterations;
+    bool f32;
+    const char* obj_path;
+    const char* cache_path;
+} ThroughputConfig;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Parse an unsigned integer argument.
+ *
+ * @param text argument text
+ * @param value output value
+ * @return whether the argument is a valid 32-bit unsigned integer
+ */
+static bool parse_u32(const char* text, uint32_t* value)
+{
+    char* end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*text == '\0' || end == NULL || *end != '\0' || parsed > UINT32_MAX)
+        return false;
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+
+
+/**
+ * Parse the command line.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param cfg output configuration
+ * @return whether every argument was recognized
+ */
+static bool parse_args(int argc, char** argv, ThroughputConfig* cfg)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = true;
+        if (strcmp(argv[i], "--f32") == 0)
+            cfg->f32 = true;
+        else if (i + 1 < argc && strcmp(argv[i], "--grid") == 0)
+            ok = parse_u32(argv[++i], &cfg->grid) && cfg->grid >= 2;
+        else if (i + 1 < argc && strcmp(argv[i], "--iterations") == 0)
+            ok = parse_u32(argv[++i], &cfg->iterations);
+        else if (i + 1 < argc && strcmp(argv[i], "--obj") == 0)
+            cfg->obj_path = argv[++i];
+        else if (i + 1 < argc && strcmp(argv[i], "--cache") == 0)
+            cfg->cache_path = argv[++i];
+        else
+            ok = false;
+        if (!ok)
+        {
+            fprintf(
+                stderr, "usage: %s [--grid N] [--iterations N] [--f32] [--obj FILE] "
+                        "[--cache FILE]\n",
+                argv[0]);
+            return false;
+        }
+    }
+    cfg->iterations = cfg->iterations == 0 ? 1 : cfg->iterations;
+    return true;
+}
+
+
+
+/**
+ * Write a grid x grid surface as an OBJ file.
+ *
+ * @param path output path
+ * @param grid number of vertices along each side
+ * @return file size in bytes, or 0 on failure
+ */
+static uint64_t write_grid(const char* path, uint32_t grid)
+{
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL)
+        return 0;
+    bool ok = true;
+    for (uint32_t i = 0; i < grid && ok; i++)
+    {
+        for (uint32_t j = 0; j < grid && ok; j++)
+        {
+            const double u = (double)i / (grid - 1), v = (double)j / (grid - 1);
+            ok = fprintf(
+                     fp, "v %.6f %.6f %.6f\nvt %.6f %.6f\nvn 0 0 1\n", u * 2 - 1, v * 2 - 1,
+                     0.25 * (u * u - v * v), u, v) > 0;
+        }
+    }
+    for (uint32_t i = 0; i + 1 < grid && ok; i++)
+    {
+        for (uint32_t j = 0; j + 1 < grid && ok; j++)
+        {
+            const uint32_t a = i * grid + j + 1, b = a + grid;
+            ok = fprintf(
+                     fp, "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n", a, a, a, b, b, b, b + 1,
+                     b + 1, b + 1, a + 1, a + 1, a + 1) > 0;
+        }
+    }
+    const long size = ok ? ftell(fp) : 0;
+    ok = fclose(fp) == 0 && ok;
+    return ok && size > 0 ? (uint64_t)size : 0;
+}
+
+
+
+/**
+ * Load the OBJ file repeatedly and report MB/s of OBJ text.
+ *
+ * @param name configuration name
+ * @param path OBJ file path
+ * @param desc loader descriptor
+ * @param size OBJ file size in bytes
+ * @param iterations number of loads
+ * @return whether every load succeeded
+ */
+static bool bench_load(
+    const char* name, const char* path, const DvzGeometryObjDesc* desc, uint64_t size,
+    uint32_t iterations)
+{
+    uint32_t vertex_count = 0;
+    uint64_t start = dvz_time_monotonic_ns();
+    for (uint32_t it = 0; it < iterations; it++)
+    {
+        DvzGeometry* geometry = dvz_geometry_obj(path, desc);
+        if (geometry == NULL)
+        {
+            fprintf(stderr, "%s: could not load %s\n", name, path);
+            return false;
+        }
+        vertex_count = geometry->vertex_count;
+        dvz_geometry_destroy(geometry);
+    }
+    double seconds = (double)(dvz_time_monotonic_ns() - start) * 1e-9;
+    printf(
+        "%-16s %9.2f ms/load %9.1f MB/s %10u vertices\n", name, seconds * 1e3 / iterations,
+        seconds > 0 ? (double)size * iterations / seconds / 1e6 : 0.0, vertex_count);
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Entry-point                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Report OBJ parse and binary mesh cache throughput.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @return process exit code
+ */
+int main(int argc, char** argv)
+{
+    ThroughputConfig cfg = {
+        .grid = 1000,
+        .iterations = 3,
+        .cache_path = "geometry_obj_throughput.dvzmesh",
+    };
+    if (!parse_args(argc, argv, &cfg))
+        return 1;
+
+    const char* path = cfg.obj_path != NULL ? cfg.obj_path : "geometry_obj_throughput.obj";
+    uint64_t size = 0;
+    if (cfg.obj_path == NULL)
+    {
+        size = write_grid(path, cfg.grid);
+    }
+    else
+    {
+        FILE* fp = fopen(path, "rb");
+        if (fp != NULL && fseek(fp, 0, SEEK_END) == 0)
+            size = (uint64_t)ftell(fp);
+        if (fp != NULL)
+            fclose(fp);
+    }
+    if (size == 0)
+    {
+        fprintf(stderr, "could not read or write %s\n", path);
+        return 1;
+    }
+    printf("%s: %.1f MB, %s\n", path, (double)size / 1e6, cfg.f32 ? "f32" : "f64");
+
+    DvzGeometryObjDesc desc = dvz_geometry_obj_desc();
+    desc.flags = cfg.f32 ? DVZ_GEOMETRY_DESC_F32 : 0;
+    bool ok = bench_load("parse", path, &desc, size, cfg.iterations);
+
+    desc.cache_path = cfg.cache_path;
+    remove(cfg.cache_path);
+    ok = ok && bench_load("parse + cache", path, &desc, size, 1);
+    ok = ok && bench_load("cache load", path, &desc, size, cfg.iterations);
+
+    remove(cfg.cache_path);
+    if (cfg.obj_path == NULL)
+        remove(path);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* hover_query_bench - frame time with continuous hover picking disabled, synchronous, pipelined.
+ *
+ * Build:  cmake --build build --target example_c_lab_hover_query_bench
+ * Run:    ./build/examples/c/lab/hover_query_bench --points 100000 --frames 240
+ *
+ * Every frame moves the pointer, queues one item query on a point cloud (as an app does on every
+ * mouse move), emits the figure frame, and processes the queries through a vklite runtime. The
+ * same frames run without hover, with synchronous queries, and with query latencies of 1..3
+ * frames. Every line reports ms/frame and the number of delivered hover results.
+ */
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "datoviz/common/functions.h"
+#include "datoviz/drp2.h"
+#include "datoviz/scene.h"
+#include "datoviz/vk/gpu_ctx.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define FIGURE_SIZE      512
+#define HOVER_REQUEST_ID 1
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct HoverConfig
+{
+    uint32_t points;
+    uint32_t frames;
+} HoverConfig;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Parse an unsigned integer argument.
+ *
+ * @param text argument text
+ * @param value output value
+ * @return whether the argument is a valid 32-bit unsigned integer
+ */
+static bool parse_u32(const char* text, uint32_t* value)
+{
+    char* end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*text == '\0' || end == NULL || *end != '\0' || parsed > UINT32_MAX)
+        return false;
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+
+
+/**
+ * Parse the command line.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param cfg output configuration
+ * @return whether every argument was recognized
+ */
+static bool parse_args(int argc, char** argv, HoverConfig* cfg)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--points") == 0)
+            ok = parse_u32(argv[++i], &cfg->points) && cfg->points > 0;
+        else if (ok && strcmp(argv[i], "--frames") == 0)
+            ok = parse_u32(argv[++i], &cfg->frames) && cfg->frames > 0;
+        else
+            ok = false;
+        if (!ok)
+        {
+            fprintf(stderr, "usage: %s [--points N] [--frames N]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+/**
+ * Create the GPU context with the features the DRP2 runtime and its transfer timeline use.
+ *
+ * @return owned GPU context, or NULL on failure
+ */
+static DvzGpuCtx* create_ctx(void)
+{
+    DvzGpuCtxConfig cfg = dvz_gpu_ctx_config();
+    VkPhysicalDeviceVulkan12Features features12 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .timelineSemaphore = true,
+    };
+    dvz_gpu_ctx_config_features12(&cfg, &features12);
+    VkPhysicalDeviceVulkan13Features features13 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        .dynamicRendering = true,
+        .synchronization2 = true,
+    };
+    dvz_gpu_ctx_config_features13(&cfg, &features13);
+    return dvz_gpu_ctx(&cfg);
+}
+
+
+
+/**
+ * Fill a pickable point cloud on a spiral.
+ *
+ * @param scene the scene
+ * @param panel the panel
+ * @param count point count
+ * @return whether the visual was created and attached
+ */
+static bool add_points(DvzScene* scene, DvzPanel* panel, uint32_t count)
+{
+    DvzVisual* points = dvz_point(scene, 0);
+    vec3* position = (vec3*)calloc(count, sizeof(vec3));
+    DvzColor* color = (DvzColor*)calloc(count, sizeof(DvzColor));
+    float* size = (float*)calloc(count, sizeof(float));
+    bool ok = points != NULL && position != NULL && color != NULL && size != NULL;
+    for (uint32_t i = 0; ok && i < count; i++)
+    {
+        double t = (double)i / (double)count;
+        double angle = 40.0 * DVZ_PI * t;
+        position[i][0] = (float)(0.9 * t * cos(angle));
+        position[i][1] = (float)(0.9 * t * sin(angle));
+        color[i] = (DvzColor){(uint8_t)(255.0 * t), 128, (uint8_t)(255.0 * (1.0 - t)), 255};
+        size[i] = 6.0f;
+    }
+    if (ok)
+    {
+        dvz_visual_set_query_capabilities(points, DVZ_QUERY_CAPABILITY_ITEM);
+        ok = dvz_visual_set_data(points, "position", position, count) == DVZ_OK &&
+             dvz_visual_set_data(points, "color", color, count) == DVZ_OK &&
+             dvz_visual_set_data(points, "size", size, count) == DVZ_OK &&
+             dvz_panel_add_visual(panel, points, NULL) == DVZ_OK;
+    }
+    free(position);
+    free(color);
+    free(size);
+    return ok;
+}
+
+
+
+/**
+ * Run the frames in one hover mode and report ms/frame and delivered results.
+ *
+ * @param runtime the vklite runtime
+ * @param cfg benchmark configuration
+ * @param name hover mode name
+ * @param hover whether a hover query is queued every frame
+ * @param latency query latency in frames, 0 for synchronous queries
+ * @return whether every frame emitted and every query was processed
+ */
+static bool bench_frames(
+    DvzDrp2Runtime* runtime, const HoverConfig* cfg, const char* name, bool hover,
+    uint32_t latency)
+{
+    DvzScene* scene = dvz_scene();
+    DvzFigure* figure = scene != NULL ? dvz_figure(scene, FIGURE_SIZE, FIGURE_SIZE, 0) : NULL;
+    DvzPanel* panel = figure != NULL ? dvz_panel_full(figure) : NULL;
+    bool ok = panel != NULL && add_points(scene, panel, cfg->points) &&
+              dvz_scene_set_query_latency(scene, latency) == DVZ_OK;
+
+    DvzCapabilitySnapshot caps = dvz_capability_snapshot();
+    caps.shader_format_glsl = true;
+    DvzDiagnosticReport report;
+    dvz_diagnostic_report_init(&report);
+
+    uint32_t delivered = 0;
+    uint64_t start = dvz_time_monotonic_ns();
+    for (uint32_t frame = 0; frame < cfg->frames && ok; frame++)
+    {
+        if (hover)
+        {
+            double angle = 2.0 * DVZ_PI * (double)frame / 120.0;
+            DvzQueryRequest request = dvz_query_request();
+            request.request_id = HOVER_REQUEST_ID;
+            request.target = DVZ_SCENE_TARGET_ITEM;
+            ok = dvz_panel_query_px(
+                     panel, FIGURE_SIZE * (0.5 + 0.3 * cos(angle)),
+                     FIGURE_SIZE * (0.5 + 0.3 * sin(angle)), &request) == DVZ_OK;
+        }
+        DvzSceneFrameArtifact* artifact = dvz_figure_emit_frame(figure, &caps, &report, NULL);
+        ok = ok && artifact != NULL &&
+             dvz_scene_frame_artifact_status(artifact) == DVZ_SCENE_FRAME_ARTIFACT_STATUS_OK;
+        dvz_scene_frame_artifact_destroy(artifact);
+        (void)dvz_figure_process_queries(figure, runtime, &caps);
+        DvzQueryResult result = {0};
+        while (dvz_scene_poll_query(scene, &result))
+            delivered++;
+    }
+    double seconds = (double)(dvz_time_monotonic_ns() - start) * 1e-9;
+    dvz_scene_destroy(scene);
+    if (!ok)
+    {
+        fprintf(stderr, "%s: frame emission or query failed\n", name);
+        return false;
+    }
+    printf(
+        "%-12s %9.3f ms/frame %6u hover results\n", name, seconds * 1e3 / cfg->frames,
+        delivered);
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Entry-point                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Report frame time with continuous hover picking disabled, synchronous, and pipelined.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @return process exit code
+ */
+int main(int argc, char** argv)
+{
+    HoverConfig cfg = {
+        .points = 100000,
+        .frames = 240,
+    };
+    if (!parse_args(argc, argv, &cfg))
+        return 1;
+
+    DvzGpuCtx* ctx = create_ctx();
+    if (ctx == NULL)
+    {
+        fprintf(stderr, "could not create a GPU context\n");
+        return 1;
+    }
+    DvzDrp2RuntimeConfig runtime_cfg =
+        dvz_drp2_runtime_vklite_config(dvz_gpu_ctx_device(ctx), dvz_gpu_ctx_alloc(ctx));
+    DvzDrp2Runtime* runtime = dvz_drp2_runtime_vklite(&runtime_cfg);
+    bool ok = runtime != NULL;
+    printf("%u points, %u frames\n", cfg.points, cfg.frames);
+
+    ok = ok && bench_frames(runtime, &cfg, "hover-off", false, 0);
+    ok = ok && bench_frames(runtime, &cfg, "hover-sync", true, 0);
+    ok = ok && bench_frames(runtime, &cfg, "hover-lat1", true, 1);
+    ok = ok && bench_frames(runtime, &cfg, "hover-lat2", true, 2);
+    ok = ok && bench_frames(runtime, &cfg, "hover-lat3", true, 3);
+
+    dvz_drp2_runtime_destroy(runtime);
+    dvz_gpu_ctx_destroy(ctx);
+    return ok ? 0 : 1;
+}
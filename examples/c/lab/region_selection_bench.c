@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* region_selection_bench - rectangle and lasso selection latency on the CPU and the GPU.
+ *
+ * Build:  cmake --build build --target example_c_lab_region_selection_bench
+ * Run:    ./build/examples/c/lab/region_selection_bench --points 50000000 --selections 20
+ *
+ * A point cloud is brushed with rectangles, with full lassos, and with a lasso that grows by one
+ * vertex per selection, as while the pointer is dragged. Each shape runs on the parallel CPU scan,
+ * on the CPU spatial index, and on the GPU compute pass through a vklite runtime. Every line
+ * reports ms per selection and the size of the last selection.
+ */
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "datoviz/common/functions.h"
+#include "datoviz/drp2.h"
+#include "datoviz/scene.h"
+#include "datoviz/vk/gpu_ctx.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define LASSO_VERTICES 256
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct SelectionConfig
+{
+    uint32_t points;
+    uint32_t selections;
+} SelectionConfig;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Parse an unsigned integer argument.
+ *
+ * @param text argument text
+ * @param value output value
+ * @return whether the argument is a valid 32-bit unsigned integer
+ */
+static bool parse_u32(const char* text, uint32_t* value)
+{
+    char* end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*text == '\0' || end == NULL || *end != '\0' || parsed > UINT32_MAX)
+        return false;
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+
+
+/**
+ * Parse the command line.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param cfg output configuration
+ * @return whether every argument was recognized
+ */
+static bool parse_args(int argc, char** argv, SelectionConfig* cfg)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--points") == 0)
+            ok = parse_u32(argv[++i], &cfg->points) && cfg->points > 0;
+        else if (ok && strcmp(argv[i], "--selections") == 0)
+            ok = parse_u32(argv[++i], &cfg->selections) && cfg->selections > 0;
+        else
+            ok = false;
+        if (!ok)
+        {
+            fprintf(stderr, "usage: %s [--points N] [--selections N]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+/**
+ * Create the GPU context with the features the DRP2 runtime and its transfer timeline use.
+ *
+ * @return owned GPU context, or NULL on failure
+ */
+static DvzGpuCtx* create_ctx(void)
+{
+    DvzGpuCtxConfig cfg = dvz_gpu_ctx_config();
+    VkPhysicalDeviceVulkan12Features features12 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .timelineSemaphore = true,
+    };
+    dvz_gpu_ctx_config_features12(&cfg, &features12);
+    VkPhysicalDeviceVulkan13Features features13 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        .dynamicRendering = true,
+        .synchronization2 = true,
+    };
+    dvz_gpu_ctx_config_features13(&cfg, &features13);
+    return dvz_gpu_ctx(&cfg);
+}
+
+
+
+/**
+ * Create a point cloud on a spiral.
+ *
+ * @param scene the scene
+ * @param count point count
+ * @return the point visual, or NULL on failure
+ */
+static DvzVisual* create_points(DvzScene* scene, uint32_t count)
+{
+    DvzVisual* points = dvz_point(scene, 0);
+    vec3* position = (vec3*)calloc(count, sizeof(vec3));
+    bool ok = points != NULL && position != NULL;
+    for (uint32_t i = 0; ok && i < count; i++)
+    {
+        double t = (double)i / (double)count;
+        double angle = 40.0 * DVZ_PI * t;
+        position[i][0] = (float)(0.9 * t * cos(angle));
+        position[i][1] = (float)(0.9 * t * sin(angle));
+    }
+    ok = ok && dvz_visual_set_data(points, "position", position, count) == DVZ_OK;
+    free(position);
+    return ok ? points : NULL;
+}
+
+
+
+/**
+ * Fill a star-shaped lasso around a center.
+ *
+ * @param center lasso center
+ * @param polygon output vertices as xy pairs
+ */
+static void star_lasso(const double center[2], double* polygon)
+{
+    for (uint32_t i = 0; i < LASSO_VERTICES; i++)
+    {
+        double angle = 2.0 * DVZ_PI * i / LASSO_VERTICES;
+        double radius = i % 2 == 0 ? 0.5 : 0.3;
+        polygon[2 * i + 0] = center[0] + radius * cos(angle);
+        polygon[2 * i + 1] = center[1] + radius * sin(angle);
+    }
+}
+
+
+
+/**
+ * Report one timing line.
+ *
+ * @param mode selection path name
+ * @param shape selection shape name
+ * @param start start timestamp in nanoseconds
+ * @param count selection count
+ * @param selected size of the last selection
+ */
+static void report(
+    const char* mode, const char* shape, uint64_t start, uint32_t count, uint64_t selected)
+{
+    double ms = (double)(dvz_time_monotonic_ns() - start) * 1e-6 / (double)count;
+    printf("%-10s %-11s %10.3f ms/op %12" PRIu64 " selected\n", mode, shape, ms, selected);
+}
+
+
+
+/**
+ * Time rectangles, full lassos, and a growing lasso on one selection path.
+ *
+ * @param cfg benchmark configuration
+ * @param mode selection path name
+ * @param runtime the runtime of the GPU compute pass, or NULL for the CPU
+ * @param indexed whether the CPU path uses the spatial index
+ * @return whether every selection succeeded
+ */
+static bool bench_mode(
+    const SelectionConfig* cfg, const char* mode, DvzDrp2Runtime* runtime, bool indexed)
+{
+    DvzScene* scene = dvz_scene();
+    DvzVisual* points = scene != NULL ? create_points(scene, cfg->points) : NULL;
+    double* lasso = (double*)calloc(2 * LASSO_VERTICES, sizeof(double));
+    bool ok = points != NULL && lasso != NULL &&
+              (!indexed || dvz_visual_set_spatial_index(points, true) == DVZ_OK) &&
+              (runtime == NULL || dvz_visual_set_region_selection_runtime(points, runtime) == 0);
+
+    // Warm up: the first selection builds the index or uploads the positions.
+    ok = ok && dvz_visual_select_rect(points, (double[2]){0, 0}, (double[2]){0.1, 0.1}) == 0;
+
+    uint64_t start = dvz_time_monotonic_ns();
+    for (uint32_t i = 0; ok && i < cfg->selections; i++)
+    {
+        double x = -0.8 + 1.0 * i / cfg->selections;
+        ok = dvz_visual_select_rect(points, (double[2]){x, -0.4}, (double[2]){x + 0.6, 0.4}) == 0;
+    }
+    if (ok)
+        report(mode, "rect", start, cfg->selections, dvz_visual_region_selection_count(points));
+
+    start = dvz_time_monotonic_ns();
+    for (uint32_t i = 0; ok && i < cfg->selections; i++)
+    {
+        star_lasso((double[2]){-0.3 + 0.6 * i / cfg->selections, 0.0}, lasso);
+        ok = dvz_visual_select_lasso(points, lasso, LASSO_VERTICES) == 0;
+    }
+    if (ok)
+    {
+        report(
+            mode, "lasso-full", start, cfg->selections,
+            dvz_visual_region_selection_count(points));
+    }
+
+    star_lasso((double[2]){0.0, 0.0}, lasso);
+    dvz_visual_clear_region_selection(points);
+    ok = ok && dvz_visual_select_lasso(points, lasso, 3) == 0;
+    start = dvz_time_monotonic_ns();
+    for (uint32_t n = 4; ok && n <= LASSO_VERTICES; n++)
+        ok = dvz_visual_select_lasso(points, lasso, n) == 0;
+    if (ok)
+    {
+        report(
+            mode, "lasso-grow", start, LASSO_VERTICES - 3,
+            dvz_visual_region_selection_count(points));
+    }
+
+    free(lasso);
+    dvz_scene_destroy(scene);
+    if (!ok)
+        fprintf(stderr, "%s: selection failed\n", mode);
+    return ok;
+}
+
+
+
+/*************************************************************************************************/
+/*  Entry-point                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Compare region selection latency on the CPU scan, the CPU spatial index, and the GPU.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @return process exit code
+ */
+int main(int argc, char** argv)
+{
+    SelectionConfig cfg = {
+        .points = 50000000,
+        .selections = 20,
+    };
+    if (!parse_args(argc, argv, &cfg))
+        return 1;
+    printf("%u points, %u selections\n", cfg.points, cfg.selections);
+
+    bool ok = bench_mode(&cfg, "cpu-scan", NULL, false);
+    ok = ok && bench_mode(&cfg, "cpu-grid", NULL, true);
+
+    DvzGpuCtx* ctx = create_ctx();
+    if (ctx == NULL)
+    {
+        printf("gpu        skipped, no GPU context\n");
+        return ok ? 0 : 1;
+    }
+    DvzDrp2RuntimeConfig runtime_cfg =
+        dvz_drp2_runtime_vklite_config(dvz_gpu_ctx_device(ctx), dvz_gpu_ctx_alloc(ctx));
+    DvzDrp2Runtime* runtime = dvz_drp2_runtime_vklite(&runtime_cfg);
+    ok = ok && runtime != NULL && bench_mode(&cfg, "gpu", runtime, false);
+
+    if (runtime != NULL)
+        dvz_drp2_runtime_destroy(runtime);
+    dvz_gpu_ctx_destroy(ctx);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* spatial_pick_bench - item pick latency with the CPU spatial index versus GPU query readback.
+ *
+ * Build:  cmake --build build --target example_c_lab_spatial_pick_bench
+ * Run:    ./build/examples/c/lab/spatial_pick_bench --points 10000000 --picks 200
+ *
+ * A point cloud is picked at the same pointer positions through three paths: the CPU spatial index
+ * (first query includes the index build), a range update followed by a pick (incremental refresh),
+ * and the GPU query render and readback through a vklite runtime. The rectangle and lasso lines
+ * time region selections, which only the index supports. Every line reports ms per operation.
+ */
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "datoviz/common/functions.h"
+#include "datoviz/drp2.h"
+#include "datoviz/scene.h"
+#include "datoviz/vk/gpu_ctx.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define FIGURE_SIZE     512
+#define PICK_REQUEST_ID 1
+#define UPDATE_BATCH    1024
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct PickConfig
+{
+    uint32_t points;
+    uint32_t picks;
+} PickConfig;
+
+
+typedef struct PickScene
+{
+    DvzScene* scene;
+    DvzFigure* figure;
+    DvzPanel* panel;
+    DvzVisual* points;
+} PickScene;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Parse an unsigned integer argument.
+ *
+ * @param text argument text
+ * @param value output value
+ * @return whether the argument is a valid 32-bit unsigned integer
+ */
+static bool parse_u32(const char* text, uint32_t* value)
+{
+    char* end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*text == '\0' || end == NULL || *end != '\0' || parsed > UINT32_MAX)
+        return false;
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+
+
+/**
+ * Parse the command line.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param cfg output configuration
+ * @return whether every argument was recognized
+ */
+static bool parse_args(int argc, char** argv, PickConfig* cfg)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--points") == 0)
+            ok = parse_u32(argv[++i], &cfg->points) && cfg->points > 0;
+        else if (ok && strcmp(argv[i], "--picks") == 0)
+            ok = parse_u32(argv[++i], &cfg->picks) && cfg->picks > 0;
+        else
+            ok = false;
+        if (!ok)
+        {
+            fprintf(stderr, "usage: %s [--points N] [--picks N]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+/**
+ * Create the GPU context with the features the DRP2 runtime and its transfer timeline use.
+ *
+ * @return owned GPU context, or NULL on failure
+ */
+static DvzGpuCtx* create_ctx(void)
+{
+    DvzGpuCtxConfig cfg = dvz_gpu_ctx_config();
+    VkPhysicalDeviceVulkan12Features features12 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+        .timelineSemaphore = true,
+    };
+    dvz_gpu_ctx_config_features12(&cfg, &features12);
+    VkPhysicalDeviceVulkan13Features features13 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES,
+        .dynamicRendering = true,
+        .synchronization2 = true,
+    };
+    dvz_gpu_ctx_config_features13(&cfg, &features13);
+    return dvz_gpu_ctx(&cfg);
+}
+
+
+
+/**
+ * Return the position of one spiral point.
+ *
+ * @param i point index
+ * @param count point count
+ * @param out output position
+ */
+static void spiral_point(uint32_t i, uint32_t count, vec3 out)
+{
+    double t = (double)i / (double)count;
+    double angle = 40.0 * DVZ_PI * t;
+    out[0] = (float)(0.9 * t * cos(angle));
+    out[1] = (float)(0.9 * t * sin(angle));
+    out[2] = 0.0f;
+}
+
+
+
+/**
+ * Create a scene with one pickable point cloud on a spiral.
+ *
+ * @param count point count
+ * @param indexed whether the points carry a CPU spatial index
+ * @param out output scene handles
+ * @return whether the scene was created
+ */
+static bool create_scene(uint32_t count, bool indexed, PickScene* out)
+{
+    out->scene = dvz_scene();
+    out->figure = out->scene != NULL ? dvz_figure(out->scene, FIGURE_SIZE, FIGURE_SIZE, 0) : NULL;
+    out->panel = out->figure != NULL ? dvz_panel_full(out->figure) : NULL;
+    out->points = out->scene != NULL ? dvz_point(out->scene, 0) : NULL;
+    vec3* position = (vec3*)calloc(count, sizeof(vec3));
+    float* size = (float*)calloc(count, sizeof(float));
+    bool ok = out->panel != NULL && out->points != NULL && position != NULL && size != NULL;
+    for (uint32_t i = 0; ok && i < count; i++)
+    {
+        spiral_point(i, count, position[i]);
+        size[i] = 6.0f;
+    }
+    if (ok)
+    {
+        dvz_visual_set_query_capabilities(out->points, DVZ_QUERY_CAPABILITY_ITEM);
+        ok = dvz_visual_set_data(out->points, "position", position, count) == DVZ_OK &&
+             dvz_visual_set_data(out->points, "size", size, count) == DVZ_OK &&
+             (!indexed || dvz_visual_set_spatial_index(out->points, true) == DVZ_OK) &&
+             dvz_panel_add_visual(out->panel, out->points, NULL) == DVZ_OK;
+    }
+    free(position);
+    free(size);
+    return ok;
+}
+
+
+
+/**
+ * Return the pointer position of one pick, on a circle around the panel center.
+ *
+ * @param pick pick index
+ * @param out output panel pixel position
+ */
+static void pick_px(uint32_t pick, double out[2])
+{
+    double angle = 2.0 * DVZ_PI * (double)pick / 120.0;
+    out[0] = FIGURE_SIZE * (0.5 + 0.3 * cos(angle));
+    out[1] = FIGURE_SIZE * (0.5 + 0.3 * sin(angle));
+}
+
+
+
+/**
+ * Queue one item pick and resolve it, returning whether the pick produced a result.
+ *
+ * @param s scene handles
+ * @param runtime the runtime, or NULL for CPU-only resolution
+ * @param caps capability snapshot
+ * @param pick pick index
+ * @param hits incremented when the pick hit a point
+ * @return whether the query was queued and resolved
+ */
+static bool pick_once(
+    PickScene* s, DvzDrp2Runtime* runtime, const DvzCapabilitySnapshot* caps, uint32_t pick,
+    uint32_t* hits)
+{
+    double px[2] = {0};
+    pick_px(pick, px);
+    DvzQueryRequest request = dvz_query_request();
+    request.request_id = PICK_REQUEST_ID;
+    request.target = DVZ_SCENE_TARGET_ITEM;
+    if (dvz_panel_query_px(s->panel, px[0], px[1], &request) != DVZ_OK)
+        return false;
+    if (dvz_figure_process_queries(s->figure, runtime, caps) != 1)
+        return false;
+    DvzQueryResult result = {0};
+    while (dvz_scene_poll_query(s->scene, &result))
+        *hits += result.hit ? 1 : 0;
+    return true;
+}
+
+
+
+/**
+ * Report one timing line.
+ *
+ * @param name operation name
+ * @param start start timestamp in nanoseconds
+ * @param count operation count
+ * @param detail trailing detail
+ */
+static void report(const char* name, uint64_t start, uint32_t count, const char* detail)
+{
+    double ms = (double)(dvz_time_monotonic_ns() - start) * 1e-6 / (double)count;
+    printf("%-14s %10.4f ms/op  %s\n", name, ms, detail);
+}
+
+
+
+/**
+ * Time picks, range updates, and region selections through the CPU spatial index.
+ *
+ * @param cfg benchmark configuration
+ * @return whether every operation succeeded
+ */
+static bool bench_cpu(const PickConfig* cfg)
+{
+    PickScene s = {0};
+    bool ok = create_scene(cfg->points, true, &s);
+    DvzCapabilitySnapshot caps = dvz_capability_snapshot();
+    caps.supports_readback = false;
+    uint32_t hits = 0;
+    char detail[64] = {0};
+
+    uint64_t start = dvz_time_monotonic_ns();
+    ok = ok && pick_once(&s, NULL, &caps, 0, &hits);
+    if (ok)
+        report("cpu-build", start, 1, "first pick, includes the index build");
+
+    start = dvz_time_monotonic_ns();
+    for (uint32_t i = 0; ok && i < cfg->picks; i++)
+        ok = pick_once(&s, NULL, &caps, i, &hits);
+    snprintf(detail, sizeof(detail), "%u hits", hits);
+    if (ok)
+        report("cpu-pick", start, cfg->picks, detail);
+
+    // Jitter a batch of points, then pick: the refresh only moves the updated range.
+    vec3 batch[UPDATE_BATCH];
+    uint32_t first = cfg->points > UPDATE_BATCH ? cfg->points / 2 : 0;
+    uint32_t batch_count = cfg->points - first < UPDATE_BATCH ? cfg->points - first : UPDATE_BATCH;
+    start = dvz_time_monotonic_ns();
+    for (uint32_t i = 0; ok && i < cfg->picks; i++)
+    {
+        for (uint32_t j = 0; j < batch_count; j++)
+        {
+            spiral_point(first + j, cfg->points, batch[j]);
+            batch[j][0] += 1e-3f * (float)(i % 7);
+        }
+        ok = dvz_visual_set_data_range(s.points, "position", first, batch, batch_count) ==
+                 DVZ_OK &&
+             pick_once(&s, NULL, &caps, i, &hits);
+    }
+    snprintf(detail, sizeof(detail), "%u-point range update per pick", batch_count);
+    if (ok)
+        report("cpu-update", start, cfg->picks, detail);
+
+    uint64_t selected = 0;
+    start = dvz_time_monotonic_ns();
+    for (uint32_t i = 0; ok && i < cfg->picks; i++)
+    {
+        double half = 0.05 + 0.2 * (double)(i % 5) / 4.0;
+        ok = dvz_visual_query_rect(
+                 s.points, (double[2]){-half, -half}, (double[2]){half, half}, NULL, 0,
+                 &selected) == DVZ_OK;
+    }
+    snprintf(detail, sizeof(detail), "last selection %llu items", (unsigned long long)selected);
+    if (ok)
+        report("cpu-rect", start, cfg->picks, detail);
+
+    double lasso[12] = {0};
+    for (uint32_t v = 0; v < 6; v++)
+    {
+        lasso[2 * v + 0] = 0.5 * cos(2.0 * DVZ_PI * v / 6.0);
+        lasso[2 * v + 1] = 0.5 * sin(2.0 * DVZ_PI * v / 6.0);
+    }
+    start = dvz_time_monotonic_ns();
+    for (uint32_t i = 0; ok && i < cfg->picks; i++)
+        ok = dvz_visual_query_lasso(s.points, lasso, 6, NULL, 0, &selected) == DVZ_OK;
+    snprintf(detail, sizeof(detail), "%llu items", (unsigned long long)selected);
+    if (ok)
+        report("cpu-lasso", start, cfg->picks, detail);
+
+    dvz_scene_destroy(s.scene);
+    if (!ok)
+        fprintf(stderr, "cpu: spatial index query failed\n");
+    return ok;
+}
+
+
+
+/**
+ * Time picks through the GPU query render and readback.
+ *
+ * @param runtime the vklite runtime
+ * @param cfg benchmark configuration
+ * @return whether every pick succeeded
+ */
+static bool bench_gpu(DvzDrp2Runtime* runtime, const PickConfig* cfg)
+{
+    PickScene s = {0};
+    bool ok = create_scene(cfg->points, false, &s);
+    DvzCapabilitySnapshot caps = dvz_capability_snapshot();
+    caps.shader_format_glsl = true;
+    uint32_t hits = 0;
+
+    // The first pick uploads the point cloud into the query executor.
+    ok = ok && pick_once(&s, runtime, &caps, 0, &hits);
+    uint64_t start = dvz_time_monotonic_ns();
+    for (uint32_t i = 0; ok && i < cfg->picks; i++)
+        ok = pick_once(&s, runtime, &caps, i, &hits);
+    char detail[64] = {0};
+    snprintf(detail, sizeof(detail), "%u hits", hits);
+    if (ok)
+        report("gpu-readback", start, cfg->picks, detail);
+
+    dvz_scene_destroy(s.scene);
+    if (!ok)
+        fprintf(stderr, "gpu: query readback failed\n");
+    return ok;
+}
+
+
+
+/*************************************************************************************************/
+/*  Entry-point                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Compare CPU spatial index picks with GPU readback picks on one point cloud.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @return process exit code
+ */
+int main(int argc, char** argv)
+{
+    PickConfig cfg = {
+        .points = 10000000,
+        .picks = 200,
+    };
+    if (!parse_args(argc, argv, &cfg))
+        return 1;
+    printf("%u points, %u picks\n", cfg.points, cfg.picks);
+
+    bool ok = bench_cpu(&cfg);
+
+    DvzGpuCtx* ctx = create_ctx();
+    if (ctx == NULL)
+    {
+        printf("gpu-readback   skipped, no GPU context\n");
+        return ok ? 0 : 1;
+    }
+    DvzDrp2RuntimeConfig runtime_cfg =
+        dvz_drp2_runtime_vklite_config(dvz_gpu_ctx_device(ctx), dvz_gpu_ctx_alloc(ctx));
+    DvzDrp2Runtime* runtime = dvz_drp2_runtime_vklite(&runtime_cfg);
+    ok = ok && runtime != NULL && bench_gpu(runtime, &cfg);
+
+    if (runtime != NULL)
+        dvz_drp2_runtime_destroy(runtime);
+    dvz_gpu_ctx_destroy(ctx);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* text_msdf_throughput - runtime MSDF atlas generation throughput and product cache timings.
+ *
+ * Build:  cmake --build build --target example_c_lab_text_msdf_throughput
+ * Run:    ./build/examples/c/lab/text_msdf_throughput --em 32 --glyphs 256 --iterations 3
+ *
+ * Builds the same Source Sans 3 atlas product serially, with msdf-atlas-gen transient threads,
+ * and on a persistent thread pool, then saves and reloads it from the product cache. Every line
+ * reports glyphs per second.
+ */
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "_alloc.h"
+#include "_scene.h"
+#include "datoviz/common/functions.h"
+#include "datoviz/scene.h"
+#include "text/text_atlas_product_internal.h"
+#include "text/text_internal.h"
+#include "thread_internal.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define THROUGHPUT_MAX_GLYPHS DVZ_SCENE_TEXT_ATLAS_MAX_GLYPHS
+#define THROUGHPUT_PATH_SIZE  1024
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct ThroughputConfig
+{
+    float em_px;
+    uint32_t glyphs;
+    uint32_t threads;
+    uint32_t iterations;
+    const char* cache_path;
+} ThroughputConfig;
+
+
+
+typedef struct ThroughputRun
+{
+    const DvzTextAtlasFontView* primary;
+    const DvzTextAtlasSpec* spec;
+    const uint32_t* codepoints;
+    uint32_t count;
+    DvzTextAtlasProductBudget budget;
+    DvzTextAtlasProductParams params;
+} ThroughputRun;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Parse an unsigned integer argument.
+ *
+ * @param text argument text
+ * @param value output value
+ * @return whether the argument is a valid 32-bit unsigned integer
+ */
+static bool parse_u32(const char* text, uint32_t* value)
+{
+    char* end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*text == '\0' || end == NULL || *end != '\0' || parsed > UINT32_MAX)
+        return false;
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+
+
+/**
+ * Parse the command line.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param cfg output configuration
+ * @return whether every argument was recognized
+ */
+static bool parse_args(int argc, char** argv, ThroughputConfig* cfg)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--em") == 0)
+        {
+            cfg->em_px = (float)atof(argv[++i]);
+            ok = cfg->em_px > 0.0f;
+        }
+        else if (ok && strcmp(argv[i], "--glyphs") == 0)
+            ok = parse_u32(argv[++i], &cfg->glyphs);
+        else if (ok && strcmp(argv[i], "--threads") == 0)
+            ok = parse_u32(argv[++i], &cfg->threads);
+        else if (ok && strcmp(argv[i], "--iterations") == 0)
+            ok = parse_u32(argv[++i], &cfg->iterations);
+        else if (ok && strcmp(argv[i], "--cache") == 0)
+            cfg->cache_path = argv[++i];
+        else
+            ok = false;
+        if (!ok)
+        {
+            fprintf(
+                stderr, "usage: %s [--em PX] [--glyphs N] [--threads N] [--iterations N] "
+                        "[--cache FILE]\n",
+                argv[0]);
+            return false;
+        }
+    }
+    cfg->glyphs = cfg->glyphs == 0 ? 1 : cfg->glyphs;
+    cfg->glyphs = cfg->glyphs > THROUGHPUT_MAX_GLYPHS ? THROUGHPUT_MAX_GLYPHS : cfg->glyphs;
+    cfg->iterations = cfg->iterations == 0 ? 1 : cfg->iterations;
+    return true;
+}
+
+
+
+/**
+ * Fill a canonical set of visible Latin codepoints.
+ *
+ * @param codepoints output codepoints
+ * @param count number of codepoints
+ */
+static void fill_codepoints(uint32_t* codepoints, uint32_t count)
+{
+    uint32_t cp = 0x21u;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        // Skip the C1 controls, the no-break space, and the soft hyphen.
+        if (cp == 0x7Fu)
+            cp = 0xA1u;
+        if (cp == 0xADu)
+            cp++;
+        codepoints[i] = cp++;
+    }
+}
+
+
+
+/**
+ * Build the product repeatedly and report glyphs per second.
+ *
+ * @param run build inputs
+ * @param name configuration name
+ * @param pool thread pool, or NULL for msdf-atlas-gen threads
+ * @param iterations number of builds
+ * @param out_product optional output receiving the last product
+ * @return whether every build succeeded
+ */
+static bool bench_build(
+    const ThroughputRun* run, const char* name, DvzThreadPool* pool, uint32_t iterations,
+    DvzTextAtlasProduct* out_product)
+{
+    uint64_t start = dvz_time_monotonic_ns();
+    for (uint32_t it = 0; it < iterations; it++)
+    {
+        DvzTextAtlasProduct product = {0};
+        if (!_text_atlas_product_build_msdf_pool(
+                run->primary, NULL, run->spec, run->codepoints, run->count, &run->budget,
+                &run->params, pool, &product))
+        {
+            fprintf(stderr, "%s: MSDF product build failed\n", name);
+            return false;
+        }
+        if (out_product != NULL && it + 1 == iterations)
+            *out_product = product;
+        else
+            _text_atlas_product_destroy(&product);
+    }
+    double seconds = (double)(dvz_time_monotonic_ns() - start) * 1e-9;
+    printf(
+        "%-24s %8.2f ms/atlas %10.0f glyphs/s\n", name, seconds * 1e3 / iterations,
+        seconds > 0 ? (double)run->count * iterations / seconds : 0.0);
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Entry-point                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Report runtime MSDF atlas generation and cache throughput.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @return process exit code
+ */
+int main(int argc, char** argv)
+{
+    ThroughputConfig cfg = {
+        .em_px = 32.0f,
+        .glyphs = THROUGHPUT_MAX_GLYPHS,
+        .threads = 0,
+        .iterations = 3,
+        .cache_path = "text_msdf_throughput.dtap",
+    };
+    if (!parse_args(argc, argv, &cfg))
+        return 1;
+    if (!_text_atlas_product_msdf_available())
+    {
+        printf("MSDF atlas generation is not compiled in\n");
+        return 0;
+    }
+
+    DvzScene* scene = dvz_scene();
+    DvzFontDesc desc = dvz_font_desc();
+    desc.family = "Source Sans 3";
+    desc.style = "Regular";
+    DvzFont* font = dvz_font(scene, &desc);
+    if (font == NULL || !_scene_font_ensure_bytes(font))
+    {
+        fprintf(stderr, "failed to load Source Sans 3\n");
+        dvz_scene_destroy(scene);
+        return 1;
+    }
+
+    uint32_t codepoints[THROUGHPUT_MAX_GLYPHS] = {0};
+    fill_codepoints(codepoints, cfg.glyphs);
+    DvzTextAtlasFontView primary = {
+        .bytes = (const uint8_t*)font->ttf_bytes,
+        .size = font->ttf_size,
+        .face_index = (int32_t)font->face_index,
+    };
+    DvzTextAtlasSpec spec = _scene_text_atlas_spec(DVZ_TEXT_ATLAS_BACKEND_MSDF, cfg.em_px);
+    ThroughputRun run = {
+        .primary = &primary,
+        .spec = &spec,
+        .codepoints = codepoints,
+        .count = cfg.glyphs,
+        .budget = _text_atlas_product_budget_default(),
+        .params = _text_atlas_product_params_default(),
+    };
+    DvzThreadPool* pool = dvz_thread_pool(cfg.threads);
+    printf(
+        "MSDF em=%.1f range=%.1f glyphs=%u iterations=%u pool workers=%u\n", (double)spec.em_px,
+        (double)spec.distance_range_px, run.count, cfg.iterations, dvz_thread_pool_size(pool));
+
+    char name[64] = {0};
+    DvzTextAtlasProduct product = {0};
+    uint32_t thread_count = run.params.thread_count;
+    run.params.thread_count = 1;
+    bool ok = bench_build(&run, "serial", NULL, cfg.iterations, NULL);
+    run.params.thread_count = thread_count;
+    snprintf(name, sizeof(name), "msdf-atlas-gen x%u", thread_count);
+    ok = ok && bench_build(&run, name, NULL, cfg.iterations, NULL);
+    snprintf(name, sizeof(name), "thread pool x%u", dvz_thread_pool_size(pool) + 1);
+    ok = ok && bench_build(&run, name, pool, cfg.iterations, &product);
+
+    if (ok)
+    {
+        uint64_t key = _text_atlas_product_cache_key(
+            &primary, NULL, &spec, codepoints, run.count, &run.params);
+        uint64_t start = dvz_time_monotonic_ns();
+        ok = _text_atlas_product_save(&product, key, cfg.cache_path);
+        double save_s = (double)(dvz_time_monotonic_ns() - start) * 1e-9;
+
+        DvzTextAtlasProduct loaded = {0};
+        start = dvz_time_monotonic_ns();
+        ok = ok && _text_atlas_product_load(cfg.cache_path, key, &run.budget, &loaded);
+        double load_s = (double)(dvz_time_monotonic_ns() - start) * 1e-9;
+        if (ok)
+        {
+            printf(
+                "%-24s %8.2f ms/atlas %10.0f glyphs/s (%" PRIu64 " bytes)\n", "cache save",
+                save_s * 1e3, save_s > 0 ? run.count / save_s : 0.0, product.rgba_size);
+            printf(
+                "%-24s %8.2f ms/atlas %10.0f glyphs/s\n", "cache load", load_s * 1e3,
+                load_s > 0 ? run.count / load_s : 0.0);
+        }
+        else
+            fprintf(stderr, "product cache round trip failed: %s\n", cfg.cache_path);
+        _text_atlas_product_destroy(&loaded);
+        remove(cfg.cache_path);
+    }
+
+    _text_atlas_product_destroy(&product);
+    dvz_thread_pool_destroy(pool);
+    dvz_scene_destroy(scene);
+    return ok ? 0 : 1;
+}
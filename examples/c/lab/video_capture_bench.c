@@ -0,0 +1,250 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/* video_capture_bench - offscreen frame rate without capture, with synchronous and queued capture.
+ *
+ * Build:  cmake --build build --target example_c_lab_video_capture_bench
+ * Run:    ./build/examples/c/lab/video_capture_bench --frames 240 --queue 4
+ *
+ * An offscreen view renders an animated point cloud. The same frames run without video capture,
+ * with CPU readback capture encoding on the render thread (queue depth 0), and with the pipelined
+ * readback handing frames to an encoder thread. Every line reports the render loop frame rate and
+ * the total time including the flush at capture stop. Videos are written to --dir.
+ */
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "datoviz/app.h"
+#include "datoviz/canvas/enums.h"
+#include "datoviz/common/functions.h"
+#include "datoviz/scene.h"
+#include "datoviz/video.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define POINT_COUNT   10000
+#define WARMUP_FRAMES 8
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct CaptureConfig
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t frames;
+    uint32_t queue;
+    const char* dir;
+} CaptureConfig;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Parse an unsigned integer argument.
+ *
+ * @param text argument text
+ * @param value output value
+ * @return whether the argument is a valid 32-bit unsigned integer
+ */
+static bool parse_u32(const char* text, uint32_t* value)
+{
+    char* end = NULL;
+    unsigned long parsed = strtoul(text, &end, 10);
+    if (*text == '\0' || end == NULL || *end != '\0' || parsed > UINT32_MAX)
+        return false;
+    *value = (uint32_t)parsed;
+    return true;
+}
+
+
+
+/**
+ * Parse the command line.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @param cfg output configuration
+ * @return whether every argument was recognized
+ */
+static bool parse_args(int argc, char** argv, CaptureConfig* cfg)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--width") == 0)
+            ok = parse_u32(argv[++i], &cfg->width) && cfg->width > 0;
+        else if (ok && strcmp(argv[i], "--height") == 0)
+            ok = parse_u32(argv[++i], &cfg->height) && cfg->height > 0;
+        else if (ok && strcmp(argv[i], "--frames") == 0)
+            ok = parse_u32(argv[++i], &cfg->frames) && cfg->frames > 0;
+        else if (ok && strcmp(argv[i], "--queue") == 0)
+            ok = parse_u32(argv[++i], &cfg->queue) && cfg->queue > 0;
+        else if (ok && strcmp(argv[i], "--dir") == 0)
+            cfg->dir = argv[++i];
+        else
+            ok = false;
+        if (!ok)
+        {
+            fprintf(
+                stderr,
+                "usage: %s [--width N] [--height N] [--frames N] [--queue N] [--dir PATH]\n",
+                argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+/**
+ * Fill the point positions of one animation frame.
+ *
+ * @param position output positions
+ * @param frame frame index
+ */
+static void fill_positions(vec3* position, uint32_t frame)
+{
+    double phase = 0.02 * (double)frame;
+    for (uint32_t i = 0; i < POINT_COUNT; i++)
+    {
+        double angle = 2.0 * DVZ_PI * i / POINT_COUNT;
+        double radius = 0.5 + 0.3 * sin(7.0 * angle + phase);
+        position[i][0] = (float)(radius * cos(angle));
+        position[i][1] = (float)(radius * sin(angle));
+        position[i][2] = 0.0f;
+    }
+}
+
+
+
+/**
+ * Render the animation with or without video capture and report its frame rate.
+ *
+ * @param cfg benchmark configuration
+ * @param mode capture mode name, also the video basename
+ * @param capture whether to record a video
+ * @param queue_depth encoder queue depth, 0 to encode on the render thread
+ * @return whether every frame rendered and the capture stopped cleanly
+ */
+static bool
+bench_mode(const CaptureConfig* cfg, const char* mode, bool capture, uint32_t queue_depth)
+{
+    DvzScene* scene = dvz_scene();
+    DvzFigure* figure = scene != NULL ? dvz_figure(scene, cfg->width, cfg->height, 0) : NULL;
+    DvzPanel* panel = figure != NULL ? dvz_panel_full(figure) : NULL;
+    DvzVisual* point = scene != NULL ? dvz_point(scene, 0) : NULL;
+    vec3* position = (vec3*)calloc(POINT_COUNT, sizeof(vec3));
+    bool ok = panel != NULL && point != NULL && position != NULL;
+    if (ok)
+    {
+        fill_positions(position, 0);
+        ok = dvz_visual_set_data(point, "position", position, POINT_COUNT) == DVZ_OK &&
+             dvz_panel_add_visual(panel, point, NULL) == DVZ_OK;
+    }
+
+    DvzApp* app = ok ? dvz_app(scene) : NULL;
+    DvzView* view = app != NULL ? dvz_view_offscreen(app, figure, cfg->width, cfg->height) : NULL;
+    ok = ok && view != NULL;
+    for (uint32_t frame = 0; ok && frame < WARMUP_FRAMES; frame++)
+        ok = dvz_view_render_once(view) == DVZ_CANVAS_FRAME_READY;
+
+    if (ok && capture)
+    {
+        DvzAppCaptureConfig capture_cfg = dvz_app_capture_config();
+        capture_cfg.flags = DVZ_APP_CAPTURE_VIDEO;
+        capture_cfg.directory = cfg->dir;
+        capture_cfg.basename = mode;
+        capture_cfg.video_capture_mode = DVZ_VIDEO_CAPTURE_CPU_READBACK;
+        capture_cfg.video_queue_depth = queue_depth;
+        ok = dvz_view_capture_start(view, &capture_cfg) == DVZ_OK;
+        if (!ok)
+            fprintf(stderr, "%s: video capture unavailable\n", mode);
+    }
+
+    uint64_t start = dvz_time_monotonic_ns();
+    for (uint32_t frame = 0; ok && frame < cfg->frames; frame++)
+    {
+        fill_positions(position, frame);
+        ok = dvz_visual_set_data(point, "position", position, POINT_COUNT) == DVZ_OK &&
+             dvz_view_render_once(view) == DVZ_CANVAS_FRAME_READY;
+    }
+    uint64_t render = dvz_time_monotonic_ns() - start;
+    if (ok && capture)
+        ok = dvz_view_capture_stop(view) == DVZ_OK;
+    uint64_t total = dvz_time_monotonic_ns() - start;
+
+    if (ok)
+    {
+        double n = (double)cfg->frames;
+        printf(
+            "%-8s %8.1f FPS render %8.3f ms/frame render %8.3f ms/frame with flush\n", mode,
+            n / ((double)render * 1e-9), (double)render * 1e-6 / n, (double)total * 1e-6 / n);
+    }
+    else
+    {
+        fprintf(stderr, "%s: rendering failed\n", mode);
+    }
+
+    free(position);
+    if (app != NULL)
+        dvz_app_destroy(app);
+    if (scene != NULL)
+        dvz_scene_destroy(scene);
+    return ok;
+}
+
+
+
+/*************************************************************************************************/
+/*  Entry-point                                                                                  */
+/*************************************************************************************************/
+
+/**
+ * Report the offscreen frame rate without capture, with synchronous and with queued capture.
+ *
+ * @param argc argument count
+ * @param argv arguments
+ * @return process exit code
+ */
+int main(int argc, char** argv)
+{
+    CaptureConfig cfg = {
+        .width = 1280,
+        .height = 720,
+        .frames = 240,
+        .queue = 4,
+        .dir = ".",
+    };
+    if (!parse_args(argc, argv, &cfg))
+        return 1;
+    printf("%ux%u, %u frames, queue depth %u\n", cfg.width, cfg.height, cfg.frames, cfg.queue);
+
+    bool ok = bench_mode(&cfg, "off", false, 0);
+    ok = bench_mode(&cfg, "sync", true, 0) && ok;
+    ok = bench_mode(&cfg, "queued", true, cfg.queue) && ok;
+    return ok ? 0 : 1;
+}
@@ -189,6 +189,8 @@ struct DvzAppCaptureConfig
     double fps;
     const char* video_backend;
     DvzVideoCaptureMode video_capture_mode;
+    /** CPU readback frames queued to an encoder thread, 0 to encode on the render thread. */
+    uint32_t video_queue_depth;
 };
 
 
@@ -845,7 +847,8 @@ DVZ_EXPORT DvzAppCaptureConfig dvz_app_capture_config(void);
  * `DVZ_CAPTURE` accepts comma-, semicolon-, plus-, colon-, pipe-, or space-separated tokens:
  * `dvzr`, `mp4`/`video`, `png`, `all`, or false-like values (`0`, `false`, `off`, `none`).
  * Optional overrides are `DVZ_CAPTURE_DIR`, `DVZ_CAPTURE_BASENAME`, `DVZ_CAPTURE_FPS`,
- * `DVZ_CAPTURE_VIDEO_BACKEND`, and `DVZ_CAPTURE_VIDEO_MODE` (`auto`, `external`, `cpu`).
+ * `DVZ_CAPTURE_VIDEO_BACKEND`, `DVZ_CAPTURE_VIDEO_MODE` (`auto`, `external`, `cpu`), and
+ * `DVZ_CAPTURE_VIDEO_QUEUE` (CPU readback frames queued to an encoder thread).
  *
  * @param basename fallback output basename, or NULL for "capture"
  * @return the environment-derived capture configuration
@@ -1140,7 +1143,10 @@ dvz_view_set_frame_callback(
  *
  * This is the primary hosted-loop primitive for Qt, SDL, Tk, IPython, and other integrations where
  * the caller owns scheduling. Returns the dvz_canvas_frame() status when no frame was submitted.
- * Disabled views are skipped and return DVZ_CANVAS_FRAME_READY without submitting.
+ * Disabled views are skipped and return DVZ_CANVAS_FRAME_READY without submitting. Views kept
+ * rendering only by continuous work (animations, frame callbacks, continuous scheduling) whose
+ * last emitted DRP2 streams were identical also return DVZ_CANVAS_FRAME_READY without submitting:
+ * animations and the frame callback still run, and any signalled scene change renders again.
  *
  * @param view the view
  * @return DVZ_CANVAS_FRAME_READY after a submitted frame, DVZ_CANVAS_FRAME_WAIT_SURFACE while the
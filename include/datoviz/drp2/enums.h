@@ -60,6 +60,9 @@ typedef enum
     DVZ_DRP2_COMMAND_FINISH_COMMAND_ENCODER,
     DVZ_DRP2_COMMAND_QUEUE_SUBMIT,
     DVZ_DRP2_COMMAND_QUEUE_SUBMIT_REPLY,
+    DVZ_DRP2_COMMAND_DRAW_INDIRECT,
+    DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT,
+    DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT,
 } DvzDrp2CommandType;
 
 
@@ -139,6 +142,7 @@ typedef enum
     DVZ_DRP2_BUFFER_USAGE_INDEX = 0x0020,
     DVZ_DRP2_BUFFER_USAGE_UNIFORM = 0x0040,
     DVZ_DRP2_BUFFER_USAGE_STORAGE = 0x0080,
+    DVZ_DRP2_BUFFER_USAGE_INDIRECT = 0x0100,
 } DvzDrp2BufferUsageFlags;
 
 
@@ -151,6 +155,7 @@ typedef enum
     DVZ_DRP2_TEXTURE_USAGE_TEXTURE_BINDING = 0x0004,
     DVZ_DRP2_TEXTURE_USAGE_STORAGE_BINDING = 0x0008,
     DVZ_DRP2_TEXTURE_USAGE_RENDER_ATTACHMENT = 0x0010,
+    DVZ_DRP2_TEXTURE_USAGE_TRANSIENT_ATTACHMENT = 0x0020, /* contents never outlive the pass */
 } DvzDrp2TextureUsageFlags;
 
 
@@ -131,6 +131,20 @@ DVZ_EXPORT DvzDrp2CommandStream* dvz_drp2_packet_decode_stream(
     DvzDrp2PacketInfo* info);
 
 
+/**
+ * Return a byte-exact 64-bit fingerprint of a command stream.
+ *
+ * The hash covers every command record in packet layout plus its payload bytes, so two streams
+ * with equal fingerprints would encode to the same packet. Debug labels are not hashed. This reads
+ * every payload; per-frame change detection uses the incremental `dvz_drp2_stream_fingerprint()`
+ * and this function is kept for debugging it.
+ *
+ * @param stream the command stream
+ * @return the stream fingerprint
+ */
+DVZ_EXPORT uint64_t dvz_drp2_packet_fingerprint(const DvzDrp2CommandStream* stream);
+
+
 /**
  * Destroy a buffer returned by `dvz_drp2_packet_encode_stream()`.
  *
@@ -27,6 +27,15 @@
 
 EXTERN_C_ON
 
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+/* Memory budget that follows the device-local budget reported by the allocator. */
+#define DVZ_DRP2_MEMORY_BUDGET_DEVICE UINT64_MAX
+
+
+
 /*************************************************************************************************/
 /*  Structs                                                                                      */
 /*************************************************************************************************/
@@ -35,6 +44,7 @@ typedef struct DvzDrp2ValidationResult DvzDrp2ValidationResult;
 typedef struct DvzDrp2RuntimeConfig DvzDrp2RuntimeConfig;
 typedef struct DvzDrp2ExternalBufferDesc DvzDrp2ExternalBufferDesc;
 typedef struct DvzDrp2ExternalBufferTimelineDesc DvzDrp2ExternalBufferTimelineDesc;
+typedef struct DvzDrp2MemoryStats DvzDrp2MemoryStats;
 typedef struct DvzDevice DvzDevice;
 typedef struct DvzStreamFrame DvzStreamFrame;
 typedef struct DvzVma DvzVma;
@@ -80,6 +90,24 @@ struct DvzDrp2ExternalBufferTimelineDesc
 };
 
 
+struct DvzDrp2MemoryStats
+{
+    uint32_t struct_size;
+    uint32_t flags;
+    uint64_t budget;         /* enforced device-local budget, 0 when disabled */
+    uint64_t device_usage;   /* allocator device-local usage, all owners and resources */
+    uint64_t device_budget;  /* allocator device-local budget */
+    uint64_t resident_bytes; /* device-local runtime buffers and textures */
+    uint64_t host_bytes;     /* host-visible runtime buffers */
+    uint64_t evicted_bytes;  /* textures demoted to host memory */
+    uint32_t resident_count;
+    uint32_t evicted_count;
+    uint64_t eviction_count; /* cumulative since the last reset, all owners */
+    uint64_t restore_count;
+    uint64_t restore_bytes;
+};
+
+
 
 /*************************************************************************************************/
 /*  Functions                                                                                    */
@@ -280,4 +308,55 @@ DVZ_EXPORT bool dvz_drp2_runtime_copy_texture_to_frame(
 DVZ_EXPORT bool dvz_drp2_runtime_download_buffer(
     DvzDrp2Runtime* runtime, uint64_t buffer_id, uint64_t offset, uint64_t size, void* dst);
 
+
+/**
+ * Set the device-local memory budget enforced at the start of every execution.
+ *
+ * While runtime-owned buffers and textures exceed the budget, the sampled textures least recently
+ * referenced by an executed stream are copied to host memory and their images are released, as
+ * long as no stream referenced them during the last two frames counted by
+ * dvz_drp2_runtime_begin_frame(). A demoted texture is uploaded again, under the same id, before
+ * the next stream that references it executes. Render targets, storage and multisampled
+ * textures, and buffers are never demoted. Eviction blocks on the copy. Eviction is disabled
+ * until a budget is set.
+ *
+ * @param runtime the vklite runtime
+ * @param bytes budget in bytes, `DVZ_DRP2_MEMORY_BUDGET_DEVICE` to follow the allocator's
+ * device-local budget, or 0 to disable eviction
+ * @return false for NULL or semantic-only runtimes
+ */
+DVZ_EXPORT bool dvz_drp2_runtime_set_memory_budget(DvzDrp2Runtime* runtime, uint64_t bytes);
+
+
+/**
+ * Tag the buffers and textures created by later executions with an owner, such as a figure.
+ *
+ * @param runtime the runtime
+ * @param owner nonzero owner tag, or 0 to stop tagging
+ */
+DVZ_EXPORT void dvz_drp2_runtime_set_memory_owner(DvzDrp2Runtime* runtime, uint64_t owner);
+
+
+
+/**
+ * Start a new frame of the clock that ages textures for memory budget eviction.
+ *
+ * Call it once per frame, however many owners execute streams during that frame.
+ *
+ * @param runtime the runtime
+ */
+DVZ_EXPORT void dvz_drp2_runtime_begin_frame(DvzDrp2Runtime* runtime);
+
+
+/**
+ * Return the memory usage of runtime-owned buffers and textures.
+ *
+ * @param runtime the runtime
+ * @param owner owner tag to report, or 0 for every resource
+ * @param[out] stats memory statistics
+ * @return false for NULL arguments
+ */
+DVZ_EXPORT bool dvz_drp2_runtime_memory_stats(
+    const DvzDrp2Runtime* runtime, uint64_t owner, DvzDrp2MemoryStats* stats);
+
 EXTERN_C_OFF
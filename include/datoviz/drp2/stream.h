@@ -884,6 +884,36 @@ DVZ_EXPORT bool dvz_drp2_stream_write_texture_3d_borrowed(
     uint32_t bytes_per_row, uint32_t rows_per_image, const void* data);
 
 
+/**
+ * Declare the content version of the most recently appended WriteBuffer or WriteTexture payload.
+ *
+ * Emitters that version their resources set this so that `dvz_drp2_stream_fingerprint()` hashes
+ * the version instead of the payload. Equal versions of a resource must carry equal bytes.
+ *
+ * @param stream the command stream
+ * @param version content version, or 0 to hash the payload
+ * @return whether the most recent command was a write and was updated
+ */
+DVZ_EXPORT bool
+dvz_drp2_stream_set_payload_version(DvzDrp2CommandStream* stream, uint64_t version);
+
+
+/**
+ * Return the fingerprint accumulated while the stream was built.
+ *
+ * Commands are folded as they are appended: each record in packet layout, plus the declared
+ * payload version of writes, or the payload itself for unversioned writes up to 256 bytes.
+ * Larger unversioned payloads are not read; the fingerprint is then reported as unreliable.
+ * `dvz_drp2_packet_fingerprint()` remains the byte-exact variant for debugging.
+ *
+ * @param stream the command stream
+ * @param[out] fingerprint the stream fingerprint
+ * @return false when the stream is NULL or carries a large unversioned payload
+ */
+DVZ_EXPORT bool
+dvz_drp2_stream_fingerprint(const DvzDrp2CommandStream* stream, uint64_t* fingerprint);
+
+
 
 /**
  * Append a BeginCommandEncoder command.
@@ -1242,6 +1272,75 @@ DVZ_EXPORT bool dvz_drp2_stream_draw_indexed(
 
 
 
+/**
+ * Append a DrawIndirect command.
+ *
+ * The indirect buffer holds one `DVZ_DRP2_DRAW_INDIRECT_ARGS_SIZE` record laid out as
+ * `VkDrawIndirectCommand` and must have been created with `DVZ_DRP2_BUFFER_USAGE_INDIRECT`.
+ *
+ * @param stream the command stream
+ * @param pass_id the pass id
+ * @param buffer_id the indirect argument buffer id
+ * @param offset the byte offset of the record, a multiple of 4
+ * @return whether the command was appended
+ */
+DVZ_EXPORT bool dvz_drp2_stream_draw_indirect(
+    DvzDrp2CommandStream* stream, uint64_t pass_id, uint64_t buffer_id, uint64_t offset);
+
+
+
+/**
+ * Append a DrawIndexedIndirect command.
+ *
+ * The indirect buffer holds one `DVZ_DRP2_DRAW_INDEXED_INDIRECT_ARGS_SIZE` record laid out as
+ * `VkDrawIndexedIndirectCommand` and must have been created with
+ * `DVZ_DRP2_BUFFER_USAGE_INDIRECT`.
+ *
+ * @param stream the command stream
+ * @param pass_id the pass id
+ * @param buffer_id the indirect argument buffer id
+ * @param offset the byte offset of the record, a multiple of 4
+ * @return whether the command was appended
+ */
+DVZ_EXPORT bool dvz_drp2_stream_draw_indexed_indirect(
+    DvzDrp2CommandStream* stream, uint64_t pass_id, uint64_t buffer_id, uint64_t offset);
+
+
+
+/**
+ * Append a multi-draw DrawIndirect command reading several consecutive records.
+ *
+ * @param stream the command stream
+ * @param pass_id the pass id
+ * @param buffer_id the indirect argument buffer id
+ * @param offset the byte offset of the first record, a multiple of 4
+ * @param draw_count the number of records to draw, at least 1
+ * @param stride the byte stride between records, 0 for tightly packed records
+ * @return whether the command was appended
+ */
+DVZ_EXPORT bool dvz_drp2_stream_multi_draw_indirect(
+    DvzDrp2CommandStream* stream, uint64_t pass_id, uint64_t buffer_id, uint64_t offset,
+    uint32_t draw_count, uint32_t stride);
+
+
+
+/**
+ * Append a multi-draw DrawIndexedIndirect command reading several consecutive records.
+ *
+ * @param stream the command stream
+ * @param pass_id the pass id
+ * @param buffer_id the indirect argument buffer id
+ * @param offset the byte offset of the first record, a multiple of 4
+ * @param draw_count the number of records to draw, at least 1
+ * @param stride the byte stride between records, 0 for tightly packed records
+ * @return whether the command was appended
+ */
+DVZ_EXPORT bool dvz_drp2_stream_multi_draw_indexed_indirect(
+    DvzDrp2CommandStream* stream, uint64_t pass_id, uint64_t buffer_id, uint64_t offset,
+    uint32_t draw_count, uint32_t stride);
+
+
+
 /**
  * Append an EndRenderPass command.
  *
@@ -1268,6 +1367,23 @@ DVZ_EXPORT bool dvz_drp2_stream_dispatch_workgroups(
 
 
 
+/**
+ * Append a DispatchWorkgroupsIndirect command.
+ *
+ * The indirect buffer holds one `DVZ_DRP2_DISPATCH_INDIRECT_ARGS_SIZE` record laid out as
+ * `VkDispatchIndirectCommand` and must have been created with `DVZ_DRP2_BUFFER_USAGE_INDIRECT`.
+ *
+ * @param stream the command stream
+ * @param pass_id the compute pass id
+ * @param buffer_id the indirect argument buffer id
+ * @param offset the byte offset of the record, a multiple of 4
+ * @return whether the command was appended
+ */
+DVZ_EXPORT bool dvz_drp2_stream_dispatch_workgroups_indirect(
+    DvzDrp2CommandStream* stream, uint64_t pass_id, uint64_t buffer_id, uint64_t offset);
+
+
+
 /**
  * Append an EndComputePass command.
  *
@@ -1282,15 +1398,16 @@ DVZ_EXPORT bool dvz_drp2_stream_end_compute_pass(DvzDrp2CommandStream* stream, u
  * Append a ResourceBarrier command for a buffer range.
  *
  * The first active DRP2 barrier slice covers compute storage writes made visible to a later vertex
- * input or copy read in the same command encoder.
+ * input, indirect argument read ("DRAW_INDIRECT", "INDIRECT_READ"), or copy read in the same
+ * command encoder.
  *
  * @param stream the command stream
  * @param encoder_id the open command encoder id
  * @param buffer_id the buffer id
  * @param src_stage the producer stage, such as "COMPUTE"
  * @param src_access the producer access, such as "STORAGE_WRITE"
- * @param dst_stage the consumer stage, such as "VERTEX_INPUT" or "COPY"
- * @param dst_access the consumer access, such as "VERTEX_READ" or "COPY_READ"
+ * @param dst_stage the consumer stage, such as "VERTEX_INPUT", "DRAW_INDIRECT", or "COPY"
+ * @param dst_access the consumer access, such as "VERTEX_READ", "INDIRECT_READ", or "COPY_READ"
  * @param offset the first byte in the synchronized range
  * @param size the synchronized byte size, or 0 for the rest of the buffer
  * @return whether the command was appended
@@ -32,6 +32,11 @@
 #define DVZ_DRP2_MAX_BINDINGS 16
 #define DVZ_DRP2_MAX_COLOR_ATTACHMENTS 4
 
+/* Byte sizes of the packed records read by indirect commands (VkDraw*IndirectCommand layout). */
+#define DVZ_DRP2_DRAW_INDIRECT_ARGS_SIZE         16
+#define DVZ_DRP2_DRAW_INDEXED_INDIRECT_ARGS_SIZE 20
+#define DVZ_DRP2_DISPATCH_INDIRECT_ARGS_SIZE     12
+
 typedef struct DvzDrp2CommandStream DvzDrp2CommandStream;
 typedef struct DvzDrp2Command DvzDrp2Command;
 typedef struct DvzDrp2Runtime DvzDrp2Runtime;
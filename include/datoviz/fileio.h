@@ -17,3 +17,4 @@
 /*************************************************************************************************/
 
 #include "fileio/fileio.h"
+#include "fileio/npy.h"
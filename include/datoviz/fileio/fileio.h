@@ -72,7 +72,7 @@ DVZ_EXPORT char* dvz_read_text(const char* filename, DvzSize* size);
  * Read the data payload of a NumPy NPY v1 file.
  *
  * This minimal reader strips the NPY header but does not expose or convert the array dtype, shape,
- * byte order, or storage order.
+ * byte order, or storage order. Use `dvz_npy_open()` to map large arrays without copying them.
  *
  * @param filename path of the file to open; must not be NULL
  * @param[out] size optional destination receiving the payload size in bytes
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  NumPy NPY/NPZ arrays                                                                         */
+/*************************************************************************************************/
+
+#ifndef DVZ_HEADER_FILEIO_NPY
+#define DVZ_HEADER_FILEIO_NPY
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "datoviz/common/macros.h"
+#include "datoviz/math/types.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_NPY_MAX_NDIM 8
+
+
+
+/*************************************************************************************************/
+/*  Enums                                                                                        */
+/*************************************************************************************************/
+
+typedef enum
+{
+    DVZ_NPY_DTYPE_UNKNOWN = 0,
+    DVZ_NPY_DTYPE_BOOL,
+    DVZ_NPY_DTYPE_INT8,
+    DVZ_NPY_DTYPE_UINT8,
+    DVZ_NPY_DTYPE_INT16,
+    DVZ_NPY_DTYPE_UINT16,
+    DVZ_NPY_DTYPE_INT32,
+    DVZ_NPY_DTYPE_UINT32,
+    DVZ_NPY_DTYPE_INT64,
+    DVZ_NPY_DTYPE_UINT64,
+    DVZ_NPY_DTYPE_FLOAT16,
+    DVZ_NPY_DTYPE_FLOAT32,
+    DVZ_NPY_DTYPE_FLOAT64,
+} DvzNpyDtype;
+
+
+
+typedef enum
+{
+    DVZ_NPY_ACCESS_NORMAL = 0,
+    DVZ_NPY_ACCESS_SEQUENTIAL,
+    DVZ_NPY_ACCESS_RANDOM,
+} DvzNpyAccess;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzNpyInfo
+{
+    DvzNpyDtype dtype;
+    uint32_t item_size;         /* Bytes per scalar item. */
+    bool byte_swapped;          /* Items are stored in the non-native byte order. */
+    bool fortran_order;         /* Column-major storage; row accessors are unavailable. */
+    uint32_t ndim;              /* 0 for a scalar array. */
+    uint64_t shape[DVZ_NPY_MAX_NDIM];
+    uint64_t row_count;         /* Length of the first axis, 1 for a scalar array. */
+    DvzSize row_size;           /* Bytes per row along the first axis. */
+    DvzSize data_size;          /* Payload size in bytes. */
+};
+typedef struct DvzNpyInfo DvzNpyInfo;
+
+typedef struct DvzNpy DvzNpy;
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+EXTERN_C_ON
+
+
+
+/**
+ * Parse an NPY header (format versions 1 to 3).
+ *
+ * Only plain numeric dtypes are recognized; structured, string, and object dtypes are rejected.
+ *
+ * @param bytes start of the NPY file; must not be NULL
+ * @param size_bytes number of readable bytes at @p bytes, at least the full header
+ * @param[out] info destination receiving the array description; must not be NULL
+ * @param[out] data_offset optional destination receiving the payload offset in bytes
+ * @return zero on success, nonzero for an invalid or unsupported header
+ */
+DVZ_EXPORT int dvz_npy_parse_header(
+    const void* bytes, DvzSize size_bytes, DvzNpyInfo* info, DvzSize* data_offset);
+
+
+
+/**
+ * Open an NPY file as a memory-mapped array.
+ *
+ * The header is parsed eagerly and the payload is mapped read-only; pages are only read from disk
+ * when they are first accessed. When the payload cannot be mapped, for example because it exceeds
+ * the address space, the array falls back to streaming mode where only `dvz_npy_read_rows()` is
+ * available.
+ *
+ * @param filename path of the NPY file; must not be NULL
+ * @return array handle, or NULL on failure; close with `dvz_npy_close()`
+ */
+DVZ_EXPORT DvzNpy* dvz_npy_open(const char* filename);
+
+
+
+/**
+ * Open one array stored in an NPZ archive.
+ *
+ * Arrays stored without compression (`numpy.savez`) are memory-mapped in place like
+ * `dvz_npy_open()`. Compressed arrays (`numpy.savez_compressed`) are inflated into an owned buffer
+ * and require zlib support.
+ *
+ * @param filename path of the NPZ archive; must not be NULL
+ * @param name array name, with or without the `.npy` suffix; must not be NULL
+ * @return array handle, or NULL on failure; close with `dvz_npy_close()`
+ */
+DVZ_EXPORT DvzNpy* dvz_npz_open(const char* filename, const char* name);
+
+
+
+/**
+ * Copy the array description.
+ *
+ * @param npy the array
+ * @param[out] out destination receiving the description; must not be NULL
+ * @return whether the description was copied
+ */
+DVZ_EXPORT bool dvz_npy_info(const DvzNpy* npy, DvzNpyInfo* out);
+
+
+
+/**
+ * Return the whole array payload without copying it.
+ *
+ * @param npy the array
+ * @return borrowed read-only payload valid until `dvz_npy_close()`, or NULL in streaming mode
+ */
+DVZ_EXPORT const void* dvz_npy_data(const DvzNpy* npy);
+
+
+
+/**
+ * Return a range of rows along the first axis without copying them.
+ *
+ * The range is prefetched asynchronously. The returned pointer can be passed as borrowed data to
+ * visual setters or as `DvzFieldDataView.data` to `dvz_sampled_field_update_region()`, one chunk
+ * of rows at a time.
+ *
+ * @param npy the array
+ * @param row_start first row
+ * @param row_count number of rows
+ * @return borrowed read-only rows valid until `dvz_npy_close()`, or NULL if the range is out of
+ * bounds, the array is in Fortran order, or the array is in streaming mode
+ */
+DVZ_EXPORT const void* dvz_npy_rows(DvzNpy* npy, uint64_t row_start, uint64_t row_count);
+
+
+
+/**
+ * Drop the resident pages of a range of rows once they have been consumed.
+ *
+ * This keeps the resident set bounded when streaming through arrays larger than RAM. The rows
+ * remain readable and are read again from disk if accessed later.
+ *
+ * @param npy the array
+ * @param row_start first row
+ * @param row_count number of rows
+ */
+DVZ_EXPORT void dvz_npy_evict_rows(DvzNpy* npy, uint64_t row_start, uint64_t row_count);
+
+
+
+/**
+ * Copy a range of rows along the first axis into a caller buffer.
+ *
+ * This works in both mapped and streaming mode and never keeps more than the requested rows in
+ * memory.
+ *
+ * @param npy the array
+ * @param row_start first row
+ * @param row_count number of rows
+ * @param[out] dst destination buffer; must not be NULL
+ * @param dst_size size of @p dst in bytes, at least `row_count * row_size`
+ * @return zero on success, nonzero for an invalid range or a read failure
+ */
+DVZ_EXPORT int dvz_npy_read_rows(
+    DvzNpy* npy, uint64_t row_start, uint64_t row_count, void* dst, DvzSize dst_size);
+
+
+
+/**
+ * Hint the expected access pattern of the mapped payload.
+ *
+ * @param npy the array
+ * @param access expected access pattern
+ */
+DVZ_EXPORT void dvz_npy_advise(DvzNpy* npy, DvzNpyAccess access);
+
+
+
+/**
+ * Unmap and close an array.
+ *
+ * @param npy the array, or NULL
+ */
+DVZ_EXPORT void dvz_npy_close(DvzNpy* npy);
+
+
+
+EXTERN_C_OFF
+
+#endif
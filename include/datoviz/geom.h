@@ -51,6 +51,38 @@ DVZ_EXPORT DvzGeometry* dvz_geometry(uint32_t vertex_count, uint32_t index_count
 
 
 
+/**
+ * Allocate a geometry object with owned single-precision vertex arrays.
+ *
+ * The geometry uses `DVZ_GEOMETRY_PRECISION_F32`: `positions_f32`, `normals_f32`, and
+ * `texcoords_f32` are allocated and the F64 arrays are NULL. This halves the host memory of
+ * positions, normals, and texture coordinates, and `dvz_mesh_set_geometry()` uploads these arrays
+ * without a conversion pass. Destroy it with `dvz_geometry_destroy()`.
+ *
+ * @param vertex_count number of vertices to allocate; may be zero for an empty geometry
+ * @param index_count number of indices to allocate; may be zero for non-indexed geometry
+ * @return new owned geometry, or NULL on invalid input or allocation failure
+ */
+DVZ_EXPORT DvzGeometry* dvz_geometry_f32(uint32_t vertex_count, uint32_t index_count);
+
+
+
+/**
+ * Convert the vertex attributes of a geometry to another storage precision in place.
+ *
+ * Positions, normals, and texture coordinates are reallocated in the target precision and the
+ * previous arrays are released, so pointers to them become invalid. Converting to F32 rounds each
+ * value to the nearest float. On failure the geometry is left unchanged.
+ *
+ * @param geometry geometry to convert; must not be NULL
+ * @param precision target storage precision
+ * @return DVZ_OK on success, DVZ_ERROR on invalid input or allocation failure
+ */
+DVZ_EXPORT DvzResult
+dvz_geometry_set_precision(DvzGeometry* geometry, DvzGeometryPrecision precision);
+
+
+
 /**
  * Free all buffers owned by a geometry object and reset it to an empty state.
  *
@@ -83,6 +115,10 @@ DVZ_EXPORT DvzGeometryBounds dvz_geometry_bounds(const DvzGeometry* geometry);
 /**
  * Recompute smooth vertex normals from triangle indices.
  *
+ * On large meshes the vertex-to-triangle adjacency is built once, cached on the geometry, and
+ * reused while the index buffer is unchanged; normals are then gathered per vertex on a thread
+ * pool created for the call. Results are identical to the serial accumulation.
+ *
  * @param geometry indexed triangle geometry to update; must not be NULL
  * @return DVZ_OK on success, DVZ_ERROR on invalid input
  */
@@ -104,6 +140,8 @@ DVZ_EXPORT DvzResult dvz_geometry_transform(DvzGeometry* geometry, dmat4 transfo
 /**
  * Merge several geometry objects into one indexed geometry.
  *
+ * The merged geometry uses F32 storage when every input does, and F64 storage otherwise.
+ *
  * @param count number of input geometry pointers; must be positive
  * @param geometries array of @p count borrowed geometry pointers; entries must not be NULL
  * @return new owned merged geometry, or NULL on invalid input or allocation failure; destroy with
@@ -137,7 +175,15 @@ DVZ_EXPORT void dvz_geometry_edges_destroy(DvzGeometryEdges* edges);
 /**
  * Extract contour line segments from indexed triangle geometry and per-vertex scalar values.
  *
- * @param geometry borrowed indexed triangle geometry; must not be NULL
+ * Segments are ordered by triangle, then by level. The cost is proportional to the number of
+ * triangles; with ascending levels, each triangle only visits the levels inside its value range.
+ * Large meshes are processed in triangle blocks on a thread pool created for the call. The
+ * geometry is non-const because its cached topology is refreshed, so calls on the same geometry
+ * must not run concurrently. Neighboring triangles produce bitwise identical endpoints on their
+ * shared edge.
+ *
+ * @param geometry borrowed indexed triangle geometry, whose topology cache may be refreshed; must
+ * not be NULL
  * @param values array containing one scalar per geometry vertex; must not be NULL
  * @param value_count number of values; must equal the geometry vertex count
  * @param levels array of contour levels; must not be NULL
@@ -146,7 +192,7 @@ DVZ_EXPORT void dvz_geometry_edges_destroy(DvzGeometryEdges* edges);
  * `dvz_geometry_contours_destroy()`
  */
 DVZ_EXPORT DvzGeometryContours* dvz_geometry_contours(
-    const DvzGeometry* geometry, const double* values, uint32_t value_count, const double* levels,
+    DvzGeometry* geometry, const double* values, uint32_t value_count, const double* levels,
     uint32_t level_count);
 
 
@@ -396,6 +442,11 @@ DVZ_EXPORT DvzGeometryObjDesc dvz_geometry_obj_desc(void);
  * indices. Faces are triangulated as fans. Missing texture coordinates default to `(0, 0)` and
  * missing normals are computed. Materials, objects, groups, and smoothing records are ignored.
  *
+ * Large files are memory-mapped and parsed in line-aligned chunks on a temporary thread pool.
+ * When `desc->cache_path` is set, the loaded vertex arrays are written to that binary cache file,
+ * keyed by the size and modification time of @p filename, and later loads with the same precision
+ * read the cache instead of parsing the OBJ file.
+ *
  * @param filename OBJ file path; must not be NULL
  * @param desc optional borrowed loader descriptor, or NULL for defaults
  * @return new owned geometry, or NULL on unsupported input, allocation, or I/O failure; destroy
@@ -53,6 +53,24 @@ typedef enum
 
 
 
+// Storage precision of geometry vertex attributes.
+typedef enum
+{
+    DVZ_GEOMETRY_PRECISION_F64 = 0, // dvec3/dvec2 positions, normals, and texcoords
+    DVZ_GEOMETRY_PRECISION_F32 = 1, // vec3/vec2 arrays, uploaded to meshes without conversion
+} DvzGeometryPrecision;
+
+
+
+// Geometry builder descriptor flags.
+typedef enum
+{
+    DVZ_GEOMETRY_DESC_NONE = 0x00, // default F64 storage
+    DVZ_GEOMETRY_DESC_F32 = 0x01,  // return a DVZ_GEOMETRY_PRECISION_F32 geometry
+} DvzGeometryDescFlags;
+
+
+
 // Polygon triangulation backend.
 typedef enum
 {
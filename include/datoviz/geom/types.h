@@ -51,6 +51,7 @@ typedef struct DvzGeometryEdge DvzGeometryEdge;
 typedef struct DvzGeometryEdges DvzGeometryEdges;
 typedef struct DvzGeometryContourSegment DvzGeometryContourSegment;
 typedef struct DvzGeometryContours DvzGeometryContours;
+typedef struct DvzGeometryTopology DvzGeometryTopology;
 
 
 
@@ -62,6 +63,7 @@ struct DvzGeometry
 {
     DvzGeometryType type; // geometry source/type
     uint32_t flags;      // DvzGeometryIndexingFlags and future metadata flags
+    DvzGeometryPrecision precision; // which of the F64 or F32 attribute arrays are allocated
 
     uint32_t vertex_count; // number of vertices
     uint32_t index_count;  // number of triangle-list indices
@@ -78,11 +80,17 @@ struct DvzGeometry
      * Owned arrays released by dvz_geometry_destroy(). Callers may edit element contents but must
      * not free, reallocate, replace these pointers, or desynchronize them from the count fields.
      */
-    dvec3* positions;  // F64 3D positions
-    dvec3* normals;    // F64 3D normal vectors
+    dvec3* positions;  // F64 3D positions, NULL for F32 geometries
+    dvec3* normals;    // F64 3D normal vectors, NULL for F32 geometries
     DvzColor* colors;  // RGBA color of each vertex
-    dvec2* texcoords;  // F64 texture coordinates
+    dvec2* texcoords;  // F64 texture coordinates, NULL for F32 geometries
     DvzIndex* indices; // triangle-list index buffer
+
+    vec3* positions_f32; // F32 3D positions, NULL for F64 geometries
+    vec3* normals_f32;   // F32 3D normal vectors, NULL for F64 geometries
+    vec2* texcoords_f32; // F32 texture coordinates, NULL for F64 geometries
+
+    DvzGeometryTopology* topology; // owned opaque cache of index-derived adjacency, may be NULL
 };
 
 
@@ -264,7 +272,8 @@ struct DvzGeometryObjDesc
 {
     uint32_t struct_size;
     uint32_t flags;
-    DvzColor color; // vertex color, defaults to opaque white when all channels are zero
+    DvzColor color;         // vertex color, defaults to opaque white when all channels are zero
+    const char* cache_path; // optional binary mesh cache file, NULL to always parse the OBJ file
 };
 
 
@@ -61,6 +61,19 @@ DVZ_EXPORT int dvz_threads_get(void);
 
 
 
+/**
+ * Return the default number of worker threads for a given processor count.
+ *
+ * This is `DVZ_NUM_THREADS` when set (nonpositive values are relative to the processor count),
+ * otherwise half of the processors, clamped between one and the processor count.
+ *
+ * @param num_procs number of available processors
+ * @return default thread count, between 1 and max(num_processors, 1)
+ */
+DVZ_EXPORT int dvz_threads_default_count(int num_procs);
+
+
+
 /**
  * Set the number of threads to use in OpenMP-aware functions based on DVZ_NUM_THREADS, or take
  * half of dvz_num_procs().
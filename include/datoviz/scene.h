@@ -2387,6 +2387,24 @@ DVZ_EXPORT DvzResult
 dvz_scene_buffer_set_data(DvzSceneBuffer* buffer, const void* data, uint64_t byte_size);
 
 
+/**
+ * Overwrite a byte range of a scene-owned buffer resource.
+ *
+ * The buffer must already hold a full payload from `dvz_scene_buffer_set_data()`. The range is
+ * copied before this function returns and must lie inside the buffer and be aligned to its stride.
+ * Only the dirty range is uploaded on the next frame; several updates before that frame coalesce
+ * into their enclosing range.
+ *
+ * @param buffer the buffer
+ * @param byte_offset first byte to overwrite
+ * @param data the packed payload borrowed for the duration of the call
+ * @param byte_size the payload size in bytes
+ * @return DVZ_OK on success, DVZ_ERROR on error
+ */
+DVZ_EXPORT DvzResult dvz_scene_buffer_update_data(
+    DvzSceneBuffer* buffer, uint64_t byte_offset, const void* data, uint64_t byte_size);
+
+
 /**
  * Copy immutable buffer descriptor information.
  * @param buffer the buffer
@@ -3059,6 +3077,26 @@ DVZ_EXPORT DvzVisual* dvz_mesh(DvzScene* scene, uint32_t flags);
 DVZ_EXPORT DvzResult dvz_mesh_set_geometry(DvzVisual* visual, const DvzGeometry* geometry);
 
 
+/**
+ * Drive a mesh visual from a surface grid whose heights live in a sampled field.
+ *
+ * The grid must come from `dvz_geometry_surface_grid()` and the field must be a 2D R32_FLOAT
+ * field of `cols x rows` texels. Positions and normals are computed on the GPU by the returned
+ * scene compute pass, which the caller attaches with `dvz_figure_add_compute()`. Later field
+ * updates only upload the changed rows, so scrolling one row of a large surface costs one row
+ * upload per frame. Calling `dvz_mesh_set_geometry()` leaves this mode.
+ *
+ * @param visual the mesh visual
+ * @param grid the surface grid geometry providing the grid layout, colors, and texcoords
+ * @param heights the 2D R32_FLOAT height field
+ * @param shader_format the compute shader language matching the runtime backend
+ * @return the owned compute pass, or NULL on invalid input
+ */
+DVZ_EXPORT DvzSceneCompute* dvz_mesh_set_surface_field(
+    DvzVisual* visual, const DvzGeometry* grid, DvzSampledField* heights,
+    DvzSceneShaderFormat shader_format);
+
+
 /**
  * Create a scene-owned semantic graph object.
  *
@@ -333,7 +333,8 @@ DVZ_EXPORT DvzResult dvz_sampled_field_resize(
  *
  * `region` must be non-empty and fully inside the current field extent. `view->data` must cover the
  * subregion and is copied before return. This operation is unavailable while the field borrows an
- * external buffer.
+ * external buffer. The region is logical: with a ring origin, it is written at its physical
+ * samples and split where it crosses the ring seam.
  *
  * @param field the sampled field
  * @param region the updated sample-space region
@@ -344,6 +345,27 @@ DVZ_EXPORT DvzResult dvz_sampled_field_update_region(
     DvzSampledField* field, DvzFieldRegion region, const DvzFieldDataView* view);
 
 
+/**
+ * Set the physical sample holding the logical origin of a circular field.
+ *
+ * Rolling acquisitions keep a fixed-size field and overwrite the oldest samples in place. Logical
+ * sample `i` along each axis lives at physical sample `(i + origin) % extent`: to append one row,
+ * advance `y` by one and write the last logical row with dvz_sampled_field_update_region(). Image,
+ * textured mesh, and volume shaders, their sample queries, and GPU mesh surfaces honor the origin.
+ * Moving it uploads no sample data. Samplers still clamp in physical space, so linear filtering
+ * does not blend across the ring seam. dvz_sampled_field_set_data() and
+ * dvz_sampled_field_resize() take logical payloads and reset the origin to zero.
+ *
+ * @param field the sampled field
+ * @param x physical column of logical column 0
+ * @param y physical row of logical row 0
+ * @param z physical slice of logical slice 0 (must be 0 for 2D fields)
+ * @return DVZ_OK on success, DVZ_ERROR when the origin is outside the field extent
+ */
+DVZ_EXPORT DvzResult
+dvz_sampled_field_set_ring_origin(DvzSampledField* field, uint32_t x, uint32_t y, uint32_t z);
+
+
 /**
  * Update the field geometry metadata.
  *
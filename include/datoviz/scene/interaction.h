@@ -118,6 +118,171 @@ DVZ_EXPORT DvzResult dvz_interaction_set_auto_pin_readout(
 DVZ_EXPORT DvzResult dvz_visual_set_query_capabilities(DvzVisual* visual, uint32_t capabilities);
 
 
+/**
+ * Enable or disable the CPU spatial index of a visual.
+ *
+ * Point, pixel, and marker visuals are indexed with a uniform grid over their xy positions; mesh
+ * and primitive visuals with triangle topology use a bounding-volume hierarchy over their
+ * triangles. Once enabled, item queries on the visual resolve on the CPU without a GPU query
+ * render and readback, and `dvz_visual_query_nearest()`, `dvz_visual_query_rect()`, and
+ * `dvz_visual_query_lasso()` become available. The index is built on the first query and then
+ * refreshed from the ranges passed to `dvz_visual_set_data_range()`.
+ *
+ * @param visual the visual
+ * @param enabled whether to keep a spatial index for the visual
+ * @return 0 on success, -1 when the visual type has no spatial index
+ */
+DVZ_EXPORT DvzResult dvz_visual_set_spatial_index(DvzVisual* visual, bool enabled);
+
+
+/**
+ * Find the item nearest to a point with the visual CPU spatial index.
+ *
+ * The point and distance use the xy coordinates of the visual positions, which are panel data
+ * coordinates for visuals attached in DATA space. Triangle geometry reports a zero distance for
+ * points inside a triangle and fills `primitive_id` with the triangle index.
+ *
+ * @param visual the visual, with a spatial index enabled
+ * @param point the query point
+ * @param max_distance the largest accepted distance, INFINITY for no limit
+ * @param out_result output result, with status DVZ_QUERY_STATUS_HIT or DVZ_QUERY_STATUS_MISS
+ * @return 0 on success, -1 on error
+ */
+DVZ_EXPORT DvzResult dvz_visual_query_nearest(
+    DvzVisual* visual, const double point[2], double max_distance, DvzQueryResult* out_result);
+
+
+/**
+ * Select the items inside a rectangle with the visual CPU spatial index.
+ *
+ * Point-like items are selected by position, triangle geometry by triangle centroid. Item ids are
+ * written in increasing order; `out_count` receives the full selection size even when it exceeds
+ * `capacity`, so a first call with a NULL `out_items` sizes the buffer.
+ *
+ * @param visual the visual, with a spatial index enabled
+ * @param min one rectangle corner in position coordinates
+ * @param max the opposite rectangle corner
+ * @param out_items output item ids, or NULL
+ * @param capacity number of entries `out_items` can hold
+ * @param out_count output number of selected items
+ * @return 0 on success, -1 on error
+ */
+DVZ_EXPORT DvzResult dvz_visual_query_rect(
+    DvzVisual* visual, const double min[2], const double max[2], uint64_t* out_items,
+    uint64_t capacity, uint64_t* out_count);
+
+
+/**
+ * Select the items inside a lasso polygon with the visual CPU spatial index.
+ *
+ * The polygon is closed implicitly and uses the even-odd rule. Output conventions follow
+ * `dvz_visual_query_rect()`.
+ *
+ * @param visual the visual, with a spatial index enabled
+ * @param polygon polygon vertices as xy pairs in position coordinates
+ * @param vertex_count number of polygon vertices, at least 3
+ * @param out_items output item ids, or NULL
+ * @param capacity number of entries `out_items` can hold
+ * @param out_count output number of selected items
+ * @return 0 on success, -1 on error
+ */
+DVZ_EXPORT DvzResult dvz_visual_query_lasso(
+    DvzVisual* visual, const double* polygon, uint32_t vertex_count, uint64_t* out_items,
+    uint64_t capacity, uint64_t* out_count);
+
+
+/**
+ * Run the region selections of a visual as a GPU compute pass.
+ *
+ * The pass uses a private runtime on the device of `runtime`, which may be destroyed afterwards.
+ * Without a runtime, region selections scan the positions on the CPU worker pool of the scene, or
+ * use the visual spatial index when it is enabled.
+ *
+ * @param visual a point, pixel, or marker visual
+ * @param runtime a device-backed runtime, or NULL for the CPU path
+ * @return 0 on success, -1 on error
+ */
+DVZ_EXPORT DvzResult
+dvz_visual_set_region_selection_runtime(DvzVisual* visual, DvzDrp2Runtime* runtime);
+
+
+/**
+ * Replace the region selection of a visual with the items inside a rectangle.
+ *
+ * The selection is kept as a bitmask with one bit per item, set for the drawn items whose xy
+ * position lies in the rectangle, and read back with `dvz_visual_region_selection_mask()`.
+ *
+ * @param visual a point, pixel, or marker visual
+ * @param min one rectangle corner in position coordinates
+ * @param max the opposite rectangle corner
+ * @return 0 on success, -1 on error
+ */
+DVZ_EXPORT DvzResult
+dvz_visual_select_rect(DvzVisual* visual, const double min[2], const double max[2]);
+
+
+/**
+ * Replace the region selection of a visual with the items inside a lasso polygon.
+ *
+ * The polygon is closed implicitly and uses the even-odd rule. When it extends the previous lasso
+ * of the visual by appending vertices, only the items in the added wedge are tested, so a lasso
+ * redrawn on every pointer move costs the area it grew by rather than the whole polygon.
+ *
+ * @param visual a point, pixel, or marker visual
+ * @param polygon polygon vertices as xy pairs in position coordinates
+ * @param vertex_count number of polygon vertices, at least 3
+ * @return 0 on success, -1 on error
+ */
+DVZ_EXPORT DvzResult
+dvz_visual_select_lasso(DvzVisual* visual, const double* polygon, uint32_t vertex_count);
+
+
+/**
+ * Clear the region selection of a visual.
+ *
+ * @param visual the visual
+ */
+DVZ_EXPORT void dvz_visual_clear_region_selection(DvzVisual* visual);
+
+
+/**
+ * Return the number of items in the region selection of a visual.
+ *
+ * @param visual the visual
+ * @return the number of selected items
+ */
+DVZ_EXPORT uint64_t dvz_visual_region_selection_count(const DvzVisual* visual);
+
+
+/**
+ * Return the region selection bitmask of a visual.
+ *
+ * Bit `i % 64` of word `i / 64` is set when item `i` is selected. The mask is owned by the visual
+ * and stays valid until the next selection call on it.
+ *
+ * @param visual the visual
+ * @param out_item_count output number of items the mask covers, or NULL
+ * @return the mask, or NULL before the first selection
+ */
+DVZ_EXPORT const uint64_t*
+dvz_visual_region_selection_mask(const DvzVisual* visual, uint64_t* out_item_count);
+
+
+/**
+ * Copy the selected item ids of a visual in increasing order.
+ *
+ * Output conventions follow `dvz_visual_query_rect()`.
+ *
+ * @param visual the visual
+ * @param out_items output item ids, or NULL
+ * @param capacity number of entries `out_items` can hold
+ * @param out_count output number of selected items
+ * @return 0 on success, -1 on error
+ */
+DVZ_EXPORT DvzResult dvz_visual_region_selection_items(
+    const DvzVisual* visual, uint64_t* out_items, uint64_t capacity, uint64_t* out_count);
+
+
 /**
  * Bind per-item link keys for a visual on one link channel.
  *
@@ -412,6 +577,24 @@ DVZ_EXPORT DvzResult dvz_panel_query_px(
 DVZ_EXPORT bool dvz_scene_poll_query(DvzScene* scene, DvzQueryResult* out_result);
 
 
+/**
+ * Pipeline query readbacks over several frames instead of waiting for them.
+ *
+ * With a nonzero latency, `dvz_figure_process_queries()` submits queued queries into a ring of
+ * readback buffers and delivers each result `frames` calls later, so the frame does not wait for
+ * the buffer download. Each query still records and submits its own ID render pass, which blocks
+ * until it completes: there is no persistent ID/depth target yet. When the topmost visual misses,
+ * the query is submitted again for the next visual in z-order, adding `frames` calls per fallback.
+ * Results keep their request ids and freshness serials; superseded ones are dropped as usual.
+ * `dvz_panel_query_now_px()` always resolves synchronously.
+ *
+ * @param scene the scene
+ * @param frames the number of frames a query stays in flight, 0 (default) for synchronous
+ * @return 0 on success, -1 when `frames` does not fit the readback ring (at most 3)
+ */
+DVZ_EXPORT DvzResult dvz_scene_set_query_latency(DvzScene* scene, uint32_t frames);
+
+
 /**
  * Queue and synchronously resolve a query through a DRP2 runtime.
  *
@@ -59,8 +59,19 @@ typedef enum
 
 
 
+// Behavior of the CPU readback encoder queue when the encoder falls behind rendering.
+typedef enum
+{
+    DVZ_VIDEO_QUEUE_BLOCK = 0,       // wait for the encoder, never lose a frame
+    DVZ_VIDEO_QUEUE_DROP_NEWEST = 1, // drop the incoming frame
+    DVZ_VIDEO_QUEUE_DROP_OLDEST = 2, // drop the oldest queued frame
+} DvzVideoQueuePolicy;
+
+
+
 // CPU readback callback used by video sinks running in CPU capture mode. Returned pixels use the
-// screenshot/export contract: tightly packed sRGB RGBA8 with straight linear alpha.
+// screenshot/export contract: tightly packed sRGB RGBA8 with straight linear alpha. Pipelined
+// readbacks return 1 with no pixels while a frame is still in flight.
 typedef int (*DvzVideoSinkCaptureFn)(
     void* user_data, uint32_t* out_width, uint32_t* out_height, size_t* out_stride,
     uint8_t** out_rgba);
@@ -101,6 +112,9 @@ typedef struct
     DvzVideoSinkCaptureFn capture_rgba;
     DvzVideoSinkReleaseFn release_rgba;
     void* capture_user_data;
+    DvzVideoSinkCaptureFn flush_rgba; // drains in-flight frames at stop, called until it returns 1
+    uint32_t queue_depth; // frames queued to an encoder thread (opt-in), 0 encodes synchronously
+    DvzVideoQueuePolicy queue_policy;
 } DvzVideoSinkConfig;
 
 
@@ -215,6 +215,16 @@ DVZ_EXPORT const VkPhysicalDeviceFeatures* dvz_device_features10(DvzDevice* devi
 
 
 
+/**
+ * Return the Vulkan 1.2 feature set enabled on this device.
+ *
+ * @param device the device
+ * @return borrowed immutable enabled-feature storage, valid until device destruction
+ */
+DVZ_EXPORT const VkPhysicalDeviceVulkan12Features* dvz_device_features12(DvzDevice* device);
+
+
+
 /**
  * Retrieve a queue from a role.
  *
@@ -31,6 +31,7 @@
 typedef struct DvzDevice DvzDevice;
 typedef struct DvzVma DvzVma;
 typedef struct DvzAllocation DvzAllocation;
+typedef struct DvzMemoryBudget DvzMemoryBudget;
 typedef uint32_t DvzAllocationFlags;
 
 
@@ -45,6 +46,21 @@ typedef uint32_t DvzAllocationFlags;
 #define DVZ_ALLOC_HOST_ACCESS_SEQUENTIAL_WRITE ((DvzAllocationFlags)(1u << 2))
 #define DVZ_ALLOC_HOST_ACCESS_RANDOM ((DvzAllocationFlags)(1u << 3))
 #define DVZ_ALLOC_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD ((DvzAllocationFlags)(1u << 4))
+#define DVZ_ALLOC_LAZILY_ALLOCATED ((DvzAllocationFlags)(1u << 5))
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzMemoryBudget
+{
+    VkDeviceSize device_usage;  // bytes allocated in device-local heaps
+    VkDeviceSize device_budget; // bytes the process can use in device-local heaps
+    VkDeviceSize host_usage;    // bytes allocated in the other heaps
+    VkDeviceSize host_budget;   // bytes the process can use in the other heaps
+};
 
 
 
@@ -186,6 +202,20 @@ DVZ_EXPORT int dvz_device_allocator(
 
 
 
+/**
+ * Query the current memory usage and budget of an allocator, summed per heap class.
+ *
+ * The allocator is created with VK_EXT_memory_budget support when the device exposes it; without
+ * the extension, VMA estimates the budget from the heap sizes and tracks its own allocations.
+ *
+ * @param allocator the allocator
+ * @param[out] budget usage and budget of the device-local heaps and of the other heaps
+ * @return 0 on success, non-zero when the allocator is not initialized
+ */
+DVZ_EXPORT int dvz_allocator_budget(DvzVma* allocator, DvzMemoryBudget* budget);
+
+
+
 /**
  * Allocate and create a Vulkan buffer.
  *
@@ -209,7 +239,8 @@ DVZ_EXPORT int dvz_allocator_buffer(
  * Allocate and create a Vulkan image.
  *
  * The input create-info struct is treated as caller-owned configuration and is
- * not retained or mutated after this call returns.
+ * not retained or mutated after this call returns. With DVZ_ALLOC_LAZILY_ALLOCATED and a
+ * transient-attachment usage, lazily-allocated memory is used when the device exposes it.
  *
  * @param allocator the allocator
  * @param info the image creation info Vulkan struct
@@ -38,6 +38,7 @@
 typedef struct DvzCommands DvzCommands;
 typedef struct DvzDevice DvzDevice;
 typedef struct DvzQueue DvzQueue;
+typedef struct DvzSemaphore DvzSemaphore;
 
 
 
@@ -89,6 +90,23 @@ dvz_commands(DvzDevice* device, DvzQueue* queue, uint32_t count, DvzCommands* cm
 
 
 
+/**
+ * Create a set of secondary command buffers.
+ *
+ * Secondary command buffers are recorded with dvz_cmd_begin_rendering_secondary_result() and
+ * replayed from a primary command buffer with dvz_cmd_execute_commands(). They cannot be
+ * submitted directly.
+ *
+ * @param device logical device that owns the command pool and buffers; must outlive `cmds`
+ * @param queue queue whose family selects the command pool; must outlive `cmds`
+ * @param count the number of command buffers to create
+ * @param[out] cmds the created command buffers
+ */
+DVZ_EXPORT void
+dvz_commands_secondary(DvzDevice* device, DvzQueue* queue, uint32_t count, DvzCommands* cmds);
+
+
+
 /**
  * Allocate a single primary command buffer from the device command pool of a queue family.
  *
@@ -215,6 +233,31 @@ DVZ_EXPORT void dvz_cmd_release(DvzCommands* cmds);
 
 
 
+/**
+ * Start recording a secondary command buffer that continues a dynamic rendering.
+ *
+ * The command buffer is begun with the render-pass-continue and simultaneous-use flags so that it
+ * can be executed from several in-flight primary command buffers.
+ *
+ * @param cmds the set of secondary command buffers
+ * @param rendering attachment formats and sample count of the renderings it will be executed in
+ * @return 0 on success, non-zero on Vulkan or state failure
+ */
+DVZ_EXPORT int dvz_cmd_begin_rendering_secondary_result(
+    DvzCommands* cmds, const VkCommandBufferInheritanceRenderingInfo* rendering);
+
+
+
+/**
+ * Execute the currently selected secondary command buffer from a primary command buffer.
+ *
+ * @param cmds the primary command buffers
+ * @param secondary the recorded secondary command buffers
+ */
+DVZ_EXPORT void dvz_cmd_execute_commands(DvzCommands* cmds, DvzCommands* secondary);
+
+
+
 /**
  * Submit a command buffer on its queue.
  *
@@ -238,6 +281,23 @@ DVZ_EXPORT void dvz_cmd_submit(DvzCommands* cmds);
 
 
 
+/**
+ * Submit a command buffer on its queue without waiting for completion.
+ *
+ * The submission signals `signal_value` on the timeline semaphore once the command buffer has
+ * completed. The caller must keep the command buffer, and every resource it references, alive
+ * until the semaphore reaches that value.
+ *
+ * @param cmds the set of command buffers
+ * @param timeline the timeline semaphore to signal
+ * @param signal_value the timeline value to signal on completion
+ * @return 0 on success, non-zero on Vulkan or state failure
+ */
+DVZ_EXPORT int
+dvz_cmd_submit_async(DvzCommands* cmds, DvzSemaphore* timeline, uint64_t signal_value);
+
+
+
 /**
  * Destroy a set of command buffers.
  *
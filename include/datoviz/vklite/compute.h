@@ -191,4 +191,15 @@ DVZ_EXPORT void dvz_cmd_dispatch(DvzCommands* cmds, uint32_t nx, uint32_t ny, ui
 
 
 
+/**
+ * Dispatch a compute task whose workgroup counts are read from a GPU buffer.
+ *
+ * @param cmds the set of command buffers to record
+ * @param indirect buffer containing a `VkDispatchIndirectCommand` record
+ * @param offset byte offset of the record within `indirect`, a multiple of 4
+ */
+DVZ_EXPORT void dvz_cmd_dispatch_indirect(DvzCommands* cmds, VkBuffer indirect, DvzSize offset);
+
+
+
 EXTERN_C_OFF
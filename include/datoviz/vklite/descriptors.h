@@ -35,10 +35,28 @@ typedef struct DvzDevice DvzDevice;
 
 typedef struct DvzSlots DvzSlots;
 typedef struct DvzDescriptors DvzDescriptors;
+typedef struct DvzDescriptorAllocator DvzDescriptorAllocator;
+typedef struct DvzDescriptorAllocatorStats DvzDescriptorAllocatorStats;
 typedef struct DvzCommands DvzCommands;
 
 
 
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzDescriptorAllocatorStats
+{
+    uint32_t layout_count; /* slots with a live pool chain */
+    uint32_t pool_count;   /* Vulkan descriptor pools across all chains */
+    uint64_t live_groups;  /* descriptor wrappers currently allocated from the chains */
+    uint64_t free_groups;  /* recycled set groups waiting for reuse */
+    uint64_t allocations;  /* dvz_descriptors_pooled() calls that succeeded */
+    uint64_t recycled;     /* allocations served from the free lists */
+};
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -77,6 +95,74 @@ DVZ_EXPORT void dvz_descriptors(DvzSlots* slots, DvzDescriptors* descriptors);
 
 
 
+/**
+ * Create a growable descriptor allocator.
+ *
+ * The allocator keeps one chain of descriptor pools per slots object. Each chain is sized from
+ * the slots bindings, grows by appending larger pools instead of failing when a pool is
+ * exhausted, and recycles the sets of freed wrappers for later allocations with the same slots.
+ *
+ * @param device the device
+ * @return owned allocator, or NULL on allocation failure
+ */
+DVZ_EXPORT DvzDescriptorAllocator* dvz_descriptor_allocator(DvzDevice* device);
+
+
+
+/**
+ * Allocate descriptors from a growable allocator.
+ *
+ * Like dvz_descriptors(), the wrapper must be fresh. dvz_descriptors_free() hands the sets back
+ * to the allocator free list instead of the device pool, so the caller must only free the
+ * wrapper once the GPU no longer uses its sets.
+ *
+ * @param allocator the descriptor allocator
+ * @param slots the slots
+ * @param[out] descriptors the created descriptors
+ * @return 0 on success, nonzero on failure
+ */
+DVZ_EXPORT int dvz_descriptors_pooled(
+    DvzDescriptorAllocator* allocator, DvzSlots* slots, DvzDescriptors* descriptors);
+
+
+
+/**
+ * Release the pool chain of a slots object before the slots are destroyed.
+ *
+ * Recycled sets are dropped immediately. Pools still backing live wrappers are destroyed when
+ * the last of these wrappers is freed. A later allocation with the same slots pointer starts a
+ * new chain.
+ *
+ * @param allocator the descriptor allocator
+ * @param slots the slots about to be destroyed
+ */
+DVZ_EXPORT void
+dvz_descriptor_allocator_release(DvzDescriptorAllocator* allocator, DvzSlots* slots);
+
+
+
+/**
+ * Return descriptor allocator counters.
+ *
+ * @param allocator the descriptor allocator
+ * @return the allocator statistics
+ */
+DVZ_EXPORT DvzDescriptorAllocatorStats
+dvz_descriptor_allocator_stats(DvzDescriptorAllocator* allocator);
+
+
+
+/**
+ * Destroy a descriptor allocator and all its pools.
+ *
+ * Every wrapper allocated from the allocator must be freed first.
+ *
+ * @param allocator the descriptor allocator
+ */
+DVZ_EXPORT void dvz_descriptor_allocator_destroy(DvzDescriptorAllocator* allocator);
+
+
+
 /**
  * Return the number of descriptor sets allocated by the wrapper.
  *
@@ -153,7 +239,8 @@ DVZ_EXPORT void dvz_cmd_bind_descriptors(
  * Free a descriptor wrapper allocated by dvz_descriptors_create().
  *
  * This releases the CPU-side wrapper and returns its Vulkan descriptor sets to the parent
- * device-owned descriptor pool. The wrapper must be freed before the parent device is destroyed.
+ * device-owned descriptor pool, or to the allocator free list for dvz_descriptors_pooled()
+ * wrappers. The wrapper must be freed before the parent device is destroyed.
  *
  * @param descriptors descriptor wrapper to free
  */
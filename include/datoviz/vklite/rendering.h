@@ -146,6 +146,19 @@ DVZ_EXPORT void dvz_rendering_layers(DvzRendering* rendering, uint32_t count);
 
 
 
+/**
+ * Set the Vulkan rendering flags of a rendering.
+ *
+ * Use `VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT` when the rendering body is recorded in
+ * secondary command buffers.
+ *
+ * @param rendering the rendering
+ * @param flags the rendering flags
+ */
+DVZ_EXPORT void dvz_rendering_flags(DvzRendering* rendering, VkRenderingFlags flags);
+
+
+
 /**
  * Return the number of configured color attachments.
  *
@@ -42,6 +42,11 @@ struct DvzAppStatus
     double fps;
     uint32_t fps_frames;
     double fps_elapsed_s;
+
+    bool memory_valid;
+    uint64_t memory_resident;
+    uint64_t memory_budget;
+    uint64_t memory_evicted;
 };
 
 
@@ -100,6 +105,18 @@ void _dvz_app_status_fps(
     DvzAppStatus* status, double fps, uint32_t frames, double elapsed_s);
 
 
+/**
+ * Update the GPU memory portion of the terminal status line.
+ *
+ * @param status the status state
+ * @param resident device-local runtime bytes
+ * @param budget enforced budget in bytes, 0 when unlimited
+ * @param evicted bytes demoted to host memory
+ */
+void _dvz_app_status_memory(
+    DvzAppStatus* status, uint64_t resident, uint64_t budget, uint64_t evicted);
+
+
 /**
  * Format the current terminal status line.
  *
@@ -53,6 +53,7 @@
 #include <volk.h>
 #include "../canvas/canvas_internal.h"
 #include "datoviz/canvas.h"
+#include "datoviz/drp2/packet.h"
 #include "datoviz/drp2/recording.h"
 #include "datoviz/drp2/runtime.h"
 #include "datoviz/drp2/stream.h"
@@ -134,6 +135,11 @@ static const char* _app_present_mode_name(VkPresentModeKHR mode)
 #define DVZ_APP_DEFAULT_REFERENCE_DPI 96.0
 #define DVZ_APP_TIMING_INTERACTIVE_CAPACITY 65536u
 
+/* Frame-level skip: one stream fingerprint per frame-slot scope, and a forced re-render of idle
+ * views at this period to catch changes that only show up during emission. */
+#define DVZ_APP_FINGERPRINT_SLOTS 8u
+#define DVZ_APP_IDLE_RECHECK_NS UINT64_C(1000000000)
+
 
 
 /*************************************************************************************************/
@@ -180,6 +186,14 @@ typedef struct DvzAppFrameTiming
     uint64_t scene_prepare_ns;
     uint64_t scene_plan_ns;
     uint64_t scene_contract_ns;
+    uint64_t scene_contract_pass_count;
+    uint64_t scene_contract_memo_hit_count;
+    uint64_t scene_target_bytes;
+    uint64_t scene_aliased_target_bytes;
+    uint64_t runtime_resident_bytes;
+    uint64_t runtime_evicted_bytes;
+    uint64_t runtime_eviction_count;
+    uint64_t runtime_restore_count;
     uint64_t scene_emit_ns;
     uint64_t scene_cleanup_ns;
     uint64_t execute_ns;
@@ -209,6 +223,14 @@ typedef struct DvzAppFrameTimingState
 
 
 
+typedef struct DvzAppStreamFingerprint
+{
+    uint64_t scope;
+    uint64_t fingerprint;
+} DvzAppStreamFingerprint;
+
+
+
 struct DvzView
 {
     DvzApp*    app;
@@ -277,6 +299,13 @@ struct DvzView
     bool draw_failed;
     bool test_force_draw_failure;
     uint64_t next_frame_ns;
+    DvzAppStreamFingerprint fingerprints[DVZ_APP_FINGERPRINT_SLOTS];
+    uint32_t fingerprint_count;
+    uint32_t identical_frames;
+    bool presentation_idle;
+    bool idle_tick_stepped;
+    bool frame_presented; /* whether the last render submitted a frame, false for idle skips */
+    uint64_t last_presented_ns;
     bool capture_dvzr_enabled;
     bool capture_video_enabled;
     bool capture_png_enabled;
@@ -306,6 +335,7 @@ struct DvzApp
     bool owns_runtime;
     bool owns_window_host;
     bool runtime_recovery_pending;
+    uint64_t memory_frame_count; /* frames started on the runtime memory budget clock */
 #endif
     uint32_t     view_count;
     DvzView views[DVZ_APP_MAX_VIEWS];
@@ -687,6 +717,34 @@ static double _app_capture_fps_from_env(double fallback)
 
 
 
+/**
+ * Parse the runtime memory budget environment override.
+ *
+ * DVZ_APP_MEMORY_BUDGET_MIB caps device-local scene resources, "device" follows the budget
+ * reported by the Vulkan driver, and 0 disables eviction. Eviction stays off without it.
+ *
+ * @return the budget in bytes, DVZ_DRP2_MEMORY_BUDGET_DEVICE, or 0
+ */
+static uint64_t _app_memory_budget_from_env(void)
+{
+    const char* env = getenv("DVZ_APP_MEMORY_BUDGET_MIB");
+    if (env == NULL || env[0] == '\0')
+        return 0;
+    if (strcmp(env, "device") == 0)
+        return DVZ_DRP2_MEMORY_BUDGET_DEVICE;
+
+    char* end = NULL;
+    double mib = strtod(env, &end);
+    if (end == env || *end != '\0' || mib < 0 || mib > 1e12)
+    {
+        log_warn("ignoring DVZ_APP_MEMORY_BUDGET_MIB='%s' (expected MiB count or device)", env);
+        return 0;
+    }
+    return (uint64_t)(mib * 1024.0 * 1024.0);
+}
+
+
+
 /**
  * Parse the capture video mode environment override.
  *
@@ -711,6 +769,30 @@ static DvzVideoCaptureMode _app_capture_video_mode_from_env(DvzVideoCaptureMode
 
 
 
+/**
+ * Parse the capture video queue depth environment override.
+ *
+ * @param fallback fallback queue depth
+ * @return parsed queue depth, 0 to encode on the render thread
+ */
+static uint32_t _app_capture_video_queue_from_env(uint32_t fallback)
+{
+    const char* env = getenv("DVZ_CAPTURE_VIDEO_QUEUE");
+    if (env == NULL || env[0] == '\0')
+        return fallback;
+
+    char* end = NULL;
+    unsigned long depth = strtoul(env, &end, 10);
+    if (end == env || *end != '\0' || depth > UINT32_MAX)
+    {
+        log_warn("ignoring DVZ_CAPTURE_VIDEO_QUEUE='%s' (expected a frame count)", env);
+        return fallback;
+    }
+    return (uint32_t)depth;
+}
+
+
+
 /**
  * Build a capture output path.
  *
@@ -1861,6 +1943,22 @@ static void _app_frame_timing_report(DvzApp* app)
             total.scene_prepare_ns += sample->scene_prepare_ns;
             total.scene_plan_ns += sample->scene_plan_ns;
             total.scene_contract_ns += sample->scene_contract_ns;
+            total.scene_contract_pass_count += sample->scene_contract_pass_count;
+            total.scene_contract_memo_hit_count += sample->scene_contract_memo_hit_count;
+            // Target memory is a footprint, not a cost: report its peak over the samples.
+            if (sample->scene_target_bytes > total.scene_target_bytes)
+                total.scene_target_bytes = sample->scene_target_bytes;
+            if (sample->scene_aliased_target_bytes > total.scene_aliased_target_bytes)
+                total.scene_aliased_target_bytes = sample->scene_aliased_target_bytes;
+            if (sample->runtime_resident_bytes > total.runtime_resident_bytes)
+                total.runtime_resident_bytes = sample->runtime_resident_bytes;
+            if (sample->runtime_evicted_bytes > total.runtime_evicted_bytes)
+                total.runtime_evicted_bytes = sample->runtime_evicted_bytes;
+            // Eviction counters are cumulative: the largest sample is the latest total.
+            if (sample->runtime_eviction_count > total.runtime_eviction_count)
+                total.runtime_eviction_count = sample->runtime_eviction_count;
+            if (sample->runtime_restore_count > total.runtime_restore_count)
+                total.runtime_restore_count = sample->runtime_restore_count;
             total.scene_emit_ns += sample->scene_emit_ns;
             total.scene_cleanup_ns += sample->scene_cleanup_ns;
             total.execute_ns += sample->execute_ns;
@@ -1889,13 +1987,21 @@ static void _app_frame_timing_report(DvzApp* app)
                 : 0.0;
         const double scheduler_residual_ms =
             run_ms > host_ms + frame_ms ? run_ms - host_ms - frame_ms : 0.0;
+        const double scene_contract_memo_hit =
+            total.scene_contract_pass_count > 0
+                ? (double)total.scene_contract_memo_hit_count /
+                      (double)total.scene_contract_pass_count
+                : 0.0;
         dvz_fprintf(
             stdout,
             "app_frame_timing: view=%u frames=%u run_ms=%.4f host_ms=%.4f "
             "frame_ms=%.4f p50=%.4f p95=%.4f p99=%.4f canvas=%.4f draw=%.4f "
             "submit=%.4f prepare=%.4f "
             "attach=%.4f setup=%.4f scene_total=%.4f scene_prepare=%.4f scene_plan=%.4f "
-            "scene_contract=%.4f "
+            "scene_contract=%.4f scene_contract_memo_hit=%.4f "
+            "scene_target_mib=%.4f scene_aliased_target_mib=%.4f "
+            "runtime_resident_mib=%.4f runtime_evicted_mib=%.4f "
+            "runtime_evictions=%llu runtime_restores=%llu "
             "scene_emit=%.4f scene_cleanup=%.4f execute=%.4f semantic_validation=%.4f "
             "backend=%.4f semantic_commit=%.4f trace=%.4f post=%.4f callback=%.4f "
             "canvas_overhead=%.4f "
@@ -1914,7 +2020,13 @@ static void _app_frame_timing_report(DvzApp* app)
             (double)total.scene_total_ns * 1e-6 / divisor,
             (double)total.scene_prepare_ns * 1e-6 / divisor,
             (double)total.scene_plan_ns * 1e-6 / divisor,
-            (double)total.scene_contract_ns * 1e-6 / divisor,
+            (double)total.scene_contract_ns * 1e-6 / divisor, scene_contract_memo_hit,
+            (double)total.scene_target_bytes / (1024.0 * 1024.0),
+            (double)total.scene_aliased_target_bytes / (1024.0 * 1024.0),
+            (double)total.runtime_resident_bytes / (1024.0 * 1024.0),
+            (double)total.runtime_evicted_bytes / (1024.0 * 1024.0),
+            (unsigned long long)total.runtime_eviction_count,
+            (unsigned long long)total.runtime_restore_count,
             (double)total.scene_emit_ns * 1e-6 / divisor,
             (double)total.scene_cleanup_ns * 1e-6 / divisor,
             (double)total.execute_ns * 1e-6 / divisor,
@@ -2689,10 +2801,16 @@ static const char* _trace_command_name(DvzDrp2CommandType type)
         return "Draw";
     case DVZ_DRP2_COMMAND_DRAW_INDEXED:
         return "DrawIndexed";
+    case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+        return "DrawIndirect";
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
+        return "DrawIndexedIndirect";
     case DVZ_DRP2_COMMAND_END_RENDER_PASS:
         return "EndRenderPass";
     case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS:
         return "DispatchWorkgroups";
+    case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT:
+        return "DispatchWorkgroupsIndirect";
     case DVZ_DRP2_COMMAND_END_COMPUTE_PASS:
         return "EndComputePass";
     case DVZ_DRP2_COMMAND_COPY_BUFFER_TO_BUFFER:
@@ -2833,7 +2951,10 @@ static const char* _trace_command_color(DvzDrp2CommandType type)
         return DVZ_TRACE_COLOR_BLUE;
     case DVZ_DRP2_COMMAND_DRAW:
     case DVZ_DRP2_COMMAND_DRAW_INDEXED:
+    case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
     case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS:
+    case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT:
         return DVZ_TRACE_COLOR_MAGENTA;
     default:
         return DVZ_TRACE_COLOR_DIM;
@@ -3298,6 +3419,15 @@ static bool _app_trace_print_command_detail(
             stderr, "  %03u = EndRenderPass pass=%" PRIu64 "\n", index,
             command->u.end_render_pass.pass_id);
         return true;
+    case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
+        dvz_fprintf(
+            stderr, "  %03u = %s buffer=%" PRIu64 " offset=%" PRIu64 " count=%" PRIu32
+                    " stride=%" PRIu32 "\n",
+            index, _trace_command_name(command->type), command->u.draw_indirect.buffer_id,
+            command->u.draw_indirect.offset, command->u.draw_indirect.draw_count,
+            command->u.draw_indirect.stride);
+        return true;
     case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS:
         dvz_fprintf(
             stderr, "  %03u = DispatchWorkgroups pass=%" PRIu64 " groups=(%" PRIu32
@@ -3305,6 +3435,14 @@ static bool _app_trace_print_command_detail(
             index, command->u.dispatch.pass_id, command->u.dispatch.x,
             command->u.dispatch.y, command->u.dispatch.z);
         return true;
+    case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT:
+        dvz_fprintf(
+            stderr, "  %03u = DispatchWorkgroupsIndirect pass=%" PRIu64 " buffer=%" PRIu64
+                    " offset=%" PRIu64 "\n",
+            index, command->u.dispatch_workgroups_indirect.pass_id,
+            command->u.dispatch_workgroups_indirect.buffer_id,
+            command->u.dispatch_workgroups_indirect.offset);
+        return true;
     case DVZ_DRP2_COMMAND_END_COMPUTE_PASS:
         dvz_fprintf(
             stderr, "  %03u = EndComputePass pass=%" PRIu64 "\n", index,
@@ -3881,7 +4019,9 @@ static bool _app_replay_stream_has_draw(const DvzDrp2CommandStream* stream)
     for (uint32_t i = 0; i < stream->count; i++)
     {
         const DvzDrp2CommandType type = stream->commands[i].type;
-        if (type == DVZ_DRP2_COMMAND_DRAW || type == DVZ_DRP2_COMMAND_DRAW_INDEXED)
+        if (type == DVZ_DRP2_COMMAND_DRAW || type == DVZ_DRP2_COMMAND_DRAW_INDEXED ||
+            type == DVZ_DRP2_COMMAND_DRAW_INDIRECT ||
+            type == DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT)
             return true;
     }
     return false;
@@ -4126,6 +4266,150 @@ static int _app_resolve_gui_viewport(DvzView* source, void* user_data)
 
 
 
+/**
+ * Return whether a view may skip frames whose emitted stream would not change.
+ *
+ * Recording, capture, replay, GUI overlays and frame timing all need every frame, and active
+ * interaction (fly navigation) is not driven by scene change notifications.
+ *
+ * @param win view to inspect
+ * @return whether presentation-idle skipping is allowed
+ */
+static bool _view_presentation_idle_allowed(DvzView* win)
+{
+    ANN(win);
+    if (win->recorder != NULL || win->replay_recording != NULL || win->capture_video_enabled)
+        return false;
+    if (win->frame_timing.enabled || win->test_force_draw_failure)
+        return false;
+#if defined(DVZ_HAS_GUI) && DVZ_HAS_GUI
+    if (win->gui != NULL)
+        return false;
+#endif
+    if (win->figure != NULL && _scene_figure_frame_demand(win->figure) != DVZ_FRAME_DEMAND_NONE)
+        return false;
+    return true;
+}
+
+
+
+/**
+ * Forget the stream fingerprints of one view and leave presentation-idle mode.
+ *
+ * @param win view to reset
+ */
+static void _view_presentation_idle_reset(DvzView* win)
+{
+    ANN(win);
+    win->fingerprint_count = 0;
+    win->identical_frames = 0;
+    win->presentation_idle = false;
+}
+
+
+
+/**
+ * Record the fingerprint of a successfully executed frame stream.
+ *
+ * Frame-local intermediates are keyed by the canvas frame slot, so streams are only comparable
+ * within one scope. The view becomes presentation-idle once every known scope re-emitted the
+ * stream it had last time, i.e. the presented image would not change.
+ *
+ * @param win view that executed the stream
+ * @param scope runtime resource scope of the frame
+ * @param stream executed frame stream
+ */
+static void _view_presentation_fingerprint(
+    DvzView* win, uint64_t scope, const DvzDrp2CommandStream* stream)
+{
+    ANN(win);
+    ANN(stream);
+    win->last_presented_ns = dvz_time_monotonic_ns();
+    if (!_view_presentation_idle_allowed(win) || !_view_has_continuous_work(win))
+    {
+        _view_presentation_idle_reset(win);
+        return;
+    }
+
+    /* Accumulated by the emitter from command records and payload versions; upload bytes are
+       never re-read. A large unversioned payload counts as a change. */
+    uint64_t fingerprint = 0;
+    const bool versioned = dvz_drp2_stream_fingerprint(stream, &fingerprint);
+    DvzAppStreamFingerprint* slot = NULL;
+    for (uint32_t i = 0; i < win->fingerprint_count; i++)
+    {
+        if (win->fingerprints[i].scope == scope)
+        {
+            slot = &win->fingerprints[i];
+            break;
+        }
+    }
+    if (slot == NULL)
+    {
+        /* Swapchain recreation changes the frame slots: drop stale scopes when full. */
+        if (win->fingerprint_count >= DVZ_APP_FINGERPRINT_SLOTS)
+            _view_presentation_idle_reset(win);
+        slot = &win->fingerprints[win->fingerprint_count++];
+        slot->scope = scope;
+        slot->fingerprint = fingerprint;
+        win->identical_frames = 0;
+    }
+    else if (!versioned || slot->fingerprint != fingerprint)
+    {
+        slot->fingerprint = fingerprint;
+        win->identical_frames = 0;
+    }
+    else if (win->identical_frames < UINT32_MAX)
+    {
+        win->identical_frames++;
+    }
+    win->presentation_idle = win->identical_frames >= win->fingerprint_count;
+}
+
+
+
+/**
+ * Run the CPU side of a frame for a presentation-idle view without touching the canvas.
+ *
+ * Animations and the frame callback still advance; any scene change they signal ends the idle
+ * period and the frame is rendered normally.
+ *
+ * @param win view to tick
+ * @return true when the frame was skipped, false when it must be rendered
+ */
+static bool _view_presentation_idle_tick(DvzView* win)
+{
+    ANN(win);
+    if (!win->presentation_idle)
+        return false;
+    if (
+        win->dirty || win->frame_requested || !_view_presentation_idle_allowed(win) ||
+        _view_has_posted_callbacks(win) || _view_has_pending_requests(win) ||
+        _view_has_pending_scene_work(win))
+    {
+        _view_presentation_idle_reset(win);
+        return false;
+    }
+    if (dvz_time_monotonic_ns() - win->last_presented_ns >= DVZ_APP_IDLE_RECHECK_NS)
+        return false;
+
+    DvzApp* app = win->app;
+    if (app != NULL && app->scene != NULL)
+        _dvz_scene_animations_step(app->scene, dvz_input_timestamp_ns());
+    win->idle_tick_stepped = true;
+    if (win->frame_callback != NULL && _app_frame_callback_allowed(win))
+        win->frame_callback(win, win->frame_user_data);
+    if (win->dirty || win->frame_requested || _view_has_pending_scene_work(win))
+    {
+        _view_presentation_idle_reset(win);
+        return false;
+    }
+    win->idle_tick_stepped = false;
+    return true;
+}
+
+
+
 static void _app_draw(DvzCanvas* canvas, const DvzStreamFrame* frame, void* user_data)
 {
     (void)canvas;
@@ -4180,7 +4464,11 @@ static void _app_draw(DvzCanvas* canvas, const DvzStreamFrame* frame, void* user
     }
 #endif
 
-    _dvz_scene_animations_step(app->scene, dvz_input_timestamp_ns());
+    /* A presentation-idle tick may already have stepped animations for this frame. */
+    bool idle_tick_stepped = win->idle_tick_stepped;
+    win->idle_tick_stepped = false;
+    if (!idle_tick_stepped)
+        _dvz_scene_animations_step(app->scene, dvz_input_timestamp_ns());
     _app_sync_figure_size(win, frame);
     bool fly_active = _dvz_figure_fly_update(win->figure, app->scene->clock.dt);
     if (timing != NULL)
@@ -4247,6 +4535,10 @@ static void _app_draw(DvzCanvas* canvas, const DvzStreamFrame* frame, void* user
             timing->scene_prepare_ns = scene_timing.prepare_ns;
             timing->scene_plan_ns = scene_timing.plan_ns;
             timing->scene_contract_ns = scene_timing.contract_ns;
+            timing->scene_contract_pass_count = scene_timing.contract_pass_count;
+            timing->scene_contract_memo_hit_count = scene_timing.contract_memo_hit_count;
+            timing->scene_target_bytes = scene_timing.target_bytes;
+            timing->scene_aliased_target_bytes = scene_timing.aliased_target_bytes;
             timing->scene_emit_ns = scene_timing.emit_ns;
             timing->scene_cleanup_ns = scene_timing.cleanup_ns;
         }
@@ -4283,7 +4575,16 @@ static void _app_draw(DvzCanvas* canvas, const DvzStreamFrame* frame, void* user
         timing->trace_ns = dvz_time_monotonic_ns() - phase_start;
 
     phase_start = timing != NULL ? dvz_time_monotonic_ns() : 0;
+    // The memory budget clock follows the view furthest ahead; views drawn in step share frames.
+    if (win->frame_index >= app->memory_frame_count)
+    {
+        app->memory_frame_count = win->frame_index + 1;
+        dvz_drp2_runtime_begin_frame(app->runtime);
+    }
+    const uint64_t memory_owner = (uint64_t)(win - app->views) + 1;
+    dvz_drp2_runtime_set_memory_owner(app->runtime, memory_owner);
     DvzDrp2ValidationResult result = dvz_drp2_runtime_execute(app->runtime, stream);
+    dvz_drp2_runtime_set_memory_owner(app->runtime, 0);
     if (timing != NULL)
     {
         timing->execute_ns = dvz_time_monotonic_ns() - phase_start;
@@ -4294,6 +4595,14 @@ static void _app_draw(DvzCanvas* canvas, const DvzStreamFrame* frame, void* user
             timing->backend_ns = runtime_timing.backend_ns;
             timing->semantic_commit_ns = runtime_timing.semantic_commit_ns;
         }
+        DvzDrp2MemoryStats memory = {0};
+        if (dvz_drp2_runtime_memory_stats(app->runtime, memory_owner, &memory))
+        {
+            timing->runtime_resident_bytes = memory.resident_bytes;
+            timing->runtime_evicted_bytes = memory.evicted_bytes;
+            timing->runtime_eviction_count = memory.eviction_count;
+            timing->runtime_restore_count = memory.restore_count;
+        }
         phase_start = dvz_time_monotonic_ns();
     }
     if (!result.ok)
@@ -4308,7 +4617,14 @@ static void _app_draw(DvzCanvas* canvas, const DvzStreamFrame* frame, void* user
     }
 
     if (result.ok)
+    {
         _app_record_stream(win, frame, stream);
+        _view_presentation_fingerprint(win, cfg.runtime_resource_scope_id, stream);
+    }
+    else
+    {
+        _view_presentation_idle_reset(win);
+    }
     dvz_scene_frame_artifact_destroy(artifact);
     if (timing != NULL)
         timing->post_ns = dvz_time_monotonic_ns() - phase_start;
@@ -4318,7 +4634,7 @@ static void _app_draw(DvzCanvas* canvas, const DvzStreamFrame* frame, void* user
 #endif
 
     phase_start = timing != NULL ? dvz_time_monotonic_ns() : 0;
-    if (win->frame_callback != NULL && _app_frame_callback_allowed(win))
+    if (win->frame_callback != NULL && !idle_tick_stepped && _app_frame_callback_allowed(win))
         win->frame_callback(win, win->frame_user_data);
     if (_view_has_pending_scene_work(win))
         dvz_view_request_frame(win);
@@ -4500,6 +4816,7 @@ dvz_app_with_resources(DvzScene* scene, const DvzAppConfig* config, const DvzApp
             dvz_free(app);
             return NULL;
         }
+        (void)dvz_drp2_runtime_set_memory_budget(app->runtime, _app_memory_budget_from_env());
     }
     if (!_scene_add_request_frame_callback(app->scene, _app_scene_request_frame, app))
     {
@@ -5866,6 +6183,7 @@ DvzAppCaptureConfig dvz_app_capture_config(void)
         .fps = DVZ_APP_CAPTURE_DEFAULT_FPS,
         .video_backend = "auto",
         .video_capture_mode = DVZ_VIDEO_CAPTURE_AUTO,
+        .video_queue_depth = 0,
     };
     return config;
 }
@@ -5902,6 +6220,7 @@ DvzAppCaptureConfig dvz_app_capture_config_from_env(const char* basename)
         config.video_backend = backend;
 
     config.video_capture_mode = _app_capture_video_mode_from_env(config.video_capture_mode);
+    config.video_queue_depth = _app_capture_video_queue_from_env(config.video_queue_depth);
     return config;
 }
 
@@ -5981,6 +6300,7 @@ DvzResult dvz_view_capture_start(DvzView* win, const DvzAppCaptureConfig* config
         video.encoder.fps = resolved.fps > 0 ? (uint32_t)(resolved.fps + 0.5) : 60;
         video.encoder.mp4_path = win->capture_video_path;
         video.capture_mode = resolved.video_capture_mode;
+        video.queue_depth = resolved.video_queue_depth;
 
         if (dvz_canvas_configure_video_sink(win->canvas, true, &video) != 0)
         {
@@ -6550,6 +6870,7 @@ int dvz_view_render_once(DvzView* win)
 {
     ANN(win);
     _view_post_drain(win);
+    win->frame_presented = false;
 
 #if defined(DVZ_DRP2_HAS_VKLITE) && DVZ_DRP2_HAS_VKLITE
     if (!win->render_enabled)
@@ -6558,6 +6879,8 @@ int dvz_view_render_once(DvzView* win)
         return -1;
     if (_view_close_requested(win))
         return 0;
+    if (_view_presentation_idle_tick(win))
+        return DVZ_CANVAS_FRAME_READY;
 
     bool dirty_before = win->dirty;
     bool requested_before = win->frame_requested;
@@ -6584,6 +6907,7 @@ int dvz_view_render_once(DvzView* win)
         }
     }
     int rc = dvz_canvas_frame(win->canvas);
+    win->idle_tick_stepped = false;
     if (timing_enabled)
         win->frame_timing.current.canvas_frame_ns = dvz_time_monotonic_ns() - frame_start_ns;
     if (rc == DVZ_CANVAS_FRAME_READY)
@@ -6597,6 +6921,7 @@ int dvz_view_render_once(DvzView* win)
         }
         if (win->draw_failed)
         {
+            _view_presentation_idle_reset(win);
             win->dirty = true;
             win->frame_requested = win->frame_requested || requested_before;
             return -1;
@@ -6621,6 +6946,7 @@ int dvz_view_render_once(DvzView* win)
             }
             win->frame_timing.samples[win->frame_timing.sample_count++] = *current;
         }
+        win->frame_presented = true;
         _view_fps_update(win, dvz_input_timestamp_ns());
         if (win->app != NULL && win->app->scene != NULL &&
             dvz_scene_has_active_animations(win->app->scene))
@@ -6734,7 +7060,8 @@ void dvz_app_run(DvzApp* app, uint32_t frame_count)
                 int rc = dvz_view_render_once(win);
                 if (rc == DVZ_CANVAS_FRAME_READY)
                     _view_update_deadline(win, _app_scheduler_now_ns());
-                if (rc == DVZ_CANVAS_FRAME_READY && fps_enabled)
+                // Idle views report skipped frames as ready; count only presented ones.
+                if (rc == DVZ_CANVAS_FRAME_READY && fps_enabled && win->frame_presented)
                     fps_window_frames++;
             }
             if (fps_enabled)
@@ -6746,6 +7073,11 @@ void dvz_app_run(DvzApp* app, uint32_t frame_count)
                     double fps = (double)fps_window_frames * 1e9 / (double)elapsed_ns;
                     _dvz_app_status_fps(
                         &app->status, fps, fps_window_frames, (double)elapsed_ns / 1e9);
+                    DvzDrp2MemoryStats memory = {0};
+                    if (dvz_drp2_runtime_memory_stats(app->runtime, 0, &memory))
+                        _dvz_app_status_memory(
+                            &app->status, memory.resident_bytes, memory.budget,
+                            memory.evicted_bytes);
                     _dvz_app_status_render(&app->status);
                     fps_window_start = now;
                     fps_window_frames = 0;
@@ -111,6 +111,26 @@ void _dvz_app_status_fps(
 
 
 
+/**
+ * Update the GPU memory portion of the terminal status line.
+ *
+ * @param status the status state
+ * @param resident device-local runtime bytes
+ * @param budget enforced budget in bytes, 0 when unlimited
+ * @param evicted bytes demoted to host memory
+ */
+void _dvz_app_status_memory(
+    DvzAppStatus* status, uint64_t resident, uint64_t budget, uint64_t evicted)
+{
+    ANN(status);
+    status->memory_valid = true;
+    status->memory_resident = resident;
+    status->memory_budget = budget;
+    status->memory_evicted = evicted;
+}
+
+
+
 /**
  * Format the current terminal status line.
  *
@@ -155,7 +175,28 @@ bool _dvz_app_status_line(const DvzAppStatus* status, char* out, uint32_t size)
     {
         return false;
     }
-    return written >= 0 && (uint32_t)written < size;
+    if (written < 0 || (uint32_t)written >= size)
+        return false;
+
+    if (status->memory_valid)
+    {
+        const double mib = 1.0 / (1024.0 * 1024.0);
+        int suffix = 0;
+        if (status->memory_budget > 0)
+            suffix = dvz_snprintf(
+                out + written, size - (uint32_t)written,
+                " | VRAM %.1f/%.1f MiB (%.1f MiB evicted)",
+                (double)status->memory_resident * mib, (double)status->memory_budget * mib,
+                (double)status->memory_evicted * mib);
+        else
+            suffix = dvz_snprintf(
+                out + written, size - (uint32_t)written, " | VRAM %.1f MiB",
+                (double)status->memory_resident * mib);
+        if (suffix < 0)
+            return false;
+        written += suffix;
+    }
+    return (uint32_t)written < size;
 }
 
 
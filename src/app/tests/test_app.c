@@ -592,6 +592,7 @@ static int test_app_capture_config_defaults(TstContext* suite, const TstCase* it
     AT(config.fps == 60.0);
     AT(strcmp(config.video_backend, "auto") == 0);
     AT(config.video_capture_mode == DVZ_VIDEO_CAPTURE_AUTO);
+    AT(config.video_queue_depth == 0);
     return 0;
 }
 
@@ -642,12 +643,14 @@ static int test_app_capture_config_env(TstContext* suite, const TstCase* item)
     const char* old_fps = getenv("DVZ_CAPTURE_FPS");
     const char* old_backend = getenv("DVZ_CAPTURE_VIDEO_BACKEND");
     const char* old_mode = getenv("DVZ_CAPTURE_VIDEO_MODE");
+    const char* old_queue = getenv("DVZ_CAPTURE_VIDEO_QUEUE");
     char saved_capture[128] = {0};
     char saved_dir[128] = {0};
     char saved_basename[128] = {0};
     char saved_fps[128] = {0};
     char saved_backend[128] = {0};
     char saved_mode[128] = {0};
+    char saved_queue[128] = {0};
     if (old_capture != NULL)
         dvz_snprintf(saved_capture, sizeof(saved_capture), "%s", old_capture);
     if (old_dir != NULL)
@@ -660,6 +663,8 @@ static int test_app_capture_config_env(TstContext* suite, const TstCase* item)
         dvz_snprintf(saved_backend, sizeof(saved_backend), "%s", old_backend);
     if (old_mode != NULL)
         dvz_snprintf(saved_mode, sizeof(saved_mode), "%s", old_mode);
+    if (old_queue != NULL)
+        dvz_snprintf(saved_queue, sizeof(saved_queue), "%s", old_queue);
 
     AT(tst_setenv("DVZ_CAPTURE", "dvzr,mp4,png") == 0);
     AT(tst_setenv("DVZ_CAPTURE_DIR", "/tmp/datoviz-capture") == 0);
@@ -667,6 +672,7 @@ static int test_app_capture_config_env(TstContext* suite, const TstCase* item)
     AT(tst_setenv("DVZ_CAPTURE_FPS", "24") == 0);
     AT(tst_setenv("DVZ_CAPTURE_VIDEO_BACKEND", "stub") == 0);
     AT(tst_setenv("DVZ_CAPTURE_VIDEO_MODE", "cpu") == 0);
+    AT(tst_setenv("DVZ_CAPTURE_VIDEO_QUEUE", "4") == 0);
 
     DvzAppCaptureConfig config = dvz_app_capture_config_from_env("fallback-name");
     AT((config.flags & DVZ_APP_CAPTURE_DVZR) != 0);
@@ -677,6 +683,7 @@ static int test_app_capture_config_env(TstContext* suite, const TstCase* item)
     AT(config.fps == 24.0);
     AT(strcmp(config.video_backend, "stub") == 0);
     AT(config.video_capture_mode == DVZ_VIDEO_CAPTURE_CPU_READBACK);
+    AT(config.video_queue_depth == 4);
 
     AT(tst_setenv("DVZ_CAPTURE", "off") == 0);
     config = dvz_app_capture_config_from_env("fallback-name");
@@ -688,6 +695,7 @@ static int test_app_capture_config_env(TstContext* suite, const TstCase* item)
     _test_restore_env("DVZ_CAPTURE_FPS", old_fps != NULL ? saved_fps : NULL);
     _test_restore_env("DVZ_CAPTURE_VIDEO_BACKEND", old_backend != NULL ? saved_backend : NULL);
     _test_restore_env("DVZ_CAPTURE_VIDEO_MODE", old_mode != NULL ? saved_mode : NULL);
+    _test_restore_env("DVZ_CAPTURE_VIDEO_QUEUE", old_queue != NULL ? saved_queue : NULL);
     return 0;
 }
 
@@ -1053,6 +1061,29 @@ static int test_app_status_line_combines_trace_and_fps(TstContext* suite, const
 }
 
 
+static int test_app_status_line_reports_memory(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    ANN(item);
+
+    DvzAppStatus status;
+    _dvz_app_status_init(&status);
+    _dvz_app_status_trace(&status, 149, 27, 12, false);
+    _dvz_app_status_fps(&status, 123.4, 124, 1.005);
+
+    char line[192] = {0};
+    _dvz_app_status_memory(&status, 3u << 20, 4u << 20, 1u << 19);
+    AT(_dvz_app_status_line(&status, line, sizeof(line)));
+    AT(strstr(line, "124 frames in 1.005 s) | VRAM 3.0/4.0 MiB (0.5 MiB evicted)") != NULL);
+
+    _dvz_app_status_memory(&status, 3u << 20, 0, 0);
+    AT(_dvz_app_status_line(&status, line, sizeof(line)));
+    AT(strstr(line, "| VRAM 3.0 MiB") != NULL);
+    AT(strstr(line, "evicted") == NULL);
+    return 0;
+}
+
+
 static int test_app_status_line_rejects_truncation(TstContext* suite, const TstCase* item)
 {
     ANN(suite);
@@ -1804,6 +1835,7 @@ int test_app(TstSuite* suite)
     TST_CASE(test_app_trace_plan_normal_changed_after_open_line);
     TST_CASE(test_app_trace_plan_normal_unchanged_rewrites_in_place);
     TST_CASE(test_app_status_line_combines_trace_and_fps);
+    TST_CASE(test_app_status_line_reports_memory);
     TST_CASE(test_app_status_line_rejects_truncation);
     TST_CASE(test_app_trace_fingerprint_name_is_frame_stable);
     TST_CASE(test_app_trace_fingerprint_ignores_frame_handles_and_payloads);
@@ -398,10 +398,19 @@ static uint64_t _trace_hash_command(uint64_t hash, const DvzDrp2Command* command
         hash = _trace_hash_u32(hash, command->u.draw_indexed.first_index);
         hash = _trace_hash_u32(hash, (uint32_t)command->u.draw_indexed.base_vertex);
         return _trace_hash_u32(hash, command->u.draw_indexed.first_instance);
+    case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
+        hash = _trace_hash_u64(hash, command->u.draw_indirect.buffer_id);
+        hash = _trace_hash_u64(hash, command->u.draw_indirect.offset);
+        hash = _trace_hash_u32(hash, command->u.draw_indirect.draw_count);
+        return _trace_hash_u32(hash, command->u.draw_indirect.stride);
     case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS:
         hash = _trace_hash_u32(hash, command->u.dispatch.x);
         hash = _trace_hash_u32(hash, command->u.dispatch.y);
         return _trace_hash_u32(hash, command->u.dispatch.z);
+    case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT:
+        hash = _trace_hash_u64(hash, command->u.dispatch_workgroups_indirect.buffer_id);
+        return _trace_hash_u64(hash, command->u.dispatch_workgroups_indirect.offset);
     case DVZ_DRP2_COMMAND_COPY_BUFFER_TO_BUFFER:
         hash = _trace_hash_u64(hash, command->u.copy_buffer_to_buffer.src_buffer_id);
         hash = _trace_hash_u64(hash, command->u.copy_buffer_to_buffer.src_offset);
@@ -1089,6 +1098,20 @@ static bool _trace_snapshot_append_command(
             command->u.draw_indexed.base_vertex, command->u.draw_indexed.instance_count))
             return false;
         return _trace_snapshot_append_pass_line(snapshot, "render", ordinal, suffix);
+    case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
+        ordinal = _trace_pass_ordinal(passes, pass_count, command->u.draw_indirect.pass_id);
+        if (!_trace_semantic_id(stream, command->u.draw_indirect.buffer_id, a, sizeof(a)))
+            return false;
+        if (!_trace_format_suffix(
+            suffix, sizeof(suffix), "%s args=%s off=%" PRIu64 " count=%" PRIu32
+                                    " stride=%" PRIu32,
+            command->type == DVZ_DRP2_COMMAND_DRAW_INDIRECT ? "draw-indirect"
+                                                            : "draw-indexed-indirect",
+            a, command->u.draw_indirect.offset, command->u.draw_indirect.draw_count,
+            command->u.draw_indirect.stride))
+            return false;
+        return _trace_snapshot_append_pass_line(snapshot, "render", ordinal, suffix);
     case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS:
         ordinal = _trace_pass_ordinal(passes, pass_count, command->u.dispatch.pass_id);
         if (!_trace_format_suffix(
@@ -1096,6 +1119,17 @@ static bool _trace_snapshot_append_command(
             command->u.dispatch.x, command->u.dispatch.y, command->u.dispatch.z))
             return false;
         return _trace_snapshot_append_pass_line(snapshot, "compute", ordinal, suffix);
+    case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT:
+        ordinal = _trace_pass_ordinal(
+            passes, pass_count, command->u.dispatch_workgroups_indirect.pass_id);
+        if (!_trace_semantic_id(
+                stream, command->u.dispatch_workgroups_indirect.buffer_id, a, sizeof(a)))
+            return false;
+        if (!_trace_format_suffix(
+            suffix, sizeof(suffix), "dispatch-indirect args=%s off=%" PRIu64, a,
+            command->u.dispatch_workgroups_indirect.offset))
+            return false;
+        return _trace_snapshot_append_pass_line(snapshot, "compute", ordinal, suffix);
     case DVZ_DRP2_COMMAND_COPY_BUFFER_TO_BUFFER:
         if (!_trace_semantic_id(
                 stream, command->u.copy_buffer_to_buffer.src_buffer_id, a, sizeof(a)) ||
@@ -26,6 +26,7 @@
 #include "_assertions.h"
 #include "_log.h"
 #include "_time_utils.h"
+#include "../vklite/_buffers.h"
 #include "../vklite/_images.h"
 #include "datoviz/common/functions.h"
 #include "datoviz/fileio/fileio.h"
@@ -1394,6 +1395,397 @@ static int canvas_offscreen_capture_rgba_into(
 
 
 
+/*************************************************************************************************/
+/*  Pipelined readback                                                                           */
+/*************************************************************************************************/
+
+static void canvas_readback_slot_release(DvzCanvas* canvas, DvzCanvasReadbackSlot* slot)
+{
+    ANN(canvas);
+    ANN(slot);
+    if (slot->lent != NULL)
+    {
+        log_warn("releasing a readback slot still held by the video sink");
+    }
+    if (slot->fence != NULL)
+    {
+        if (slot->pending)
+        {
+            dvz_fence_wait(slot->fence);
+        }
+        dvz_fence_destroy(slot->fence);
+        dvz_fence_free(slot->fence);
+    }
+    if (slot->cmd != VK_NULL_HANDLE)
+    {
+        dvz_command_buffer_free(canvas->device, canvas->offscreen_queue_family, slot->cmd);
+    }
+    if (slot->staging != NULL)
+    {
+        dvz_buffer_destroy(slot->staging);
+        dvz_buffer_free(slot->staging);
+    }
+    dvz_memset(slot, sizeof(*slot), 0, sizeof(*slot));
+}
+
+
+
+/**
+ * Return a readback slot with neither a copy in flight nor pixels lent to the video sink.
+ *
+ * Slots are added up to DVZ_CANVAS_READBACK_MAX_SLOTS; past that, wait for the encoder thread to
+ * return one.
+ *
+ * @param canvas offscreen canvas
+ * @returns the free slot
+ */
+static DvzCanvasReadbackSlot* canvas_readback_ring_acquire(DvzCanvas* canvas)
+{
+    ANN(canvas);
+    DvzCanvasReadbackRing* ring = &canvas->readback_ring;
+    if (!ring->lock_ready)
+    {
+        dvz_mutex_init(&ring->lock);
+        dvz_cond_init(&ring->returned);
+        ring->lock_ready = true;
+    }
+
+    DvzCanvasReadbackSlot* slot = NULL;
+    dvz_mutex_lock(&ring->lock);
+    for (;;)
+    {
+        for (uint32_t i = 0; i < ring->slot_count && slot == NULL; i++)
+        {
+            if (!ring->slots[i].pending && ring->slots[i].lent == NULL)
+            {
+                slot = &ring->slots[i];
+            }
+        }
+        if (slot == NULL && ring->slot_count < DVZ_CANVAS_READBACK_MAX_SLOTS)
+        {
+            slot = &ring->slots[ring->slot_count++];
+        }
+        if (slot != NULL)
+        {
+            break;
+        }
+        dvz_cond_wait(&ring->returned, &ring->lock);
+    }
+    dvz_mutex_unlock(&ring->lock);
+    return slot;
+}
+
+
+
+/**
+ * Record and submit a fenced copy of the offscreen image into a free readback slot.
+ *
+ * The copy goes to the queue that rendered the frame, after it, so no CPU wait is needed: the
+ * barriers recorded around the copy order it against the render before and the next frame after.
+ *
+ * @param canvas offscreen canvas
+ * @returns 0 on success or -1 on failure
+ */
+static int canvas_readback_ring_push(DvzCanvas* canvas)
+{
+    ANN(canvas);
+    DvzCanvasReadbackRing* ring = &canvas->readback_ring;
+    ASSERT(ring->count < DVZ_CANVAS_READBACK_FRAMES_IN_FLIGHT);
+
+    if (!canvas->offscreen_ready || canvas->offscreen_image == VK_NULL_HANDLE ||
+        canvas->offscreen_runtime_state == DVZ_CANVAS_OFFSCREEN_STATE_DRAW_PENDING)
+    {
+        log_error("offscreen canvas readback requires a submitted frame");
+        return -1;
+    }
+    uint32_t width = canvas->offscreen_extent.width;
+    uint32_t height = canvas->offscreen_extent.height;
+    DvzSize size = (DvzSize)width * (DvzSize)height * 4;
+    DvzCanvasReadbackSlot* slot = canvas_readback_ring_acquire(canvas);
+    ANN(slot);
+
+    if (slot->staging != NULL && slot->staging_size != size)
+    {
+        dvz_buffer_destroy(slot->staging);
+        dvz_buffer_free(slot->staging);
+        slot->staging = NULL;
+    }
+    if (slot->staging == NULL)
+    {
+        slot->staging = dvz_buffer_create_wrapper();
+        ANN(slot->staging);
+        dvz_buffer(canvas->device, canvas->readback_allocator, slot->staging);
+        dvz_buffer_size(slot->staging, size);
+        dvz_buffer_flags(slot->staging, DVZ_ALLOC_HOST_ACCESS_RANDOM | DVZ_ALLOC_MAPPED);
+        dvz_buffer_usage(slot->staging, VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+        if (dvz_buffer_create(slot->staging) != 0)
+        {
+            dvz_buffer_free(slot->staging);
+            slot->staging = NULL;
+            log_error("failed to allocate readback ring staging buffer");
+            return -1;
+        }
+        slot->staging_size = size;
+    }
+    if (slot->cmd == VK_NULL_HANDLE)
+    {
+        slot->cmd = dvz_command_buffer_alloc(canvas->device, canvas->offscreen_queue_family);
+        if (slot->cmd == VK_NULL_HANDLE)
+        {
+            log_error("failed to allocate readback ring command buffer");
+            return -1;
+        }
+    }
+    if (slot->fence == NULL)
+    {
+        slot->fence = dvz_fence_create_wrapper();
+        ANN(slot->fence);
+        dvz_fence(canvas->device, false, slot->fence);
+    }
+    else
+    {
+        dvz_fence_reset(slot->fence);
+    }
+
+    DvzCommands* cmds = dvz_commands_create_wrapper();
+    ANN(cmds);
+    dvz_commands_wrap(canvas->device, slot->cmd, cmds);
+    dvz_cmd_reset(cmds);
+    dvz_cmd_begin(cmds);
+    VkImageLayout original_layout = canvas->offscreen_layout;
+    if (original_layout == VK_IMAGE_LAYOUT_UNDEFINED)
+    {
+        original_layout = VK_IMAGE_LAYOUT_GENERAL;
+    }
+    canvas_cmd_transition_image(
+        canvas, slot->cmd, canvas->offscreen_image, original_layout,
+        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    DvzImageRegion region = {0};
+    dvz_image_region(&region);
+    dvz_image_region_extent(&region, width, height, 1);
+    dvz_cmd_copy_image_to_buffer(
+        cmds, canvas->offscreen_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, &region,
+        dvz_buffer_handle(slot->staging), 0);
+    canvas_cmd_transition_image(
+        canvas, slot->cmd, canvas->offscreen_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        original_layout);
+    dvz_cmd_end(cmds);
+    dvz_commands_free(cmds);
+
+    DvzSubmit* submit = dvz_submit_create_wrapper();
+    ANN(submit);
+    dvz_submit(submit);
+    dvz_submit_command(submit, slot->cmd);
+    int32_t submit_rc =
+        dvz_submit_send(submit, canvas->offscreen_queue, dvz_fence_handle(slot->fence));
+    dvz_submit_free(submit);
+    if (submit_rc != VK_SUCCESS)
+    {
+        log_error("failed to submit readback ring copy commands (%d)", submit_rc);
+        return -1;
+    }
+
+    slot->width = width;
+    slot->height = height;
+    slot->sequence = ring->sequence++;
+    slot->pending = true;
+    ring->count++;
+    return 0;
+}
+
+
+
+/**
+ * Collect the oldest readback slot, waiting for its copy if needed.
+ *
+ * The returned pixels point into the mapped slot, which stays reserved until
+ * dvz_canvas_readback_ring_return() hands it back.
+ *
+ * @param canvas offscreen canvas
+ * @param out_width destination width
+ * @param out_height destination height
+ * @param out_rgba destination pointer receiving the mapped RGBA pixels
+ * @returns 0 when a frame was returned, 1 when the ring is empty, or -1 on failure
+ */
+static int canvas_readback_ring_pop(
+    DvzCanvas* canvas, uint32_t* out_width, uint32_t* out_height, uint8_t** out_rgba)
+{
+    ANN(canvas);
+    DvzCanvasReadbackRing* ring = &canvas->readback_ring;
+    if (ring->count == 0)
+    {
+        return 1;
+    }
+    DvzCanvasReadbackSlot* slot = NULL;
+    for (uint32_t i = 0; i < ring->slot_count; i++)
+    {
+        DvzCanvasReadbackSlot* candidate = &ring->slots[i];
+        if (candidate->pending && (slot == NULL || candidate->sequence < slot->sequence))
+        {
+            slot = candidate;
+        }
+    }
+    ANN(slot);
+
+    dvz_fence_wait(slot->fence);
+    slot->pending = false;
+    ring->count--;
+
+    DvzSize size = (DvzSize)slot->width * (DvzSize)slot->height * 4;
+    DvzBuffer* staging = slot->staging;
+    uint8_t* rgba = (uint8_t*)dvz_allocation_mapped(staging->alloc);
+    if (rgba == NULL || dvz_allocator_invalidate(staging->allocator, staging->alloc, 0, size) != 0)
+    {
+        log_error("failed to map the readback ring staging buffer");
+        return -1;
+    }
+    dvz_mutex_lock(&ring->lock);
+    slot->lent = rgba;
+    dvz_mutex_unlock(&ring->lock);
+
+    *out_width = slot->width;
+    *out_height = slot->height;
+    *out_rgba = rgba;
+    return 0;
+}
+
+
+
+/**
+ * Queue a readback of the current frame and return the frame read back
+ * DVZ_CANVAS_READBACK_FRAMES_IN_FLIGHT submissions earlier.
+ *
+ * Offscreen canvases return pixels lent from the readback ring, to hand back with
+ * dvz_canvas_readback_ring_return(). Swapchain canvases fall back to the synchronous capture,
+ * whose pixels are allocated.
+ *
+ * @param canvas canvas to capture
+ * @param out_width destination width
+ * @param out_height destination height
+ * @param out_rgba destination pointer receiving the RGBA pixels
+ * @returns 0 when a frame was returned, 1 while the ring is filling, or -1 on failure
+ */
+int dvz_canvas_capture_rgba_pipelined(
+    DvzCanvas* canvas, uint32_t* out_width, uint32_t* out_height, uint8_t** out_rgba)
+{
+    ANN(canvas);
+    ANN(out_width);
+    ANN(out_height);
+    ANN(out_rgba);
+    *out_width = 0;
+    *out_height = 0;
+    *out_rgba = NULL;
+    if (!canvas_is_offscreen_mode(canvas))
+    {
+        return dvz_canvas_capture_rgba(canvas, out_width, out_height, out_rgba);
+    }
+
+    int rc = 1;
+    if (canvas->readback_ring.count == DVZ_CANVAS_READBACK_FRAMES_IN_FLIGHT)
+    {
+        rc = canvas_readback_ring_pop(canvas, out_width, out_height, out_rgba);
+        if (rc < 0)
+        {
+            return -1;
+        }
+    }
+    if (canvas_readback_ring_push(canvas) != 0)
+    {
+        dvz_canvas_readback_ring_return(canvas, *out_rgba);
+        *out_rgba = NULL;
+        *out_width = 0;
+        *out_height = 0;
+        return -1;
+    }
+    return rc;
+}
+
+
+
+/**
+ * Return the oldest frame still held by the readback ring.
+ *
+ * @param canvas canvas to drain
+ * @param out_width destination width
+ * @param out_height destination height
+ * @param out_rgba destination pointer receiving the lent RGBA pixels
+ * @returns 0 when a frame was returned, 1 when the ring is empty, or -1 on failure
+ */
+int dvz_canvas_capture_rgba_drain(
+    DvzCanvas* canvas, uint32_t* out_width, uint32_t* out_height, uint8_t** out_rgba)
+{
+    ANN(canvas);
+    ANN(out_width);
+    ANN(out_height);
+    ANN(out_rgba);
+    *out_width = 0;
+    *out_height = 0;
+    *out_rgba = NULL;
+    return canvas_readback_ring_pop(canvas, out_width, out_height, out_rgba);
+}
+
+
+
+/**
+ * Hand pixels lent by the readback ring back so that their slot can be reused.
+ *
+ * This may be called from the encoder thread.
+ *
+ * @param canvas canvas owning the ring
+ * @param rgba pixels returned by dvz_canvas_capture_rgba_pipelined() or the drain
+ * @returns whether the pixels were lent by the ring, false for allocated swapchain captures
+ */
+bool dvz_canvas_readback_ring_return(DvzCanvas* canvas, uint8_t* rgba)
+{
+    ANN(canvas);
+    DvzCanvasReadbackRing* ring = &canvas->readback_ring;
+    if (rgba == NULL || !ring->lock_ready)
+    {
+        return false;
+    }
+    bool found = false;
+    dvz_mutex_lock(&ring->lock);
+    for (uint32_t i = 0; i < ring->slot_count && !found; i++)
+    {
+        if (ring->slots[i].lent == rgba)
+        {
+            ring->slots[i].lent = NULL;
+            found = true;
+        }
+    }
+    dvz_cond_broadcast(&ring->returned);
+    dvz_mutex_unlock(&ring->lock);
+    return found;
+}
+
+
+
+/**
+ * Wait for and release every readback slot.
+ *
+ * @param canvas canvas owning the ring
+ */
+void dvz_canvas_readback_ring_release(DvzCanvas* canvas)
+{
+    if (canvas == NULL)
+    {
+        return;
+    }
+    DvzCanvasReadbackRing* ring = &canvas->readback_ring;
+    for (uint32_t i = 0; i < ring->slot_count; i++)
+    {
+        canvas_readback_slot_release(canvas, &ring->slots[i]);
+    }
+    if (ring->lock_ready)
+    {
+        dvz_cond_destroy(&ring->returned);
+        dvz_mutex_destroy(&ring->lock);
+    }
+    dvz_memset(ring, sizeof(*ring), 0, sizeof(*ring));
+}
+
+
+
 /*************************************************************************************************/
 /*  Public API                                                                                   */
 /*************************************************************************************************/
@@ -1679,6 +2071,7 @@ void dvz_canvas_destroy(DvzCanvas* canvas)
         dvz_stream_sink_registry_destroy(canvas->sink_registry);
         canvas->sink_registry = NULL;
     }
+    dvz_canvas_readback_ring_release(canvas);
     canvas_offscreen_destroy_retired_resources(canvas);
     canvas_offscreen_destroy_resources(canvas);
     canvas_destroy_timeline(canvas);
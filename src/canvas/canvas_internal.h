@@ -29,8 +29,23 @@
 #include "datoviz/vk/memory.h"
 #include "datoviz/vk/memory_interop.h"
 #include "datoviz/window.h"
+#include "datoviz/vklite/buffers.h"
 #include "datoviz/vklite/images.h"
 #include "datoviz/vklite/sync.h"
+#include "mutex_internal.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+// Readback copies in flight on the GPU before the oldest one is collected by the video sink.
+#define DVZ_CANVAS_READBACK_FRAMES_IN_FLIGHT 3
+
+// Readback slots, in flight or lent to the video sink: the copies in flight, the deepest video
+// sink queue and the frame being encoded.
+#define DVZ_CANVAS_READBACK_MAX_SLOTS (DVZ_CANVAS_READBACK_FRAMES_IN_FLIGHT + 64 + 1)
 
 
 
@@ -42,6 +57,8 @@ typedef struct DvzCanvasFramePool DvzCanvasFramePool;
 typedef struct DvzCanvasTimingState DvzCanvasTimingState;
 typedef struct DvzCanvasSurfaceInfo DvzCanvasSurfaceInfo;
 typedef struct DvzCanvasSwapchain DvzCanvasSwapchain;
+typedef struct DvzCanvasReadbackSlot DvzCanvasReadbackSlot;
+typedef struct DvzCanvasReadbackRing DvzCanvasReadbackRing;
 
 
 
@@ -68,6 +85,37 @@ struct DvzCanvasTimingState
 
 
 
+// Host-visible readback slot, filled by a fenced image-to-buffer copy.
+struct DvzCanvasReadbackSlot
+{
+    DvzBuffer* staging;
+    DvzSize staging_size;
+    VkCommandBuffer cmd;
+    DvzFence* fence;
+    uint32_t width;
+    uint32_t height;
+    uint64_t sequence; // submission order of the copy
+    bool pending;      // copy submitted, not yet collected
+    uint8_t* lent;     // mapped pixels handed to the video sink, until returned
+};
+
+
+
+// Readback slots used by pipelined CPU video capture of offscreen canvases. Collected slots are
+// lent to the video sink without a copy and reused once the encoder thread returns them.
+struct DvzCanvasReadbackRing
+{
+    DvzCanvasReadbackSlot slots[DVZ_CANVAS_READBACK_MAX_SLOTS];
+    uint32_t slot_count; // slots used so far
+    uint32_t count;      // slots with a copy in flight or not yet collected
+    uint64_t sequence;   // next submission number
+    DvzMutex lock;       // guards the lent pointers, cleared by the encoder thread
+    DvzCond returned;
+    bool lock_ready;
+};
+
+
+
 struct DvzCanvas
 {
     DvzCanvasConfig cfg;
@@ -134,6 +182,7 @@ struct DvzCanvas
     DvzExternalHandle offscreen_memory_fd;
     bool offscreen_ready;
     DvzCanvasOffscreenRuntimeState offscreen_runtime_state;
+    DvzCanvasReadbackRing readback_ring;
     DvzCanvasSwapchain* swapchain;
 };
 
@@ -256,6 +305,16 @@ int dvz_canvas_swapchain_capture_rgba_into(
     DvzCanvas* canvas, uint32_t width, uint32_t height, uint8_t* out_rgba,
     DvzSize out_size_bytes);
 
+int dvz_canvas_capture_rgba_pipelined(
+    DvzCanvas* canvas, uint32_t* out_width, uint32_t* out_height, uint8_t** out_rgba);
+
+int dvz_canvas_capture_rgba_drain(
+    DvzCanvas* canvas, uint32_t* out_width, uint32_t* out_height, uint8_t** out_rgba);
+
+bool dvz_canvas_readback_ring_return(DvzCanvas* canvas, uint8_t* rgba);
+
+void dvz_canvas_readback_ring_release(DvzCanvas* canvas);
+
 void dvz_canvas_swapchain_test_fail_slot(DvzCanvas* canvas, int32_t slot_index);
 
 void dvz_canvas_swapchain_test_force_recreate_status(DvzCanvas* canvas, int32_t status);
@@ -16,6 +16,7 @@
 
 #include "canvas_internal.h"
 
+#include "_alloc.h"
 #include "_assertions.h"
 #include "_log.h"
 #include "datoviz/video.h"
@@ -199,6 +200,79 @@ static int canvas_capture_rgba_callback(
 
 
 
+/**
+ * Capture the current canvas frame through the pipelined readback ring.
+ *
+ * @param user_data canvas pointer
+ * @param out_width destination width
+ * @param out_height destination height
+ * @param out_stride destination row stride in bytes
+ * @param out_rgba destination pointer receiving the oldest completed frame
+ * @returns 0 on success, 1 while the ring is filling, or -1 when capture fails
+ */
+static int canvas_capture_rgba_pipelined_callback(
+    void* user_data, uint32_t* out_width, uint32_t* out_height, size_t* out_stride,
+    uint8_t** out_rgba)
+{
+    DvzCanvas* canvas = (DvzCanvas*)user_data;
+    ANN(canvas);
+    ANN(out_stride);
+    int rc = dvz_canvas_capture_rgba_pipelined(canvas, out_width, out_height, out_rgba);
+    if (rc == 0)
+    {
+        *out_stride = (size_t)(*out_width) * 4;
+    }
+    return rc;
+}
+
+
+
+/**
+ * Return pixels captured through the pipelined readback ring once the encoder is done with them.
+ *
+ * @param user_data canvas pointer
+ * @param rgba pixels returned by the pipelined capture or flush callbacks
+ */
+static void canvas_release_rgba_pipelined_callback(void* user_data, uint8_t* rgba)
+{
+    DvzCanvas* canvas = (DvzCanvas*)user_data;
+    ANN(canvas);
+    if (!dvz_canvas_readback_ring_return(canvas, rgba))
+    {
+        // Swapchain canvases fall back to an allocated synchronous capture.
+        dvz_free(rgba);
+    }
+}
+
+
+
+/**
+ * Collect the next frame still in flight in the pipelined readback ring.
+ *
+ * @param user_data canvas pointer
+ * @param out_width destination width
+ * @param out_height destination height
+ * @param out_stride destination row stride in bytes
+ * @param out_rgba destination pointer receiving the frame
+ * @returns 0 on success, 1 once the ring is empty, or -1 when the readback fails
+ */
+static int canvas_flush_rgba_callback(
+    void* user_data, uint32_t* out_width, uint32_t* out_height, size_t* out_stride,
+    uint8_t** out_rgba)
+{
+    DvzCanvas* canvas = (DvzCanvas*)user_data;
+    ANN(canvas);
+    ANN(out_stride);
+    int rc = dvz_canvas_capture_rgba_drain(canvas, out_width, out_height, out_rgba);
+    if (rc == 0)
+    {
+        *out_stride = (size_t)(*out_width) * 4;
+    }
+    return rc;
+}
+
+
+
 /**
  * Return whether the canvas can run external-handle video capture.
  *
@@ -298,7 +372,12 @@ static int canvas_create_stream_with_sinks(
         sink_cfg.capture_mode = capture_mode;
         if (capture_mode == DVZ_VIDEO_CAPTURE_CPU_READBACK && sink_cfg.capture_rgba == NULL)
         {
-            sink_cfg.capture_rgba = canvas_capture_rgba_callback;
+            sink_cfg.capture_rgba = sink_cfg.queue_depth > 0
+                                        ? canvas_capture_rgba_pipelined_callback
+                                        : canvas_capture_rgba_callback;
+            sink_cfg.release_rgba =
+                sink_cfg.queue_depth > 0 ? canvas_release_rgba_pipelined_callback : NULL;
+            sink_cfg.flush_rgba = sink_cfg.queue_depth > 0 ? canvas_flush_rgba_callback : NULL;
             sink_cfg.capture_user_data = canvas;
         }
         if (dvz_stream_attach_sink(stream, video_backend, &sink_cfg) != 0)
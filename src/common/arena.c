@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Arena                                                                                        */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "_alloc.h"
+#include "_assertions.h"
+#include "_log.h"
+#include "_overflow.h"
+#include "arena.h"
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct DvzArenaChunk DvzArenaChunk;
+
+struct DvzArenaChunk
+{
+    DvzArenaChunk* next;
+    uint64_t size; // usable bytes after the header
+    uint64_t used;
+};
+
+struct DvzArena
+{
+    DvzSize chunk_size;
+    DvzArenaChunk* first;
+    DvzArenaChunk* current;
+    void* last; // most recent allocation, the only one that can grow in place
+    DvzArenaStats stats;
+};
+
+#define ARENA_CHUNK_HEADER                                                                        \
+    ((sizeof(DvzArenaChunk) + DVZ_ARENA_ALIGNMENT - 1) & ~(uint64_t)(DVZ_ARENA_ALIGNMENT - 1))
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Round a byte size up to the arena alignment.
+ *
+ * @param size byte size
+ * @param out aligned size
+ * @return false on overflow
+ */
+static inline bool _arena_align(DvzSize size, uint64_t* out)
+{
+    if (size > UINT64_MAX - (DVZ_ARENA_ALIGNMENT - 1))
+        return false;
+    *out = (size + DVZ_ARENA_ALIGNMENT - 1) & ~(uint64_t)(DVZ_ARENA_ALIGNMENT - 1);
+    return true;
+}
+
+
+
+/**
+ * Return the first usable byte of a chunk.
+ *
+ * @param chunk the chunk
+ * @return the chunk data
+ */
+static inline uint8_t* _arena_chunk_data(const DvzArenaChunk* chunk)
+{
+    return (uint8_t*)chunk + ARENA_CHUNK_HEADER;
+}
+
+
+
+/**
+ * Allocate a chunk on the heap.
+ *
+ * @param arena the arena
+ * @param size usable byte size
+ * @return the chunk, or NULL on failure
+ */
+static DvzArenaChunk* _arena_chunk(DvzArena* arena, uint64_t size)
+{
+    if (size > SIZE_MAX - ARENA_CHUNK_HEADER)
+        return NULL;
+    DvzArenaChunk* chunk = (DvzArenaChunk*)dvz_malloc(ARENA_CHUNK_HEADER + size);
+    if (chunk == NULL)
+        return NULL;
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    arena->stats.chunk_allocs++;
+    arena->stats.chunk_count++;
+    arena->stats.capacity += size;
+    return chunk;
+}
+
+
+
+/**
+ * Free every chunk of an arena.
+ *
+ * @param arena the arena
+ */
+static void _arena_free_chunks(DvzArena* arena)
+{
+    DvzArenaChunk* chunk = arena->first;
+    while (chunk != NULL)
+    {
+        DvzArenaChunk* next = chunk->next;
+        dvz_free(chunk);
+        chunk = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->stats.chunk_count = 0;
+    arena->stats.capacity = 0;
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzArena* dvz_arena(DvzSize chunk_size)
+{
+    DvzArena* arena = (DvzArena*)dvz_calloc(1, sizeof(DvzArena));
+    if (arena == NULL)
+        return NULL;
+    uint64_t aligned = 0;
+    if (!_arena_align(chunk_size > 0 ? chunk_size : DVZ_ARENA_DEFAULT_CHUNK_SIZE, &aligned))
+    {
+        dvz_free(arena);
+        return NULL;
+    }
+    arena->chunk_size = aligned;
+    return arena;
+}
+
+
+
+void* dvz_arena_alloc(DvzArena* arena, DvzSize size)
+{
+    ANN(arena);
+    uint64_t aligned = 0;
+    if (!_arena_align(size > 0 ? size : 1, &aligned))
+    {
+        log_error("arena allocation size overflow");
+        return NULL;
+    }
+
+    // Move past the chunks kept by a reset that could not merge them.
+    DvzArenaChunk* chunk = arena->current;
+    while (chunk != NULL && chunk->size - chunk->used < aligned && chunk->next != NULL)
+        chunk = chunk->next;
+    if (chunk == NULL || chunk->size - chunk->used < aligned)
+    {
+        DvzArenaChunk* added =
+            _arena_chunk(arena, aligned > arena->chunk_size ? aligned : arena->chunk_size);
+        if (added == NULL)
+        {
+            log_error("arena chunk allocation failed");
+            return NULL;
+        }
+        if (chunk == NULL)
+            arena->first = added;
+        else
+            chunk->next = added;
+        chunk = added;
+    }
+
+    arena->current = chunk;
+    uint8_t* pointer = _arena_chunk_data(chunk) + chunk->used;
+    chunk->used += aligned;
+    dvz_memset(pointer, (size_t)aligned, 0, (size_t)aligned);
+    arena->last = pointer;
+    arena->stats.used += aligned;
+    if (arena->stats.used > arena->stats.peak)
+        arena->stats.peak = arena->stats.used;
+    return pointer;
+}
+
+
+
+void* dvz_arena_calloc(DvzArena* arena, DvzSize count, DvzSize size)
+{
+    uint64_t bytes = 0;
+    if (_dvz_mul_u64_overflows(count, size, &bytes))
+    {
+        log_error("arena allocation size multiplication overflow");
+        return NULL;
+    }
+    return dvz_arena_alloc(arena, bytes);
+}
+
+
+
+void* dvz_arena_grow(DvzArena* arena, void* pointer, DvzSize old_size, DvzSize new_size)
+{
+    ANN(arena);
+    if (pointer == NULL)
+        return dvz_arena_alloc(arena, new_size);
+    if (new_size <= old_size)
+        return pointer;
+
+    DvzArenaChunk* chunk = arena->current;
+    uint64_t old_aligned = 0, new_aligned = 0;
+    if (
+        pointer == arena->last && chunk != NULL && _arena_align(old_size, &old_aligned) &&
+        _arena_align(new_size, &new_aligned))
+    {
+        uint64_t offset = (uint64_t)((uint8_t*)pointer - _arena_chunk_data(chunk));
+        if (new_aligned <= chunk->size - offset)
+        {
+            dvz_memset(
+                (uint8_t*)pointer + old_size, (size_t)(new_aligned - old_size), 0,
+                (size_t)(new_aligned - old_size));
+            chunk->used = offset + new_aligned;
+            arena->stats.used += new_aligned - old_aligned;
+            if (arena->stats.used > arena->stats.peak)
+                arena->stats.peak = arena->stats.used;
+            return pointer;
+        }
+    }
+
+    void* grown = dvz_arena_alloc(arena, new_size);
+    if (grown == NULL)
+        return NULL;
+    dvz_memcpy(grown, (size_t)new_size, pointer, (size_t)old_size);
+    return grown;
+}
+
+
+
+char* dvz_arena_strdup(DvzArena* arena, const char* string)
+{
+    ANN(arena);
+    ANN(string);
+    size_t len = strlen(string);
+    char* copy = (char*)dvz_arena_alloc(arena, len + 1);
+    if (copy != NULL)
+        dvz_memcpy(copy, len + 1, string, len);
+    return copy;
+}
+
+
+
+void* dvz_arena_escape(DvzArena* arena, const void* pointer, DvzSize size)
+{
+    if (pointer == NULL || size == 0 || size > SIZE_MAX)
+        return NULL;
+    void* copy = dvz_malloc(size);
+    if (copy == NULL)
+        return NULL;
+    dvz_memcpy(copy, (size_t)size, pointer, (size_t)size);
+    if (arena != NULL)
+        arena->stats.escape_count++;
+    return copy;
+}
+
+
+
+bool dvz_arena_owns(const DvzArena* arena, const void* pointer)
+{
+    if (arena == NULL || pointer == NULL)
+        return false;
+    for (const DvzArenaChunk* chunk = arena->first; chunk != NULL; chunk = chunk->next)
+    {
+        const uint8_t* data = _arena_chunk_data(chunk);
+        if ((const uint8_t*)pointer >= data && (const uint8_t*)pointer < data + chunk->size)
+            return true;
+    }
+    return false;
+}
+
+
+
+void dvz_arena_reset(DvzArena* arena)
+{
+    ANN(arena);
+    arena->last = NULL;
+    arena->stats.used = 0;
+    arena->stats.reset_count++;
+    if (arena->first == NULL)
+        return;
+
+    // The common case: the previous cycle fit in one chunk.
+    if (arena->first->next == NULL)
+    {
+        arena->first->used = 0;
+        arena->current = arena->first;
+        return;
+    }
+
+    // The previous cycle overflowed: replace the chunks with one chunk holding all of them.
+    uint64_t capacity = arena->stats.capacity;
+    _arena_free_chunks(arena);
+    arena->first = _arena_chunk(arena, capacity);
+    arena->current = arena->first;
+}
+
+
+
+DvzArenaStats dvz_arena_stats(const DvzArena* arena)
+{
+    DvzArenaStats stats = {0};
+    if (arena != NULL)
+        stats = arena->stats;
+    return stats;
+}
+
+
+
+void dvz_arena_destroy(DvzArena* arena)
+{
+    if (arena == NULL)
+        return;
+    _arena_free_chunks(arena);
+    dvz_free(arena);
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Arena                                                                                        */
+/*************************************************************************************************/
+
+/* A bump allocator for short-lived objects that are all released at once. Allocations are
+ * zero-initialized and aligned on DVZ_ARENA_ALIGNMENT bytes; they cannot be freed individually.
+ * Resetting the arena makes its whole capacity available again in O(1): chunks are kept, and
+ * when a cycle overflowed into several chunks they are merged into one so that the next cycles
+ * of the same size make no heap allocation. Data that must survive a reset is copied out with
+ * dvz_arena_escape(). */
+
+#pragma once
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "datoviz/common/macros.h"
+#include "datoviz/math/types.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_ARENA_ALIGNMENT          16
+#define DVZ_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzArena DvzArena;
+typedef struct DvzArenaStats DvzArenaStats;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzArenaStats
+{
+    uint64_t used;           // bytes handed out since the last reset, padding included
+    uint64_t capacity;       // bytes held by the arena chunks
+    uint64_t peak;           // largest `used` value seen by the arena
+    uint32_t chunk_count;    // number of chunks currently held
+    uint64_t chunk_allocs;   // heap allocations made for chunks since creation
+    uint64_t escape_count;   // copies made by dvz_arena_escape() since creation
+    uint64_t reset_count;    // resets since creation
+};
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+EXTERN_C_ON
+
+/**
+ * Create an arena.
+ *
+ * @param chunk_size minimum byte size of each chunk, 0 for DVZ_ARENA_DEFAULT_CHUNK_SIZE
+ * @return the arena, or NULL on allocation failure
+ */
+DVZ_EXPORT DvzArena* dvz_arena(DvzSize chunk_size);
+
+
+
+/**
+ * Allocate zero-initialized bytes from an arena.
+ *
+ * @param arena the arena
+ * @param size byte size
+ * @return the allocation, valid until the next reset, or NULL on failure
+ */
+DVZ_EXPORT void* dvz_arena_alloc(DvzArena* arena, DvzSize size);
+
+
+
+/**
+ * Allocate a zero-initialized array from an arena.
+ *
+ * @param arena the arena
+ * @param count item count
+ * @param size item byte size
+ * @return the allocation, valid until the next reset, or NULL on failure or overflow
+ */
+DVZ_EXPORT void* dvz_arena_calloc(DvzArena* arena, DvzSize count, DvzSize size);
+
+
+
+/**
+ * Grow an arena allocation, keeping its contents.
+ *
+ * The last allocation of the arena grows in place when its chunk has room; other allocations
+ * are moved to a new allocation and their old bytes stay unused until the next reset. Added
+ * bytes are zero-initialized.
+ *
+ * @param arena the arena
+ * @param pointer an allocation of this arena, or NULL
+ * @param old_size current byte size of the allocation
+ * @param new_size requested byte size
+ * @return the grown allocation, or NULL on failure (the original allocation is left intact)
+ */
+DVZ_EXPORT void*
+dvz_arena_grow(DvzArena* arena, void* pointer, DvzSize old_size, DvzSize new_size);
+
+
+
+/**
+ * Copy a string into an arena.
+ *
+ * @param arena the arena
+ * @param string the string
+ * @return the copy, or NULL on failure
+ */
+DVZ_EXPORT char* dvz_arena_strdup(DvzArena* arena, const char* string);
+
+
+
+/**
+ * Copy arena bytes to the heap so that they outlive the next reset.
+ *
+ * @param arena the arena the bytes come from, used for statistics only
+ * @param pointer the bytes to copy
+ * @param size byte size
+ * @return a heap copy to release with dvz_free(), or NULL on failure
+ */
+DVZ_EXPORT void* dvz_arena_escape(DvzArena* arena, const void* pointer, DvzSize size);
+
+
+
+/**
+ * Return whether a pointer lies in one of the arena chunks.
+ *
+ * @param arena the arena, or NULL
+ * @param pointer the pointer
+ * @return whether the pointer belongs to the arena
+ */
+DVZ_EXPORT bool dvz_arena_owns(const DvzArena* arena, const void* pointer);
+
+
+
+/**
+ * Release every allocation of an arena at once.
+ *
+ * @param arena the arena
+ */
+DVZ_EXPORT void dvz_arena_reset(DvzArena* arena);
+
+
+
+/**
+ * Return the usage statistics of an arena.
+ *
+ * @param arena the arena
+ * @return the statistics, zeroed for a NULL arena
+ */
+DVZ_EXPORT DvzArenaStats dvz_arena_stats(const DvzArena* arena);
+
+
+
+/**
+ * Destroy an arena and its chunks.
+ *
+ * @param arena the arena, or NULL
+ */
+DVZ_EXPORT void dvz_arena_destroy(DvzArena* arena);
+
+EXTERN_C_OFF
@@ -94,6 +94,14 @@ int dvz_cond_signal(DvzCond* cond)
 
 
 
+int dvz_cond_broadcast(DvzCond* cond)
+{
+    ANN(cond);
+    return pthread_cond_broadcast(cond);
+}
+
+
+
 int dvz_cond_wait(DvzCond* cond, DvzMutex* mutex)
 {
     ANN(cond);
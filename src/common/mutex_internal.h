@@ -62,6 +62,8 @@ DvzCond dvz_cond(void);
 
 int dvz_cond_signal(DvzCond* cond);
 
+int dvz_cond_broadcast(DvzCond* cond);
+
 int dvz_cond_wait(DvzCond* cond, DvzMutex* mutex);
 
 void dvz_cond_destroy(DvzCond* cond);
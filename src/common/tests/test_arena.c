@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Testing arena                                                                                */
+/*************************************************************************************************/
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "_alloc.h"
+#include "_assertions.h"
+#include "arena.h"
+#include "test_common.h"
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Tests                                                                                        */
+/*************************************************************************************************/
+
+int test_arena_basic(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+
+    DvzArena* arena = dvz_arena(256);
+    AT(arena != NULL);
+
+    // Allocations are aligned and zero-initialized.
+    uint8_t* a = (uint8_t*)dvz_arena_alloc(arena, 3);
+    uint32_t* b = (uint32_t*)dvz_arena_calloc(arena, 8, sizeof(uint32_t));
+    AT(a != NULL && b != NULL);
+    AT((uintptr_t)a % DVZ_ARENA_ALIGNMENT == 0);
+    AT((uintptr_t)b % DVZ_ARENA_ALIGNMENT == 0);
+    AT(a[0] == 0 && a[2] == 0);
+    for (uint32_t i = 0; i < 8; i++)
+        AT(b[i] == 0);
+    AT(dvz_arena_owns(arena, a));
+    AT(dvz_arena_owns(arena, b + 7));
+
+    // The last allocation grows in place, others move and keep their contents.
+    b[0] = 42;
+    uint32_t* grown =
+        (uint32_t*)dvz_arena_grow(arena, b, 8 * sizeof(uint32_t), 16 * sizeof(uint32_t));
+    AT(grown == b);
+    AT(grown[0] == 42 && grown[15] == 0);
+    a[0] = 7;
+    uint8_t* moved = (uint8_t*)dvz_arena_grow(arena, a, 3, 32);
+    AT(moved != NULL && moved != a);
+    AT(moved[0] == 7 && moved[31] == 0);
+
+    // Strings, and escaped copies that outlive a reset.
+    char* label = dvz_arena_strdup(arena, "panel_0");
+    AT(label != NULL && strcmp(label, "panel_0") == 0);
+    char* kept = (char*)dvz_arena_escape(arena, label, strlen(label) + 1);
+    AT(kept != NULL && !dvz_arena_owns(arena, kept));
+
+    // Requests larger than a chunk get their own chunk.
+    uint8_t* large = (uint8_t*)dvz_arena_alloc(arena, 1024);
+    AT(large != NULL && large[1023] == 0);
+
+    DvzArenaStats stats = dvz_arena_stats(arena);
+    AT(stats.used > 0 && stats.peak >= stats.used);
+    AT(stats.chunk_count >= 2);
+    AT(stats.escape_count == 1);
+
+    dvz_arena_reset(arena);
+    AT(strcmp(kept, "panel_0") == 0);
+    AT(dvz_arena_stats(arena).used == 0);
+    AT(!dvz_arena_owns(NULL, kept));
+
+    dvz_free(kept);
+    dvz_arena_destroy(arena);
+    dvz_arena_destroy(NULL);
+    return 0;
+}
+
+
+
+int test_arena_reset_coalesces(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+
+    DvzArena* arena = dvz_arena(128);
+    AT(arena != NULL);
+
+    // A cycle that overflows its first chunk ends up holding several chunks.
+    for (uint32_t i = 0; i < 20; i++)
+        AT(dvz_arena_alloc(arena, 48) != NULL);
+    DvzArenaStats stats = dvz_arena_stats(arena);
+    AT(stats.chunk_count > 1);
+    uint64_t capacity = stats.capacity;
+
+    // The reset merges them into one chunk of the same capacity...
+    dvz_arena_reset(arena);
+    stats = dvz_arena_stats(arena);
+    AT(stats.chunk_count == 1);
+    AT(stats.capacity == capacity);
+    uint64_t chunk_allocs = stats.chunk_allocs;
+
+    // ...so that identical cycles no longer allocate.
+    for (uint32_t cycle = 0; cycle < 4; cycle++)
+    {
+        for (uint32_t i = 0; i < 20; i++)
+            AT(dvz_arena_alloc(arena, 48) != NULL);
+        dvz_arena_reset(arena);
+    }
+    stats = dvz_arena_stats(arena);
+    AT(stats.chunk_allocs == chunk_allocs);
+    AT(stats.chunk_count == 1);
+    AT(stats.reset_count == 5);
+
+    dvz_arena_destroy(arena);
+    return 0;
+}
@@ -39,6 +39,10 @@ int test_common(TstSuite* suite)
     TST_CASE(test_alloc_basic);
     TST_CASE(test_alloc_aligned);
 
+    TST_GROUP("arena");
+    TST_CASE(test_arena_basic);
+    TST_CASE(test_arena_reset_coalesces);
+
     TST_GROUP("time");
     TST_CASE(test_time_monotonic_ns);
 
@@ -27,6 +27,8 @@
 int test_obj_1(TstContext* suite, const TstCase* tstitem);
 int test_alloc_basic(TstContext* suite, const TstCase* tstitem);
 int test_alloc_aligned(TstContext* suite, const TstCase* tstitem);
+int test_arena_basic(TstContext* suite, const TstCase* tstitem);
+int test_arena_reset_coalesces(TstContext* suite, const TstCase* tstitem);
 int test_time_monotonic_ns(TstContext* suite, const TstCase* tstitem);
 
 int test_log_default_level(TstContext* suite, const TstCase* tstitem);
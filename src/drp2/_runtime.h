@@ -44,6 +44,7 @@
 
 #define DVZ_DRP2_RUNTIME_INITIAL_OBJECT_CAPACITY 64
 #define DVZ_DRP2_RGBA8_BYTES_PER_TEXEL 4
+#define DVZ_DRP2_MAX_PENDING_TRANSFERS 256
 
 
 
@@ -114,6 +115,10 @@ struct DvzDrp2Runtime
     DvzVma* allocator;
     bool semantic_only;
     bool timing_enabled;
+    bool sync_transfers; /* block on every transfer submission instead of a timeline */
+    uint64_t memory_budget; /* enforced device-local budget, 0 when disabled */
+    uint64_t memory_owner;  /* owner tag stamped on resources created by later executions */
+    uint64_t memory_frame;  /* frame clock advanced by dvz_drp2_runtime_begin_frame() */
     DvzDrp2RuntimeTiming last_timing;
     Drp2RuntimeState* semantic_state;
 #if DVZ_DRP2_HAS_VKLITE
@@ -127,6 +132,8 @@ void _dvz_drp2_runtime_timing_enable(DvzDrp2Runtime* runtime, bool enabled);
 bool _dvz_drp2_runtime_timing_get(
     const DvzDrp2Runtime* runtime, DvzDrp2RuntimeTiming* timing);
 
+void _dvz_drp2_runtime_async_transfers(DvzDrp2Runtime* runtime, bool enabled);
+
 
 struct Drp2Object
 {
@@ -263,6 +270,10 @@ struct Drp2VkliteObject
     float scissor_width;
     float scissor_height;
     uint64_t current_pipeline_id;
+    DvzCommands* primary_commands; /* pass primary while `commands` records a pass bundle */
+    uint64_t bundle_key;
+    uint32_t bundle_end_index;
+    bool bundle_replayed;
     VkPipelineLayout combined_pipeline_layout; /* owned combined layout for two-set pipelines */
     VkDevice         combined_layout_device;   /* VkDevice needed to destroy combined_pipeline_layout */
     bool borrowed_slots;
@@ -272,6 +283,15 @@ struct Drp2VkliteObject
     bool borrowed_frame_depth;
     DvzSemaphore* external_timeline_semaphore;
     bool external_timeline_pending;
+    uint64_t transfer_value; /* transfer timeline value of the last copy touching this object */
+    uint64_t memory_bytes;   /* estimated allocation size of an owned buffer or texture */
+    uint64_t memory_owner;   /* runtime owner tag when the object was created */
+    uint64_t memory_frame;   /* runtime frame of the last stream that referenced the object */
+    bool memory_device_local;
+    bool memory_lru_linked;   /* whether the texture is in the eviction LRU list */
+    uint32_t memory_lru_prev; /* LRU neighbours, slot index + 1, 0 at either end */
+    uint32_t memory_lru_next;
+    DvzBuffer* evicted_copy; /* host copy of an evicted texture, NULL while resident */
     bool destroyed;
 };
 
@@ -285,6 +305,38 @@ struct Drp2DeferredDestroy
 };
 
 
+typedef struct Drp2PendingTransfer Drp2PendingTransfer;
+
+struct Drp2PendingTransfer
+{
+    uint64_t value;
+    DvzCommands* commands;
+    DvzBuffer* staging; /* owned staging buffer, NULL for copies between runtime objects */
+};
+
+
+typedef struct Drp2BindGroupRef Drp2BindGroupRef;
+
+struct Drp2BindGroupRef
+{
+    uint64_t resource_id; /* 0 for empty slots and tombstones */
+    uint64_t bind_group_id;
+    bool tombstone;
+};
+
+
+typedef struct Drp2PassBundle Drp2PassBundle;
+
+struct Drp2PassBundle
+{
+    uint64_t key;
+    uint64_t generation;
+    uint64_t last_used;
+    DvzCommands* commands; /* recorded secondary, NULL while the key is only a candidate */
+    VkCommandBuffer last_primary; /* primary that last executed it, NULL once an owned one ran */
+};
+
+
 struct Drp2VkliteState
 {
     DvzDrp2Runtime* runtime;
@@ -295,6 +347,29 @@ struct Drp2VkliteState
     uint32_t deferred_count;
     Drp2DeferredDestroy* deferred;
     VkCommandBuffer active_borrowed_command_buffer;
+    uint32_t max_draw_indirect_count; /* records per indirect draw call, 0 until queried */
+    uint32_t bundle_capacity;
+    uint32_t bundle_count;
+    Drp2PassBundle* bundles;
+    uint64_t bundle_generation; /* bumped whenever a resource a bundle may reference is retired */
+    uint64_t bundle_tick;       /* bumped once per executed stream */
+    uint64_t bundle_replays;
+    DvzSemaphore* transfer_timeline; /* NULL while transfers are submitted synchronously */
+    uint64_t transfer_submitted;     /* last timeline value signaled by a transfer */
+    uint64_t transfer_completed;     /* last timeline value observed on the host */
+    uint32_t transfer_count;
+    Drp2PendingTransfer transfers[DVZ_DRP2_MAX_PENDING_TRANSFERS];
+    DvzDescriptorAllocator* descriptor_allocator; /* bind-group pool chains, created lazily */
+    uint32_t bind_ref_capacity;                   /* power of two */
+    uint32_t bind_ref_count;
+    uint32_t bind_ref_tombstones;
+    Drp2BindGroupRef* bind_refs; /* resource id -> dependent bind group id, open addressing */
+    uint32_t lru_head;           /* least recently used evictable texture, slot index + 1 */
+    uint32_t lru_tail;           /* most recently used evictable texture, slot index + 1 */
+    uint32_t evicted_count;      /* textures currently demoted to host memory */
+    uint64_t eviction_count;
+    uint64_t restore_count;
+    uint64_t restore_bytes;
 };
 
 #endif
@@ -350,6 +425,26 @@ DvzCommands* _vklite_borrowed_frame_commands_create(
 void _vklite_borrowed_frame_commands_free(DvzCommands* cmds);
 DvzDrp2ValidationResult _vklite_owned_commands_end_submit(
     DvzCommands* cmds, uint32_t command_index);
+int _vklite_transfer_begin(DvzCommands* cmds);
+DvzDrp2ValidationResult _vklite_transfer_submit(
+    Drp2VkliteState* state, DvzCommands* cmds, DvzBuffer* staging, Drp2VkliteObject* src,
+    Drp2VkliteObject* dst, uint32_t command_index);
+void _vklite_transfer_retire(Drp2VkliteState* state);
+void _vklite_transfer_wait(Drp2VkliteState* state, uint64_t value);
+void _vklite_transfer_cleanup(Drp2VkliteState* state);
+bool _vklite_create_staging_buffer(
+    Drp2VkliteState* state, uint64_t size, DvzBuffer** buffer, VkBufferUsageFlags usage);
+bool _vklite_texture_evictable(const Drp2VkliteObject* object);
+bool _vklite_texture_allocate(Drp2VkliteState* state, Drp2VkliteObject* object);
+void _vklite_budget_track(
+    Drp2VkliteState* state, Drp2VkliteObject* object, bool device_local);
+void _vklite_budget_forget(Drp2VkliteState* state, Drp2VkliteObject* object);
+DvzDrp2ValidationResult _vklite_budget_use(
+    Drp2VkliteState* state, uint64_t id, uint32_t command_index);
+DvzDrp2ValidationResult _vklite_budget_prepare(
+    Drp2VkliteState* state, const DvzDrp2CommandStream* stream);
+void _vklite_budget_stats(
+    const Drp2VkliteState* state, uint64_t owner, DvzDrp2MemoryStats* stats);
 VkImageLayout _vklite_texture_access_layout(Drp2TextureAccess access);
 void _vklite_texture_access_scope(
     Drp2TextureAccess access, VkPipelineStageFlags2* stage, VkAccessFlags2* access_mask);
@@ -368,6 +463,9 @@ DvzDrp2ValidationResult _vklite_build_bind_group_descriptors(
     DvzDescriptors** out);
 DvzDrp2ValidationResult _vklite_refresh_dependent_bind_groups(
     Drp2VkliteState* state, uint64_t resource_id, uint32_t command_index);
+bool _vklite_bind_refs_add(Drp2VkliteState* state, const Drp2VkliteObject* bind_group);
+void _vklite_bind_refs_remove(Drp2VkliteState* state, const Drp2VkliteObject* bind_group);
+void _vklite_bind_refs_cleanup(Drp2VkliteState* state);
 VkSampleCountFlagBits _vklite_sample_count(uint32_t sample_count);
 DvzDrp2ValidationResult _vklite_create_bind_group(
     Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index);
@@ -410,10 +508,25 @@ DvzDrp2ValidationResult _vklite_draw(
     Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index);
 DvzDrp2ValidationResult _vklite_draw_indexed(
     Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index);
+DvzDrp2ValidationResult _vklite_draw_indirect(
+    Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index);
 DvzDrp2ValidationResult _vklite_dispatch_workgroups(
     Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index);
+DvzDrp2ValidationResult _vklite_dispatch_workgroups_indirect(
+    Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index);
 DvzDrp2ValidationResult _vklite_end_render_pass(
     Drp2VkliteState* state, uint64_t pass_id, uint32_t command_index);
 DvzDrp2ValidationResult _vklite_end_compute_pass(
     Drp2VkliteState* state, uint64_t pass_id, uint32_t command_index);
+void _vklite_pass_bundles_invalidate(Drp2VkliteState* state);
+void _vklite_pass_bundles_note_retired(Drp2VkliteState* state, const Drp2VkliteObject* object);
+void _vklite_pass_bundles_note_primary_done(Drp2VkliteState* state, VkCommandBuffer primary);
+void _vklite_pass_bundles_cleanup(Drp2VkliteState* state);
+DvzDrp2ValidationResult _vklite_pass_bundle_begin(
+    Drp2VkliteState* state, const DvzDrp2CommandStream* stream, uint32_t command_index,
+    Drp2VkliteObject* pass, const VkCommandBufferInheritanceRenderingInfo* inheritance);
+DvzDrp2ValidationResult _vklite_pass_bundle_end(
+    Drp2VkliteState* state, Drp2VkliteObject* pass, uint32_t command_index);
+uint32_t _vklite_pass_bundle_resume_index(
+    Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index);
 #endif
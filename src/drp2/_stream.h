@@ -16,6 +16,7 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include "arena.h"
 #include "datoviz/drp2.h"
 
 
@@ -26,6 +27,12 @@
 
 #define DVZ_DRP2_INITIAL_COMMAND_CAPACITY 64
 #define DVZ_DRP2_LABEL_SIZE 512
+#define DVZ_DRP2_PAYLOAD_CHUNK_SIZE (16 * 1024)
+#define DVZ_DRP2_PAYLOAD_ARENA_MAX  1024
+#define DVZ_DRP2_FINGERPRINT_OFFSET UINT64_C(0xcbf29ce484222325)
+#define DVZ_DRP2_FINGERPRINT_PRIME  UINT64_C(0x00000100000001b3)
+/* Unversioned payloads up to this size are hashed into the incremental stream fingerprint. */
+#define DVZ_DRP2_FINGERPRINT_INLINE_PAYLOAD 256
 
 
 
@@ -174,6 +181,7 @@ struct DvzDrp2Command
             void* data_raw;        /* in-process path: copied bytes */
             bool data_raw_owned;   /* whether data_raw is owned directly by this command */
             char* data_base64;     /* JSON path: heap-allocated, freed by stream_destroy */
+            uint64_t payload_version; /* caller content version for fingerprints, 0 = none */
         } write_buffer;
         struct
         {
@@ -190,6 +198,7 @@ struct DvzDrp2Command
             const void* data_raw; /* in-process path: borrowed or owned pointer */
             bool data_raw_owned;  /* whether data_raw is owned directly by this command */
             char* data_base64;    /* JSON path: heap-allocated, freed by stream_destroy */
+            uint64_t payload_version; /* caller content version for fingerprints, 0 = none */
         } write_texture;
         struct
         {
@@ -292,6 +301,20 @@ struct DvzDrp2Command
             uint64_t pass_id;
         } end_compute_pass;
         struct
+        {
+            uint64_t pass_id;
+            uint64_t buffer_id;
+            uint64_t offset;
+            uint32_t draw_count; /* 1 for a single draw, >1 for multi-draw-indirect */
+            uint32_t stride;     /* byte stride between records; 0 means tightly packed */
+        } draw_indirect;         /* shared by DrawIndirect and DrawIndexedIndirect */
+        struct
+        {
+            uint64_t pass_id;
+            uint64_t buffer_id;
+            uint64_t offset;
+        } dispatch_workgroups_indirect;
+        struct
         {
             uint64_t encoder_id;
             uint64_t buffer_id;
@@ -386,6 +409,10 @@ struct DvzDrp2CommandStream
     void* owner;
     DvzDrp2StreamOwnerRelease owner_release;
     bool owner_released;
+    DvzArena* payloads; // small write payloads copied by the stream, freed with it
+    uint64_t fingerprint;         // incremental fingerprint of commands [0, fingerprint_count)
+    uint32_t fingerprint_count;   // commands folded so far; the last command may still change
+    bool fingerprint_unversioned; // a folded command carries a large unversioned payload
 };
 
 
@@ -400,3 +427,36 @@ struct DvzDrp2CommandStream
  * @param stream the command stream
  */
 void _dvz_drp2_stream_release_owner(DvzDrp2CommandStream* stream);
+
+
+
+/**
+ * Allocate storage for a write payload owned by a DRP2 stream.
+ *
+ * Payloads up to DVZ_DRP2_PAYLOAD_ARENA_MAX bytes share the stream payload arena so that the
+ * uniform writes of a frame do not each hit the heap; larger payloads are allocated on the heap.
+ * Either way, the storage is released by dvz_drp2_stream_destroy() when the command marks its
+ * payload as owned.
+ *
+ * @param stream the command stream
+ * @param size byte size
+ * @return the payload storage, or NULL on failure
+ */
+void* _dvz_drp2_stream_payload(DvzDrp2CommandStream* stream, uint64_t size);
+
+
+
+/**
+ * Fold one command into an incremental stream fingerprint.
+ *
+ * The command record is hashed in packet layout. Write payloads contribute their declared payload
+ * version; unversioned payloads are hashed when small, and otherwise flag the fingerprint as
+ * unversioned instead of being read.
+ *
+ * @param hash running fingerprint
+ * @param command the command to fold
+ * @param[out] unversioned set when the command carries a large unversioned payload
+ * @return the updated fingerprint
+ */
+uint64_t _dvz_drp2_fingerprint_command(
+    uint64_t hash, const DvzDrp2Command* command, bool* unversioned);
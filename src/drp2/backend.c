@@ -46,6 +46,8 @@ static VkBufferUsageFlags _vklite_buffer_usage(uint32_t usage)
         out |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
     if ((usage & DVZ_DRP2_BUFFER_USAGE_STORAGE) != 0)
         out |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    if ((usage & DVZ_DRP2_BUFFER_USAGE_INDIRECT) != 0)
+        out |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
     return out != 0 ? out : VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 }
 
@@ -65,6 +67,25 @@ static DvzAllocationFlags _vklite_buffer_alloc_flags(uint32_t usage)
 }
 
 
+/**
+ * Return whether a texture may be created as a Vulkan transient attachment.
+ *
+ * Vulkan only accepts the transient bit next to attachment usages, so a texture that is also
+ * sampled, stored to, or copied keeps ordinary memory even when the emitter flagged it.
+ *
+ * @param usage DRP2 texture usage flags
+ * @return whether the texture is a transient attachment
+ */
+static bool _vklite_texture_is_transient(uint32_t usage)
+{
+    const uint32_t other = DVZ_DRP2_TEXTURE_USAGE_COPY_SRC | DVZ_DRP2_TEXTURE_USAGE_COPY_DST |
+                           DVZ_DRP2_TEXTURE_USAGE_TEXTURE_BINDING |
+                           DVZ_DRP2_TEXTURE_USAGE_STORAGE_BINDING;
+    return (usage & DVZ_DRP2_TEXTURE_USAGE_TRANSIENT_ATTACHMENT) != 0 &&
+           (usage & DVZ_DRP2_TEXTURE_USAGE_RENDER_ATTACHMENT) != 0 && (usage & other) == 0;
+}
+
+
 static VkImageUsageFlags _vklite_texture_usage(uint32_t usage)
 {
     VkImageUsageFlags out = 0;
@@ -78,6 +99,8 @@ static VkImageUsageFlags _vklite_texture_usage(uint32_t usage)
         out |= VK_IMAGE_USAGE_STORAGE_BIT;
     if ((usage & DVZ_DRP2_TEXTURE_USAGE_RENDER_ATTACHMENT) != 0)
         out |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if (_vklite_texture_is_transient(usage))
+        out |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
     return out != 0 ? out : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
 }
 
@@ -139,6 +162,91 @@ static VkImageUsageFlags _vklite_texture_usage_for_format(uint32_t usage, uint32
 }
 
 
+/**
+ * Return whether a texture may be demoted to host memory under a memory budget.
+ *
+ * Only single-sampled color textures that are sampled and never rendered to or stored to qualify,
+ * so their whole content can be copied out and back with one transfer each.
+ *
+ * @param object vklite texture object
+ * @return whether the texture is evictable
+ */
+bool _vklite_texture_evictable(const Drp2VkliteObject* object)
+{
+    ANN(object);
+    const uint32_t pinned = DVZ_DRP2_TEXTURE_USAGE_RENDER_ATTACHMENT |
+                            DVZ_DRP2_TEXTURE_USAGE_STORAGE_BINDING |
+                            DVZ_DRP2_TEXTURE_USAGE_TRANSIENT_ATTACHMENT;
+    uint32_t bytes_per_texel = 0;
+    return object->kind == DRP2_OBJECT_TEXTURE && !object->borrowed_frame_target &&
+           (object->usage & DVZ_DRP2_TEXTURE_USAGE_TEXTURE_BINDING) != 0 &&
+           (object->usage & pinned) == 0 && object->sample_count <= 1 &&
+           !_vklite_format_has_depth(object->format) &&
+           _drp2_texture_format_bytes_per_texel(object->format, &bytes_per_texel);
+}
+
+
+/**
+ * Create the image and view of a texture object from its recorded description.
+ *
+ * Used when the texture is created and when an evicted texture is restored. On failure, the
+ * partially-created image and view stay on the object for the caller to release.
+ *
+ * @param state vklite runtime state
+ * @param object texture object with usage, format, extent, and sample count set
+ * @return whether the image and its view were created
+ */
+bool _vklite_texture_allocate(Drp2VkliteState* state, Drp2VkliteObject* object)
+{
+    ANN(state);
+    ANN(object);
+    DvzImages* images = dvz_images_create_wrapper();
+    if (images == NULL)
+        return false;
+    object->images = images;
+
+    VkFormat format = (VkFormat)object->format;
+    VkImageUsageFlags usage = _vklite_texture_usage_for_format(object->usage, object->format);
+    if (_vklite_texture_evictable(object))
+        usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    VkImageType img_type = object->depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
+    dvz_images(state->runtime->device, state->runtime->allocator, img_type, 1, images);
+    dvz_images_format(images, format);
+    dvz_images_size(images, object->width, object->height, object->depth);
+    dvz_images_mip(images, 1);
+    dvz_images_layers(images, 1);
+    dvz_images_samples(images, _vklite_sample_count(object->sample_count));
+    dvz_images_usage(images, usage);
+    if (_vklite_texture_is_transient(object->usage))
+        dvz_images_alloc_flags(images, DVZ_ALLOC_LAZILY_ALLOCATED);
+    if (dvz_images_create(images) != 0)
+        return false;
+
+    if ((object->usage &
+         (DVZ_DRP2_TEXTURE_USAGE_TEXTURE_BINDING |
+          DVZ_DRP2_TEXTURE_USAGE_STORAGE_BINDING |
+          DVZ_DRP2_TEXTURE_USAGE_RENDER_ATTACHMENT)) != 0)
+    {
+        DvzImageViews* views = dvz_image_views_create_wrapper();
+        if (views == NULL)
+            return false;
+        object->views = views;
+        dvz_image_views(images, views);
+        dvz_image_views_type(
+            views, object->depth > 1 ? VK_IMAGE_VIEW_TYPE_3D : VK_IMAGE_VIEW_TYPE_2D);
+        if (_vklite_format_has_depth(object->format))
+            dvz_image_views_aspect(views, VK_IMAGE_ASPECT_DEPTH_BIT);
+        dvz_image_views_create(views);
+        if (dvz_image_views_handle(views, 0) == VK_NULL_HANDLE)
+            return false;
+    }
+
+    object->image_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    object->texture_access = DRP2_TEXTURE_ACCESS_NONE;
+    return true;
+}
+
+
 /**
  * Destroy a partially-created vklite object and return a validation failure.
  *
@@ -197,6 +305,9 @@ static DvzDrp2ValidationResult _vklite_create_buffer(
     if (dvz_buffer_create(buffer) != 0)
         return _vklite_fail_destroy_object(
             object, DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    _vklite_budget_track(
+        state, object,
+        _vklite_buffer_alloc_flags(command->u.create_buffer.usage) == DVZ_ALLOC_FLAGS_NONE);
     if (replaced)
     {
         DvzDrp2ValidationResult result = _vklite_refresh_dependent_bind_groups(
@@ -235,60 +346,19 @@ static DvzDrp2ValidationResult _vklite_create_texture(
     if (object == NULL)
         return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
 
-    DvzImages* images = dvz_images_create_wrapper();
-    if (images == NULL)
-        return _vklite_fail_destroy_object(
-            object, DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
-    object->images = images;
-
-    uint32_t depth = command->u.create_texture.depth > 1 ? command->u.create_texture.depth : 1;
-    VkFormat format = command->u.create_texture.format != 0 ?
-                          (VkFormat)command->u.create_texture.format :
-                          VK_FORMAT_R8G8B8A8_UNORM;
-    VkImageType img_type = depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
-    dvz_images(state->runtime->device, state->runtime->allocator, img_type, 1, images);
-    dvz_images_format(images, format);
-    dvz_images_size(
-        images, command->u.create_texture.width, command->u.create_texture.height, depth);
-    dvz_images_mip(images, 1);
-    dvz_images_layers(images, 1);
-    dvz_images_samples(images, _vklite_sample_count(command->u.create_texture.sample_count));
-    dvz_images_usage(
-        images, _vklite_texture_usage_for_format(command->u.create_texture.usage, format));
-    if (dvz_images_create(images) != 0)
-        return _vklite_fail_destroy_object(
-            object, DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
-
-    if ((command->u.create_texture.usage &
-         (DVZ_DRP2_TEXTURE_USAGE_TEXTURE_BINDING |
-          DVZ_DRP2_TEXTURE_USAGE_STORAGE_BINDING |
-          DVZ_DRP2_TEXTURE_USAGE_RENDER_ATTACHMENT)) != 0)
-    {
-        DvzImageViews* views = dvz_image_views_create_wrapper();
-        if (views == NULL)
-            return _vklite_fail_destroy_object(
-                object, DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
-        object->views = views;
-        dvz_image_views(images, views);
-        dvz_image_views_type(
-            views, depth > 1 ? VK_IMAGE_VIEW_TYPE_3D : VK_IMAGE_VIEW_TYPE_2D);
-        if (_vklite_format_has_depth(format))
-            dvz_image_views_aspect(views, VK_IMAGE_ASPECT_DEPTH_BIT);
-        dvz_image_views_create(views);
-        if (dvz_image_views_handle(views, 0) == VK_NULL_HANDLE)
-            return _vklite_fail_destroy_object(
-                object, DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
-    }
-
-    object->image_layout = VK_IMAGE_LAYOUT_UNDEFINED;
-    object->texture_access = DRP2_TEXTURE_ACCESS_NONE;
     object->usage = command->u.create_texture.usage;
-    object->format = (uint32_t)format;
+    object->format = command->u.create_texture.format != 0 ?
+                         command->u.create_texture.format :
+                         (uint32_t)VK_FORMAT_R8G8B8A8_UNORM;
     object->width = command->u.create_texture.width;
     object->height = command->u.create_texture.height;
-    object->depth = depth;
+    object->depth = command->u.create_texture.depth > 1 ? command->u.create_texture.depth : 1;
     object->sample_count =
         command->u.create_texture.sample_count != 0 ? command->u.create_texture.sample_count : 1;
+    if (!_vklite_texture_allocate(state, object))
+        return _vklite_fail_destroy_object(
+            object, DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    _vklite_budget_track(state, object, true);
     if (replaced)
     {
         DvzDrp2ValidationResult result = _vklite_refresh_dependent_bind_groups(
@@ -586,9 +656,11 @@ _vklite_execute(DvzDrp2Runtime* runtime, const DvzDrp2CommandStream* stream)
 
     Drp2VkliteState* state = runtime->vklite_state;
     state->runtime = runtime;
-    DvzDrp2ValidationResult result = _drp2_ok();
+    state->bundle_tick++;
+    _vklite_transfer_retire(state);
+    DvzDrp2ValidationResult result = _vklite_budget_prepare(state, stream);
 
-    for (uint32_t i = 0; i < stream->count; i++)
+    for (uint32_t i = 0; result.ok && i < stream->count; i++)
     {
         const DvzDrp2Command* command = &stream->commands[i];
         switch (command->type)
@@ -668,6 +740,8 @@ _vklite_execute(DvzDrp2Runtime* runtime, const DvzDrp2CommandStream* stream)
             break;
         case DVZ_DRP2_COMMAND_BEGIN_RENDER_PASS:
             result = _vklite_begin_render_pass(state, stream, command, i);
+            if (result.ok)
+                i = _vklite_pass_bundle_resume_index(state, command, i);
             break;
         case DVZ_DRP2_COMMAND_BEGIN_COMPUTE_PASS:
             result = _vklite_begin_compute_pass(state, command, i);
@@ -696,9 +770,16 @@ _vklite_execute(DvzDrp2Runtime* runtime, const DvzDrp2CommandStream* stream)
         case DVZ_DRP2_COMMAND_DRAW_INDEXED:
             result = _vklite_draw_indexed(state, command, i);
             break;
+        case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+        case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
+            result = _vklite_draw_indirect(state, command, i);
+            break;
         case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS:
             result = _vklite_dispatch_workgroups(state, command, i);
             break;
+        case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT:
+            result = _vklite_dispatch_workgroups_indirect(state, command, i);
+            break;
         case DVZ_DRP2_COMMAND_END_RENDER_PASS:
             result = _vklite_end_render_pass(state, command->u.end_render_pass.pass_id, i);
             break;
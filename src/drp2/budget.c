@@ -0,0 +1,560 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  DRP2 vklite memory budget                                                                    */
+/*************************************************************************************************/
+
+/*
+ * Every owned buffer and texture records its estimated size, the owner tag active when it was
+ * created, whether it lives in device-local memory, and the runtime frame of the last stream that
+ * referenced it. Resident evictable textures are also kept in a list ordered by last use. With a
+ * budget set, each execution first restores the evicted textures the stream references, then
+ * demotes textures from the least recently used end of the list to host buffers until the
+ * device-local usage fits. Only textures that no owner referenced during the last
+ * DVZ_DRP2_MEMORY_EVICT_MIN_FRAMES frames are demoted, so the textures another view drew during
+ * the previous frame stay resident. Restoring happens before any command is recorded because
+ * render passes transition the textures of their bind groups up front.
+ *
+ * Buffers are never demoted: the backend already places every buffer the host writes or reads in
+ * host-visible memory, and the remaining ones are GPU-written storage or indirect buffers.
+ */
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "_alloc.h"
+#include "_assertions.h"
+#include "_log.h"
+#include "_runtime.h"
+#include "_stream.h"
+#include "datoviz/vk/memory.h"
+
+
+
+#if DVZ_DRP2_HAS_VKLITE
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_DRP2_MEMORY_EVICT_MIN_FRAMES 2u
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Return the tightly-packed byte size of a texture's single mip level.
+ *
+ * @param object vklite texture object
+ * @return texel bytes times extent and sample count
+ */
+static uint64_t _vklite_texture_bytes(const Drp2VkliteObject* object)
+{
+    ANN(object);
+    uint32_t bytes_per_texel = 0;
+    if (!_drp2_texture_format_bytes_per_texel(object->format, &bytes_per_texel))
+        bytes_per_texel = DVZ_DRP2_RGBA8_BYTES_PER_TEXEL;
+    return (uint64_t)object->width * object->height * object->depth * bytes_per_texel *
+           (object->sample_count > 1 ? object->sample_count : 1);
+}
+
+
+
+/**
+ * Remove a texture from the eviction LRU list.
+ *
+ * @param state vklite runtime state
+ * @param object vklite object, left untouched when it is not in the list
+ */
+static void _vklite_lru_unlink(Drp2VkliteState* state, Drp2VkliteObject* object)
+{
+    ANN(state);
+    ANN(object);
+    if (!object->memory_lru_linked)
+        return;
+    if (object->memory_lru_prev != 0)
+        state->objects[object->memory_lru_prev - 1].memory_lru_next = object->memory_lru_next;
+    else
+        state->lru_head = object->memory_lru_next;
+    if (object->memory_lru_next != 0)
+        state->objects[object->memory_lru_next - 1].memory_lru_prev = object->memory_lru_prev;
+    else
+        state->lru_tail = object->memory_lru_prev;
+    object->memory_lru_prev = 0;
+    object->memory_lru_next = 0;
+    object->memory_lru_linked = false;
+}
+
+
+
+/**
+ * Move a resident evictable texture to the most recently used end of the eviction LRU list.
+ *
+ * @param state vklite runtime state
+ * @param object vklite texture slot of the object table
+ */
+static void _vklite_lru_touch(Drp2VkliteState* state, Drp2VkliteObject* object)
+{
+    ANN(state);
+    ANN(object);
+    ASSERT(object >= state->objects && object < state->objects + state->count);
+    _vklite_lru_unlink(state, object);
+    uint32_t link = (uint32_t)(object - state->objects) + 1;
+    object->memory_lru_prev = state->lru_tail;
+    if (state->lru_tail != 0)
+        state->objects[state->lru_tail - 1].memory_lru_next = link;
+    else
+        state->lru_head = link;
+    state->lru_tail = link;
+    object->memory_lru_linked = true;
+}
+
+
+
+/**
+ * Detach the image and view of a texture into a standalone object that can be destroyed.
+ *
+ * @param object vklite texture object keeping its slot and description
+ * @return object owning the detached image and view
+ */
+static Drp2VkliteObject _vklite_detach_image(Drp2VkliteObject* object)
+{
+    ANN(object);
+    Drp2VkliteObject detached = {0};
+    detached.id = object->id;
+    detached.kind = DRP2_OBJECT_TEXTURE;
+    detached.images = object->images;
+    detached.views = object->views;
+    detached.transfer_value = object->transfer_value;
+    object->images = NULL;
+    object->views = NULL;
+    object->image_layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    object->texture_access = DRP2_TEXTURE_ACCESS_NONE;
+    return detached;
+}
+
+
+
+/**
+ * Record a whole-texture copy region.
+ *
+ * @param object vklite texture object
+ * @param region output region, tightly packed in the buffer
+ */
+static void _vklite_texture_region(const Drp2VkliteObject* object, DvzImageRegion* region)
+{
+    ANN(object);
+    ANN(region);
+    dvz_image_region(region);
+    dvz_image_region_extent(region, object->width, object->height, object->depth);
+}
+
+
+
+/**
+ * Upload an evicted texture from its host copy into a new image.
+ *
+ * The host copy becomes the staging buffer of the transfer and is released once it completes.
+ * Bind groups are rebuilt against the new view.
+ *
+ * @param state vklite runtime state
+ * @param object evicted texture
+ * @param command_index index of the first command referencing the texture
+ * @return DRP2 validation result
+ */
+static DvzDrp2ValidationResult
+_vklite_restore_texture(Drp2VkliteState* state, Drp2VkliteObject* object, uint32_t command_index)
+{
+    ANN(state);
+    ANN(object);
+    ANN(object->evicted_copy);
+
+    DvzCommands* cmds = NULL;
+    if (_vklite_texture_allocate(state, object))
+        cmds = _vklite_owned_commands_create(state->runtime->device);
+    if (cmds == NULL || _vklite_transfer_begin(cmds) != 0)
+    {
+        _vklite_owned_commands_destroy(cmds);
+        Drp2VkliteObject detached = _vklite_detach_image(object);
+        _vklite_destroy_object(&detached);
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    }
+
+    DvzBuffer* copy = object->evicted_copy;
+    object->evicted_copy = NULL;
+    state->evicted_count--;
+
+    DvzImageRegion region = {0};
+    _vklite_texture_region(object, &region);
+    _vklite_transition_image_access(cmds, object, DRP2_TEXTURE_ACCESS_TRANSFER_WRITE);
+    dvz_cmd_copy_buffer_to_image(
+        cmds, dvz_buffer_handle(copy), 0, dvz_image_handle(object->images, 0),
+        _vklite_texture_access_layout(DRP2_TEXTURE_ACCESS_TRANSFER_WRITE), &region);
+    DvzDrp2ValidationResult result =
+        _vklite_transfer_submit(state, cmds, copy, NULL, object, command_index);
+    if (!result.ok)
+        return result;
+
+    state->restore_count++;
+    state->restore_bytes += object->memory_bytes;
+    return _vklite_refresh_dependent_bind_groups(state, object->id, command_index);
+}
+
+
+
+/**
+ * Copy a resident texture into a new host buffer and release its image.
+ *
+ * The copy is submitted on the transfer timeline; the image is destroyed once it completes, or
+ * deferred to the active borrowed frame command buffer, which may still sample it.
+ *
+ * @param state vklite runtime state
+ * @param object resident evictable texture
+ * @return whether the texture was evicted
+ */
+static bool _vklite_evict_texture(Drp2VkliteState* state, Drp2VkliteObject* object)
+{
+    ANN(state);
+    ANN(object);
+    ANN(object->images);
+
+    DvzBuffer* copy = NULL;
+    if (!_vklite_create_staging_buffer(
+            state, _vklite_texture_bytes(object), &copy,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+        return false;
+
+    DvzCommands* cmds = _vklite_owned_commands_create(state->runtime->device);
+    if (cmds == NULL || _vklite_transfer_begin(cmds) != 0)
+    {
+        _vklite_owned_commands_destroy(cmds);
+        dvz_buffer_destroy(copy);
+        dvz_buffer_free(copy);
+        return false;
+    }
+
+    DvzImageRegion region = {0};
+    _vklite_texture_region(object, &region);
+    _vklite_transition_image_access(cmds, object, DRP2_TEXTURE_ACCESS_TRANSFER_READ);
+    dvz_cmd_copy_image_to_buffer(
+        cmds, dvz_image_handle(object->images, 0),
+        _vklite_texture_access_layout(DRP2_TEXTURE_ACCESS_TRANSFER_READ), &region,
+        dvz_buffer_handle(copy), 0);
+    if (!_vklite_transfer_submit(state, cmds, NULL, object, NULL, 0).ok)
+    {
+        dvz_buffer_destroy(copy);
+        dvz_buffer_free(copy);
+        return false;
+    }
+
+    object->evicted_copy = copy;
+    state->evicted_count++;
+    state->eviction_count++;
+    _vklite_lru_unlink(state, object);
+
+    Drp2VkliteObject detached = _vklite_detach_image(object);
+    if (state->active_borrowed_command_buffer != VK_NULL_HANDLE &&
+        _vklite_defer_destroy_object(state, &detached, state->active_borrowed_command_buffer))
+        return true;
+    _vklite_transfer_wait(state, detached.transfer_value);
+    _vklite_pass_bundles_note_retired(state, &detached);
+    _vklite_destroy_object(&detached);
+    return true;
+}
+
+
+
+/**
+ * Return the least recently used resident evictable texture, if it is old enough to evict.
+ *
+ * The LRU list is ordered by last use, so when its head was referenced during the last
+ * DVZ_DRP2_MEMORY_EVICT_MIN_FRAMES frames, every other texture was too.
+ *
+ * @param state vklite runtime state
+ * @return eviction candidate, or NULL when none is left
+ */
+static Drp2VkliteObject* _vklite_eviction_candidate(Drp2VkliteState* state)
+{
+    ANN(state);
+    ANN(state->runtime);
+    if (state->lru_head == 0)
+        return NULL;
+    Drp2VkliteObject* object = &state->objects[state->lru_head - 1];
+    if (state->runtime->memory_frame - object->memory_frame < DVZ_DRP2_MEMORY_EVICT_MIN_FRAMES)
+        return NULL;
+    return object;
+}
+
+
+
+/**
+ * Return the device-local bytes of the resident runtime-owned buffers and textures.
+ *
+ * @param state vklite runtime state
+ * @return resident device-local bytes
+ */
+static uint64_t _vklite_resident_bytes(const Drp2VkliteState* state)
+{
+    ANN(state);
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < state->count; i++)
+    {
+        const Drp2VkliteObject* object = &state->objects[i];
+        if (!object->destroyed && object->memory_device_local && object->evicted_copy == NULL)
+            bytes += object->memory_bytes;
+    }
+    return bytes;
+}
+
+
+
+/**
+ * Mark the textures one command reads or writes as used, restoring evicted ones.
+ *
+ * @param state vklite runtime state
+ * @param command DRP2 command
+ * @param command_index command index used for validation reporting
+ * @return DRP2 validation result
+ */
+static DvzDrp2ValidationResult _vklite_budget_use_command(
+    Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index)
+{
+    ANN(state);
+    ANN(command);
+    DvzDrp2ValidationResult result = _drp2_ok();
+    switch (command->type)
+    {
+    case DVZ_DRP2_COMMAND_SET_BIND_GROUP:
+    {
+        const Drp2VkliteObject* bind_group =
+            _vklite_find(state, command->u.set_bind_group.bind_group_id);
+        if (bind_group == NULL || bind_group->kind != DRP2_OBJECT_BIND_GROUP)
+            break;
+        for (uint32_t e = 0; result.ok && e < bind_group->bind_group_entry_count; e++)
+            result = _vklite_budget_use(
+                state, bind_group->bind_group_entries[e].resource_id, command_index);
+        break;
+    }
+    case DVZ_DRP2_COMMAND_CREATE_BIND_GROUP:
+        for (uint32_t e = 0; result.ok && e < command->u.create_bind_group.entry_count; e++)
+            result = _vklite_budget_use(
+                state, command->u.create_bind_group.entries[e].resource_id, command_index);
+        break;
+    case DVZ_DRP2_COMMAND_WRITE_TEXTURE:
+        result = _vklite_budget_use(state, command->u.write_texture.texture_id, command_index);
+        break;
+    case DVZ_DRP2_COMMAND_COPY_BUFFER_TO_TEXTURE:
+        result = _vklite_budget_use(
+            state, command->u.copy_buffer_to_texture.dst_texture_id, command_index);
+        break;
+    case DVZ_DRP2_COMMAND_COPY_TEXTURE_TO_BUFFER:
+        result = _vklite_budget_use(
+            state, command->u.copy_texture_to_buffer.src_texture_id, command_index);
+        break;
+    case DVZ_DRP2_COMMAND_COPY_TEXTURE_TO_TEXTURE:
+        result = _vklite_budget_use(
+            state, command->u.copy_texture_to_texture.src_texture_id, command_index);
+        if (result.ok)
+            result = _vklite_budget_use(
+                state, command->u.copy_texture_to_texture.dst_texture_id, command_index);
+        break;
+    default:
+        break;
+    }
+    return result;
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Record the size, owner, and memory class of a newly created buffer or texture.
+ *
+ * @param state vklite runtime state
+ * @param object created buffer or texture
+ * @param device_local whether the allocation lives in device-local memory
+ */
+void _vklite_budget_track(Drp2VkliteState* state, Drp2VkliteObject* object, bool device_local)
+{
+    ANN(state);
+    ANN(state->runtime);
+    ANN(object);
+    object->memory_owner = state->runtime->memory_owner;
+    object->memory_frame = state->runtime->memory_frame;
+    object->memory_device_local = device_local;
+    object->memory_bytes = object->kind == DRP2_OBJECT_BUFFER ?
+                               (uint64_t)dvz_buffer_allocated_size(object->buffer) :
+                               _vklite_texture_bytes(object);
+    if (object->images != NULL && object->memory_bytes > 0 && _vklite_texture_evictable(object))
+        _vklite_lru_touch(state, object);
+}
+
+
+
+/**
+ * Drop a buffer or texture that leaves the object table from the eviction LRU list.
+ *
+ * @param state vklite runtime state
+ * @param object destroyed or deferred object
+ */
+void _vklite_budget_forget(Drp2VkliteState* state, Drp2VkliteObject* object)
+{
+    ANN(state);
+    ANN(object);
+    _vklite_lru_unlink(state, object);
+}
+
+
+
+/**
+ * Mark one object as used by the current stream, restoring it first when it is evicted.
+ *
+ * @param state vklite runtime state
+ * @param id DRP2 object id, ignored when it does not name a tracked buffer or texture
+ * @param command_index command index used for validation reporting
+ * @return DRP2 validation result
+ */
+DvzDrp2ValidationResult
+_vklite_budget_use(Drp2VkliteState* state, uint64_t id, uint32_t command_index)
+{
+    ANN(state);
+    ANN(state->runtime);
+    if (id == 0)
+        return _drp2_ok();
+    Drp2VkliteObject* object = _vklite_find(state, id);
+    if (object == NULL || object->memory_bytes == 0)
+        return _drp2_ok();
+    object->memory_frame = state->runtime->memory_frame;
+    bool evicted = object->evicted_copy != NULL;
+    if (evicted)
+    {
+        DvzDrp2ValidationResult result = _vklite_restore_texture(state, object, command_index);
+        if (!result.ok)
+            return result;
+    }
+    if (evicted || object->memory_lru_linked)
+        _vklite_lru_touch(state, object);
+    return _drp2_ok();
+}
+
+
+
+/**
+ * Restore the evicted textures a stream references, then evict until the budget is met.
+ *
+ * Resources the stream creates are counted from the next execution on. While a borrowed frame
+ * command buffer is active, released images return to the allocator only once that frame
+ * completes.
+ *
+ * @param state vklite runtime state
+ * @param stream command stream about to execute
+ * @return DRP2 validation result
+ */
+DvzDrp2ValidationResult
+_vklite_budget_prepare(Drp2VkliteState* state, const DvzDrp2CommandStream* stream)
+{
+    ANN(state);
+    ANN(state->runtime);
+    ANN(stream);
+    uint64_t budget = state->runtime->memory_budget;
+    if (budget == 0 && state->evicted_count == 0)
+        return _drp2_ok();
+
+    for (uint32_t i = 0; i < stream->count; i++)
+    {
+        DvzDrp2ValidationResult result =
+            _vklite_budget_use_command(state, &stream->commands[i], i);
+        if (!result.ok)
+            return result;
+    }
+    if (budget == 0)
+        return _drp2_ok();
+
+    uint64_t usage = 0;
+    if (budget == DVZ_DRP2_MEMORY_BUDGET_DEVICE)
+    {
+        DvzMemoryBudget heaps = {0};
+        if (dvz_allocator_budget(state->runtime->allocator, &heaps) != 0)
+            return _drp2_ok();
+        budget = heaps.device_budget;
+        usage = heaps.device_usage;
+    }
+    else
+    {
+        usage = _vklite_resident_bytes(state);
+    }
+
+    // Deferred images still count in the allocator, so the usage is tracked here instead.
+    while (usage > budget)
+    {
+        Drp2VkliteObject* candidate = _vklite_eviction_candidate(state);
+        if (candidate == NULL)
+            break;
+        uint64_t bytes = candidate->memory_bytes;
+        if (!_vklite_evict_texture(state, candidate))
+        {
+            log_warn("unable to evict texture %" PRIu64 " to host memory", candidate->id);
+            break;
+        }
+        usage = usage > bytes ? usage - bytes : 0;
+    }
+    return _drp2_ok();
+}
+
+
+
+/**
+ * Sum the memory of the runtime-owned buffers and textures of one owner.
+ *
+ * @param state vklite runtime state
+ * @param owner owner tag, or 0 for every object
+ * @param stats statistics to accumulate into
+ */
+void _vklite_budget_stats(
+    const Drp2VkliteState* state, uint64_t owner, DvzDrp2MemoryStats* stats)
+{
+    ANN(state);
+    ANN(stats);
+    for (uint32_t i = 0; i < state->count; i++)
+    {
+        const Drp2VkliteObject* object = &state->objects[i];
+        if (object->destroyed || object->memory_bytes == 0)
+            continue;
+        if (owner != 0 && object->memory_owner != owner)
+            continue;
+        if (object->evicted_copy != NULL)
+        {
+            stats->evicted_bytes += object->memory_bytes;
+            stats->evicted_count++;
+        }
+        else if (object->memory_device_local)
+        {
+            stats->resident_bytes += object->memory_bytes;
+            stats->resident_count++;
+        }
+        else
+        {
+            stats->host_bytes += object->memory_bytes;
+        }
+    }
+    stats->eviction_count = state->eviction_count;
+    stats->restore_count = state->restore_count;
+    stats->restore_bytes = state->restore_bytes;
+}
+#endif
@@ -0,0 +1,627 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  DRP2 vklite render pass bundles                                                              */
+/*************************************************************************************************/
+
+/*
+ * A pass bundle is a secondary command buffer holding the body of one render pass (pipeline,
+ * vertex/index buffer and bind group bindings, dynamic viewport/scissor, draws). The body is keyed
+ * by a fingerprint of its commands and of the backend objects they resolve to. A key seen once is
+ * kept as a candidate; the second occurrence records a bundle while drawing, and later occurrences
+ * replay it with vkCmdExecuteCommands() and skip the inner commands entirely.
+ *
+ * Bundles are invalidated wholesale whenever a buffer, pipeline, bind group, sampler or texture is
+ * retired, so a replayed bundle never references a destroyed Vulkan object.
+ */
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "_alloc.h"
+#include "_assertions.h"
+#include "_log.h"
+#include "_runtime.h"
+#include "_stream.h"
+#include "datoviz/vk/device.h"
+
+
+
+#if DVZ_DRP2_HAS_VKLITE
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_DRP2_PASS_BUNDLE_CAPACITY 64u
+#define DVZ_DRP2_PASS_BUNDLE_MAX_AGE  240u
+
+#define DVZ_DRP2_PASS_BUNDLE_OFFSET UINT64_C(0xcbf29ce484222325)
+#define DVZ_DRP2_PASS_BUNDLE_PRIME  UINT64_C(0x100000001b3)
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+static void _bundle_hash(uint64_t* hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++)
+    {
+        *hash ^= bytes[i];
+        *hash *= DVZ_DRP2_PASS_BUNDLE_PRIME;
+    }
+}
+
+
+
+static void _bundle_hash_u64(uint64_t* hash, uint64_t value)
+{
+    _bundle_hash(hash, &value, sizeof(value));
+}
+
+
+
+static void _bundle_hash_ptr(uint64_t* hash, const void* ptr)
+{
+    _bundle_hash_u64(hash, (uint64_t)(uintptr_t)ptr);
+}
+
+
+
+/**
+ * Return the pass id of a command that may appear inside a cached render pass body.
+ *
+ * @param command DRP2 command
+ * @param[out] pass_id owning pass id
+ * @return whether the command type can be recorded into a pass bundle
+ */
+static bool _bundle_command_pass_id(const DvzDrp2Command* command, uint64_t* pass_id)
+{
+    ANN(command);
+    ANN(pass_id);
+    switch (command->type)
+    {
+    case DVZ_DRP2_COMMAND_SET_PIPELINE:
+        *pass_id = command->u.set_pipeline.pass_id;
+        return true;
+    case DVZ_DRP2_COMMAND_SET_VERTEX_BUFFER:
+        *pass_id = command->u.set_vertex_buffer.pass_id;
+        return true;
+    case DVZ_DRP2_COMMAND_SET_INDEX_BUFFER:
+        *pass_id = command->u.set_index_buffer.pass_id;
+        return true;
+    case DVZ_DRP2_COMMAND_SET_VIEWPORT:
+        *pass_id = command->u.set_viewport.pass_id;
+        return true;
+    case DVZ_DRP2_COMMAND_SET_SCISSOR:
+        *pass_id = command->u.set_scissor.pass_id;
+        return true;
+    case DVZ_DRP2_COMMAND_SET_BIND_GROUP:
+        *pass_id = command->u.set_bind_group.pass_id;
+        return true;
+    case DVZ_DRP2_COMMAND_DRAW:
+        *pass_id = command->u.draw.pass_id;
+        return true;
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED:
+        *pass_id = command->u.draw_indexed.pass_id;
+        return true;
+    case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
+        *pass_id = command->u.draw_indirect.pass_id;
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+
+/**
+ * Hash one pass-body command together with the backend objects it resolves to.
+ *
+ * Pass ids are excluded so that a fresh transient pass id every frame still matches.
+ *
+ * @param state vklite runtime state
+ * @param command pass-body command
+ * @param hash running hash
+ * @return whether every referenced object resolved
+ */
+static bool _bundle_hash_command(
+    Drp2VkliteState* state, const DvzDrp2Command* command, uint64_t* hash)
+{
+    ANN(state);
+    ANN(command);
+    ANN(hash);
+
+    Drp2VkliteObject* object = NULL;
+    _bundle_hash_u64(hash, (uint64_t)command->type);
+    switch (command->type)
+    {
+    case DVZ_DRP2_COMMAND_SET_PIPELINE:
+        object = _vklite_find(state, command->u.set_pipeline.pipeline_id);
+        if (object == NULL || object->graphics == NULL)
+            return false;
+        _bundle_hash_u64(hash, command->u.set_pipeline.pipeline_id);
+        _bundle_hash_ptr(hash, object->graphics);
+        return true;
+    case DVZ_DRP2_COMMAND_SET_VERTEX_BUFFER:
+        object = _vklite_find(state, command->u.set_vertex_buffer.buffer_id);
+        if (object == NULL || object->buffer == NULL)
+            return false;
+        _bundle_hash_u64(hash, command->u.set_vertex_buffer.slot);
+        _bundle_hash_u64(hash, command->u.set_vertex_buffer.buffer_id);
+        _bundle_hash_u64(hash, command->u.set_vertex_buffer.offset);
+        _bundle_hash_ptr(hash, object->buffer);
+        return true;
+    case DVZ_DRP2_COMMAND_SET_INDEX_BUFFER:
+        object = _vklite_find(state, command->u.set_index_buffer.buffer_id);
+        if (object == NULL || object->buffer == NULL)
+            return false;
+        _bundle_hash_u64(hash, command->u.set_index_buffer.buffer_id);
+        _bundle_hash_u64(hash, command->u.set_index_buffer.offset);
+        _bundle_hash(
+            hash, command->u.set_index_buffer.index_format,
+            strnlen(command->u.set_index_buffer.index_format, DVZ_DRP2_LABEL_SIZE));
+        _bundle_hash_ptr(hash, object->buffer);
+        return true;
+    case DVZ_DRP2_COMMAND_SET_VIEWPORT:
+        _bundle_hash(hash, command->u.set_viewport.viewport, sizeof(float) * 4);
+        return true;
+    case DVZ_DRP2_COMMAND_SET_SCISSOR:
+        _bundle_hash(hash, command->u.set_scissor.scissor, sizeof(float) * 4);
+        return true;
+    case DVZ_DRP2_COMMAND_SET_BIND_GROUP:
+        object = _vklite_find(state, command->u.set_bind_group.bind_group_id);
+        if (object == NULL || object->descriptors == NULL)
+            return false;
+        _bundle_hash_u64(hash, command->u.set_bind_group.slot);
+        _bundle_hash_u64(hash, command->u.set_bind_group.bind_group_id);
+        _bundle_hash_u64(hash, command->u.set_bind_group.dynamic_offset_count);
+        for (uint32_t i = 0; i < command->u.set_bind_group.dynamic_offset_count; i++)
+            _bundle_hash_u64(hash, command->u.set_bind_group.dynamic_offsets[i]);
+        _bundle_hash_ptr(hash, object->descriptors);
+        return true;
+    case DVZ_DRP2_COMMAND_DRAW:
+        _bundle_hash_u64(hash, command->u.draw.vertex_count);
+        _bundle_hash_u64(hash, command->u.draw.instance_count);
+        _bundle_hash_u64(hash, command->u.draw.first_vertex);
+        _bundle_hash_u64(hash, command->u.draw.first_instance);
+        return true;
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED:
+        _bundle_hash_u64(hash, command->u.draw_indexed.index_count);
+        _bundle_hash_u64(hash, command->u.draw_indexed.instance_count);
+        _bundle_hash_u64(hash, command->u.draw_indexed.first_index);
+        _bundle_hash_u64(hash, (uint64_t)(int64_t)command->u.draw_indexed.base_vertex);
+        _bundle_hash_u64(hash, command->u.draw_indexed.first_instance);
+        return true;
+    case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
+        object = _vklite_find(state, command->u.draw_indirect.buffer_id);
+        if (object == NULL || object->buffer == NULL)
+            return false;
+        _bundle_hash_u64(hash, command->u.draw_indirect.buffer_id);
+        _bundle_hash_u64(hash, command->u.draw_indirect.offset);
+        _bundle_hash_u64(hash, command->u.draw_indirect.draw_count);
+        _bundle_hash_u64(hash, command->u.draw_indirect.stride);
+        _bundle_hash_ptr(hash, object->buffer);
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+
+/**
+ * Compute the bundle key of a render pass body.
+ *
+ * @param state vklite runtime state
+ * @param stream DRP2 command stream
+ * @param command_index BeginRenderPass command index
+ * @param pass vklite render pass object
+ * @param inheritance attachment formats and sample count of the pass
+ * @param[out] key bundle key
+ * @param[out] end_index index of the matching EndRenderPass command
+ * @return whether the pass body can be cached
+ */
+static bool _bundle_key(
+    Drp2VkliteState* state, const DvzDrp2CommandStream* stream, uint32_t command_index,
+    const Drp2VkliteObject* pass, const VkCommandBufferInheritanceRenderingInfo* inheritance,
+    uint64_t* key, uint32_t* end_index)
+{
+    ANN(state);
+    ANN(stream);
+    ANN(pass);
+    ANN(inheritance);
+    ANN(key);
+    ANN(end_index);
+
+    uint64_t hash = DVZ_DRP2_PASS_BUNDLE_OFFSET;
+    _bundle_hash_u64(&hash, pass->width);
+    _bundle_hash_u64(&hash, pass->height);
+    _bundle_hash(&hash, &pass->viewport_x, sizeof(float));
+    _bundle_hash(&hash, &pass->viewport_y, sizeof(float));
+    _bundle_hash(&hash, &pass->viewport_width, sizeof(float));
+    _bundle_hash(&hash, &pass->viewport_height, sizeof(float));
+    _bundle_hash(&hash, &pass->scissor_x, sizeof(float));
+    _bundle_hash(&hash, &pass->scissor_y, sizeof(float));
+    _bundle_hash(&hash, &pass->scissor_width, sizeof(float));
+    _bundle_hash(&hash, &pass->scissor_height, sizeof(float));
+    _bundle_hash_u64(&hash, inheritance->colorAttachmentCount);
+    for (uint32_t i = 0; i < inheritance->colorAttachmentCount; i++)
+        _bundle_hash_u64(&hash, (uint64_t)inheritance->pColorAttachmentFormats[i]);
+    _bundle_hash_u64(&hash, (uint64_t)inheritance->depthAttachmentFormat);
+    _bundle_hash_u64(&hash, (uint64_t)inheritance->stencilAttachmentFormat);
+    _bundle_hash_u64(&hash, (uint64_t)inheritance->rasterizationSamples);
+
+    uint32_t draw_count = 0;
+    for (uint32_t i = command_index + 1; i < stream->count; i++)
+    {
+        const DvzDrp2Command* command = &stream->commands[i];
+        if (command->type == DVZ_DRP2_COMMAND_END_RENDER_PASS &&
+            command->u.end_render_pass.pass_id == pass->id)
+        {
+            *key = hash;
+            *end_index = i;
+            return draw_count > 0;
+        }
+
+        uint64_t pass_id = 0;
+        if (!_bundle_command_pass_id(command, &pass_id) || pass_id != pass->id)
+            return false;
+        if (!_bundle_hash_command(state, command, &hash))
+            return false;
+        if (command->type == DVZ_DRP2_COMMAND_DRAW ||
+            command->type == DVZ_DRP2_COMMAND_DRAW_INDEXED ||
+            command->type == DVZ_DRP2_COMMAND_DRAW_INDIRECT ||
+            command->type == DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT)
+            draw_count++;
+    }
+    return false;
+}
+
+
+
+/**
+ * Release a bundle's secondary command buffer once no in-flight primary uses it.
+ *
+ * @param state vklite runtime state
+ * @param bundle bundle to release
+ */
+static void _bundle_release(Drp2VkliteState* state, Drp2PassBundle* bundle)
+{
+    ANN(state);
+    ANN(bundle);
+    if (bundle->commands != NULL)
+    {
+        Drp2VkliteObject retired = {0};
+        retired.kind = DRP2_OBJECT_RENDER_PASS;
+        retired.commands = bundle->commands;
+        if (bundle->last_primary == VK_NULL_HANDLE ||
+            !_vklite_defer_destroy_object(state, &retired, bundle->last_primary))
+            _vklite_destroy_object(&retired);
+    }
+    dvz_memset(bundle, sizeof(Drp2PassBundle), 0, sizeof(Drp2PassBundle));
+}
+
+
+
+/**
+ * Drop stale bundles and return the live bundle matching a key.
+ *
+ * @param state vklite runtime state
+ * @param key bundle key
+ * @return matching bundle, or NULL
+ */
+static Drp2PassBundle* _bundle_find(Drp2VkliteState* state, uint64_t key)
+{
+    ANN(state);
+    Drp2PassBundle* found = NULL;
+    uint32_t i = 0;
+    while (i < state->bundle_count)
+    {
+        Drp2PassBundle* bundle = &state->bundles[i];
+        if (bundle->generation != state->bundle_generation ||
+            state->bundle_tick - bundle->last_used > DVZ_DRP2_PASS_BUNDLE_MAX_AGE)
+        {
+            _bundle_release(state, bundle);
+            state->bundles[i] = state->bundles[--state->bundle_count];
+            dvz_memset(
+                &state->bundles[state->bundle_count], sizeof(Drp2PassBundle), 0,
+                sizeof(Drp2PassBundle));
+            continue;
+        }
+        if (bundle->key == key)
+            found = bundle;
+        i++;
+    }
+    return found;
+}
+
+
+
+/**
+ * Add a candidate bundle entry, evicting the least recently used entry when full.
+ *
+ * @param state vklite runtime state
+ * @param key bundle key
+ * @return new bundle entry, or NULL on allocation failure
+ */
+static Drp2PassBundle* _bundle_add(Drp2VkliteState* state, uint64_t key)
+{
+    ANN(state);
+    if (state->bundles == NULL)
+    {
+        state->bundles = (Drp2PassBundle*)dvz_calloc(
+            DVZ_DRP2_PASS_BUNDLE_CAPACITY, sizeof(Drp2PassBundle));
+        if (state->bundles == NULL)
+            return NULL;
+        state->bundle_capacity = DVZ_DRP2_PASS_BUNDLE_CAPACITY;
+    }
+
+    Drp2PassBundle* bundle = NULL;
+    if (state->bundle_count < state->bundle_capacity)
+    {
+        bundle = &state->bundles[state->bundle_count++];
+    }
+    else
+    {
+        bundle = &state->bundles[0];
+        for (uint32_t i = 1; i < state->bundle_count; i++)
+        {
+            if (state->bundles[i].last_used < bundle->last_used)
+                bundle = &state->bundles[i];
+        }
+        _bundle_release(state, bundle);
+    }
+    bundle->key = key;
+    bundle->generation = state->bundle_generation;
+    bundle->last_used = state->bundle_tick;
+    return bundle;
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Invalidate every recorded pass bundle.
+ *
+ * @param state vklite runtime state
+ */
+void _vklite_pass_bundles_invalidate(Drp2VkliteState* state)
+{
+    ANN(state);
+    state->bundle_generation++;
+}
+
+
+
+/**
+ * Invalidate recorded pass bundles when a retired object owns resources a bundle may reference.
+ *
+ * @param state vklite runtime state
+ * @param object vklite object being destroyed or deferred for destruction
+ */
+void _vklite_pass_bundles_note_retired(Drp2VkliteState* state, const Drp2VkliteObject* object)
+{
+    ANN(state);
+    if (object == NULL || object->destroyed)
+        return;
+    if (object->buffer != NULL || object->graphics != NULL || object->descriptors != NULL ||
+        object->sampler != NULL || object->views != NULL)
+        _vklite_pass_bundles_invalidate(state);
+}
+
+
+
+/**
+ * Forget an owned primary command buffer once it completed, before it is freed.
+ *
+ * Bundles executed from it no longer need to defer their release on it; objects already deferred
+ * on it are destroyed.
+ *
+ * @param state vklite runtime state
+ * @param primary completed owned primary command buffer
+ */
+void _vklite_pass_bundles_note_primary_done(Drp2VkliteState* state, VkCommandBuffer primary)
+{
+    ANN(state);
+    if (primary == VK_NULL_HANDLE)
+        return;
+    for (uint32_t i = 0; i < state->bundle_count; i++)
+    {
+        if (state->bundles[i].last_primary == primary)
+            state->bundles[i].last_primary = VK_NULL_HANDLE;
+    }
+    _vklite_flush_deferred_for_command_buffer(state, primary);
+}
+
+
+
+/**
+ * Destroy every pass bundle.
+ *
+ * @param state vklite runtime state
+ */
+void _vklite_pass_bundles_cleanup(Drp2VkliteState* state)
+{
+    if (state == NULL)
+        return;
+    for (uint32_t i = 0; i < state->bundle_count; i++)
+    {
+        Drp2VkliteObject retired = {0};
+        retired.kind = DRP2_OBJECT_RENDER_PASS;
+        retired.commands = state->bundles[i].commands;
+        _vklite_destroy_object(&retired);
+    }
+    dvz_free(state->bundles);
+    state->bundles = NULL;
+    state->bundle_capacity = 0;
+    state->bundle_count = 0;
+}
+
+
+
+/**
+ * Begin the dynamic rendering of a render pass, recording or replaying its pass bundle.
+ *
+ * On a replay the pass body is executed from the cached secondary command buffer and
+ * `pass->bundle_replayed` is set so the caller skips the body commands. When recording,
+ * `pass->commands` points to a fresh secondary command buffer until _vklite_pass_bundle_end().
+ *
+ * @param state vklite runtime state
+ * @param stream DRP2 command stream
+ * @param command_index BeginRenderPass command index
+ * @param pass vklite render pass object with its primary commands and rendering
+ * @param inheritance attachment formats and sample count of the pass
+ * @return DRP2 validation result
+ */
+DvzDrp2ValidationResult _vklite_pass_bundle_begin(
+    Drp2VkliteState* state, const DvzDrp2CommandStream* stream, uint32_t command_index,
+    Drp2VkliteObject* pass, const VkCommandBufferInheritanceRenderingInfo* inheritance)
+{
+    ANN(state);
+    ANN(stream);
+    ANN(pass);
+    ANN(pass->commands);
+    ANN(pass->rendering);
+    ANN(inheritance);
+
+    uint64_t key = 0;
+    uint32_t end_index = 0;
+    Drp2PassBundle* bundle = NULL;
+    if (_bundle_key(state, stream, command_index, pass, inheritance, &key, &end_index))
+    {
+        bundle = _bundle_find(state, key);
+        if (bundle == NULL)
+            (void)_bundle_add(state, key);
+    }
+    if (bundle == NULL)
+    {
+        dvz_cmd_rendering_begin(pass->commands, pass->rendering);
+        return _drp2_ok();
+    }
+
+    bundle->last_used = state->bundle_tick;
+    dvz_rendering_flags(pass->rendering, VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT);
+    if (bundle->commands != NULL)
+    {
+        dvz_cmd_rendering_begin(pass->commands, pass->rendering);
+        dvz_cmd_execute_commands(pass->commands, bundle->commands);
+        bundle->last_primary = dvz_commands_handle(pass->commands);
+        pass->bundle_replayed = true;
+        pass->bundle_end_index = end_index;
+        state->bundle_replays++;
+        return _drp2_ok();
+    }
+
+    DvzQueue* queue = dvz_device_queue(state->runtime->device, DVZ_QUEUE_MAIN);
+    DvzCommands* secondary = queue != NULL ? dvz_commands_create_wrapper() : NULL;
+    if (secondary != NULL)
+        dvz_commands_secondary(state->runtime->device, queue, 1, secondary);
+    if (secondary == NULL || dvz_commands_count(secondary) == 0 ||
+        dvz_cmd_begin_rendering_secondary_result(secondary, inheritance) != 0)
+    {
+        log_warn("falling back to direct recording of DRP2 render pass %" PRIu64, pass->id);
+        if (secondary != NULL)
+            _vklite_owned_commands_destroy(secondary);
+        dvz_rendering_flags(pass->rendering, 0);
+        dvz_cmd_rendering_begin(pass->commands, pass->rendering);
+        return _drp2_ok();
+    }
+
+    dvz_cmd_rendering_begin(pass->commands, pass->rendering);
+    pass->primary_commands = pass->commands;
+    pass->commands = secondary;
+    pass->bundle_key = key;
+    return _drp2_ok();
+}
+
+
+
+/**
+ * Finish recording a pass bundle and execute it from the pass primary command buffer.
+ *
+ * @param state vklite runtime state
+ * @param pass vklite render pass object
+ * @param command_index EndRenderPass command index
+ * @return DRP2 validation result
+ */
+DvzDrp2ValidationResult
+_vklite_pass_bundle_end(Drp2VkliteState* state, Drp2VkliteObject* pass, uint32_t command_index)
+{
+    ANN(state);
+    ANN(pass);
+    if (pass->primary_commands == NULL)
+        return _drp2_ok();
+
+    DvzCommands* secondary = pass->commands;
+    pass->commands = pass->primary_commands;
+    pass->primary_commands = NULL;
+    if (dvz_cmd_end_result(secondary) != 0)
+    {
+        _vklite_owned_commands_destroy(secondary);
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    }
+    dvz_cmd_execute_commands(pass->commands, secondary);
+
+    Drp2PassBundle* bundle = _bundle_find(state, pass->bundle_key);
+    if (bundle == NULL)
+        bundle = _bundle_add(state, pass->bundle_key);
+    if (bundle == NULL)
+    {
+        Drp2PassBundle orphan = {0};
+        orphan.commands = secondary;
+        orphan.last_primary = dvz_commands_handle(pass->commands);
+        _bundle_release(state, &orphan);
+        return _drp2_ok();
+    }
+    if (bundle->commands != NULL)
+        _bundle_release(state, bundle);
+    bundle->key = pass->bundle_key;
+    bundle->generation = state->bundle_generation;
+    bundle->last_used = state->bundle_tick;
+    bundle->commands = secondary;
+    bundle->last_primary = dvz_commands_handle(pass->commands);
+    return _drp2_ok();
+}
+
+
+
+/**
+ * Return the command index the backend loop resumes from after a BeginRenderPass command.
+ *
+ * @param state vklite runtime state
+ * @param command BeginRenderPass command
+ * @param command_index BeginRenderPass command index
+ * @return index preceding the matching EndRenderPass when the pass replayed a bundle, otherwise
+ * `command_index`
+ */
+uint32_t _vklite_pass_bundle_resume_index(
+    Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index)
+{
+    ANN(state);
+    ANN(command);
+    Drp2VkliteObject* pass = _vklite_find(state, command->u.begin_render_pass.id);
+    if (pass == NULL || !pass->bundle_replayed || pass->bundle_end_index <= command_index)
+        return command_index;
+    return pass->bundle_end_index - 1;
+}
+#endif
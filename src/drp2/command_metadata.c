@@ -27,7 +27,7 @@
 /*************************************************************************************************/
 
 #define DVZ_DRP2_COMMAND_METADATA_COUNT                                                        \
-    ((size_t)DVZ_DRP2_COMMAND_QUEUE_SUBMIT_REPLY + (size_t)1)
+    ((size_t)DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT + (size_t)1)
 #define DVZ_DRP2_COMMAND_BODY_SIZE(name) sizeof(((DvzDrp2Command*)0)->u.name)
 
 
@@ -166,6 +166,15 @@ static const DvzDrp2CommandMetadata _command_metadata[DVZ_DRP2_COMMAND_METADATA_
     [DVZ_DRP2_COMMAND_QUEUE_SUBMIT_REPLY] = {DVZ_DRP2_COMMAND_QUEUE_SUBMIT_REPLY,
                                              "QueueSubmitReply", DVZ_DRP2_PACKET_FRAME,
                                              DVZ_DRP2_COMMAND_BODY_SIZE(queue_submit)},
+    [DVZ_DRP2_COMMAND_DRAW_INDIRECT] = {DVZ_DRP2_COMMAND_DRAW_INDIRECT, "DrawIndirect",
+                                        DVZ_DRP2_PACKET_FRAME,
+                                        DVZ_DRP2_COMMAND_BODY_SIZE(draw_indirect)},
+    [DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT] = {
+        DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT, "DrawIndexedIndirect", DVZ_DRP2_PACKET_FRAME,
+        DVZ_DRP2_COMMAND_BODY_SIZE(draw_indirect)},
+    [DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT] = {
+        DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT, "DispatchWorkgroupsIndirect",
+        DVZ_DRP2_PACKET_FRAME, DVZ_DRP2_COMMAND_BODY_SIZE(dispatch_workgroups_indirect)},
 };
 
 
@@ -85,6 +85,28 @@ static void _vklite_trim_destroyed_tail(Drp2VkliteState* state)
 
 
 
+/**
+ * Drop the descriptor bookkeeping of an object that leaves the live table.
+ *
+ * Bind groups leave the resource reverse index. Bind-group layouts release their descriptor pool
+ * chain while their set layouts are still alive; sets of this layout that are still in flight
+ * keep their pools until they are freed.
+ *
+ * @param state vklite runtime state
+ * @param object vklite object slot that is destroyed or deferred
+ */
+static void _vklite_forget_descriptors(Drp2VkliteState* state, const Drp2VkliteObject* object)
+{
+    ANN(state);
+    ANN(object);
+    if (object->kind == DRP2_OBJECT_BIND_GROUP)
+        _vklite_bind_refs_remove(state, object);
+    else if (object->kind == DRP2_OBJECT_BIND_GROUP_LAYOUT && !object->borrowed_slots)
+        dvz_descriptor_allocator_release(state->descriptor_allocator, object->slots);
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -200,6 +222,12 @@ void _vklite_destroy_object(Drp2VkliteObject* object)
         }
         object->buffer = NULL;
     }
+    if (object->primary_commands != NULL)
+    {
+        _vklite_owned_commands_destroy(object->commands);
+        object->commands = object->primary_commands;
+        object->primary_commands = NULL;
+    }
     if (object->commands != NULL)
     {
         if (!object->borrowed_commands)
@@ -283,6 +311,12 @@ void _vklite_destroy_object(Drp2VkliteObject* object)
         dvz_shader_free(object->shader);
         object->shader = NULL;
     }
+    if (object->evicted_copy != NULL)
+    {
+        dvz_buffer_destroy(object->evicted_copy);
+        dvz_buffer_free(object->evicted_copy);
+        object->evicted_copy = NULL;
+    }
     object->destroyed = true;
 }
 
@@ -296,6 +330,13 @@ void _vklite_destroy_object(Drp2VkliteObject* object)
 void _vklite_destroy_object_slot(Drp2VkliteState* state, Drp2VkliteObject* object)
 {
     ANN(state);
+    ANN(object);
+    _vklite_transfer_wait(state, object->transfer_value);
+    _vklite_pass_bundles_note_retired(state, object);
+    _vklite_forget_descriptors(state, object);
+    _vklite_budget_forget(state, object);
+    if (object->evicted_copy != NULL)
+        state->evicted_count--;
     _vklite_destroy_object(object);
     _vklite_trim_destroyed_tail(state);
 }
@@ -330,6 +371,8 @@ void _vklite_state_cleanup(Drp2VkliteState* state)
 {
     if (state == NULL)
         return;
+    _vklite_transfer_cleanup(state);
+    _vklite_pass_bundles_cleanup(state);
     for (uint32_t i = state->deferred_count; i > 0; i--)
         _vklite_destroy_object(&state->deferred[i - 1].object);
     dvz_free(state->deferred);
@@ -345,6 +388,11 @@ void _vklite_state_cleanup(Drp2VkliteState* state)
     state->objects = NULL;
     state->capacity = 0;
     state->count = 0;
+    state->lru_head = 0;
+    state->lru_tail = 0;
+    _vklite_bind_refs_cleanup(state);
+    dvz_descriptor_allocator_destroy(state->descriptor_allocator);
+    state->descriptor_allocator = NULL;
     state->runtime = NULL;
 }
 
@@ -368,6 +416,11 @@ bool _vklite_defer_destroy_object(
         return false;
     if (!_vklite_deferred_ensure_capacity(state))
         return false;
+    _vklite_pass_bundles_note_retired(state, object);
+    _vklite_forget_descriptors(state, object);
+    _vklite_budget_forget(state, object);
+    if (object->evicted_copy != NULL)
+        state->evicted_count--;
 
     Drp2DeferredDestroy* deferred = &state->deferred[state->deferred_count++];
     deferred->command_buffer = command_buffer;
@@ -400,6 +453,7 @@ void _vklite_flush_deferred_for_command_buffer(
         Drp2DeferredDestroy* deferred = &state->deferred[i];
         if (deferred->command_buffer == command_buffer)
         {
+            _vklite_transfer_wait(state, deferred->object.transfer_value);
             _vklite_destroy_object(&deferred->object);
             dvz_memset(deferred, sizeof(Drp2DeferredDestroy), 0, sizeof(Drp2DeferredDestroy));
             continue;
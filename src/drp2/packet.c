@@ -530,6 +530,136 @@ bool dvz_drp2_packet_encode_stream_phase(
 }
 
 
+static uint64_t _fingerprint_bytes(uint64_t hash, const void* data, uint64_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (uint64_t i = 0; i < size; i++)
+    {
+        hash ^= (uint64_t)bytes[i];
+        hash *= DVZ_DRP2_FINGERPRINT_PRIME;
+    }
+    return hash;
+}
+
+
+
+static uint64_t _fingerprint_u64(uint64_t hash, uint64_t value)
+{
+    uint8_t bytes[8] = {0};
+    _put_u64(bytes, value);
+    return _fingerprint_bytes(hash, bytes, sizeof(bytes));
+}
+
+
+
+static const char* _base64_payload(const DvzDrp2Command* command)
+{
+    ANN(command);
+    if (command->type == DVZ_DRP2_COMMAND_WRITE_BUFFER)
+        return command->u.write_buffer.data_base64;
+    if (command->type == DVZ_DRP2_COMMAND_WRITE_TEXTURE)
+        return command->u.write_texture.data_base64;
+    return NULL;
+}
+
+
+
+static uint64_t _fingerprint_record(uint64_t hash, const DvzDrp2Command* command)
+{
+    ANN(command);
+    const uint64_t body_size = _fixed_body_size(command->type);
+    hash = _fingerprint_u64(hash, (uint64_t)command->type);
+    if (body_size > 0)
+    {
+        uint8_t scratch[sizeof(PacketShaderBody)] = {0};
+        hash = _fingerprint_bytes(hash, _body_ptr(command, scratch), body_size);
+    }
+    return hash;
+}
+
+
+
+static const void* _fingerprint_payload(const DvzDrp2Command* command, uint64_t* size)
+{
+    ANN(command);
+    ANN(size);
+    const void* payload_ptr = NULL;
+    if (_payload_info(command, &payload_ptr, size))
+        return payload_ptr;
+    const char* base64 = _base64_payload(command);
+    *size = base64 != NULL ? (uint64_t)strlen(base64) : 0;
+    return base64;
+}
+
+
+
+static uint64_t _payload_version(const DvzDrp2Command* command)
+{
+    ANN(command);
+    if (command->type == DVZ_DRP2_COMMAND_WRITE_BUFFER)
+        return command->u.write_buffer.payload_version;
+    if (command->type == DVZ_DRP2_COMMAND_WRITE_TEXTURE)
+        return command->u.write_texture.payload_version;
+    return 0;
+}
+
+
+
+/**
+ * Fold one command into an incremental stream fingerprint.
+ */
+uint64_t
+_dvz_drp2_fingerprint_command(uint64_t hash, const DvzDrp2Command* command, bool* unversioned)
+{
+    ANN(command);
+    ANN(unversioned);
+    hash = _fingerprint_record(hash, command);
+
+    const uint64_t version = _payload_version(command);
+    if (version != 0)
+        return _fingerprint_u64(hash, version);
+    uint64_t payload_size = 0;
+    const void* payload = _fingerprint_payload(command, &payload_size);
+    if (payload == NULL)
+        return hash;
+    hash = _fingerprint_u64(hash, payload_size);
+    if (payload_size > DVZ_DRP2_FINGERPRINT_INLINE_PAYLOAD)
+    {
+        *unversioned = true;
+        return hash;
+    }
+    return _fingerprint_bytes(hash, payload, payload_size);
+}
+
+
+
+/**
+ * Hash a command stream over its packet records and payload bytes.
+ */
+uint64_t dvz_drp2_packet_fingerprint(const DvzDrp2CommandStream* stream)
+{
+    uint64_t hash = DVZ_DRP2_FINGERPRINT_OFFSET;
+    if (stream == NULL)
+        return hash;
+
+    hash = _fingerprint_u64(hash, stream->count);
+    for (uint32_t i = 0; i < stream->count; i++)
+    {
+        const DvzDrp2Command* command = &stream->commands[i];
+        hash = _fingerprint_record(hash, command);
+        uint64_t payload_size = 0;
+        const void* payload = _fingerprint_payload(command, &payload_size);
+        if (payload != NULL)
+        {
+            hash = _fingerprint_u64(hash, payload_size);
+            hash = _fingerprint_bytes(hash, payload, payload_size);
+        }
+    }
+    return hash;
+}
+
+
+
 /**
  * Decode a binary packet plus payload arena into a command stream.
  */
@@ -23,6 +23,7 @@
 #include "_assertions.h"
 #include "_runtime.h"
 #include "_stream.h"
+#include "datoviz/vk/device.h"
 #include "datoviz/vklite/sync.h"
 
 
@@ -309,6 +310,27 @@ static bool _vklite_pass_format_has_depth(uint32_t format)
 
 
 
+/**
+ * Return whether a Vulkan format carries a stencil aspect.
+ *
+ * @param format backend-native texture format enum value
+ * @return whether the format is a depth-stencil format
+ */
+static bool _vklite_pass_format_has_stencil(uint32_t format)
+{
+    switch ((VkFormat)format)
+    {
+    case VK_FORMAT_D16_UNORM_S8_UINT:
+    case VK_FORMAT_D24_UNORM_S8_UINT:
+    case VK_FORMAT_D32_SFLOAT_S8_UINT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+
 /**
  * Find the layout entry that declares one bind-group binding's access.
  *
@@ -936,6 +958,12 @@ DvzDrp2ValidationResult _vklite_begin_render_pass(
                 datt,
                 (VkClearValue){.depthStencil = {command->u.begin_render_pass.clear_depth, 0}});
         }
+        if (named_depth != NULL && _vklite_pass_format_has_stencil(named_depth->format))
+        {
+            // A depth-stencil texture is bound as the stencil attachment with the same ops.
+            DvzAttachment* satt = dvz_rendering_stencil(rendering);
+            *satt = *datt;
+        }
     }
 
     if (!pass->borrowed_commands && dvz_cmd_begin_result(cmds) != 0)
@@ -1011,8 +1039,22 @@ DvzDrp2ValidationResult _vklite_begin_render_pass(
          transient_depth_owner->depth_image != VK_NULL_HANDLE))
         _transition_depth_image_access(
             cmds, transient_depth_owner, _depth_texture_access(depth_transition_access));
-    dvz_cmd_rendering_begin(cmds, rendering);
-    return _drp2_ok();
+
+    VkFormat color_formats[DVZ_DRP2_MAX_COLOR_ATTACHMENTS] = {0};
+    for (uint32_t i = 0; i < color_count; i++)
+        color_formats[i] = (VkFormat)targets[i]->format;
+    VkCommandBufferInheritanceRenderingInfo inheritance = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+        .colorAttachmentCount = color_count,
+        .pColorAttachmentFormats = color_formats,
+        .rasterizationSamples = _vklite_sample_count(target->sample_count),
+    };
+    if (command->u.begin_render_pass.has_depth_attachment)
+        inheritance.depthAttachmentFormat =
+            named_depth != NULL ? (VkFormat)named_depth->format : VK_FORMAT_D32_SFLOAT;
+    if (named_depth != NULL && _vklite_pass_format_has_stencil(named_depth->format))
+        inheritance.stencilAttachmentFormat = (VkFormat)named_depth->format;
+    return _vklite_pass_bundle_begin(state, stream, command_index, pass, &inheritance);
 }
 
 
@@ -1246,6 +1288,52 @@ DvzDrp2ValidationResult _vklite_set_scissor(
 }
 
 
+/**
+ * Reorder SetBindGroup dynamic offsets from layout-entry order to Vulkan binding order.
+ *
+ * @param state vklite runtime state
+ * @param bind_group bound bind-group object
+ * @param command DRP2 SetBindGroup command
+ * @param out output offsets, one per dynamic binding
+ */
+static void _vklite_dynamic_offsets(
+    Drp2VkliteState* state, const Drp2VkliteObject* bind_group, const DvzDrp2Command* command,
+    uint32_t* out)
+{
+    ANN(state);
+    ANN(bind_group);
+    ANN(command);
+    ANN(out);
+    uint32_t count = command->u.set_bind_group.dynamic_offset_count;
+    Drp2VkliteObject* layout = _vklite_find(state, bind_group->bind_group_layout_id);
+    if (count == 0 || layout == NULL)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            out[i] = (uint32_t)command->u.set_bind_group.dynamic_offsets[i];
+        return;
+    }
+
+    // Vulkan consumes dynamic offsets by increasing binding number, DRP2 by layout entry.
+    uint32_t dynamic_index = 0;
+    for (uint32_t i = 0; i < layout->layout_entry_count && dynamic_index < count; i++)
+    {
+        const DvzDrp2BindGroupLayoutEntry* entry = &layout->layout_entries[i];
+        if (!entry->has_dynamic_offset)
+            continue;
+        uint32_t rank = 0;
+        for (uint32_t j = 0; j < layout->layout_entry_count; j++)
+        {
+            if (layout->layout_entries[j].has_dynamic_offset &&
+                layout->layout_entries[j].binding < entry->binding)
+                rank++;
+        }
+        if (rank < count)
+            out[rank] = (uint32_t)command->u.set_bind_group.dynamic_offsets[dynamic_index];
+        dynamic_index++;
+    }
+}
+
+
 /**
  * Bind a vklite descriptor set within a DRP2 render or compute pass.
  *
@@ -1283,12 +1371,11 @@ DvzDrp2ValidationResult _vklite_set_bind_group(
             return transition_result;
     }
 
+    uint32_t dynamic_offsets[DVZ_DRP2_MAX_BINDINGS] = {0};
+    _vklite_dynamic_offsets(state, bind_group, command, dynamic_offsets);
     if (pipeline->combined_pipeline_layout != VK_NULL_HANDLE)
     {
         VkDescriptorSet descriptor_set = dvz_descriptors_handle(bind_group->descriptors, 0);
-        uint32_t dynamic_offsets[DVZ_DRP2_MAX_BINDINGS] = {0};
-        for (uint32_t i = 0; i < command->u.set_bind_group.dynamic_offset_count; i++)
-            dynamic_offsets[i] = (uint32_t)command->u.set_bind_group.dynamic_offsets[i];
         vkCmdBindDescriptorSets(
             dvz_commands_handle(pass->commands), bind_point, pipeline->combined_pipeline_layout,
             command->u.set_bind_group.slot, 1, &descriptor_set,
@@ -1296,9 +1383,6 @@ DvzDrp2ValidationResult _vklite_set_bind_group(
     }
     else
     {
-        uint32_t dynamic_offsets[DVZ_DRP2_MAX_BINDINGS] = {0};
-        for (uint32_t i = 0; i < command->u.set_bind_group.dynamic_offset_count; i++)
-            dynamic_offsets[i] = (uint32_t)command->u.set_bind_group.dynamic_offsets[i];
         dvz_cmd_bind_descriptors(
             pass->commands, bind_point, bind_group->descriptors, command->u.set_bind_group.slot, 1,
             command->u.set_bind_group.dynamic_offset_count, dynamic_offsets);
@@ -1379,6 +1463,105 @@ DvzDrp2ValidationResult _vklite_dispatch_workgroups(
 }
 
 
+/**
+ * Return how many indirect records one draw call may consume on the runtime device.
+ *
+ * @param state vklite runtime state
+ * @return 1 without the `multiDrawIndirect` feature, `maxDrawIndirectCount` otherwise
+ */
+static uint32_t _vklite_max_draw_indirect_count(Drp2VkliteState* state)
+{
+    ANN(state);
+    if (state->max_draw_indirect_count == 0)
+    {
+        DvzDevice* device = state->runtime->device;
+        uint32_t limit = 1;
+        if (dvz_device_features10(device)->multiDrawIndirect)
+        {
+            VkPhysicalDeviceProperties props = {0};
+            vkGetPhysicalDeviceProperties(dvz_device_physical_device(device), &props);
+            limit = props.limits.maxDrawIndirectCount;
+        }
+        state->max_draw_indirect_count = limit > 0 ? limit : 1;
+    }
+    return state->max_draw_indirect_count;
+}
+
+
+/**
+ * Record an indirect or multi-draw-indirect draw within a vklite render pass.
+ *
+ * Devices without the `multiDrawIndirect` feature replay the records one draw at a time; batches
+ * above `maxDrawIndirectCount` are split into several draw calls.
+ *
+ * @param state vklite runtime state
+ * @param command DRP2 DrawIndirect or DrawIndexedIndirect command
+ * @param command_index command index used for validation reporting
+ * @return DRP2 validation result
+ */
+DvzDrp2ValidationResult _vklite_draw_indirect(
+    Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index)
+{
+    ANN(state);
+    ANN(command);
+    Drp2VkliteObject* pass = _vklite_find(state, command->u.draw_indirect.pass_id);
+    if (pass == NULL || pass->kind != DRP2_OBJECT_RENDER_PASS || pass->commands == NULL)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    Drp2VkliteObject* buffer = _vklite_find(state, command->u.draw_indirect.buffer_id);
+    if (buffer == NULL || buffer->kind != DRP2_OBJECT_BUFFER || buffer->buffer == NULL)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+
+    bool indexed = command->type == DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT;
+    VkBuffer handle = dvz_buffer_handle(buffer->buffer);
+    DvzSize offset = command->u.draw_indirect.offset;
+    uint32_t draw_count = command->u.draw_indirect.draw_count;
+    DvzSize stride = command->u.draw_indirect.stride;
+    if (stride == 0)
+        stride =
+            indexed ? DVZ_DRP2_DRAW_INDEXED_INDIRECT_ARGS_SIZE : DVZ_DRP2_DRAW_INDIRECT_ARGS_SIZE;
+
+    uint32_t limit = draw_count > 1 ? _vklite_max_draw_indirect_count(state) : 1;
+    for (uint32_t i = 0; i < draw_count; i += limit)
+    {
+        uint32_t batch = draw_count - i < limit ? draw_count - i : limit;
+        DvzSize record_offset = offset + (DvzSize)i * stride;
+        if (indexed)
+            dvz_cmd_draw_indexed_indirect(pass->commands, handle, record_offset, batch, stride);
+        else
+            dvz_cmd_draw_indirect(pass->commands, handle, record_offset, batch, stride);
+    }
+    return _drp2_ok();
+}
+
+
+/**
+ * Record an indirect compute dispatch within a vklite compute pass.
+ *
+ * @param state vklite runtime state
+ * @param command DRP2 DispatchWorkgroupsIndirect command
+ * @param command_index command index used for validation reporting
+ * @return DRP2 validation result
+ */
+DvzDrp2ValidationResult _vklite_dispatch_workgroups_indirect(
+    Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index)
+{
+    ANN(state);
+    ANN(command);
+    Drp2VkliteObject* pass = _vklite_find(state, command->u.dispatch_workgroups_indirect.pass_id);
+    if (pass == NULL || pass->kind != DRP2_OBJECT_COMPUTE_PASS || pass->commands == NULL)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    Drp2VkliteObject* buffer =
+        _vklite_find(state, command->u.dispatch_workgroups_indirect.buffer_id);
+    if (buffer == NULL || buffer->kind != DRP2_OBJECT_BUFFER || buffer->buffer == NULL)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+
+    dvz_cmd_dispatch_indirect(
+        pass->commands, dvz_buffer_handle(buffer->buffer),
+        command->u.dispatch_workgroups_indirect.offset);
+    return _drp2_ok();
+}
+
+
 /**
  * Record and submit a buffer resource barrier in an owned vklite command buffer.
  *
@@ -1410,6 +1593,12 @@ DvzDrp2ValidationResult _vklite_resource_barrier(
         dst_stage = VK_PIPELINE_STAGE_2_COPY_BIT;
         dst_access = VK_ACCESS_2_TRANSFER_READ_BIT;
     }
+    else if (strcmp(command->u.resource_barrier.dst_stage, "DRAW_INDIRECT") == 0 &&
+             strcmp(command->u.resource_barrier.dst_access, "INDIRECT_READ") == 0)
+    {
+        dst_stage = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+        dst_access = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+    }
     else
     {
         return _drp2_fail(DVZ_DRP2_VALIDATION_USAGE, command_index);
@@ -1508,9 +1697,20 @@ _vklite_end_render_pass(Drp2VkliteState* state, uint64_t pass_id, uint32_t comma
     if (pass == NULL || pass->kind != DRP2_OBJECT_RENDER_PASS || pass->commands == NULL)
         return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
 
+    DvzDrp2ValidationResult bundle_result = _vklite_pass_bundle_end(state, pass, command_index);
+    // An owned primary is freed with the pass, after its blocking submission or unsubmitted.
+    VkCommandBuffer owned_primary =
+        pass->borrowed_commands ? VK_NULL_HANDLE : dvz_commands_handle(pass->commands);
+    if (!bundle_result.ok)
+    {
+        _vklite_pass_bundles_note_primary_done(state, owned_primary);
+        _vklite_destroy_object_slot(state, pass);
+        return bundle_result;
+    }
     dvz_cmd_rendering_end(pass->commands);
     if (!_vklite_resolve_deferred_color_regions(state, pass))
     {
+        _vklite_pass_bundles_note_primary_done(state, owned_primary);
         _vklite_destroy_object_slot(state, pass);
         return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
     }
@@ -1518,6 +1718,7 @@ _vklite_end_render_pass(Drp2VkliteState* state, uint64_t pass_id, uint32_t comma
     {
         DvzDrp2ValidationResult result =
             _vklite_owned_commands_end_submit(pass->commands, command_index);
+        _vklite_pass_bundles_note_primary_done(state, owned_primary);
         if (!result.ok)
         {
             _vklite_destroy_object_slot(state, pass);
@@ -68,14 +68,17 @@ static bool _vklite_pipeline_format_has_depth(uint32_t format)
 
 
 
-static VkDescriptorType _vklite_descriptor_type(DvzDrp2BindingType type)
+static VkDescriptorType _vklite_descriptor_type(const DvzDrp2BindGroupLayoutEntry* entry)
 {
-    switch (type)
+    ANN(entry);
+    switch (entry->binding_type)
     {
     case DVZ_DRP2_BINDING_TYPE_UNIFORM_BUFFER:
-        return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        return entry->has_dynamic_offset ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC
+                                         : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     case DVZ_DRP2_BINDING_TYPE_STORAGE_BUFFER:
-        return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        return entry->has_dynamic_offset ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC
+                                         : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
     case DVZ_DRP2_BINDING_TYPE_SAMPLED_TEXTURE:
         return VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
     case DVZ_DRP2_BINDING_TYPE_STORAGE_TEXTURE:
@@ -357,7 +360,7 @@ DvzDrp2ValidationResult _vklite_create_bind_group_layout(
     {
         const DvzDrp2BindGroupLayoutEntry* entry =
             &command->u.create_bind_group_layout.entries[i];
-        VkDescriptorType type = _vklite_descriptor_type(entry->binding_type);
+        VkDescriptorType type = _vklite_descriptor_type(entry);
         if (type == VK_DESCRIPTOR_TYPE_MAX_ENUM)
             return _vklite_fail_destroy_object(
                 object, DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
@@ -392,10 +395,23 @@ DvzDrp2ValidationResult _vklite_build_bind_group_descriptors(
     if (layout == NULL || layout->kind != DRP2_OBJECT_BIND_GROUP_LAYOUT || layout->slots == NULL)
         return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
 
+    if (state->descriptor_allocator == NULL)
+    {
+        ANN(state->runtime);
+        state->descriptor_allocator = dvz_descriptor_allocator(state->runtime->device);
+        if (state->descriptor_allocator == NULL)
+            return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    }
+
+    // Retired sets come back through the deferred flush, once their frame has completed.
     DvzDescriptors* descriptors = dvz_descriptors_create_wrapper();
     if (descriptors == NULL)
         return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
-    dvz_descriptors(layout->slots, descriptors);
+    if (dvz_descriptors_pooled(state->descriptor_allocator, layout->slots, descriptors) != 0)
+    {
+        dvz_descriptors_free(descriptors);
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    }
 
     for (uint32_t i = 0; i < bind_group->bind_group_entry_count; i++)
     {
@@ -454,21 +470,96 @@ DvzDrp2ValidationResult _vklite_build_bind_group_descriptors(
 
 
 /**
- * Return whether a bind group references a backend resource id.
+ * Return the first reverse-index slot probed for a resource id.
+ *
+ * @param state vklite runtime state with a non-empty index
+ * @param resource_id backend resource id
+ * @return slot index
+ */
+static uint32_t _vklite_bind_ref_home(const Drp2VkliteState* state, uint64_t resource_id)
+{
+    ANN(state);
+    ASSERT(state->bind_ref_capacity > 0);
+    uint64_t hash = resource_id * 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(hash >> 32) & (state->bind_ref_capacity - 1);
+}
+
+
+
+/**
+ * Store one resource -> bind group pair in a reverse index with a free slot.
+ *
+ * @param state vklite runtime state
+ * @param resource_id backend resource id
+ * @param bind_group_id dependent bind-group id
+ */
+static void
+_vklite_bind_ref_insert(Drp2VkliteState* state, uint64_t resource_id, uint64_t bind_group_id)
+{
+    ANN(state);
+    const uint32_t mask = state->bind_ref_capacity - 1;
+    for (uint32_t i = _vklite_bind_ref_home(state, resource_id);; i = (i + 1) & mask)
+    {
+        Drp2BindGroupRef* ref = &state->bind_refs[i];
+        if (ref->resource_id != 0)
+            continue;
+        if (ref->tombstone)
+            state->bind_ref_tombstones--;
+        ref->resource_id = resource_id;
+        ref->bind_group_id = bind_group_id;
+        ref->tombstone = false;
+        state->bind_ref_count++;
+        return;
+    }
+}
+
+
+
+/**
+ * Rebuild the reverse index with a new capacity, dropping tombstones.
+ *
+ * @param state vklite runtime state
+ * @param capacity new power-of-two capacity
+ * @return whether the index was rebuilt
+ */
+static bool _vklite_bind_refs_rehash(Drp2VkliteState* state, uint32_t capacity)
+{
+    ANN(state);
+    Drp2BindGroupRef* refs = (Drp2BindGroupRef*)dvz_calloc(capacity, sizeof(Drp2BindGroupRef));
+    if (refs == NULL)
+        return false;
+
+    Drp2BindGroupRef* old_refs = state->bind_refs;
+    uint32_t old_capacity = state->bind_ref_capacity;
+    state->bind_refs = refs;
+    state->bind_ref_capacity = capacity;
+    state->bind_ref_count = 0;
+    state->bind_ref_tombstones = 0;
+    for (uint32_t i = 0; i < old_capacity; i++)
+    {
+        if (old_refs[i].resource_id != 0)
+            _vklite_bind_ref_insert(state, old_refs[i].resource_id, old_refs[i].bind_group_id);
+    }
+    dvz_free(old_refs);
+    return true;
+}
+
+
+
+/**
+ * Return whether a bind-group entry repeats the resource of an earlier entry.
  *
  * @param bind_group bind-group object carrying saved entries
- * @param resource_id backend resource id to match
- * @return whether the bind group depends on the resource
+ * @param index entry index
+ * @return whether an earlier entry has the same resource id
  */
-static bool _vklite_bind_group_references_resource(
-    const Drp2VkliteObject* bind_group, uint64_t resource_id)
+static bool _vklite_bind_group_entry_repeats(const Drp2VkliteObject* bind_group, uint32_t index)
 {
     ANN(bind_group);
-    if (bind_group->kind != DRP2_OBJECT_BIND_GROUP)
-        return false;
-    for (uint32_t i = 0; i < bind_group->bind_group_entry_count; i++)
+    for (uint32_t i = 0; i < index; i++)
     {
-        if (bind_group->bind_group_entries[i].resource_id == resource_id)
+        if (bind_group->bind_group_entries[i].resource_id ==
+            bind_group->bind_group_entries[index].resource_id)
             return true;
     }
     return false;
@@ -476,6 +567,97 @@ static bool _vklite_bind_group_references_resource(
 
 
 
+/**
+ * Record the resources a live bind group references in the reverse index.
+ *
+ * @param state vklite runtime state
+ * @param bind_group bind-group object carrying saved entries
+ * @return whether every reference was recorded
+ */
+bool _vklite_bind_refs_add(Drp2VkliteState* state, const Drp2VkliteObject* bind_group)
+{
+    ANN(state);
+    ANN(bind_group);
+    if (bind_group->kind != DRP2_OBJECT_BIND_GROUP || bind_group->bind_group_entry_count == 0)
+        return true;
+
+    // Keep live entries under half the slots and rehash once tombstones fill a quarter.
+    uint64_t live = (uint64_t)state->bind_ref_count + bind_group->bind_group_entry_count;
+    if ((live + state->bind_ref_tombstones) * 4 > (uint64_t)state->bind_ref_capacity * 3)
+    {
+        uint64_t capacity = 64;
+        while (capacity < live * 2)
+            capacity *= 2;
+        if (capacity > UINT32_MAX / 2 || !_vklite_bind_refs_rehash(state, (uint32_t)capacity))
+            return false;
+    }
+
+    for (uint32_t i = 0; i < bind_group->bind_group_entry_count; i++)
+    {
+        uint64_t resource_id = bind_group->bind_group_entries[i].resource_id;
+        if (resource_id != 0 && !_vklite_bind_group_entry_repeats(bind_group, i))
+            _vklite_bind_ref_insert(state, resource_id, bind_group->id);
+    }
+    return true;
+}
+
+
+
+/**
+ * Drop the reverse-index entries of a bind group that is destroyed or retired.
+ *
+ * @param state vklite runtime state
+ * @param bind_group bind-group object carrying saved entries
+ */
+void _vklite_bind_refs_remove(Drp2VkliteState* state, const Drp2VkliteObject* bind_group)
+{
+    ANN(state);
+    ANN(bind_group);
+    if (bind_group->kind != DRP2_OBJECT_BIND_GROUP || state->bind_ref_count == 0)
+        return;
+
+    const uint32_t mask = state->bind_ref_capacity - 1;
+    for (uint32_t e = 0; e < bind_group->bind_group_entry_count; e++)
+    {
+        uint64_t resource_id = bind_group->bind_group_entries[e].resource_id;
+        if (resource_id == 0 || _vklite_bind_group_entry_repeats(bind_group, e))
+            continue;
+        for (uint32_t i = _vklite_bind_ref_home(state, resource_id);; i = (i + 1) & mask)
+        {
+            Drp2BindGroupRef* ref = &state->bind_refs[i];
+            if (ref->resource_id == 0 && !ref->tombstone)
+                break;
+            if (ref->resource_id != resource_id || ref->bind_group_id != bind_group->id)
+                continue;
+            ref->resource_id = 0;
+            ref->bind_group_id = 0;
+            ref->tombstone = true;
+            state->bind_ref_count--;
+            state->bind_ref_tombstones++;
+            break;
+        }
+    }
+}
+
+
+
+/**
+ * Free the bind-group reverse index.
+ *
+ * @param state vklite runtime state
+ */
+void _vklite_bind_refs_cleanup(Drp2VkliteState* state)
+{
+    ANN(state);
+    dvz_free(state->bind_refs);
+    state->bind_refs = NULL;
+    state->bind_ref_capacity = 0;
+    state->bind_ref_count = 0;
+    state->bind_ref_tombstones = 0;
+}
+
+
+
 /**
  * Retire one descriptor wrapper without mutating the live bind-group object.
  *
@@ -499,12 +681,39 @@ static bool _vklite_retire_bind_group_descriptors(
             state, &retired, state->active_borrowed_command_buffer);
     }
 
+    _vklite_pass_bundles_invalidate(state);
     dvz_descriptors_free(descriptors);
     return true;
 }
 
 
 
+/**
+ * Return whether a bind group references a texture currently evicted to host memory.
+ *
+ * @param state vklite runtime state
+ * @param bind_group bind-group object carrying saved entries
+ * @return whether one of its resources has no image to bind
+ */
+static bool _vklite_bind_group_has_evicted(
+    Drp2VkliteState* state, const Drp2VkliteObject* bind_group)
+{
+    ANN(state);
+    ANN(bind_group);
+    if (state->evicted_count == 0)
+        return false;
+    for (uint32_t e = 0; e < bind_group->bind_group_entry_count; e++)
+    {
+        const Drp2VkliteObject* resource =
+            _vklite_find(state, bind_group->bind_group_entries[e].resource_id);
+        if (resource != NULL && resource->evicted_copy != NULL)
+            return true;
+    }
+    return false;
+}
+
+
+
 /**
  * Rebuild bind-group descriptors that reference a recreated backend resource id.
  *
@@ -520,12 +729,23 @@ DvzDrp2ValidationResult _vklite_refresh_dependent_bind_groups(
     if (resource_id == 0)
         return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_ARGUMENT, command_index);
 
-    for (uint32_t i = 0; i < state->count; i++)
+    if (state->bind_ref_count == 0)
+        return _drp2_ok();
+
+    // Rebuilding descriptors never adds or removes index entries, so the probe stays valid.
+    const uint32_t mask = state->bind_ref_capacity - 1;
+    for (uint32_t i = _vklite_bind_ref_home(state, resource_id);; i = (i + 1) & mask)
     {
-        Drp2VkliteObject* object = &state->objects[i];
-        if (object->destroyed || object->kind != DRP2_OBJECT_BIND_GROUP)
+        const Drp2BindGroupRef* ref = &state->bind_refs[i];
+        if (ref->resource_id == 0 && !ref->tombstone)
+            break;
+        if (ref->resource_id != resource_id)
             continue;
-        if (!_vklite_bind_group_references_resource(object, resource_id))
+        Drp2VkliteObject* object = _vklite_find(state, ref->bind_group_id);
+        if (object == NULL || object->kind != DRP2_OBJECT_BIND_GROUP)
+            continue;
+        // Rebuilt when the evicted texture is restored, before the bind group is used again.
+        if (_vklite_bind_group_has_evicted(state, object))
             continue;
 
         DvzDescriptors* descriptors = NULL;
@@ -602,6 +822,11 @@ DvzDrp2ValidationResult _vklite_create_bind_group(
         return result;
     }
     object->descriptors = descriptors;
+    if (!_vklite_bind_refs_add(state, object))
+    {
+        _vklite_destroy_object(object);
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    }
     return _drp2_ok();
 }
 
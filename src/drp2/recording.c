@@ -1427,6 +1427,20 @@ static bool _recording_write_portable_command(
                    command->u.draw_indexed.index_count, command->u.draw_indexed.instance_count,
                    command->u.draw_indexed.first_index, command->u.draw_indexed.base_vertex,
                    command->u.draw_indexed.first_instance) > 0;
+    case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
+        return dvz_fprintf(
+                   stream_fp,
+                   "{\"type\":\"command\",\"index\":%" PRIu32 ",\"cmd_type\":%d,"
+                   "\"op\":\"%s\",\"pass_id\":%" PRIu64 ",\"buffer_id\":%" PRIu64
+                   ",\"offset\":%" PRIu64 ",\"draw_count\":%" PRIu32 ",\"stride\":%" PRIu32
+                   "}\n",
+                   index, (int)command->type,
+                   command->type == DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT ? "DrawIndexedIndirect"
+                                                                           : "DrawIndirect",
+                   command->u.draw_indirect.pass_id, command->u.draw_indirect.buffer_id,
+                   command->u.draw_indirect.offset, command->u.draw_indirect.draw_count,
+                   command->u.draw_indirect.stride) > 0;
     case DVZ_DRP2_COMMAND_END_RENDER_PASS:
         return dvz_fprintf(
                    stream_fp,
@@ -1449,6 +1463,15 @@ static bool _recording_write_portable_command(
                    ",\"y\":%" PRIu32 ",\"z\":%" PRIu32 "}\n",
                    index, (int)command->type, command->u.dispatch.pass_id,
                    command->u.dispatch.x, command->u.dispatch.y, command->u.dispatch.z) > 0;
+    case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT:
+        return dvz_fprintf(
+                   stream_fp,
+                   "{\"type\":\"command\",\"index\":%" PRIu32 ",\"cmd_type\":%d,"
+                   "\"op\":\"DispatchWorkgroupsIndirect\",\"pass_id\":%" PRIu64
+                   ",\"buffer_id\":%" PRIu64 ",\"offset\":%" PRIu64 "}\n",
+                   index, (int)command->type, command->u.dispatch_workgroups_indirect.pass_id,
+                   command->u.dispatch_workgroups_indirect.buffer_id,
+                   command->u.dispatch_workgroups_indirect.offset) > 0;
     case DVZ_DRP2_COMMAND_END_COMPUTE_PASS:
         return dvz_fprintf(
                    stream_fp,
@@ -2682,6 +2705,17 @@ static bool _recording_read_portable_command(
                 line, "\"first_instance\":", &command.u.draw_indexed.first_instance))
             return false;
     }
+    else if (strcmp(op, "DrawIndirect") == 0 || strcmp(op, "DrawIndexedIndirect") == 0)
+    {
+        command.type = strcmp(op, "DrawIndirect") == 0 ? DVZ_DRP2_COMMAND_DRAW_INDIRECT
+                                                        : DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT;
+        if (!_recording_line_u64(line, "\"pass_id\":", &command.u.draw_indirect.pass_id) ||
+            !_recording_line_u64(line, "\"buffer_id\":", &command.u.draw_indirect.buffer_id) ||
+            !_recording_line_u64(line, "\"offset\":", &command.u.draw_indirect.offset) ||
+            !_recording_line_u32(line, "\"draw_count\":", &command.u.draw_indirect.draw_count) ||
+            !_recording_line_u32(line, "\"stride\":", &command.u.draw_indirect.stride))
+            return false;
+    }
     else if (strcmp(op, "EndRenderPass") == 0)
     {
         command.type = DVZ_DRP2_COMMAND_END_RENDER_PASS;
@@ -2704,6 +2738,17 @@ static bool _recording_read_portable_command(
             !_recording_line_u32(line, "\"z\":", &command.u.dispatch.z))
             return false;
     }
+    else if (strcmp(op, "DispatchWorkgroupsIndirect") == 0)
+    {
+        command.type = DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT;
+        if (!_recording_line_u64(
+                line, "\"pass_id\":", &command.u.dispatch_workgroups_indirect.pass_id) ||
+            !_recording_line_u64(
+                line, "\"buffer_id\":", &command.u.dispatch_workgroups_indirect.buffer_id) ||
+            !_recording_line_u64(
+                line, "\"offset\":", &command.u.dispatch_workgroups_indirect.offset))
+            return false;
+    }
     else if (strcmp(op, "EndComputePass") == 0)
     {
         command.type = DVZ_DRP2_COMMAND_END_COMPUTE_PASS;
@@ -35,6 +35,7 @@
 #if DVZ_DRP2_HAS_VKLITE
 #include "datoviz/stream/frame_stream.h"
 #include "datoviz/vk/device.h"
+#include "datoviz/vk/memory.h"
 #include "datoviz/vklite/buffers.h"
 #include "datoviz/vklite/compute.h"
 #include "datoviz/vklite/commands.h"
@@ -209,6 +210,8 @@ static VkBufferUsageFlags _drp2_external_buffer_required_vk_usage(uint32_t usage
         out |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
     if ((usage & DVZ_DRP2_BUFFER_USAGE_STORAGE) != 0)
         out |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    if ((usage & DVZ_DRP2_BUFFER_USAGE_INDIRECT) != 0)
+        out |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
     return out;
 }
 #endif
@@ -545,6 +548,7 @@ bool _dvz_drp2_runtime_vklite_download_buffer(
         return false;
     }
 
+    _vklite_transfer_wait(runtime->vklite_state, object->transfer_value);
     dvz_buffer_download(object->buffer, offset, size, data);
     return true;
 }
@@ -648,6 +652,15 @@ bool _dvz_drp2_runtime_timing_get(
 }
 
 
+
+void _dvz_drp2_runtime_async_transfers(DvzDrp2Runtime* runtime, bool enabled)
+{
+    if (runtime == NULL)
+        return;
+    runtime->sync_transfers = !enabled;
+}
+
+
 /**
  * Attach a borrowed stream frame as a runtime render target.
  *
@@ -732,6 +745,8 @@ bool dvz_drp2_runtime_copy_texture_to_frame(
     if ((frame->usage & DVZ_STREAM_FRAME_USAGE_COPY_DST) == 0)
         return false;
 
+    if (!_vklite_budget_use(runtime->vklite_state, texture_id, 0).ok)
+        return false;
     Drp2VkliteObject* source = _vklite_find(runtime->vklite_state, texture_id);
     if (source == NULL || source->images == NULL)
         return false;
@@ -813,3 +828,58 @@ bool dvz_drp2_runtime_download_buffer(
     return false;
 #endif
 }
+
+
+
+bool dvz_drp2_runtime_set_memory_budget(DvzDrp2Runtime* runtime, uint64_t bytes)
+{
+    if (runtime == NULL || runtime->semantic_only)
+        return false;
+    runtime->memory_budget = bytes;
+    return true;
+}
+
+
+
+void dvz_drp2_runtime_set_memory_owner(DvzDrp2Runtime* runtime, uint64_t owner)
+{
+    if (runtime == NULL)
+        return;
+    runtime->memory_owner = owner;
+}
+
+
+
+void dvz_drp2_runtime_begin_frame(DvzDrp2Runtime* runtime)
+{
+    if (runtime == NULL)
+        return;
+    runtime->memory_frame++;
+}
+
+
+
+bool dvz_drp2_runtime_memory_stats(
+    const DvzDrp2Runtime* runtime, uint64_t owner, DvzDrp2MemoryStats* stats)
+{
+    if (runtime == NULL || stats == NULL)
+        return false;
+    dvz_memset(stats, sizeof(DvzDrp2MemoryStats), 0, sizeof(DvzDrp2MemoryStats));
+    stats->struct_size = (uint32_t)sizeof(DvzDrp2MemoryStats);
+    stats->budget = runtime->memory_budget;
+#if DVZ_DRP2_HAS_VKLITE
+    DvzMemoryBudget heaps = {0};
+    if (runtime->allocator != NULL && dvz_allocator_budget(runtime->allocator, &heaps) == 0)
+    {
+        stats->device_usage = heaps.device_usage;
+        stats->device_budget = heaps.device_budget;
+    }
+    if (stats->budget == DVZ_DRP2_MEMORY_BUDGET_DEVICE)
+        stats->budget = stats->device_budget;
+    if (runtime->vklite_state != NULL)
+        _vklite_budget_stats(runtime->vklite_state, owner, stats);
+#else
+    (void)owner;
+#endif
+    return true;
+}
@@ -1951,6 +1951,79 @@ static DvzDrp2ValidationResult _validate_draw_indexed(
 
 
 
+/**
+ * Validate the argument records read by an indirect draw or dispatch.
+ *
+ * @param state semantic runtime state
+ * @param buffer_id indirect argument buffer id
+ * @param offset byte offset of the first record
+ * @param record_count number of records read
+ * @param stride byte stride between records, or zero when tightly packed
+ * @param record_size byte size of one record
+ * @param command_index command index used for validation reporting
+ * @return validation result
+ */
+static DvzDrp2ValidationResult _validate_indirect_buffer(
+    Drp2RuntimeState* state, uint64_t buffer_id, uint64_t offset, uint32_t record_count,
+    uint32_t stride, uint32_t record_size, uint32_t command_index)
+{
+    ANN(state);
+
+    Drp2Object* buffer = _find_object(state, buffer_id);
+    if (buffer == NULL || buffer->kind != DRP2_OBJECT_BUFFER)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    if ((buffer->usage & DVZ_DRP2_BUFFER_USAGE_INDIRECT) == 0)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_USAGE, command_index);
+    if (record_count == 0 || offset % 4 != 0)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_ARGUMENT, command_index);
+    if (stride != 0 && (stride % 4 != 0 || stride < record_size))
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_ARGUMENT, command_index);
+
+    uint64_t span = 0;
+    uint32_t effective_stride = stride != 0 ? stride : record_size;
+    if (_dvz_mul_u64_overflows(record_count - 1u, effective_stride, &span) ||
+        span > UINT64_MAX - record_size)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_OUT_OF_RANGE, command_index);
+    if (_drp2_range_overflows(offset, span + record_size, buffer->size))
+        return _drp2_fail(DVZ_DRP2_VALIDATION_OUT_OF_RANGE, command_index);
+
+    _mark_referenced(state, buffer_id);
+    return _drp2_ok();
+}
+
+
+
+static DvzDrp2ValidationResult _validate_draw_indirect(
+    Drp2RuntimeState* state, const DvzDrp2Command* command, uint32_t command_index)
+{
+    ANN(state);
+    ANN(command);
+
+    bool indexed = command->type == DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT;
+    Drp2Object* pass = _find_object(state, command->u.draw_indirect.pass_id);
+    if (pass == NULL || pass->kind != DRP2_OBJECT_RENDER_PASS || !pass->open)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+
+    DvzDrp2ValidationResult result = _validate_render_draw_state(state, pass, command_index);
+    if (!result.ok)
+        return result;
+    if (indexed && !pass->index_buffer_bound)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+
+    // Vertex and instance ranges live in GPU memory, so only the bindings themselves are checked.
+    Drp2Object* pipeline = _find_object(state, pass->pipeline_id);
+    result = _validate_draw_vertex_ranges(state, pass, pipeline, 0, 0, 0, 0, command_index);
+    if (!result.ok)
+        return result;
+    return _validate_indirect_buffer(
+        state, command->u.draw_indirect.buffer_id, command->u.draw_indirect.offset,
+        command->u.draw_indirect.draw_count, command->u.draw_indirect.stride,
+        indexed ? DVZ_DRP2_DRAW_INDEXED_INDIRECT_ARGS_SIZE : DVZ_DRP2_DRAW_INDIRECT_ARGS_SIZE,
+        command_index);
+}
+
+
+
 static DvzDrp2ValidationResult _validate_end_render_pass(
     Drp2RuntimeState* state, const DvzDrp2Command* command, uint32_t command_index)
 {
@@ -2000,6 +2073,36 @@ static DvzDrp2ValidationResult _validate_dispatch_workgroups(
 
 
 
+static DvzDrp2ValidationResult _validate_dispatch_workgroups_indirect(
+    Drp2RuntimeState* state, const DvzDrp2Command* command, uint32_t command_index)
+{
+    ANN(state);
+    ANN(command);
+
+    Drp2Object* pass = _find_object(state, command->u.dispatch_workgroups_indirect.pass_id);
+    if (pass == NULL || pass->kind != DRP2_OBJECT_COMPUTE_PASS || !pass->open)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+
+    Drp2Object* pipeline = _find_object(state, pass->pipeline_id);
+    if (pipeline == NULL || pipeline->kind != DRP2_OBJECT_COMPUTE_PIPELINE)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    for (uint32_t i = 0; i < pipeline->bind_group_layout_count; i++)
+    {
+        if ((pass->bound_bind_group_mask & (1u << i)) == 0)
+            return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    }
+    DvzDrp2ValidationResult result = _validate_indirect_buffer(
+        state, command->u.dispatch_workgroups_indirect.buffer_id,
+        command->u.dispatch_workgroups_indirect.offset, 1, 0,
+        DVZ_DRP2_DISPATCH_INDIRECT_ARGS_SIZE, command_index);
+    if (!result.ok)
+        return result;
+    _mark_referenced(state, pass->pipeline_id);
+    return _drp2_ok();
+}
+
+
+
 static DvzDrp2ValidationResult _validate_end_compute_pass(
     Drp2RuntimeState* state, const DvzDrp2Command* command, uint32_t command_index)
 {
@@ -2027,6 +2130,9 @@ static bool _resource_barrier_supported(const DvzDrp2Command* command)
     if (strcmp(command->u.resource_barrier.dst_stage, "COPY") == 0 &&
         strcmp(command->u.resource_barrier.dst_access, "COPY_READ") == 0)
         return true;
+    if (strcmp(command->u.resource_barrier.dst_stage, "DRAW_INDIRECT") == 0 &&
+        strcmp(command->u.resource_barrier.dst_access, "INDIRECT_READ") == 0)
+        return true;
     return false;
 }
 
@@ -2057,6 +2163,9 @@ static DvzDrp2ValidationResult _validate_resource_barrier(
     if (strcmp(command->u.resource_barrier.dst_stage, "COPY") == 0 &&
         (buffer->usage & DVZ_DRP2_BUFFER_USAGE_COPY_SRC) == 0)
         return _drp2_fail(DVZ_DRP2_VALIDATION_USAGE, command_index);
+    if (strcmp(command->u.resource_barrier.dst_stage, "DRAW_INDIRECT") == 0 &&
+        (buffer->usage & DVZ_DRP2_BUFFER_USAGE_INDIRECT) == 0)
+        return _drp2_fail(DVZ_DRP2_VALIDATION_USAGE, command_index);
 
     if (!_resource_barrier_supported(command))
         return _drp2_fail(DVZ_DRP2_VALIDATION_USAGE, command_index);
@@ -2415,10 +2524,15 @@ static DvzDrp2ValidationResult _validate_command(
         return _validate_draw(state, command, command_index);
     case DVZ_DRP2_COMMAND_DRAW_INDEXED:
         return _validate_draw_indexed(state, command, command_index);
+    case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
+        return _validate_draw_indirect(state, command, command_index);
     case DVZ_DRP2_COMMAND_END_RENDER_PASS:
         return _validate_end_render_pass(state, command, command_index);
     case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS:
         return _validate_dispatch_workgroups(state, command, command_index);
+    case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT:
+        return _validate_dispatch_workgroups_indirect(state, command, command_index);
     case DVZ_DRP2_COMMAND_END_COMPUTE_PASS:
         return _validate_end_compute_pass(state, command, command_index);
     case DVZ_DRP2_COMMAND_RESOURCE_BARRIER:
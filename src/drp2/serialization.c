@@ -472,6 +472,7 @@ static void _json_append_usage(JsonBuilder* builder, uint32_t usage)
     APPEND_USAGE(DVZ_DRP2_BUFFER_USAGE_INDEX, "INDEX");
     APPEND_USAGE(DVZ_DRP2_BUFFER_USAGE_UNIFORM, "UNIFORM");
     APPEND_USAGE(DVZ_DRP2_BUFFER_USAGE_STORAGE, "STORAGE");
+    APPEND_USAGE(DVZ_DRP2_BUFFER_USAGE_INDIRECT, "INDIRECT");
 
 #undef APPEND_USAGE
     _json_append(builder, "]");
@@ -499,6 +500,7 @@ static void _json_append_texture_usage(JsonBuilder* builder, uint32_t usage)
     APPEND_TEXTURE_USAGE(DVZ_DRP2_TEXTURE_USAGE_TEXTURE_BINDING, "TEXTURE_BINDING");
     APPEND_TEXTURE_USAGE(DVZ_DRP2_TEXTURE_USAGE_STORAGE_BINDING, "STORAGE_BINDING");
     APPEND_TEXTURE_USAGE(DVZ_DRP2_TEXTURE_USAGE_RENDER_ATTACHMENT, "RENDER_ATTACHMENT");
+    APPEND_TEXTURE_USAGE(DVZ_DRP2_TEXTURE_USAGE_TRANSIENT_ATTACHMENT, "TRANSIENT_ATTACHMENT");
 
 #undef APPEND_TEXTURE_USAGE
     _json_append(builder, "]");
@@ -1165,6 +1167,16 @@ static void _json_append_command(
             command->u.draw_indexed.first_index, command->u.draw_indexed.base_vertex,
             command->u.draw_indexed.first_instance);
         break;
+    case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+    case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
+        _json_append(
+            builder,
+            "{ \"cmd\": \"%s\", \"pass_id\": %" PRIu64 ", \"buffer_id\": %" PRIu64
+            ", \"offset\": %" PRIu64 ", \"draw_count\": %" PRIu32 ", \"stride\": %" PRIu32 " }",
+            _dvz_drp2_command_name(command->type), command->u.draw_indirect.pass_id,
+            command->u.draw_indirect.buffer_id, command->u.draw_indirect.offset,
+            command->u.draw_indirect.draw_count, command->u.draw_indirect.stride);
+        break;
     case DVZ_DRP2_COMMAND_END_RENDER_PASS:
         _json_append(
             builder, "{ \"cmd\": \"%s\", \"pass_id\": %" PRIu64 " }",
@@ -1178,6 +1190,15 @@ static void _json_append_command(
             _dvz_drp2_command_name(command->type), command->u.dispatch.pass_id, command->u.dispatch.x,
             command->u.dispatch.y, command->u.dispatch.z);
         break;
+    case DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT:
+        _json_append(
+            builder,
+            "{ \"cmd\": \"%s\", \"pass_id\": %" PRIu64 ", \"buffer_id\": %" PRIu64
+            ", \"offset\": %" PRIu64 " }",
+            _dvz_drp2_command_name(command->type), command->u.dispatch_workgroups_indirect.pass_id,
+            command->u.dispatch_workgroups_indirect.buffer_id,
+            command->u.dispatch_workgroups_indirect.offset);
+        break;
     case DVZ_DRP2_COMMAND_END_COMPUTE_PASS:
         _json_append(
             builder, "{ \"cmd\": \"%s\", \"pass_id\": %" PRIu64 " }",
@@ -64,6 +64,31 @@ static bool _ensure_stream_capacity(DvzDrp2CommandStream* stream)
 
 
 
+/**
+ * Fold the commands of a stream into its running fingerprint up to one command index.
+ *
+ * @param stream the command stream
+ * @param end index past the last command to fold
+ */
+static void _fingerprint_fold(DvzDrp2CommandStream* stream, uint32_t end)
+{
+    ANN(stream);
+    if (stream->fingerprint_count > end)
+    {
+        /* The stream shrank below the folded prefix: start over. */
+        stream->fingerprint_count = 0;
+        stream->fingerprint_unversioned = false;
+    }
+    if (stream->fingerprint_count == 0)
+        stream->fingerprint = DVZ_DRP2_FINGERPRINT_OFFSET;
+    for (uint32_t i = stream->fingerprint_count; i < end; i++)
+        stream->fingerprint = _dvz_drp2_fingerprint_command(
+            stream->fingerprint, &stream->commands[i], &stream->fingerprint_unversioned);
+    stream->fingerprint_count = end;
+}
+
+
+
 static DvzDrp2Command* _append_command(DvzDrp2CommandStream* stream, DvzDrp2CommandType type)
 {
     if (stream == NULL)
@@ -71,6 +96,8 @@ static DvzDrp2Command* _append_command(DvzDrp2CommandStream* stream, DvzDrp2Comm
         log_error("cannot append DRP2 command to a null stream");
         return NULL;
     }
+    /* Setters only amend the last command, so every earlier command is final. */
+    _fingerprint_fold(stream, stream->count);
     if (!_ensure_stream_capacity(stream))
     {
         log_error("cannot grow DRP2 command stream");
@@ -132,6 +159,23 @@ static void _copy_label(char* dst, uint64_t dst_size, const char* src)
 
 
 
+static bool _append_draw_indirect(
+    DvzDrp2CommandStream* stream, DvzDrp2CommandType type, uint64_t pass_id, uint64_t buffer_id,
+    uint64_t offset, uint32_t draw_count, uint32_t stride)
+{
+    DvzDrp2Command* command = _append_command(stream, type);
+    if (command == NULL)
+        return false;
+    command->u.draw_indirect.pass_id = pass_id;
+    command->u.draw_indirect.buffer_id = buffer_id;
+    command->u.draw_indirect.offset = offset;
+    command->u.draw_indirect.draw_count = draw_count;
+    command->u.draw_indirect.stride = stride;
+    return true;
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -209,13 +253,17 @@ void dvz_drp2_stream_destroy(DvzDrp2CommandStream* stream)
         DvzDrp2Command* cmd = &stream->commands[i];
         if (cmd->type == DVZ_DRP2_COMMAND_WRITE_BUFFER)
         {
-            if (cmd->u.write_buffer.data_raw_owned)
+            if (
+                cmd->u.write_buffer.data_raw_owned &&
+                !dvz_arena_owns(stream->payloads, cmd->u.write_buffer.data_raw))
                 dvz_free(cmd->u.write_buffer.data_raw);
             dvz_free(cmd->u.write_buffer.data_base64);
         }
         else if (cmd->type == DVZ_DRP2_COMMAND_WRITE_TEXTURE)
         {
-            if (cmd->u.write_texture.data_raw_owned)
+            if (
+                cmd->u.write_texture.data_raw_owned &&
+                !dvz_arena_owns(stream->payloads, cmd->u.write_texture.data_raw))
                 dvz_free((void*)(uintptr_t)cmd->u.write_texture.data_raw);
             dvz_free(cmd->u.write_texture.data_base64);
         }
@@ -224,11 +272,28 @@ void dvz_drp2_stream_destroy(DvzDrp2CommandStream* stream)
     }
     dvz_free(stream->commands);
     dvz_free(stream->labels);
+    dvz_arena_destroy(stream->payloads);
     dvz_free(stream);
 }
 
 
 
+void* _dvz_drp2_stream_payload(DvzDrp2CommandStream* stream, uint64_t size)
+{
+    ANN(stream);
+    if (size == 0 || size > SIZE_MAX)
+        return NULL;
+    if (size > DVZ_DRP2_PAYLOAD_ARENA_MAX)
+        return dvz_malloc((size_t)size);
+    if (stream->payloads == NULL)
+        stream->payloads = dvz_arena(DVZ_DRP2_PAYLOAD_CHUNK_SIZE);
+    if (stream->payloads == NULL)
+        return dvz_malloc((size_t)size);
+    return dvz_arena_alloc(stream->payloads, size);
+}
+
+
+
 /**
  * Return the number of commands in a DRP2 command stream.
  *
@@ -1728,6 +1793,43 @@ bool dvz_drp2_stream_write_texture_3d_borrowed(
 
 
 
+bool dvz_drp2_stream_set_payload_version(DvzDrp2CommandStream* stream, uint64_t version)
+{
+    if (stream == NULL || stream->count == 0)
+        return false;
+    DvzDrp2Command* command = &stream->commands[stream->count - 1];
+    if (command->type == DVZ_DRP2_COMMAND_WRITE_BUFFER)
+        command->u.write_buffer.payload_version = version;
+    else if (command->type == DVZ_DRP2_COMMAND_WRITE_TEXTURE)
+        command->u.write_texture.payload_version = version;
+    else
+        return false;
+    return true;
+}
+
+
+
+bool dvz_drp2_stream_fingerprint(const DvzDrp2CommandStream* stream, uint64_t* fingerprint)
+{
+    if (fingerprint != NULL)
+        *fingerprint = 0;
+    if (stream == NULL || fingerprint == NULL)
+        return false;
+
+    /* Fold the pending tail into a copy; the stream keeps only final commands folded. */
+    uint32_t begin = stream->fingerprint_count <= stream->count ? stream->fingerprint_count : 0;
+    uint64_t hash = begin > 0 ? stream->fingerprint : DVZ_DRP2_FINGERPRINT_OFFSET;
+    bool unversioned = begin > 0 && stream->fingerprint_unversioned;
+    for (uint32_t i = begin; i < stream->count; i++)
+        hash = _dvz_drp2_fingerprint_command(hash, &stream->commands[i], &unversioned);
+    hash ^= (uint64_t)stream->count;
+    hash *= DVZ_DRP2_FINGERPRINT_PRIME;
+    *fingerprint = hash;
+    return !unversioned;
+}
+
+
+
 /**
  * Append a BeginCommandEncoder command.
  *
@@ -2375,6 +2477,85 @@ bool dvz_drp2_stream_draw_indexed(
 
 
 
+/**
+ * Append a DrawIndirect command.
+ *
+ * @param stream the command stream
+ * @param pass_id the pass id
+ * @param buffer_id the indirect argument buffer id
+ * @param offset the byte offset of the record
+ * @return whether the command was appended
+ */
+bool dvz_drp2_stream_draw_indirect(
+    DvzDrp2CommandStream* stream, uint64_t pass_id, uint64_t buffer_id, uint64_t offset)
+{
+    return _append_draw_indirect(
+        stream, DVZ_DRP2_COMMAND_DRAW_INDIRECT, pass_id, buffer_id, offset, 1, 0);
+}
+
+
+
+/**
+ * Append a DrawIndexedIndirect command.
+ *
+ * @param stream the command stream
+ * @param pass_id the pass id
+ * @param buffer_id the indirect argument buffer id
+ * @param offset the byte offset of the record
+ * @return whether the command was appended
+ */
+bool dvz_drp2_stream_draw_indexed_indirect(
+    DvzDrp2CommandStream* stream, uint64_t pass_id, uint64_t buffer_id, uint64_t offset)
+{
+    return _append_draw_indirect(
+        stream, DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT, pass_id, buffer_id, offset, 1, 0);
+}
+
+
+
+/**
+ * Append a multi-draw DrawIndirect command.
+ *
+ * @param stream the command stream
+ * @param pass_id the pass id
+ * @param buffer_id the indirect argument buffer id
+ * @param offset the byte offset of the first record
+ * @param draw_count the number of records to draw
+ * @param stride the byte stride between records, 0 for tightly packed records
+ * @return whether the command was appended
+ */
+bool dvz_drp2_stream_multi_draw_indirect(
+    DvzDrp2CommandStream* stream, uint64_t pass_id, uint64_t buffer_id, uint64_t offset,
+    uint32_t draw_count, uint32_t stride)
+{
+    return _append_draw_indirect(
+        stream, DVZ_DRP2_COMMAND_DRAW_INDIRECT, pass_id, buffer_id, offset, draw_count, stride);
+}
+
+
+
+/**
+ * Append a multi-draw DrawIndexedIndirect command.
+ *
+ * @param stream the command stream
+ * @param pass_id the pass id
+ * @param buffer_id the indirect argument buffer id
+ * @param offset the byte offset of the first record
+ * @param draw_count the number of records to draw
+ * @param stride the byte stride between records, 0 for tightly packed records
+ * @return whether the command was appended
+ */
+bool dvz_drp2_stream_multi_draw_indexed_indirect(
+    DvzDrp2CommandStream* stream, uint64_t pass_id, uint64_t buffer_id, uint64_t offset,
+    uint32_t draw_count, uint32_t stride)
+{
+    return _append_draw_indirect(
+        stream, DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT, pass_id, buffer_id, offset, draw_count,
+        stride);
+}
+
+
+
 /**
  * Append an EndRenderPass command.
  *
@@ -2418,6 +2599,30 @@ bool dvz_drp2_stream_dispatch_workgroups(
 
 
 
+/**
+ * Append a DispatchWorkgroupsIndirect command.
+ *
+ * @param stream the command stream
+ * @param pass_id the compute pass id
+ * @param buffer_id the indirect argument buffer id
+ * @param offset the byte offset of the record
+ * @return whether the command was appended
+ */
+bool dvz_drp2_stream_dispatch_workgroups_indirect(
+    DvzDrp2CommandStream* stream, uint64_t pass_id, uint64_t buffer_id, uint64_t offset)
+{
+    DvzDrp2Command* command =
+        _append_command(stream, DVZ_DRP2_COMMAND_DISPATCH_WORKGROUPS_INDIRECT);
+    if (command == NULL)
+        return false;
+    command->u.dispatch_workgroups_indirect.pass_id = pass_id;
+    command->u.dispatch_workgroups_indirect.buffer_id = buffer_id;
+    command->u.dispatch_workgroups_indirect.offset = offset;
+    return true;
+}
+
+
+
 /**
  * Append an EndComputePass command.
  *
@@ -2695,7 +2900,7 @@ bool dvz_drp2_stream_write_buffer_bytes(
     DvzDrp2Command* command = _append_command(stream, DVZ_DRP2_COMMAND_WRITE_BUFFER);
     if (command == NULL)
         return false;
-    void* data_copy = dvz_malloc((size_t)size);
+    void* data_copy = _dvz_drp2_stream_payload(stream, size);
     if (data_copy == NULL)
     {
         stream->count--;
@@ -16,6 +16,7 @@
 
 #include <stdint.h>
 
+#include "_alloc.h"
 #include "_assertions.h"
 #include "../_runtime.h"
 #include "../_stream.h"
@@ -300,6 +301,37 @@ int test_drp2_runtime_vklite_trims_destroyed_tail_slots(TstContext* suite, const
     _vklite_state_cleanup(&state);
     return 0;
 }
+
+
+
+int test_drp2_runtime_vklite_bundles_forget_owned_primary(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    Drp2VkliteState state = {0};
+    VkCommandBuffer owned = (VkCommandBuffer)(uintptr_t)0x123;
+    VkCommandBuffer borrowed = (VkCommandBuffer)(uintptr_t)0x456;
+    state.bundles = (Drp2PassBundle*)dvz_calloc(2, sizeof(Drp2PassBundle));
+    ANN(state.bundles);
+    state.bundle_capacity = 2;
+    state.bundle_count = 2;
+    state.bundles[0].last_primary = owned;
+    state.bundles[1].last_primary = borrowed;
+
+    // A bundle released while the owned primary is still recording waits for that primary.
+    Drp2VkliteObject retired = {.kind = DRP2_OBJECT_RENDER_PASS};
+    AT(_vklite_defer_destroy_object(&state, &retired, owned));
+    AT(state.deferred_count == 1);
+
+    _vklite_pass_bundles_note_primary_done(&state, owned);
+    AT(state.deferred_count == 0);
+    AT(state.bundles[0].last_primary == VK_NULL_HANDLE);
+    AT(state.bundles[1].last_primary == borrowed);
+
+    _vklite_state_cleanup(&state);
+    return 0;
+}
 #endif
 
 
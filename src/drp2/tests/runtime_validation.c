@@ -615,6 +615,115 @@ int test_drp2_runtime_rejects_wrong_index_buffer_usage(TstContext* suite, const
 
 
 
+int test_drp2_runtime_validate_indirect_stream(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzDrp2CommandStream* stream = dvz_drp2_stream();
+    ANN(stream);
+
+    // A compute pass writes draw records that a later render pass consumes indirectly.
+    AT(dvz_drp2_stream_hello_renderer(stream, "test-client"));
+    AT(dvz_drp2_stream_renderer_hello_reply(stream, "test-renderer"));
+    AT(dvz_drp2_stream_create_shader_module(stream, 2, "vertex", "@vertex fn main() {}"));
+    AT(dvz_drp2_stream_create_shader_module(stream, 3, "fragment", "@fragment fn main() {}"));
+    AT(dvz_drp2_stream_create_shader_module(stream, 9000, "COMPUTE", "@compute fn main() {}"));
+    AT(drp2_test_create_render_pipeline(stream, 4, 2, 3, 1));
+    AT(dvz_drp2_stream_create_compute_pipeline(stream, 20, 9000));
+    AT(dvz_drp2_stream_create_buffer(stream, 11, 64, DVZ_DRP2_BUFFER_USAGE_VERTEX));
+    AT(dvz_drp2_stream_create_buffer(stream, 12, 64, DVZ_DRP2_BUFFER_USAGE_INDEX));
+    AT(dvz_drp2_stream_create_buffer(
+        stream, 13, 64, DVZ_DRP2_BUFFER_USAGE_STORAGE | DVZ_DRP2_BUFFER_USAGE_INDIRECT));
+    AT(dvz_drp2_stream_create_texture_2d(stream, 5, 4, 4));
+    AT(dvz_drp2_stream_begin_command_encoder(stream, 6));
+    AT(dvz_drp2_stream_begin_compute_pass(stream, 21, 6));
+    AT(dvz_drp2_stream_set_pipeline(stream, 21, 20));
+    AT(dvz_drp2_stream_dispatch_workgroups_indirect(stream, 21, 13, 40));
+    AT(dvz_drp2_stream_end_compute_pass(stream, 21));
+    AT(dvz_drp2_stream_resource_barrier(
+        stream, 6, 13, "COMPUTE", "STORAGE_WRITE", "DRAW_INDIRECT", "INDIRECT_READ", 0, 0));
+    AT(dvz_drp2_stream_begin_render_pass(stream, 7, 6, 5));
+    AT(dvz_drp2_stream_set_pipeline(stream, 7, 4));
+    AT(dvz_drp2_stream_set_vertex_buffer(stream, 7, 0, 11, 0));
+    AT(dvz_drp2_stream_draw_indirect(stream, 7, 13, 0));
+    AT(dvz_drp2_stream_set_index_buffer(stream, 7, 12, "uint16", 0));
+    AT(dvz_drp2_stream_multi_draw_indexed_indirect(stream, 7, 13, 0, 2, 20));
+    AT(dvz_drp2_stream_end_render_pass(stream, 7));
+    AT(dvz_drp2_stream_finish_command_encoder(stream, 6, 8));
+
+    DvzDrp2ValidationResult result = dvz_drp2_validate_stream(stream);
+    AT(result.ok);
+    AT(result.code == DVZ_DRP2_VALIDATION_OK);
+
+    char* json = dvz_drp2_stream_json(stream, "indirect_from_c");
+    ANN(json);
+    AT(strstr(json, "\"cmd\": \"DispatchWorkgroupsIndirect\"") != NULL);
+    AT(strstr(json, "\"cmd\": \"DrawIndirect\"") != NULL);
+    AT(strstr(json, "\"cmd\": \"DrawIndexedIndirect\"") != NULL);
+    AT(strstr(json, "\"draw_count\": 2, \"stride\": 20") != NULL);
+    AT(strstr(json, "\"INDIRECT\"") != NULL);
+
+    dvz_drp2_stream_json_destroy(json);
+    dvz_drp2_stream_destroy(stream);
+    return 0;
+}
+
+
+
+int test_drp2_runtime_rejects_invalid_indirect_args(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    struct
+    {
+        uint32_t usage;
+        uint64_t offset;
+        uint32_t draw_count;
+        uint32_t stride;
+        DvzDrp2ValidationCode code;
+    } cases[] = {
+        {DVZ_DRP2_BUFFER_USAGE_STORAGE, 0, 1, 0, DVZ_DRP2_VALIDATION_USAGE},
+        {DVZ_DRP2_BUFFER_USAGE_INDIRECT, 2, 1, 0, DVZ_DRP2_VALIDATION_INVALID_ARGUMENT},
+        {DVZ_DRP2_BUFFER_USAGE_INDIRECT, 0, 2, 8, DVZ_DRP2_VALIDATION_INVALID_ARGUMENT},
+        {DVZ_DRP2_BUFFER_USAGE_INDIRECT, 0, 0, 0, DVZ_DRP2_VALIDATION_INVALID_ARGUMENT},
+        {DVZ_DRP2_BUFFER_USAGE_INDIRECT, 0, 3, 16, DVZ_DRP2_VALIDATION_OUT_OF_RANGE},
+        {DVZ_DRP2_BUFFER_USAGE_INDIRECT, 24, 1, 0, DVZ_DRP2_VALIDATION_OUT_OF_RANGE},
+    };
+
+    for (uint32_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        DvzDrp2CommandStream* stream = dvz_drp2_stream();
+        ANN(stream);
+
+        AT(dvz_drp2_stream_hello_renderer(stream, "test-client"));
+        AT(dvz_drp2_stream_renderer_hello_reply(stream, "test-renderer"));
+        AT(dvz_drp2_stream_create_shader_module(stream, 2, "vertex", "@vertex fn main() {}"));
+        AT(dvz_drp2_stream_create_shader_module(stream, 3, "fragment", "@fragment fn main() {}"));
+        AT(drp2_test_create_render_pipeline(stream, 4, 2, 3, 1));
+        AT(dvz_drp2_stream_create_buffer(stream, 11, 64, DVZ_DRP2_BUFFER_USAGE_VERTEX));
+        AT(dvz_drp2_stream_create_buffer(stream, 13, 32, cases[i].usage));
+        AT(dvz_drp2_stream_create_texture_2d(stream, 5, 4, 4));
+        AT(dvz_drp2_stream_begin_command_encoder(stream, 6));
+        AT(dvz_drp2_stream_begin_render_pass(stream, 7, 6, 5));
+        AT(dvz_drp2_stream_set_pipeline(stream, 7, 4));
+        AT(dvz_drp2_stream_set_vertex_buffer(stream, 7, 0, 11, 0));
+        AT(dvz_drp2_stream_multi_draw_indirect(
+            stream, 7, 13, cases[i].offset, cases[i].draw_count, cases[i].stride));
+
+        DvzDrp2ValidationResult result = dvz_drp2_validate_stream(stream);
+        AT(!result.ok);
+        AT(result.code == cases[i].code);
+        AT(result.command_index == 12);
+
+        dvz_drp2_stream_destroy(stream);
+    }
+    return 0;
+}
+
+
+
 int test_drp2_runtime_validate_write_texture(TstContext* suite, const TstCase* item)
 {
     ANN(suite);
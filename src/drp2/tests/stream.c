@@ -601,6 +601,144 @@ int test_drp2_packet_rejects_empty_shader_module_fields(
 
 
 
+static DvzDrp2CommandStream* _fingerprint_stream(const uint8_t* payload, uint32_t vertex_count)
+{
+    DvzDrp2CommandStream* stream = dvz_drp2_stream();
+    ANN(stream);
+    bool ok = dvz_drp2_stream_set_label(stream, 1, "fingerprint") &&
+              dvz_drp2_stream_write_buffer_bytes(stream, 1, 0, 4, payload) &&
+              dvz_drp2_stream_begin_command_encoder(stream, 10) &&
+              dvz_drp2_stream_begin_render_pass(stream, 20, 10, 2) &&
+              dvz_drp2_stream_set_pipeline(stream, 20, 3) &&
+              dvz_drp2_stream_draw(stream, 20, vertex_count, 1, 0, 0) &&
+              dvz_drp2_stream_end_render_pass(stream, 20) &&
+              dvz_drp2_stream_finish_command_encoder(stream, 10, 11) &&
+              dvz_drp2_stream_queue_submit(stream, 11, 12);
+    if (!ok)
+    {
+        dvz_drp2_stream_destroy(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+
+
+int test_drp2_packet_fingerprint(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    uint8_t payload[4] = {1, 2, 3, 4};
+    DvzDrp2CommandStream* a = _fingerprint_stream(payload, 3);
+    DvzDrp2CommandStream* b = _fingerprint_stream(payload, 3);
+    ANN(a);
+    ANN(b);
+    const uint64_t fingerprint = dvz_drp2_packet_fingerprint(a);
+    AT(fingerprint == dvz_drp2_packet_fingerprint(b));
+
+    /* Labels do not change presentation and are excluded from the fingerprint. */
+    AT(dvz_drp2_stream_set_label(b, 2, "other"));
+    AT(fingerprint == dvz_drp2_packet_fingerprint(b));
+    dvz_drp2_stream_destroy(b);
+
+    /* Command arguments and payload bytes are both covered. */
+    b = _fingerprint_stream(payload, 6);
+    ANN(b);
+    AT(fingerprint != dvz_drp2_packet_fingerprint(b));
+    dvz_drp2_stream_destroy(b);
+
+    payload[3] = 5;
+    b = _fingerprint_stream(payload, 3);
+    ANN(b);
+    AT(fingerprint != dvz_drp2_packet_fingerprint(b));
+    dvz_drp2_stream_destroy(b);
+
+    AT(dvz_drp2_packet_fingerprint(NULL) != fingerprint);
+    dvz_drp2_stream_destroy(a);
+    return 0;
+}
+
+
+
+static DvzDrp2CommandStream* _versioned_stream(const uint8_t* payload, uint64_t version)
+{
+    DvzDrp2CommandStream* stream = _fingerprint_stream(payload, 3);
+    if (stream == NULL)
+        return NULL;
+    if (!dvz_drp2_stream_write_buffer_bytes(stream, 4, 0, 512, payload) ||
+        (version != 0 && !dvz_drp2_stream_set_payload_version(stream, version)))
+    {
+        dvz_drp2_stream_destroy(stream);
+        return NULL;
+    }
+    return stream;
+}
+
+
+
+int test_drp2_stream_fingerprint(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    uint8_t payload[512] = {1, 2, 3, 4};
+    DvzDrp2CommandStream* a = _fingerprint_stream(payload, 3);
+    DvzDrp2CommandStream* b = _fingerprint_stream(payload, 3);
+    ANN(a);
+    ANN(b);
+    uint64_t fingerprint = 0;
+    uint64_t other = 0;
+    AT(dvz_drp2_stream_fingerprint(a, &fingerprint));
+    AT(dvz_drp2_stream_fingerprint(b, &other));
+    AT(fingerprint == other);
+    dvz_drp2_stream_destroy(b);
+
+    /* Small unversioned payloads are hashed. */
+    payload[3] = 5;
+    b = _fingerprint_stream(payload, 3);
+    ANN(b);
+    AT(dvz_drp2_stream_fingerprint(b, &other));
+    AT(fingerprint != other);
+    dvz_drp2_stream_destroy(b);
+    dvz_drp2_stream_destroy(a);
+
+    /* Large payloads are identified by their declared version and never read. */
+    a = _versioned_stream(payload, 0);
+    ANN(a);
+    AT(!dvz_drp2_stream_fingerprint(a, &fingerprint));
+    dvz_drp2_stream_destroy(a);
+
+    a = _versioned_stream(payload, 7);
+    ANN(a);
+    AT(dvz_drp2_stream_fingerprint(a, &fingerprint));
+    payload[100] = 9;
+    b = _versioned_stream(payload, 7);
+    ANN(b);
+    AT(dvz_drp2_stream_fingerprint(b, &other));
+    AT(fingerprint == other);
+    dvz_drp2_stream_destroy(b);
+
+    b = _versioned_stream(payload, 8);
+    ANN(b);
+    AT(dvz_drp2_stream_fingerprint(b, &other));
+    AT(fingerprint != other);
+
+    /* Versions only attach to writes, and appending more commands keeps folding. */
+    AT(dvz_drp2_stream_begin_command_encoder(b, 30));
+    AT(!dvz_drp2_stream_set_payload_version(b, 9));
+    uint64_t extended = 0;
+    AT(dvz_drp2_stream_fingerprint(b, &extended));
+    AT(extended != other);
+    dvz_drp2_stream_destroy(b);
+    dvz_drp2_stream_destroy(a);
+
+    AT(!dvz_drp2_stream_fingerprint(NULL, &fingerprint));
+    return 0;
+}
+
+
+
 int test_drp2_write_buffer_bytes_large_json_roundtrip(TstContext* suite, const TstCase* item)
 {
     ANN(suite);
@@ -105,6 +105,8 @@ int test_drp2(TstSuite* suite)
     TST_CASE(test_drp2_packet_phase_split_roundtrip);
     TST_CASE(test_drp2_packet_shader_module_roundtrip);
     TST_CASE(test_drp2_packet_rejects_empty_shader_module_fields);
+    TST_CASE(test_drp2_packet_fingerprint);
+    TST_CASE(test_drp2_stream_fingerprint);
     TST_CASE(test_drp2_write_buffer_bytes_large_json_roundtrip);
     TST_CASE(test_drp2_render_pipeline_step_modes_json);
     TST_CASE(test_drp2_render_pipeline_rejects_vertex_layout_overflow);
@@ -161,6 +163,8 @@ int test_drp2(TstSuite* suite)
     TST_CASE(test_drp2_runtime_validate_indexed_render_stream);
     TST_CASE(test_drp2_runtime_rejects_draw_indexed_without_index_buffer);
     TST_CASE(test_drp2_runtime_rejects_wrong_index_buffer_usage);
+    TST_CASE(test_drp2_runtime_validate_indirect_stream);
+    TST_CASE(test_drp2_runtime_rejects_invalid_indirect_args);
     TST_CASE(test_drp2_runtime_validate_write_texture);
     TST_CASE(test_drp2_runtime_validate_write_texture_3d_formats);
     TST_CASE(test_drp2_runtime_rejects_write_texture_format_row_layout);
@@ -203,6 +207,7 @@ int test_drp2(TstSuite* suite)
 #if DVZ_DRP2_HAS_VKLITE
     TST_CASE(test_drp2_runtime_vklite_deferred_destroy_flush);
     TST_CASE(test_drp2_runtime_vklite_trims_destroyed_tail_slots);
+    TST_CASE(test_drp2_runtime_vklite_bundles_forget_owned_primary);
 #endif
     TST_DRP2_GPU_CASE(test_drp2_runtime_download_buffer_rejects_out_of_range);
 #if DVZ_DRP2_HAS_VKLITE
@@ -216,6 +221,9 @@ int test_drp2(TstSuite* suite)
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_writes_texture_contents);
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_copies_buffer_to_texture);
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_copies_texture_to_texture);
+    TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_async_transfers_match_sync);
+    TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_recycles_bind_group_descriptors);
+    TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_binds_dynamic_uniform_offsets);
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_creates_glsl_shader_modules);
     TST_DRP2_GPU_CASE(test_drp2_runtime_vklite_rejects_invalid_glsl_shader);
     TST_DRP2_GPU_CASE(test_drp2_runtime_vklite_rejects_pipeline_with_failed_shader);
@@ -223,6 +231,7 @@ int test_drp2(TstSuite* suite)
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_creates_render_pipeline);
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_reallocates_object_table_safely);
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_draws_render_pass);
+    TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_replays_pass_bundle);
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_render_area_independent_from_viewport);
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_draws_named_depth_render_pass);
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_draws_msaa_resolve_render_pass);
@@ -237,6 +246,7 @@ int test_drp2(TstSuite* suite)
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_refreshes_bind_group_after_texture_recreate);
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_refreshes_bind_group_after_buffer_sampler_recreate);
     TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_refresh_defers_retired_descriptors);
+    TST_DRP2_SHARED_GPU_CASE(test_drp2_runtime_vklite_evicts_textures_over_budget);
 #if DVZ_HAS_CUDA
     // CUDA selects a device by UUID; exclude it from index-selected GPU campaigns.
     TST_DRP2_GPU_EXEMPT_CASE(test_drp2_runtime_vklite_draws_cuda_external_vertex_buffer);
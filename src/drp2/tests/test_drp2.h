@@ -54,6 +54,10 @@ int test_drp2_packet_shader_module_roundtrip(TstContext* suite, const TstCase* i
 
 int test_drp2_packet_rejects_empty_shader_module_fields(TstContext* suite, const TstCase* item);
 
+int test_drp2_packet_fingerprint(TstContext* suite, const TstCase* item);
+
+int test_drp2_stream_fingerprint(TstContext* suite, const TstCase* item);
+
 int test_drp2_render_pipeline_step_modes_json(TstContext* suite, const TstCase* item);
 int test_drp2_render_pipeline_rejects_vertex_layout_overflow(
     TstContext* suite, const TstCase* item);
@@ -113,6 +117,10 @@ int test_drp2_runtime_rejects_draw_indexed_without_index_buffer(TstContext* suit
 
 int test_drp2_runtime_rejects_wrong_index_buffer_usage(TstContext* suite, const TstCase* item);
 
+int test_drp2_runtime_validate_indirect_stream(TstContext* suite, const TstCase* item);
+
+int test_drp2_runtime_rejects_invalid_indirect_args(TstContext* suite, const TstCase* item);
+
 int test_drp2_runtime_validate_write_texture(TstContext* suite, const TstCase* item);
 
 int test_drp2_runtime_validate_write_texture_3d_formats(TstContext* suite, const TstCase* item);
@@ -201,6 +209,8 @@ int test_drp2_runtime_frame_lifecycle_edge_cases(TstContext* suite, const TstCas
 int test_drp2_runtime_vklite_deferred_destroy_flush(TstContext* suite, const TstCase* item);
 
 int test_drp2_runtime_vklite_trims_destroyed_tail_slots(TstContext* suite, const TstCase* item);
+
+int test_drp2_runtime_vklite_bundles_forget_owned_primary(TstContext* suite, const TstCase* item);
 #endif
 
 int test_drp2_runtime_download_buffer_rejects_out_of_range(TstContext* suite, const TstCase* item);
@@ -228,6 +238,12 @@ int test_drp2_runtime_vklite_copies_buffer_to_texture(TstContext* suite, const T
 
 int test_drp2_runtime_vklite_copies_texture_to_texture(TstContext* suite, const TstCase* item);
 
+int test_drp2_runtime_vklite_async_transfers_match_sync(TstContext* suite, const TstCase* item);
+int test_drp2_runtime_vklite_recycles_bind_group_descriptors(
+    TstContext* suite, const TstCase* item);
+
+int test_drp2_runtime_vklite_binds_dynamic_uniform_offsets(TstContext* suite, const TstCase* item);
+
 int test_drp2_runtime_vklite_creates_glsl_shader_modules(TstContext* suite, const TstCase* item);
 
 int test_drp2_runtime_vklite_creates_render_pipeline(TstContext* suite, const TstCase* item);
@@ -242,6 +258,8 @@ int test_drp2_runtime_vklite_reallocates_object_table_safely(TstContext* suite,
 
 int test_drp2_runtime_vklite_draws_render_pass(TstContext* suite, const TstCase* item);
 
+int test_drp2_runtime_vklite_replays_pass_bundle(TstContext* suite, const TstCase* item);
+
 int test_drp2_runtime_vklite_render_area_independent_from_viewport(
     TstContext* suite, const TstCase* item);
 
@@ -275,6 +293,8 @@ int test_drp2_runtime_vklite_refreshes_bind_group_after_buffer_sampler_recreate(
 
 int test_drp2_runtime_vklite_refresh_defers_retired_descriptors(
     TstContext* suite, const TstCase* item);
+
+int test_drp2_runtime_vklite_evicts_textures_over_budget(TstContext* suite, const TstCase* item);
 #endif
 
 
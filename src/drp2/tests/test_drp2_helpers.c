@@ -104,6 +104,10 @@ typedef struct
 static DvzGpuCtxConfig _drp2_vklite_gpu_ctx_config(const TstSuite* suite)
 {
     DvzGpuCtxConfig gpu_cfg = dvz_testing_suite_gpu_ctx_config(suite);
+    VkPhysicalDeviceVulkan12Features features12 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    features12.timelineSemaphore = true;
+    dvz_gpu_ctx_config_features12(&gpu_cfg, &features12);
     VkPhysicalDeviceVulkan13Features features13 = {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
     features13.dynamicRendering = true;
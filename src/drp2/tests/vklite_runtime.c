@@ -24,6 +24,7 @@
 #include "_alloc.h"
 #include "_assertions.h"
 #include "../_stream.h"
+#include "datoviz/common/functions.h"
 #include "datoviz/drp2.h"
 #include "datoviz_testing.h"
 #include "test_drp2.h"
@@ -1102,6 +1103,257 @@ int test_drp2_runtime_vklite_copies_texture_to_texture(TstContext* suite, const
 
 
 
+/**
+ * Chain per-texel texture writes, a texture-to-buffer copy, a buffer-to-buffer copy, and a host
+ * write into the copied buffer, then return the downloaded result.
+ *
+ * @param runtime the vklite runtime
+ * @param out downloaded 16-byte result
+ * @return whether the stream executed and the download succeeded
+ */
+static bool _drp2_transfer_chain(DvzDrp2Runtime* runtime, uint8_t out[16])
+{
+    uint8_t texels[4][4] = {{0}};
+    DvzDrp2CommandStream* stream = dvz_drp2_stream();
+    ANN(stream);
+    AT(dvz_drp2_stream_hello_renderer(stream, "test-client"));
+    AT(dvz_drp2_stream_renderer_hello_reply(stream, "test-renderer"));
+    AT(dvz_drp2_stream_create_texture_2d_usage(
+        stream, 1, 2, 2, DVZ_DRP2_TEXTURE_USAGE_COPY_DST | DVZ_DRP2_TEXTURE_USAGE_COPY_SRC));
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        for (uint32_t c = 0; c < 4; c++)
+            texels[i][c] = (uint8_t)(4 * i + c + 1);
+        AT(dvz_drp2_stream_write_texture_2d_region_borrowed(
+            stream, 1, 0, i % 2, i / 2, 1, 1, 4, 1, texels[i]));
+    }
+    AT(dvz_drp2_stream_create_buffer(
+        stream, 2, 16, DVZ_DRP2_BUFFER_USAGE_COPY_DST | DVZ_DRP2_BUFFER_USAGE_COPY_SRC |
+                           DVZ_DRP2_BUFFER_USAGE_MAP_WRITE));
+    AT(dvz_drp2_stream_create_buffer(
+        stream, 3, 16, DVZ_DRP2_BUFFER_USAGE_COPY_DST | DVZ_DRP2_BUFFER_USAGE_MAP_READ));
+    AT(dvz_drp2_stream_begin_command_encoder(stream, 10));
+    AT(dvz_drp2_stream_copy_texture_to_buffer(stream, 10, 1, 2, 0, 2, 2, 8, 2));
+    AT(dvz_drp2_stream_copy_buffer_to_buffer(stream, 10, 2, 0, 3, 0, 16));
+    AT(dvz_drp2_stream_finish_command_encoder(stream, 10, 11));
+    AT(dvz_drp2_stream_queue_submit(stream, 11, 12));
+
+    // The host write into buffer 2 must wait for the copy that reads it.
+    uint8_t zeros[16] = {0};
+    AT(dvz_drp2_stream_write_buffer_bytes(stream, 2, 0, sizeof(zeros), zeros));
+
+    DvzDrp2ValidationResult result = dvz_drp2_runtime_execute(runtime, stream);
+    dvz_drp2_stream_destroy(stream);
+    return result.ok && _dvz_drp2_runtime_vklite_download_buffer(runtime, 3, 0, 16, out);
+}
+
+
+
+int test_drp2_runtime_vklite_async_transfers_match_sync(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzGpuCtx* ctx = NULL;
+    DvzDrp2Runtime* runtime = drp2_test_vklite_fixture_runtime(suite, &ctx);
+    if (runtime == NULL)
+        return 0;
+    ANN(ctx);
+
+    uint8_t async_bytes[16] = {0};
+    AT(_drp2_transfer_chain(runtime, async_bytes));
+    AT(drp2_test_vklite_validation_clean(suite, ctx));
+    if (dvz_device_features12(dvz_gpu_ctx_device(ctx))->timelineSemaphore)
+    {
+        AT(runtime->vklite_state->transfer_timeline != NULL);
+        AT(runtime->vklite_state->transfer_submitted >= 6);
+    }
+    dvz_drp2_runtime_reset(runtime);
+
+    uint8_t sync_bytes[16] = {0};
+    _dvz_drp2_runtime_async_transfers(runtime, false);
+    AT(_drp2_transfer_chain(runtime, sync_bytes));
+    _dvz_drp2_runtime_async_transfers(runtime, true);
+    AT(drp2_test_vklite_validation_clean(suite, ctx));
+    AT(runtime->vklite_state->transfer_timeline == NULL);
+    dvz_drp2_runtime_reset(runtime);
+
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        AT(async_bytes[i] == i + 1);
+        AT(sync_bytes[i] == async_bytes[i]);
+    }
+    return 0;
+}
+
+
+
+/**
+ * Create and destroy 100k bind groups in batches and check their descriptor sets are recycled
+ * from a bounded number of pools.
+ *
+ * @param suite test suite
+ * @param item test item
+ * @return 0 on success
+ */
+int test_drp2_runtime_vklite_recycles_bind_group_descriptors(
+    TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzGpuCtx* ctx = NULL;
+    DvzDrp2Runtime* runtime = drp2_test_vklite_fixture_runtime(suite, &ctx);
+    if (runtime == NULL)
+        return 0;
+    ANN(ctx);
+
+    DvzDrp2CommandStream* setup = dvz_drp2_stream();
+    ANN(setup);
+    AT(dvz_drp2_stream_hello_renderer(setup, "test-client"));
+    AT(dvz_drp2_stream_renderer_hello_reply(setup, "test-renderer"));
+    AT(dvz_drp2_stream_create_uniform_bind_group_layout(setup, 1));
+    AT(dvz_drp2_stream_create_buffer(setup, 2, 256, DVZ_DRP2_BUFFER_USAGE_UNIFORM));
+    AT(dvz_drp2_runtime_execute(runtime, setup).ok);
+    dvz_drp2_stream_destroy(setup);
+
+    const uint32_t batch = 100;
+    const uint32_t rounds = 1000;
+    uint64_t start = dvz_time_monotonic_ns();
+    for (uint32_t round = 0; round < rounds; round++)
+    {
+        DvzDrp2CommandStream* stream = dvz_drp2_stream();
+        ANN(stream);
+        for (uint32_t i = 0; i < batch; i++)
+            AT(dvz_drp2_stream_create_uniform_bind_group(stream, 100 + i, 1, 2, 0, 16));
+        for (uint32_t i = 0; i < batch; i++)
+            AT(dvz_drp2_stream_destroy_bind_group(stream, 100 + i));
+        AT(dvz_drp2_runtime_execute(runtime, stream).ok);
+        dvz_drp2_stream_destroy(stream);
+    }
+    double seconds = (double)(dvz_time_monotonic_ns() - start) * 1e-9;
+    log_info(
+        "created and destroyed %u bind groups in %.3f s (%.0f bind groups/s)", batch * rounds,
+        seconds, seconds > 0 ? batch * rounds / seconds : 0.0);
+    AT(drp2_test_vklite_validation_clean(suite, ctx));
+
+    // One chain for the layout; the first batch fills pools of 16, 32, and 64 set groups.
+    DvzDescriptorAllocatorStats stats =
+        dvz_descriptor_allocator_stats(runtime->vklite_state->descriptor_allocator);
+    AT(stats.layout_count == 1);
+    AT(stats.pool_count == 3);
+    AT(stats.live_groups == 0);
+    AT(stats.free_groups == batch);
+    AT(stats.allocations == (uint64_t)batch * rounds);
+    AT(stats.recycled == (uint64_t)batch * (rounds - 1));
+    AT(runtime->vklite_state->bind_ref_count == 0);
+
+    // Destroying the layout drops its chain and pools.
+    DvzDrp2CommandStream* teardown = dvz_drp2_stream();
+    ANN(teardown);
+    AT(dvz_drp2_stream_destroy_bind_group_layout(teardown, 1));
+    AT(dvz_drp2_runtime_execute(runtime, teardown).ok);
+    dvz_drp2_stream_destroy(teardown);
+    stats = dvz_descriptor_allocator_stats(runtime->vklite_state->descriptor_allocator);
+    AT(stats.layout_count == 0);
+    AT(stats.pool_count == 0);
+
+    dvz_drp2_runtime_reset(runtime);
+    return 0;
+}
+
+
+
+/**
+ * Check that dynamic offsets select uniform slices and reach Vulkan in binding order.
+ *
+ * @param suite test suite
+ * @param item test item
+ * @return 0 on success
+ */
+int test_drp2_runtime_vklite_binds_dynamic_uniform_offsets(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzGpuCtx* ctx = NULL;
+    DvzDrp2Runtime* runtime = drp2_test_vklite_fixture_runtime(suite, &ctx);
+    if (runtime == NULL)
+        return 0;
+    ANN(ctx);
+
+    // Layout entries list binding 1 before binding 0, so offsets arrive out of binding order.
+    DvzDrp2BindGroupLayoutEntry layout[2] = {0};
+    DvzDrp2BindGroupEntry entries[2] = {0};
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        layout[i].binding = 1 - i;
+        layout[i].binding_type = DVZ_DRP2_BINDING_TYPE_UNIFORM_BUFFER;
+        layout[i].visibility = DVZ_DRP2_SHADER_STAGE_FRAGMENT;
+        layout[i].access = DVZ_DRP2_BINDING_ACCESS_READ;
+        layout[i].has_dynamic_offset = true;
+        entries[i].binding = 1 - i;
+        entries[i].binding_type = DVZ_DRP2_BINDING_TYPE_UNIFORM_BUFFER;
+        entries[i].resource_kind = DVZ_DRP2_BINDING_RESOURCE_BUFFER;
+        entries[i].resource_id = 5;
+        entries[i].size = 16;
+    }
+    float ring[192] = {0};
+    ring[64] = 1.0f; // first float of the 256-byte slot 1
+    uint64_t offsets[2] = {256, 512};
+
+    DvzDrp2CommandStream* stream = dvz_drp2_stream();
+    ANN(stream);
+    AT(dvz_drp2_stream_hello_renderer(stream, "test-client"));
+    AT(dvz_drp2_stream_renderer_hello_reply(stream, "test-renderer"));
+    AT(dvz_drp2_stream_create_shader_module_format(
+        stream, 1, "VERTEX", "glsl",
+        "#version 450\nvec2 p[3]=vec2[](vec2(-1,-1),vec2(3,-1),vec2(-1,3));"
+        "void main(){gl_Position=vec4(p[gl_VertexIndex],0,1);}"));
+    AT(dvz_drp2_stream_create_shader_module_format(
+        stream, 2, "FRAGMENT", "glsl",
+        "#version 450\nlayout(set=0,binding=0)uniform A{vec4 a;};"
+        "layout(set=0,binding=1)uniform B{vec4 b;};layout(location=0)out vec4 color;"
+        "void main(){color=vec4(a.x,b.x,0,1);}"));
+    AT(dvz_drp2_stream_create_bind_group_layout_entries(stream, 3, 2, layout));
+    AT(drp2_test_create_render_pipeline_with_bind_group_layout(stream, 4, 1, 2, 0, 3));
+    AT(dvz_drp2_stream_create_buffer(
+        stream, 5, sizeof(ring), DVZ_DRP2_BUFFER_USAGE_UNIFORM | DVZ_DRP2_BUFFER_USAGE_COPY_DST));
+    AT(dvz_drp2_stream_write_buffer_bytes(stream, 5, 0, sizeof(ring), ring));
+    AT(dvz_drp2_stream_create_bind_group_entries(stream, 6, 3, 2, entries));
+    AT(dvz_drp2_stream_create_texture_2d_usage(
+        stream, 7, 2, 2,
+        DVZ_DRP2_TEXTURE_USAGE_RENDER_ATTACHMENT | DVZ_DRP2_TEXTURE_USAGE_COPY_SRC));
+    AT(dvz_drp2_stream_create_buffer(
+        stream, 8, 4, DVZ_DRP2_BUFFER_USAGE_COPY_DST | DVZ_DRP2_BUFFER_USAGE_MAP_READ));
+    AT(dvz_drp2_stream_begin_command_encoder(stream, 10));
+    AT(dvz_drp2_stream_begin_render_pass(stream, 11, 10, 7));
+    AT(dvz_drp2_stream_set_pipeline(stream, 11, 4));
+    AT(dvz_drp2_stream_set_bind_group_dynamic(stream, 11, 0, 6, 2, offsets));
+    AT(dvz_drp2_stream_draw(stream, 11, 3, 1, 0, 0));
+    AT(dvz_drp2_stream_end_render_pass(stream, 11));
+    AT(dvz_drp2_stream_copy_texture_to_buffer(stream, 10, 7, 8, 0, 1, 1, 4, 1));
+    AT(dvz_drp2_stream_finish_command_encoder(stream, 10, 12));
+    AT(dvz_drp2_stream_queue_submit(stream, 12, 13));
+
+    DvzDrp2ValidationResult result = dvz_drp2_runtime_execute(runtime, stream);
+    AT(result.ok);
+    AT(drp2_test_vklite_validation_clean(suite, ctx));
+
+    // Binding 1 reads slot 1 (1.0) and binding 0 reads slot 2 (0.0).
+    uint8_t downloaded[4] = {0};
+    AT(_dvz_drp2_runtime_vklite_download_buffer(runtime, 8, 0, 4, downloaded));
+    AT(downloaded[0] == 0);
+    AT(downloaded[1] == 255);
+    AT(downloaded[3] == 255);
+
+    dvz_drp2_stream_destroy(stream);
+    dvz_drp2_runtime_reset(runtime);
+    return 0;
+}
+
+
+
 int test_drp2_runtime_vklite_creates_glsl_shader_modules(TstContext* suite, const TstCase* item)
 {
     ANN(suite);
@@ -1458,6 +1710,83 @@ int test_drp2_runtime_vklite_draws_render_pass(TstContext* suite, const TstCase*
 
 
 
+int test_drp2_runtime_vklite_replays_pass_bundle(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzGpuCtx* ctx = NULL;
+    DvzDrp2Runtime* runtime = drp2_test_vklite_fixture_runtime(suite, &ctx);
+    if (runtime == NULL)
+        return 0;
+    ANN(ctx);
+
+    DvzDrp2CommandStream* setup = dvz_drp2_stream();
+    ANN(setup);
+    AT(dvz_drp2_stream_hello_renderer(setup, "test-client"));
+    AT(dvz_drp2_stream_renderer_hello_reply(setup, "test-renderer"));
+    AT(dvz_drp2_stream_create_shader_module_format(
+        setup, 1, "VERTEX", "glsl",
+        "#version 450\nvec2 p[3]=vec2[](vec2(-1,-1),vec2(3,-1),vec2(-1,3));"
+        "void main(){gl_Position=vec4(p[gl_VertexIndex],0,1);}"));
+    AT(dvz_drp2_stream_create_shader_module_format(
+        setup, 2, "FRAGMENT", "glsl",
+        "#version 450\nlayout(location=0)out vec4 color;void main(){color=vec4(1.0);}"));
+    AT(drp2_test_create_render_pipeline(setup, 3, 1, 2, 0));
+    AT(dvz_drp2_stream_create_texture_2d_usage(
+        setup, 4, 2, 2,
+        DVZ_DRP2_TEXTURE_USAGE_RENDER_ATTACHMENT | DVZ_DRP2_TEXTURE_USAGE_COPY_SRC));
+    AT(dvz_drp2_stream_create_buffer(
+        setup, 5, 4, DVZ_DRP2_BUFFER_USAGE_COPY_DST | DVZ_DRP2_BUFFER_USAGE_MAP_READ));
+    AT(dvz_drp2_stream_create_buffer(setup, 6, 16, DVZ_DRP2_BUFFER_USAGE_VERTEX));
+    AT(dvz_drp2_runtime_execute(runtime, setup).ok);
+
+    /* Frame 1 registers a candidate, frame 2 records the bundle, frame 3 replays it; a resource
+     * recreation before frame 4 invalidates it again. */
+    Drp2VkliteState* state = runtime->vklite_state;
+    ANN(state);
+    uint64_t expected_replays[4] = {0, 0, 1, 1};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        if (i == 3)
+        {
+            DvzDrp2CommandStream* recreate = dvz_drp2_stream();
+            ANN(recreate);
+            AT(dvz_drp2_stream_create_buffer(recreate, 6, 32, DVZ_DRP2_BUFFER_USAGE_VERTEX));
+            AT(dvz_drp2_runtime_execute(runtime, recreate).ok);
+            dvz_drp2_stream_destroy(recreate);
+        }
+
+        DvzDrp2CommandStream* frame = dvz_drp2_stream();
+        ANN(frame);
+        uint64_t pass_id = 20 + i;
+        AT(dvz_drp2_stream_begin_command_encoder(frame, 10));
+        AT(dvz_drp2_stream_begin_render_pass(frame, pass_id, 10, 4));
+        AT(dvz_drp2_stream_set_pipeline(frame, pass_id, 3));
+        AT(dvz_drp2_stream_draw(frame, pass_id, 3, 1, 0, 0));
+        AT(dvz_drp2_stream_end_render_pass(frame, pass_id));
+        AT(dvz_drp2_stream_copy_texture_to_buffer(frame, 10, 4, 5, 0, 1, 1, 4, 1));
+        AT(dvz_drp2_stream_finish_command_encoder(frame, 10, 12));
+        AT(dvz_drp2_stream_queue_submit(frame, 12, 13));
+
+        DvzDrp2ValidationResult result = dvz_drp2_runtime_execute(runtime, frame);
+        AT(result.ok);
+        AT(drp2_test_vklite_validation_clean(suite, ctx));
+        AT(state->bundle_replays == expected_replays[i]);
+
+        uint8_t downloaded[4] = {0};
+        AT(_dvz_drp2_runtime_vklite_download_buffer(runtime, 5, 0, 4, downloaded));
+        AT(downloaded[0] == 255);
+        AT(downloaded[3] == 255);
+        dvz_drp2_stream_destroy(frame);
+    }
+
+    dvz_drp2_stream_destroy(setup);
+    return 0;
+}
+
+
+
 int test_drp2_runtime_vklite_render_area_independent_from_viewport(
     TstContext* suite, const TstCase* item)
 {
@@ -2939,6 +3268,165 @@ int test_drp2_runtime_vklite_refresh_defers_retired_descriptors(
     dvz_drp2_stream_destroy(stream);
     return 0;
 }
+
+
+
+/**
+ * Draw a full-screen triangle sampling one bind group into target 10 and read back one texel.
+ *
+ * @param runtime the vklite runtime
+ * @param frames frames to start on the memory budget clock before the draw
+ * @param bind_group_id texture-sampler bind group to draw with
+ * @param base first id of the encoder, pass, and command buffer of this draw
+ * @param out first rendered texel
+ * @return whether the stream executed and the download succeeded
+ */
+static bool _drp2_budget_draw(
+    DvzDrp2Runtime* runtime, uint32_t frames, uint64_t bind_group_id, uint64_t base,
+    uint8_t out[4])
+{
+    for (uint32_t i = 0; i < frames; i++)
+        dvz_drp2_runtime_begin_frame(runtime);
+    DvzDrp2CommandStream* stream = dvz_drp2_stream();
+    if (stream == NULL)
+        return false;
+    bool ok = dvz_drp2_stream_begin_command_encoder(stream, base) &&
+              dvz_drp2_stream_begin_render_pass(stream, base + 1, base, 10) &&
+              dvz_drp2_stream_set_pipeline(stream, base + 1, 4) &&
+              dvz_drp2_stream_set_bind_group(stream, base + 1, 0, bind_group_id) &&
+              dvz_drp2_stream_draw(stream, base + 1, 3, 1, 0, 0) &&
+              dvz_drp2_stream_end_render_pass(stream, base + 1) &&
+              dvz_drp2_stream_copy_texture_to_buffer(stream, base, 10, 11, 0, 2, 2, 8, 2) &&
+              dvz_drp2_stream_finish_command_encoder(stream, base, base + 2) &&
+              dvz_drp2_stream_queue_submit(stream, base + 2, base + 3);
+    ok = ok && dvz_drp2_runtime_execute(runtime, stream).ok;
+    uint8_t texels[16] = {0};
+    ok = ok && _dvz_drp2_runtime_vklite_download_buffer(runtime, 11, 0, 16, texels);
+    dvz_drp2_stream_destroy(stream);
+    if (ok)
+        memcpy(out, texels, 4);
+    return ok;
+}
+
+
+
+/**
+ * Ensure a low memory budget evicts the least recently drawn texture once it is two frames old,
+ * and restores it on use.
+ *
+ * @param suite test suite
+ * @param item test item
+ * @return 0 on success
+ */
+int test_drp2_runtime_vklite_evicts_textures_over_budget(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzGpuCtx* ctx = NULL;
+    DvzDrp2Runtime* runtime = drp2_test_vklite_fixture_runtime(suite, &ctx);
+    if (runtime == NULL)
+        return 0;
+    ANN(ctx);
+
+    uint8_t red[16] = {0};
+    uint8_t green[16] = {0};
+    for (uint32_t i = 0; i < sizeof(red); i += 4)
+    {
+        red[i + 0] = 255;
+        red[i + 3] = 255;
+        green[i + 1] = 255;
+        green[i + 3] = 255;
+    }
+
+    DvzDrp2CommandStream* setup = dvz_drp2_stream();
+    ANN(setup);
+    AT(dvz_drp2_stream_hello_renderer(setup, "test-client"));
+    AT(dvz_drp2_stream_renderer_hello_reply(setup, "test-renderer"));
+    AT(dvz_drp2_stream_create_shader_module_format(
+        setup, 1, "VERTEX", "glsl",
+        "#version 450\nvec2 p[3]=vec2[](vec2(-1,-1),vec2(3,-1),vec2(-1,3));"
+        "void main(){gl_Position=vec4(p[gl_VertexIndex],0,1);}"));
+    AT(dvz_drp2_stream_create_shader_module_format(
+        setup, 2, "FRAGMENT", "glsl",
+        "#version 450\nlayout(set=0,binding=0)uniform texture2D tex;"
+        "layout(set=0,binding=1)uniform sampler samp;"
+        "layout(location=0)out vec4 color;"
+        "void main(){color=texture(sampler2D(tex,samp),vec2(0.5));}"));
+    AT(dvz_drp2_stream_create_texture_sampler_bind_group_layout(setup, 3));
+    AT(drp2_test_create_render_pipeline_with_bind_group_layout(setup, 4, 1, 2, 0, 3));
+    AT(dvz_drp2_stream_create_sampler(setup, 5));
+    AT(dvz_drp2_stream_create_texture_2d_usage(
+        setup, 6, 2, 2,
+        DVZ_DRP2_TEXTURE_USAGE_COPY_DST | DVZ_DRP2_TEXTURE_USAGE_TEXTURE_BINDING));
+    AT(dvz_drp2_stream_write_texture_2d_borrowed(setup, 6, 0, 2, 2, 8, 2, red));
+    AT(dvz_drp2_stream_create_texture_sampler_bind_group(setup, 7, 3, 6, 5));
+    AT(dvz_drp2_stream_create_texture_2d_usage(
+        setup, 8, 2, 2,
+        DVZ_DRP2_TEXTURE_USAGE_COPY_DST | DVZ_DRP2_TEXTURE_USAGE_TEXTURE_BINDING));
+    AT(dvz_drp2_stream_write_texture_2d_borrowed(setup, 8, 0, 2, 2, 8, 2, green));
+    AT(dvz_drp2_stream_create_texture_sampler_bind_group(setup, 9, 3, 8, 5));
+    AT(dvz_drp2_stream_create_texture_2d_usage(
+        setup, 10, 2, 2,
+        DVZ_DRP2_TEXTURE_USAGE_RENDER_ATTACHMENT | DVZ_DRP2_TEXTURE_USAGE_COPY_SRC));
+    AT(dvz_drp2_stream_create_buffer(
+        setup, 11, 16, DVZ_DRP2_BUFFER_USAGE_COPY_DST | DVZ_DRP2_BUFFER_USAGE_MAP_READ));
+
+    dvz_drp2_runtime_set_memory_owner(runtime, 1);
+    DvzDrp2ValidationResult result = dvz_drp2_runtime_execute(runtime, setup);
+    dvz_drp2_runtime_set_memory_owner(runtime, 0);
+    AT(result.ok);
+
+    // The render target is pinned, so 32 bytes leave room for one of the two sampled textures.
+    AT(dvz_drp2_runtime_set_memory_budget(runtime, 32));
+
+    DvzDrp2MemoryStats stats = {0};
+    uint8_t texel[4] = {0};
+    AT(_drp2_budget_draw(runtime, 2, 7, 20, texel));
+    AT(texel[0] == 255 && texel[1] == 0);
+    AT(dvz_drp2_runtime_memory_stats(runtime, 1, &stats));
+    AT(stats.budget == 32);
+    AT(stats.resident_bytes == 32);
+    AT(stats.host_bytes > 0);
+    AT(stats.evicted_bytes == 16);
+    AT(stats.evicted_count == 1);
+    AT(stats.eviction_count == 1);
+    AT(stats.restore_count == 0);
+
+    AT(_drp2_budget_draw(runtime, 2, 9, 30, texel));
+    AT(texel[0] == 0 && texel[1] == 255);
+    AT(dvz_drp2_runtime_memory_stats(runtime, 1, &stats));
+    AT(stats.evicted_count == 1);
+    AT(stats.eviction_count == 2);
+    AT(stats.restore_count == 1);
+    AT(stats.restore_bytes == 16);
+
+    // A texture drawn during the previous frame stays resident, even over the budget.
+    AT(_drp2_budget_draw(runtime, 1, 7, 40, texel));
+    AT(texel[0] == 255 && texel[1] == 0);
+    AT(dvz_drp2_runtime_memory_stats(runtime, 1, &stats));
+    AT(stats.restore_count == 2);
+    AT(stats.evicted_count == 0);
+    AT(stats.eviction_count == 2);
+    AT(dvz_drp2_runtime_memory_stats(runtime, 2, &stats));
+    AT(stats.resident_bytes == 0 && stats.evicted_bytes == 0);
+
+    AT(_drp2_budget_draw(runtime, 2, 7, 50, texel));
+    AT(dvz_drp2_runtime_memory_stats(runtime, 1, &stats));
+    AT(stats.evicted_count == 1);
+    AT(stats.eviction_count == 3);
+
+    // Without a budget, the evicted texture stays in host memory until it is drawn again.
+    AT(dvz_drp2_runtime_set_memory_budget(runtime, 0));
+    AT(_drp2_budget_draw(runtime, 2, 9, 60, texel));
+    AT(texel[0] == 0 && texel[1] == 255);
+    AT(dvz_drp2_runtime_memory_stats(runtime, 0, &stats));
+    AT(stats.evicted_count == 0);
+    AT(drp2_test_vklite_validation_clean(suite, ctx));
+
+    dvz_drp2_stream_destroy(setup);
+    return 0;
+}
 #endif
 
 
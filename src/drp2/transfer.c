@@ -16,6 +16,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <volk.h>
 
@@ -24,6 +25,7 @@
 #include "_base64.h"
 #include "_runtime.h"
 #include "_stream.h"
+#include "datoviz/vk/device.h"
 #include "datoviz/vklite/sync.h"
 
 
@@ -273,7 +275,16 @@ void _vklite_transition_image_access(
 }
 
 
-static bool _vklite_create_staging_buffer(
+/**
+ * Create a host-visible buffer for staging uploads or holding host copies of device data.
+ *
+ * @param state vklite runtime state
+ * @param size buffer size in bytes
+ * @param[out] buffer created buffer, NULL on failure
+ * @param usage Vulkan buffer usage
+ * @return whether the buffer was created
+ */
+bool _vklite_create_staging_buffer(
     Drp2VkliteState* state, uint64_t size, DvzBuffer** buffer, VkBufferUsageFlags usage)
 {
     ANN(state);
@@ -300,6 +311,207 @@ static bool _vklite_create_staging_buffer(
 }
 
 
+/**
+ * Create the transfer timeline semaphore on first use.
+ *
+ * @param state vklite runtime state
+ * @return whether transfers can be submitted asynchronously
+ */
+static bool _vklite_transfer_timeline_ensure(Drp2VkliteState* state)
+{
+    ANN(state);
+    ANN(state->runtime);
+    if (state->runtime->sync_transfers)
+        return false;
+    if (state->transfer_timeline != NULL)
+        return true;
+    DvzDevice* device = state->runtime->device;
+    if (!dvz_device_features12(device)->timelineSemaphore)
+        return false;
+
+    DvzSemaphore* timeline = dvz_semaphore_create_wrapper();
+    if (timeline == NULL)
+        return false;
+    dvz_semaphore_timeline(device, state->transfer_submitted, timeline, 0);
+    state->transfer_timeline = timeline;
+    return true;
+}
+
+
+/**
+ * Begin recording an owned transfer command buffer.
+ *
+ * Transfers are submitted without waiting for earlier work, so the leading barrier orders them
+ * after every command submitted before on the same queue.
+ *
+ * @param cmds owned command-buffer wrapper
+ * @return 0 on success, non-zero on Vulkan or state failure
+ */
+int _vklite_transfer_begin(DvzCommands* cmds)
+{
+    ANN(cmds);
+    if (dvz_cmd_begin_result(cmds) != 0)
+        return 1;
+    DvzBarriers barriers = {0};
+    dvz_barriers(&barriers);
+    DvzBarrierMemory* barrier = dvz_barriers_memory(&barriers);
+    dvz_barrier_memory_stage(
+        barrier, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+    dvz_barrier_memory_access(
+        barrier, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+        VK_ACCESS_2_TRANSFER_READ_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT);
+    dvz_cmd_barriers(cmds, &barriers);
+    return 0;
+}
+
+
+/**
+ * Release one pending transfer.
+ *
+ * @param pending pending transfer whose command buffer has completed or was never submitted
+ */
+static void _vklite_transfer_release(Drp2PendingTransfer* pending)
+{
+    ANN(pending);
+    _vklite_owned_commands_destroy(pending->commands);
+    if (pending->staging != NULL)
+    {
+        dvz_buffer_destroy(pending->staging);
+        dvz_buffer_free(pending->staging);
+    }
+    dvz_memset(pending, sizeof(Drp2PendingTransfer), 0, sizeof(Drp2PendingTransfer));
+}
+
+
+/**
+ * End and submit a transfer command buffer, taking ownership of it and of its staging buffer.
+ *
+ * With a transfer timeline, the submission signals the next timeline value and returns
+ * immediately; the command buffer and staging buffer are released once that value is reached.
+ * Without one, the submission blocks as before and everything is released on return.
+ *
+ * @param state vklite runtime state
+ * @param cmds owned command-buffer wrapper started with `_vklite_transfer_begin()`
+ * @param staging optional owned staging buffer read by the transfer
+ * @param src optional source object stamped with the submission value
+ * @param dst optional destination object stamped with the submission value
+ * @param command_index command index used for validation reporting
+ * @return DRP2 validation result
+ */
+DvzDrp2ValidationResult _vklite_transfer_submit(
+    Drp2VkliteState* state, DvzCommands* cmds, DvzBuffer* staging, Drp2VkliteObject* src,
+    Drp2VkliteObject* dst, uint32_t command_index)
+{
+    ANN(state);
+    ANN(cmds);
+    Drp2PendingTransfer pending = {.commands = cmds, .staging = staging};
+
+    DvzBarriers barriers = {0};
+    dvz_barriers(&barriers);
+    DvzBarrierMemory* barrier = dvz_barriers_memory(&barriers);
+    dvz_barrier_memory_stage(
+        barrier, VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    dvz_barrier_memory_access(
+        barrier, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT);
+    dvz_cmd_barriers(cmds, &barriers);
+    if (dvz_cmd_end_result(cmds) != 0)
+    {
+        _vklite_transfer_release(&pending);
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    }
+
+    if (!_vklite_transfer_timeline_ensure(state))
+    {
+        int res = dvz_cmd_submit_result(cmds);
+        _vklite_transfer_release(&pending);
+        if (res != 0)
+            return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+        return _drp2_ok();
+    }
+
+    // Bound the number of in-flight transfers by waiting for the oldest one.
+    if (state->transfer_count == DVZ_DRP2_MAX_PENDING_TRANSFERS)
+        _vklite_transfer_wait(state, state->transfers[0].value);
+
+    pending.value = state->transfer_submitted + 1;
+    if (dvz_cmd_submit_async(cmds, state->transfer_timeline, pending.value) != 0)
+    {
+        _vklite_transfer_release(&pending);
+        return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+    }
+    state->transfer_submitted = pending.value;
+    state->transfers[state->transfer_count++] = pending;
+    if (src != NULL)
+        src->transfer_value = pending.value;
+    if (dst != NULL)
+        dst->transfer_value = pending.value;
+    return _drp2_ok();
+}
+
+
+/**
+ * Release the pending transfers whose timeline value has been reached, without blocking.
+ *
+ * @param state vklite runtime state
+ */
+void _vklite_transfer_retire(Drp2VkliteState* state)
+{
+    ANN(state);
+    if (state->transfer_timeline == NULL || state->transfer_count == 0)
+        return;
+    state->transfer_completed = dvz_semaphore_query(state->transfer_timeline);
+
+    uint32_t done = 0;
+    while (done < state->transfer_count &&
+           state->transfers[done].value <= state->transfer_completed)
+        _vklite_transfer_release(&state->transfers[done++]);
+    if (done == 0)
+        return;
+    state->transfer_count -= done;
+    memmove(
+        state->transfers, state->transfers + done,
+        state->transfer_count * sizeof(Drp2PendingTransfer));
+}
+
+
+/**
+ * Block until a transfer timeline value has been reached.
+ *
+ * This is a no-op for objects no pending transfer touches, so host accesses only wait for the
+ * transfers they actually depend on.
+ *
+ * @param state vklite runtime state
+ * @param value transfer timeline value, 0 for none
+ */
+void _vklite_transfer_wait(Drp2VkliteState* state, uint64_t value)
+{
+    ANN(state);
+    if (value == 0 || value <= state->transfer_completed || state->transfer_timeline == NULL)
+        return;
+    dvz_semaphore_wait(state->transfer_timeline, value);
+    _vklite_transfer_retire(state);
+}
+
+
+/**
+ * Wait for every pending transfer, release them, and destroy the transfer timeline.
+ *
+ * @param state vklite runtime state
+ */
+void _vklite_transfer_cleanup(Drp2VkliteState* state)
+{
+    ANN(state);
+    if (state->transfer_timeline == NULL)
+        return;
+    _vklite_transfer_wait(state, state->transfer_submitted);
+    ASSERT(state->transfer_count == 0);
+    dvz_semaphore_destroy(state->transfer_timeline);
+    dvz_semaphore_free(state->transfer_timeline);
+    state->transfer_timeline = NULL;
+}
+
+
 DvzDrp2ValidationResult _vklite_write_buffer(
     Drp2VkliteState* state, const DvzDrp2Command* command, uint32_t command_index)
 {
@@ -316,6 +528,8 @@ DvzDrp2ValidationResult _vklite_write_buffer(
     if (size == 0)
         return _drp2_ok();
 
+    // The host write must not race a pending copy that reads or writes this buffer.
+    _vklite_transfer_wait(state, object->transfer_value);
     if (command->u.write_buffer.data_raw != NULL)
     {
         dvz_buffer_upload(object->buffer, offset, size, command->u.write_buffer.data_raw);
@@ -392,7 +606,7 @@ DvzDrp2ValidationResult _vklite_write_texture(
         &region, command->u.write_texture.origin_x, command->u.write_texture.origin_y,
         command->u.write_texture.origin_z);
 
-    if (dvz_cmd_begin_result(cmds) != 0)
+    if (_vklite_transfer_begin(cmds) != 0)
     {
         _vklite_owned_commands_destroy(cmds);
         dvz_buffer_destroy(staging);
@@ -403,19 +617,7 @@ DvzDrp2ValidationResult _vklite_write_texture(
     dvz_cmd_copy_buffer_to_image(
         cmds, dvz_buffer_handle(staging), 0, dvz_image_handle(texture->images, 0),
         _vklite_texture_access_layout(DRP2_TEXTURE_ACCESS_TRANSFER_WRITE), &region);
-    DvzDrp2ValidationResult result = _vklite_owned_commands_end_submit(cmds, command_index);
-    if (!result.ok)
-    {
-        _vklite_owned_commands_destroy(cmds);
-        dvz_buffer_destroy(staging);
-        dvz_buffer_free(staging);
-        return result;
-    }
-
-    _vklite_owned_commands_destroy(cmds);
-    dvz_buffer_destroy(staging);
-    dvz_buffer_free(staging);
-    return _drp2_ok();
+    return _vklite_transfer_submit(state, cmds, staging, NULL, texture, command_index);
 }
 
 
@@ -438,7 +640,7 @@ DvzDrp2ValidationResult _vklite_copy_buffer_to_buffer(
     region.dstOffset = command->u.copy_buffer_to_buffer.dst_offset;
     region.size = command->u.copy_buffer_to_buffer.size;
 
-    if (dvz_cmd_begin_result(cmds) != 0)
+    if (_vklite_transfer_begin(cmds) != 0)
     {
         _vklite_owned_commands_destroy(cmds);
         return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
@@ -446,14 +648,7 @@ DvzDrp2ValidationResult _vklite_copy_buffer_to_buffer(
     vkCmdCopyBuffer(
         dvz_commands_handle(cmds), dvz_buffer_handle(src->buffer), dvz_buffer_handle(dst->buffer),
         1, &region);
-    DvzDrp2ValidationResult result = _vklite_owned_commands_end_submit(cmds, command_index);
-    if (!result.ok)
-    {
-        _vklite_owned_commands_destroy(cmds);
-        return result;
-    }
-    _vklite_owned_commands_destroy(cmds);
-    return _drp2_ok();
+    return _vklite_transfer_submit(state, cmds, NULL, src, dst, command_index);
 }
 
 
@@ -497,7 +692,8 @@ DvzDrp2ValidationResult _vklite_copy_buffer_to_texture(
         return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
     }
 
-    if (dvz_cmd_begin_result(cmds) != 0)
+    int begin = timeline_handoff ? dvz_cmd_begin_result(cmds) : _vklite_transfer_begin(cmds);
+    if (begin != 0)
     {
         _vklite_owned_commands_destroy(cmds);
         return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
@@ -532,46 +728,36 @@ DvzDrp2ValidationResult _vklite_copy_buffer_to_texture(
             buffer_barrier, VK_ACCESS_2_TRANSFER_READ_BIT, VK_ACCESS_2_NONE);
         dvz_cmd_barriers(cmds, &release);
     }
+    if (!timeline_handoff)
+        return _vklite_transfer_submit(state, cmds, NULL, src, dst, command_index);
 
+    // The external timeline handoff keeps its blocking submission.
     DvzDrp2ValidationResult result = _drp2_ok();
-    if (timeline_handoff)
+    DvzQueue* queue = dvz_device_queue(state->runtime->device, DVZ_QUEUE_MAIN);
+    DvzSubmit* submit = queue != NULL ? dvz_submit_create_wrapper() : NULL;
+    if (dvz_cmd_end_result(cmds) != 0 || submit == NULL)
     {
-        if (dvz_cmd_end_result(cmds) != 0)
-        {
-            result = _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
-        }
-        else
-        {
-            DvzQueue* queue = dvz_device_queue(state->runtime->device, DVZ_QUEUE_MAIN);
-            DvzSubmit* submit = queue != NULL ? dvz_submit_create_wrapper() : NULL;
-            if (submit == NULL)
-            {
-                result = _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
-            }
-            else
-            {
-                dvz_submit(submit);
-                dvz_submit_wait(
-                    submit, dvz_semaphore_handle(timeline_semaphore),
-                    semantic_src->external_timeline_wait_value, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
-                dvz_submit_command(submit, dvz_commands_handle(cmds));
-                dvz_submit_signal(
-                    submit, dvz_semaphore_handle(timeline_semaphore),
-                    semantic_src->external_timeline_signal_value, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
-                if (dvz_submit_send(submit, dvz_queue_handle(queue), VK_NULL_HANDLE) != VK_SUCCESS)
-                    result = _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
-                else
-                    dvz_queue_wait(queue);
-                dvz_submit_free(submit);
-            }
-        }
+        result = _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
     }
     else
     {
-        result = _vklite_owned_commands_end_submit(cmds, command_index);
+        dvz_submit(submit);
+        dvz_submit_wait(
+            submit, dvz_semaphore_handle(timeline_semaphore),
+            semantic_src->external_timeline_wait_value, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+        dvz_submit_command(submit, dvz_commands_handle(cmds));
+        dvz_submit_signal(
+            submit, dvz_semaphore_handle(timeline_semaphore),
+            semantic_src->external_timeline_signal_value, VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+        if (dvz_submit_send(submit, dvz_queue_handle(queue), VK_NULL_HANDLE) != VK_SUCCESS)
+            result = _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
+        else
+            dvz_queue_wait(queue);
     }
+    if (submit != NULL)
+        dvz_submit_free(submit);
 
-    if (result.ok && timeline_handoff)
+    if (result.ok)
     {
         src->external_timeline_pending = false;
         src->external_timeline_semaphore = NULL;
@@ -606,7 +792,7 @@ DvzDrp2ValidationResult _vklite_copy_texture_to_buffer(
         command->u.copy_texture_to_buffer.bytes_per_row,
         command->u.copy_texture_to_buffer.rows_per_image, bytes_per_texel);
 
-    if (dvz_cmd_begin_result(cmds) != 0)
+    if (_vklite_transfer_begin(cmds) != 0)
     {
         _vklite_owned_commands_destroy(cmds);
         return _drp2_fail(DVZ_DRP2_VALIDATION_INVALID_STATE, command_index);
@@ -616,15 +802,7 @@ DvzDrp2ValidationResult _vklite_copy_texture_to_buffer(
         cmds, dvz_image_handle(src->images, 0),
         _vklite_texture_access_layout(DRP2_TEXTURE_ACCESS_TRANSFER_READ), &region,
         dvz_buffer_handle(dst->buffer), command->u.copy_texture_to_buffer.dst_offset);
-    DvzDrp2ValidationResult result = _vklite_owned_commands_end_submit(cmds, command_index);
-    if (!result.ok)
-    {
-        _vklite_owned_commands_destroy(cmds);
-        return result;
-    }
-
-    _vklite_owned_commands_destroy(cmds);
-    return _drp2_ok();
+    return _vklite_transfer_submit(state, cmds, NULL, src, dst, command_index);
 }
 
 
@@ -663,7 +841,7 @@ DvzDrp2ValidationResult _vklite_copy_texture_to_texture(
         (int32_t)command->u.copy_texture_to_texture.dst_origin_y,
         (int32_t)command->u.copy_texture_to_texture.dst_origin_z);
 
-    if (dvz_cmd_begin_result(cmds) != 0)
+    if (_vklite_transfer_begin(cmds) != 0)
     {
         dvz_image_copy_free(copy);
         _vklite_owned_commands_destroy(cmds);
@@ -672,17 +850,8 @@ DvzDrp2ValidationResult _vklite_copy_texture_to_texture(
     _vklite_transition_image_access(cmds, src, DRP2_TEXTURE_ACCESS_TRANSFER_READ);
     _vklite_transition_image_access(cmds, dst, DRP2_TEXTURE_ACCESS_TRANSFER_WRITE);
     dvz_cmd_copy_image(cmds, copy);
-    DvzDrp2ValidationResult result = _vklite_owned_commands_end_submit(cmds, command_index);
-    if (!result.ok)
-    {
-        dvz_image_copy_free(copy);
-        _vklite_owned_commands_destroy(cmds);
-        return result;
-    }
-
     dvz_image_copy_free(copy);
-    _vklite_owned_commands_destroy(cmds);
-    return _drp2_ok();
+    return _vklite_transfer_submit(state, cmds, NULL, src, dst, command_index);
 }
 
 
@@ -0,0 +1,967 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  NumPy NPY/NPZ arrays                                                                         */
+/*************************************************************************************************/
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32) || defined(_MSC_VER)
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include "_alloc.h"
+#include "_assertions.h"
+#include "_log.h"
+#include "_overflow.h"
+#include "datoviz/fileio/npy.h"
+
+#if DVZ_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define NPY_PREFIX_SIZE    12
+#define NPY_MAX_HEADER     (1u << 20)
+#define ZIP_EOCD_SIZE      22
+#define ZIP_EOCD_SEARCH    (ZIP_EOCD_SIZE + 0xFFFF)
+#define ZIP_LOCAL_SIZE     30
+#define ZIP_CENTRAL_SIZE   46
+#define ZIP_MAX_DIRECTORY  (64u << 20)
+#define ZIP_SIG_LOCAL      0x04034b50u
+#define ZIP_SIG_CENTRAL    0x02014b50u
+#define ZIP_SIG_EOCD       0x06054b50u
+#define ZIP_SIG_EOCD64     0x06064b50u
+#define ZIP_SIG_EOCD64_LOC 0x07064b50u
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+struct DvzNpy
+{
+    DvzNpyInfo info;
+    FILE* file;
+    DvzSize data_offset; /* Absolute payload offset in the file. */
+
+    uint8_t* map;    /* Page-aligned mapping base, or NULL. */
+    DvzSize map_len; /* Mapping length in bytes. */
+#if defined(_WIN32) || defined(_MSC_VER)
+    HANDLE mapping;
+#endif
+
+    void* owned;         /* Inflated payload of a compressed NPZ entry, or NULL. */
+    const uint8_t* data; /* Payload, or NULL in streaming mode. */
+};
+
+
+
+/*************************************************************************************************/
+/*  Utils                                                                                        */
+/*************************************************************************************************/
+
+static int _npy_seek(FILE* file, DvzSize offset)
+{
+    if (offset > (DvzSize)INT64_MAX)
+        return -1;
+#if defined(_WIN32) || defined(_MSC_VER)
+    return _fseeki64(file, (int64_t)offset, SEEK_SET);
+#else
+    return fseeko(file, (off_t)offset, SEEK_SET);
+#endif
+}
+
+
+
+/**
+ * Read bytes at an absolute file offset.
+ *
+ * @param file open file
+ * @param offset byte offset
+ * @param dst destination buffer
+ * @param size number of bytes to read
+ * @return whether all bytes were read
+ */
+static bool _npy_pread(FILE* file, DvzSize offset, void* dst, size_t size)
+{
+    ANN(file);
+    if (size == 0)
+        return true;
+    if (_npy_seek(file, offset) != 0)
+        return false;
+    return fread(dst, 1, size, file) == size;
+}
+
+
+
+static DvzSize _npy_file_size(FILE* file)
+{
+    ANN(file);
+#if defined(_WIN32) || defined(_MSC_VER)
+    if (_fseeki64(file, 0, SEEK_END) != 0)
+        return 0;
+    int64_t size = _ftelli64(file);
+#else
+    if (fseeko(file, 0, SEEK_END) != 0)
+        return 0;
+    int64_t size = (int64_t)ftello(file);
+#endif
+    return size > 0 ? (DvzSize)size : 0;
+}
+
+
+
+static uint16_t _le16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+
+
+static uint32_t _le32(const uint8_t* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+
+
+static uint64_t _le64(const uint8_t* p)
+{
+    return (uint64_t)_le32(p) | ((uint64_t)_le32(p + 4) << 32);
+}
+
+
+
+static bool _native_little_endian(void)
+{
+    const uint16_t probe = 1;
+    return *(const uint8_t*)&probe == 1;
+}
+
+
+
+/**
+ * Return the OS granularity that mapping offsets must be aligned to.
+ *
+ * @return granularity in bytes
+ */
+static DvzSize _map_granularity(void)
+{
+#if defined(_WIN32) || defined(_MSC_VER)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (DvzSize)info.dwAllocationGranularity;
+#else
+    long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? (DvzSize)page : 4096;
+#endif
+}
+
+
+
+/*************************************************************************************************/
+/*  Header parsing                                                                               */
+/*************************************************************************************************/
+
+/**
+ * Find the value of a key in the NPY header dictionary.
+ *
+ * @param header header text
+ * @param end end of the header text
+ * @param key dictionary key without quotes
+ * @return pointer to the first non-space character after the colon, or NULL
+ */
+static const char* _npy_dict_value(const char* header, const char* end, const char* key)
+{
+    const size_t key_len = strlen(key);
+    for (const char* p = header; p + key_len + 2 <= end; p++)
+    {
+        if ((*p != '\'' && *p != '"') || memcmp(p + 1, key, key_len) != 0 || p[key_len + 1] != *p)
+            continue;
+        p += key_len + 2;
+        while (p < end && isspace((unsigned char)*p))
+            p++;
+        if (p >= end || *p != ':')
+            return NULL;
+        p++;
+        while (p < end && isspace((unsigned char)*p))
+            p++;
+        return p < end ? p : NULL;
+    }
+    return NULL;
+}
+
+
+
+static bool _npy_parse_descr(const char* p, const char* end, DvzNpyInfo* info)
+{
+    ANN(info);
+    if (p == NULL || (*p != '\'' && *p != '"'))
+        return false;
+    const char quote = *p++;
+    if (end - p < 3)
+        return false;
+
+    const char order = *p++;
+    const char kind = *p++;
+    if (order != '<' && order != '>' && order != '|' && order != '=')
+        return false;
+    uint32_t size = 0;
+    while (p < end && isdigit((unsigned char)*p) && size < 64)
+        size = size * 10 + (uint32_t)(*p++ - '0');
+    if (p >= end || *p != quote)
+        return false;
+
+    DvzNpyDtype dtype = DVZ_NPY_DTYPE_UNKNOWN;
+    switch (kind)
+    {
+    case 'b':
+        dtype = size == 1 ? DVZ_NPY_DTYPE_BOOL : DVZ_NPY_DTYPE_UNKNOWN;
+        break;
+    case 'i':
+        dtype = size == 1   ? DVZ_NPY_DTYPE_INT8
+                : size == 2 ? DVZ_NPY_DTYPE_INT16
+                : size == 4 ? DVZ_NPY_DTYPE_INT32
+                : size == 8 ? DVZ_NPY_DTYPE_INT64
+                            : DVZ_NPY_DTYPE_UNKNOWN;
+        break;
+    case 'u':
+        dtype = size == 1   ? DVZ_NPY_DTYPE_UINT8
+                : size == 2 ? DVZ_NPY_DTYPE_UINT16
+                : size == 4 ? DVZ_NPY_DTYPE_UINT32
+                : size == 8 ? DVZ_NPY_DTYPE_UINT64
+                            : DVZ_NPY_DTYPE_UNKNOWN;
+        break;
+    case 'f':
+        dtype = size == 2   ? DVZ_NPY_DTYPE_FLOAT16
+                : size == 4 ? DVZ_NPY_DTYPE_FLOAT32
+                : size == 8 ? DVZ_NPY_DTYPE_FLOAT64
+                            : DVZ_NPY_DTYPE_UNKNOWN;
+        break;
+    default:
+        break;
+    }
+    if (dtype == DVZ_NPY_DTYPE_UNKNOWN)
+        return false;
+
+    info->dtype = dtype;
+    info->item_size = size;
+    info->byte_swapped =
+        size > 1 && ((order == '<' && !_native_little_endian()) ||
+                     (order == '>' && _native_little_endian()));
+    return true;
+}
+
+
+
+static bool _npy_parse_shape(const char* p, const char* end, DvzNpyInfo* info)
+{
+    ANN(info);
+    if (p == NULL || *p != '(')
+        return false;
+    p++;
+    info->ndim = 0;
+    for (;;)
+    {
+        while (p < end && (isspace((unsigned char)*p) || *p == ','))
+            p++;
+        if (p >= end)
+            return false;
+        if (*p == ')')
+            return true;
+        if (!isdigit((unsigned char)*p) || info->ndim >= DVZ_NPY_MAX_NDIM)
+            return false;
+        uint64_t dim = 0;
+        while (p < end && isdigit((unsigned char)*p))
+        {
+            if (dim > (UINT64_MAX - 9) / 10)
+                return false;
+            dim = dim * 10 + (uint64_t)(*p++ - '0');
+        }
+        info->shape[info->ndim++] = dim;
+    }
+}
+
+
+
+int dvz_npy_parse_header(
+    const void* bytes, DvzSize size_bytes, DvzNpyInfo* info, DvzSize* data_offset)
+{
+    ANN(info);
+    if (bytes == NULL || size_bytes < 10)
+        return 1;
+    const uint8_t* b = (const uint8_t*)bytes;
+    if (memcmp(b, "\x93NUMPY", 6) != 0)
+        return 1;
+
+    DvzSize header_start = 0;
+    DvzSize header_len = 0;
+    if (b[6] == 1)
+    {
+        header_start = 10;
+        header_len = _le16(b + 8);
+    }
+    else if ((b[6] == 2 || b[6] == 3) && size_bytes >= 12)
+    {
+        header_start = 12;
+        header_len = _le32(b + 8);
+    }
+    else
+    {
+        return 1;
+    }
+    if (header_len == 0 || header_len > NPY_MAX_HEADER || header_start + header_len > size_bytes)
+        return 1;
+
+    DvzNpyInfo parsed = {0};
+    const char* header = (const char*)b + header_start;
+    const char* end = header + header_len;
+    if (!_npy_parse_descr(_npy_dict_value(header, end, "descr"), end, &parsed))
+        return 1;
+    const char* fortran = _npy_dict_value(header, end, "fortran_order");
+    if (fortran == NULL)
+        return 1;
+    parsed.fortran_order = end - fortran >= 4 && memcmp(fortran, "True", 4) == 0;
+    if (!_npy_parse_shape(_npy_dict_value(header, end, "shape"), end, &parsed))
+        return 1;
+
+    uint64_t row_items = 1;
+    for (uint32_t i = 1; i < parsed.ndim; i++)
+        if (_dvz_mul_u64_overflows(row_items, parsed.shape[i], &row_items))
+            return 1;
+    parsed.row_count = parsed.ndim > 0 ? parsed.shape[0] : 1;
+    if (_dvz_mul_u64_overflows(row_items, parsed.item_size, &parsed.row_size) ||
+        _dvz_mul_u64_overflows(parsed.row_size, parsed.row_count, &parsed.data_size))
+        return 1;
+
+    *info = parsed;
+    if (data_offset != NULL)
+        *data_offset = header_start + header_len;
+    return 0;
+}
+
+
+
+/*************************************************************************************************/
+/*  Mapping                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Map the payload of an opened array read-only.
+ *
+ * @param npy the array, with its file and payload offset set
+ * @return whether the payload was mapped
+ */
+static bool _npy_map(DvzNpy* npy)
+{
+    ANN(npy);
+    ANN(npy->file);
+
+    static const uint8_t empty = 0;
+    if (npy->info.data_size == 0)
+    {
+        npy->data = &empty;
+        return true;
+    }
+
+    const DvzSize granularity = _map_granularity();
+    const DvzSize map_offset = npy->data_offset - npy->data_offset % granularity;
+    const DvzSize delta = npy->data_offset - map_offset;
+    if (npy->info.data_size > (DvzSize)SIZE_MAX - delta)
+        return false;
+    const DvzSize map_len = delta + npy->info.data_size;
+
+#if defined(_WIN32) || defined(_MSC_VER)
+    HANDLE handle = (HANDLE)_get_osfhandle(_fileno(npy->file));
+    if (handle == INVALID_HANDLE_VALUE)
+        return false;
+    HANDLE mapping = CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL)
+        return false;
+    void* base = MapViewOfFile(
+        mapping, FILE_MAP_READ, (DWORD)(map_offset >> 32), (DWORD)(map_offset & 0xFFFFFFFFu),
+        (SIZE_T)map_len);
+    if (base == NULL)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+    npy->mapping = mapping;
+#else
+    void* base = mmap(
+        NULL, (size_t)map_len, PROT_READ, MAP_PRIVATE, fileno(npy->file), (off_t)map_offset);
+    if (base == MAP_FAILED)
+        return false;
+#endif
+
+    npy->map = (uint8_t*)base;
+    npy->map_len = map_len;
+    npy->data = npy->map + delta;
+    return true;
+}
+
+
+
+static void _npy_unmap(DvzNpy* npy)
+{
+    ANN(npy);
+    if (npy->map == NULL)
+        return;
+#if defined(_WIN32) || defined(_MSC_VER)
+    UnmapViewOfFile(npy->map);
+    CloseHandle(npy->mapping);
+    npy->mapping = NULL;
+#else
+    munmap(npy->map, (size_t)npy->map_len);
+#endif
+    npy->map = NULL;
+    npy->map_len = 0;
+}
+
+
+
+/**
+ * Apply an madvise() hint to the pages covering a payload byte range.
+ *
+ * @param npy the array
+ * @param offset payload byte offset
+ * @param size byte count
+ * @param advice madvise() advice
+ * @param inner whether to only cover pages fully inside the range
+ */
+static void _npy_madvise(DvzNpy* npy, DvzSize offset, DvzSize size, int advice, bool inner)
+{
+    ANN(npy);
+#if defined(_WIN32) || defined(_MSC_VER)
+    (void)offset;
+    (void)size;
+    (void)advice;
+    (void)inner;
+#else
+    if (npy->map == NULL || size == 0)
+        return;
+    const DvzSize page = _map_granularity();
+    const DvzSize start = (DvzSize)(npy->data - npy->map) + offset;
+    const DvzSize end = start + size;
+    DvzSize first = start - start % page;
+    DvzSize last = end + (page - end % page) % page;
+    if (inner)
+    {
+        first = start + (page - start % page) % page;
+        last = end - end % page;
+    }
+    if (last > npy->map_len)
+        last = npy->map_len;
+    if (first >= last)
+        return;
+    madvise(npy->map + first, (size_t)(last - first), advice);
+#endif
+}
+
+
+
+/*************************************************************************************************/
+/*  Opening                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Parse the NPY header stored at a file offset and map its payload.
+ *
+ * @param file open file, owned by the returned array
+ * @param base offset of the NPY magic in the file
+ * @param avail number of bytes available from @p base
+ * @return the array, or NULL on failure (the file is then left open)
+ */
+static DvzNpy* _npy_open_at(FILE* file, DvzSize base, DvzSize avail)
+{
+    ANN(file);
+    uint8_t prefix[NPY_PREFIX_SIZE] = {0};
+    const size_t prefix_size = avail < NPY_PREFIX_SIZE ? (size_t)avail : NPY_PREFIX_SIZE;
+    if (prefix_size < 10 || !_npy_pread(file, base, prefix, prefix_size))
+        return NULL;
+
+    DvzSize header_size = prefix[6] == 1 ? 10 + (DvzSize)_le16(prefix + 8)
+                                         : 12 + (DvzSize)_le32(prefix + 8);
+    if (prefix_size < 12 && prefix[6] != 1)
+        return NULL;
+    if (header_size > avail || header_size > NPY_MAX_HEADER + 12)
+        return NULL;
+
+    uint8_t* header = (uint8_t*)dvz_malloc((size_t)header_size);
+    ANN(header);
+    DvzNpyInfo info = {0};
+    DvzSize data_offset = 0;
+    bool ok = _npy_pread(file, base, header, (size_t)header_size) &&
+              dvz_npy_parse_header(header, header_size, &info, &data_offset) == 0;
+    dvz_free(header);
+    if (!ok || info.data_size > avail - data_offset)
+        return NULL;
+
+    DvzNpy* npy = (DvzNpy*)dvz_calloc(1, sizeof(DvzNpy));
+    ANN(npy);
+    npy->info = info;
+    npy->file = file;
+    npy->data_offset = base + data_offset;
+    if (!_npy_map(npy))
+    {
+        log_warn("unable to map the NPY payload, falling back to streaming reads");
+        npy->data = NULL;
+    }
+    return npy;
+}
+
+
+
+DvzNpy* dvz_npy_open(const char* filename)
+{
+    ANN(filename);
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        log_error("the file %s does not exist", filename);
+        return NULL;
+    }
+    DvzNpy* npy = _npy_open_at(file, 0, _npy_file_size(file));
+    if (npy == NULL)
+    {
+        log_error("unable to read the NPY file %s", filename);
+        fclose(file);
+    }
+    return npy;
+}
+
+
+
+/*************************************************************************************************/
+/*  NPZ archives                                                                                 */
+/*************************************************************************************************/
+
+typedef struct
+{
+    uint16_t method;
+    uint64_t compressed_size;
+    uint64_t size;
+    uint64_t local_offset;
+} ZipEntry;
+
+
+
+/**
+ * Locate the central directory from the end-of-central-directory records.
+ *
+ * @param file open archive
+ * @param file_size archive size
+ * @param[out] offset central directory offset
+ * @param[out] size central directory size
+ * @return whether the directory was found
+ */
+static bool _zip_directory(FILE* file, DvzSize file_size, DvzSize* offset, DvzSize* size)
+{
+    if (file_size < ZIP_EOCD_SIZE)
+        return false;
+    const size_t tail_size =
+        file_size < ZIP_EOCD_SEARCH ? (size_t)file_size : (size_t)ZIP_EOCD_SEARCH;
+    const DvzSize tail_offset = file_size - tail_size;
+    uint8_t* tail = (uint8_t*)dvz_malloc(tail_size);
+    ANN(tail);
+    if (!_npy_pread(file, tail_offset, tail, tail_size))
+    {
+        dvz_free(tail);
+        return false;
+    }
+
+    int64_t eocd = -1;
+    for (int64_t i = (int64_t)tail_size - ZIP_EOCD_SIZE; i >= 0; i--)
+    {
+        if (_le32(tail + i) == ZIP_SIG_EOCD)
+        {
+            eocd = i;
+            break;
+        }
+    }
+    bool ok = eocd >= 0;
+    if (ok)
+    {
+        *size = _le32(tail + eocd + 12);
+        *offset = _le32(tail + eocd + 16);
+
+        // numpy writes ZIP64 records for archives over 4 GB.
+        if (*offset == 0xFFFFFFFFu || *size == 0xFFFFFFFFu)
+        {
+            uint8_t locator[20] = {0};
+            uint8_t record[56] = {0};
+            const DvzSize locator_offset = tail_offset + (DvzSize)eocd;
+            ok = locator_offset >= sizeof(locator) &&
+                 _npy_pread(file, locator_offset - sizeof(locator), locator, sizeof(locator)) &&
+                 _le32(locator) == ZIP_SIG_EOCD64_LOC &&
+                 _npy_pread(file, _le64(locator + 8), record, sizeof(record)) &&
+                 _le32(record) == ZIP_SIG_EOCD64;
+            if (ok)
+            {
+                *size = _le64(record + 40);
+                *offset = _le64(record + 48);
+            }
+        }
+    }
+    dvz_free(tail);
+    return ok && *size <= ZIP_MAX_DIRECTORY && *offset + *size <= file_size;
+}
+
+
+
+/**
+ * Apply the ZIP64 extended information extra field to an entry.
+ *
+ * @param extra extra fields of a central directory record
+ * @param extra_len size of the extra fields
+ * @param entry entry whose saturated fields are replaced
+ */
+static void _zip_apply_zip64(const uint8_t* extra, size_t extra_len, ZipEntry* entry)
+{
+    size_t pos = 0;
+    while (pos + 4 <= extra_len)
+    {
+        const uint16_t id = _le16(extra + pos);
+        const uint16_t len = _le16(extra + pos + 2);
+        const uint8_t* field = extra + pos + 4;
+        if (pos + 4 + len > extra_len)
+            return;
+        if (id == 0x0001)
+        {
+            size_t k = 0;
+            if (entry->size == 0xFFFFFFFFu && k + 8 <= len)
+                entry->size = _le64(field + k), k += 8;
+            if (entry->compressed_size == 0xFFFFFFFFu && k + 8 <= len)
+                entry->compressed_size = _le64(field + k), k += 8;
+            if (entry->local_offset == 0xFFFFFFFFu && k + 8 <= len)
+                entry->local_offset = _le64(field + k), k += 8;
+            return;
+        }
+        pos += 4 + (size_t)len;
+    }
+}
+
+
+
+static bool _zip_name_matches(const char* entry, size_t entry_len, const char* name)
+{
+    const size_t name_len = strlen(name);
+    if (entry_len == name_len && memcmp(entry, name, name_len) == 0)
+        return true;
+    return entry_len == name_len + 4 && memcmp(entry, name, name_len) == 0 &&
+           memcmp(entry + name_len, ".npy", 4) == 0;
+}
+
+
+
+static bool _zip_find(FILE* file, DvzSize file_size, const char* name, ZipEntry* out)
+{
+    DvzSize dir_offset = 0;
+    DvzSize dir_size = 0;
+    if (!_zip_directory(file, file_size, &dir_offset, &dir_size))
+        return false;
+    uint8_t* dir = (uint8_t*)dvz_malloc(dir_size > 0 ? (size_t)dir_size : 1);
+    ANN(dir);
+    if (!_npy_pread(file, dir_offset, dir, (size_t)dir_size))
+    {
+        dvz_free(dir);
+        return false;
+    }
+
+    bool found = false;
+    size_t pos = 0;
+    while (!found && pos + ZIP_CENTRAL_SIZE <= dir_size && _le32(dir + pos) == ZIP_SIG_CENTRAL)
+    {
+        const uint8_t* rec = dir + pos;
+        const size_t name_len = _le16(rec + 28);
+        const size_t extra_len = _le16(rec + 30);
+        const size_t comment_len = _le16(rec + 32);
+        if (pos + ZIP_CENTRAL_SIZE + name_len + extra_len > dir_size)
+            break;
+        if (_zip_name_matches((const char*)rec + ZIP_CENTRAL_SIZE, name_len, name))
+        {
+            ZipEntry entry = {
+                .method = _le16(rec + 10),
+                .compressed_size = _le32(rec + 20),
+                .size = _le32(rec + 24),
+                .local_offset = _le32(rec + 42),
+            };
+            _zip_apply_zip64(rec + ZIP_CENTRAL_SIZE + name_len, extra_len, &entry);
+            *out = entry;
+            found = true;
+        }
+        pos += ZIP_CENTRAL_SIZE + name_len + extra_len + comment_len;
+    }
+    dvz_free(dir);
+    return found;
+}
+
+
+
+/**
+ * Inflate a deflate-compressed NPZ entry into an owned array.
+ *
+ * @param file open archive, owned by the returned array
+ * @param offset offset of the compressed data
+ * @param entry archive entry
+ * @return the array, or NULL on failure
+ */
+static DvzNpy* _npz_inflate(FILE* file, DvzSize offset, const ZipEntry* entry)
+{
+#if DVZ_HAS_ZLIB
+    if (entry->compressed_size > SIZE_MAX || entry->size > SIZE_MAX || entry->size < 10)
+        return NULL;
+    uint8_t* src = (uint8_t*)dvz_malloc((size_t)entry->compressed_size + 1);
+    uint8_t* dst = (uint8_t*)dvz_malloc((size_t)entry->size);
+    ANN(src);
+    ANN(dst);
+    bool ok = _npy_pread(file, offset, src, (size_t)entry->compressed_size);
+
+    z_stream stream = {0};
+    ok = ok && inflateInit2(&stream, -MAX_WBITS) == Z_OK;
+    if (ok)
+    {
+        // Inflate in bounded steps since zlib counts bytes with 32-bit integers.
+        size_t in_pos = 0;
+        size_t out_pos = 0;
+        int rc = Z_OK;
+        while (rc == Z_OK)
+        {
+            stream.next_in = src + in_pos;
+            stream.avail_in =
+                (uInt)DVZ_MIN((size_t)entry->compressed_size - in_pos, (size_t)UINT32_MAX);
+            stream.next_out = dst + out_pos;
+            stream.avail_out = (uInt)DVZ_MIN((size_t)entry->size - out_pos, (size_t)UINT32_MAX);
+            const uInt avail_in = stream.avail_in;
+            const uInt avail_out = stream.avail_out;
+            rc = inflate(&stream, Z_NO_FLUSH);
+            in_pos += avail_in - stream.avail_in;
+            out_pos += avail_out - stream.avail_out;
+            if (rc == Z_OK && avail_in == stream.avail_in && avail_out == stream.avail_out)
+                break;
+        }
+        ok = rc == Z_STREAM_END && out_pos == entry->size;
+        inflateEnd(&stream);
+    }
+    dvz_free(src);
+
+    DvzNpyInfo info = {0};
+    DvzSize data_offset = 0;
+    ok = ok && dvz_npy_parse_header(dst, entry->size, &info, &data_offset) == 0 &&
+         info.data_size <= entry->size - data_offset;
+    if (!ok)
+    {
+        dvz_free(dst);
+        return NULL;
+    }
+
+    DvzNpy* npy = (DvzNpy*)dvz_calloc(1, sizeof(DvzNpy));
+    ANN(npy);
+    npy->info = info;
+    npy->file = file;
+    npy->owned = dst;
+    npy->data = dst + data_offset;
+    return npy;
+#else
+    (void)file;
+    (void)offset;
+    (void)entry;
+    log_error(
+        "unable to load a compressed NPZ array, Datoviz was not built with zlib support. Please "
+        "activate CMake option DVZ_WITH_ZLIB");
+    return NULL;
+#endif
+}
+
+
+
+DvzNpy* dvz_npz_open(const char* filename, const char* name)
+{
+    ANN(filename);
+    ANN(name);
+    FILE* file = fopen(filename, "rb");
+    if (file == NULL)
+    {
+        log_error("the file %s does not exist", filename);
+        return NULL;
+    }
+
+    const DvzSize file_size = _npy_file_size(file);
+    ZipEntry entry = {0};
+    uint8_t local[ZIP_LOCAL_SIZE] = {0};
+    DvzNpy* npy = NULL;
+    if (!_zip_find(file, file_size, name, &entry))
+    {
+        log_error("array %s not found in the NPZ file %s", name, filename);
+    }
+    else if (
+        !_npy_pread(file, entry.local_offset, local, sizeof(local)) ||
+        _le32(local) != ZIP_SIG_LOCAL)
+    {
+        log_error("invalid NPZ file %s", filename);
+    }
+    else
+    {
+        const DvzSize offset =
+            entry.local_offset + ZIP_LOCAL_SIZE + _le16(local + 26) + _le16(local + 28);
+        if (entry.method == 0 && offset <= file_size && entry.size <= file_size - offset)
+            npy = _npy_open_at(file, offset, entry.size);
+        else if (entry.method == 8)
+            npy = _npz_inflate(file, offset, &entry);
+        if (npy == NULL)
+            log_error("unable to read array %s in the NPZ file %s", name, filename);
+    }
+    if (npy == NULL)
+        fclose(file);
+    return npy;
+}
+
+
+
+/*************************************************************************************************/
+/*  Access                                                                                       */
+/*************************************************************************************************/
+
+bool dvz_npy_info(const DvzNpy* npy, DvzNpyInfo* out)
+{
+    if (npy == NULL || out == NULL)
+        return false;
+    *out = npy->info;
+    return true;
+}
+
+
+
+const void* dvz_npy_data(const DvzNpy* npy)
+{
+    ANN(npy);
+    return npy->data;
+}
+
+
+
+/**
+ * Convert a row range to a payload byte range.
+ *
+ * @param npy the array
+ * @param row_start first row
+ * @param row_count number of rows
+ * @param[out] offset payload byte offset
+ * @param[out] size byte count
+ * @return whether the range is valid
+ */
+static bool _npy_row_range(
+    const DvzNpy* npy, uint64_t row_start, uint64_t row_count, DvzSize* offset, DvzSize* size)
+{
+    ANN(npy);
+    if (npy->info.fortran_order && npy->info.ndim > 1)
+        return false;
+    if (row_start > npy->info.row_count || row_count > npy->info.row_count - row_start)
+        return false;
+    *offset = row_start * npy->info.row_size;
+    *size = row_count * npy->info.row_size;
+    return true;
+}
+
+
+
+const void* dvz_npy_rows(DvzNpy* npy, uint64_t row_start, uint64_t row_count)
+{
+    ANN(npy);
+    DvzSize offset = 0;
+    DvzSize size = 0;
+    if (npy->data == NULL || !_npy_row_range(npy, row_start, row_count, &offset, &size))
+        return NULL;
+#if !defined(_WIN32) && !defined(_MSC_VER)
+    _npy_madvise(npy, offset, size, MADV_WILLNEED, false);
+#endif
+    return npy->data + offset;
+}
+
+
+
+void dvz_npy_evict_rows(DvzNpy* npy, uint64_t row_start, uint64_t row_count)
+{
+    ANN(npy);
+    DvzSize offset = 0;
+    DvzSize size = 0;
+    if (!_npy_row_range(npy, row_start, row_count, &offset, &size))
+        return;
+#if !defined(_WIN32) && !defined(_MSC_VER)
+    _npy_madvise(npy, offset, size, MADV_DONTNEED, true);
+#if defined(POSIX_FADV_DONTNEED)
+    posix_fadvise(
+        fileno(npy->file), (off_t)(npy->data_offset + offset), (off_t)size, POSIX_FADV_DONTNEED);
+#endif
+#endif
+}
+
+
+
+int dvz_npy_read_rows(
+    DvzNpy* npy, uint64_t row_start, uint64_t row_count, void* dst, DvzSize dst_size)
+{
+    ANN(npy);
+    ANN(dst);
+    DvzSize offset = 0;
+    DvzSize size = 0;
+    if (!_npy_row_range(npy, row_start, row_count, &offset, &size) || size > dst_size ||
+        size > SIZE_MAX)
+        return 1;
+    if (npy->data != NULL)
+    {
+        if (size > 0)
+            dvz_memcpy(dst, (size_t)dst_size, npy->data + offset, (size_t)size);
+        return 0;
+    }
+    return _npy_pread(npy->file, npy->data_offset + offset, dst, (size_t)size) ? 0 : 1;
+}
+
+
+
+void dvz_npy_advise(DvzNpy* npy, DvzNpyAccess access)
+{
+    ANN(npy);
+#if !defined(_WIN32) && !defined(_MSC_VER)
+    int advice = MADV_NORMAL;
+    if (access == DVZ_NPY_ACCESS_SEQUENTIAL)
+        advice = MADV_SEQUENTIAL;
+    else if (access == DVZ_NPY_ACCESS_RANDOM)
+        advice = MADV_RANDOM;
+    _npy_madvise(npy, 0, npy->info.data_size, advice, false);
+#else
+    (void)access;
+#endif
+}
+
+
+
+void dvz_npy_close(DvzNpy* npy)
+{
+    if (npy == NULL)
+        return;
+    _npy_unmap(npy);
+    dvz_free(npy->owned);
+    if (npy->file != NULL)
+        fclose(npy->file);
+    dvz_free(npy);
+}
@@ -14,6 +14,7 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -22,11 +23,18 @@
 #include "_alloc.h"
 #include "_assertions.h"
 #include "_compat.h"
+#include "_log.h"
+#include "_time_utils.h"
 #include "datoviz/fileio/fileio.h"
+#include "datoviz/fileio/npy.h"
 #include "test_fileio.h"
 #include "testing.h"
 #include "datoviz/math/types.h"
 
+#if DVZ_HAS_ZLIB
+#include <zlib.h>
+#endif
+
 
 
 /*************************************************************************************************/
@@ -88,6 +96,88 @@ static bool _fixture_path(
 
 
 
+/**
+ * Build an NPY file in memory.
+ *
+ * @param header header dictionary text
+ * @param version NPY format major version
+ * @param payload array payload
+ * @param payload_size payload size in bytes
+ * @param total_size output file size
+ * @return owned file bytes
+ */
+static uint8_t* _npy_bytes(
+    const char* header, uint8_t version, const void* payload, size_t payload_size,
+    size_t* total_size)
+{
+    ANN(header);
+    ANN(total_size);
+    const size_t prefix = version == 1 ? 10 : 12;
+    const size_t header_len = ((prefix + strlen(header) + 1 + 63) / 64) * 64 - prefix;
+    *total_size = prefix + header_len + payload_size;
+    uint8_t* buffer = (uint8_t*)dvz_calloc(*total_size, 1);
+    ANN(buffer);
+    dvz_memcpy(buffer, *total_size, "\x93NUMPY", 6);
+    buffer[6] = version;
+    uint32_t len = (uint32_t)header_len;
+    dvz_memcpy(buffer + 8, prefix - 8, &len, prefix - 8);
+    dvz_memset(buffer + prefix, header_len, ' ', header_len);
+    dvz_memcpy(buffer + prefix, header_len, header, strlen(header));
+    buffer[prefix + header_len - 1] = '\n';
+    if (payload_size > 0)
+        dvz_memcpy(buffer + prefix + header_len, payload_size, payload, payload_size);
+    return buffer;
+}
+
+
+
+/**
+ * Write a single-entry ZIP archive as produced by numpy.savez.
+ *
+ * @param path destination path
+ * @param name entry name
+ * @param method 0 for stored, 8 for deflate
+ * @param data entry data, already compressed for deflate
+ * @param size entry data size
+ * @param uncompressed_size uncompressed entry size
+ * @return whether the archive was written
+ */
+static bool _npz_write(
+    const char* path, const char* name, uint16_t method, const uint8_t* data, uint32_t size,
+    uint32_t uncompressed_size)
+{
+    const uint16_t name_len = (uint16_t)strlen(name);
+    uint8_t local[30] = {0x50, 0x4b, 0x03, 0x04, 20};
+    dvz_memcpy(local + 8, 2, &method, 2);
+    dvz_memcpy(local + 18, 4, &size, 4);
+    dvz_memcpy(local + 22, 4, &uncompressed_size, 4);
+    dvz_memcpy(local + 26, 2, &name_len, 2);
+
+    uint8_t central[46] = {0x50, 0x4b, 0x01, 0x02, 20, 0, 20};
+    dvz_memcpy(central + 10, 2, &method, 2);
+    dvz_memcpy(central + 20, 4, &size, 4);
+    dvz_memcpy(central + 24, 4, &uncompressed_size, 4);
+    dvz_memcpy(central + 28, 2, &name_len, 2);
+
+    const uint32_t dir_offset = (uint32_t)(sizeof(local) + name_len + size);
+    const uint32_t dir_size = (uint32_t)(sizeof(central) + name_len);
+    const uint16_t count = 1;
+    uint8_t eocd[22] = {0x50, 0x4b, 0x05, 0x06};
+    dvz_memcpy(eocd + 8, 2, &count, 2);
+    dvz_memcpy(eocd + 10, 2, &count, 2);
+    dvz_memcpy(eocd + 12, 4, &dir_size, 4);
+    dvz_memcpy(eocd + 16, 4, &dir_offset, 4);
+
+    return dvz_write_bytes(path, "wb", sizeof(local), local) == 0 &&
+           dvz_write_bytes(path, "ab", name_len, (const uint8_t*)name) == 0 &&
+           dvz_write_bytes(path, "ab", size, data) == 0 &&
+           dvz_write_bytes(path, "ab", sizeof(central), central) == 0 &&
+           dvz_write_bytes(path, "ab", name_len, (const uint8_t*)name) == 0 &&
+           dvz_write_bytes(path, "ab", sizeof(eocd), eocd) == 0;
+}
+
+
+
 /*************************************************************************************************/
 /*  Tests                                                                                        */
 /*************************************************************************************************/
@@ -382,6 +472,183 @@ int test_read_npy(TstContext* suite, const TstCase* tstitem)
 
 
 
+int test_npy_open(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+
+    /* Parse dtype, shape, and storage order from the header. */
+    DvzNpyInfo info = {0};
+    size_t size = 0;
+    uint8_t* bytes = _npy_bytes(
+        "{'descr': '>i2', 'fortran_order': True, 'shape': (3, 4, 5), }", 1, NULL, 0, &size);
+    DvzSize offset = 0;
+    AT(dvz_npy_parse_header(bytes, size, &info, &offset) == 0);
+    AT(offset == size);
+    AT(info.dtype == DVZ_NPY_DTYPE_INT16);
+    AT(info.item_size == 2);
+    AT(info.byte_swapped);
+    AT(info.fortran_order);
+    AT(info.ndim == 3);
+    AT(info.shape[0] == 3 && info.shape[1] == 4 && info.shape[2] == 5);
+    AT(info.row_size == 40);
+    AT(info.data_size == 120);
+    dvz_free(bytes);
+
+    bytes = _npy_bytes(
+        "{'descr': '<U8', 'fortran_order': False, 'shape': (2,), }", 1, NULL, 0, &size);
+    AT(dvz_npy_parse_header(bytes, size, &info, NULL) != 0);
+    dvz_free(bytes);
+
+    /* Map a version 2 file of 1000 float32 rows with 3 columns. */
+    const uint32_t rows = 1000;
+    float* points = (float*)dvz_calloc(rows * 3, sizeof(float));
+    ANN(points);
+    for (uint32_t i = 0; i < rows * 3; i++)
+        points[i] = (float)i;
+    bytes = _npy_bytes(
+        "{'descr': '<f4', 'fortran_order': False, 'shape': (1000, 3), }", 2, points,
+        rows * 3 * sizeof(float), &size);
+    char path[256] = {0};
+    AT(_fixture_path(suite, "points.npy", path, sizeof(path)));
+    AT(dvz_write_bytes(path, "wb", size, bytes) == 0);
+    dvz_free(bytes);
+
+    DvzNpy* npy = dvz_npy_open(path);
+    AT(npy != NULL);
+    AT(dvz_npy_info(npy, &info));
+    AT(info.dtype == DVZ_NPY_DTYPE_FLOAT32);
+    AT(info.row_count == rows);
+    AT(info.row_size == 3 * sizeof(float));
+    AT(memcmp(dvz_npy_data(npy), points, rows * 3 * sizeof(float)) == 0);
+
+    dvz_npy_advise(npy, DVZ_NPY_ACCESS_SEQUENTIAL);
+    const float* chunk = (const float*)dvz_npy_rows(npy, 500, 100);
+    AT(chunk != NULL);
+    AT(chunk[0] == 1500.0f);
+    dvz_npy_evict_rows(npy, 500, 100);
+    AT(chunk[299] == 1799.0f);
+    AT(dvz_npy_rows(npy, 990, 11) == NULL);
+
+    float copy[30] = {0};
+    AT(dvz_npy_read_rows(npy, 990, 10, copy, sizeof(copy)) == 0);
+    AT(copy[29] == 2999.0f);
+    AT(dvz_npy_read_rows(npy, 990, 10, copy, sizeof(copy) - 1) != 0);
+    dvz_npy_close(npy);
+    dvz_free(points);
+    AT(remove(path) == 0);
+
+    AT_EXPECTED_ERROR_STRICT(suite, dvz_npy_open(__FILE__) == NULL);
+    return 0;
+}
+
+
+
+int test_npz_open(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+
+    const uint8_t values[] = {1, 2, 3, 5, 8, 13, 21, 34};
+    size_t size = 0;
+    uint8_t* bytes = _npy_bytes(
+        "{'descr': '|u1', 'fortran_order': False, 'shape': (4, 2), }", 1, values, sizeof(values),
+        &size);
+    char path[256] = {0};
+    AT(_fixture_path(suite, "arrays.npz", path, sizeof(path)));
+
+    /* Stored entries are mapped in place. */
+    AT(_npz_write(path, "points.npy", 0, bytes, (uint32_t)size, (uint32_t)size));
+    DvzNpy* npy = dvz_npz_open(path, "points");
+    AT(npy != NULL);
+    DvzNpyInfo info = {0};
+    AT(dvz_npy_info(npy, &info));
+    AT(info.ndim == 2 && info.shape[0] == 4 && info.shape[1] == 2);
+    AT(memcmp(dvz_npy_data(npy), values, sizeof(values)) == 0);
+    AT(((const uint8_t*)dvz_npy_rows(npy, 3, 1))[1] == 34);
+    dvz_npy_close(npy);
+    AT_EXPECTED_ERROR_STRICT(suite, dvz_npz_open(path, "colors") == NULL);
+
+#if DVZ_HAS_ZLIB
+    /* Compressed entries are inflated. */
+    uint8_t compressed[256] = {0};
+    z_stream stream = {0};
+    AT(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                    Z_DEFAULT_STRATEGY) == Z_OK);
+    stream.next_in = bytes;
+    stream.avail_in = (uInt)size;
+    stream.next_out = compressed;
+    stream.avail_out = sizeof(compressed);
+    AT(deflate(&stream, Z_FINISH) == Z_STREAM_END);
+    const uint32_t compressed_size = (uint32_t)stream.total_out;
+    deflateEnd(&stream);
+
+    AT(_npz_write(path, "points.npy", 8, compressed, compressed_size, (uint32_t)size));
+    npy = dvz_npz_open(path, "points.npy");
+    AT(npy != NULL);
+    AT(memcmp(dvz_npy_data(npy), values, sizeof(values)) == 0);
+    uint8_t row[2] = {0};
+    AT(dvz_npy_read_rows(npy, 2, 1, row, sizeof(row)) == 0);
+    AT(row[0] == 8 && row[1] == 13);
+    dvz_npy_close(npy);
+#endif
+
+    dvz_free(bytes);
+    AT(remove(path) == 0);
+    return 0;
+}
+
+
+
+int test_npy_bench(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+
+    /* Time to the first chunk of rows: full read versus memory-mapped open. */
+    const uint64_t rows = 8 * 1024 * 1024;
+    const uint64_t chunk = 64 * 1024;
+    const size_t payload_size = (size_t)rows * 3 * sizeof(float);
+    const char header[] = "{'descr': '<f4', 'fortran_order': False, 'shape': (8388608, 3), }";
+    char path[256] = {0};
+    AT(_fixture_path(suite, "bench.npy", path, sizeof(path)));
+
+    size_t size = 0;
+    uint8_t* bytes = _npy_bytes(header, 1, NULL, 0, &size);
+    uint8_t* payload = (uint8_t*)dvz_calloc(payload_size, 1);
+    ANN(payload);
+    AT(dvz_write_bytes(path, "wb", size, bytes) == 0);
+    AT(dvz_write_bytes(path, "ab", payload_size, payload) == 0);
+    dvz_free(bytes);
+    dvz_free(payload);
+
+    DvzClock clock = dvz_clock();
+    DvzSize read_size = 0;
+    void* data = dvz_read_npy(path, &read_size);
+    AT(data != NULL);
+    const double read_elapsed = dvz_clock_get(&clock);
+    AT(read_size == payload_size);
+    dvz_free(data);
+
+    clock = dvz_clock();
+    DvzNpy* npy = dvz_npy_open(path);
+    AT(npy != NULL);
+    dvz_npy_advise(npy, DVZ_NPY_ACCESS_SEQUENTIAL);
+    const float* first = (const float*)dvz_npy_rows(npy, 0, chunk);
+    AT(first != NULL);
+    float sum = 0;
+    for (uint64_t i = 0; i < chunk * 3; i += 1024)
+        sum += first[i];
+    const double map_elapsed = dvz_clock_get(&clock);
+    AT(sum == 0);
+    dvz_npy_close(npy);
+
+    log_info(
+        "NPY %.0f MB, first %" PRIu64 " rows: dvz_read_npy %.2f ms, dvz_npy_open %.2f ms",
+        payload_size / 1e6, chunk, read_elapsed * 1e3, map_elapsed * 1e3);
+    AT(remove(path) == 0);
+    return 0;
+}
+
+
+
 int test_jpeg_bytes_fixture(TstContext* suite, const TstCase* tstitem)
 {
     ANN(suite);
@@ -457,6 +724,9 @@ int test_fileio(TstSuite* suite)
     TST_GROUP("npy");
     TST_CASE(test_parse_npy);
     TST_CASE(test_read_npy);
+    TST_CASE(test_npy_open);
+    TST_CASE(test_npz_open);
+    TST_CASE(test_npy_bench);
 
     return 0;
 }
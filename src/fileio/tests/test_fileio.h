@@ -36,6 +36,12 @@ int test_parse_npy(TstContext* suite, const TstCase* tstitem);
 
 int test_read_npy(TstContext* suite, const TstCase* tstitem);
 
+int test_npy_open(TstContext* suite, const TstCase* tstitem);
+
+int test_npz_open(TstContext* suite, const TstCase* tstitem);
+
+int test_npy_bench(TstContext* suite, const TstCase* tstitem);
+
 int test_read_text(TstContext* suite, const TstCase* tstitem);
 
 int test_jpeg_bytes_fixture(TstContext* suite, const TstCase* tstitem);
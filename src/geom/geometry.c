@@ -30,6 +30,7 @@
 #include "_compat.h"
 #include "_log.h"
 #include "_overflow.h"
+#include "thread_internal.h"
 
 
 
@@ -50,18 +51,22 @@
 #define DVZ_GEOM_REVOLUTION_DEFAULT_SECTORS 32
 #define DVZ_GEOM_TORUS_DEFAULT_RINGS 32
 #define DVZ_GEOM_TORUS_DEFAULT_SECTORS 16
-#define DVZ_GEOMETRY_CUBE_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_PLANE_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_SPHERE_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_SURFACE_GRID_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_DISC_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_SECTOR_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_REGULAR_POLYGON_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_STAR_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_CYLINDER_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_CONE_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_TORUS_DESC_KNOWN_FLAGS 0u
-#define DVZ_GEOMETRY_ARROW_DESC_KNOWN_FLAGS 0u
+#define DVZ_GEOM_PARALLEL_MIN_TRIANGLES (1u << 16)
+#define DVZ_GEOM_BLOCK_INDICES (1u << 16)
+#define DVZ_GEOM_BLOCK_TRIANGLES (1u << 14)
+#define DVZ_GEOM_BLOCK_VERTICES (1u << 14)
+#define DVZ_GEOMETRY_CUBE_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_PLANE_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_SPHERE_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_SURFACE_GRID_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_DISC_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_SECTOR_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_REGULAR_POLYGON_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_STAR_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_CYLINDER_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_CONE_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_TORUS_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
+#define DVZ_GEOMETRY_ARROW_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
 
 
 
@@ -78,6 +83,50 @@ struct _GeomEdgeCandidate
 
 
 
+// Index-derived data cached on large geometries and rebuilt when the index buffer changes.
+struct DvzGeometryTopology
+{
+    uint32_t vertex_count;
+    uint32_t index_count;
+    uint64_t index_hash;
+
+    uint32_t* vertex_offsets; // vertex_count + 1 offsets into vertex_faces
+    uint32_t* vertex_faces;   // incident triangles of each vertex, in ascending order
+};
+
+
+
+struct _GeomIndexHash
+{
+    const DvzIndex* indices;
+    uint32_t index_count;
+    uint64_t* block_hashes;
+};
+
+
+
+struct _GeomNormalGather
+{
+    DvzGeometry* geometry;
+    const DvzGeometryTopology* topology;
+};
+
+
+
+struct _GeomContourPass
+{
+    const DvzGeometry* geometry;
+    const double* values;
+    const double* levels;
+    uint32_t level_count;
+    bool sorted_levels;
+    uint32_t* block_counts;  // segment count of each triangle block
+    uint32_t* block_offsets; // first segment of each triangle block, NULL for the counting pass
+    DvzGeometryContourSegment* segments;
+};
+
+
+
 /*************************************************************************************************/
 /*  Helpers                                                                                      */
 /*************************************************************************************************/
@@ -380,6 +429,193 @@ static void _geom_fill_color(DvzGeometry* geometry, const DvzColor color)
 
 
 
+/**
+ * Return whether a geometry stores F32 vertex attributes.
+ *
+ * @param geometry the geometry
+ * @return whether the F32 arrays are the active storage
+ */
+static inline bool _geom_is_f32(const DvzGeometry* geometry)
+{
+    return geometry->precision == DVZ_GEOMETRY_PRECISION_F32;
+}
+
+
+
+/**
+ * Return whether a geometry has positions in its storage precision.
+ *
+ * @param geometry the geometry
+ * @return whether positions are allocated
+ */
+static inline bool _geom_has_positions(const DvzGeometry* geometry)
+{
+    return _geom_is_f32(geometry) ? geometry->positions_f32 != NULL : geometry->positions != NULL;
+}
+
+
+
+/**
+ * Return whether a geometry has normals in its storage precision.
+ *
+ * @param geometry the geometry
+ * @return whether normals are allocated
+ */
+static inline bool _geom_has_normals(const DvzGeometry* geometry)
+{
+    return _geom_is_f32(geometry) ? geometry->normals_f32 != NULL : geometry->normals != NULL;
+}
+
+
+
+/**
+ * Return whether a geometry has texture coordinates in its storage precision.
+ *
+ * @param geometry the geometry
+ * @return whether texture coordinates are allocated
+ */
+static inline bool _geom_has_texcoords(const DvzGeometry* geometry)
+{
+    return _geom_is_f32(geometry) ? geometry->texcoords_f32 != NULL
+                                  : geometry->texcoords != NULL;
+}
+
+
+
+/**
+ * Read one vertex position as F64.
+ *
+ * @param geometry the geometry
+ * @param index vertex index
+ * @param out output position
+ */
+static inline void _geom_get_position(const DvzGeometry* geometry, uint32_t index, dvec3 out)
+{
+    if (_geom_is_f32(geometry))
+    {
+        out[0] = geometry->positions_f32[index][0];
+        out[1] = geometry->positions_f32[index][1];
+        out[2] = geometry->positions_f32[index][2];
+        return;
+    }
+    out[0] = geometry->positions[index][0];
+    out[1] = geometry->positions[index][1];
+    out[2] = geometry->positions[index][2];
+}
+
+
+
+/**
+ * Write one vertex position, rounding to F32 when needed.
+ *
+ * @param geometry the geometry
+ * @param index vertex index
+ * @param value position
+ */
+static inline void _geom_put_position(DvzGeometry* geometry, uint32_t index, const dvec3 value)
+{
+    if (_geom_is_f32(geometry))
+    {
+        geometry->positions_f32[index][0] = (float)value[0];
+        geometry->positions_f32[index][1] = (float)value[1];
+        geometry->positions_f32[index][2] = (float)value[2];
+        return;
+    }
+    geometry->positions[index][0] = value[0];
+    geometry->positions[index][1] = value[1];
+    geometry->positions[index][2] = value[2];
+}
+
+
+
+/**
+ * Read one vertex normal as F64.
+ *
+ * @param geometry the geometry
+ * @param index vertex index
+ * @param out output normal
+ */
+static inline void _geom_get_normal(const DvzGeometry* geometry, uint32_t index, dvec3 out)
+{
+    if (_geom_is_f32(geometry))
+    {
+        out[0] = geometry->normals_f32[index][0];
+        out[1] = geometry->normals_f32[index][1];
+        out[2] = geometry->normals_f32[index][2];
+        return;
+    }
+    out[0] = geometry->normals[index][0];
+    out[1] = geometry->normals[index][1];
+    out[2] = geometry->normals[index][2];
+}
+
+
+
+/**
+ * Write one vertex normal, rounding to F32 when needed.
+ *
+ * @param geometry the geometry
+ * @param index vertex index
+ * @param value normal
+ */
+static inline void _geom_put_normal(DvzGeometry* geometry, uint32_t index, const dvec3 value)
+{
+    if (_geom_is_f32(geometry))
+    {
+        geometry->normals_f32[index][0] = (float)value[0];
+        geometry->normals_f32[index][1] = (float)value[1];
+        geometry->normals_f32[index][2] = (float)value[2];
+        return;
+    }
+    geometry->normals[index][0] = value[0];
+    geometry->normals[index][1] = value[1];
+    geometry->normals[index][2] = value[2];
+}
+
+
+
+/**
+ * Read one texture coordinate as F64.
+ *
+ * @param geometry the geometry
+ * @param index vertex index
+ * @param out output texture coordinate
+ */
+static inline void _geom_get_texcoord(const DvzGeometry* geometry, uint32_t index, dvec2 out)
+{
+    if (_geom_is_f32(geometry))
+    {
+        out[0] = geometry->texcoords_f32[index][0];
+        out[1] = geometry->texcoords_f32[index][1];
+        return;
+    }
+    out[0] = geometry->texcoords[index][0];
+    out[1] = geometry->texcoords[index][1];
+}
+
+
+
+/**
+ * Write one texture coordinate, rounding to F32 when needed.
+ *
+ * @param geometry the geometry
+ * @param index vertex index
+ * @param value texture coordinate
+ */
+static inline void _geom_put_texcoord(DvzGeometry* geometry, uint32_t index, const dvec2 value)
+{
+    if (_geom_is_f32(geometry))
+    {
+        geometry->texcoords_f32[index][0] = (float)value[0];
+        geometry->texcoords_f32[index][1] = (float)value[1];
+        return;
+    }
+    geometry->texcoords[index][0] = value[0];
+    geometry->texcoords[index][1] = value[1];
+}
+
+
+
 /**
  * Return the squared length of a F64 3-vector.
  *
@@ -533,9 +769,10 @@ static bool _geom_triangle_normal(
     ASSERT(i1 < geometry->vertex_count);
     ASSERT(i2 < geometry->vertex_count);
 
-    const double* p0 = geometry->positions[i0];
-    const double* p1 = geometry->positions[i1];
-    const double* p2 = geometry->positions[i2];
+    dvec3 p0 = {0}, p1 = {0}, p2 = {0};
+    _geom_get_position(geometry, i0, p0);
+    _geom_get_position(geometry, i1, p1);
+    _geom_get_position(geometry, i2, p2);
     dvec3 a = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
     dvec3 b = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
     _geom_dvec3_cross(a, b, out);
@@ -698,8 +935,8 @@ static void _geom_surface_grid_config(
  */
 static bool _geom_valid_payload(const DvzGeometry* geometry)
 {
-    return geometry != NULL && geometry->vertex_count > 0 && geometry->positions != NULL &&
-           geometry->colors != NULL && geometry->texcoords != NULL &&
+    return geometry != NULL && geometry->vertex_count > 0 && _geom_has_positions(geometry) &&
+           geometry->colors != NULL && _geom_has_texcoords(geometry) &&
            (geometry->index_count == 0 || geometry->indices != NULL);
 }
 
@@ -801,6 +1038,18 @@ static void _geom_contour_intersection(
     if (*count >= 3 || sa == sb)
         return;
 
+    // Interpolate from the lower vertex index so that both triangles sharing an edge produce
+    // bitwise identical endpoints.
+    if (ia > ib)
+    {
+        const DvzIndex index = ia;
+        ia = ib;
+        ib = index;
+        const double value = sa;
+        sa = sb;
+        sb = value;
+    }
+
     const double min_value = sa < sb ? sa : sb;
     const double max_value = sa > sb ? sa : sb;
     if (level < min_value || level >= max_value)
@@ -810,13 +1059,375 @@ static void _geom_contour_intersection(
     if (!isfinite(t) || t < -DVZ_EPSILON || t > 1.0 + DVZ_EPSILON)
         return;
 
-    _geom_dvec3_lerp(geometry->positions[ia], geometry->positions[ib], DVZ_CLIP(t, 0.0, 1.0),
-                     points[*count]);
+    dvec3 pa = {0}, pb = {0};
+    _geom_get_position(geometry, ia, pa);
+    _geom_get_position(geometry, ib, pb);
+    _geom_dvec3_lerp(pa, pb, DVZ_CLIP(t, 0.0, 1.0), points[*count]);
     *count += 1;
 }
 
 
 
+/**
+ * Return the first level not below a value in an ascending level array.
+ *
+ * @param levels ascending contour levels
+ * @param level_count number of levels
+ * @param value searched value
+ * @return index of the first level >= value, or level_count
+ */
+static uint32_t _geom_level_lower_bound(const double* levels, uint32_t level_count, double value)
+{
+    ANN(levels);
+    uint32_t lo = 0, hi = level_count;
+    while (lo < hi)
+    {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (levels[mid] < value)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+
+
+/**
+ * Extract the contour segments of one triangle.
+ *
+ * With ascending levels, only the levels inside the scalar range of the triangle are visited.
+ *
+ * @param pass contour pass inputs
+ * @param face triangle index
+ * @param out output segments, or NULL to only count them
+ * @return number of segments
+ */
+static uint32_t _geom_contour_triangle(
+    const struct _GeomContourPass* pass, uint32_t face, DvzGeometryContourSegment* out)
+{
+    ANN(pass);
+    const DvzGeometry* geometry = pass->geometry;
+    const uint32_t offset = 3 * face;
+    const DvzIndex i0 = geometry->indices[offset + 0];
+    const DvzIndex i1 = geometry->indices[offset + 1];
+    const DvzIndex i2 = geometry->indices[offset + 2];
+    const double s0 = pass->values[i0];
+    const double s1 = pass->values[i1];
+    const double s2 = pass->values[i2];
+    if (!isfinite(s0) || !isfinite(s1) || !isfinite(s2))
+        return 0;
+
+    uint32_t first = 0, last = pass->level_count;
+    if (pass->sorted_levels)
+    {
+        const double smin = fmin(s0, fmin(s1, s2));
+        const double smax = fmax(s0, fmax(s1, s2));
+        first = _geom_level_lower_bound(pass->levels, pass->level_count, smin);
+        last = _geom_level_lower_bound(pass->levels, pass->level_count, smax);
+    }
+
+    uint32_t count = 0;
+    for (uint32_t level_index = first; level_index < last; level_index++)
+    {
+        const double level = pass->levels[level_index];
+        if (!isfinite(level))
+            continue;
+
+        dvec3 points[3] = {{0}};
+        uint32_t point_count = 0;
+        _geom_contour_intersection(geometry, i0, i1, s0, s1, level, points, &point_count);
+        _geom_contour_intersection(geometry, i1, i2, s1, s2, level, points, &point_count);
+        _geom_contour_intersection(geometry, i2, i0, s2, s0, level, points, &point_count);
+        if (point_count != 2 || _geom_dvec3_nearly_equal(points[0], points[1]))
+            continue;
+
+        if (out != NULL)
+        {
+            DvzGeometryContourSegment* segment = &out[count];
+            dvz_memcpy(segment->p0, sizeof(dvec3), points[0], sizeof(dvec3));
+            dvz_memcpy(segment->p1, sizeof(dvec3), points[1], sizeof(dvec3));
+            segment->level = level;
+            segment->level_index = level_index;
+            segment->face_index = face;
+        }
+        count++;
+    }
+    return count;
+}
+
+
+
+/**
+ * Count or write the contour segments of a range of triangle blocks.
+ *
+ * @param begin first block
+ * @param end end block
+ * @param user_data contour pass
+ */
+static void _geom_contour_blocks(uint32_t begin, uint32_t end, void* user_data)
+{
+    struct _GeomContourPass* pass = (struct _GeomContourPass*)user_data;
+    ANN(pass);
+    const uint32_t triangle_count = pass->geometry->index_count / 3;
+    for (uint32_t block = begin; block < end; block++)
+    {
+        const uint32_t face0 = block * DVZ_GEOM_BLOCK_TRIANGLES;
+        const uint32_t face1 = DVZ_MIN(triangle_count, face0 + DVZ_GEOM_BLOCK_TRIANGLES);
+        DvzGeometryContourSegment* out =
+            pass->block_offsets != NULL ? &pass->segments[pass->block_offsets[block]] : NULL;
+        uint32_t count = 0;
+        for (uint32_t face = face0; face < face1; face++)
+            count += _geom_contour_triangle(pass, face, out != NULL ? &out[count] : NULL);
+        ASSERT(out == NULL || count == pass->block_counts[block]);
+        pass->block_counts[block] = count;
+    }
+}
+
+
+
+/**
+ * Hash a range of index blocks.
+ *
+ * @param begin first block
+ * @param end end block
+ * @param user_data index hash state
+ */
+static void _geom_index_hash_blocks(uint32_t begin, uint32_t end, void* user_data)
+{
+    struct _GeomIndexHash* state = (struct _GeomIndexHash*)user_data;
+    ANN(state);
+    for (uint32_t block = begin; block < end; block++)
+    {
+        const uint32_t i0 = block * DVZ_GEOM_BLOCK_INDICES;
+        const uint32_t i1 = DVZ_MIN(state->index_count, i0 + DVZ_GEOM_BLOCK_INDICES);
+        uint64_t hash = 0xcbf29ce484222325ull ^ block;
+        for (uint32_t i = i0; i < i1; i++)
+            hash = (hash ^ state->indices[i]) * 0x100000001b3ull;
+        state->block_hashes[block] = hash;
+    }
+}
+
+
+
+/**
+ * Hash the index buffer of a geometry, in parallel when a pool is available.
+ *
+ * @param geometry the geometry
+ * @param pool thread pool, or NULL
+ * @param out output hash
+ * @return whether the hash could be computed
+ */
+static bool _geom_index_hash(const DvzGeometry* geometry, DvzThreadPool* pool, uint64_t* out)
+{
+    ANN(geometry);
+    ANN(out);
+    const uint32_t block_count =
+        (geometry->index_count + DVZ_GEOM_BLOCK_INDICES - 1) / DVZ_GEOM_BLOCK_INDICES;
+    struct _GeomIndexHash state = {
+        .indices = geometry->indices,
+        .index_count = geometry->index_count,
+        .block_hashes = (uint64_t*)dvz_calloc(DVZ_MAX(block_count, 1u), sizeof(uint64_t)),
+    };
+    if (state.block_hashes == NULL)
+        return false;
+    dvz_thread_pool_parallel_for(pool, block_count, 1, _geom_index_hash_blocks, &state);
+
+    uint64_t hash = (uint64_t)geometry->index_count;
+    for (uint32_t block = 0; block < block_count; block++)
+        hash = (hash ^ state.block_hashes[block]) * 0x9e3779b97f4a7c15ull;
+    dvz_free(state.block_hashes);
+    *out = hash;
+    return true;
+}
+
+
+
+static void _geom_topology_destroy(DvzGeometryTopology* topology)
+{
+    if (topology == NULL)
+        return;
+    dvz_free(topology->vertex_offsets);
+    dvz_free(topology->vertex_faces);
+    dvz_free(topology);
+}
+
+
+
+/**
+ * Build the vertex-to-triangle adjacency of a geometry with valid indexed triangles.
+ *
+ * @param geometry the geometry
+ * @param pool thread pool of the calling operation, or NULL
+ * @return the topology, or NULL on allocation failure
+ */
+static DvzGeometryTopology* _geom_topology_build(const DvzGeometry* geometry, DvzThreadPool* pool)
+{
+    ANN(geometry);
+    DvzGeometryTopology* topology =
+        (DvzGeometryTopology*)dvz_calloc(1, sizeof(DvzGeometryTopology));
+    if (topology == NULL)
+        return NULL;
+    topology->vertex_count = geometry->vertex_count;
+    topology->index_count = geometry->index_count;
+    topology->vertex_offsets =
+        (uint32_t*)dvz_calloc((DvzSize)geometry->vertex_count + 1, sizeof(uint32_t));
+    topology->vertex_faces = (uint32_t*)dvz_calloc(geometry->index_count, sizeof(uint32_t));
+    if (topology->vertex_offsets == NULL || topology->vertex_faces == NULL ||
+        !_geom_index_hash(geometry, pool, &topology->index_hash))
+    {
+        _geom_topology_destroy(topology);
+        return NULL;
+    }
+
+    // A vertex repeated in a degenerate triangle is listed twice, as the serial accumulation
+    // adds that triangle twice.
+    uint32_t* offsets = topology->vertex_offsets;
+    for (uint32_t i = 0; i < geometry->index_count; i++)
+        offsets[geometry->indices[i] + 1]++;
+    for (uint32_t v = 0; v < geometry->vertex_count; v++)
+        offsets[v + 1] += offsets[v];
+    uint32_t* cursor = (uint32_t*)dvz_calloc(geometry->vertex_count, sizeof(uint32_t));
+    if (cursor == NULL)
+    {
+        _geom_topology_destroy(topology);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < geometry->index_count; i++)
+    {
+        const DvzIndex v = geometry->indices[i];
+        topology->vertex_faces[offsets[v] + cursor[v]++] = i / 3;
+    }
+    dvz_free(cursor);
+    return topology;
+}
+
+
+
+/**
+ * Create the thread pool of a geometry operation, sized for its triangle count.
+ *
+ * Like the OBJ loader, each large operation owns a pool for its own duration, so geometries do
+ * not keep idle worker threads alive between calls.
+ *
+ * @param geometry the geometry
+ * @return a new thread pool, or NULL for geometries too small to benefit from threads
+ */
+static DvzThreadPool* _geom_pool(const DvzGeometry* geometry)
+{
+    if (geometry == NULL || geometry->index_count / 3 < DVZ_GEOM_PARALLEL_MIN_TRIANGLES)
+        return NULL;
+    return dvz_thread_pool(dvz_thread_pool_default_size());
+}
+
+
+
+/**
+ * Return the cached topology of a large indexed triangle geometry, rebuilding it if needed.
+ *
+ * The cache is keyed by the vertex count, the index count, and a hash of the index buffer, so
+ * in-place index edits are detected.
+ *
+ * @param geometry the geometry owning the cache
+ * @param pool thread pool of the calling operation, NULL for the serial paths
+ * @param out output topology, NULL when no pool is given or on allocation failure
+ * @return whether the geometry has valid indexed triangles
+ */
+static bool _geom_topology(DvzGeometry* geometry, DvzThreadPool* pool, DvzGeometryTopology** out)
+{
+    ANN(out);
+    *out = NULL;
+    if (geometry == NULL || geometry->vertex_count == 0 || geometry->index_count == 0 ||
+        geometry->indices == NULL || geometry->index_count % 3 != 0)
+    {
+        return false;
+    }
+    if (pool == NULL)
+        return _geom_valid_indexed_triangles(geometry);
+
+    DvzGeometryTopology* topology = geometry->topology;
+    uint64_t hash = 0;
+    if (topology != NULL && topology->vertex_count == geometry->vertex_count &&
+        topology->index_count == geometry->index_count &&
+        _geom_index_hash(geometry, pool, &hash) && hash == topology->index_hash)
+    {
+        *out = topology;
+        return true;
+    }
+
+    _geom_topology_destroy(topology);
+    geometry->topology = NULL;
+    if (!_geom_valid_indexed_triangles(geometry))
+        return false;
+
+    // On allocation failure, fall back to the serial paths.
+    geometry->topology = _geom_topology_build(geometry, pool);
+    *out = geometry->topology;
+    return true;
+}
+
+
+
+/**
+ * Accumulate and normalize the smooth normals of a range of vertex blocks.
+ *
+ * Each vertex sums the normals of its incident triangles in ascending triangle order, which
+ * matches the serial scatter accumulation bit for bit.
+ *
+ * @param begin first block
+ * @param end end block
+ * @param user_data normal gather state
+ */
+static void _geom_normal_gather_blocks(uint32_t begin, uint32_t end, void* user_data)
+{
+    struct _GeomNormalGather* state = (struct _GeomNormalGather*)user_data;
+    ANN(state);
+    DvzGeometry* geometry = state->geometry;
+    const DvzGeometryTopology* topology = state->topology;
+    const bool f32 = _geom_is_f32(geometry);
+
+    const uint32_t v0 = begin * DVZ_GEOM_BLOCK_VERTICES;
+    const uint32_t v1 = DVZ_MIN(geometry->vertex_count, end * DVZ_GEOM_BLOCK_VERTICES);
+    for (uint32_t v = v0; v < v1; v++)
+    {
+        dvec3 normal = {0};
+        vec3 normal_f32 = {0};
+        for (uint32_t k = topology->vertex_offsets[v]; k < topology->vertex_offsets[v + 1]; k++)
+        {
+            const uint32_t offset = 3 * topology->vertex_faces[k];
+            dvec3 n = {0};
+            if (!_geom_triangle_normal(
+                    geometry, geometry->indices[offset + 0], geometry->indices[offset + 1],
+                    geometry->indices[offset + 2], n))
+            {
+                continue;
+            }
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                if (f32)
+                    normal_f32[j] += (float)n[j];
+                else
+                    normal[j] += n[j];
+            }
+        }
+        if (f32)
+        {
+            normal[0] = normal_f32[0];
+            normal[1] = normal_f32[1];
+            normal[2] = normal_f32[2];
+        }
+        if (!_geom_dvec3_normalize(normal))
+        {
+            normal[0] = 0.0;
+            normal[1] = 0.0;
+            normal[2] = 1.0;
+        }
+        _geom_put_normal(geometry, v, normal);
+    }
+}
+
+
+
 /**
  * Store structured-grid provenance on a geometry.
  *
@@ -855,15 +1466,14 @@ static void _geom_surface_grid_update_position(
     ASSERT(col < geometry->grid_cols);
     const uint32_t index = row * geometry->grid_cols + col;
     const double scaled_height = height * geometry->grid_height_scale;
-    geometry->positions[index][0] =
-        geometry->grid_origin[0] + (double)col * geometry->grid_col_basis[0] +
-        (double)row * geometry->grid_row_basis[0] + scaled_height * geometry->grid_height_axis[0];
-    geometry->positions[index][1] =
-        geometry->grid_origin[1] + (double)col * geometry->grid_col_basis[1] +
-        (double)row * geometry->grid_row_basis[1] + scaled_height * geometry->grid_height_axis[1];
-    geometry->positions[index][2] =
-        geometry->grid_origin[2] + (double)col * geometry->grid_col_basis[2] +
-        (double)row * geometry->grid_row_basis[2] + scaled_height * geometry->grid_height_axis[2];
+    dvec3 position = {0};
+    for (uint32_t j = 0; j < 3; j++)
+    {
+        position[j] = geometry->grid_origin[j] + (double)col * geometry->grid_col_basis[j] +
+                      (double)row * geometry->grid_row_basis[j] +
+                      scaled_height * geometry->grid_height_axis[j];
+    }
+    _geom_put_position(geometry, index, position);
 }
 
 
@@ -882,8 +1492,8 @@ static DvzResult _geom_surface_grid_compute_normals(DvzGeometry* geometry)
 {
     ANN(geometry);
     if (
-        geometry->positions == NULL || geometry->normals == NULL || geometry->grid_rows < 2 ||
-        geometry->grid_cols < 2)
+        !_geom_has_positions(geometry) || !_geom_has_normals(geometry) ||
+        geometry->grid_rows < 2 || geometry->grid_cols < 2)
     {
         return DVZ_ERROR;
     }
@@ -898,10 +1508,11 @@ static DvzResult _geom_surface_grid_compute_normals(DvzGeometry* geometry)
         {
             const uint32_t col0 = col > 0 ? col - 1 : col;
             const uint32_t col1 = col + 1 < cols ? col + 1 : col;
-            const double* p_col0 = geometry->positions[row * cols + col0];
-            const double* p_col1 = geometry->positions[row * cols + col1];
-            const double* p_row0 = geometry->positions[row0 * cols + col];
-            const double* p_row1 = geometry->positions[row1 * cols + col];
+            dvec3 p_col0 = {0}, p_col1 = {0}, p_row0 = {0}, p_row1 = {0};
+            _geom_get_position(geometry, row * cols + col0, p_col0);
+            _geom_get_position(geometry, row * cols + col1, p_col1);
+            _geom_get_position(geometry, row0 * cols + col, p_row0);
+            _geom_get_position(geometry, row1 * cols + col, p_row1);
             const dvec3 col_tangent = {
                 p_col1[0] - p_col0[0],
                 p_col1[1] - p_col0[1],
@@ -912,14 +1523,15 @@ static DvzResult _geom_surface_grid_compute_normals(DvzGeometry* geometry)
                 p_row1[1] - p_row0[1],
                 p_row1[2] - p_row0[2],
             };
-            dvec3* normal = &geometry->normals[row * cols + col];
-            _geom_dvec3_cross(col_tangent, row_tangent, *normal);
-            if (!_geom_dvec3_normalize(*normal))
+            dvec3 normal = {0};
+            _geom_dvec3_cross(col_tangent, row_tangent, normal);
+            if (!_geom_dvec3_normalize(normal))
             {
-                (*normal)[0] = 0.0;
-                (*normal)[1] = 0.0;
-                (*normal)[2] = 1.0;
+                normal[0] = 0.0;
+                normal[1] = 0.0;
+                normal[2] = 1.0;
             }
+            _geom_put_normal(geometry, row * cols + col, normal);
         }
     }
     return DVZ_OK;
@@ -927,6 +1539,94 @@ static DvzResult _geom_surface_grid_compute_normals(DvzGeometry* geometry)
 
 
 
+/**
+ * Allocate a geometry object in one storage precision.
+ *
+ * @param vertex_count number of vertices
+ * @param index_count number of indices
+ * @param precision vertex attribute precision
+ * @return the new geometry, or NULL on failure
+ */
+static DvzGeometry* _geom_alloc(
+    uint32_t vertex_count, uint32_t index_count, DvzGeometryPrecision precision)
+{
+    const bool f32 = precision == DVZ_GEOMETRY_PRECISION_F32;
+    if (!_geom_allocation_valid(vertex_count, f32 ? sizeof(vec3) : sizeof(dvec3)) ||
+        !_geom_allocation_valid(vertex_count, sizeof(DvzColor)) ||
+        !_geom_allocation_valid(vertex_count, f32 ? sizeof(vec2) : sizeof(dvec2)) ||
+        !_geom_allocation_valid(index_count, sizeof(DvzIndex)))
+    {
+        log_error("geometry allocation size overflow");
+        return NULL;
+    }
+
+    DvzGeometry* geometry = (DvzGeometry*)dvz_calloc(1, sizeof(DvzGeometry));
+    if (geometry == NULL)
+        return NULL;
+
+    geometry->precision = f32 ? DVZ_GEOMETRY_PRECISION_F32 : DVZ_GEOMETRY_PRECISION_F64;
+    geometry->vertex_count = vertex_count;
+    geometry->index_count = index_count;
+
+    if (vertex_count > 0)
+    {
+        geometry->colors = (DvzColor*)dvz_calloc(vertex_count, sizeof(DvzColor));
+        if (f32)
+        {
+            geometry->positions_f32 = (vec3*)dvz_calloc(vertex_count, sizeof(vec3));
+            geometry->normals_f32 = (vec3*)dvz_calloc(vertex_count, sizeof(vec3));
+            geometry->texcoords_f32 = (vec2*)dvz_calloc(vertex_count, sizeof(vec2));
+        }
+        else
+        {
+            geometry->positions = (dvec3*)dvz_calloc(vertex_count, sizeof(dvec3));
+            geometry->normals = (dvec3*)dvz_calloc(vertex_count, sizeof(dvec3));
+            geometry->texcoords = (dvec2*)dvz_calloc(vertex_count, sizeof(dvec2));
+        }
+        if (!_geom_has_positions(geometry) || !_geom_has_normals(geometry) ||
+            geometry->colors == NULL || !_geom_has_texcoords(geometry))
+        {
+            dvz_geometry_destroy(geometry);
+            return NULL;
+        }
+    }
+
+    if (index_count > 0)
+    {
+        geometry->indices = (DvzIndex*)dvz_calloc(index_count, sizeof(DvzIndex));
+        if (geometry->indices == NULL)
+        {
+            dvz_geometry_destroy(geometry);
+            return NULL;
+        }
+    }
+
+    return geometry;
+}
+
+
+
+/**
+ * Convert a freshly built F64 geometry when a builder descriptor requests F32 storage.
+ *
+ * @param geometry the built geometry, or NULL
+ * @param desc_flags builder descriptor flags
+ * @return the geometry in the requested precision, or NULL on failure
+ */
+static DvzGeometry* _geom_finish(DvzGeometry* geometry, uint32_t desc_flags)
+{
+    if (geometry == NULL || (desc_flags & DVZ_GEOMETRY_DESC_F32) == 0)
+        return geometry;
+    if (dvz_geometry_set_precision(geometry, DVZ_GEOMETRY_PRECISION_F32) != DVZ_OK)
+    {
+        dvz_geometry_destroy(geometry);
+        return NULL;
+    }
+    return geometry;
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -1160,47 +1860,112 @@ DVZ_FFI_DESC_WRAPPER(geometry_torus_desc, DvzGeometryTorusDesc)
  */
 DvzGeometry* dvz_geometry(uint32_t vertex_count, uint32_t index_count)
 {
-    if (!_geom_allocation_valid(vertex_count, sizeof(dvec3)) ||
-        !_geom_allocation_valid(vertex_count, sizeof(DvzColor)) ||
-        !_geom_allocation_valid(vertex_count, sizeof(dvec2)) ||
-        !_geom_allocation_valid(index_count, sizeof(DvzIndex)))
-    {
-        log_error("geometry allocation size overflow");
-        return NULL;
-    }
+    return _geom_alloc(vertex_count, index_count, DVZ_GEOMETRY_PRECISION_F64);
+}
 
-    DvzGeometry* geometry = (DvzGeometry*)dvz_calloc(1, sizeof(DvzGeometry));
-    if (geometry == NULL)
-        return NULL;
 
-    geometry->vertex_count = vertex_count;
-    geometry->index_count = index_count;
 
-    if (vertex_count > 0)
+/**
+ * Allocate a geometry object with owned F32 vertex arrays.
+ *
+ * @param vertex_count number of vertices
+ * @param index_count number of indices
+ * @return the new geometry, or NULL on failure
+ */
+DvzGeometry* dvz_geometry_f32(uint32_t vertex_count, uint32_t index_count)
+{
+    return _geom_alloc(vertex_count, index_count, DVZ_GEOMETRY_PRECISION_F32);
+}
+
+
+
+/**
+ * Convert the vertex attributes of a geometry to another storage precision in place.
+ *
+ * @param geometry the geometry
+ * @param precision target precision
+ * @return DVZ_OK on success, DVZ_ERROR on invalid input or allocation failure
+ */
+DvzResult dvz_geometry_set_precision(DvzGeometry* geometry, DvzGeometryPrecision precision)
+{
+    if (geometry == NULL ||
+        (precision != DVZ_GEOMETRY_PRECISION_F64 && precision != DVZ_GEOMETRY_PRECISION_F32))
     {
-        geometry->positions = (dvec3*)dvz_calloc(vertex_count, sizeof(dvec3));
-        geometry->normals = (dvec3*)dvz_calloc(vertex_count, sizeof(dvec3));
-        geometry->colors = (DvzColor*)dvz_calloc(vertex_count, sizeof(DvzColor));
-        geometry->texcoords = (dvec2*)dvz_calloc(vertex_count, sizeof(dvec2));
-        if (geometry->positions == NULL || geometry->normals == NULL || geometry->colors == NULL ||
-            geometry->texcoords == NULL)
-        {
-            dvz_geometry_destroy(geometry);
-            return NULL;
-        }
+        return DVZ_ERROR;
+    }
+    if (geometry->precision == precision)
+        return DVZ_OK;
+
+    // Allocate the target arrays first so that a failure leaves the geometry untouched.
+    const bool f32 = precision == DVZ_GEOMETRY_PRECISION_F32;
+    const uint32_t n = geometry->vertex_count;
+    const bool has_positions = _geom_has_positions(geometry);
+    const bool has_normals = _geom_has_normals(geometry);
+    const bool has_texcoords = _geom_has_texcoords(geometry);
+    const DvzSize vec3_size = f32 ? sizeof(vec3) : sizeof(dvec3);
+    const DvzSize vec2_size = f32 ? sizeof(vec2) : sizeof(dvec2);
+    DvzGeometry converted = *geometry;
+    converted.precision = precision;
+    converted.positions = NULL;
+    converted.normals = NULL;
+    converted.texcoords = NULL;
+    converted.positions_f32 = NULL;
+    converted.normals_f32 = NULL;
+    converted.texcoords_f32 = NULL;
+    void* positions = has_positions && n > 0 ? dvz_calloc(n, vec3_size) : NULL;
+    void* normals = has_normals && n > 0 ? dvz_calloc(n, vec3_size) : NULL;
+    void* texcoords = has_texcoords && n > 0 ? dvz_calloc(n, vec2_size) : NULL;
+    if ((has_positions && n > 0 && positions == NULL) ||
+        (has_normals && n > 0 && normals == NULL) ||
+        (has_texcoords && n > 0 && texcoords == NULL))
+    {
+        dvz_free(positions);
+        dvz_free(normals);
+        dvz_free(texcoords);
+        return DVZ_ERROR;
+    }
+    if (f32)
+    {
+        converted.positions_f32 = (vec3*)positions;
+        converted.normals_f32 = (vec3*)normals;
+        converted.texcoords_f32 = (vec2*)texcoords;
+    }
+    else
+    {
+        converted.positions = (dvec3*)positions;
+        converted.normals = (dvec3*)normals;
+        converted.texcoords = (dvec2*)texcoords;
     }
 
-    if (index_count > 0)
+    for (uint32_t i = 0; i < n; i++)
     {
-        geometry->indices = (DvzIndex*)dvz_calloc(index_count, sizeof(DvzIndex));
-        if (geometry->indices == NULL)
+        dvec3 value = {0};
+        dvec2 texcoord = {0};
+        if (has_positions)
         {
-            dvz_geometry_destroy(geometry);
-            return NULL;
+            _geom_get_position(geometry, i, value);
+            _geom_put_position(&converted, i, value);
+        }
+        if (has_normals)
+        {
+            _geom_get_normal(geometry, i, value);
+            _geom_put_normal(&converted, i, value);
+        }
+        if (has_texcoords)
+        {
+            _geom_get_texcoord(geometry, i, texcoord);
+            _geom_put_texcoord(&converted, i, texcoord);
         }
     }
 
-    return geometry;
+    dvz_free(geometry->positions);
+    dvz_free(geometry->normals);
+    dvz_free(geometry->texcoords);
+    dvz_free(geometry->positions_f32);
+    dvz_free(geometry->normals_f32);
+    dvz_free(geometry->texcoords_f32);
+    *geometry = converted;
+    return DVZ_OK;
 }
 
 
@@ -1220,6 +1985,10 @@ DvzResult dvz_geometry_reset(DvzGeometry* geometry)
     dvz_free(geometry->colors);
     dvz_free(geometry->texcoords);
     dvz_free(geometry->indices);
+    dvz_free(geometry->positions_f32);
+    dvz_free(geometry->normals_f32);
+    dvz_free(geometry->texcoords_f32);
+    _geom_topology_destroy(geometry->topology);
 
     dvz_memset(geometry, sizeof(DvzGeometry), 0, sizeof(DvzGeometry));
     return DVZ_OK;
@@ -1251,7 +2020,7 @@ void dvz_geometry_destroy(DvzGeometry* geometry)
  */
 DvzGeometryBounds dvz_geometry_bounds(const DvzGeometry* geometry)
 {
-    if (geometry == NULL || geometry->vertex_count == 0 || geometry->positions == NULL)
+    if (geometry == NULL || geometry->vertex_count == 0 || !_geom_has_positions(geometry))
         return (DvzGeometryBounds){0};
 
     double xmin = DBL_MAX;
@@ -1263,7 +2032,8 @@ DvzGeometryBounds dvz_geometry_bounds(const DvzGeometry* geometry)
 
     for (uint32_t i = 0; i < geometry->vertex_count; i++)
     {
-        const double* p = geometry->positions[i];
+        dvec3 p = {0};
+        _geom_get_position(geometry, i, p);
         xmin = p[0] < xmin ? p[0] : xmin;
         xmax = p[0] > xmax ? p[0] : xmax;
         ymin = p[1] < ymin ? p[1] : ymin;
@@ -1286,15 +2056,36 @@ DvzGeometryBounds dvz_geometry_bounds(const DvzGeometry* geometry)
  */
 DvzResult dvz_geometry_compute_normals(DvzGeometry* geometry)
 {
-    if (geometry == NULL || geometry->positions == NULL || geometry->normals == NULL ||
+    if (geometry == NULL || !_geom_has_positions(geometry) || !_geom_has_normals(geometry) ||
         geometry->indices == NULL || geometry->vertex_count == 0 || geometry->index_count == 0 ||
         geometry->index_count % 3 != 0)
     {
         return -1;
     }
 
-    dvz_memset(geometry->normals, geometry->vertex_count * sizeof(dvec3), 0,
-               geometry->vertex_count * sizeof(dvec3));
+    DvzThreadPool* pool = _geom_pool(geometry);
+    DvzGeometryTopology* topology = NULL;
+    if (!_geom_topology(geometry, pool, &topology))
+    {
+        dvz_thread_pool_destroy(pool);
+        return -1;
+    }
+    if (topology != NULL)
+    {
+        struct _GeomNormalGather state = {.geometry = geometry, .topology = topology};
+        const uint32_t block_count =
+            (geometry->vertex_count + DVZ_GEOM_BLOCK_VERTICES - 1) / DVZ_GEOM_BLOCK_VERTICES;
+        dvz_thread_pool_parallel_for(pool, block_count, 1, _geom_normal_gather_blocks, &state);
+        dvz_thread_pool_destroy(pool);
+        return 0;
+    }
+    dvz_thread_pool_destroy(pool);
+
+    const bool f32 = _geom_is_f32(geometry);
+    void* normals = f32 ? (void*)geometry->normals_f32 : (void*)geometry->normals;
+    const DvzSize normal_size = f32 ? sizeof(vec3) : sizeof(dvec3);
+    dvz_memset(normals, geometry->vertex_count * normal_size, 0,
+               geometry->vertex_count * normal_size);
 
     for (uint32_t i = 0; i < geometry->index_count; i += 3)
     {
@@ -1311,6 +2102,16 @@ DvzResult dvz_geometry_compute_normals(DvzGeometry* geometry)
         if (!_geom_triangle_normal(geometry, i0, i1, i2, n))
             continue;
 
+        if (f32)
+        {
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                geometry->normals_f32[i0][j] += (float)n[j];
+                geometry->normals_f32[i1][j] += (float)n[j];
+                geometry->normals_f32[i2][j] += (float)n[j];
+            }
+            continue;
+        }
         for (uint32_t j = 0; j < 3; j++)
         {
             geometry->normals[i0][j] += n[j];
@@ -1321,12 +2122,15 @@ DvzResult dvz_geometry_compute_normals(DvzGeometry* geometry)
 
     for (uint32_t i = 0; i < geometry->vertex_count; i++)
     {
-        if (!_geom_dvec3_normalize(geometry->normals[i]))
+        dvec3 normal = {0};
+        _geom_get_normal(geometry, i, normal);
+        if (!_geom_dvec3_normalize(normal))
         {
-            geometry->normals[i][0] = 0.0;
-            geometry->normals[i][1] = 0.0;
-            geometry->normals[i][2] = 1.0;
+            normal[0] = 0.0;
+            normal[1] = 0.0;
+            normal[2] = 1.0;
         }
+        _geom_put_normal(geometry, i, normal);
     }
     return 0;
 }
@@ -1342,7 +2146,7 @@ DvzResult dvz_geometry_compute_normals(DvzGeometry* geometry)
  */
 DvzResult dvz_geometry_transform(DvzGeometry* geometry, dmat4 transform)
 {
-    if (geometry == NULL || transform == NULL || geometry->positions == NULL ||
+    if (geometry == NULL || transform == NULL || !_geom_has_positions(geometry) ||
         geometry->vertex_count == 0)
     {
         return -1;
@@ -1354,7 +2158,8 @@ DvzResult dvz_geometry_transform(DvzGeometry* geometry, dmat4 transform)
     const double det = a00 * (a11 * a22 - a12 * a21) -
                        a01 * (a10 * a22 - a12 * a20) +
                        a02 * (a10 * a21 - a11 * a20);
-    if (geometry->normals != NULL && fabs(det) <= DVZ_EPSILON)
+    const bool has_normals = _geom_has_normals(geometry);
+    if (has_normals && fabs(det) <= DVZ_EPSILON)
         return -1;
 
     const double inv_det = det != 0.0 ? 1.0 / det : 0.0;
@@ -1369,19 +2174,27 @@ DvzResult dvz_geometry_transform(DvzGeometry* geometry, dmat4 transform)
     const double n22 = (a00 * a11 - a01 * a10) * inv_det;
 
     for (uint32_t i = 0; i < geometry->vertex_count; i++)
-        dvz_dmat4_mulv3(transform, geometry->positions[i], 1.0, geometry->positions[i]);
+    {
+        dvec3 position = {0};
+        _geom_get_position(geometry, i, position);
+        dvz_dmat4_mulv3(transform, position, 1.0, position);
+        _geom_put_position(geometry, i, position);
+    }
 
-    if (geometry->normals != NULL)
+    if (has_normals)
     {
         for (uint32_t i = 0; i < geometry->vertex_count; i++)
         {
-            const double x = geometry->normals[i][0];
-            const double y = geometry->normals[i][1];
-            const double z = geometry->normals[i][2];
-            geometry->normals[i][0] = n00 * x + n01 * y + n02 * z;
-            geometry->normals[i][1] = n10 * x + n11 * y + n12 * z;
-            geometry->normals[i][2] = n20 * x + n21 * y + n22 * z;
-            _geom_dvec3_normalize(geometry->normals[i]);
+            dvec3 normal = {0};
+            _geom_get_normal(geometry, i, normal);
+            const double x = normal[0];
+            const double y = normal[1];
+            const double z = normal[2];
+            normal[0] = n00 * x + n01 * y + n02 * z;
+            normal[1] = n10 * x + n11 * y + n12 * z;
+            normal[2] = n20 * x + n21 * y + n22 * z;
+            _geom_dvec3_normalize(normal);
+            _geom_put_normal(geometry, i, normal);
         }
     }
 
@@ -1404,11 +2217,13 @@ DvzGeometry* dvz_geometry_merge(uint32_t count, const DvzGeometry* const* geomet
 
     uint64_t vertex_count = 0;
     uint64_t index_count = 0;
+    bool all_f32 = true;
     for (uint32_t i = 0; i < count; i++)
     {
         const DvzGeometry* geometry = geometries[i];
         if (!_geom_valid_payload(geometry))
             return NULL;
+        all_f32 = all_f32 && _geom_is_f32(geometry);
 
         if (_dvz_add_u64_overflows(vertex_count, geometry->vertex_count, &vertex_count) ||
             _dvz_add_u64_overflows(index_count, geometry->index_count, &index_count) ||
@@ -1418,7 +2233,10 @@ DvzGeometry* dvz_geometry_merge(uint32_t count, const DvzGeometry* const* geomet
         }
     }
 
-    DvzGeometry* out = dvz_geometry((uint32_t)vertex_count, (uint32_t)index_count);
+    // F32 inputs only produce an F32 output, so that merging never silently drops precision.
+    DvzGeometry* out = _geom_alloc(
+        (uint32_t)vertex_count, (uint32_t)index_count,
+        all_f32 ? DVZ_GEOMETRY_PRECISION_F32 : DVZ_GEOMETRY_PRECISION_F64);
     if (out == NULL)
         return NULL;
 
@@ -1430,18 +2248,57 @@ DvzGeometry* dvz_geometry_merge(uint32_t count, const DvzGeometry* const* geomet
     for (uint32_t i = 0; i < count; i++)
     {
         const DvzGeometry* geometry = geometries[i];
-        const uint64_t position_size = (uint64_t)geometry->vertex_count * sizeof(dvec3);
         const uint64_t color_size = (uint64_t)geometry->vertex_count * sizeof(DvzColor);
-        const uint64_t texcoord_size = (uint64_t)geometry->vertex_count * sizeof(dvec2);
-
-        dvz_memcpy(&out->positions[vertex_offset], position_size, geometry->positions, position_size);
-        if (geometry->normals != NULL)
-            dvz_memcpy(&out->normals[vertex_offset], position_size, geometry->normals, position_size);
+        if (all_f32)
+        {
+            const uint64_t position_size = (uint64_t)geometry->vertex_count * sizeof(vec3);
+            const uint64_t texcoord_size = (uint64_t)geometry->vertex_count * sizeof(vec2);
+            dvz_memcpy(
+                &out->positions_f32[vertex_offset], position_size, geometry->positions_f32,
+                position_size);
+            if (geometry->normals_f32 != NULL)
+                dvz_memcpy(
+                    &out->normals_f32[vertex_offset], position_size, geometry->normals_f32,
+                    position_size);
+            dvz_memcpy(
+                &out->texcoords_f32[vertex_offset], texcoord_size, geometry->texcoords_f32,
+                texcoord_size);
+        }
+        else if (!_geom_is_f32(geometry))
+        {
+            const uint64_t position_size = (uint64_t)geometry->vertex_count * sizeof(dvec3);
+            const uint64_t texcoord_size = (uint64_t)geometry->vertex_count * sizeof(dvec2);
+            dvz_memcpy(
+                &out->positions[vertex_offset], position_size, geometry->positions,
+                position_size);
+            if (geometry->normals != NULL)
+                dvz_memcpy(
+                    &out->normals[vertex_offset], position_size, geometry->normals,
+                    position_size);
+            dvz_memcpy(
+                &out->texcoords[vertex_offset], texcoord_size, geometry->texcoords,
+                texcoord_size);
+        }
+        else
+        {
+            const bool has_normals = _geom_has_normals(geometry);
+            for (uint32_t j = 0; j < geometry->vertex_count; j++)
+            {
+                dvec3 value = {0};
+                dvec2 texcoord = {0};
+                _geom_get_position(geometry, j, value);
+                _geom_put_position(out, vertex_offset + j, value);
+                if (has_normals)
+                {
+                    _geom_get_normal(geometry, j, value);
+                    _geom_put_normal(out, vertex_offset + j, value);
+                }
+                _geom_get_texcoord(geometry, j, texcoord);
+                _geom_put_texcoord(out, vertex_offset + j, texcoord);
+            }
+        }
         if (geometry->colors != NULL)
             dvz_memcpy(&out->colors[vertex_offset], color_size, geometry->colors, color_size);
-        if (geometry->texcoords != NULL)
-            dvz_memcpy(
-                &out->texcoords[vertex_offset], texcoord_size, geometry->texcoords, texcoord_size);
 
         for (uint32_t j = 0; j < geometry->index_count; j++)
         {
@@ -1589,11 +2446,11 @@ void dvz_geometry_edges_destroy(DvzGeometryEdges* edges)
  * @return the extracted contour segments, or NULL on invalid input or allocation failure
  */
 DvzGeometryContours* dvz_geometry_contours(
-    const DvzGeometry* geometry, const double* values, uint32_t value_count, const double* levels,
+    DvzGeometry* geometry, const double* values, uint32_t value_count, const double* levels,
     uint32_t level_count)
 {
-    if (!_geom_valid_indexed_triangles(geometry) || geometry->positions == NULL || values == NULL ||
-        levels == NULL || value_count != geometry->vertex_count || level_count == 0)
+    if (!_geom_has_positions(geometry) || values == NULL || levels == NULL ||
+        value_count != geometry->vertex_count || level_count == 0)
     {
         return NULL;
     }
@@ -1601,70 +2458,74 @@ DvzGeometryContours* dvz_geometry_contours(
     const uint32_t triangle_count = geometry->index_count / 3;
     uint64_t max_segments_u64 = 0;
     if (_dvz_mul_u64_overflows((uint64_t)triangle_count, (uint64_t)level_count, &max_segments_u64) ||
-        max_segments_u64 > UINT32_MAX ||
-        !_geom_allocation_valid(
-            (uint32_t)max_segments_u64, sizeof(DvzGeometryContourSegment)))
+        max_segments_u64 > UINT32_MAX)
     {
         return NULL;
     }
-    const uint32_t max_segments = (uint32_t)max_segments_u64;
 
-    DvzGeometryContours* out = (DvzGeometryContours*)dvz_calloc(1, sizeof(DvzGeometryContours));
-    if (out == NULL)
+    DvzThreadPool* pool = _geom_pool(geometry);
+    DvzGeometryTopology* topology = NULL;
+    if (!_geom_topology(geometry, pool, &topology))
+    {
+        dvz_thread_pool_destroy(pool);
         return NULL;
+    }
 
-    if (max_segments > 0)
+    bool sorted_levels = isfinite(levels[0]);
+    for (uint32_t i = 1; i < level_count && sorted_levels; i++)
+        sorted_levels = isfinite(levels[i]) && levels[i - 1] <= levels[i];
+
+    // First pass: count the segments of each triangle block. Second pass: write them at the
+    // prefix-summed block offsets, in the same face and level order as a serial scan.
+    const uint32_t block_count =
+        (triangle_count + DVZ_GEOM_BLOCK_TRIANGLES - 1) / DVZ_GEOM_BLOCK_TRIANGLES;
+    struct _GeomContourPass pass = {
+        .geometry = geometry,
+        .values = values,
+        .levels = levels,
+        .level_count = level_count,
+        .sorted_levels = sorted_levels,
+        .block_counts = (uint32_t*)dvz_calloc(block_count, sizeof(uint32_t)),
+        .block_offsets = NULL,
+    };
+    uint32_t* block_offsets = (uint32_t*)dvz_calloc(block_count, sizeof(uint32_t));
+    DvzGeometryContours* out = (DvzGeometryContours*)dvz_calloc(1, sizeof(DvzGeometryContours));
+    if (pass.block_counts == NULL || block_offsets == NULL || out == NULL)
+        goto error;
+
+    dvz_thread_pool_parallel_for(pool, block_count, 1, _geom_contour_blocks, &pass);
+    uint32_t segment_count = 0;
+    for (uint32_t block = 0; block < block_count; block++)
     {
-        out->segments =
-            (DvzGeometryContourSegment*)dvz_calloc(max_segments, sizeof(DvzGeometryContourSegment));
-        if (out->segments == NULL)
-        {
-            dvz_free(out);
-            return NULL;
-        }
+        block_offsets[block] = segment_count;
+        segment_count += pass.block_counts[block];
     }
 
-    for (uint32_t face = 0; face < triangle_count; face++)
+    if (segment_count > 0)
     {
-        const uint32_t offset = 3 * face;
-        const DvzIndex i0 = geometry->indices[offset + 0];
-        const DvzIndex i1 = geometry->indices[offset + 1];
-        const DvzIndex i2 = geometry->indices[offset + 2];
-        const double s0 = values[i0];
-        const double s1 = values[i1];
-        const double s2 = values[i2];
-        if (!isfinite(s0) || !isfinite(s1) || !isfinite(s2))
-            continue;
-
-        for (uint32_t level_index = 0; level_index < level_count; level_index++)
-        {
-            const double level = levels[level_index];
-            if (!isfinite(level))
-                continue;
-
-            dvec3 points[3] = {{0}};
-            uint32_t point_count = 0;
-            _geom_contour_intersection(
-                geometry, i0, i1, s0, s1, level, points, &point_count);
-            _geom_contour_intersection(
-                geometry, i1, i2, s1, s2, level, points, &point_count);
-            _geom_contour_intersection(
-                geometry, i2, i0, s2, s0, level, points, &point_count);
-
-            if (point_count != 2 || _geom_dvec3_nearly_equal(points[0], points[1]))
-                continue;
-
-            ASSERT(out->segment_count < max_segments);
-            DvzGeometryContourSegment* segment = &out->segments[out->segment_count++];
-            dvz_memcpy(segment->p0, sizeof(dvec3), points[0], sizeof(dvec3));
-            dvz_memcpy(segment->p1, sizeof(dvec3), points[1], sizeof(dvec3));
-            segment->level = level;
-            segment->level_index = level_index;
-            segment->face_index = face;
-        }
+        if (!_geom_allocation_valid(segment_count, sizeof(DvzGeometryContourSegment)))
+            goto error;
+        out->segments = (DvzGeometryContourSegment*)dvz_calloc(
+            segment_count, sizeof(DvzGeometryContourSegment));
+        if (out->segments == NULL)
+            goto error;
+        pass.block_offsets = block_offsets;
+        pass.segments = out->segments;
+        dvz_thread_pool_parallel_for(pool, block_count, 1, _geom_contour_blocks, &pass);
     }
+    out->segment_count = segment_count;
 
+    dvz_free(pass.block_counts);
+    dvz_free(block_offsets);
+    dvz_thread_pool_destroy(pool);
     return out;
+
+error:
+    dvz_free(pass.block_counts);
+    dvz_free(block_offsets);
+    dvz_thread_pool_destroy(pool);
+    dvz_geometry_contours_destroy(out);
+    return NULL;
 }
 
 
@@ -1761,7 +2622,7 @@ DvzGeometry* dvz_geometry_cube(const DvzGeometryCubeDesc* desc)
         _geom_set_index(geometry, index_base + 5, base + 3);
     }
 
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -1815,7 +2676,7 @@ DvzGeometry* dvz_geometry_plane(const DvzGeometryPlaneDesc* desc)
     _geom_set_index(geometry, 4, 2);
     _geom_set_index(geometry, 5, 3);
 
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -1899,7 +2760,7 @@ DvzGeometry* dvz_geometry_sphere(const DvzGeometrySphereDesc* desc)
         }
     }
 
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -1974,7 +2835,7 @@ DvzGeometry* dvz_geometry_surface_grid(const DvzGeometrySurfaceGridDesc* desc)
         return NULL;
     }
 
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -1991,7 +2852,7 @@ DvzResult dvz_geometry_surface_grid_update_heights(
     DvzGeometry* geometry, const double* heights, uint32_t count)
 {
     if (geometry == NULL || heights == NULL || geometry->type != DVZ_GEOMETRY_SURFACE_GRID ||
-        geometry->positions == NULL || geometry->grid_rows < 2 || geometry->grid_cols < 2 ||
+        !_geom_has_positions(geometry) || geometry->grid_rows < 2 || geometry->grid_cols < 2 ||
         count != geometry->vertex_count || geometry->vertex_count == 0)
     {
         return -1;
@@ -2072,7 +2933,7 @@ DvzGeometry* dvz_geometry_disc(const DvzGeometryDiscDesc* desc)
         _geom_set_vertex(geometry, i + 1u, position, normal, uv, color);
     }
     _geom_set_fan_indices(geometry, cfg.segments);
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -2145,7 +3006,7 @@ DvzGeometry* dvz_geometry_sector(const DvzGeometrySectorDesc* desc)
             _geom_set_index(geometry, 3u * i + 2u, i + 1u);
         }
     }
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -2168,13 +3029,14 @@ DvzGeometry* dvz_geometry_regular_polygon(const DvzGeometryRegularPolygonDesc* d
     if (cfg.radius <= 0.0 || cfg.sides < 3u)
         return NULL;
 
-    return dvz_geometry_disc(&(DvzGeometryDiscDesc){
+    DvzGeometry* geometry = dvz_geometry_disc(&(DvzGeometryDiscDesc){
         DVZ_STRUCT_INIT_FIELDS(DvzGeometryDiscDesc),
         .center = {cfg.center[0], cfg.center[1], cfg.center[2]},
         .radius = cfg.radius,
         .segments = cfg.sides,
         .color = cfg.color,
     });
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -2235,7 +3097,7 @@ DvzGeometry* dvz_geometry_star(const DvzGeometryStarDesc* desc)
         _geom_set_vertex(geometry, i + 1u, position, normal, uv, color);
     }
     _geom_set_fan_indices(geometry, outer_count);
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -2345,7 +3207,7 @@ DvzGeometry* dvz_geometry_cylinder(const DvzGeometryCylinderDesc* desc)
         _geom_set_index(geometry, index++, bottom_base + 2u + i);
         _geom_set_index(geometry, index++, bottom_base + 1u + i);
     }
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -2429,7 +3291,7 @@ DvzGeometry* dvz_geometry_cone(const DvzGeometryConeDesc* desc)
         _geom_set_index(geometry, index++, cap_base + 2u + i);
         _geom_set_index(geometry, index++, cap_base + 1u + i);
     }
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -2519,7 +3381,7 @@ DvzGeometry* dvz_geometry_torus(const DvzGeometryTorusDesc* desc)
             _geom_set_index(geometry, index++, i1);
         }
     }
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
 
 
@@ -2578,5 +3440,5 @@ DvzGeometry* dvz_geometry_arrow(const DvzGeometryArrowDesc* desc)
     dvz_geometry_destroy(head);
     if (geometry != NULL)
         geometry->type = DVZ_GEOMETRY_ARROW;
-    return geometry;
+    return _geom_finish(geometry, cfg.flags);
 }
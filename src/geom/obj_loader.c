@@ -20,12 +20,25 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+
+#if defined(_WIN32) || defined(_MSC_VER)
+#include <io.h>
+#include <process.h>
+#include <windows.h>
+#define OBJ_PID() ((unsigned long)_getpid())
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#define OBJ_PID() ((unsigned long)getpid())
+#endif
 
 #include "_alloc.h"
 #include "_assertions.h"
 #include "_log.h"
 #include "_overflow.h"
 #include "datoviz/geom.h"
+#include "thread_internal.h"
 
 
 
@@ -33,9 +46,17 @@
 /*  Constants                                                                                    */
 /*************************************************************************************************/
 
-#define DVZ_GEOMETRY_OBJ_DESC_KNOWN_FLAGS 0u
+#define DVZ_GEOMETRY_OBJ_DESC_KNOWN_FLAGS DVZ_GEOMETRY_DESC_F32
 #define OBJ_LINE_MAX                      2048
 #define OBJ_FACE_MAX                      128
+#define OBJ_CHUNK_SIZE                    (1u << 20)
+#define OBJ_CHUNK_MAX                     4096
+#define OBJ_EXPAND_GRAIN                  (1u << 16)
+#define OBJ_FAST_DIGITS_MAX               19
+#define OBJ_FAST_EXP_MAX                  22
+#define OBJ_CACHE_MAGIC                   0x0048534D5A5644ull /* "DVZMSH" */
+#define OBJ_CACHE_VERSION                 1
+#define OBJ_CACHE_PATH_MAX                1024
 
 
 
@@ -43,6 +64,17 @@
 /*  Structs                                                                                      */
 /*************************************************************************************************/
 
+typedef enum
+{
+    OBJ_RECORD_OTHER,
+    OBJ_RECORD_POSITION,
+    OBJ_RECORD_NORMAL,
+    OBJ_RECORD_TEXCOORD,
+    OBJ_RECORD_FACE,
+} ObjRecord;
+
+
+
 typedef struct ObjFaceVertex
 {
     uint32_t position;
@@ -56,38 +88,101 @@ typedef struct ObjArrays
 {
     dvec3* positions;
     uint32_t position_count;
-    uint32_t position_capacity;
 
     dvec3* normals;
     uint32_t normal_count;
-    uint32_t normal_capacity;
 
     dvec2* texcoords;
     uint32_t texcoord_count;
-    uint32_t texcoord_capacity;
 
     ObjFaceVertex* vertices;
     uint32_t vertex_count;
-    uint32_t vertex_capacity;
 } ObjArrays;
 
 
 
-/*************************************************************************************************/
-/*  Helpers                                                                                      */
-/*************************************************************************************************/
+// Line-aligned byte range of the file parsed by one task.
+typedef struct ObjChunk
+{
+    const char* begin;
+    const char* end;
+
+    // Record counts of this chunk, from the counting pass.
+    uint32_t position_count;
+    uint32_t normal_count;
+    uint32_t texcoord_count;
+    uint32_t vertex_count;
+
+    // Records of all previous chunks, used to resolve relative indices and write in place.
+    uint32_t position_offset;
+    uint32_t normal_offset;
+    uint32_t texcoord_offset;
+    uint32_t vertex_offset;
+
+    bool missing_normal;
+    bool ok;
+} ObjChunk;
+
+
+
+typedef struct ObjParse
+{
+    ObjChunk* chunks;
+    uint32_t chunk_count;
+    ObjArrays arrays;
+} ObjParse;
+
+
+
+typedef struct ObjExpand
+{
+    const ObjArrays* arrays;
+    DvzGeometry* geometry;
+    DvzColor color;
+} ObjExpand;
+
+
 
-static char* _obj_strtok(char* str, const char* delimiters, char** context)
+// Read-only view of a whole file, memory-mapped when possible.
+typedef struct ObjMap
 {
+    const char* data;
+    DvzSize size;
+    void* map;
+    void* owned;
 #if defined(_WIN32) || defined(_MSC_VER)
-    return strtok_s(str, delimiters, context);
-#else
-    return strtok_r(str, delimiters, context);
+    HANDLE mapping;
 #endif
-}
+} ObjMap;
+
+
+
+// Identity of the source file a cache entry was built from.
+typedef struct ObjStamp
+{
+    uint64_t size;
+    int64_t mtime_ns;
+} ObjStamp;
 
 
 
+typedef struct ObjCacheHeader
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t precision;
+    uint64_t source_size;
+    int64_t source_mtime_ns;
+    uint32_t vertex_count;
+    uint32_t reserved;
+} ObjCacheHeader;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
 static bool _obj_desc_validate(const DvzGeometryObjDesc* desc)
 {
     if (desc == NULL)
@@ -113,17 +208,235 @@ static void _obj_color_or_default(const DvzColor color, DvzColor* out)
 
 
 
+static inline char _obj_char(const char* p, const char* stop, size_t offset)
+{
+    return (size_t)(stop - p) > offset ? p[offset] : '\0';
+}
+
+
+
+static inline bool _obj_is_delimiter(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+
+
+/*************************************************************************************************/
+/*  File mapping                                                                                 */
+/*************************************************************************************************/
+
+/**
+ * Map a whole file read-only, or read it into memory when it cannot be mapped.
+ *
+ * @param filename file path
+ * @param out receives the file view; `data` is NULL for an empty file
+ * @return whether the file could be read
+ */
+static bool _obj_map_open(const char* filename, ObjMap* out)
+{
+    ANN(filename);
+    ANN(out);
+    memset(out, 0, sizeof(*out));
+
+    FILE* fp = fopen(filename, "rb");
+    if (fp == NULL)
+        return false;
+#if defined(_WIN32) || defined(_MSC_VER)
+    const int64_t size = _fseeki64(fp, 0, SEEK_END) == 0 ? _ftelli64(fp) : -1;
+#else
+    const int64_t size = fseeko(fp, 0, SEEK_END) == 0 ? (int64_t)ftello(fp) : -1;
+#endif
+    if (size < 0 || (uint64_t)size > (uint64_t)SIZE_MAX)
+    {
+        fclose(fp);
+        return false;
+    }
+    out->size = (DvzSize)size;
+    if (size == 0)
+    {
+        fclose(fp);
+        return true;
+    }
+
+#if defined(_WIN32) || defined(_MSC_VER)
+    HANDLE handle = (HANDLE)_get_osfhandle(_fileno(fp));
+    HANDLE mapping = handle == INVALID_HANDLE_VALUE
+                         ? NULL
+                         : CreateFileMappingW(handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    void* base = mapping != NULL ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if (base == NULL && mapping != NULL)
+        CloseHandle(mapping);
+    else
+        out->mapping = mapping;
+#else
+    void* base = mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if (base == MAP_FAILED)
+        base = NULL;
+#endif
+    if (base != NULL)
+    {
+        out->map = base;
+        out->data = (const char*)base;
+        fclose(fp);
+        return true;
+    }
+
+    // Fall back to a single buffered read, e.g. for special files that cannot be mapped.
+    out->owned = dvz_malloc((DvzSize)size);
+    bool ok = out->owned != NULL && fseek(fp, 0, SEEK_SET) == 0 &&
+              fread(out->owned, 1, (size_t)size, fp) == (size_t)size;
+    fclose(fp);
+    if (!ok)
+    {
+        dvz_free(out->owned);
+        out->owned = NULL;
+        return false;
+    }
+    out->data = (const char*)out->owned;
+    return true;
+}
+
+
+
+static void _obj_map_close(ObjMap* map)
+{
+    ANN(map);
+    if (map->map != NULL)
+    {
+#if defined(_WIN32) || defined(_MSC_VER)
+        UnmapViewOfFile(map->map);
+        CloseHandle(map->mapping);
+#else
+        munmap(map->map, (size_t)map->size);
+#endif
+    }
+    dvz_free(map->owned);
+    memset(map, 0, sizeof(*map));
+}
+
+
+
+/*************************************************************************************************/
+/*  Record parsing                                                                               */
+/*************************************************************************************************/
+
+/**
+ * Parse one floating-point number with `strtod()` on a NUL-terminated copy of the line.
+ *
+ * @param p start of the number
+ * @param stop end of the line
+ * @param out receives the parsed value
+ * @return pointer past the number, or NULL if no number could be parsed
+ */
+static const char* _obj_parse_double_slow(const char* p, const char* stop, double* out)
+{
+    char buffer[OBJ_LINE_MAX] = {0};
+    const size_t length = DVZ_MIN((size_t)(stop - p), sizeof(buffer) - 1);
+    memcpy(buffer, p, length);
+    errno = 0;
+    char* end = NULL;
+    const double value = strtod(buffer, &end);
+    if (errno == ERANGE || end == buffer)
+        return NULL;
+    *out = value;
+    return p + (end - buffer);
+}
+
+
+
+/**
+ * Parse one decimal floating-point number.
+ *
+ * Plain decimal values with at most 19 significant digits and a small exponent are converted
+ * exactly with one multiplication or division; anything else (hex floats, infinities, long
+ * mantissas) falls back to `strtod()` on a bounded copy, so results always match `strtod()`.
+ *
+ * @param p start of the number
+ * @param stop end of the line
+ * @param out receives the parsed value
+ * @return pointer past the number, or NULL if no number could be parsed
+ */
+static const char* _obj_parse_double(const char* p, const char* stop, double* out)
+{
+    static const double powers[OBJ_FAST_EXP_MAX + 1] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    const char* q = p;
+    const bool negative = q < stop && *q == '-';
+    if (q < stop && (*q == '-' || *q == '+'))
+        q++;
+
+    uint64_t mantissa = 0;
+    int32_t digits = 0;
+    int32_t exponent = 0;
+    bool any = false;
+    for (; q < stop && *q >= '0' && *q <= '9'; q++, any = true)
+    {
+        if (mantissa != 0 || *q != '0')
+            digits++;
+        mantissa = mantissa * 10u + (uint64_t)(*q - '0');
+    }
+    if (q < stop && *q == '.')
+    {
+        for (q++; q < stop && *q >= '0' && *q <= '9'; q++, any = true)
+        {
+            if (mantissa != 0 || *q != '0')
+                digits++;
+            mantissa = mantissa * 10u + (uint64_t)(*q - '0');
+            exponent--;
+        }
+    }
+    if (any && q < stop && (*q == 'e' || *q == 'E'))
+    {
+        const char* e = q + 1;
+        const bool exp_negative = e < stop && *e == '-';
+        if (e < stop && (*e == '-' || *e == '+'))
+            e++;
+        int32_t value = 0;
+        const char* exp_digits = e;
+        for (; e < stop && *e >= '0' && *e <= '9' && value < 10000; e++)
+            value = value * 10 + (*e - '0');
+        if (e > exp_digits && (e >= stop || *e < '0' || *e > '9'))
+        {
+            exponent += exp_negative ? -value : value;
+            q = e;
+        }
+        else if (e > exp_digits)
+        {
+            return _obj_parse_double_slow(p, stop, out);
+        }
+    }
+
+    const bool fast = any && digits <= OBJ_FAST_DIGITS_MAX && mantissa <= (1ull << 53) &&
+                      exponent >= -OBJ_FAST_EXP_MAX && exponent <= OBJ_FAST_EXP_MAX &&
+                      (q >= stop || (*q != 'x' && *q != 'X'));
+    if (!fast)
+        return _obj_parse_double_slow(p, stop, out);
+
+    double value = (double)mantissa;
+    value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+    *out = negative ? -value : value;
+    return q;
+}
+
+
+
 /**
  * Parse a bounded sequence of finite floating-point values.
  *
  * @param text source text after the OBJ record prefix
+ * @param stop end of the line
  * @param required_count number of required values copied to @p values
  * @param max_count maximum number of values permitted by the OBJ record
  * @param values output values with room for @p required_count elements
  * @return whether the complete record is valid
  */
 static bool _obj_parse_values(
-    const char* text, uint32_t required_count, uint32_t max_count, double* values)
+    const char* text, const char* stop, uint32_t required_count, uint32_t max_count,
+    double* values)
 {
     ANN(text);
     ANN(values);
@@ -133,17 +446,16 @@ static bool _obj_parse_values(
     uint32_t count = 0;
     while (true)
     {
-        while (isspace((unsigned char)*text))
+        while (text < stop && isspace((unsigned char)*text))
             text++;
-        if (*text == '\0' || *text == '#')
+        if (text >= stop || *text == '#')
             break;
         if (count >= max_count)
             return false;
 
-        errno = 0;
-        char* end = NULL;
-        const double value = strtod(text, &end);
-        if (errno == ERANGE || end == text || !isfinite(value))
+        double value = 0;
+        const char* end = _obj_parse_double(text, stop, &value);
+        if (end == NULL || !isfinite(value))
             return false;
         if (count < required_count)
             values[count] = value;
@@ -155,173 +467,204 @@ static bool _obj_parse_values(
 
 
 
-static bool _obj_reserve(void** data, uint32_t* capacity, uint32_t count, DvzSize item_size)
+/**
+ * Classify an OBJ line and skip its record prefix.
+ *
+ * @param cursor start of the line, advanced past the record prefix
+ * @param stop end of the line, including its newline
+ * @return record type
+ */
+static ObjRecord _obj_record(const char** cursor, const char* stop)
 {
-    ANN(data);
-    ANN(capacity);
-
-    if (count <= *capacity)
-        return true;
-    uint32_t next = *capacity == 0 ? 16u : *capacity;
-    while (next < count)
+    ANN(cursor);
+    const char* p = *cursor;
+    while (p < stop && isspace((unsigned char)*p))
+        p++;
+
+    const char c0 = _obj_char(p, stop, 0);
+    const char c1 = _obj_char(p, stop, 1);
+    const char c2 = _obj_char(p, stop, 2);
+    ObjRecord record = OBJ_RECORD_OTHER;
+    size_t prefix = 0;
+    if (c0 == 'v' && isspace((unsigned char)c1))
     {
-        if (next > UINT32_MAX / 2u)
-            return false;
-        next *= 2u;
+        record = OBJ_RECORD_POSITION;
+        prefix = 2;
     }
-    uint64_t bytes = 0;
-    if (_dvz_mul_u64_overflows((uint64_t)next, (uint64_t)item_size, &bytes))
-        return false;
-
-    void* resized = dvz_realloc(*data, (DvzSize)bytes);
-    if (resized == NULL)
-        return false;
-    *data = resized;
-    *capacity = next;
-    return true;
+    else if (c0 == 'v' && c1 == 'n' && isspace((unsigned char)c2))
+    {
+        record = OBJ_RECORD_NORMAL;
+        prefix = 3;
+    }
+    else if (c0 == 'v' && c1 == 't' && isspace((unsigned char)c2))
+    {
+        record = OBJ_RECORD_TEXCOORD;
+        prefix = 3;
+    }
+    else if (c0 == 'f' && isspace((unsigned char)c1))
+    {
+        record = OBJ_RECORD_FACE;
+        prefix = 2;
+    }
+    *cursor = p + prefix;
+    return record;
 }
 
 
 
-static bool _obj_append_dvec3(dvec3** data, uint32_t* count, uint32_t* capacity, const dvec3 value)
+/**
+ * Return the next whitespace-delimited face token.
+ *
+ * @param cursor current position, advanced past the token
+ * @param stop end of the line
+ * @param token_end receives the end of the token
+ * @return start of the token, or NULL at the end of the record or at a comment
+ */
+static const char* _obj_next_token(const char** cursor, const char* stop, const char** token_end)
 {
-    ANN(data);
-    ANN(count);
-    ANN(capacity);
-    ANN(value);
-
-    if (*count == UINT32_MAX || !_obj_reserve((void**)data, capacity, *count + 1u, sizeof(dvec3)))
-        return false;
-    (*data)[*count][0] = value[0];
-    (*data)[*count][1] = value[1];
-    (*data)[*count][2] = value[2];
-    (*count)++;
-    return true;
+    const char* p = *cursor;
+    while (p < stop && _obj_is_delimiter(*p))
+        p++;
+    if (p >= stop || *p == '#')
+        return NULL;
+    const char* q = p;
+    while (q < stop && !_obj_is_delimiter(*q))
+        q++;
+    *cursor = q;
+    *token_end = q;
+    return p;
 }
 
 
 
-static bool _obj_append_dvec2(dvec2** data, uint32_t* count, uint32_t* capacity, const dvec2 value)
+static bool _obj_index_from_token(int64_t raw, uint32_t count, uint32_t* out)
 {
-    ANN(data);
-    ANN(count);
-    ANN(capacity);
-    ANN(value);
-
-    if (*count == UINT32_MAX || !_obj_reserve((void**)data, capacity, *count + 1u, sizeof(dvec2)))
+    ANN(out);
+    if (raw == 0 || count == 0)
+        return false;
+    int64_t index = raw > 0 ? raw - 1 : (int64_t)count + raw;
+    if (index < 0 || (uint64_t)index >= count)
         return false;
-    (*data)[*count][0] = value[0];
-    (*data)[*count][1] = value[1];
-    (*count)++;
+    *out = (uint32_t)index;
     return true;
 }
 
 
 
-static bool _obj_append_face_vertex(ObjArrays* arrays, ObjFaceVertex value)
+static const char* _obj_parse_int(const char* p, const char* stop, int64_t* out)
 {
-    ANN(arrays);
-    if (arrays->vertex_count == UINT32_MAX ||
-        !_obj_reserve(
-            (void**)&arrays->vertices, &arrays->vertex_capacity, arrays->vertex_count + 1u,
-            sizeof(ObjFaceVertex)))
+    const bool negative = p < stop && *p == '-';
+    if (p < stop && (*p == '-' || *p == '+'))
+        p++;
+    const char* digits = p;
+    int64_t value = 0;
+    for (; p < stop && *p >= '0' && *p <= '9'; p++)
     {
-        return false;
+        // Larger indices can never resolve to a valid vertex.
+        if (value > ((int64_t)1 << 40))
+            return NULL;
+        value = value * 10 + (*p - '0');
     }
-    arrays->vertices[arrays->vertex_count++] = value;
-    return true;
-}
-
-
-
-static bool _obj_index_from_token(long raw, uint32_t count, uint32_t* out)
-{
-    ANN(out);
-    if (raw == 0 || count == 0)
-        return false;
-    long index = raw > 0 ? raw - 1 : (long)count + raw;
-    if (index < 0 || (uint64_t)index >= count)
-        return false;
-    *out = (uint32_t)index;
-    return true;
+    if (p == digits)
+        return NULL;
+    *out = negative ? -value : value;
+    return p;
 }
 
 
 
 static bool _obj_parse_face_vertex(
-    const char* token, uint32_t position_count, uint32_t texcoord_count, uint32_t normal_count,
-    ObjFaceVertex* out)
+    const char* token, const char* token_end, uint32_t position_count, uint32_t texcoord_count,
+    uint32_t normal_count, ObjFaceVertex* out)
 {
     ANN(token);
     ANN(out);
 
-    errno = 0;
-    char* end = NULL;
-    const long position = strtol(token, &end, 10);
-    if (errno != 0 || end == token ||
-        !_obj_index_from_token(position, position_count, &out->position))
+    int64_t position = 0;
+    const char* end = _obj_parse_int(token, token_end, &position);
+    if (end == NULL || !_obj_index_from_token(position, position_count, &out->position))
         return false;
     out->texcoord = UINT32_MAX;
     out->normal = UINT32_MAX;
 
-    if (*end == '\0')
+    if (end == token_end)
         return true;
     if (*end != '/')
         return false;
     end++;
 
-    if (*end != '/')
+    if (end < token_end && *end != '/')
     {
-        if (*end == '\0')
+        int64_t texcoord = 0;
+        end = _obj_parse_int(end, token_end, &texcoord);
+        if (end == NULL || !_obj_index_from_token(texcoord, texcoord_count, &out->texcoord))
             return false;
-        errno = 0;
-        char* texcoord_end = NULL;
-        const long texcoord = strtol(end, &texcoord_end, 10);
-        if (errno != 0 || texcoord_end == end ||
-            !_obj_index_from_token(texcoord, texcoord_count, &out->texcoord))
-        {
-            return false;
-        }
-        end = texcoord_end;
     }
-    if (*end == '/')
+    else if (end == token_end)
+    {
+        return false;
+    }
+    if (end < token_end && *end == '/')
     {
         end++;
-        if (*end == '\0')
-            return false;
-        errno = 0;
-        char* normal_end = NULL;
-        const long normal = strtol(end, &normal_end, 10);
-        if (errno != 0 || normal_end == end ||
-            !_obj_index_from_token(normal, normal_count, &out->normal))
-        {
+        int64_t normal = 0;
+        end = end < token_end ? _obj_parse_int(end, token_end, &normal) : NULL;
+        if (end == NULL || !_obj_index_from_token(normal, normal_count, &out->normal))
             return false;
-        }
-        end = normal_end;
     }
-    return *end == '\0';
+    return end == token_end;
 }
 
 
 
-static bool _obj_parse_face(char* line, ObjArrays* arrays)
+/**
+ * Count the vertices of a face record.
+ *
+ * @param text source text after the face record prefix
+ * @param stop end of the line
+ * @return number of face vertices, or 0 for an invalid face
+ */
+static uint32_t _obj_face_size(const char* text, const char* stop)
 {
-    ANN(line);
+    uint32_t count = 0;
+    const char* token_end = NULL;
+    while (_obj_next_token(&text, stop, &token_end) != NULL)
+    {
+        if (++count > OBJ_FACE_MAX)
+            return 0;
+    }
+    return count >= 3u ? count : 0;
+}
+
+
+
+/**
+ * Parse a face record and append its fan triangulation.
+ *
+ * @param text source text after the face record prefix
+ * @param stop end of the line
+ * @param chunk chunk holding the record, with its running counts
+ * @param arrays destination arrays
+ * @param counts records parsed so far in the whole file: positions, texcoords, normals, vertices
+ * @return whether the face is valid
+ */
+static bool _obj_parse_face(
+    const char* text, const char* stop, const ObjChunk* chunk, ObjArrays* arrays,
+    uint32_t counts[4])
+{
+    ANN(text);
+    ANN(chunk);
     ANN(arrays);
 
     ObjFaceVertex face[OBJ_FACE_MAX] = {{0}};
     uint32_t face_count = 0;
-    char* saveptr = NULL;
-    for (char* token = _obj_strtok(line, " \t\r\n", &saveptr); token != NULL;
-         token = _obj_strtok(NULL, " \t\r\n", &saveptr))
+    const char* token_end = NULL;
+    for (const char* token = _obj_next_token(&text, stop, &token_end); token != NULL;
+         token = _obj_next_token(&text, stop, &token_end))
     {
-        if (token[0] == '#')
-            break;
-        if (face_count >= OBJ_FACE_MAX)
-            return false;
-        if (!_obj_parse_face_vertex(
-                token, arrays->position_count, arrays->texcoord_count, arrays->normal_count,
-                &face[face_count]))
+        if (face_count >= OBJ_FACE_MAX ||
+            !_obj_parse_face_vertex(
+                token, token_end, counts[0], counts[1], counts[2], &face[face_count]))
         {
             return false;
         }
@@ -330,173 +673,583 @@ static bool _obj_parse_face(char* line, ObjArrays* arrays)
     if (face_count < 3u)
         return false;
 
+    const uint32_t triangle_vertices = 3u * (face_count - 2u);
+    if (triangle_vertices > chunk->vertex_offset + chunk->vertex_count - counts[3])
+        return false;
+    ObjFaceVertex* out = &arrays->vertices[counts[3]];
     for (uint32_t i = 1; i + 1u < face_count; i++)
     {
-        if (!_obj_append_face_vertex(arrays, face[0]) ||
-            !_obj_append_face_vertex(arrays, face[i]) ||
-            !_obj_append_face_vertex(arrays, face[i + 1u]))
-        {
-            return false;
-        }
+        *out++ = face[0];
+        *out++ = face[i];
+        *out++ = face[i + 1u];
     }
+    counts[3] += triangle_vertices;
     return true;
 }
 
 
 
-static void _obj_arrays_destroy(ObjArrays* arrays)
-{
-    if (arrays == NULL)
-        return;
-    dvz_free(arrays->positions);
-    dvz_free(arrays->normals);
-    dvz_free(arrays->texcoords);
-    dvz_free(arrays->vertices);
-}
-
-
-
 /*************************************************************************************************/
-/*  Functions                                                                                    */
+/*  Chunked parser                                                                               */
 /*************************************************************************************************/
 
-DvzGeometryObjDesc dvz_geometry_obj_desc(void)
+/**
+ * Split a file into line-aligned chunks.
+ *
+ * @param data file contents
+ * @param size file size
+ * @param chunks output chunks
+ * @param max_chunks capacity of @p chunks
+ * @return number of chunks
+ */
+static uint32_t _obj_split(const char* data, DvzSize size, ObjChunk* chunks, uint32_t max_chunks)
 {
-    return (DvzGeometryObjDesc){DVZ_STRUCT_INIT_FIELDS(DvzGeometryObjDesc)};
+    uint32_t count = 0;
+    const char* begin = data;
+    const char* end = data + size;
+    while (begin < end && count < max_chunks)
+    {
+        const char* stop = end;
+        if (count + 1u < max_chunks && (DvzSize)(end - begin) > OBJ_CHUNK_SIZE)
+        {
+            const char* newline = (const char*)memchr(
+                begin + OBJ_CHUNK_SIZE, '\n', (size_t)(end - begin) - OBJ_CHUNK_SIZE);
+            stop = newline != NULL ? newline + 1 : end;
+        }
+        chunks[count].begin = begin;
+        chunks[count].end = stop;
+        count++;
+        begin = stop;
+    }
+    return count;
 }
 
 
 
-DvzGeometry* dvz_geometry_obj(const char* filename, const DvzGeometryObjDesc* desc)
+/**
+ * Return the end of the line starting at @p line, including its newline.
+ *
+ * @param line start of the line
+ * @param end end of the chunk
+ * @return end of the line, or NULL if the line exceeds the supported length
+ */
+static const char* _obj_line_end(const char* line, const char* end)
 {
-    if (filename == NULL || !_obj_desc_validate(desc))
-        return NULL;
+    const char* newline = (const char*)memchr(line, '\n', (size_t)(end - line));
+    const char* stop = newline != NULL ? newline + 1 : end;
+    return stop - line < OBJ_LINE_MAX ? stop : NULL;
+}
 
-    DvzGeometryObjDesc cfg = dvz_geometry_obj_desc();
-    if (desc != NULL)
-        cfg = *desc;
-    DvzColor color = {0};
-    _obj_color_or_default(cfg.color, &color);
 
-    FILE* fp = fopen(filename, "rb");
-    if (fp == NULL)
+
+/**
+ * Count the records of one chunk and check its line lengths and face sizes.
+ *
+ * @param chunk chunk to scan
+ */
+static void _obj_count_chunk(ObjChunk* chunk)
+{
+    ANN(chunk);
+    chunk->ok = false;
+    for (const char* line = chunk->begin; line < chunk->end;)
     {
-        log_error("could not open OBJ file %s", filename);
-        return NULL;
+        const char* stop = _obj_line_end(line, chunk->end);
+        if (stop == NULL)
+            return;
+        const char* text = line;
+        switch (_obj_record(&text, stop))
+        {
+        case OBJ_RECORD_POSITION:
+            chunk->position_count++;
+            break;
+        case OBJ_RECORD_NORMAL:
+            chunk->normal_count++;
+            break;
+        case OBJ_RECORD_TEXCOORD:
+            chunk->texcoord_count++;
+            break;
+        case OBJ_RECORD_FACE:
+        {
+            const uint32_t face_size = _obj_face_size(text, stop);
+            if (face_size == 0)
+                return;
+            chunk->vertex_count += 3u * (face_size - 2u);
+            break;
+        }
+        default:
+            break;
+        }
+        line = stop;
     }
+    chunk->ok = true;
+}
+
 
-    ObjArrays arrays = {0};
-    bool ok = true;
-    char line[OBJ_LINE_MAX] = {0};
-    while (fgets(line, sizeof(line), fp) != NULL)
+
+/**
+ * Parse the records of one chunk in place into the preallocated arrays.
+ *
+ * @param chunk chunk to parse, with its offsets set
+ * @param arrays destination arrays sized for the whole file
+ */
+static void _obj_parse_chunk(ObjChunk* chunk, ObjArrays* arrays)
+{
+    ANN(chunk);
+    ANN(arrays);
+    chunk->ok = false;
+
+    // Records parsed so far in the whole file: positions, texcoords, normals, vertices.
+    uint32_t counts[4] = {
+        chunk->position_offset, chunk->texcoord_offset, chunk->normal_offset,
+        chunk->vertex_offset};
+    for (const char* line = chunk->begin; line < chunk->end;)
     {
-        if (strchr(line, '\n') == NULL && fgetc(fp) != EOF)
+        const char* stop = _obj_line_end(line, chunk->end);
+        ANN(stop);
+        const char* text = line;
+        switch (_obj_record(&text, stop))
         {
-            ok = false;
+        case OBJ_RECORD_POSITION:
+            if (!_obj_parse_values(text, stop, 3, 4, arrays->positions[counts[0]++]))
+                return;
+            break;
+        case OBJ_RECORD_TEXCOORD:
+            if (!_obj_parse_values(text, stop, 2, 3, arrays->texcoords[counts[1]++]))
+                return;
+            break;
+        case OBJ_RECORD_NORMAL:
+            if (!_obj_parse_values(text, stop, 3, 3, arrays->normals[counts[2]++]))
+                return;
+            break;
+        case OBJ_RECORD_FACE:
+        {
+            const uint32_t first = counts[3];
+            if (!_obj_parse_face(text, stop, chunk, arrays, counts))
+                return;
+            for (uint32_t i = first; i < counts[3] && !chunk->missing_normal; i++)
+                chunk->missing_normal = arrays->vertices[i].normal == UINT32_MAX;
             break;
         }
+        default:
+            break;
+        }
+        line = stop;
+    }
+    chunk->ok = counts[3] == chunk->vertex_offset + chunk->vertex_count;
+}
+
+
+
+static void _obj_count_range(uint32_t begin, uint32_t end, void* user_data)
+{
+    ObjParse* parse = (ObjParse*)user_data;
+    ANN(parse);
+    for (uint32_t i = begin; i < end; i++)
+        _obj_count_chunk(&parse->chunks[i]);
+}
+
+
+
+static void _obj_parse_range(uint32_t begin, uint32_t end, void* user_data)
+{
+    ObjParse* parse = (ObjParse*)user_data;
+    ANN(parse);
+    for (uint32_t i = begin; i < end; i++)
+        _obj_parse_chunk(&parse->chunks[i], &parse->arrays);
+}
+
+
+
+static void _obj_expand_range(uint32_t begin, uint32_t end, void* user_data)
+{
+    ObjExpand* expand = (ObjExpand*)user_data;
+    ANN(expand);
+    const ObjArrays* arrays = expand->arrays;
+    DvzGeometry* geometry = expand->geometry;
+    const bool f32 = geometry->precision == DVZ_GEOMETRY_PRECISION_F32;
 
-        char* record = line;
-        while (isspace((unsigned char)*record))
-            record++;
-        if (record[0] == 'v' && isspace((unsigned char)record[1]))
+    for (uint32_t i = begin; i < end; i++)
+    {
+        const ObjFaceVertex face = arrays->vertices[i];
+        const bool has_texcoord = face.texcoord != UINT32_MAX;
+        const bool has_normal = face.normal != UINT32_MAX;
+        for (uint32_t j = 0; j < 3; j++)
         {
-            dvec3 value = {0};
-            if (!_obj_parse_values(record + 2, 3, 4, value) ||
-                !_obj_append_dvec3(
-                    &arrays.positions, &arrays.position_count, &arrays.position_capacity, value))
+            const double position = arrays->positions[face.position][j];
+            const double normal = has_normal ? arrays->normals[face.normal][j] : 0.0;
+            if (f32)
             {
-                ok = false;
-                break;
+                geometry->positions_f32[i][j] = (float)position;
+                geometry->normals_f32[i][j] = (float)normal;
             }
-        }
-        else if (record[0] == 'v' && record[1] == 'n' && isspace((unsigned char)record[2]))
-        {
-            dvec3 value = {0};
-            if (!_obj_parse_values(record + 3, 3, 3, value) ||
-                !_obj_append_dvec3(
-                    &arrays.normals, &arrays.normal_count, &arrays.normal_capacity, value))
+            else
             {
-                ok = false;
-                break;
+                geometry->positions[i][j] = position;
+                geometry->normals[i][j] = normal;
             }
         }
-        else if (record[0] == 'v' && record[1] == 't' && isspace((unsigned char)record[2]))
+        for (uint32_t j = 0; j < 2 && has_texcoord; j++)
         {
-            dvec2 value = {0};
-            if (!_obj_parse_values(record + 3, 2, 3, value) ||
-                !_obj_append_dvec2(
-                    &arrays.texcoords, &arrays.texcoord_count, &arrays.texcoord_capacity, value))
-            {
-                ok = false;
-                break;
-            }
+            if (f32)
+                geometry->texcoords_f32[i][j] = (float)arrays->texcoords[face.texcoord][j];
+            else
+                geometry->texcoords[i][j] = arrays->texcoords[face.texcoord][j];
         }
-        else if (record[0] == 'f' && isspace((unsigned char)record[1]))
+        geometry->colors[i] = expand->color;
+        geometry->indices[i] = i;
+    }
+}
+
+
+
+static void _obj_arrays_destroy(ObjArrays* arrays)
+{
+    if (arrays == NULL)
+        return;
+    dvz_free(arrays->positions);
+    dvz_free(arrays->normals);
+    dvz_free(arrays->texcoords);
+    dvz_free(arrays->vertices);
+}
+
+
+
+/**
+ * Sum the per-chunk counts into chunk offsets and allocate the file-wide arrays.
+ *
+ * @param parse parse state after the counting pass
+ * @return whether every chunk is valid and the arrays could be allocated
+ */
+static bool _obj_prepare(ObjParse* parse)
+{
+    ANN(parse);
+    uint64_t totals[4] = {0};
+    for (uint32_t i = 0; i < parse->chunk_count; i++)
+    {
+        ObjChunk* chunk = &parse->chunks[i];
+        if (!chunk->ok)
+            return false;
+        chunk->position_offset = (uint32_t)totals[0];
+        chunk->normal_offset = (uint32_t)totals[1];
+        chunk->texcoord_offset = (uint32_t)totals[2];
+        chunk->vertex_offset = (uint32_t)totals[3];
+        totals[0] += chunk->position_count;
+        totals[1] += chunk->normal_count;
+        totals[2] += chunk->texcoord_count;
+        totals[3] += chunk->vertex_count;
+        if (totals[0] > UINT32_MAX || totals[1] > UINT32_MAX || totals[2] > UINT32_MAX ||
+            totals[3] > UINT32_MAX)
         {
-            if (!_obj_parse_face(record + 2, &arrays))
-            {
-                ok = false;
-                break;
-            }
+            return false;
         }
     }
-    if (ferror(fp))
-        ok = false;
-    fclose(fp);
+    if (totals[0] == 0 || totals[3] == 0)
+        return false;
 
-    if (!ok || arrays.position_count == 0 || arrays.vertex_count == 0)
-    {
-        _obj_arrays_destroy(&arrays);
+    ObjArrays* arrays = &parse->arrays;
+    arrays->position_count = (uint32_t)totals[0];
+    arrays->normal_count = (uint32_t)totals[1];
+    arrays->texcoord_count = (uint32_t)totals[2];
+    arrays->vertex_count = (uint32_t)totals[3];
+    arrays->positions = (dvec3*)dvz_calloc(arrays->position_count, sizeof(dvec3));
+    arrays->normals = arrays->normal_count > 0
+                          ? (dvec3*)dvz_calloc(arrays->normal_count, sizeof(dvec3))
+                          : NULL;
+    arrays->texcoords = arrays->texcoord_count > 0
+                            ? (dvec2*)dvz_calloc(arrays->texcoord_count, sizeof(dvec2))
+                            : NULL;
+    arrays->vertices =
+        (ObjFaceVertex*)dvz_calloc(arrays->vertex_count, sizeof(ObjFaceVertex));
+    return arrays->positions != NULL && arrays->vertices != NULL &&
+           (arrays->normal_count == 0 || arrays->normals != NULL) &&
+           (arrays->texcoord_count == 0 || arrays->texcoords != NULL);
+}
+
+
+
+/**
+ * Parse mapped OBJ contents into a de-indexed triangle geometry.
+ *
+ * The file is split into line-aligned chunks. A first parallel pass counts the records of each
+ * chunk, a prefix sum turns the counts into offsets so that relative indices resolve exactly as
+ * in a sequential read, and a second parallel pass parses every chunk in place.
+ *
+ * @param map file contents
+ * @param f32 whether to build a F32 geometry
+ * @param color vertex color
+ * @return new geometry, or NULL on invalid input or allocation failure
+ */
+static DvzGeometry* _obj_parse(const ObjMap* map, bool f32, DvzColor color)
+{
+    ANN(map);
+    if (map->size == 0)
+        return NULL;
+
+    const uint32_t max_chunks =
+        (uint32_t)DVZ_MIN((uint64_t)OBJ_CHUNK_MAX, map->size / OBJ_CHUNK_SIZE + 1u);
+    ObjParse parse = {0};
+    parse.chunks = (ObjChunk*)dvz_calloc(max_chunks, sizeof(ObjChunk));
+    if (parse.chunks == NULL)
         return NULL;
+    parse.chunk_count = _obj_split(map->data, map->size, parse.chunks, max_chunks);
+
+    DvzThreadPool* pool = NULL;
+    if (parse.chunk_count > 1)
+        pool = dvz_thread_pool(DVZ_MIN(dvz_thread_pool_default_size(), parse.chunk_count - 1));
+
+    DvzGeometry* geometry = NULL;
+    dvz_thread_pool_parallel_for(pool, parse.chunk_count, 1, _obj_count_range, &parse);
+    bool ok = _obj_prepare(&parse);
+    if (ok)
+    {
+        dvz_thread_pool_parallel_for(pool, parse.chunk_count, 1, _obj_parse_range, &parse);
+        for (uint32_t i = 0; i < parse.chunk_count; i++)
+            ok = ok && parse.chunks[i].ok;
     }
 
-    DvzGeometry* geometry = dvz_geometry(arrays.vertex_count, arrays.vertex_count);
-    if (geometry == NULL)
+    bool has_all_normals = true;
+    for (uint32_t i = 0; i < parse.chunk_count; i++)
+        has_all_normals = has_all_normals && !parse.chunks[i].missing_normal;
+
+    const uint32_t vertex_count = parse.arrays.vertex_count;
+    if (ok)
+    {
+        geometry = f32 ? dvz_geometry_f32(vertex_count, vertex_count)
+                       : dvz_geometry(vertex_count, vertex_count);
+    }
+    if (geometry != NULL)
+    {
+        geometry->type = DVZ_GEOMETRY_CUSTOM;
+        geometry->flags = DVZ_GEOMETRY_INDEXING_TRIANGLES;
+        ObjExpand expand = {.arrays = &parse.arrays, .geometry = geometry, .color = color};
+        dvz_thread_pool_parallel_for(
+            pool, vertex_count, OBJ_EXPAND_GRAIN, _obj_expand_range, &expand);
+    }
+
+    dvz_thread_pool_destroy(pool);
+    _obj_arrays_destroy(&parse.arrays);
+    dvz_free(parse.chunks);
+
+    if (geometry != NULL && !has_all_normals && dvz_geometry_compute_normals(geometry) != 0)
     {
-        _obj_arrays_destroy(&arrays);
+        dvz_geometry_destroy(geometry);
         return NULL;
     }
-    geometry->type = DVZ_GEOMETRY_CUSTOM;
-    geometry->flags = DVZ_GEOMETRY_INDEXING_TRIANGLES;
+    return geometry;
+}
 
-    bool has_all_normals = true;
-    for (uint32_t i = 0; i < arrays.vertex_count; i++)
+
+
+/*************************************************************************************************/
+/*  Binary cache                                                                                 */
+/*************************************************************************************************/
+
+static bool _obj_file_stamp(const char* filename, ObjStamp* out)
+{
+    ANN(filename);
+    ANN(out);
+#if defined(_WIN32) || defined(_MSC_VER)
+    struct _stat64 st;
+    if (_stat64(filename, &st) != 0)
+        return false;
+    out->mtime_ns = (int64_t)st.st_mtime * 1000000000;
+#else
+    struct stat st;
+    if (stat(filename, &st) != 0)
+        return false;
+#if defined(__APPLE__)
+    out->mtime_ns = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+    out->mtime_ns = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+#endif
+    out->size = (uint64_t)st.st_size;
+    return true;
+}
+
+
+
+static DvzSize _obj_cache_payload_size(uint32_t vertex_count, bool f32)
+{
+    const DvzSize scalar = f32 ? sizeof(float) : sizeof(double);
+    return (DvzSize)vertex_count * (3 + 3 + 2) * scalar;
+}
+
+
+
+/**
+ * Load a geometry from a binary cache file built from the same source file.
+ *
+ * @param path cache file path
+ * @param stamp identity of the source file
+ * @param f32 requested precision
+ * @param color vertex color
+ * @return new geometry, or NULL if the cache is missing, stale, or invalid
+ */
+static DvzGeometry*
+_obj_cache_load(const char* path, const ObjStamp* stamp, bool f32, DvzColor color)
+{
+    ANN(path);
+    ANN(stamp);
+
+    ObjMap map = {0};
+    if (!_obj_map_open(path, &map))
+        return NULL;
+
+    ObjCacheHeader header = {0};
+    const uint32_t precision = f32 ? DVZ_GEOMETRY_PRECISION_F32 : DVZ_GEOMETRY_PRECISION_F64;
+    bool ok = map.size >= sizeof(header);
+    if (ok)
+        memcpy(&header, map.data, sizeof(header));
+    ok = ok && header.magic == OBJ_CACHE_MAGIC && header.version == OBJ_CACHE_VERSION &&
+         header.precision == precision && header.source_size == stamp->size &&
+         header.source_mtime_ns == stamp->mtime_ns && header.vertex_count > 0 &&
+         map.size == sizeof(header) + _obj_cache_payload_size(header.vertex_count, f32);
+
+    DvzGeometry* geometry = NULL;
+    if (ok)
     {
-        const ObjFaceVertex face = arrays.vertices[i];
-        if (face.position >= arrays.position_count)
-        {
-            dvz_geometry_destroy(geometry);
-            _obj_arrays_destroy(&arrays);
-            return NULL;
-        }
-        geometry->positions[i][0] = arrays.positions[face.position][0];
-        geometry->positions[i][1] = arrays.positions[face.position][1];
-        geometry->positions[i][2] = arrays.positions[face.position][2];
-        geometry->colors[i] = color;
-        if (face.texcoord != UINT32_MAX && face.texcoord < arrays.texcoord_count)
+        const uint32_t n = header.vertex_count;
+        geometry = f32 ? dvz_geometry_f32(n, n) : dvz_geometry(n, n);
+    }
+    if (geometry != NULL)
+    {
+        const uint32_t n = header.vertex_count;
+        const char* src = map.data + sizeof(header);
+        geometry->type = DVZ_GEOMETRY_CUSTOM;
+        geometry->flags = DVZ_GEOMETRY_INDEXING_TRIANGLES;
+        if (f32)
         {
-            geometry->texcoords[i][0] = arrays.texcoords[face.texcoord][0];
-            geometry->texcoords[i][1] = arrays.texcoords[face.texcoord][1];
+            memcpy(geometry->positions_f32, src, n * sizeof(vec3));
+            memcpy(geometry->normals_f32, src + n * sizeof(vec3), n * sizeof(vec3));
+            memcpy(geometry->texcoords_f32, src + 2 * n * sizeof(vec3), n * sizeof(vec2));
         }
-        geometry->indices[i] = i;
-        if (face.normal != UINT32_MAX && face.normal < arrays.normal_count)
+        else
         {
-            geometry->normals[i][0] = arrays.normals[face.normal][0];
-            geometry->normals[i][1] = arrays.normals[face.normal][1];
-            geometry->normals[i][2] = arrays.normals[face.normal][2];
+            memcpy(geometry->positions, src, n * sizeof(dvec3));
+            memcpy(geometry->normals, src + n * sizeof(dvec3), n * sizeof(dvec3));
+            memcpy(geometry->texcoords, src + 2 * n * sizeof(dvec3), n * sizeof(dvec2));
         }
-        else
+        for (uint32_t i = 0; i < n; i++)
         {
-            has_all_normals = false;
+            geometry->colors[i] = color;
+            geometry->indices[i] = i;
         }
     }
+    _obj_map_close(&map);
+    return geometry;
+}
+
+
+
+static bool _obj_cache_write(FILE* fp, const void* data, size_t size)
+{
+    return size == 0 || fwrite(data, 1, size, fp) == size;
+}
+
 
-    _obj_arrays_destroy(&arrays);
-    if (!has_all_normals && dvz_geometry_compute_normals(geometry) != 0)
+
+/**
+ * Write the vertex arrays of a loaded geometry to a binary cache file.
+ *
+ * @param path cache file path
+ * @param stamp identity of the source file
+ * @param geometry loaded geometry
+ * @return whether the cache file was written
+ */
+static bool _obj_cache_save(const char* path, const ObjStamp* stamp, const DvzGeometry* geometry)
+{
+    ANN(path);
+    ANN(stamp);
+    ANN(geometry);
+
+    char tmp_path[OBJ_CACHE_PATH_MAX] = {0};
+    int written = snprintf(tmp_path, sizeof(tmp_path), "%s.%lu.tmp", path, OBJ_PID());
+    if (written <= 0 || (size_t)written >= sizeof(tmp_path))
+        return false;
+    FILE* fp = fopen(tmp_path, "wb");
+    if (fp == NULL)
+        return false;
+
+    const bool f32 = geometry->precision == DVZ_GEOMETRY_PRECISION_F32;
+    const size_t n = geometry->vertex_count;
+    ObjCacheHeader header = {
+        .magic = OBJ_CACHE_MAGIC,
+        .version = OBJ_CACHE_VERSION,
+        .precision = (uint32_t)geometry->precision,
+        .source_size = stamp->size,
+        .source_mtime_ns = stamp->mtime_ns,
+        .vertex_count = geometry->vertex_count,
+    };
+    bool ok = _obj_cache_write(fp, &header, sizeof(header));
+    if (f32)
     {
-        dvz_geometry_destroy(geometry);
+        ok = ok && _obj_cache_write(fp, geometry->positions_f32, n * sizeof(vec3)) &&
+             _obj_cache_write(fp, geometry->normals_f32, n * sizeof(vec3)) &&
+             _obj_cache_write(fp, geometry->texcoords_f32, n * sizeof(vec2));
+    }
+    else
+    {
+        ok = ok && _obj_cache_write(fp, geometry->positions, n * sizeof(dvec3)) &&
+             _obj_cache_write(fp, geometry->normals, n * sizeof(dvec3)) &&
+             _obj_cache_write(fp, geometry->texcoords, n * sizeof(dvec2));
+    }
+    ok = fclose(fp) == 0 && ok;
+    if (ok && rename(tmp_path, path) != 0)
+    {
+        // Windows does not replace an existing destination.
+        remove(path);
+        ok = rename(tmp_path, path) == 0;
+    }
+    if (!ok)
+        remove(tmp_path);
+    return ok;
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+DvzGeometryObjDesc dvz_geometry_obj_desc(void)
+{
+    return (DvzGeometryObjDesc){DVZ_STRUCT_INIT_FIELDS(DvzGeometryObjDesc)};
+}
+
+
+
+DvzGeometry* dvz_geometry_obj(const char* filename, const DvzGeometryObjDesc* desc)
+{
+    if (filename == NULL || !_obj_desc_validate(desc))
         return NULL;
+
+    DvzGeometryObjDesc cfg = dvz_geometry_obj_desc();
+    if (desc != NULL)
+        cfg = *desc;
+    DvzColor color = {0};
+    _obj_color_or_default(cfg.color, &color);
+    const bool f32 = (cfg.flags & DVZ_GEOMETRY_DESC_F32) != 0;
+
+    ObjStamp stamp = {0};
+    const bool cached = cfg.cache_path != NULL && _obj_file_stamp(filename, &stamp);
+    if (cached)
+    {
+        DvzGeometry* geometry = _obj_cache_load(cfg.cache_path, &stamp, f32, color);
+        if (geometry != NULL)
+            return geometry;
     }
+
+    ObjMap map = {0};
+    if (!_obj_map_open(filename, &map))
+    {
+        log_error("could not open OBJ file %s", filename);
+        return NULL;
+    }
+    DvzGeometry* geometry = _obj_parse(&map, f32, color);
+    _obj_map_close(&map);
+
+    if (geometry != NULL && cached && !_obj_cache_save(cfg.cache_path, &stamp, geometry))
+        log_warn("could not write OBJ cache file %s", cfg.cache_path);
     return geometry;
 }
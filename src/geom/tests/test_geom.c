@@ -712,6 +712,93 @@ int test_geometry_obj_loader(TstContext* suite, const TstCase* tstitem)
 
 
 
+static bool _write_obj_test_strip(const char* path, uint32_t rows, double z)
+{
+    ANN(path);
+
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL)
+        return false;
+    bool ok = true;
+    for (uint32_t row = 0; row < rows && ok; row++)
+    {
+        // Two vertices per row and a quad with relative indices back to the previous row, so that
+        // relative indices cross chunk boundaries.
+        ok = fprintf(fp, "v %u 0 %.17g\nv %u 1.25e0 %.17g\n", row, z, row, z) > 0;
+        if (ok && row > 0)
+            ok = fprintf(fp, "f -4 -2 -1 -3 # quad %u\n", row) > 0;
+    }
+    ok = fclose(fp) == 0 && ok;
+    return ok;
+}
+
+
+
+int test_geometry_obj_loader_parallel(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+    (void)tstitem;
+
+    // Large enough to be split into several chunks.
+    const uint32_t rows = 80000;
+    const char* path = "build/test_geom_obj_loader_parallel.obj";
+    const char* cache_path = "build/test_geom_obj_loader_parallel.dvzmesh";
+    remove(cache_path);
+    AT(_write_obj_test_strip(path, rows, 0.1));
+
+    DvzGeometryObjDesc desc = dvz_geometry_obj_desc();
+    DvzGeometry* geometry = dvz_geometry_obj(path, &desc);
+    AT(geometry != NULL);
+    AT(geometry->vertex_count == 6 * (rows - 1));
+    for (uint32_t row = 1; row < rows; row += 997)
+    {
+        const double* p = geometry->positions[6 * (row - 1)];
+        AC(p[0], row - 1, EPS);
+        AC(p[1], 0.0, EPS);
+        AT(p[2] == 0.1);
+        p = geometry->positions[6 * (row - 1) + 2];
+        AC(p[0], row, EPS);
+        AC(p[1], 1.25, EPS);
+        AC(geometry->normals[6 * (row - 1)][2], 1.0, EPS);
+    }
+
+    // The first load with a cache path writes the cache, the second one reads it.
+    desc.cache_path = cache_path;
+    desc.flags = DVZ_GEOMETRY_DESC_F32;
+    DvzGeometry* written = dvz_geometry_obj(path, &desc);
+    AT(written != NULL);
+    FILE* fp = fopen(cache_path, "rb");
+    AT(fp != NULL);
+    fclose(fp);
+    DvzGeometry* cached = dvz_geometry_obj(path, &desc);
+    AT(cached != NULL);
+    AT(cached->precision == DVZ_GEOMETRY_PRECISION_F32);
+    AT(cached->vertex_count == written->vertex_count);
+    AT(memcmp(
+           cached->positions_f32, written->positions_f32,
+           written->vertex_count * sizeof(vec3)) == 0);
+    AT(memcmp(
+           cached->normals_f32, written->normals_f32, written->vertex_count * sizeof(vec3)) == 0);
+    AT(cached->indices[cached->vertex_count - 1] == cached->vertex_count - 1);
+
+    // A modified source file invalidates the cache.
+    AT(_write_obj_test_strip(path, rows / 2, 0.5));
+    DvzGeometry* updated = dvz_geometry_obj(path, &desc);
+    AT(updated != NULL);
+    AT(updated->vertex_count == 6 * (rows / 2 - 1));
+    AC(updated->positions_f32[0][2], 0.5, EPS);
+
+    dvz_geometry_destroy(updated);
+    dvz_geometry_destroy(cached);
+    dvz_geometry_destroy(written);
+    dvz_geometry_destroy(geometry);
+    remove(cache_path);
+    remove(path);
+    return 0;
+}
+
+
+
 int test_geometry_transform(TstContext* suite, const TstCase* tstitem)
 {
     ANN(suite);
@@ -786,6 +873,73 @@ int test_geometry_merge(TstContext* suite, const TstCase* tstitem)
 
 
 
+int test_geometry_f32(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+
+    DvzGeometryCubeDesc desc = {
+        DVZ_STRUCT_INIT_FIELDS(DvzGeometryCubeDesc), .center = {1.0, 2.0, 3.0}, .size = 2.0};
+    desc.flags = DVZ_GEOMETRY_DESC_F32;
+
+    DvzGeometry* cube = dvz_geometry_cube(&desc);
+    AT(cube != NULL);
+    AT(cube->precision == DVZ_GEOMETRY_PRECISION_F32);
+    AT(cube->positions == NULL);
+    AT(cube->normals == NULL);
+    AT(cube->positions_f32 != NULL);
+    AT(cube->normals_f32 != NULL);
+    AT(cube->vertex_count == 24);
+
+    DvzGeometryBounds bounds = dvz_geometry_bounds(cube);
+    AC(bounds.xmin, 0.0, EPS);
+    AC(bounds.xmax, 2.0, EPS);
+    AC(bounds.zmax, 4.0, EPS);
+    AC(cube->normals_f32[0][0], 1.0, EPS);
+
+    // Transforms and normals work in place on the F32 arrays.
+    dmat4 transform = _DMAT4_IDENTITY_INIT;
+    transform[3][0] = -1.0;
+    AT(dvz_geometry_transform(cube, transform) == 0);
+    bounds = dvz_geometry_bounds(cube);
+    AC(bounds.xmin, -1.0, EPS);
+    AT(dvz_geometry_compute_normals(cube) == 0);
+    AC(cube->normals_f32[0][0], 1.0, EPS);
+
+    // F32 and F64 inputs merge into a F64 geometry.
+    DvzGeometry* plane = dvz_geometry_plane(NULL);
+    AT(plane != NULL);
+    const DvzGeometry* parts[2] = {cube, plane};
+    DvzGeometry* merged = dvz_geometry_merge(2, parts);
+    AT(merged != NULL);
+    AT(merged->precision == DVZ_GEOMETRY_PRECISION_F64);
+    AT(merged->vertex_count == 28);
+    AC(merged->positions[0][0], cube->positions_f32[0][0], EPS);
+
+    // Precision round trip.
+    AT(dvz_geometry_set_precision(plane, DVZ_GEOMETRY_PRECISION_F32) == 0);
+    AT(plane->positions == NULL);
+    AT(plane->positions_f32 != NULL);
+    AT(plane->texcoords_f32 != NULL);
+    AT(dvz_geometry_set_precision(plane, DVZ_GEOMETRY_PRECISION_F64) == 0);
+    AT(plane->positions_f32 == NULL);
+    AC(plane->positions[0][0], -0.5, EPS);
+
+    parts[1] = plane;
+    AT(dvz_geometry_set_precision(plane, DVZ_GEOMETRY_PRECISION_F32) == 0);
+    DvzGeometry* merged_f32 = dvz_geometry_merge(2, parts);
+    AT(merged_f32 != NULL);
+    AT(merged_f32->precision == DVZ_GEOMETRY_PRECISION_F32);
+    AT(merged_f32->positions == NULL);
+
+    dvz_geometry_destroy(merged_f32);
+    dvz_geometry_destroy(merged);
+    dvz_geometry_destroy(plane);
+    dvz_geometry_destroy(cube);
+    return 0;
+}
+
+
+
 int test_geometry_edges(TstContext* suite, const TstCase* tstitem)
 {
     ANN(suite);
@@ -860,6 +1014,114 @@ int test_geometry_contours(TstContext* suite, const TstCase* tstitem)
 
 
 
+int test_geometry_parallel_topology(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+
+    // 200x200 grid: 79202 triangles, above the threshold of the cached parallel path.
+    const uint32_t n = 200;
+    double* heights = (double*)calloc(n * n, sizeof(double));
+    AT(heights != NULL);
+    for (uint32_t i = 0; i < n * n; i++)
+        heights[i] = 0.1 * sin(0.05 * (i / n)) * cos(0.07 * (i % n));
+    DvzGeometrySurfaceGridDesc desc = {
+        DVZ_STRUCT_INIT_FIELDS(DvzGeometrySurfaceGridDesc),
+        .rows = n,
+        .cols = n,
+        .heights = heights,
+    };
+    DvzGeometry* grid = dvz_geometry_surface_grid(&desc);
+    AT(grid != NULL);
+    AT(grid->normals != NULL);
+
+    dvec3* expected = (dvec3*)calloc(grid->vertex_count, sizeof(dvec3));
+    AT(expected != NULL);
+    for (uint32_t pass = 0; pass < 2; pass++)
+    {
+        // The second pass flips the first triangle: the cached adjacency must be rebuilt.
+        if (pass == 1)
+        {
+            DvzIndex tmp = grid->indices[1];
+            grid->indices[1] = grid->indices[2];
+            grid->indices[2] = tmp;
+        }
+        AT(dvz_geometry_compute_normals(grid) == 0);
+        AT(grid->topology != NULL);
+
+        memset(expected, 0, grid->vertex_count * sizeof(dvec3));
+        for (uint32_t i = 0; i < grid->index_count; i += 3)
+        {
+            const DvzIndex* face = &grid->indices[i];
+            const double* p0 = grid->positions[face[0]];
+            const double* p1 = grid->positions[face[1]];
+            const double* p2 = grid->positions[face[2]];
+            dvec3 a = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            dvec3 b = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            dvec3 c = {
+                a[1] * b[2] - a[2] * b[1],
+                a[2] * b[0] - a[0] * b[2],
+                a[0] * b[1] - a[1] * b[0],
+            };
+            const double len = sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2]);
+            for (uint32_t k = 0; k < 3; k++)
+                for (uint32_t j = 0; j < 3; j++)
+                    expected[face[k]][j] += c[j] / len;
+        }
+        for (uint32_t i = 0; i < grid->vertex_count; i++)
+        {
+            const double len = sqrt(
+                expected[i][0] * expected[i][0] + expected[i][1] * expected[i][1] +
+                expected[i][2] * expected[i][2]);
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                const double value = len > 0 ? expected[i][j] / len : (j == 2 ? 1.0 : 0.0);
+                AC(grid->normals[i][j], value, 1e-12);
+            }
+        }
+    }
+
+    // Contours of x between grid columns: two segments per row of cells and per level, in
+    // ascending face order, whatever the order of the levels.
+    double* values = (double*)calloc(grid->vertex_count, sizeof(double));
+    AT(values != NULL);
+    for (uint32_t i = 0; i < grid->vertex_count; i++)
+        values[i] = grid->positions[i][0];
+    const double x0 = grid->positions[0][0];
+    const double dx = grid->positions[1][0] - x0;
+    double levels[3] = {x0 + 150.5 * dx, x0 + 10.5 * dx, x0 + 99.25 * dx};
+
+    DvzGeometryContours* contours =
+        dvz_geometry_contours(grid, values, grid->vertex_count, levels, 3);
+    AT(contours != NULL);
+    AT(contours->segment_count == 3 * 2 * (n - 1));
+    for (uint32_t i = 0; i < contours->segment_count; i++)
+    {
+        const DvzGeometryContourSegment* segment = &contours->segments[i];
+        AT(segment->level_index < 3);
+        AC(segment->p0[0], levels[segment->level_index], 1e-9);
+        AC(segment->p1[0], levels[segment->level_index], 1e-9);
+        if (i > 0)
+            AT(segment->face_index >= contours->segments[i - 1].face_index);
+    }
+
+    DvzGeometryContours* again =
+        dvz_geometry_contours(grid, values, grid->vertex_count, levels, 3);
+    AT(again != NULL);
+    AT(again->segment_count == contours->segment_count);
+    AT(memcmp(again->segments, contours->segments,
+              contours->segment_count * sizeof(DvzGeometryContourSegment)) == 0);
+
+    dvz_geometry_contours_destroy(again);
+    dvz_geometry_contours_destroy(contours);
+    free(values);
+    free(expected);
+    dvz_geometry_destroy(grid);
+    free(heights);
+    return 0;
+}
+
+
+
 int test_geometry_polygon_triangulation(TstContext* suite, const TstCase* tstitem)
 {
     ANN(suite);
@@ -1119,10 +1381,13 @@ int test_geom(TstSuite* suite)
     TST_CASE(test_geometry_builtin_shapes);
     TST_CASE(test_geometry_count_overflow);
     TST_CASE(test_geometry_obj_loader);
+    TST_CASE(test_geometry_obj_loader_parallel);
     TST_CASE(test_geometry_transform);
     TST_CASE(test_geometry_merge);
+    TST_CASE(test_geometry_f32);
     TST_CASE(test_geometry_edges);
     TST_CASE(test_geometry_contours);
+    TST_CASE(test_geometry_parallel_topology);
     TST_CASE(test_geometry_polygon_triangulation);
     TST_CASE(test_geometry_polygon_triangulation_invalid);
     TST_CASE(test_geometry_bezier_tessellation);
@@ -45,14 +45,20 @@ int test_geometry_count_overflow(TstContext* suite, const TstCase* tstitem);
 
 int test_geometry_obj_loader(TstContext* suite, const TstCase* tstitem);
 
+int test_geometry_obj_loader_parallel(TstContext* suite, const TstCase* tstitem);
+
 int test_geometry_transform(TstContext* suite, const TstCase* tstitem);
 
 int test_geometry_merge(TstContext* suite, const TstCase* tstitem);
 
+int test_geometry_f32(TstContext* suite, const TstCase* tstitem);
+
 int test_geometry_edges(TstContext* suite, const TstCase* tstitem);
 
 int test_geometry_contours(TstContext* suite, const TstCase* tstitem);
 
+int test_geometry_parallel_topology(TstContext* suite, const TstCase* tstitem);
+
 int test_geometry_polygon_triangulation(TstContext* suite, const TstCase* tstitem);
 
 int test_geometry_polygon_triangulation_invalid(TstContext* suite, const TstCase* tstitem);
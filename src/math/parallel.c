@@ -14,7 +14,10 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include <stdlib.h>
+
 #include "_assertions.h"
+#include "_env.h"
 #include "datoviz/math/parallel.h"
 
 
@@ -72,23 +75,29 @@ int dvz_threads_get(void)
 
 
 
-DvzResult dvz_threads_default(void)
+int dvz_threads_default_count(int num_procs)
 {
-#if DVZ_HAS_OPENMP
-    // Set number of threads from DVZ_NUM_THREADS env variable.
-    char* env = getenv("DVZ_NUM_THREADS");
-    if (env == NULL)
-    {
-        int n = dvz_num_procs();
-        n = DVZ_MAX(1, n / 2);
-        ASSERT(1 <= n);
-        return dvz_threads_set(n);
-    }
-    else
+    num_procs = DVZ_MAX(num_procs, 1);
+    int num_threads = DVZ_MAX(1, num_procs / 2);
+    if (getenv("DVZ_NUM_THREADS") != NULL)
     {
-        int num_threads = getenvint("DVZ_NUM_THREADS");
-        return dvz_threads_set(num_threads);
+        // Nonpositive values are relative to the processor count.
+        num_threads = getenvint("DVZ_NUM_THREADS");
+        if (num_threads <= 0)
+            num_threads += num_procs;
     }
+    return DVZ_CLIP(num_threads, 1, num_procs);
+}
+
+
+
+DvzResult dvz_threads_default(void)
+{
+#if DVZ_HAS_OPENMP
+    int num_procs = dvz_num_procs();
+    if (num_procs <= 0)
+        return DVZ_ERROR;
+    return dvz_threads_set(dvz_threads_default_count(num_procs));
 #else
     return DVZ_ERROR;
 #endif
@@ -52,6 +52,7 @@
 #define DVZ_SCENE_MAX_BUFFERS    128
 #define DVZ_SCENE_MAX_BUFFER_RETIREMENTS 128
 #define DVZ_SCENE_MAX_COMPUTES   64
+#define DVZ_SCENE_CONTRACT_MEMO_CAPACITY 1024
 #define DVZ_SCENE_MAX_SCALES     64
 #define DVZ_SCENE_MAX_COLORMAPS  64
 #define DVZ_SCENE_MAX_COLORBARS  64
@@ -104,6 +105,7 @@
     ((2 + DVZ_SCENE_MAX_AXIS_MINOR_TICKS) * DVZ_SCENE_MAX_AXIS_TICKS + 1)
 #define DVZ_SCENE_TEXT_ATLAS_MAX_GLYPHS 256
 #define DVZ_SCENE_MAX_TEXT_ATLASES_PER_FONT 32
+#define DVZ_SCENE_TEXT_ATLAS_MAX_SHELVES 64
 #define DVZ_SCENE_TEXT_BLOCK_SOURCE_SIZE 1024
 #define DVZ_SCENE_TEXT_BLOCK_TEXT_SIZE   1024
 #define DVZ_SCENE_TEXT_BLOCK_MAX_RUNS    64
@@ -330,6 +332,8 @@ typedef struct DvzSceneCompute DvzSceneCompute;
 typedef struct DvzScale   DvzScale;
 typedef struct DvzColormap DvzColormap;
 typedef struct DvzColorbar DvzColorbar;
+typedef struct DvzTextFtCache DvzTextFtCache;
+typedef struct DvzThreadPool DvzThreadPool;
 typedef struct DvzLegend DvzLegend;
 typedef struct DvzInteractionPolicy DvzInteractionPolicy;
 typedef struct DvzSelection DvzSelection;
@@ -348,6 +352,8 @@ typedef struct DvzAnimation DvzAnimation;
 typedef struct DvzTextShapedGlyph DvzTextShapedGlyph;
 typedef struct DvzTextLayoutMetrics DvzTextLayoutMetrics;
 typedef struct DvzTextGlyphInstance DvzTextGlyphInstance;
+typedef struct DvzTextAtlasShelf DvzTextAtlasShelf;
+typedef struct DvzTextAtlasShelves DvzTextAtlasShelves;
 typedef struct DvzTextBlockRun DvzTextBlockRun;
 typedef struct DvzTextBlockLayout DvzTextBlockLayout;
 typedef struct DvzTextBlockRasterDesc DvzTextBlockRasterDesc;
@@ -643,6 +649,22 @@ struct DvzTextGlyphInstance
 };
 
 
+struct DvzTextAtlasShelf
+{
+    uint32_t y;      /* top row of the shelf */
+    uint32_t height; /* shelf row count */
+    uint32_t x;      /* next free column */
+};
+
+
+struct DvzTextAtlasShelves
+{
+    uint32_t top;   /* first row not covered by a shelf, 0 until the first append */
+    uint32_t count;
+    DvzTextAtlasShelf items[DVZ_SCENE_TEXT_ATLAS_MAX_SHELVES];
+};
+
+
 struct DvzTextAtlas
 {
     DvzTextAtlasSpec spec;
@@ -662,6 +684,8 @@ struct DvzTextAtlas
     uint32_t missing_glyph_count;
     uint64_t generation;
     DvzTextAtlasGlyph glyphs[DVZ_SCENE_TEXT_ATLAS_MAX_GLYPHS];
+
+    DvzTextAtlasShelves shelves; /* glyphs appended below the last full build */
 };
 
 
@@ -1378,6 +1402,9 @@ typedef struct DvzQueuedQueryResult DvzQueuedQueryResult;
 typedef struct DvzRequestFreshnessScope DvzRequestFreshnessScope;
 typedef struct DvzSceneQueryScratch DvzSceneQueryScratch;
 typedef struct DvzSceneRequestExecutor DvzSceneRequestExecutor;
+typedef struct DvzSceneQueryInflight DvzSceneQueryInflight;
+typedef struct DvzSceneSpatialIndex DvzSceneSpatialIndex;
+typedef struct DvzSceneRegionSelection DvzSceneRegionSelection;
 
 struct DvzPendingQueryRequest
 {
@@ -1388,6 +1415,7 @@ struct DvzPendingQueryRequest
     DvzQueryRequest request;
     DvzItemInteraction* item_interaction;
     uint32_t item_interaction_kind;
+    DvzVisual* resume_after; /* pipelined miss: resume the z-order search below this visual */
 };
 
 
@@ -1419,9 +1447,16 @@ struct DvzSceneRequestExecutor
     uint32_t query_static_cache_key_count;
     DvzSceneVisualFamily active_query_family;
     DvzSceneTargetKind active_query_target;
+    DvzSceneQueryInflight* inflight; /* pipelined readback ring, allocated on first use */
+    uint64_t pipeline_tick;
+    bool pipeline_defer;     /* the next readback query submits into the ring */
+    bool pipeline_submitted; /* the last deferred query entered the ring */
+    bool pipeline_blocked;   /* the last deferred query waits for the ring to drain */
     uint32_t runtime_create_count;
     uint32_t emitter_create_count;
     uint32_t query_static_cache_upload_count;
+    uint32_t pipeline_submit_count;
+    uint32_t pipeline_collect_count;
 };
 
 
@@ -1441,6 +1476,7 @@ struct DvzSampledField
     void* upload;
     uint64_t upload_size;
     DvzSceneBuffer* buffer;
+    uint32_t ring_origin[3];
     bool dirty;
     bool dirty_full;
     DvzFieldRegion dirty_region;
@@ -1458,6 +1494,8 @@ struct DvzSceneBuffer
     uint64_t extent_revision;
     uint64_t lifecycle_revision;
     bool dirty;
+    uint64_t dirty_offset; /* first dirty byte, meaningful while dirty */
+    uint64_t dirty_size;   /* dirty byte count, meaningful while dirty */
 };
 
 
@@ -1662,6 +1700,21 @@ struct DvzVectorState
 };
 
 
+typedef struct DvzMeshSurfaceState DvzMeshSurfaceState;
+
+struct DvzMeshSurfaceState
+{
+    DvzSampledField* field;     /* borrowed height field, NULL when the GPU surface mode is off */
+    DvzSceneCompute* compute;   /* owned displacement and normal pass */
+    DvzSceneBuffer* grid;       /* owned storage buffer with the grid provenance */
+    DvzSceneBuffer* heights;    /* owned storage mirror of the field samples */
+    DvzSceneBuffer* positions;  /* owned compute output bound to "position" */
+    DvzSceneBuffer* normals;    /* owned compute output bound to "normal" */
+    uint32_t rows;
+    uint32_t cols;
+};
+
+
 typedef struct DvzTextVisualState DvzTextVisualState;
 
 struct DvzTextVisualState
@@ -1764,6 +1817,7 @@ struct DvzVisualFamilyState
     DvzSegmentState        segment;
     DvzPathState           path;
     DvzVectorState         vector;
+    DvzMeshSurfaceState    mesh_surface;
     DvzTextVisualState     text;
     DvzTextAtlasEncoding   glyph_atlas_encoding;
     float                  glyph_distance_range_px;
@@ -1806,6 +1860,8 @@ struct DvzVisual
     DvzLinkChannel* link_channel;
     uint64_t*       link_keys;
     uint32_t        link_key_count;
+    DvzSceneSpatialIndex* spatial_index; /* optional CPU pick index, NULL when disabled */
+    DvzSceneRegionSelection* region_selection; /* last rectangle or lasso selection, or NULL */
     bool                   scene_occluder;
     bool                   scene_occluded;
     DvzVisualTransformDesc transform_desc;
@@ -2137,9 +2193,23 @@ typedef struct DvzSceneEmitTiming
     uint64_t contract_ns;
     uint64_t emit_ns;
     uint64_t cleanup_ns;
+    uint32_t contract_pass_count;     /* render contracts checked in the last emission */
+    uint32_t contract_memo_hit_count; /* validations skipped by the memo, not reused plan work */
+    uint64_t target_bytes;            /* estimated per-frame render target memory */
+    uint64_t aliased_target_bytes;    /* the same, once disjoint-lifetime targets are aliased */
 } DvzSceneEmitTiming;
 
 
+/* Contract memoization, not plan reuse: an open-addressed set of structural hashes of render
+   contracts that validated cleanly. A contract's validity is a pure function of its hashed
+   inputs, so entries never go stale. */
+typedef struct DvzSceneContractMemo
+{
+    uint32_t count;
+    uint64_t hashes[DVZ_SCENE_CONTRACT_MEMO_CAPACITY];
+} DvzSceneContractMemo;
+
+
 struct DvzFigure
 {
     DvzScene*  scene;
@@ -2169,6 +2239,8 @@ struct DvzFigure
     bool has_last_frame_plan_trace;
     bool emit_timing_enabled;
     DvzSceneEmitTiming last_emit_timing;
+    DvzSceneContractMemo contract_memo;
+    DvzArena* frame_arena; // FramePlan storage of the current emission, reset by the next one
 };
 
 
@@ -2287,6 +2359,9 @@ struct DvzScene
 
     uint32_t font_count;
     DvzFont fonts[DVZ_SCENE_MAX_FONTS];
+    DvzTextFtCache* text_ft_cache; /* lazily created FreeType faces and glyphs shared by text */
+    DvzThreadPool* text_atlas_pool; /* lazily created workers generating runtime MSDF glyphs */
+    DvzThreadPool* selection_pool;  /* lazily created workers scanning region selections */
 
     uint32_t text_count;
     DvzText texts[DVZ_SCENE_MAX_TEXTS];
@@ -2312,6 +2387,7 @@ struct DvzScene
     uint32_t pending_query_count;
     DvzPendingQueryRequest pending_queries[DVZ_SCENE_MAX_PENDING_REQUESTS];
     DvzSceneRequestExecutor query_executor;
+    uint32_t query_latency; /* frames between submitting and delivering a query, 0 = synchronous */
 
     uint32_t query_result_count;
     uint32_t query_result_head;
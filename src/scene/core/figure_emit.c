@@ -35,9 +35,11 @@
 #include "core/figure_emit_internal.h"
 #include "core/frame_artifact_internal.h"
 #include "core/frame_trace_internal.h"
+#include "domain/buffer_internal.h"
 #include "domain/field_internal.h"
 #include "plot/internal.h"
 #include "_visual_internal.h"
+#include "_visual_pipeline_internal.h"
 #include "datoviz/scene.h"
 
 
@@ -482,7 +484,7 @@ static bool _scene_visual_dirty_material_emits_upload(const DvzVisual* visual)
         return true;
     case DVZ_VISUAL_TYPE_PRIMITIVE:
     case DVZ_VISUAL_TYPE_MESH:
-        return _scene_visual_has_attr_data(visual, "normal");
+        return _scene_visual_has_attr_source(visual, "normal");
     default:
         return false;
     }
@@ -630,10 +632,10 @@ static void _scene_commit_emit_success(DvzFigure* figure)
             {
                 visual->attrs[ai].dirty_item_count = 0;
                 if (visual->attrs[ai].buffer != NULL)
-                    visual->attrs[ai].buffer->dirty = false;
+                    _scene_buffer_mark_clean(visual->attrs[ai].buffer);
             }
             if (_visual_family_state(visual)->buffer != NULL)
-                _visual_family_state(visual)->buffer->dirty = false;
+                _scene_buffer_mark_clean(_visual_family_state(visual)->buffer);
             if (
                 visual->type == DVZ_VISUAL_TYPE_POINT || visual->type == DVZ_VISUAL_TYPE_PIXEL ||
                 visual->type == DVZ_VISUAL_TYPE_MARKER ||
@@ -645,7 +647,9 @@ static void _scene_commit_emit_success(DvzFigure* figure)
             {
                 int normal_idx = _attr_index(visual, "normal");
                 bool has_normals =
-                    normal_idx >= 0 && visual->attrs[normal_idx].data != NULL &&
+                    normal_idx >= 0 &&
+                    (visual->attrs[normal_idx].data != NULL ||
+                     visual->attrs[normal_idx].buffer != NULL) &&
                     visual->attrs[normal_idx].item_count > 0;
                 bool point_like = visual->type == DVZ_VISUAL_TYPE_POINT ||
                                   visual->type == DVZ_VISUAL_TYPE_PIXEL ||
@@ -688,7 +692,7 @@ static void _scene_commit_emit_success(DvzFigure* figure)
         for (uint32_t bi = 0; bi < compute->binding_count; bi++)
         {
             if (compute->bindings[bi].active && compute->bindings[bi].buffer != NULL)
-                compute->bindings[bi].buffer->dirty = false;
+                _scene_buffer_mark_clean(compute->bindings[bi].buffer);
         }
     }
     for (uint32_t i = 0; i < figure->scene->field_count; i++)
@@ -789,7 +793,13 @@ DvzDrp2CommandStream* _scene_figure_emit_stream_ex(
         phase_start = dvz_time_monotonic_ns();
     }
 
-    DvzFramePlan* plan = dvz_frame_plan(figure_id, 0);
+    // The FramePlan and its scratch only live during this emission: allocate them from the figure
+    // frame arena, whose chunks are reused from one emission to the next.
+    if (figure->frame_arena == NULL)
+        figure->frame_arena = dvz_arena(0);
+    else
+        dvz_arena_reset(figure->frame_arena);
+    DvzFramePlan* plan = dvz_frame_plan_in_arena(figure_id, 0, figure->frame_arena);
     if (plan == NULL)
         return NULL;
 
@@ -827,10 +837,14 @@ DvzDrp2CommandStream* _scene_figure_emit_stream_ex(
         phase_start = dvz_time_monotonic_ns();
     }
 
+    // Contract memoization, not plan reuse: every panel subgraph is rebuilt above in the frame
+    // arena, and only the validation of a pass is skipped while its render node, attachments and
+    // reads keep the structural hash of a previously valid contract.
     DvzDiagnosticReport contract_report;
     dvz_diagnostic_report_init(&contract_report);
-    bool contracts_ok =
-        _scene_frame_plan_contracts_validate_ex(figure, plan, caps, &contract_report);
+    bool contracts_ok = _scene_frame_plan_contracts_validate_memo(
+        figure, plan, caps, &figure->contract_memo, &contract_report,
+        &timing->contract_pass_count, &timing->contract_memo_hit_count);
     if (!contracts_ok)
     {
         for (uint32_t i = 0; i < dvz_diagnostic_report_count(&contract_report); i++)
@@ -848,8 +862,19 @@ DvzDrp2CommandStream* _scene_figure_emit_stream_ex(
     }
 
     _scene_report_capability_fallbacks(plan, caps, report);
+    if (!dvz_frame_plan_graph_alias(plan))
+    {
+        (void)dvz_diagnostic_report_add(report, "scene FramePlan target aliasing failed");
+        dvz_frame_plan_destroy(plan);
+        return NULL;
+    }
     if (figure->emit_timing_enabled)
     {
+        DvzFrameGraphAliasStats alias_stats = dvz_frame_plan_graph_alias_stats(
+            plan, cfg->target_width > 0 ? cfg->target_width : figure->width,
+            cfg->target_height > 0 ? cfg->target_height : figure->height);
+        timing->target_bytes = alias_stats.bytes;
+        timing->aliased_target_bytes = alias_stats.aliased_bytes;
         timing->contract_ns = dvz_time_monotonic_ns() - phase_start;
         phase_start = dvz_time_monotonic_ns();
     }
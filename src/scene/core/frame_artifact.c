@@ -112,7 +112,7 @@ bool _scene_freeze_stream_payloads(DvzDrp2CommandStream* stream)
         uint64_t byte_size = 0;
         if (!_write_texture_payload_size(command, &byte_size) || byte_size > SIZE_MAX)
             return false;
-        void* copy = dvz_malloc((size_t)byte_size);
+        void* copy = _dvz_drp2_stream_payload(stream, byte_size);
         if (copy == NULL)
             return false;
         dvz_memcpy(copy, (size_t)byte_size, command->u.write_texture.data_raw, (size_t)byte_size);
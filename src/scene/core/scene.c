@@ -45,6 +45,8 @@
 #include "domain/graph_internal.h"
 #include "query/internal.h"
 #include "text/text_internal.h"
+#include "text/text_ft_cache.h"
+#include "thread_internal.h"
 #include "datoviz/scene.h"
 
 
@@ -185,11 +187,11 @@ static void _scene_mark_visual_runtime_dirty(DvzVisual* visual)
             attr->dirty_item_count = attr->item_count;
         }
         if (attr->buffer != NULL)
-            attr->buffer->dirty = true;
+            _scene_buffer_mark_dirty(attr->buffer);
     }
 
     if (state->buffer != NULL)
-        state->buffer->dirty = true;
+        _scene_buffer_mark_dirty(state->buffer);
     state->material_params_dirty = true;
     if (
         visual->type == DVZ_VISUAL_TYPE_POINT || visual->type == DVZ_VISUAL_TYPE_PIXEL ||
@@ -235,7 +237,7 @@ static void _scene_mark_runtime_payloads_dirty(DvzScene* scene)
     for (uint32_t i = 0; i < scene->buffer_count; i++)
     {
         if (scene->buffers[i].scene == scene)
-            scene->buffers[i].dirty = true;
+            _scene_buffer_mark_dirty(&scene->buffers[i]);
     }
     for (uint32_t i = 0; i < scene->compute_count; i++)
     {
@@ -245,7 +247,7 @@ static void _scene_mark_runtime_payloads_dirty(DvzScene* scene)
         for (uint32_t bi = 0; bi < compute->binding_count; bi++)
         {
             if (compute->bindings[bi].active && compute->bindings[bi].buffer != NULL)
-                compute->bindings[bi].buffer->dirty = true;
+                _scene_buffer_mark_dirty(compute->bindings[bi].buffer);
         }
     }
 }
@@ -365,6 +367,8 @@ void dvz_scene_destroy(DvzScene* scene)
     {
         DvzFigure* figure = &scene->figures[i];
         _scene_figure_frame_plan_trace_reset(figure);
+        dvz_arena_destroy(figure->frame_arena);
+        figure->frame_arena = NULL;
         for (uint32_t j = 0; j < figure->panel_count; j++)
         {
             DvzPanel* panel = &figure->panels[j];
@@ -395,6 +399,14 @@ void dvz_scene_destroy(DvzScene* scene)
         dvz_colormap_destroy(&scene->colormaps[i]);
     for (uint32_t i = 0; i < scene->font_count; i++)
         _scene_font_release(&scene->fonts[i]);
+    _scene_text_ft_cache_destroy(scene->text_ft_cache);
+    scene->text_ft_cache = NULL;
+    if (scene->text_atlas_pool != NULL)
+        dvz_thread_pool_destroy(scene->text_atlas_pool);
+    scene->text_atlas_pool = NULL;
+    if (scene->selection_pool != NULL)
+        dvz_thread_pool_destroy(scene->selection_pool);
+    scene->selection_pool = NULL;
     for (uint32_t i = 0; i < scene->symbol_set_count; i++)
     {
         for (uint32_t j = 0; j < scene->symbol_sets[i].source_count; j++)
@@ -705,6 +717,7 @@ void dvz_figure_destroy(DvzFigure* figure)
     if (!_scene_visual_mutation_allowed(figure->scene, "destroy figure"))
         return;
     _scene_figure_frame_plan_trace_reset(figure);
+    dvz_arena_destroy(figure->frame_arena);
     for (uint32_t i = 0; i < figure->panel_count; i++)
         _scene_panel_reset(&figure->panels[i], false);
     dvz_memset(figure->panels, sizeof(figure->panels), 0, sizeof(figure->panels));
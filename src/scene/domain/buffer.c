@@ -158,10 +158,69 @@ void _scene_buffer_commit_data(
         buffer->extent_revision =
             buffer->extent_revision == UINT64_MAX ? 1 : buffer->extent_revision + 1;
     buffer->dirty = true;
+    buffer->dirty_offset = 0;
+    buffer->dirty_size = byte_size;
     _scene_notify_buffer_changed(buffer);
 }
 
 
+
+/**
+ * Return the byte range to upload for a dirty scene buffer.
+ *
+ * @param buffer the buffer
+ * @param out_offset output first dirty byte
+ * @param out_size output dirty byte count
+ */
+void _scene_buffer_dirty_range(
+    const DvzSceneBuffer* buffer, uint64_t* out_offset, uint64_t* out_size)
+{
+    ANN(buffer);
+    ANN(out_offset);
+    ANN(out_size);
+    // Buffers without CPU data are satisfied externally and always report their full extent.
+    if (buffer->data == NULL || buffer->dirty_size == 0 ||
+        buffer->dirty_offset + buffer->dirty_size > buffer->desc.byte_size)
+    {
+        *out_offset = 0;
+        *out_size = buffer->desc.byte_size;
+        return;
+    }
+    *out_offset = buffer->dirty_offset;
+    *out_size = buffer->dirty_size;
+}
+
+
+
+/**
+ * Mark the full extent of a scene buffer for upload.
+ *
+ * @param buffer the buffer
+ */
+void _scene_buffer_mark_dirty(DvzSceneBuffer* buffer)
+{
+    ANN(buffer);
+    buffer->dirty = true;
+    buffer->dirty_offset = 0;
+    buffer->dirty_size = buffer->desc.byte_size;
+}
+
+
+
+/**
+ * Mark a scene buffer as uploaded.
+ *
+ * @param buffer the buffer
+ */
+void _scene_buffer_mark_clean(DvzSceneBuffer* buffer)
+{
+    ANN(buffer);
+    buffer->dirty = false;
+    buffer->dirty_offset = 0;
+    buffer->dirty_size = 0;
+}
+
+
 /**
  * Allocate one free scene-buffer slot from a scene.
  *
@@ -350,6 +409,68 @@ DvzResult dvz_scene_buffer_set_data(DvzSceneBuffer* buffer, const void* data, ui
     if (extent_changed)
         buffer->extent_revision = buffer->extent_revision == UINT64_MAX ? 1 : buffer->extent_revision + 1;
     buffer->dirty = true;
+    buffer->dirty_offset = 0;
+    buffer->dirty_size = byte_size;
+    _scene_notify_buffer_changed(buffer);
+    return DVZ_OK;
+}
+
+
+
+/**
+ * Overwrite a byte range of a scene-owned buffer resource.
+ *
+ * @param buffer the buffer
+ * @param byte_offset first byte to overwrite
+ * @param data the packed payload
+ * @param byte_size the payload size
+ * @return DVZ_OK on success, DVZ_ERROR on error
+ */
+DvzResult dvz_scene_buffer_update_data(
+    DvzSceneBuffer* buffer, uint64_t byte_offset, const void* data, uint64_t byte_size)
+{
+    ANN(buffer);
+    if (buffer == NULL || buffer->scene == NULL)
+        return DVZ_ERROR;
+    if (!_scene_visual_mutation_allowed(buffer->scene, "update scene buffer data"))
+        return DVZ_ERROR;
+    if (buffer->data == NULL)
+    {
+        log_error("scene buffer range update requires a prior dvz_scene_buffer_set_data()");
+        return DVZ_ERROR;
+    }
+    uint64_t byte_end = 0;
+    if (data == NULL || byte_size == 0 ||
+        _dvz_add_u64_overflows(byte_offset, byte_size, &byte_end) ||
+        byte_end > buffer->desc.byte_size)
+    {
+        log_error(
+            "scene buffer range update [%" PRIu64 ", +%" PRIu64 ") exceeds %" PRIu64 " bytes",
+            byte_offset, byte_size, buffer->desc.byte_size);
+        return DVZ_ERROR;
+    }
+    if (byte_offset % buffer->desc.stride != 0 || byte_size % buffer->desc.stride != 0)
+    {
+        log_error("scene buffer range update is not aligned to stride %u", buffer->desc.stride);
+        return DVZ_ERROR;
+    }
+
+    dvz_memcpy((uint8_t*)buffer->data + byte_offset, byte_size, data, byte_size);
+    if (buffer->dirty)
+    {
+        // Several updates in one frame coalesce into their enclosing range.
+        uint64_t dirty_end = buffer->dirty_offset + buffer->dirty_size;
+        buffer->dirty_offset = DVZ_MIN(buffer->dirty_offset, byte_offset);
+        buffer->dirty_size = DVZ_MAX(dirty_end, byte_end) - buffer->dirty_offset;
+    }
+    else
+    {
+        buffer->dirty_offset = byte_offset;
+        buffer->dirty_size = byte_size;
+    }
+    buffer->content_revision =
+        buffer->content_revision == UINT64_MAX ? 1 : buffer->content_revision + 1;
+    buffer->dirty = true;
     _scene_notify_buffer_changed(buffer);
     return DVZ_OK;
 }
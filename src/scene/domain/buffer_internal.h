@@ -23,4 +23,11 @@ DvzResult _scene_buffer_prepare_data(
 void _scene_buffer_commit_data(
     DvzSceneBuffer* buffer, void* data, uint64_t byte_size, uint64_t capacity);
 
+void _scene_buffer_dirty_range(
+    const DvzSceneBuffer* buffer, uint64_t* out_offset, uint64_t* out_size);
+
+void _scene_buffer_mark_dirty(DvzSceneBuffer* buffer);
+
+void _scene_buffer_mark_clean(DvzSceneBuffer* buffer);
+
 void _scene_release_visual_buffer(DvzVisual* visual);
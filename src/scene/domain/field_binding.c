@@ -25,6 +25,7 @@
 #include "_scene.h"
 #include "core/scene_notify_internal.h"
 #include "field_internal.h"
+#include "mesh_surface_internal.h"
 #include "sample_profile.h"
 #include "visuals/bindings_internal.h"
 #include "_visual_internal.h"
@@ -179,6 +180,8 @@ void _scene_release_field_bindings(DvzSampledField* field)
     {
         DvzVisual* visual = &scene->visuals[i];
         DvzVisualFamilyState* state = _visual_family_state(visual);
+        if (state != NULL && state->mesh_surface.field == field)
+            _scene_mesh_surface_forget_field(visual);
         if (state == NULL || state->field != field)
             continue;
         _visual_binding_clear(visual, DVZ_VISUAL_BINDING_FIELD);
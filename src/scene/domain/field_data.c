@@ -58,6 +58,48 @@ DvzFieldDataView dvz_field_data_view(void)
 
 
 
+/**
+ * Split a logical span along one ring axis into at most two physical spans.
+ *
+ * @param start logical span start
+ * @param extent logical span extent
+ * @param origin physical sample of logical sample 0
+ * @param size axis size
+ * @param out_start output physical span starts
+ * @param out_extent output physical span extents
+ * @return number of physical spans
+ */
+static uint32_t _field_ring_span(
+    uint32_t start, uint32_t extent, uint32_t origin, uint32_t size, uint32_t out_start[2],
+    uint32_t out_extent[2])
+{
+    out_start[0] = (start + origin) % size;
+    out_extent[0] = DVZ_MIN(extent, size - out_start[0]);
+    if (out_extent[0] == extent)
+        return 1;
+    out_start[1] = 0;
+    out_extent[1] = extent - out_extent[0];
+    return 2;
+}
+
+
+
+/**
+ * Reset the ring origin of a field whose payload is replaced in logical order.
+ *
+ * @param field the sampled field
+ * @return whether the origin was not already zero
+ */
+static bool _field_ring_origin_reset(DvzSampledField* field)
+{
+    bool active = field->ring_origin[0] != 0 || field->ring_origin[1] != 0 ||
+                  field->ring_origin[2] != 0;
+    dvz_memset(field->ring_origin, sizeof(field->ring_origin), 0, sizeof(field->ring_origin));
+    return active;
+}
+
+
+
 bool _field_data_view_valid(
     const DvzSampledFieldDesc* desc, const DvzFieldDataView* view, const DvzFieldRegion* region)
 {
@@ -169,6 +211,25 @@ bool _field_ensure_upload(DvzSampledField* field, uint64_t byte_size)
 
 
 
+/**
+ * Return the normalized ring origin consumed by field sampling shaders.
+ *
+ * @param field the sampled field, or NULL
+ * @param out output origin over the field extent in xyz, zero in w
+ */
+void _field_ring_origin_uvw(const DvzSampledField* field, float out[4])
+{
+    ANN(out);
+    dvz_memset(out, 4 * sizeof(float), 0, 4 * sizeof(float));
+    if (field == NULL)
+        return;
+    const uint32_t size[3] = {field->desc.width, field->desc.height, field->desc.depth};
+    for (uint32_t i = 0; i < 3; i++)
+        out[i] = size[i] > 0 ? (float)field->ring_origin[i] / (float)size[i] : 0.0f;
+}
+
+
+
 /**
  * Replace the entire field payload.
  *
@@ -205,7 +266,10 @@ DvzResult dvz_sampled_field_set_data(DvzSampledField* field, const DvzFieldDataV
     }
 
     _field_copy_full_data(&field->desc, view, field->data);
+    bool had_ring_origin = _field_ring_origin_reset(field);
     _scene_mark_field_region_dirty(field, full, true);
+    if (had_ring_origin)
+        _scene_notify_field_ring_origin(field);
     return DVZ_OK;
 }
 
@@ -276,7 +340,10 @@ DvzResult dvz_sampled_field_resize(
     field->desc = desc;
     field->data = data;
     field->data_size = data_size;
+    bool had_ring_origin = _field_ring_origin_reset(field);
     _scene_mark_field_region_dirty(field, full, true);
+    if (had_ring_origin)
+        _scene_notify_field_ring_origin(field);
     return DVZ_OK;
 }
 
@@ -334,21 +401,77 @@ DvzResult dvz_sampled_field_update_region(
     uint64_t src_rows_per_image =
         view->rows_per_image != 0 ? view->rows_per_image : region.height;
     uint64_t dst_bytes_per_row = _field_default_bytes_per_row(&field->desc);
-    uint64_t copy_bytes = (uint64_t)region.width * (uint64_t)bytes_per_texel;
+    const uint32_t* origin = field->ring_origin;
+    uint32_t x0 = (region.x + origin[0]) % field->desc.width;
+    uint32_t head = DVZ_MIN(region.width, field->desc.width - x0);
+    uint64_t head_bytes = (uint64_t)head * (uint64_t)bytes_per_texel;
+    uint64_t tail_bytes = (uint64_t)(region.width - head) * (uint64_t)bytes_per_texel;
     const uint8_t* src = (const uint8_t*)view->data;
     uint8_t* dst = (uint8_t*)field->data;
     for (uint32_t z = 0; z < region.depth; z++)
     {
+        uint32_t pz = (region.z + z + origin[2]) % field->desc.depth;
         for (uint32_t y = 0; y < region.height; y++)
         {
+            uint32_t py = (region.y + y + origin[1]) % field->desc.height;
             uint64_t src_offset = ((uint64_t)z * src_rows_per_image + y) * src_bytes_per_row;
-            uint64_t dst_offset =
-                ((uint64_t)(region.z + z) * field->desc.height + (region.y + y)) *
-                    dst_bytes_per_row +
-                (uint64_t)region.x * (uint64_t)bytes_per_texel;
-            dvz_memcpy(dst + dst_offset, copy_bytes, src + src_offset, copy_bytes);
+            uint64_t row_offset =
+                ((uint64_t)pz * field->desc.height + py) * dst_bytes_per_row;
+            dvz_memcpy(
+                dst + row_offset + (uint64_t)x0 * bytes_per_texel, head_bytes, src + src_offset,
+                head_bytes);
+            // The logical row wraps past the ring seam: the rest starts at physical column 0.
+            if (tail_bytes > 0)
+                dvz_memcpy(
+                    dst + row_offset, tail_bytes, src + src_offset + head_bytes, tail_bytes);
+        }
+    }
+
+    uint32_t xs[2], ws[2], ys[2], hs[2], zs[2], ds[2];
+    uint32_t nx = _field_ring_span(region.x, region.width, origin[0], field->desc.width, xs, ws);
+    uint32_t ny = _field_ring_span(region.y, region.height, origin[1], field->desc.height, ys, hs);
+    uint32_t nz = _field_ring_span(region.z, region.depth, origin[2], field->desc.depth, zs, ds);
+    for (uint32_t k = 0; k < nz; k++)
+    {
+        for (uint32_t j = 0; j < ny; j++)
+        {
+            for (uint32_t i = 0; i < nx; i++)
+            {
+                DvzFieldRegion piece = {xs[i], ys[j], zs[k], ws[i], hs[j], ds[k]};
+                _scene_mark_field_region_dirty(field, piece, false);
+            }
         }
     }
-    _scene_mark_field_region_dirty(field, region, false);
+    return DVZ_OK;
+}
+
+
+
+/**
+ * Set the physical sample holding the logical origin of a circular field.
+ *
+ * @param field the sampled field
+ * @param x physical column of logical column 0
+ * @param y physical row of logical row 0
+ * @param z physical slice of logical slice 0
+ * @return DVZ_OK on success, DVZ_ERROR on error
+ */
+DvzResult
+dvz_sampled_field_set_ring_origin(DvzSampledField* field, uint32_t x, uint32_t y, uint32_t z)
+{
+    ANN(field);
+    if (!_scene_visual_mutation_allowed(field->scene, "set sampled field ring origin"))
+        return DVZ_ERROR;
+    if (x >= field->desc.width || y >= field->desc.height || z >= field->desc.depth)
+    {
+        log_error("sampled field ring origin exceeds field dimensions");
+        return DVZ_ERROR;
+    }
+    if (field->ring_origin[0] == x && field->ring_origin[1] == y && field->ring_origin[2] == z)
+        return DVZ_OK;
+    field->ring_origin[0] = x;
+    field->ring_origin[1] = y;
+    field->ring_origin[2] = z;
+    _scene_notify_field_ring_origin(field);
     return DVZ_OK;
 }
@@ -19,6 +19,7 @@
 #include "_scene.h"
 #include "core/scene_notify_internal.h"
 #include "field_internal.h"
+#include "mesh_surface_internal.h"
 
 
 
@@ -183,6 +184,35 @@ void _scene_mark_field_region_dirty(DvzSampledField* field, DvzFieldRegion regio
                 _scene_visual_texture_mark_region_dirty(visual, &field->desc, region);
             _scene_notify_visual_changed(visual);
         }
+        if (visual->scene == scene && _visual_family_state(visual)->mesh_surface.field == field)
+            _scene_mesh_surface_sync_field(visual, region, full);
+    }
+}
+
+
+
+/**
+ * Notify the visuals sampling a field that its ring origin moved.
+ *
+ * No sample data changes: sampling visuals only refresh their shader parameters, and GPU mesh
+ * surfaces rewrite the origin in their kernel parameter block.
+ *
+ * @param field the sampled field
+ */
+void _scene_notify_field_ring_origin(DvzSampledField* field)
+{
+    if (field == NULL || field->scene == NULL)
+        return;
+    DvzScene* scene = field->scene;
+    for (uint32_t i = 0; i < scene->visual_count; i++)
+    {
+        DvzVisual* visual = &scene->visuals[i];
+        if (visual->scene != scene)
+            continue;
+        if (_visual_family_state(visual)->field == field)
+            _scene_notify_visual_changed(visual);
+        if (_visual_family_state(visual)->mesh_surface.field == field)
+            _scene_mesh_surface_sync_ring_origin(visual);
     }
 }
 
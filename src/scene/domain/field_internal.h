@@ -69,6 +69,8 @@ bool _field_read_scalar(const DvzSampledField* field, uint64_t sample_index, dou
 
 bool _field_ensure_upload(DvzSampledField* field, uint64_t byte_size);
 
+void _field_ring_origin_uvw(const DvzSampledField* field, float out[4]);
+
 bool _scene_prepare_field_texture(
     DvzSampledField* field, DvzFieldRegion* out_region, const void** out_data);
 
@@ -84,6 +86,8 @@ bool _scene_prepare_image_texture(
 
 void _scene_mark_field_region_dirty(DvzSampledField* field, DvzFieldRegion region, bool full);
 
+void _scene_notify_field_ring_origin(DvzSampledField* field);
+
 void _scene_visual_texture_mark_clean(DvzVisual* visual);
 
 void _scene_visual_texture_mark_dirty(DvzVisual* visual);
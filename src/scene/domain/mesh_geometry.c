@@ -20,6 +20,7 @@
 #include "core/scene_notify_internal.h"
 #include "datoviz/scene.h"
 #include "domain/buffer_internal.h"
+#include "domain/mesh_surface_internal.h"
 #include "visuals/_visual_internal.h"
 #include "visuals/bindings_internal.h"
 
@@ -112,6 +113,28 @@ static bool _mesh_geometry_dvec2_valid(const double* values, uint32_t count)
 
 
 
+/**
+ * Return whether one F32 geometry array only holds finite values.
+ *
+ * @param values flattened F32 array
+ * @param count number of scalar values
+ * @return whether all values are finite
+ */
+static bool _mesh_geometry_f32_array_valid(const float* values, uint64_t count)
+{
+    if (values == NULL)
+        return false;
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        if (!isfinite(values[i]))
+            return false;
+    }
+    return true;
+}
+
+
+
 /**
  * Copy a F64 3-vector array into a F32 3-vector array.
  *
@@ -179,9 +202,11 @@ static bool _mesh_geometry_indices_unchanged(
  */
 DvzResult dvz_mesh_set_geometry(DvzVisual* visual, const DvzGeometry* geometry)
 {
+    const bool f32 = geometry != NULL && geometry->precision == DVZ_GEOMETRY_PRECISION_F32;
     if (
         visual == NULL || visual->type != DVZ_VISUAL_TYPE_MESH || geometry == NULL ||
-        geometry->vertex_count == 0 || geometry->positions == NULL)
+        geometry->vertex_count == 0 ||
+        (f32 ? geometry->positions_f32 == NULL : geometry->positions == NULL))
     {
         return -1;
     }
@@ -193,16 +218,33 @@ DvzResult dvz_mesh_set_geometry(DvzVisual* visual, const DvzGeometry* geometry)
         return -1;
     }
 
-    if (!_mesh_geometry_dvec3_valid(&geometry->positions[0][0], vertex_count))
-        return -1;
-    if (
-        geometry->normals != NULL &&
-        !_mesh_geometry_dvec3_valid(&geometry->normals[0][0], vertex_count))
-        return -1;
-    if (
-        geometry->texcoords != NULL &&
-        !_mesh_geometry_dvec2_valid(&geometry->texcoords[0][0], vertex_count))
-        return -1;
+    if (f32)
+    {
+        // F32 geometries are uploaded as they are, without the F64 conversion pass.
+        if (!_mesh_geometry_f32_array_valid(&geometry->positions_f32[0][0], 3ull * vertex_count))
+            return -1;
+        if (
+            geometry->normals_f32 != NULL &&
+            !_mesh_geometry_f32_array_valid(&geometry->normals_f32[0][0], 3ull * vertex_count))
+            return -1;
+        if (
+            geometry->texcoords_f32 != NULL &&
+            !_mesh_geometry_f32_array_valid(&geometry->texcoords_f32[0][0], 2ull * vertex_count))
+            return -1;
+    }
+    else
+    {
+        if (!_mesh_geometry_dvec3_valid(&geometry->positions[0][0], vertex_count))
+            return -1;
+        if (
+            geometry->normals != NULL &&
+            !_mesh_geometry_dvec3_valid(&geometry->normals[0][0], vertex_count))
+            return -1;
+        if (
+            geometry->texcoords != NULL &&
+            !_mesh_geometry_dvec2_valid(&geometry->texcoords[0][0], vertex_count))
+            return -1;
+    }
 
     if (geometry->index_count > 0)
     {
@@ -219,30 +261,40 @@ DvzResult dvz_mesh_set_geometry(DvzVisual* visual, const DvzGeometry* geometry)
         }
     }
 
-    vec3* positions = (vec3*)dvz_calloc(vertex_count, sizeof(vec3));
+    vec3* positions = NULL;
     vec3* normals = NULL;
     vec2* texcoords = NULL;
     DvzColor* default_colors = NULL;
-    if (positions == NULL)
-        return -1;
-
+    const vec3* upload_positions = geometry->positions_f32;
+    const vec3* upload_normals = geometry->normals_f32;
+    const vec2* upload_texcoords = geometry->texcoords_f32;
     int out = -1;
-    _mesh_geometry_copy_dvec3(positions, &geometry->positions[0][0], vertex_count);
 
-    if (geometry->normals != NULL)
+    if (!f32)
     {
-        normals = (vec3*)dvz_calloc(vertex_count, sizeof(vec3));
-        if (normals == NULL)
-            goto cleanup;
-        _mesh_geometry_copy_dvec3(normals, &geometry->normals[0][0], vertex_count);
-    }
+        positions = (vec3*)dvz_calloc(vertex_count, sizeof(vec3));
+        if (positions == NULL)
+            return -1;
+        _mesh_geometry_copy_dvec3(positions, &geometry->positions[0][0], vertex_count);
+        upload_positions = positions;
 
-    if (geometry->texcoords != NULL)
-    {
-        texcoords = (vec2*)dvz_calloc(vertex_count, sizeof(vec2));
-        if (texcoords == NULL)
-            goto cleanup;
-        _mesh_geometry_copy_dvec2(texcoords, &geometry->texcoords[0][0], vertex_count);
+        if (geometry->normals != NULL)
+        {
+            normals = (vec3*)dvz_calloc(vertex_count, sizeof(vec3));
+            if (normals == NULL)
+                goto cleanup;
+            _mesh_geometry_copy_dvec3(normals, &geometry->normals[0][0], vertex_count);
+        }
+        upload_normals = normals;
+
+        if (geometry->texcoords != NULL)
+        {
+            texcoords = (vec2*)dvz_calloc(vertex_count, sizeof(vec2));
+            if (texcoords == NULL)
+                goto cleanup;
+            _mesh_geometry_copy_dvec2(texcoords, &geometry->texcoords[0][0], vertex_count);
+        }
+        upload_texcoords = texcoords;
     }
 
     const DvzColor* colors = geometry->colors;
@@ -259,19 +311,19 @@ DvzResult dvz_mesh_set_geometry(DvzVisual* visual, const DvzGeometry* geometry)
 
     DvzVisualDataUpdate updates[4] = {
         {.attr_name = "color", .data = colors, .item_count = vertex_count},
-        {.attr_name = "position", .data = positions, .item_count = vertex_count},
+        {.attr_name = "position", .data = upload_positions, .item_count = vertex_count},
     };
     uint32_t update_count = 2;
 
-    if (normals != NULL)
+    if (upload_normals != NULL)
     {
         updates[update_count++] = (DvzVisualDataUpdate){
-            .attr_name = "normal", .data = normals, .item_count = vertex_count};
+            .attr_name = "normal", .data = upload_normals, .item_count = vertex_count};
     }
-    if (texcoords != NULL)
+    if (upload_texcoords != NULL)
     {
         updates[update_count++] = (DvzVisualDataUpdate){
-            .attr_name = "texcoords", .data = texcoords, .item_count = vertex_count};
+            .attr_name = "texcoords", .data = upload_texcoords, .item_count = vertex_count};
     }
 
     DvzSceneBuffer* prepared_index = NULL;
@@ -318,6 +370,8 @@ DvzResult dvz_mesh_set_geometry(DvzVisual* visual, const DvzGeometry* geometry)
         }
     }
 
+    // Leaving GPU surface mode unbinds the compute-written position and normal buffers.
+    _scene_mesh_surface_release(visual, true);
     if (dvz_visual_set_data_many(visual, updates, update_count) != 0)
     {
         dvz_free(prepared_index_data);
@@ -0,0 +1,681 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Mesh GPU surface                                                                             */
+/*************************************************************************************************/
+
+/*
+ * A mesh in surface mode keeps the grid layout and a storage mirror of the height field on the
+ * GPU. One compute pass displaces the grid vertices along the height axis and rebuilds the
+ * central-difference normals in place of the CPU surface-grid path. Scene compute passes bind
+ * storage buffers only, so field updates are copied row by row into the mirror with ranged
+ * buffer updates instead of being sampled from the field texture.
+ */
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include "_alloc.h"
+#include "_log.h"
+#include "_overflow.h"
+#include "_scene.h"
+#include "core/scene_notify_internal.h"
+#include "datoviz/scene.h"
+#include "domain/buffer_internal.h"
+#include "domain/mesh_surface_internal.h"
+#include "visuals/_visual_internal.h"
+#include "visuals/bindings_internal.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_MESH_SURFACE_WORKGROUP 16u
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct DvzMeshSurfaceGrid DvzMeshSurfaceGrid;
+
+/* std430 layout shared with the compute kernels. */
+struct DvzMeshSurfaceGrid
+{
+    float origin[4];
+    float col_basis[4];
+    float row_basis[4];
+    float height_axis[4]; /* pre-multiplied by the grid height scale */
+    uint32_t extent[4];   /* rows, cols, ring origin row, ring origin col */
+};
+
+
+
+/*************************************************************************************************/
+/*  Shaders                                                                                      */
+/*************************************************************************************************/
+
+static const char* MESH_SURFACE_WGSL =
+    "struct Grid { origin: vec4f, col: vec4f, row: vec4f, axis: vec4f, extent: vec4u, }\n"
+    "@group(0) @binding(0) var<storage, read> grid: Grid;\n"
+    "@group(0) @binding(1) var<storage, read> heights: array<f32>;\n"
+    "@group(0) @binding(2) var<storage, read_write> positions: array<f32>;\n"
+    "@group(0) @binding(3) var<storage, read_write> normals: array<f32>;\n"
+    "fn surface_point(r: u32, c: u32) -> vec3f {\n"
+    "    let pr = (r + grid.extent.z) % grid.extent.x;\n"
+    "    let pc = (c + grid.extent.w) % grid.extent.y;\n"
+    "    let h = heights[pr * grid.extent.y + pc];\n"
+    "    return grid.origin.xyz + f32(c) * grid.col.xyz + f32(r) * grid.row.xyz +\n"
+    "        h * grid.axis.xyz;\n"
+    "}\n"
+    "@compute @workgroup_size(16, 16)\n"
+    "fn main(@builtin(global_invocation_id) global_id: vec3u) {\n"
+    "    let c = global_id.x;\n"
+    "    let r = global_id.y;\n"
+    "    let rows = grid.extent.x;\n"
+    "    let cols = grid.extent.y;\n"
+    "    if (c >= cols || r >= rows) { return; }\n"
+    "    let du = surface_point(r, min(c + 1u, cols - 1u)) - surface_point(r, max(c, 1u) - 1u);\n"
+    "    let dv = surface_point(min(r + 1u, rows - 1u), c) - surface_point(max(r, 1u) - 1u, c);\n"
+    "    let n = cross(du, dv);\n"
+    "    let len = length(n);\n"
+    "    let normal = select(vec3f(0.0, 0.0, 1.0), n / len, len > 0.0);\n"
+    "    let p = surface_point(r, c);\n"
+    "    let i = 3u * (r * cols + c);\n"
+    "    positions[i + 0u] = p.x;\n"
+    "    positions[i + 1u] = p.y;\n"
+    "    positions[i + 2u] = p.z;\n"
+    "    normals[i + 0u] = normal.x;\n"
+    "    normals[i + 1u] = normal.y;\n"
+    "    normals[i + 2u] = normal.z;\n"
+    "}\n";
+
+static const char* MESH_SURFACE_GLSL =
+    "#version 450\n"
+    "layout(local_size_x = 16, local_size_y = 16) in;\n"
+    "layout(std430, set = 0, binding = 0) readonly buffer Grid {\n"
+    "    vec4 origin; vec4 col; vec4 row; vec4 axis; uvec4 extent;\n"
+    "} grid;\n"
+    "layout(std430, set = 0, binding = 1) readonly buffer Heights { float h[]; } heights;\n"
+    "layout(std430, set = 0, binding = 2) buffer Positions { float x[]; } positions;\n"
+    "layout(std430, set = 0, binding = 3) buffer Normals { float x[]; } normals;\n"
+    "vec3 surface_point(uint r, uint c) {\n"
+    "    uint pr = (r + grid.extent.z) % grid.extent.x;\n"
+    "    uint pc = (c + grid.extent.w) % grid.extent.y;\n"
+    "    float h = heights.h[pr * grid.extent.y + pc];\n"
+    "    return grid.origin.xyz + float(c) * grid.col.xyz + float(r) * grid.row.xyz +\n"
+    "        h * grid.axis.xyz;\n"
+    "}\n"
+    "void main() {\n"
+    "    uint c = gl_GlobalInvocationID.x;\n"
+    "    uint r = gl_GlobalInvocationID.y;\n"
+    "    uint rows = grid.extent.x;\n"
+    "    uint cols = grid.extent.y;\n"
+    "    if (c >= cols || r >= rows) return;\n"
+    "    vec3 du = surface_point(r, min(c + 1u, cols - 1u)) - surface_point(r, max(c, 1u) - 1u);\n"
+    "    vec3 dv = surface_point(min(r + 1u, rows - 1u), c) - surface_point(max(r, 1u) - 1u, c);\n"
+    "    vec3 n = cross(du, dv);\n"
+    "    float len = length(n);\n"
+    "    vec3 normal = len > 0.0 ? n / len : vec3(0.0, 0.0, 1.0);\n"
+    "    vec3 p = surface_point(r, c);\n"
+    "    uint i = 3u * (r * cols + c);\n"
+    "    positions.x[i + 0u] = p.x;\n"
+    "    positions.x[i + 1u] = p.y;\n"
+    "    positions.x[i + 2u] = p.z;\n"
+    "    normals.x[i + 0u] = normal.x;\n"
+    "    normals.x[i + 1u] = normal.y;\n"
+    "    normals.x[i + 2u] = normal.z;\n"
+    "}\n";
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Return the surface state of a visual.
+ *
+ * @param visual the visual
+ * @return the surface state
+ */
+static DvzMeshSurfaceState* _mesh_surface_state(DvzVisual* visual)
+{
+    return &_visual_family_state(visual)->mesh_surface;
+}
+
+
+
+/**
+ * Return whether a surface grid can drive a GPU surface.
+ *
+ * @param grid the surface grid geometry
+ * @return whether the grid is usable
+ */
+static bool _mesh_surface_grid_valid(const DvzGeometry* grid)
+{
+    if (grid == NULL || grid->type != DVZ_GEOMETRY_SURFACE_GRID)
+    {
+        log_error("GPU mesh surfaces require a geometry from dvz_geometry_surface_grid()");
+        return false;
+    }
+    const bool f32 = grid->precision == DVZ_GEOMETRY_PRECISION_F32;
+    uint64_t count = 0;
+    if (
+        grid->grid_rows < 2 || grid->grid_cols < 2 ||
+        _dvz_mul_u64_overflows(grid->grid_rows, grid->grid_cols, &count) ||
+        count != grid->vertex_count || count > UINT32_MAX / 3 ||
+        (f32 ? grid->positions_f32 == NULL : grid->positions == NULL) ||
+        grid->indices == NULL || grid->index_count == 0)
+    {
+        log_error("GPU mesh surface grid is incomplete or inconsistent");
+        return false;
+    }
+    return true;
+}
+
+
+
+/**
+ * Return whether a sampled field can provide the heights of a surface grid.
+ *
+ * @param visual the mesh visual
+ * @param field the height field
+ * @param rows grid row count
+ * @param cols grid column count
+ * @return whether the field is usable
+ */
+static bool _mesh_surface_field_valid(
+    const DvzVisual* visual, const DvzSampledField* field, uint32_t rows, uint32_t cols)
+{
+    if (field == NULL || field->scene != visual->scene)
+    {
+        log_error("GPU mesh surface height field must belong to the visual's scene");
+        return false;
+    }
+    if (
+        field->desc.dim != DVZ_FIELD_DIM_2D || field->desc.format != DVZ_FIELD_FORMAT_R32_FLOAT ||
+        field->desc.width != cols || field->desc.height != rows)
+    {
+        log_error(
+            "GPU mesh surface height field must be a %ux%u R32_FLOAT 2D field", cols, rows);
+        return false;
+    }
+    return true;
+}
+
+
+
+/**
+ * Create an owned scene buffer holding a copy of a payload.
+ *
+ * @param scene the scene
+ * @param usage buffer usage flags
+ * @param stride item stride in bytes
+ * @param data payload copied into the buffer
+ * @param byte_size payload size in bytes
+ * @return the buffer, or NULL on failure
+ */
+static DvzSceneBuffer* _mesh_surface_buffer(
+    DvzScene* scene, uint32_t usage, uint32_t stride, const void* data, uint64_t byte_size)
+{
+    DvzSceneBufferDesc desc = dvz_scene_buffer_desc();
+    desc.usage = usage;
+    desc.stride = stride;
+    desc.byte_size = byte_size;
+    DvzSceneBuffer* buffer = dvz_scene_buffer(scene, &desc);
+    if (buffer == NULL)
+        return NULL;
+    if (dvz_scene_buffer_set_data(buffer, data, byte_size) != DVZ_OK)
+    {
+        dvz_scene_buffer_destroy(buffer);
+        return NULL;
+    }
+    return buffer;
+}
+
+
+
+/**
+ * Pack the grid layout into the kernel parameter block.
+ *
+ * @param grid the surface grid geometry
+ * @param field the height field providing the ring origin
+ * @param out output parameter block
+ */
+static void _mesh_surface_grid_params(
+    const DvzGeometry* grid, const DvzSampledField* field, DvzMeshSurfaceGrid* out)
+{
+    dvz_memset(out, sizeof(*out), 0, sizeof(*out));
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        out->origin[i] = (float)grid->grid_origin[i];
+        out->col_basis[i] = (float)grid->grid_col_basis[i];
+        out->row_basis[i] = (float)grid->grid_row_basis[i];
+        out->height_axis[i] = (float)(grid->grid_height_axis[i] * grid->grid_height_scale);
+    }
+    out->extent[0] = grid->grid_rows;
+    out->extent[1] = grid->grid_cols;
+    if (field != NULL)
+    {
+        out->extent[2] = field->ring_origin[1];
+        out->extent[3] = field->ring_origin[0];
+    }
+}
+
+
+
+/**
+ * Copy one geometry 3-vector array to F32, or fill it with a constant when absent.
+ *
+ * @param grid the surface grid geometry
+ * @param f64 F64 source array, used by F64 geometries
+ * @param f32 F32 source array, used by F32 geometries
+ * @param fallback value written when the geometry has no such array
+ * @param out output F32 vectors
+ */
+static void _mesh_surface_copy_vec3(
+    const DvzGeometry* grid, const dvec3* f64, const vec3* f32, const vec3 fallback, vec3* out)
+{
+    const uint32_t count = grid->vertex_count;
+    const bool use_f32 = grid->precision == DVZ_GEOMETRY_PRECISION_F32;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t j = 0; j < 3; j++)
+        {
+            if (use_f32 && f32 != NULL)
+                out[i][j] = f32[i][j];
+            else if (!use_f32 && f64 != NULL)
+                out[i][j] = (float)f64[i][j];
+            else
+                out[i][j] = fallback[j];
+        }
+    }
+}
+
+
+
+/**
+ * Drop dense attribute data so the attribute can be rebound or refilled.
+ *
+ * @param visual the mesh visual
+ * @param attr_name attribute name
+ */
+static void _mesh_surface_drop_dense_attr(DvzVisual* visual, const char* attr_name)
+{
+    for (uint32_t i = 0; i < visual->attr_count; i++)
+    {
+        DvzVisualAttr* attr = &visual->attrs[i];
+        if (strcmp(attr->name, attr_name) != 0 || attr->data == NULL)
+            continue;
+        dvz_free(attr->data);
+        attr->data = NULL;
+        if (attr->buffer == NULL)
+            attr->item_count = 0;
+    }
+}
+
+
+
+/**
+ * Bind the index buffer of the surface grid as an owned visual buffer.
+ *
+ * @param visual the mesh visual
+ * @param grid the surface grid geometry
+ * @return whether the index buffer was bound
+ */
+static bool _mesh_surface_bind_indices(DvzVisual* visual, const DvzGeometry* grid)
+{
+    DvzSceneBuffer* index = _mesh_surface_buffer(
+        visual->scene, DVZ_SCENE_BUFFER_USAGE_INDEX, sizeof(DvzIndex), grid->indices,
+        (uint64_t)grid->index_count * sizeof(DvzIndex));
+    if (index == NULL)
+        return false;
+    _scene_release_visual_buffer(visual);
+    _visual_binding_assign(visual, DVZ_VISUAL_BINDING_BUFFER, "index", index, true);
+    return true;
+}
+
+
+
+/**
+ * Upload the dense per-vertex color and texture coordinate arrays of the grid.
+ *
+ * @param visual the mesh visual
+ * @param grid the surface grid geometry
+ * @return whether the upload succeeded
+ */
+static bool _mesh_surface_set_dense_attrs(DvzVisual* visual, const DvzGeometry* grid)
+{
+    const uint32_t count = grid->vertex_count;
+    DvzColor* default_colors = NULL;
+    vec2* texcoords = NULL;
+    bool ok = false;
+
+    const DvzColor* colors = grid->colors;
+    if (colors == NULL)
+    {
+        default_colors = (DvzColor*)dvz_malloc((DvzSize)count * sizeof(DvzColor));
+        if (default_colors == NULL)
+            goto cleanup;
+        dvz_memset(
+            default_colors, (DvzSize)count * sizeof(DvzColor), 255,
+            (DvzSize)count * sizeof(DvzColor));
+        colors = default_colors;
+    }
+
+    DvzVisualDataUpdate updates[2] = {
+        {.attr_name = "color", .data = colors, .item_count = count},
+    };
+    uint32_t update_count = 1;
+    const vec2* upload_texcoords = grid->texcoords_f32;
+    if (grid->texcoords != NULL)
+    {
+        texcoords = (vec2*)dvz_calloc(count, sizeof(vec2));
+        if (texcoords == NULL)
+            goto cleanup;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            texcoords[i][0] = (float)grid->texcoords[i][0];
+            texcoords[i][1] = (float)grid->texcoords[i][1];
+        }
+        upload_texcoords = texcoords;
+    }
+    if (upload_texcoords != NULL)
+    {
+        updates[update_count++] = (DvzVisualDataUpdate){
+            .attr_name = "texcoords", .data = upload_texcoords, .item_count = count};
+    }
+    if (dvz_visual_set_data_many(visual, updates, update_count) != DVZ_OK)
+        goto cleanup;
+    _scene_mesh_visual_set_default_color(visual, grid->colors == NULL);
+    ok = true;
+
+cleanup:
+    dvz_free(default_colors);
+    dvz_free(texcoords);
+    return ok;
+}
+
+
+
+/**
+ * Create the output vertex buffers and bind them as position and normal attributes.
+ *
+ * @param visual the mesh visual
+ * @param grid the surface grid geometry
+ * @param state the surface state receiving the buffers
+ * @return whether the buffers were created and bound
+ */
+static bool
+_mesh_surface_bind_vertices(DvzVisual* visual, const DvzGeometry* grid, DvzMeshSurfaceState* state)
+{
+    const uint32_t count = grid->vertex_count;
+    const uint64_t byte_size = (uint64_t)count * sizeof(vec3);
+    const uint32_t usage = DVZ_SCENE_BUFFER_USAGE_VERTEX | DVZ_SCENE_BUFFER_USAGE_STORAGE;
+    vec3* data = (vec3*)dvz_calloc(count, sizeof(vec3));
+    if (data == NULL)
+        return false;
+
+    // Seed both buffers with the CPU grid so bounds and the first frame match the geometry.
+    const vec3 zero = {0, 0, 0};
+    const vec3 up = {0, 0, 1};
+    _mesh_surface_copy_vec3(grid, grid->positions, grid->positions_f32, zero, data);
+    state->positions = _mesh_surface_buffer(visual->scene, usage, sizeof(vec3), data, byte_size);
+    _mesh_surface_copy_vec3(grid, grid->normals, grid->normals_f32, up, data);
+    state->normals = _mesh_surface_buffer(visual->scene, usage, sizeof(vec3), data, byte_size);
+    dvz_free(data);
+
+    return state->positions != NULL && state->normals != NULL &&
+           dvz_visual_set_attr_buffer(visual, "position", state->positions, 0, count) ==
+               DVZ_OK &&
+           dvz_visual_set_attr_buffer(visual, "normal", state->normals, 0, count) == DVZ_OK;
+}
+
+
+
+/**
+ * Create the compute pass writing positions and normals from the height mirror.
+ *
+ * @param visual the mesh visual
+ * @param state the surface state with its buffers
+ * @param shader_format compute shader language
+ * @return whether the compute pass was created and bound
+ */
+static bool _mesh_surface_create_compute(
+    DvzVisual* visual, DvzMeshSurfaceState* state, DvzSceneShaderFormat shader_format)
+{
+    DvzSceneComputeDesc desc = dvz_scene_compute_desc();
+    desc.label = "mesh_surface";
+    desc.shader_format = shader_format;
+    desc.shader_source =
+        shader_format == DVZ_SCENE_SHADER_FORMAT_GLSL ? MESH_SURFACE_GLSL : MESH_SURFACE_WGSL;
+    desc.dispatch[0] = (state->cols + DVZ_MESH_SURFACE_WORKGROUP - 1) / DVZ_MESH_SURFACE_WORKGROUP;
+    desc.dispatch[1] = (state->rows + DVZ_MESH_SURFACE_WORKGROUP - 1) / DVZ_MESH_SURFACE_WORKGROUP;
+    state->compute = dvz_scene_compute(visual->scene, &desc);
+    if (state->compute == NULL)
+        return false;
+
+    const DvzSceneComputeAccess read = DVZ_SCENE_COMPUTE_ACCESS_READ;
+    const DvzSceneComputeAccess write = DVZ_SCENE_COMPUTE_ACCESS_READ_WRITE;
+    return dvz_scene_compute_set_buffer(state->compute, 0, state->grid, read, 0, 0) == DVZ_OK &&
+           dvz_scene_compute_set_buffer(state->compute, 1, state->heights, read, 0, 0) ==
+               DVZ_OK &&
+           dvz_scene_compute_set_buffer(state->compute, 2, state->positions, write, 0, 0) ==
+               DVZ_OK &&
+           dvz_scene_compute_set_buffer(state->compute, 3, state->normals, write, 0, 0) ==
+               DVZ_OK;
+}
+
+
+
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+/**
+ * Copy the dirty rows of a height field into the storage mirror of one visual.
+ *
+ * @param visual a mesh visual in surface mode
+ * @param region dirty field region
+ * @param full whether the whole field changed
+ */
+void _scene_mesh_surface_sync_field(DvzVisual* visual, DvzFieldRegion region, bool full)
+{
+    ANN(visual);
+    DvzMeshSurfaceState* state = _mesh_surface_state(visual);
+    DvzSampledField* field = state->field;
+    if (field == NULL || state->heights == NULL)
+        return;
+    if (field->data == NULL || field->desc.width != state->cols ||
+        field->desc.height != state->rows)
+    {
+        log_error(
+            "GPU mesh surface height field no longer matches the %ux%u grid", state->cols,
+            state->rows);
+        return;
+    }
+
+    // Whole rows are cheaper to copy than strided column spans and keep one contiguous range.
+    uint32_t y = full ? 0 : region.y;
+    uint32_t h = full ? state->rows : region.height;
+    if (y >= state->rows || h == 0)
+        return;
+    h = DVZ_MIN(h, state->rows - y);
+    const uint64_t row_size = (uint64_t)state->cols * sizeof(float);
+    const uint64_t offset = (uint64_t)y * row_size;
+    dvz_scene_buffer_update_data(
+        state->heights, offset, (const uint8_t*)field->data + offset, (uint64_t)h * row_size);
+}
+
+
+
+/**
+ * Rewrite the height-field ring origin in the kernel parameter block of one visual.
+ *
+ * @param visual a mesh visual in surface mode
+ */
+void _scene_mesh_surface_sync_ring_origin(DvzVisual* visual)
+{
+    ANN(visual);
+    DvzMeshSurfaceState* state = _mesh_surface_state(visual);
+    if (state->field == NULL || state->grid == NULL)
+        return;
+
+    // The grid buffer stride is one vec4, so the whole extent word is rewritten.
+    const uint32_t extent[4] = {
+        state->rows, state->cols, state->field->ring_origin[1], state->field->ring_origin[0]};
+    if (dvz_scene_buffer_update_data(
+            state->grid, offsetof(DvzMeshSurfaceGrid, extent), extent, sizeof(extent)) != DVZ_OK)
+    {
+        log_error("failed to update the ring origin of a GPU mesh surface");
+    }
+}
+
+
+
+/**
+ * Detach a height field that is being destroyed, keeping the last uploaded heights.
+ *
+ * @param visual a mesh visual in surface mode
+ */
+void _scene_mesh_surface_forget_field(DvzVisual* visual)
+{
+    ANN(visual);
+    _mesh_surface_state(visual)->field = NULL;
+}
+
+
+
+/**
+ * Leave GPU surface mode.
+ *
+ * @param visual the mesh visual
+ * @param release_owned_resources whether the owned compute pass and buffers are destroyed
+ */
+void _scene_mesh_surface_release(DvzVisual* visual, bool release_owned_resources)
+{
+    ANN(visual);
+    DvzMeshSurfaceState* state = _mesh_surface_state(visual);
+    if (release_owned_resources)
+    {
+        if (state->compute != NULL)
+            dvz_scene_compute_destroy(state->compute);
+        DvzSceneBuffer* buffers[] = {state->grid, state->heights, state->positions,
+                                     state->normals};
+        for (uint32_t i = 0; i < DVZ_ARRAY_COUNT(buffers); i++)
+        {
+            if (buffers[i] != NULL)
+                dvz_scene_buffer_destroy(buffers[i]);
+        }
+    }
+    dvz_memset(state, sizeof(*state), 0, sizeof(*state));
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Drive a mesh visual from a surface grid whose heights live in a sampled field.
+ *
+ * @param visual the mesh visual
+ * @param grid the surface grid geometry providing the grid layout, colors, and texcoords
+ * @param heights the 2D R32_FLOAT height field
+ * @param shader_format the compute shader language matching the runtime backend
+ * @return the owned compute pass, or NULL on invalid input
+ */
+DvzSceneCompute* dvz_mesh_set_surface_field(
+    DvzVisual* visual, const DvzGeometry* grid, DvzSampledField* heights,
+    DvzSceneShaderFormat shader_format)
+{
+    if (visual == NULL || visual->type != DVZ_VISUAL_TYPE_MESH)
+    {
+        log_error("GPU mesh surfaces require a mesh visual");
+        return NULL;
+    }
+    if (
+        !_mesh_surface_grid_valid(grid) ||
+        !_mesh_surface_field_valid(visual, heights, grid->grid_rows, grid->grid_cols))
+    {
+        return NULL;
+    }
+    if (
+        shader_format != DVZ_SCENE_SHADER_FORMAT_WGSL &&
+        shader_format != DVZ_SCENE_SHADER_FORMAT_GLSL)
+    {
+        log_error("unsupported GPU mesh surface shader format %d", (int)shader_format);
+        return NULL;
+    }
+
+    _scene_mesh_surface_release(visual, true);
+    DvzMeshSurfaceState* state = _mesh_surface_state(visual);
+    state->rows = grid->grid_rows;
+    state->cols = grid->grid_cols;
+
+    // Vertex counts change across grids: clear every per-vertex attribute before rebinding.
+    _mesh_surface_drop_dense_attr(visual, "position");
+    _mesh_surface_drop_dense_attr(visual, "normal");
+    _mesh_surface_drop_dense_attr(visual, "color");
+    _mesh_surface_drop_dense_attr(visual, "texcoords");
+
+    DvzMeshSurfaceGrid params = {0};
+    _mesh_surface_grid_params(grid, heights, &params);
+    state->grid = _mesh_surface_buffer(
+        visual->scene, DVZ_SCENE_BUFFER_USAGE_STORAGE, sizeof(params.origin), &params,
+        sizeof(params));
+    if (state->grid == NULL)
+        goto error;
+
+    const uint64_t heights_size = (uint64_t)grid->vertex_count * sizeof(float);
+    float* zeros = NULL;
+    const void* initial = heights->data;
+    if (initial == NULL)
+    {
+        zeros = (float*)dvz_calloc(grid->vertex_count, sizeof(float));
+        if (zeros == NULL)
+            goto error;
+        initial = zeros;
+    }
+    state->heights = _mesh_surface_buffer(
+        visual->scene, DVZ_SCENE_BUFFER_USAGE_STORAGE, sizeof(float), initial, heights_size);
+    dvz_free(zeros);
+    if (state->heights == NULL)
+        goto error;
+
+    if (
+        !_mesh_surface_bind_vertices(visual, grid, state) ||
+        !_mesh_surface_set_dense_attrs(visual, grid) ||
+        !_mesh_surface_bind_indices(visual, grid) ||
+        !_mesh_surface_create_compute(visual, state, shader_format))
+    {
+        goto error;
+    }
+
+    state->field = heights;
+    _scene_notify_visual_changed(visual);
+    return state->compute;
+
+error:
+    log_error("could not set up the GPU mesh surface");
+    _scene_mesh_surface_release(visual, true);
+    _scene_notify_visual_changed(visual);
+    return NULL;
+}
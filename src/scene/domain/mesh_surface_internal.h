@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Mesh GPU surface internals                                                                   */
+/*************************************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+
+#include "_scene.h"
+
+void _scene_mesh_surface_sync_field(DvzVisual* visual, DvzFieldRegion region, bool full);
+
+void _scene_mesh_surface_sync_ring_origin(DvzVisual* visual);
+
+void _scene_mesh_surface_forget_field(DvzVisual* visual);
+
+void _scene_mesh_surface_release(DvzVisual* visual, bool release_owned_resources);
@@ -64,7 +64,9 @@ static bool _composition_ensure_capacity(DvzFramePlan* plan, uint32_t count)
     if (_dvz_mul_u64_overflows(capacity, sizeof(DvzPanelCompositionSnapshot), &bytes))
         return false;
     DvzPanelCompositionSnapshot* snapshots =
-        (DvzPanelCompositionSnapshot*)dvz_realloc(plan->compositions, bytes);
+        (DvzPanelCompositionSnapshot*)_frame_plan_realloc(
+        plan, plan->compositions,
+        (uint64_t)plan->composition_capacity * sizeof(DvzPanelCompositionSnapshot), bytes);
     if (snapshots == NULL)
         return false;
     plan->compositions = snapshots;
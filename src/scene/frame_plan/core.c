@@ -51,6 +51,61 @@ void _frame_plan_copy_label(char* dst, uint64_t dst_size, const char* src)
 
 
 
+/**
+ * Allocate zero-initialized FramePlan storage, from the plan arena when it has one.
+ *
+ * @param plan the FramePlan
+ * @param count item count
+ * @param size item byte size
+ * @return the allocation, or NULL on failure
+ */
+void* _frame_plan_calloc(const DvzFramePlan* plan, uint64_t count, uint64_t size)
+{
+    ANN(plan);
+    if (plan->arena != NULL)
+        return dvz_arena_calloc(plan->arena, count, size);
+    return dvz_calloc(count, size);
+}
+
+
+
+/**
+ * Grow FramePlan storage, from the plan arena when it has one.
+ *
+ * Bytes added by the heap path are left uninitialized, as with dvz_realloc().
+ *
+ * @param plan the FramePlan
+ * @param pointer the current allocation, or NULL
+ * @param old_size current byte size
+ * @param new_size requested byte size
+ * @return the grown allocation, or NULL on failure (the original allocation is left intact)
+ */
+void* _frame_plan_realloc(
+    const DvzFramePlan* plan, void* pointer, uint64_t old_size, uint64_t new_size)
+{
+    ANN(plan);
+    if (plan->arena != NULL)
+        return dvz_arena_grow(plan->arena, pointer, old_size, new_size);
+    return dvz_realloc(pointer, new_size);
+}
+
+
+
+/**
+ * Release FramePlan storage; arena storage is released by the next arena reset instead.
+ *
+ * @param plan the FramePlan
+ * @param pointer the allocation, or NULL
+ */
+void _frame_plan_free(const DvzFramePlan* plan, void* pointer)
+{
+    ANN(plan);
+    if (plan->arena == NULL)
+        dvz_free(pointer);
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -64,16 +119,39 @@ void _frame_plan_copy_label(char* dst, uint64_t dst_size, const char* src)
  */
 DvzFramePlan* dvz_frame_plan(const char* figure_id, uint64_t frame_index)
 {
-    DvzFramePlan* plan = (DvzFramePlan*)dvz_calloc(1, sizeof(DvzFramePlan));
+    return dvz_frame_plan_in_arena(figure_id, frame_index, NULL);
+}
+
+
+
+/**
+ * Create an empty FramePlan whose storage is allocated from an arena.
+ *
+ * The plan, its nodes and its arrays stay valid until the arena is reset; destroying the plan
+ * releases nothing. Data that must outlive the arena cycle has to be copied out of the plan.
+ *
+ * @param figure_id the figure id
+ * @param frame_index the frame index
+ * @param arena the arena, or NULL to allocate on the heap
+ * @return the FramePlan
+ */
+DvzFramePlan*
+dvz_frame_plan_in_arena(const char* figure_id, uint64_t frame_index, DvzArena* arena)
+{
+    DvzFramePlan* plan = arena != NULL
+                             ? (DvzFramePlan*)dvz_arena_calloc(arena, 1, sizeof(DvzFramePlan))
+                             : (DvzFramePlan*)dvz_calloc(1, sizeof(DvzFramePlan));
     if (plan == NULL)
         return NULL;
+    plan->arena = arena;
     _frame_plan_copy_label(plan->figure_id, DVZ_SCENE_LABEL_SIZE, figure_id ? figure_id : "");
     plan->frame_index = frame_index;
     plan->capacity = DVZ_FRAME_PLAN_INITIAL_NODE_CAPACITY;
-    plan->nodes = (DvzFramePlanNode*)dvz_calloc(plan->capacity, sizeof(DvzFramePlanNode));
+    plan->nodes =
+        (DvzFramePlanNode*)_frame_plan_calloc(plan, plan->capacity, sizeof(DvzFramePlanNode));
     if (plan->nodes == NULL)
     {
-        dvz_free(plan);
+        _frame_plan_free(plan, plan);
         return NULL;
     }
     return plan;
@@ -90,6 +168,8 @@ void dvz_frame_plan_destroy(DvzFramePlan* plan)
 {
     if (plan == NULL)
         return;
+    if (plan->arena != NULL)
+        return; // everything is released by the next arena reset
     for (uint32_t i = 0; i < plan->count; i++)
     {
         if (plan->nodes[i].type == DVZ_FRAME_PLAN_NODE_UPLOAD)
@@ -47,7 +47,11 @@
 #define DRP2_MAX_FIXTURE_RESOURCES 64
 #define DRP2_RUNTIME_TRANSIENT_ID_BASE 10000
 #define DRP2_EMITTER_OBJECT_ID_BASE 5000
-#define DVZ_SCENE_COMMON_CACHE_CAPACITY (2 * DVZ_SCENE_MAX_PANELS)
+#define DVZ_SCENE_COMMON_MIN_SLOTS 64
+#define DVZ_SCENE_COMMON_RING_MAX_REGIONS 8
+#define DVZ_SCENE_COMMON_KEY_MIN_CAPACITY 64
+#define DVZ_SCENE_COMMON_UNIFORM_ALIGNMENT 256 /* largest minUniformBufferOffsetAlignment */
+#define DVZ_SCENE_COMMON_RING_KEY "_common_uniform_ring"
 #define DVZ_SCENE_VOLUME_CACHE_CAPACITY DVZ_SCENE_MAX_VISUALS
 #define DVZ_SCENE_LABELS_CACHE_CAPACITY DVZ_SCENE_MAX_VISUALS
 #define DVZ_SCENE_LABELS_HIDDEN_VEC4_COUNT ((DVZ_LABELS_MAX_HIDDEN + 3u) / 4u)
@@ -65,6 +69,9 @@ typedef struct ConverterState ConverterState;
 typedef struct SceneRenderStateCache SceneRenderStateCache;
 typedef struct DvzSceneLabelsUniform DvzSceneLabelsUniform;
 typedef struct DvzSceneVolumeUniform DvzSceneVolumeUniform;
+typedef struct DvzSceneCommonUniform DvzSceneCommonUniform;
+typedef struct DvzSceneCommonRegion DvzSceneCommonRegion;
+typedef struct DvzSceneCommonRing DvzSceneCommonRing;
 
 struct DvzSceneLabelsUniform
 {
@@ -91,6 +98,47 @@ struct DvzSceneVolumeUniform
     float value_range[4];
     float occlusion[4];
     float texture_params[4];
+    float ring_origin[4]; /* normalized field ring origin xyz, reserved */
+};
+
+/* One common uniform ring slot: each binding starts on a dynamic-offset alignment boundary. */
+struct DvzSceneCommonUniform
+{
+    DvzMVP mvp;
+    uint8_t mvp_padding[DVZ_SCENE_COMMON_UNIFORM_ALIGNMENT - sizeof(DvzMVP)];
+    DvzSceneViewportUniform viewport;
+    uint8_t
+        viewport_padding[DVZ_SCENE_COMMON_UNIFORM_ALIGNMENT - sizeof(DvzSceneViewportUniform)];
+};
+
+/* Ring region of one frame-slot scope: the CPU mirror of one growable uniform buffer bound by
+   one bind group. A frame only writes its own region, so it never rewrites slots that another
+   frame in flight still reads. Slots whose contents changed since the last flush,
+   [dirty_begin, dirty_end), are uploaded by one WriteBuffer. */
+struct DvzSceneCommonRegion
+{
+    uint64_t scope;      /* runtime resource scope of the frames using this region */
+    uint64_t last_frame; /* ring frame that last used this region, for reuse */
+    uint32_t capacity;   /* mirrored slots, doubled when a frame needs more */
+    uint32_t synced;     /* leading slots whose uploaded copy matches the mirror */
+    uint32_t dirty_begin;
+    uint32_t dirty_end;
+    DvzSceneCommonUniform* slots;
+};
+
+/* Common uniform ring: a bump allocator over the slots of the current region, reset at the
+   start of every frame, with a hashed index from common-set keys to the slots of this frame. */
+struct DvzSceneCommonRing
+{
+    DvzSceneCommonRegion regions[DVZ_SCENE_COMMON_RING_MAX_REGIONS];
+    uint32_t region_count;
+    uint32_t region; /* region of the current frame */
+    uint64_t frame;  /* frames begun so far */
+    uint32_t count;  /* slots allocated in the current frame */
+    uint32_t key_capacity;
+    char (*keys)[DVZ_SCENE_LABEL_SIZE];
+    uint32_t index_capacity; /* power of two, twice key_capacity */
+    uint32_t* index;         /* open-addressed key index: slot + 1, or 0 when empty */
 };
 
 struct ResourceId
@@ -113,6 +161,7 @@ struct ResourceId
     DvzFramePlanResourceKind kind;        /* typed resource kind, when supplied by FramePlan   */
     DvzFramePlanResourceRole role;        /* typed resource role, when supplied by FramePlan   */
     DvzColorRole color_role;              /* texture color role, when supplied by FramePlan    */
+    uint64_t payload_version;             /* bumped by every upload, declared on its write     */
 };
 
 
@@ -136,6 +185,7 @@ struct SceneRenderStateCache
 {
     uint64_t pipeline_id;
     uint64_t bg_set0;
+    uint64_t set0_offset;
 };
 
 
@@ -149,19 +199,22 @@ struct DvzFramePlanEmitter
     uint32_t max_color_sample_count;
     uint32_t max_depth_sample_count;
 
-    /* Common cache: APPLY and FIXED slots are panel-specific once viewport is part of set 0. */
-    char mvp_panel_ids[DVZ_SCENE_COMMON_CACHE_CAPACITY][DVZ_SCENE_LABEL_SIZE];
-    DvzMVP mvp_cache[DVZ_SCENE_COMMON_CACHE_CAPACITY];
-    uint32_t mvp_panel_count;
-    char viewport_panel_ids[DVZ_SCENE_COMMON_CACHE_CAPACITY][DVZ_SCENE_LABEL_SIZE];
-    DvzSceneViewportUniform viewport_cache[DVZ_SCENE_COMMON_CACHE_CAPACITY];
-    uint32_t viewport_panel_count;
+    /* Common ring: one slot per panel/visual common set per frame, bound with a dynamic
+       offset. */
+    DvzSceneCommonRing common;
     char volume_ids[DVZ_SCENE_VOLUME_CACHE_CAPACITY][DVZ_SCENE_LABEL_SIZE];
     DvzSceneVolumeUniform volume_cache[DVZ_SCENE_VOLUME_CACHE_CAPACITY];
     uint32_t volume_count;
     char labels_ids[DVZ_SCENE_LABELS_CACHE_CAPACITY][DVZ_SCENE_LABEL_SIZE];
     DvzSceneLabelsUniform labels_cache[DVZ_SCENE_LABELS_CACHE_CAPACITY];
     uint32_t labels_count;
+    /* Bumped whenever a cached uniform changes content; declared as the payload version of
+       uniform writes so that unchanged frames fingerprint equally without hashing payloads. */
+    uint64_t uniform_version;
+
+    /* Object key of the buffer receiving readback copies; empty selects "_rb". Pipelined queries
+       rotate it so a copy never lands in a buffer whose download is still pending. */
+    char readback_key[DVZ_SCENE_LABEL_SIZE];
 };
 
 
@@ -184,10 +237,13 @@ void _emitter_state_discard(DvzFramePlanEmitter* candidate);
 
 uint64_t _emitter_next_transient_id(DvzFramePlanEmitter* emitter);
 
-DvzMVP* _emitter_mvp_slot(DvzFramePlanEmitter* emitter, const char* key);
+void _emitter_common_begin_frame(DvzFramePlanEmitter* emitter, uint64_t scope);
+
+DvzSceneCommonUniform*
+_emitter_common_slot(DvzFramePlanEmitter* emitter, const char* key, uint32_t* out_index);
 
-DvzSceneViewportUniform*
-_emitter_viewport_slot(DvzFramePlanEmitter* emitter, const char* key);
+void _emitter_common_store(
+    DvzFramePlanEmitter* emitter, uint32_t index, const DvzSceneCommonUniform* value);
 
 DvzSceneVolumeUniform*
 _emitter_volume_slot(DvzFramePlanEmitter* emitter, const char* key);
@@ -195,6 +251,13 @@ _emitter_volume_slot(DvzFramePlanEmitter* emitter, const char* key);
 DvzSceneLabelsUniform*
 _emitter_labels_slot(DvzFramePlanEmitter* emitter, const char* key);
 
+uint64_t _emitter_uniform_store(
+    DvzFramePlanEmitter* emitter, void* slot, const void* value, uint64_t size);
+
+void _emitter_set_readback_key(DvzFramePlanEmitter* emitter, const char* key);
+
+const char* _emitter_readback_key(const DvzFramePlanEmitter* emitter);
+
 uint64_t _resource_id(ConverterState* state, const char* key);
 
 uint64_t _resource_lookup_id(const ConverterState* state, const char* key);
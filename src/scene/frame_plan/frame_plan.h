@@ -16,6 +16,7 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include "arena.h"
 #include "datoviz/scene.h"
 
 
@@ -745,10 +746,29 @@ typedef struct DvzFrameGraphResource
     char extent_resource_id[DVZ_SCENE_LABEL_SIZE];
     uint32_t usage_flags;
     DvzFrameGraphResourceLifetime lifetime;
+
+    /* Set by dvz_frame_plan_graph_alias(): per-frame textures with disjoint pass lifetimes and
+       one descriptor share a 1-based alias slot, and thus one runtime texture. */
+    uint32_t alias_slot;        /* 0 when the resource owns its texture */
+    uint32_t alias_usage_flags; /* union of the usage flags of the slot members */
+    bool transient;             /* only ever an attachment: contents never leave the frame */
 } DvzFrameGraphResource;
 
 
 
+typedef struct DvzFrameGraphAliasStats
+{
+    uint32_t texture_count;   /* per-frame textures considered for aliasing */
+    uint32_t aliased_count;   /* textures sharing an alias slot with another one */
+    uint32_t slot_count;      /* alias slots shared by two textures or more */
+    uint32_t transient_count; /* textures only used as attachments */
+    uint64_t bytes;           /* estimated texture memory without aliasing */
+    uint64_t aliased_bytes;   /* estimated texture memory with aliasing */
+    uint64_t transient_bytes; /* part of aliased_bytes that may be lazily allocated */
+} DvzFrameGraphAliasStats;
+
+
+
 typedef struct DvzRenderProductContract
 {
     DvzRenderProductId id;
@@ -950,6 +970,7 @@ typedef struct DvzFramePlanVisualMeta
     uint32_t field_width;
     uint32_t field_height;
     uint32_t field_depth;
+    float field_ring_origin[4];
     uint32_t scale_index;
     bool volume_transfer_rgba;
     DvzColorRole volume_color_role;
@@ -1172,6 +1193,7 @@ struct DvzFramePlan
     DvzSceneGraphRealization* realizations;
     uint32_t retirement_count;
     DvzFramePlanRetirement retirements[DVZ_FRAME_PLAN_MAX_RETIREMENTS];
+    DvzArena* arena; // storage of the plan and its arrays, NULL when they live on the heap
 };
 
 
@@ -1180,6 +1202,16 @@ struct DvzFramePlan
 /*  Internal helpers                                                                            */
 /*************************************************************************************************/
 
+DvzFramePlan*
+dvz_frame_plan_in_arena(const char* figure_id, uint64_t frame_index, DvzArena* arena);
+
+void* _frame_plan_calloc(const DvzFramePlan* plan, uint64_t count, uint64_t size);
+
+void* _frame_plan_realloc(
+    const DvzFramePlan* plan, void* pointer, uint64_t old_size, uint64_t new_size);
+
+void _frame_plan_free(const DvzFramePlan* plan, void* pointer);
+
 DvzFramePlanRenderPassRole _frame_plan_render_pass_role(const DvzFramePlanNode* node);
 
 bool dvz_frame_plan_render_panel(
@@ -1238,6 +1270,11 @@ bool dvz_frame_graph_pass_depth_attachment(
 
 bool dvz_frame_plan_graph_validate(const DvzFramePlan* plan, DvzDiagnosticReport* report);
 
+bool dvz_frame_plan_graph_alias(DvzFramePlan* plan);
+
+DvzFrameGraphAliasStats
+dvz_frame_plan_graph_alias_stats(const DvzFramePlan* plan, uint32_t width, uint32_t height);
+
 bool dvz_frame_plan_product(DvzFramePlan* plan, const DvzRenderProductContract* product);
 
 bool dvz_frame_plan_product_consumer(
@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Scene FramePlan graph aliasing                                                               */
+/*************************************************************************************************/
+
+/*
+ * Per-frame textures only hold data between their first and last graph pass. Two of them whose
+ * pass intervals do not overlap, and which share one descriptor, can therefore be backed by one
+ * runtime texture. Graph passes are emitted in declaration order, so the pass index is the
+ * timeline used by the lifetime analysis.
+ */
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "_alloc.h"
+#include "_assertions.h"
+#include "frame_plan/internal.h"
+#include "internal.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define GRAPH_ALIAS_ATTACHMENT_USAGE                                                              \
+    ((uint32_t)(DVZ_FRAME_GRAPH_RESOURCE_USAGE_COLOR_ATTACHMENT |                                 \
+                DVZ_FRAME_GRAPH_RESOURCE_USAGE_DEPTH_ATTACHMENT))
+
+#define GRAPH_ALIAS_MAX_EXTENT_DEPTH 8 /* RESOURCE_REF chain length followed by the statistics */
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct GraphAliasLifetime GraphAliasLifetime;
+
+struct GraphAliasLifetime
+{
+    bool touched;
+    bool first_attachment; // the first pass touches the texture as a render attachment
+    bool first_reads;      // the first pass also reads the previous texture contents
+    bool external;         // copy or readback nodes use the texture outside the pass graph
+    uint32_t first;
+    uint32_t last;
+    uint32_t usage; // resource usage flags, including the ones implied by pass accesses
+    uint32_t slot;  // 0-based candidate slot, UINT32_MAX when not aliasable
+};
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Record one pass access to a resource.
+ *
+ * @param plan the FramePlan
+ * @param lifetimes per-resource lifetimes
+ * @param resource_id graph resource id
+ * @param pass_index graph pass index
+ * @param usage resource usage flag implied by the access
+ * @param attachment whether the access is a render attachment
+ * @param reads whether the access reads the texture contents
+ */
+static void _graph_alias_touch(
+    const DvzFramePlan* plan, GraphAliasLifetime* lifetimes, const char* resource_id,
+    uint32_t pass_index, uint32_t usage, bool attachment, bool reads)
+{
+    uint32_t index = 0;
+    if (!_frame_plan_graph_resource_index(plan, resource_id, &index))
+        return;
+    GraphAliasLifetime* lifetime = &lifetimes[index];
+    if (!lifetime->touched)
+    {
+        lifetime->touched = true;
+        lifetime->first = pass_index;
+        lifetime->first_attachment = attachment;
+    }
+    if (pass_index == lifetime->first)
+    {
+        lifetime->first_attachment = lifetime->first_attachment && attachment;
+        lifetime->first_reads = lifetime->first_reads || reads;
+    }
+    lifetime->last = pass_index;
+    lifetime->usage |= usage;
+}
+
+
+
+/**
+ * Record every resource access of one graph pass.
+ *
+ * @param plan the FramePlan
+ * @param lifetimes per-resource lifetimes
+ * @param pass_index graph pass index
+ */
+static void _graph_alias_touch_pass(
+    const DvzFramePlan* plan, GraphAliasLifetime* lifetimes, uint32_t pass_index)
+{
+    const DvzFrameGraphPass* pass = &plan->graph_passes[pass_index];
+    for (uint32_t i = 0; i < pass->read_count; i++)
+        _graph_alias_touch(
+            plan, lifetimes, pass->reads[i].resource_id, pass_index,
+            _frame_plan_graph_usage_flag(pass->reads[i].usage), false, true);
+    for (uint32_t i = 0; i < pass->write_count; i++)
+        _graph_alias_touch(
+            plan, lifetimes, pass->writes[i].resource_id, pass_index,
+            _frame_plan_graph_usage_flag(pass->writes[i].usage), false,
+            _frame_plan_graph_access_reads(pass->writes[i].usage));
+    for (uint32_t i = 0; i < pass->color_attachment_count; i++)
+    {
+        const DvzFrameGraphAttachment* attachment = &pass->color_attachments[i];
+        _graph_alias_touch(
+            plan, lifetimes, attachment->resource_id, pass_index,
+            DVZ_FRAME_GRAPH_RESOURCE_USAGE_COLOR_ATTACHMENT, true,
+            _frame_plan_graph_attachment_reads(attachment));
+        if (attachment->resolve_resource_id[0] != '\0')
+            _graph_alias_touch(
+                plan, lifetimes, attachment->resolve_resource_id, pass_index,
+                DVZ_FRAME_GRAPH_RESOURCE_USAGE_COLOR_ATTACHMENT, true, false);
+    }
+    if (pass->has_depth_attachment)
+        _graph_alias_touch(
+            plan, lifetimes, pass->depth_attachment.resource_id, pass_index,
+            DVZ_FRAME_GRAPH_RESOURCE_USAGE_DEPTH_ATTACHMENT, true,
+            _frame_plan_graph_attachment_reads(&pass->depth_attachment));
+    if (pass->has_stencil_attachment)
+        _graph_alias_touch(
+            plan, lifetimes, pass->stencil_attachment.resource_id, pass_index,
+            DVZ_FRAME_GRAPH_RESOURCE_USAGE_DEPTH_ATTACHMENT, true,
+            _frame_plan_graph_attachment_reads(&pass->stencil_attachment));
+}
+
+
+
+/**
+ * Mark the resources used by copy and readback nodes, which run outside the pass timeline.
+ *
+ * @param plan the FramePlan
+ * @param lifetimes per-resource lifetimes
+ */
+static void _graph_alias_mark_external(const DvzFramePlan* plan, GraphAliasLifetime* lifetimes)
+{
+    for (uint32_t i = 0; i < plan->count; i++)
+    {
+        const DvzFramePlanNode* node = &plan->nodes[i];
+        const char* ids[2] = {NULL, NULL};
+        if (node->type == DVZ_FRAME_PLAN_NODE_COPY)
+        {
+            ids[0] = node->u.copy.src_resource_id;
+            ids[1] = node->u.copy.dst_resource_id;
+        }
+        else if (node->type == DVZ_FRAME_PLAN_NODE_READBACK)
+        {
+            ids[0] = node->u.readback.resource_id;
+        }
+        for (uint32_t j = 0; j < 2; j++)
+        {
+            uint32_t index = 0;
+            if (ids[j] != NULL && _frame_plan_graph_resource_index(plan, ids[j], &index))
+                lifetimes[index].external = true;
+        }
+    }
+}
+
+
+
+/**
+ * Return whether a graph resource takes part in the lifetime analysis.
+ *
+ * @param resource graph resource descriptor
+ * @return whether the resource is a per-frame texture
+ */
+static bool _graph_alias_candidate(const DvzFrameGraphResource* resource)
+{
+    return resource->kind == DVZ_FRAME_GRAPH_RESOURCE_TEXTURE &&
+           resource->lifetime == DVZ_FRAME_GRAPH_RESOURCE_LIFETIME_PER_FRAME &&
+           resource->extent_kind != DVZ_FRAME_GRAPH_EXTENT_NONE;
+}
+
+
+
+/**
+ * Return whether two per-frame textures can be backed by the same runtime texture.
+ *
+ * A zero format is resolved by the runtime from the attachment kind, so the attachment usages
+ * must match as well.
+ *
+ * @param a first graph resource descriptor
+ * @param b second graph resource descriptor
+ * @param a_usage usage flags of the first resource
+ * @param b_usage usage flags of the second resource
+ * @return whether the descriptors are interchangeable
+ */
+static bool _graph_alias_compatible(
+    const DvzFrameGraphResource* a, const DvzFrameGraphResource* b, uint32_t a_usage,
+    uint32_t b_usage)
+{
+    return a->format == b->format &&
+           _frame_plan_graph_resource_sample_count(a) ==
+               _frame_plan_graph_resource_sample_count(b) &&
+           (a_usage & GRAPH_ALIAS_ATTACHMENT_USAGE) == (b_usage & GRAPH_ALIAS_ATTACHMENT_USAGE) &&
+           _frame_plan_graph_resource_extent_matches(a, b);
+}
+
+
+
+/**
+ * Return the byte size of one texel of a graph texture format.
+ *
+ * @param format texture format token, zero meaning the 4-byte scene color format
+ * @return texel byte size, an estimate of 4 bytes for unlisted formats
+ */
+static uint32_t _graph_alias_texel_bytes(uint32_t format)
+{
+    switch ((DvzFormat)format)
+    {
+    case DVZ_FORMAT_R8_UNORM:
+    case DVZ_FORMAT_R8_UINT:
+        return 1;
+    case DVZ_FORMAT_R16_SFLOAT:
+    case DVZ_FORMAT_R16_UINT:
+        return 2;
+    case DVZ_FORMAT_R32G32_SFLOAT:
+    case DVZ_FORMAT_R32G32_UINT:
+    case DVZ_FORMAT_R16G16B16A16_SFLOAT:
+    case DVZ_FORMAT_R16G16B16A16_UNORM:
+        return 8;
+    case DVZ_FORMAT_R32G32B32A32_SFLOAT:
+    case DVZ_FORMAT_R32G32B32A32_UINT:
+        return 16;
+    default:
+        return 4;
+    }
+}
+
+
+
+/**
+ * Estimate the memory of one graph texture.
+ *
+ * @param plan the FramePlan
+ * @param resource graph resource descriptor
+ * @param width figure-extent width
+ * @param height figure-extent height
+ * @return texture byte size, or zero when the extent does not resolve
+ */
+static uint64_t _graph_alias_texture_bytes(
+    const DvzFramePlan* plan, const DvzFrameGraphResource* resource, uint32_t width,
+    uint32_t height)
+{
+    const DvzFrameGraphResource* extent = resource;
+    for (uint32_t i = 0; extent != NULL && i < GRAPH_ALIAS_MAX_EXTENT_DEPTH; i++)
+    {
+        if (extent->extent_kind != DVZ_FRAME_GRAPH_EXTENT_RESOURCE_REF)
+            break;
+        uint32_t index = 0;
+        extent = _frame_plan_graph_resource_index(plan, extent->extent_resource_id, &index)
+                     ? &plan->graph_resources[index]
+                     : NULL;
+    }
+    if (extent == NULL)
+        return 0;
+
+    uint64_t w = extent->width, h = extent->height;
+    if (extent->extent_kind == DVZ_FRAME_GRAPH_EXTENT_FIGURE)
+    {
+        w = width;
+        h = height;
+    }
+    else if (
+        extent->extent_kind != DVZ_FRAME_GRAPH_EXTENT_PANEL &&
+        extent->extent_kind != DVZ_FRAME_GRAPH_EXTENT_FIXED)
+    {
+        return 0;
+    }
+    return w * h * _graph_alias_texel_bytes(resource->format) *
+           _frame_plan_graph_resource_sample_count(resource);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Assign alias slots and transient flags to the per-frame textures of a FramePlan.
+ *
+ * A texture is aliased only when its first pass overwrites it as an attachment without loading
+ * it, and when no copy or readback node uses it; slots are filled first-fit in pass order. A
+ * texture whose usages, over all its slot members, are render attachments only is transient.
+ *
+ * @param plan the FramePlan
+ * @return whether the analysis ran; on failure no texture is aliased
+ */
+bool dvz_frame_plan_graph_alias(DvzFramePlan* plan)
+{
+    ANN(plan);
+    uint32_t count = plan->graph_resource_count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        plan->graph_resources[i].alias_slot = 0;
+        plan->graph_resources[i].alias_usage_flags = 0;
+        plan->graph_resources[i].transient = false;
+    }
+    if (count == 0)
+        return true;
+
+    GraphAliasLifetime* lifetimes =
+        (GraphAliasLifetime*)_frame_plan_calloc(plan, count, sizeof(GraphAliasLifetime));
+    // Slot i is represented by its first member, lifetimes[heads[i]], and ends at tails[i].
+    uint32_t* heads = (uint32_t*)_frame_plan_calloc(plan, count, sizeof(uint32_t));
+    uint32_t* tails = (uint32_t*)_frame_plan_calloc(plan, count, sizeof(uint32_t));
+    uint32_t* sizes = (uint32_t*)_frame_plan_calloc(plan, count, sizeof(uint32_t));
+    uint32_t* usages = (uint32_t*)_frame_plan_calloc(plan, count, sizeof(uint32_t));
+    if (lifetimes == NULL || heads == NULL || tails == NULL || sizes == NULL || usages == NULL)
+    {
+        _frame_plan_free(plan, lifetimes);
+        _frame_plan_free(plan, heads);
+        _frame_plan_free(plan, tails);
+        _frame_plan_free(plan, sizes);
+        _frame_plan_free(plan, usages);
+        return false;
+    }
+
+    for (uint32_t p = 0; p < plan->graph_pass_count; p++)
+        _graph_alias_touch_pass(plan, lifetimes, p);
+    _graph_alias_mark_external(plan, lifetimes);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        lifetimes[i].usage |= plan->graph_resources[i].usage_flags;
+        lifetimes[i].slot = UINT32_MAX;
+    }
+
+    // First-fit slot assignment, visiting the textures by increasing first pass.
+    uint32_t slot_count = 0;
+    for (uint32_t p = 0; p < plan->graph_pass_count; p++)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            GraphAliasLifetime* lifetime = &lifetimes[i];
+            const DvzFrameGraphResource* resource = &plan->graph_resources[i];
+            if (!lifetime->touched || lifetime->first != p || !_graph_alias_candidate(resource) ||
+                !lifetime->first_attachment || lifetime->first_reads || lifetime->external)
+                continue;
+
+            uint32_t slot = 0;
+            while (slot < slot_count &&
+                   (tails[slot] >= lifetime->first ||
+                    !_graph_alias_compatible(
+                        &plan->graph_resources[heads[slot]], resource,
+                        lifetimes[heads[slot]].usage, lifetime->usage)))
+                slot++;
+            if (slot == slot_count)
+                heads[slot_count++] = i;
+            tails[slot] = lifetime->last;
+            sizes[slot]++;
+            usages[slot] |= lifetime->usage;
+            lifetime->slot = slot;
+        }
+    }
+
+    // Only slots shared by two textures or more are published, numbered from 1.
+    uint32_t published = 0;
+    for (uint32_t slot = 0; slot < slot_count; slot++)
+        heads[slot] = sizes[slot] >= 2 ? ++published : 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        DvzFrameGraphResource* resource = &plan->graph_resources[i];
+        const GraphAliasLifetime* lifetime = &lifetimes[i];
+        if (!_graph_alias_candidate(resource) || !lifetime->touched)
+            continue;
+        uint32_t usage = lifetime->usage;
+        if (lifetime->slot != UINT32_MAX && heads[lifetime->slot] != 0)
+        {
+            usage = usages[lifetime->slot];
+            resource->alias_slot = heads[lifetime->slot];
+            resource->alias_usage_flags = usage;
+        }
+        resource->transient = !lifetime->external && (usage & ~GRAPH_ALIAS_ATTACHMENT_USAGE) == 0;
+    }
+
+    _frame_plan_free(plan, lifetimes);
+    _frame_plan_free(plan, heads);
+    _frame_plan_free(plan, tails);
+    _frame_plan_free(plan, sizes);
+    _frame_plan_free(plan, usages);
+    return true;
+}
+
+
+
+/**
+ * Estimate the per-frame texture memory of a FramePlan, before and after aliasing.
+ *
+ * @param plan the FramePlan, after dvz_frame_plan_graph_alias()
+ * @param width width of figure-extent textures
+ * @param height height of figure-extent textures
+ * @return the aliasing statistics
+ */
+DvzFrameGraphAliasStats
+dvz_frame_plan_graph_alias_stats(const DvzFramePlan* plan, uint32_t width, uint32_t height)
+{
+    DvzFrameGraphAliasStats stats = {0};
+    if (plan == NULL)
+        return stats;
+    for (uint32_t i = 0; i < plan->graph_resource_count; i++)
+    {
+        const DvzFrameGraphResource* resource = &plan->graph_resources[i];
+        if (!_graph_alias_candidate(resource))
+            continue;
+        uint64_t bytes = _graph_alias_texture_bytes(plan, resource, width, height);
+        stats.texture_count++;
+        stats.bytes += bytes;
+        if (resource->transient)
+            stats.transient_count++;
+
+        // A slot is counted once, on its first member.
+        bool counted = false;
+        for (uint32_t j = 0; resource->alias_slot != 0 && j < i && !counted; j++)
+            counted = plan->graph_resources[j].alias_slot == resource->alias_slot;
+        if (resource->alias_slot != 0)
+        {
+            stats.aliased_count++;
+            if (!counted)
+                stats.slot_count++;
+        }
+        if (!counted)
+        {
+            stats.aliased_bytes += bytes;
+            if (resource->transient)
+                stats.transient_bytes += bytes;
+        }
+    }
+    return stats;
+}
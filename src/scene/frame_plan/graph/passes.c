@@ -41,8 +41,8 @@ static bool _ensure_graph_pass_capacity(DvzFramePlan* plan)
     if (plan->graph_passes == NULL || plan->graph_pass_capacity == 0)
     {
         plan->graph_pass_capacity = DVZ_FRAME_PLAN_INITIAL_GRAPH_PASS_CAPACITY;
-        plan->graph_passes = (DvzFrameGraphPass*)dvz_calloc(
-            plan->graph_pass_capacity, sizeof(DvzFrameGraphPass));
+        plan->graph_passes = (DvzFrameGraphPass*)_frame_plan_calloc(
+            plan, plan->graph_pass_capacity, sizeof(DvzFrameGraphPass));
         return plan->graph_passes != NULL;
     }
 
@@ -56,7 +56,9 @@ static bool _ensure_graph_pass_capacity(DvzFramePlan* plan)
     if (_dvz_mul_u64_overflows(capacity, sizeof(DvzFrameGraphPass), &bytes))
         return false;
 
-    DvzFrameGraphPass* passes = (DvzFrameGraphPass*)dvz_realloc(plan->graph_passes, bytes);
+    DvzFrameGraphPass* passes = (DvzFrameGraphPass*)_frame_plan_realloc(
+        plan, plan->graph_passes, (uint64_t)plan->graph_pass_capacity * sizeof(DvzFrameGraphPass),
+        bytes);
     if (passes == NULL)
         return false;
 
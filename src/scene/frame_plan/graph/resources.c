@@ -41,8 +41,8 @@ static bool _ensure_graph_resource_capacity(DvzFramePlan* plan)
     if (plan->graph_resources == NULL || plan->graph_resource_capacity == 0)
     {
         plan->graph_resource_capacity = DVZ_FRAME_PLAN_INITIAL_GRAPH_RESOURCE_CAPACITY;
-        plan->graph_resources = (DvzFrameGraphResource*)dvz_calloc(
-            plan->graph_resource_capacity, sizeof(DvzFrameGraphResource));
+        plan->graph_resources = (DvzFrameGraphResource*)_frame_plan_calloc(
+            plan, plan->graph_resource_capacity, sizeof(DvzFrameGraphResource));
         return plan->graph_resources != NULL;
     }
 
@@ -57,7 +57,9 @@ static bool _ensure_graph_resource_capacity(DvzFramePlan* plan)
         return false;
 
     DvzFrameGraphResource* resources =
-        (DvzFrameGraphResource*)dvz_realloc(plan->graph_resources, bytes);
+        (DvzFrameGraphResource*)_frame_plan_realloc(
+        plan, plan->graph_resources,
+        (uint64_t)plan->graph_resource_capacity * sizeof(DvzFrameGraphResource), bytes);
     if (resources == NULL)
         return false;
 
@@ -40,7 +40,8 @@ static bool _ensure_node_capacity(DvzFramePlan* plan)
     if (plan->nodes == NULL || plan->capacity == 0)
     {
         plan->capacity = DVZ_FRAME_PLAN_INITIAL_NODE_CAPACITY;
-        plan->nodes = (DvzFramePlanNode*)dvz_calloc(plan->capacity, sizeof(DvzFramePlanNode));
+        plan->nodes =
+            (DvzFramePlanNode*)_frame_plan_calloc(plan, plan->capacity, sizeof(DvzFramePlanNode));
         return plan->nodes != NULL;
     }
 
@@ -54,7 +55,8 @@ static bool _ensure_node_capacity(DvzFramePlan* plan)
     if (_dvz_mul_u64_overflows(capacity, sizeof(DvzFramePlanNode), &bytes))
         return false;
 
-    DvzFramePlanNode* nodes = (DvzFramePlanNode*)dvz_realloc(plan->nodes, bytes);
+    DvzFramePlanNode* nodes = (DvzFramePlanNode*)_frame_plan_realloc(
+        plan, plan->nodes, (uint64_t)plan->capacity * sizeof(DvzFramePlanNode), bytes);
     if (nodes == NULL)
         return false;
 
@@ -29,13 +29,15 @@
 /**
  * Reserve parallel render-visual storage on a FramePlan node.
  *
+ * @param plan the FramePlan owning the node storage
  * @param node the render node
  * @param count the required visual capacity
  * @return whether the requested capacity is available
  */
-bool _frame_plan_render_visual_reserve(DvzFramePlanNode* node, uint32_t count)
+bool _frame_plan_render_visual_reserve(
+    const DvzFramePlan* plan, DvzFramePlanNode* node, uint32_t count)
 {
-    if (node == NULL || node->type != DVZ_FRAME_PLAN_NODE_RENDER ||
+    if (plan == NULL || node == NULL || node->type != DVZ_FRAME_PLAN_NODE_RENDER ||
         count > DVZ_SCENE_MAX_RENDER_VISUALS)
         return false;
     if (count <= node->u.render.visual_capacity)
@@ -53,32 +55,38 @@ bool _frame_plan_render_visual_reserve(DvzFramePlanNode* node, uint32_t count)
         capacity *= 2;
     }
 
-    char(*visuals)[DVZ_SCENE_LABEL_SIZE] = (char(*)[DVZ_SCENE_LABEL_SIZE])dvz_realloc(
-        node->u.render.visuals, (uint64_t)capacity * sizeof(*visuals));
+    char(*visuals)[DVZ_SCENE_LABEL_SIZE] = (char(*)[DVZ_SCENE_LABEL_SIZE])_frame_plan_realloc(
+        plan, node->u.render.visuals, (uint64_t)old_capacity * sizeof(*visuals),
+        (uint64_t)capacity * sizeof(*visuals));
     if (visuals == NULL)
         return false;
     node->u.render.visuals = visuals;
 
-    DvzFramePlanVisualMeta* metadata = (DvzFramePlanVisualMeta*)dvz_realloc(
-        node->u.render.visual_metadata, (uint64_t)capacity * sizeof(*metadata));
+    DvzFramePlanVisualMeta* metadata = (DvzFramePlanVisualMeta*)_frame_plan_realloc(
+        plan, node->u.render.visual_metadata, (uint64_t)old_capacity * sizeof(*metadata),
+        (uint64_t)capacity * sizeof(*metadata));
     if (metadata == NULL)
         return false;
     node->u.render.visual_metadata = metadata;
 
-    DvzControllerMode* controller_modes = (DvzControllerMode*)dvz_realloc(
-        node->u.render.controller_modes, (uint64_t)capacity * sizeof(*controller_modes));
+    DvzControllerMode* controller_modes = (DvzControllerMode*)_frame_plan_realloc(
+        plan, node->u.render.controller_modes,
+        (uint64_t)old_capacity * sizeof(*controller_modes),
+        (uint64_t)capacity * sizeof(*controller_modes));
     if (controller_modes == NULL)
         return false;
     node->u.render.controller_modes = controller_modes;
 
-    DvzMVP* visual_mvp =
-        (DvzMVP*)dvz_realloc(node->u.render.visual_mvp, (uint64_t)capacity * sizeof(*visual_mvp));
+    DvzMVP* visual_mvp = (DvzMVP*)_frame_plan_realloc(
+        plan, node->u.render.visual_mvp, (uint64_t)old_capacity * sizeof(*visual_mvp),
+        (uint64_t)capacity * sizeof(*visual_mvp));
     if (visual_mvp == NULL)
         return false;
     node->u.render.visual_mvp = visual_mvp;
 
-    bool* visual_has_mvp = (bool*)dvz_realloc(
-        node->u.render.visual_has_mvp, (uint64_t)capacity * sizeof(*visual_has_mvp));
+    bool* visual_has_mvp = (bool*)_frame_plan_realloc(
+        plan, node->u.render.visual_has_mvp, (uint64_t)old_capacity * sizeof(*visual_has_mvp),
+        (uint64_t)capacity * sizeof(*visual_has_mvp));
     if (visual_has_mvp == NULL)
         return false;
     node->u.render.visual_has_mvp = visual_has_mvp;
@@ -302,7 +310,7 @@ bool dvz_frame_plan_render_visual(DvzFramePlan* plan, const char* visual_id)
     DvzFramePlanNode* node = _frame_plan_last_node(plan, DVZ_FRAME_PLAN_NODE_RENDER);
     if (
         node == NULL || visual_id == NULL || visual_id[0] == '\0' ||
-        !_frame_plan_render_visual_reserve(node, node->u.render.visual_count + 1))
+        !_frame_plan_render_visual_reserve(plan, node, node->u.render.visual_count + 1))
         return false;
     char* dst = node->u.render.visuals[node->u.render.visual_count];
     size_t len = strlen(visual_id);
@@ -39,8 +39,8 @@ static bool _ensure_product_capacity(DvzFramePlan* plan)
     if (plan->products == NULL || plan->product_capacity == 0)
     {
         plan->product_capacity = DVZ_FRAME_PLAN_INITIAL_PRODUCT_CAPACITY;
-        plan->products = (DvzRenderProductContract*)dvz_calloc(
-            plan->product_capacity, sizeof(DvzRenderProductContract));
+        plan->products = (DvzRenderProductContract*)_frame_plan_calloc(
+            plan, plan->product_capacity, sizeof(DvzRenderProductContract));
         return plan->products != NULL;
     }
     if (plan->product_count < plan->product_capacity)
@@ -52,7 +52,9 @@ static bool _ensure_product_capacity(DvzFramePlan* plan)
     if (_dvz_mul_u64_overflows(capacity, sizeof(DvzRenderProductContract), &bytes))
         return false;
     DvzRenderProductContract* products =
-        (DvzRenderProductContract*)dvz_realloc(plan->products, bytes);
+        (DvzRenderProductContract*)_frame_plan_realloc(
+        plan, plan->products,
+        (uint64_t)plan->product_capacity * sizeof(DvzRenderProductContract), bytes);
     if (products == NULL)
         return false;
     plan->product_capacity = capacity;
@@ -68,8 +70,8 @@ static bool _ensure_product_use_capacity(DvzFramePlan* plan)
     if (plan->product_uses == NULL || plan->product_use_capacity == 0)
     {
         plan->product_use_capacity = DVZ_FRAME_PLAN_INITIAL_PRODUCT_USE_CAPACITY;
-        plan->product_uses = (DvzRenderProductConsumer*)dvz_calloc(
-            plan->product_use_capacity, sizeof(DvzRenderProductConsumer));
+        plan->product_uses = (DvzRenderProductConsumer*)_frame_plan_calloc(
+            plan, plan->product_use_capacity, sizeof(DvzRenderProductConsumer));
         return plan->product_uses != NULL;
     }
     if (plan->product_use_count < plan->product_use_capacity)
@@ -81,7 +83,9 @@ static bool _ensure_product_use_capacity(DvzFramePlan* plan)
     if (_dvz_mul_u64_overflows(capacity, sizeof(DvzRenderProductConsumer), &bytes))
         return false;
     DvzRenderProductConsumer* uses =
-        (DvzRenderProductConsumer*)dvz_realloc(plan->product_uses, bytes);
+        (DvzRenderProductConsumer*)_frame_plan_realloc(
+        plan, plan->product_uses,
+        (uint64_t)plan->product_use_capacity * sizeof(DvzRenderProductConsumer), bytes);
     if (uses == NULL)
         return false;
     plan->product_use_capacity = capacity;
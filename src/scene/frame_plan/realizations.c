@@ -34,8 +34,8 @@ static bool _ensure_realization_capacity(DvzFramePlan* plan)
     if (plan->realizations == NULL || plan->realization_capacity == 0)
     {
         plan->realization_capacity = DVZ_FRAME_PLAN_INITIAL_GRAPH_RESOURCE_CAPACITY;
-        plan->realizations = (DvzSceneGraphRealization*)dvz_calloc(
-            plan->realization_capacity, sizeof(DvzSceneGraphRealization));
+        plan->realizations = (DvzSceneGraphRealization*)_frame_plan_calloc(
+            plan, plan->realization_capacity, sizeof(DvzSceneGraphRealization));
         return plan->realizations != NULL;
     }
     if (plan->realization_count < plan->realization_capacity)
@@ -47,7 +47,9 @@ static bool _ensure_realization_capacity(DvzFramePlan* plan)
     if (_dvz_mul_u64_overflows(capacity, sizeof(DvzSceneGraphRealization), &bytes))
         return false;
     DvzSceneGraphRealization* realizations =
-        (DvzSceneGraphRealization*)dvz_realloc(plan->realizations, bytes);
+        (DvzSceneGraphRealization*)_frame_plan_realloc(
+        plan, plan->realizations,
+        (uint64_t)plan->realization_capacity * sizeof(DvzSceneGraphRealization), bytes);
     if (realizations == NULL)
         return false;
     plan->realization_capacity = capacity;
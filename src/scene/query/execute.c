@@ -86,6 +86,25 @@ static void _query_result_init(
 
 
 
+/**
+ * Return whether the next plan uses a different retained resource schema.
+ *
+ * @param executor retained query executor
+ * @param family query visual family
+ * @param target query target
+ * @return true when retained query resources must be reset
+ */
+static bool _query_executor_schema_changes(
+    const DvzSceneRequestExecutor* executor, DvzSceneVisualFamily family,
+    DvzSceneTargetKind target)
+{
+    ANN(executor);
+    return executor->active_query_family != DVZ_SCENE_VISUAL_FAMILY_NONE &&
+           (executor->active_query_family != family || executor->active_query_target != target);
+}
+
+
+
 /**
  * Reset retained query resources when the next plan uses a different resource schema.
  *
@@ -97,12 +116,130 @@ static void _query_executor_reset_for_schema(
     DvzSceneRequestExecutor* executor, DvzSceneVisualFamily family, DvzSceneTargetKind target)
 {
     ANN(executor);
-    if (
-        executor->active_query_family != DVZ_SCENE_VISUAL_FAMILY_NONE &&
-        (executor->active_query_family != family || executor->active_query_target != target))
-    {
+    if (_query_executor_schema_changes(executor, family, target))
         _scene_request_executor_destroy(executor);
+}
+
+
+
+/**
+ * Return whether a panel still attaches a visual.
+ *
+ * @param panel the panel
+ * @param visual the visual
+ * @return true when the visual is attached to the panel
+ */
+static bool _query_panel_attaches_visual(const DvzPanel* panel, const DvzVisual* visual)
+{
+    if (panel == NULL || visual == NULL)
+        return false;
+    for (uint32_t i = 0; i < panel->visual_count; i++)
+    {
+        if (panel->visuals[i].visual == visual)
+            return true;
     }
+    return false;
+}
+
+
+
+/**
+ * Decode a readback payload and apply the optional family readout.
+ *
+ * @param ops family operation table
+ * @param build the query build context
+ * @param plan the executed query plan
+ * @param bytes the readback payload
+ * @param out_result output result
+ * @return true when the family produced a terminal result
+ */
+static bool _query_decode_readout(
+    const DvzSceneQueryFamilyOps* ops, const DvzSceneQueryBuildContext* build,
+    const DvzSceneQueryPlan* plan, const uint8_t* bytes, DvzQueryResult* out_result)
+{
+    ANN(ops);
+    ANN(build);
+    ANN(plan);
+    ANN(bytes);
+    ANN(out_result);
+    DvzSceneQueryDecodeContext decode = {
+        .build = build,
+        .plan = plan,
+        .bytes = bytes,
+        .byte_size = plan->byte_size,
+    };
+    if (!ops->decode(&decode, out_result))
+        return false;
+
+    if (ops->readout != NULL)
+    {
+        DvzSceneQueryReadoutContext readout = {
+            .build = build,
+            .plan = plan,
+        };
+        if (!ops->readout(&readout, out_result))
+            out_result->status = DVZ_QUERY_STATUS_DECODE_FAILED;
+    }
+    return true;
+}
+
+
+
+/**
+ * Submit one built query plan into a readback ring slot instead of downloading it.
+ *
+ * The slot takes ownership of the plan scratch; decoding happens at collection.
+ *
+ * @param figure the figure
+ * @param executor retained query executor
+ * @param caps capability snapshot
+ * @param build the query build context
+ * @param ops family operation table
+ * @param plan the built query plan
+ * @param out_result output result
+ */
+static void _query_submit_inflight(
+    DvzFigure* figure, DvzSceneRequestExecutor* executor, const DvzCapabilitySnapshot* caps,
+    const DvzSceneQueryBuildContext* build, const DvzSceneQueryFamilyOps* ops,
+    DvzSceneQueryPlan* plan, DvzQueryResult* out_result)
+{
+    ANN(figure);
+    ANN(executor);
+    ANN(build);
+    ANN(plan);
+    ANN(out_result);
+    DvzSceneQueryInflight* slot = _scene_request_executor_acquire_slot(executor);
+    if (slot == NULL)
+    {
+        executor->pipeline_blocked = true;
+        _scene_query_scratch_destroy(&plan->scratch);
+        return;
+    }
+
+    uint64_t rb_id = 0;
+    if (!_dvz_scene_query_submit_readback(
+            figure->scene, executor, caps, plan->scratch.plan, plan->target_width,
+            plan->target_height, plan->format, slot->slot, &rb_id))
+    {
+        out_result->status = DVZ_QUERY_STATUS_GPU_EXEC_FAILED;
+        _scene_query_scratch_destroy(&plan->scratch);
+        return;
+    }
+    _query_mark_static_upload(executor, plan);
+
+    slot->active = true;
+    slot->submit_tick = executor->pipeline_tick;
+    slot->readback_id = rb_id;
+    slot->pending = *build->pending;
+    slot->visual = build->visual;
+    slot->ops = ops;
+    slot->profile = build->profile;
+    slot->request_ndc[0] = build->request_ndc[0];
+    slot->request_ndc[1] = build->request_ndc[1];
+    slot->plan = *plan;
+    slot->result = *out_result;
+    executor->pipeline_submitted = true;
+    executor->pipeline_submit_count++;
 }
 
 
@@ -148,21 +285,26 @@ bool _dvz_scene_query_process_pending(
         return true;
     }
 
+    // Visuals with a CPU spatial index still resolve when no GPU query profile is available.
     out_result->profile = _dvz_scene_query_select_profile(&pending->request, caps);
-    if (out_result->profile == DVZ_QUERY_PROFILE_UNSUPPORTED)
-    {
-        out_result->status = caps->supports_readback ? DVZ_QUERY_STATUS_UNSUPPORTED_QUERY_PROFILE
-                                                     : DVZ_QUERY_STATUS_READBACK_FAILED;
-        return true;
-    }
+    bool gpu_profile = out_result->profile != DVZ_QUERY_PROFILE_UNSUPPORTED;
+    bool gpu_skipped = false;
+    bool spatial_attempted = false;
 
-    bool native_attempted = false;
+    // A request resumed after a pipelined miss skips the candidates down to the missed visual.
+    bool resuming = pending->resume_after != NULL;
+    bool native_attempted = resuming;
     uint32_t order[DVZ_SCENE_MAX_VISUALS] = {0};
     _scene_panel_visual_order(pending->panel, order);
     for (int32_t oi = (int32_t)pending->panel->visual_count - 1; oi >= 0; oi--)
     {
         const DvzPanelAttach* attach = &pending->panel->visuals[order[oi]];
         DvzVisual* visual = attach->visual;
+        if (resuming)
+        {
+            resuming = visual != pending->resume_after;
+            continue;
+        }
         if (visual == NULL || !visual->visible)
             continue;
         if (attach->controller_mode == DVZ_CONTROLLER_FIXED)
@@ -173,6 +315,21 @@ bool _dvz_scene_query_process_pending(
             _dvz_scene_query_family_ops_for_visual(pending->panel, visual, &pending->request);
         if (ops == NULL || ops->build == NULL || ops->decode == NULL)
             continue;
+        bool spatial_hit = false;
+        if (_dvz_scene_query_spatial_pick(figure, pending, attach, out_result, &spatial_hit))
+        {
+            native_attempted = true;
+            spatial_attempted = true;
+            if (!spatial_hit)
+                continue;
+            out_result->freshness_serial = pending->freshness_serial;
+            return true;
+        }
+        if (!gpu_profile)
+        {
+            gpu_skipped = true;
+            continue;
+        }
         native_attempted = true;
         if (_dvz_scene_query_execute_family(
                 figure, runtime, executor, caps, pending, request_ndc, out_result->profile,
@@ -184,6 +341,13 @@ bool _dvz_scene_query_process_pending(
         }
     }
 
+    if (!gpu_profile && (gpu_skipped || !spatial_attempted))
+    {
+        out_result->status = caps->supports_readback ? DVZ_QUERY_STATUS_UNSUPPORTED_QUERY_PROFILE
+                                                     : DVZ_QUERY_STATUS_READBACK_FAILED;
+        return true;
+    }
+
     DvzVisual* visual = _dvz_scene_query_candidate_visual(pending->panel, capability);
     if (visual == NULL)
     {
@@ -277,6 +441,15 @@ bool _dvz_scene_query_execute_family(
         out_result->status = DVZ_QUERY_STATUS_GPU_EXEC_FAILED;
         return true;
     }
+    if (
+        executor->pipeline_defer &&
+        _query_executor_schema_changes(executor, ops->family, pending->request.target) &&
+        _scene_request_executor_has_inflight(executor))
+    {
+        // Switching schema destroys the runtime that recorded the in-flight readbacks.
+        executor->pipeline_blocked = true;
+        return true;
+    }
     _query_executor_reset_for_schema(executor, ops->family, pending->request.target);
     if (!_scene_request_executor_prepare(executor, runtime))
     {
@@ -300,6 +473,13 @@ bool _dvz_scene_query_execute_family(
         return true;
     }
 
+    // Families with a custom execute path stay synchronous.
+    if (executor->pipeline_defer && ops->execute == NULL)
+    {
+        _query_submit_inflight(figure, executor, caps, &build, ops, &plan, out_result);
+        return true;
+    }
+
     uint8_t bytes[DVZ_SCENE_QUERY_PAYLOAD_WORDS * sizeof(uint32_t)] = {0};
     bool executed = false;
     bool ok = false;
@@ -323,28 +503,78 @@ bool _dvz_scene_query_execute_family(
         return true;
     }
 
-    DvzSceneQueryDecodeContext decode = {
-        .build = &build,
-        .plan = &plan,
-        .bytes = bytes,
-        .byte_size = plan.byte_size,
-    };
-    if (!ops->decode(&decode, out_result))
-    {
-        _scene_query_scratch_destroy(&plan.scratch);
+    bool terminal = _query_decode_readout(ops, &build, &plan, bytes, out_result);
+    _scene_query_scratch_destroy(&plan.scratch);
+    return terminal;
+}
+
+
+
+/**
+ * Download, decode, and release one readback ring slot.
+ *
+ * Results whose visual left the panel while the readback was in flight are reported as stale.
+ * When the family decodes a non-terminal result, the caller should resume the request below the
+ * slot visual, as the synchronous path falls back to the next visual in z-order; the result is
+ * still filled in as a miss for callers that cannot requeue it.
+ *
+ * @param figure the figure
+ * @param executor retained query executor
+ * @param caps capability snapshot
+ * @param slot the in-flight ring slot
+ * @param out_result output result
+ * @param out_resume set to whether the request should resume below the slot visual
+ * @return true when a result was produced
+ */
+bool _dvz_scene_query_collect_inflight(
+    DvzFigure* figure, DvzSceneRequestExecutor* executor, const DvzCapabilitySnapshot* caps,
+    DvzSceneQueryInflight* slot, DvzQueryResult* out_result, bool* out_resume)
+{
+    ANN(figure);
+    ANN(executor);
+    ANN(caps);
+    ANN(slot);
+    ANN(out_result);
+    ANN(out_resume);
+    *out_resume = false;
+    if (!slot->active)
         return false;
-    }
 
-    if (ops->readout != NULL)
+    *out_result = slot->result;
+    if (!_query_panel_attaches_visual(slot->pending.panel, slot->visual))
     {
-        DvzSceneQueryReadoutContext readout = {
-            .build = &build,
-            .plan = &plan,
-        };
-        if (!ops->readout(&readout, out_result))
-            out_result->status = DVZ_QUERY_STATUS_DECODE_FAILED;
+        out_result->status = DVZ_QUERY_STATUS_STALE_DROPPED;
     }
-
-    _scene_query_scratch_destroy(&plan.scratch);
-    return true;
+    else
+    {
+        uint8_t bytes[DVZ_SCENE_QUERY_PAYLOAD_WORDS * sizeof(uint32_t)] = {0};
+        if (!_dvz_scene_query_download_readback(
+                figure->scene, executor, slot->readback_id, bytes, slot->plan.byte_size))
+        {
+            out_result->status = DVZ_QUERY_STATUS_READBACK_FAILED;
+        }
+        else
+        {
+            DvzSceneQueryBuildContext build = {
+                .figure = figure,
+                .panel = slot->pending.panel,
+                .visual = slot->visual,
+                .executor = executor,
+                .pending = &slot->pending,
+                .caps = caps,
+                .profile = slot->profile,
+            };
+            build.request_ndc[0] = slot->request_ndc[0];
+            build.request_ndc[1] = slot->request_ndc[1];
+            if (!_query_decode_readout(slot->ops, &build, &slot->plan, bytes, out_result))
+            {
+                out_result->status = DVZ_QUERY_STATUS_MISS;
+                *out_resume = true;
+            }
+        }
+    }
+    out_result->freshness_serial = slot->pending.freshness_serial;
+    executor->pipeline_collect_count++;
+    _scene_query_inflight_release(slot);
+    return !*out_resume;
 }
@@ -71,6 +71,13 @@ void _scene_request_executor_destroy(DvzSceneRequestExecutor* executor)
 {
     if (executor == NULL)
         return;
+    if (executor->inflight != NULL)
+    {
+        // In-flight readbacks die with the runtime that recorded them.
+        for (uint32_t i = 0; i < DVZ_SCENE_QUERY_READBACK_RING; i++)
+            _scene_query_inflight_release(&executor->inflight[i]);
+        dvz_free(executor->inflight);
+    }
     if (executor->runtime != NULL)
         dvz_drp2_runtime_destroy(executor->runtime);
     if (executor->emitter != NULL)
@@ -119,3 +126,69 @@ bool _scene_request_executor_prepare(DvzSceneRequestExecutor* executor, DvzDrp2R
     executor->runtime_create_count++;
     return true;
 }
+
+
+
+/**
+ * Release one readback ring slot and its retained query plan.
+ *
+ * @param slot the ring slot
+ */
+void _scene_query_inflight_release(DvzSceneQueryInflight* slot)
+{
+    if (slot == NULL)
+        return;
+    _scene_query_scratch_destroy(&slot->plan.scratch);
+    uint32_t index = slot->slot;
+    dvz_memset(slot, sizeof(DvzSceneQueryInflight), 0, sizeof(DvzSceneQueryInflight));
+    slot->slot = index;
+}
+
+
+
+/**
+ * Return a free readback ring slot, allocating the ring on first use.
+ *
+ * @param executor the retained query executor
+ * @return a free slot, or NULL when every slot is in flight
+ */
+DvzSceneQueryInflight* _scene_request_executor_acquire_slot(DvzSceneRequestExecutor* executor)
+{
+    ANN(executor);
+    if (executor->inflight == NULL)
+    {
+        executor->inflight = (DvzSceneQueryInflight*)dvz_calloc(
+            DVZ_SCENE_QUERY_READBACK_RING, sizeof(DvzSceneQueryInflight));
+        if (executor->inflight == NULL)
+            return NULL;
+        for (uint32_t i = 0; i < DVZ_SCENE_QUERY_READBACK_RING; i++)
+            executor->inflight[i].slot = i;
+    }
+    for (uint32_t i = 0; i < DVZ_SCENE_QUERY_READBACK_RING; i++)
+    {
+        if (!executor->inflight[i].active)
+            return &executor->inflight[i];
+    }
+    return NULL;
+}
+
+
+
+/**
+ * Return whether any readback ring slot is still waiting for collection.
+ *
+ * @param executor the retained query executor
+ * @return true when at least one slot is in flight
+ */
+bool _scene_request_executor_has_inflight(const DvzSceneRequestExecutor* executor)
+{
+    ANN(executor);
+    if (executor->inflight == NULL)
+        return false;
+    for (uint32_t i = 0; i < DVZ_SCENE_QUERY_READBACK_RING; i++)
+    {
+        if (executor->inflight[i].active)
+            return true;
+    }
+    return false;
+}
@@ -30,6 +30,7 @@
 
 #define DVZ_SCENE_QUERY_PAYLOAD_WORDS 4
 #define DVZ_SCENE_QUERY_STATIC_CACHE_KEY_COUNT 4
+#define DVZ_SCENE_QUERY_READBACK_RING 4
 
 
 
@@ -81,6 +82,15 @@ typedef enum
 
 
 
+typedef enum
+{
+    DVZ_SCENE_SPATIAL_INDEX_NONE = 0,
+    DVZ_SCENE_SPATIAL_INDEX_GRID = 1, /* uniform grid over point-like item positions */
+    DVZ_SCENE_SPATIAL_INDEX_BVH  = 2, /* bounding-volume hierarchy over triangles */
+} DvzSceneSpatialIndexKind;
+
+
+
 /*************************************************************************************************/
 /*  Structs                                                                                      */
 /*************************************************************************************************/
@@ -160,6 +170,95 @@ struct DvzSceneQueryReadoutContext
 };
 
 
+struct DvzSceneQueryInflight
+{
+    bool active;
+    uint32_t slot;
+    uint64_t submit_tick;
+    uint64_t readback_id;
+    DvzPendingQueryRequest pending;
+    DvzVisual* visual;
+    const DvzSceneQueryFamilyOps* ops;
+    DvzQueryProfile profile;
+    vec2 request_ndc;
+    DvzSceneQueryPlan plan;
+    DvzQueryResult result;
+};
+
+
+typedef struct DvzSceneSpatialNode
+{
+    float min[2];
+    float max[2];
+    uint32_t first; /* leaf: first slot in triangle_order; inner: left child, right is first+1 */
+    uint32_t count; /* leaf triangle count, 0 for inner nodes */
+} DvzSceneSpatialNode;
+
+
+struct DvzSceneSpatialIndex
+{
+    DvzSceneSpatialIndexKind kind;
+    bool built;
+    uint64_t item_count;       /* indexed positions (grid) or triangles (BVH) */
+    uint64_t item_bound;       /* one past the largest reported item id */
+    uint64_t position_version; /* position attribute version the index reflects */
+    uint64_t noted_version;    /* position version reached through noted range updates */
+    uint64_t dirty_first;
+    uint64_t dirty_count;
+    uint64_t size_version;
+    float max_radius_px;
+
+    double origin[2];
+    double cell_size[2];
+    uint32_t dims[2];
+    uint32_t* item_cell;
+    uint32_t* cell_start;
+    uint32_t* cell_items;
+
+    const DvzSceneBuffer* index_buffer;
+    uint64_t index_revision;
+    uint64_t instance_version;
+    uint32_t topology;
+    float* triangles; /* xy of the three corners, 6 floats per triangle */
+    uint32_t* triangle_items;
+    uint32_t* triangle_order;
+    DvzSceneSpatialNode* nodes;
+    uint32_t node_count;
+};
+
+
+struct DvzSceneRegionSelection
+{
+    uint64_t* mask;            /* one bit per item id */
+    uint64_t item_count;       /* position count the mask covers */
+    uint64_t word_count;
+    uint64_t selected_count;
+    uint64_t position_version; /* position attribute version the mask reflects */
+    bool has_item_range;
+    uint64_t item_range_first;
+    uint64_t item_range_count;
+    double* polygon; /* last lasso as xy pairs, vertex_count 0 after a rectangle */
+    uint32_t vertex_count;
+    uint32_t vertex_capacity;
+    bool last_incremental; /* whether the last update only tested the area a lasso gained */
+
+    DvzDrp2Runtime* runtime; /* private runtime of the GPU pass, NULL for the CPU path */
+    DvzDrp2RuntimeConfig runtime_cfg;
+    uint64_t* gpu_bits; /* downloaded region bits folded into the mask */
+    uint64_t gpu_next_id;
+    uint64_t gpu_pipeline_id;
+    uint64_t gpu_bgl_id;
+    uint64_t gpu_positions_id;
+    uint64_t gpu_params_id;
+    uint64_t gpu_mask_id;
+    uint64_t gpu_readback_id;
+    uint64_t gpu_bind_group_id;
+    uint64_t gpu_item_count;
+    uint64_t gpu_position_version;
+    uint32_t gpu_vertex_capacity;
+};
+
+
 struct DvzSceneQueryFamilyOps
 {
     const char* name;
@@ -239,6 +338,47 @@ bool _dvz_scene_query_execute_readback(
     DvzFramePlan* plan, uint32_t target_width, uint32_t target_height, uint32_t color_format,
     uint8_t* bytes, uint32_t byte_size, bool* out_executed);
 
+bool _dvz_scene_query_submit_readback(
+    const DvzScene* scene, DvzSceneRequestExecutor* executor, const DvzCapabilitySnapshot* caps,
+    DvzFramePlan* plan, uint32_t target_width, uint32_t target_height, uint32_t color_format,
+    uint32_t slot, uint64_t* out_readback_id);
+
+bool _dvz_scene_query_download_readback(
+    const DvzScene* scene, DvzSceneRequestExecutor* executor, uint64_t readback_id,
+    uint8_t* bytes, uint32_t byte_size);
+
+DvzSceneQueryInflight* _scene_request_executor_acquire_slot(DvzSceneRequestExecutor* executor);
+
+bool _scene_request_executor_has_inflight(const DvzSceneRequestExecutor* executor);
+
+void _scene_query_inflight_release(DvzSceneQueryInflight* slot);
+
+bool _dvz_scene_query_collect_inflight(
+    DvzFigure* figure, DvzSceneRequestExecutor* executor, const DvzCapabilitySnapshot* caps,
+    DvzSceneQueryInflight* slot, DvzQueryResult* out_result, bool* out_resume);
+
+void _scene_spatial_index_destroy(DvzSceneSpatialIndex* index);
+
+void _scene_spatial_index_note_range(
+    DvzVisual* visual, const DvzVisualAttr* attr, uint64_t previous_version, uint64_t first_item,
+    uint64_t item_count);
+
+bool _dvz_scene_query_spatial_pick(
+    const DvzFigure* figure, const DvzPendingQueryRequest* pending, const DvzPanelAttach* attach,
+    DvzQueryResult* out_result, bool* out_hit);
+
+bool _scene_point_in_polygon(const double* xy, uint32_t count, double x, double y);
+
+bool _scene_spatial_index_toggle_region(
+    DvzVisual* visual, const double min[2], const double max[2], const double* polygon,
+    uint32_t vertex_count, uint64_t* mask);
+
+void _scene_region_selection_destroy(DvzSceneRegionSelection* selection);
+
+bool _scene_region_selection_gpu_bits(
+    DvzSceneRegionSelection* selection, const DvzVisual* visual, const DvzVisualAttr* attr,
+    const double min[2], const double max[2], const double* polygon, uint32_t vertex_count);
+
 void _dvz_scene_query_drop_superseded_results(
     DvzScene* scene, const DvzPanel* panel, uint64_t request_id);
 
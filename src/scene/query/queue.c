@@ -249,6 +249,166 @@ static void _query_remove_pending_at(DvzScene* scene, uint32_t index)
 
 
 
+/**
+ * Put a pipelined query back at the head of the queue to try the visuals below a missed one.
+ *
+ * @param scene the scene
+ * @param pending the originating pending query
+ * @param visual the visual whose readback missed
+ * @return whether the request was queued again
+ */
+static bool _query_resume_pending(
+    DvzScene* scene, const DvzPendingQueryRequest* pending, DvzVisual* visual)
+{
+    ANN(scene);
+    ANN(pending);
+    if (scene->pending_query_count >= DVZ_SCENE_MAX_PENDING_REQUESTS)
+        return false;
+    for (uint32_t i = scene->pending_query_count; i > 0; i--)
+        scene->pending_queries[i] = scene->pending_queries[i - 1];
+    scene->pending_query_count++;
+    scene->pending_queries[0] = *pending;
+    scene->pending_queries[0].resume_after = visual;
+    return true;
+}
+
+
+
+/**
+ * Deliver one resolved query result to its item interaction and the scene result queue.
+ *
+ * @param scene the scene
+ * @param pending the originating pending query
+ * @param result the resolved result
+ */
+static void _query_deliver_result(
+    DvzScene* scene, const DvzPendingQueryRequest* pending, const DvzQueryResult* result)
+{
+    ANN(scene);
+    ANN(pending);
+    ANN(result);
+    _scene_item_interaction_apply_query_result(
+        pending->item_interaction, pending->item_interaction_kind, result);
+    (void)_dvz_scene_query_push_result(scene, pending->panel, pending->freshness_serial, result);
+}
+
+
+
+/**
+ * Collect the in-flight readbacks of one figure submitted at least `latency` frames ago.
+ *
+ * Slots are collected oldest first so results keep their submission order. A readback that
+ * misses its visual queues the request again below that visual, so the next submission tries the
+ * following visual in z-order like the synchronous path does.
+ *
+ * @param figure the figure
+ * @param caps the capability snapshot
+ * @param latency the number of frames a readback stays in flight
+ * @return the number of delivered results
+ */
+static uint32_t _query_collect_inflight(
+    DvzFigure* figure, const DvzCapabilitySnapshot* caps, uint32_t latency)
+{
+    ANN(figure);
+    ANN(figure->scene);
+    DvzScene* scene = figure->scene;
+    DvzSceneRequestExecutor* executor = &scene->query_executor;
+    uint32_t delivered = 0;
+    while (executor->inflight != NULL)
+    {
+        DvzSceneQueryInflight* oldest = NULL;
+        for (uint32_t i = 0; i < DVZ_SCENE_QUERY_READBACK_RING; i++)
+        {
+            DvzSceneQueryInflight* slot = &executor->inflight[i];
+            if (!slot->active || slot->pending.panel == NULL ||
+                slot->pending.panel->figure != figure)
+                continue;
+            if (slot->submit_tick + latency > executor->pipeline_tick)
+                continue;
+            if (oldest == NULL || slot->submit_tick < oldest->submit_tick)
+                oldest = slot;
+        }
+        if (oldest == NULL)
+            break;
+
+        const DvzPendingQueryRequest pending = oldest->pending;
+        DvzVisual* visual = oldest->visual;
+        DvzQueryResult result = {0};
+        bool resume = false;
+        bool produced =
+            _dvz_scene_query_collect_inflight(figure, executor, caps, oldest, &result, &resume);
+        if (resume && _query_resume_pending(scene, &pending, visual))
+            continue;
+        if (produced || resume)
+        {
+            _query_deliver_result(scene, &pending, &result);
+            delivered++;
+        }
+    }
+    return delivered;
+}
+
+
+
+/**
+ * Submit coalesced queries of one figure into the readback ring without waiting for them.
+ *
+ * Queries that resolve without GPU work (outside the panel, unsupported targets, custom execute
+ * families) are delivered immediately. Queries stay queued while the ring is full or while a
+ * schema switch would destroy in-flight readbacks; coalescing keeps only the newest of them.
+ *
+ * @param figure the figure
+ * @param runtime the DRP2 runtime
+ * @param caps the capability snapshot
+ * @return the number of consumed requests
+ */
+static uint32_t _query_submit_pipelined(
+    DvzFigure* figure, DvzDrp2Runtime* runtime, const DvzCapabilitySnapshot* caps)
+{
+    ANN(figure);
+    ANN(figure->scene);
+    DvzScene* scene = figure->scene;
+    DvzSceneRequestExecutor* executor = &scene->query_executor;
+    uint32_t processed = 0;
+
+    for (uint32_t i = 0; i < scene->pending_query_count;)
+    {
+        const DvzPendingQueryRequest pending = scene->pending_queries[i];
+        if (pending.panel == NULL || pending.panel->figure != figure)
+        {
+            i++;
+            continue;
+        }
+        if (_scene_request_executor_acquire_slot(executor) == NULL)
+            break;
+
+        executor->pipeline_defer = true;
+        executor->pipeline_submitted = false;
+        executor->pipeline_blocked = false;
+        DvzQueryResult result = {0};
+        bool produced =
+            _dvz_scene_query_process_pending(figure, runtime, executor, caps, &pending, &result);
+        bool submitted = executor->pipeline_submitted;
+        bool blocked = executor->pipeline_blocked;
+        executor->pipeline_defer = false;
+        executor->pipeline_submitted = false;
+        executor->pipeline_blocked = false;
+        if (blocked)
+        {
+            i++;
+            continue;
+        }
+        if (produced && !submitted)
+            _query_deliver_result(scene, &pending, &result);
+
+        _query_remove_pending_at(scene, i);
+        processed++;
+    }
+    return processed;
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -347,7 +507,17 @@ uint32_t dvz_figure_process_queries(
     uint32_t processed = 0;
     _query_coalesce_pending_requests(scene, figure);
     DvzSceneRequestExecutor* executor = &scene->query_executor;
+    executor->pipeline_tick++;
 
+    if (scene->query_latency > 0)
+    {
+        processed = _query_submit_pipelined(figure, runtime, caps);
+        (void)_query_collect_inflight(figure, caps, scene->query_latency);
+        return processed;
+    }
+
+    // Synchronous mode first drains readbacks left in flight by an earlier pipelined frame.
+    (void)_query_collect_inflight(figure, caps, 0);
     for (uint32_t i = 0; i < scene->pending_query_count;)
     {
         const DvzPendingQueryRequest pending = scene->pending_queries[i];
@@ -359,12 +529,7 @@ uint32_t dvz_figure_process_queries(
 
         DvzQueryResult result = {0};
         if (_dvz_scene_query_process_pending(figure, runtime, executor, caps, &pending, &result))
-        {
-            _scene_item_interaction_apply_query_result(
-                pending.item_interaction, pending.item_interaction_kind, &result);
-            (void)_dvz_scene_query_push_result(
-                scene, pending.panel, pending.freshness_serial, &result);
-        }
+            _query_deliver_result(scene, &pending, &result);
 
         _query_remove_pending_at(scene, i);
         processed++;
@@ -375,6 +540,29 @@ uint32_t dvz_figure_process_queries(
 
 
 
+/**
+ * Set how many frames pending queries stay in flight before their results are delivered.
+ *
+ * @param scene the scene
+ * @param frames the query latency in frames, 0 for synchronous resolution
+ * @return 0 on success, -1 on failure
+ */
+DvzResult dvz_scene_set_query_latency(DvzScene* scene, uint32_t frames)
+{
+    ANN(scene);
+    if (frames >= DVZ_SCENE_QUERY_READBACK_RING)
+    {
+        log_error(
+            "query latency %u exceeds the %u-slot readback ring", frames,
+            DVZ_SCENE_QUERY_READBACK_RING);
+        return -1;
+    }
+    scene->query_latency = frames;
+    return 0;
+}
+
+
+
 /**
  * Queue and synchronously resolve one panel query.
  *
@@ -396,10 +584,15 @@ DvzResult dvz_panel_query_now_px(
     if (panel->figure == NULL || dvz_panel_query_px(panel, x, y, request) != 0)
         return -1;
 
+    // Resolve synchronously even when the scene pipelines its queries.
+    DvzScene* scene = panel->figure->scene;
+    uint32_t latency = scene->query_latency;
+    scene->query_latency = 0;
     (void)dvz_figure_process_queries(panel->figure, runtime, NULL);
+    scene->query_latency = latency;
     const uint64_t request_id = request != NULL ? request->request_id : 0;
     DvzQueryResult result = {0};
-    while (dvz_scene_poll_query(panel->figure->scene, &result))
+    while (dvz_scene_poll_query(scene, &result))
     {
         if (result.request_id == request_id)
         {
@@ -17,10 +17,12 @@
 #include <inttypes.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 
 #include "datoviz/drp2/runtime.h"
 #include "../../drp2/_stream.h"
 #include "_scene.h"
+#include "frame_plan/emit.h"
 #include "_assertions.h"
 #include "_log.h"
 #include "internal.h"
@@ -28,39 +30,30 @@
 
 
 /*************************************************************************************************/
-/*  Functions                                                                                    */
+/*  Helpers                                                                                      */
 /*************************************************************************************************/
 
 /**
- * Emit, execute, and download one native query readback request.
+ * Emit and execute one native query stream into the emitter's current readback buffer.
  *
- * @param scene the owning scene, used for instance-scoped test controls
  * @param executor retained request executor
  * @param caps capability snapshot
  * @param plan prepared frame plan
  * @param target_width offscreen target width
  * @param target_height offscreen target height
  * @param color_format backend-native color target format, or zero for default RGBA8
- * @param bytes destination readback bytes
- * @param byte_size destination byte count
- * @param out_executed whether the stream executed successfully before download
- * @return true on successful execution and download
+ * @param out_readback_id the readback buffer the copy was recorded into
+ * @return true when the stream executed successfully
  */
-bool _dvz_scene_query_execute_readback(
-    const DvzScene* scene, DvzSceneRequestExecutor* executor, const DvzCapabilitySnapshot* caps,
-    DvzFramePlan* plan, uint32_t target_width, uint32_t target_height, uint32_t color_format,
-    uint8_t* bytes, uint32_t byte_size, bool* out_executed)
+static bool _query_readback_emit_execute(
+    DvzSceneRequestExecutor* executor, const DvzCapabilitySnapshot* caps, DvzFramePlan* plan,
+    uint32_t target_width, uint32_t target_height, uint32_t color_format,
+    uint64_t* out_readback_id)
 {
     ANN(executor);
     ANN(caps);
-    ANN(bytes);
-    ANN(out_executed);
-    *out_executed = false;
-    if (plan == NULL || executor->runtime == NULL || executor->emitter == NULL || byte_size == 0)
-    {
-        log_error("scene query readback requires a prepared frame plan and emitter");
-        return false;
-    }
+    ANN(out_readback_id);
+    *out_readback_id = 0;
 
     DvzDiagnosticReport report = {0};
     dvz_diagnostic_report_init(&report);
@@ -78,11 +71,12 @@ bool _dvz_scene_query_execute_readback(
             log_error("scene query readback diagnostic: %s", report.messages[i]);
         return false;
     }
-    uint64_t rb_id = dvz_frame_plan_emitter_object_id(executor->emitter, "_rb");
+    const char* rb_key = _emitter_readback_key(executor->emitter);
+    uint64_t rb_id = dvz_frame_plan_emitter_object_id(executor->emitter, rb_key);
     bool ok = false;
     if (rb_id == 0)
     {
-        log_error("scene query readback plan did not emit the _rb buffer");
+        log_error("scene query readback plan did not emit the %s buffer", rb_key);
     }
     else
     {
@@ -114,19 +108,134 @@ bool _dvz_scene_query_execute_readback(
         }
         else
         {
-            *out_executed = true;
-            if (scene != NULL && scene->test.force_readback_download_failure)
-            {
-                log_error("scene query readback buffer download forced to fail");
-            }
-            else
-            {
-                ok = dvz_drp2_runtime_download_buffer(executor->runtime, rb_id, 0, byte_size, bytes);
-                if (!ok)
-                    log_error("scene query readback buffer download failed");
-            }
+            *out_readback_id = rb_id;
+            ok = true;
         }
     }
     dvz_drp2_stream_destroy(stream);
     return ok;
 }
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Emit, execute, and download one native query readback request.
+ *
+ * @param scene the owning scene, used for instance-scoped test controls
+ * @param executor retained request executor
+ * @param caps capability snapshot
+ * @param plan prepared frame plan
+ * @param target_width offscreen target width
+ * @param target_height offscreen target height
+ * @param color_format backend-native color target format, or zero for default RGBA8
+ * @param bytes destination readback bytes
+ * @param byte_size destination byte count
+ * @param out_executed whether the stream executed successfully before download
+ * @return true on successful execution and download
+ */
+bool _dvz_scene_query_execute_readback(
+    const DvzScene* scene, DvzSceneRequestExecutor* executor, const DvzCapabilitySnapshot* caps,
+    DvzFramePlan* plan, uint32_t target_width, uint32_t target_height, uint32_t color_format,
+    uint8_t* bytes, uint32_t byte_size, bool* out_executed)
+{
+    ANN(executor);
+    ANN(caps);
+    ANN(bytes);
+    ANN(out_executed);
+    *out_executed = false;
+    if (plan == NULL || executor->runtime == NULL || executor->emitter == NULL || byte_size == 0)
+    {
+        log_error("scene query readback requires a prepared frame plan and emitter");
+        return false;
+    }
+
+    _emitter_set_readback_key(executor->emitter, NULL);
+    uint64_t rb_id = 0;
+    if (!_query_readback_emit_execute(
+            executor, caps, plan, target_width, target_height, color_format, &rb_id))
+    {
+        return false;
+    }
+    *out_executed = true;
+    return _dvz_scene_query_download_readback(scene, executor, rb_id, bytes, byte_size);
+}
+
+
+
+/**
+ * Emit and execute one native query into a readback ring slot without downloading it.
+ *
+ * The copy into the slot buffer is submitted asynchronously by the runtime; a later
+ * `_dvz_scene_query_download_readback()` only waits for that copy.
+ *
+ * @param scene the owning scene, used for instance-scoped test controls
+ * @param executor retained request executor
+ * @param caps capability snapshot
+ * @param plan prepared frame plan
+ * @param target_width offscreen target width
+ * @param target_height offscreen target height
+ * @param color_format backend-native color target format, or zero for default RGBA8
+ * @param slot readback ring slot index
+ * @param out_readback_id the slot readback buffer id
+ * @return true when the stream executed successfully
+ */
+bool _dvz_scene_query_submit_readback(
+    const DvzScene* scene, DvzSceneRequestExecutor* executor, const DvzCapabilitySnapshot* caps,
+    DvzFramePlan* plan, uint32_t target_width, uint32_t target_height, uint32_t color_format,
+    uint32_t slot, uint64_t* out_readback_id)
+{
+    (void)scene;
+    ANN(executor);
+    ANN(caps);
+    ANN(out_readback_id);
+    *out_readback_id = 0;
+    if (plan == NULL || executor->runtime == NULL || executor->emitter == NULL)
+    {
+        log_error("scene query readback requires a prepared frame plan and emitter");
+        return false;
+    }
+
+    char key[DVZ_SCENE_LABEL_SIZE] = {0};
+    (void)snprintf(key, sizeof(key), "_rb%u", slot);
+    _emitter_set_readback_key(executor->emitter, key);
+    bool ok = _query_readback_emit_execute(
+        executor, caps, plan, target_width, target_height, color_format, out_readback_id);
+    _emitter_set_readback_key(executor->emitter, NULL);
+    return ok;
+}
+
+
+
+/**
+ * Download one executed query readback buffer.
+ *
+ * @param scene the owning scene, used for instance-scoped test controls
+ * @param executor retained request executor
+ * @param readback_id the readback buffer id
+ * @param bytes destination readback bytes
+ * @param byte_size destination byte count
+ * @return true on successful download
+ */
+bool _dvz_scene_query_download_readback(
+    const DvzScene* scene, DvzSceneRequestExecutor* executor, uint64_t readback_id,
+    uint8_t* bytes, uint32_t byte_size)
+{
+    ANN(executor);
+    ANN(bytes);
+    if (executor->runtime == NULL || readback_id == 0 || byte_size == 0)
+        return false;
+    if (scene != NULL && scene->test.force_readback_download_failure)
+    {
+        log_error("scene query readback buffer download forced to fail");
+        return false;
+    }
+    bool ok =
+        dvz_drp2_runtime_download_buffer(executor->runtime, readback_id, 0, byte_size, bytes);
+    if (!ok)
+        log_error("scene query readback buffer download failed");
+    return ok;
+}
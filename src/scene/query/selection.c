@@ -0,0 +1,686 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Scene query region selection                                                                 */
+/*************************************************************************************************/
+
+/* Rectangle and lasso selections keep one bit per item of a point-like visual. The bits come from
+ * a compute pass over the positions when a GPU runtime was given, from the visual uniform grid
+ * when a spatial index is enabled, and otherwise from a scan split across the scene selection
+ * workers. A lasso that only gained vertices since the last call flips the bits of the area
+ * between its previous closing edge and its new tail instead of testing every item against the
+ * whole polygon again. */
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "datoviz/drp2/runtime.h"
+#include "_alloc.h"
+#include "_assertions.h"
+#include "_log.h"
+#include "datoviz/scene.h"
+#include "internal.h"
+#include "thread_internal.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define SELECTION_SCAN_GRAIN_WORDS 256
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct DvzSelectionScan
+{
+    const float* pos;
+    uint64_t item_count;
+    bool has_item_range;
+    uint64_t item_range_first;
+    uint64_t item_range_count;
+    double min[2];
+    double max[2];
+    const double* polygon;
+    uint32_t vertex_count;
+    uint64_t* mask;
+    bool toggle;
+} DvzSelectionScan;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Return the number of set bits of a mask word.
+ *
+ * @param bits the mask word
+ * @return the number of set bits
+ */
+static inline uint64_t _selection_popcount(uint64_t bits)
+{
+    bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+    bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+    bits = (bits + (bits >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (bits * 0x0101010101010101ull) >> 56;
+}
+
+
+
+/**
+ * Return whether a visual type has one position per selectable item.
+ *
+ * @param type the visual type
+ * @return true for point-like visuals
+ */
+static bool _selection_supported(DvzVisualType type)
+{
+    return type == DVZ_VISUAL_TYPE_POINT || type == DVZ_VISUAL_TYPE_PIXEL ||
+           type == DVZ_VISUAL_TYPE_MARKER;
+}
+
+
+
+/**
+ * Return the region selection state of a visual, creating it on first use.
+ *
+ * @param visual the visual
+ * @return the selection state, or NULL when the visual type is not supported
+ */
+static DvzSceneRegionSelection* _selection_state(DvzVisual* visual)
+{
+    if (!_selection_supported(visual->type))
+    {
+        log_error("%s visuals have no region selection", _visual_type_name(visual->type));
+        return NULL;
+    }
+    if (visual->region_selection == NULL)
+    {
+        visual->region_selection =
+            (DvzSceneRegionSelection*)dvz_calloc(1, sizeof(DvzSceneRegionSelection));
+    }
+    return visual->region_selection;
+}
+
+
+
+/**
+ * Return whether the selection mask still describes the current positions and item range.
+ *
+ * @param selection the selection state
+ * @param visual the visual
+ * @param attr the position attribute
+ * @return true when the mask can be refined in place
+ */
+static bool _selection_current(
+    const DvzSceneRegionSelection* selection, const DvzVisual* visual, const DvzVisualAttr* attr)
+{
+    return selection->mask != NULL && selection->item_count == attr->item_count &&
+           selection->position_version == attr->version &&
+           selection->has_item_range == visual->has_item_range &&
+           (!visual->has_item_range ||
+            (selection->item_range_first == visual->item_range_first &&
+             selection->item_range_count == visual->item_range_count));
+}
+
+
+
+/**
+ * Mark the drawn items of a word range inside the scanned region.
+ *
+ * @param begin first mask word
+ * @param end one past the last mask word
+ * @param user_data the scan description
+ */
+static void _selection_scan_chunk(uint32_t begin, uint32_t end, void* user_data)
+{
+    const DvzSelectionScan* scan = (const DvzSelectionScan*)user_data;
+    for (uint32_t w = begin; w < end; w++)
+    {
+        uint64_t first = 64 * (uint64_t)w;
+        uint64_t last = first + 64 < scan->item_count ? first + 64 : scan->item_count;
+        uint64_t bits = 0;
+        for (uint64_t item = first; item < last; item++)
+        {
+            double x = scan->pos[3 * item + 0];
+            double y = scan->pos[3 * item + 1];
+            if (x < scan->min[0] || x > scan->max[0] || y < scan->min[1] || y > scan->max[1])
+                continue;
+            if (scan->has_item_range && (item < scan->item_range_first ||
+                                         item - scan->item_range_first >= scan->item_range_count))
+                continue;
+            if (scan->polygon != NULL &&
+                !_scene_point_in_polygon(scan->polygon, scan->vertex_count, x, y))
+                continue;
+            bits |= 1ull << (item - first);
+        }
+        scan->mask[w] = scan->toggle ? scan->mask[w] ^ bits : bits;
+    }
+}
+
+
+
+/**
+ * Mark the items of a region with a scan over every position, split across the scene workers.
+ *
+ * @param visual the visual
+ * @param selection the selection state
+ * @param attr the position attribute
+ * @param min lower region corner
+ * @param max upper region corner
+ * @param polygon optional polygon as xy pairs, or NULL
+ * @param vertex_count polygon vertex count
+ * @param toggle whether to flip the bits of the region instead of overwriting the mask
+ */
+static void _selection_scan(
+    DvzVisual* visual, DvzSceneRegionSelection* selection, const DvzVisualAttr* attr,
+    const double min[2], const double max[2], const double* polygon, uint32_t vertex_count,
+    bool toggle)
+{
+    DvzScene* scene = visual->scene;
+    if (scene != NULL && scene->selection_pool == NULL)
+        scene->selection_pool = dvz_thread_pool(dvz_thread_pool_default_size());
+    DvzSelectionScan scan = {
+        .pos = (const float*)attr->data,
+        .item_count = attr->item_count,
+        .has_item_range = visual->has_item_range,
+        .item_range_first = visual->item_range_first,
+        .item_range_count = visual->item_range_count,
+        .min = {min[0], min[1]},
+        .max = {max[0], max[1]},
+        .polygon = polygon,
+        .vertex_count = vertex_count,
+        .mask = selection->mask,
+        .toggle = toggle,
+    };
+    dvz_thread_pool_parallel_for(
+        scene != NULL ? scene->selection_pool : NULL, (uint32_t)selection->word_count,
+        SELECTION_SCAN_GRAIN_WORDS, _selection_scan_chunk, &scan);
+}
+
+
+
+/**
+ * Mark the items of a region in the selection mask with the best available path.
+ *
+ * A failing GPU pass drops the selection runtime, so later selections stay on the CPU.
+ *
+ * @param visual the visual
+ * @param selection the selection state
+ * @param attr the position attribute
+ * @param min lower region corner
+ * @param max upper region corner
+ * @param polygon optional polygon as xy pairs, or NULL
+ * @param vertex_count polygon vertex count
+ * @param toggle whether to flip the bits of the region instead of overwriting the mask
+ */
+static void _selection_evaluate(
+    DvzVisual* visual, DvzSceneRegionSelection* selection, const DvzVisualAttr* attr,
+    const double min[2], const double max[2], const double* polygon, uint32_t vertex_count,
+    bool toggle)
+{
+    if (selection->runtime != NULL)
+    {
+        if (_scene_region_selection_gpu_bits(
+                selection, visual, attr, min, max, polygon, vertex_count))
+        {
+            for (uint64_t w = 0; w < selection->word_count; w++)
+            {
+                selection->mask[w] =
+                    toggle ? selection->mask[w] ^ selection->gpu_bits[w] : selection->gpu_bits[w];
+            }
+            return;
+        }
+        log_warn("region selection GPU pass failed, falling back to the CPU");
+        dvz_drp2_runtime_destroy(selection->runtime);
+        selection->runtime = NULL;
+    }
+
+    // The grid flips bits, which sets them on the cleared mask of a full update.
+    if (!toggle)
+    {
+        dvz_memset(
+            selection->mask, selection->word_count * sizeof(uint64_t), 0,
+            selection->word_count * sizeof(uint64_t));
+    }
+    if (!_scene_spatial_index_toggle_region(
+            visual, min, max, polygon, vertex_count, selection->mask))
+    {
+        _selection_scan(visual, selection, attr, min, max, polygon, vertex_count, toggle);
+    }
+}
+
+
+
+/**
+ * Size the selection mask for the current positions.
+ *
+ * @param visual the visual
+ * @param selection the selection state
+ * @param attr the position attribute
+ * @return true on success
+ */
+static bool _selection_prepare_mask(
+    const DvzVisual* visual, DvzSceneRegionSelection* selection, const DvzVisualAttr* attr)
+{
+    uint64_t word_count = (attr->item_count + 63) / 64;
+    if (word_count > UINT32_MAX)
+    {
+        log_error(
+            "region selection supports at most %" PRIu64 " items", 64 * (uint64_t)UINT32_MAX);
+        return false;
+    }
+    if (word_count != selection->word_count)
+    {
+        dvz_free(selection->mask);
+        dvz_free(selection->gpu_bits);
+        selection->gpu_bits = NULL;
+        selection->word_count = 0;
+        selection->mask = (uint64_t*)dvz_calloc(word_count, sizeof(uint64_t));
+        if (selection->mask == NULL)
+        {
+            log_error(
+                "region selection allocation failed for %" PRIu64 " items", attr->item_count);
+            return false;
+        }
+        selection->word_count = word_count;
+    }
+    selection->item_count = attr->item_count;
+    selection->position_version = attr->version;
+    selection->has_item_range = visual->has_item_range;
+    selection->item_range_first = visual->item_range_first;
+    selection->item_range_count = visual->item_range_count;
+    return true;
+}
+
+
+
+/**
+ * Keep a copy of the last lasso for the next incremental update.
+ *
+ * @param selection the selection state
+ * @param polygon polygon vertices as xy pairs, or NULL after a rectangle
+ * @param vertex_count polygon vertex count
+ * @return true on success
+ */
+static bool _selection_store_polygon(
+    DvzSceneRegionSelection* selection, const double* polygon, uint32_t vertex_count)
+{
+    selection->vertex_count = 0;
+    if (polygon == NULL)
+        return true;
+    if (vertex_count > selection->vertex_capacity)
+    {
+        uint32_t capacity = selection->vertex_capacity > 0 ? selection->vertex_capacity : 64;
+        while (capacity < vertex_count)
+            capacity *= 2;
+        double* grown = (double*)dvz_realloc(selection->polygon, 2 * capacity * sizeof(double));
+        if (grown == NULL)
+            return false;
+        selection->polygon = grown;
+        selection->vertex_capacity = capacity;
+    }
+    dvz_memcpy(
+        selection->polygon, 2 * selection->vertex_capacity * sizeof(double), polygon,
+        2 * vertex_count * sizeof(double));
+    selection->vertex_count = vertex_count;
+    return true;
+}
+
+
+
+/**
+ * Recount the selected items.
+ *
+ * @param selection the selection state
+ */
+static void _selection_recount(DvzSceneRegionSelection* selection)
+{
+    uint64_t count = 0;
+    for (uint64_t w = 0; w < selection->word_count; w++)
+        count += _selection_popcount(selection->mask[w]);
+    selection->selected_count = count;
+}
+
+
+
+/**
+ * Return the bounds of a polygon.
+ *
+ * @param polygon polygon vertices as xy pairs
+ * @param vertex_count polygon vertex count
+ * @param out_min output lower corner
+ * @param out_max output upper corner
+ */
+static void _selection_polygon_bounds(
+    const double* polygon, uint32_t vertex_count, double out_min[2], double out_max[2])
+{
+    out_min[0] = out_min[1] = INFINITY;
+    out_max[0] = out_max[1] = -INFINITY;
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        for (uint32_t d = 0; d < 2; d++)
+        {
+            out_min[d] = fmin(out_min[d], polygon[2 * i + d]);
+            out_max[d] = fmax(out_max[d], polygon[2 * i + d]);
+        }
+    }
+}
+
+
+
+/**
+ * Flip the bits of the area a grown lasso gained or lost since the last update.
+ *
+ * With the even-odd rule, the parity of the new polygon is the parity of the old one combined
+ * with the parity of the polygon closing its old last vertex, the added vertices, and its first
+ * vertex. Only that small polygon is tested.
+ *
+ * @param visual the visual
+ * @param selection the selection state, holding the previous lasso
+ * @param attr the position attribute
+ * @param polygon the grown polygon, whose first vertices repeat the previous lasso
+ * @param vertex_count vertex count of the grown polygon
+ * @return true on success
+ */
+static bool _selection_grow_lasso(
+    DvzVisual* visual, DvzSceneRegionSelection* selection, const DvzVisualAttr* attr,
+    const double* polygon, uint32_t vertex_count)
+{
+    uint32_t previous = selection->vertex_count;
+    uint32_t delta_count = vertex_count - previous + 2;
+    double* delta = (double*)dvz_calloc(2 * (uint64_t)delta_count, sizeof(double));
+    if (delta == NULL)
+        return false;
+    dvz_memcpy(
+        delta, 2 * delta_count * sizeof(double), &polygon[2 * (previous - 1)],
+        2 * (vertex_count - previous + 1) * sizeof(double));
+    delta[2 * (delta_count - 1) + 0] = polygon[0];
+    delta[2 * (delta_count - 1) + 1] = polygon[1];
+
+    double min[2] = {0}, max[2] = {0};
+    _selection_polygon_bounds(delta, delta_count, min, max);
+    _selection_evaluate(visual, selection, attr, min, max, delta, delta_count, true);
+    dvz_free(delta);
+    return true;
+}
+
+
+
+/**
+ * Replace or refine the region selection of a visual.
+ *
+ * @param visual the visual
+ * @param min lower region corner
+ * @param max upper region corner
+ * @param polygon optional lasso as xy pairs, or NULL for a rectangle
+ * @param vertex_count lasso vertex count
+ * @return 0 on success, -1 on failure
+ */
+static DvzResult _selection_update(
+    DvzVisual* visual, const double min[2], const double max[2], const double* polygon,
+    uint32_t vertex_count)
+{
+    DvzSceneRegionSelection* selection = _selection_state(visual);
+    if (selection == NULL)
+        return -1;
+    const DvzVisualAttr* attr = NULL;
+    if (!_dvz_scene_query_dense_attr(visual, "position", sizeof(vec3), &attr))
+    {
+        log_error("region selection needs CPU-retained vec3 positions");
+        return -1;
+    }
+
+    uint32_t previous = selection->vertex_count;
+    bool grows = polygon != NULL && previous >= 3 && vertex_count >= previous &&
+                 _selection_current(selection, visual, attr);
+    for (uint32_t i = 0; grows && i < 2 * previous; i++)
+        grows = polygon[i] == selection->polygon[i];
+
+    selection->last_incremental = grows;
+    if (grows)
+    {
+        if (vertex_count == previous)
+            return 0;
+        if (!_selection_grow_lasso(visual, selection, attr, polygon, vertex_count))
+            return -1;
+    }
+    else
+    {
+        if (!_selection_prepare_mask(visual, selection, attr))
+            return -1;
+        _selection_evaluate(visual, selection, attr, min, max, polygon, vertex_count, false);
+    }
+    _selection_recount(selection);
+    return _selection_store_polygon(selection, polygon, vertex_count) ? 0 : -1;
+}
+
+
+
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+/**
+ * Destroy a region selection and its private GPU runtime.
+ *
+ * @param selection the region selection, or NULL
+ */
+void _scene_region_selection_destroy(DvzSceneRegionSelection* selection)
+{
+    if (selection == NULL)
+        return;
+    if (selection->runtime != NULL)
+        dvz_drp2_runtime_destroy(selection->runtime);
+    dvz_free(selection->mask);
+    dvz_free(selection->gpu_bits);
+    dvz_free(selection->polygon);
+    dvz_free(selection);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Run the region selections of a visual as a GPU compute pass.
+ *
+ * @param visual the visual
+ * @param runtime a device-backed runtime whose backend the pass uses, or NULL for the CPU path
+ * @return 0 on success, -1 on failure
+ */
+DvzResult dvz_visual_set_region_selection_runtime(DvzVisual* visual, DvzDrp2Runtime* runtime)
+{
+    ANN(visual);
+    DvzSceneRegionSelection* selection = _selection_state(visual);
+    if (selection == NULL)
+        return -1;
+    if (runtime == NULL)
+    {
+        if (selection->runtime != NULL)
+            dvz_drp2_runtime_destroy(selection->runtime);
+        selection->runtime = NULL;
+        return 0;
+    }
+
+    DvzDrp2RuntimeConfig cfg = dvz_drp2_runtime_get_config(runtime);
+    if (cfg.semantic_only || cfg.device == NULL)
+    {
+        log_error("region selection compute pass needs a device-backed runtime");
+        return -1;
+    }
+    if (selection->runtime != NULL && selection->runtime_cfg.device == cfg.device &&
+        selection->runtime_cfg.allocator == cfg.allocator)
+    {
+        return 0;
+    }
+    if (selection->runtime != NULL)
+        dvz_drp2_runtime_destroy(selection->runtime);
+    selection->runtime = dvz_drp2_runtime_vklite(&cfg);
+    if (selection->runtime == NULL)
+    {
+        log_error("region selection runtime creation failed");
+        return -1;
+    }
+    selection->runtime_cfg = cfg;
+    selection->gpu_next_id = 0;
+    selection->gpu_pipeline_id = 0;
+    selection->gpu_item_count = 0;
+    selection->gpu_vertex_capacity = 0;
+    return 0;
+}
+
+
+
+/**
+ * Select the items of a visual inside an axis-aligned rectangle.
+ *
+ * @param visual the visual
+ * @param min one rectangle corner in position coordinates
+ * @param max the opposite rectangle corner
+ * @return 0 on success, -1 on failure
+ */
+DvzResult dvz_visual_select_rect(DvzVisual* visual, const double min[2], const double max[2])
+{
+    ANN(visual);
+    ANN(min);
+    ANN(max);
+    double lo[2] = {fmin(min[0], max[0]), fmin(min[1], max[1])};
+    double hi[2] = {fmax(min[0], max[0]), fmax(min[1], max[1])};
+    return _selection_update(visual, lo, hi, NULL, 0);
+}
+
+
+
+/**
+ * Select the items of a visual inside a lasso polygon.
+ *
+ * @param visual the visual
+ * @param polygon polygon vertices as xy pairs in position coordinates
+ * @param vertex_count polygon vertex count, at least 3
+ * @return 0 on success, -1 on failure
+ */
+DvzResult dvz_visual_select_lasso(DvzVisual* visual, const double* polygon, uint32_t vertex_count)
+{
+    ANN(visual);
+    if (polygon == NULL || vertex_count < 3)
+    {
+        log_error("lasso selection needs at least 3 vertices");
+        return -1;
+    }
+    double min[2] = {0}, max[2] = {0};
+    _selection_polygon_bounds(polygon, vertex_count, min, max);
+    return _selection_update(visual, min, max, polygon, vertex_count);
+}
+
+
+
+/**
+ * Clear the region selection of a visual.
+ *
+ * @param visual the visual
+ */
+void dvz_visual_clear_region_selection(DvzVisual* visual)
+{
+    ANN(visual);
+    DvzSceneRegionSelection* selection = visual->region_selection;
+    if (selection == NULL)
+        return;
+    if (selection->mask != NULL)
+    {
+        dvz_memset(
+            selection->mask, selection->word_count * sizeof(uint64_t), 0,
+            selection->word_count * sizeof(uint64_t));
+    }
+    selection->selected_count = 0;
+    selection->vertex_count = 0;
+    selection->last_incremental = false;
+}
+
+
+
+/**
+ * Return the number of items in the region selection of a visual.
+ *
+ * @param visual the visual
+ * @return the number of selected items
+ */
+uint64_t dvz_visual_region_selection_count(const DvzVisual* visual)
+{
+    ANN(visual);
+    return visual->region_selection != NULL ? visual->region_selection->selected_count : 0;
+}
+
+
+
+/**
+ * Return the region selection bitmask of a visual.
+ *
+ * @param visual the visual
+ * @param out_item_count output number of items the mask covers, or NULL
+ * @return the mask, or NULL before the first selection
+ */
+const uint64_t* dvz_visual_region_selection_mask(const DvzVisual* visual, uint64_t* out_item_count)
+{
+    ANN(visual);
+    const DvzSceneRegionSelection* selection = visual->region_selection;
+    bool has_mask = selection != NULL && selection->mask != NULL;
+    if (out_item_count != NULL)
+        *out_item_count = has_mask ? selection->item_count : 0;
+    return has_mask ? selection->mask : NULL;
+}
+
+
+
+/**
+ * Copy the selected item ids of a visual in increasing order.
+ *
+ * @param visual the visual
+ * @param out_items output item ids, or NULL to only count
+ * @param capacity output capacity
+ * @param out_count output number of selected items, which may exceed the capacity
+ * @return 0 on success, -1 on failure
+ */
+DvzResult dvz_visual_region_selection_items(
+    const DvzVisual* visual, uint64_t* out_items, uint64_t capacity, uint64_t* out_count)
+{
+    ANN(visual);
+    ANN(out_count);
+    const DvzSceneRegionSelection* selection = visual->region_selection;
+    *out_count = selection != NULL ? selection->selected_count : 0;
+    if (selection == NULL || selection->mask == NULL || out_items == NULL)
+        return 0;
+    uint64_t written = 0;
+    for (uint64_t w = 0; w < selection->word_count && written < capacity; w++)
+    {
+        for (uint64_t bits = selection->mask[w]; bits != 0 && written < capacity;
+             bits &= bits - 1)
+        {
+            uint64_t bit = 0;
+            while (((bits >> bit) & 1u) == 0)
+                bit++;
+            out_items[written++] = 64 * w + bit;
+        }
+    }
+    return 0;
+}
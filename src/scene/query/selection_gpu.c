@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Scene query region selection compute pass                                                    */
+/*************************************************************************************************/
+
+/* The pass runs on a private runtime sharing the caller's device, like the query executor. One
+ * invocation packs the region bits of 32 items into one word of a storage mask, which is copied
+ * into a mappable buffer and downloaded. Positions are uploaded again only when their attribute
+ * version changes, so successive lasso updates only move the region parameters. */
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "datoviz/drp2/runtime.h"
+#include "datoviz/drp2/stream.h"
+#include "_alloc.h"
+#include "_assertions.h"
+#include "_log.h"
+#include "internal.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define SELECTION_GPU_WORKGROUP_SIZE 64
+#define SELECTION_GPU_MAX_GROUPS     65535
+#define SELECTION_GPU_MIN_VERTICES   64
+
+static const char SELECTION_GLSL[] =
+    "#version 450\n"
+    "layout(local_size_x = 64) in;\n"
+    "layout(std430, set = 0, binding = 0) readonly buffer Params\n"
+    "{\n"
+    "    vec4 bounds;\n"   /* region min xy, max xy */
+    "    uvec4 counts;\n"  /* item count, item range first, item range count, vertex count */
+    "    uvec4 layout_;\n" /* words per dispatch row, mask word count */
+    "    vec2 vertices[];\n"
+    "} params;\n"
+    "layout(std430, set = 0, binding = 1) readonly buffer Positions { float xyz[]; } positions;\n"
+    "layout(std430, set = 0, binding = 2) writeonly buffer Mask { uint bits[]; } mask;\n"
+    "bool edgeCrosses(vec2 a, vec2 b, vec2 p)\n"
+    "{\n"
+    "    if ((a.y > p.y) == (b.y > p.y))\n"
+    "        return false;\n"
+    "    vec2 lo = a.y < b.y ? a : b;\n"
+    "    vec2 hi = a.y < b.y ? b : a;\n"
+    "    float cross = (hi.x - lo.x) * (p.y - lo.y) / (hi.y - lo.y) + lo.x;\n"
+    "    return p.x < clamp(cross, min(lo.x, hi.x), max(lo.x, hi.x));\n"
+    "}\n"
+    "bool inside(vec2 p)\n"
+    "{\n"
+    "    if (any(lessThan(p, params.bounds.xy)) || any(greaterThan(p, params.bounds.zw)))\n"
+    "        return false;\n"
+    "    uint n = params.counts.w;\n"
+    "    if (n == 0u)\n"
+    "        return true;\n"
+    "    bool odd = false;\n"
+    "    for (uint i = 0u, j = n - 1u; i < n; j = i++)\n"
+    "        if (edgeCrosses(params.vertices[j], params.vertices[i], p))\n"
+    "            odd = !odd;\n"
+    "    return odd;\n"
+    "}\n"
+    "void main()\n"
+    "{\n"
+    "    uint word = gl_GlobalInvocationID.y * params.layout_.x + gl_GlobalInvocationID.x;\n"
+    "    if (word >= params.layout_.y)\n"
+    "        return;\n"
+    "    uint bits = 0u;\n"
+    "    uint first = word * 32u;\n"
+    "    uint last = min(first + 32u, params.counts.x);\n"
+    "    for (uint item = first; item < last; item++)\n"
+    "    {\n"
+    "        if (item - params.counts.y >= params.counts.z)\n"
+    "            continue;\n"
+    "        vec2 p = vec2(positions.xyz[3u * item], positions.xyz[3u * item + 1u]);\n"
+    "        if (inside(p))\n"
+    "            bits |= 1u << (item - first);\n"
+    "    }\n"
+    "    mask.bits[word] = bits;\n"
+    "}\n";
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct DvzSelectionGpuParams
+{
+    float bounds[4];
+    uint32_t counts[4];
+    uint32_t layout[4];
+} DvzSelectionGpuParams;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Return the next object id of the selection runtime.
+ *
+ * @param selection the selection state
+ * @return a fresh object id
+ */
+static inline uint64_t _selection_gpu_id(DvzSceneRegionSelection* selection)
+{
+    return ++selection->gpu_next_id;
+}
+
+
+
+/**
+ * Append the pipeline objects of the pass on first use.
+ *
+ * @param selection the selection state
+ * @param stream the command stream
+ * @return whether the commands were appended
+ */
+static bool
+_selection_gpu_pipeline(DvzSceneRegionSelection* selection, DvzDrp2CommandStream* stream)
+{
+    if (selection->gpu_pipeline_id != 0)
+        return true;
+    uint64_t shader_id = _selection_gpu_id(selection);
+    selection->gpu_bgl_id = _selection_gpu_id(selection);
+    selection->gpu_pipeline_id = _selection_gpu_id(selection);
+    DvzDrp2BindGroupLayoutEntry entries[3] = {0};
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        entries[i].binding = i;
+        entries[i].binding_type = DVZ_DRP2_BINDING_TYPE_STORAGE_BUFFER;
+        entries[i].visibility = DVZ_DRP2_SHADER_STAGE_COMPUTE;
+        entries[i].access = i == 2 ? DVZ_DRP2_BINDING_ACCESS_READ_WRITE
+                                   : DVZ_DRP2_BINDING_ACCESS_READ;
+    }
+    return dvz_drp2_stream_create_shader_module_format(
+               stream, shader_id, "COMPUTE", "glsl", SELECTION_GLSL) &&
+           dvz_drp2_stream_create_bind_group_layout_entries(
+               stream, selection->gpu_bgl_id, 3, entries) &&
+           dvz_drp2_stream_create_compute_pipeline_with_bind_group_layout(
+               stream, selection->gpu_pipeline_id, shader_id, selection->gpu_bgl_id);
+}
+
+
+
+/**
+ * Append the buffers and bind group of the pass, replacing them when they are too small.
+ *
+ * @param selection the selection state
+ * @param stream the command stream
+ * @param item_count position count
+ * @param vertex_count region polygon vertex count
+ * @return whether the commands were appended
+ */
+static bool _selection_gpu_buffers(
+    DvzSceneRegionSelection* selection, DvzDrp2CommandStream* stream, uint64_t item_count,
+    uint32_t vertex_count)
+{
+    bool resize_items = selection->gpu_item_count != item_count;
+    bool resize_params = vertex_count > selection->gpu_vertex_capacity;
+    if (!resize_items && !resize_params)
+        return true;
+
+    bool ok = true;
+    if (selection->gpu_bind_group_id != 0)
+        ok = dvz_drp2_stream_destroy_bind_group(stream, selection->gpu_bind_group_id);
+    uint64_t mask_size = selection->word_count * sizeof(uint64_t);
+    if (ok && resize_items)
+    {
+        if (selection->gpu_positions_id != 0)
+        {
+            ok = dvz_drp2_stream_destroy_buffer(stream, selection->gpu_positions_id) &&
+                 dvz_drp2_stream_destroy_buffer(stream, selection->gpu_mask_id) &&
+                 dvz_drp2_stream_destroy_buffer(stream, selection->gpu_readback_id);
+        }
+        selection->gpu_positions_id = _selection_gpu_id(selection);
+        selection->gpu_mask_id = _selection_gpu_id(selection);
+        selection->gpu_readback_id = _selection_gpu_id(selection);
+        ok = ok &&
+             dvz_drp2_stream_create_buffer(
+                 stream, selection->gpu_positions_id, item_count * sizeof(vec3),
+                 DVZ_DRP2_BUFFER_USAGE_STORAGE | DVZ_DRP2_BUFFER_USAGE_COPY_DST) &&
+             dvz_drp2_stream_create_buffer(
+                 stream, selection->gpu_mask_id, mask_size,
+                 DVZ_DRP2_BUFFER_USAGE_STORAGE | DVZ_DRP2_BUFFER_USAGE_COPY_SRC) &&
+             dvz_drp2_stream_create_buffer(
+                 stream, selection->gpu_readback_id, mask_size,
+                 DVZ_DRP2_BUFFER_USAGE_COPY_DST | DVZ_DRP2_BUFFER_USAGE_MAP_READ);
+        selection->gpu_item_count = item_count;
+        selection->gpu_position_version = 0;
+    }
+    if (ok && resize_params)
+    {
+        if (selection->gpu_params_id != 0)
+            ok = dvz_drp2_stream_destroy_buffer(stream, selection->gpu_params_id);
+        uint32_t capacity = selection->gpu_vertex_capacity > 0 ? selection->gpu_vertex_capacity
+                                                               : SELECTION_GPU_MIN_VERTICES;
+        while (capacity < vertex_count)
+            capacity *= 2;
+        selection->gpu_params_id = _selection_gpu_id(selection);
+        selection->gpu_vertex_capacity = capacity;
+        ok = ok && dvz_drp2_stream_create_buffer(
+                       stream, selection->gpu_params_id,
+                       sizeof(DvzSelectionGpuParams) + 2 * capacity * sizeof(float),
+                       DVZ_DRP2_BUFFER_USAGE_STORAGE | DVZ_DRP2_BUFFER_USAGE_COPY_DST);
+    }
+
+    uint64_t buffers[3] = {
+        selection->gpu_params_id, selection->gpu_positions_id, selection->gpu_mask_id};
+    DvzDrp2BindGroupEntry entries[3] = {0};
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        entries[i].binding = i;
+        entries[i].binding_type = DVZ_DRP2_BINDING_TYPE_STORAGE_BUFFER;
+        entries[i].resource_kind = DVZ_DRP2_BINDING_RESOURCE_BUFFER;
+        entries[i].resource_id = buffers[i];
+    }
+    selection->gpu_bind_group_id = _selection_gpu_id(selection);
+    return ok && dvz_drp2_stream_create_bind_group_entries(
+                     stream, selection->gpu_bind_group_id, selection->gpu_bgl_id, 3, entries);
+}
+
+
+
+/**
+ * Append the region parameters of one dispatch.
+ *
+ * @param selection the selection state
+ * @param stream the command stream
+ * @param visual the visual
+ * @param min lower region corner
+ * @param max upper region corner
+ * @param polygon optional polygon as xy pairs, or NULL
+ * @param vertex_count polygon vertex count
+ * @param row_words mask words per dispatch row
+ * @return whether the command was appended
+ */
+static bool _selection_gpu_params(
+    DvzSceneRegionSelection* selection, DvzDrp2CommandStream* stream, const DvzVisual* visual,
+    const double min[2], const double max[2], const double* polygon, uint32_t vertex_count,
+    uint32_t row_words)
+{
+    uint64_t size = sizeof(DvzSelectionGpuParams) + 2 * (uint64_t)vertex_count * sizeof(float);
+    uint8_t* bytes = (uint8_t*)dvz_calloc(1, size);
+    if (bytes == NULL)
+        return false;
+    DvzSelectionGpuParams* params = (DvzSelectionGpuParams*)bytes;
+    params->bounds[0] = (float)min[0];
+    params->bounds[1] = (float)min[1];
+    params->bounds[2] = (float)max[0];
+    params->bounds[3] = (float)max[1];
+    params->counts[0] = (uint32_t)selection->item_count;
+    params->counts[1] = visual->has_item_range ? (uint32_t)visual->item_range_first : 0;
+    params->counts[2] = visual->has_item_range ? (uint32_t)visual->item_range_count
+                                               : (uint32_t)selection->item_count;
+    params->counts[3] = polygon != NULL ? vertex_count : 0;
+    params->layout[0] = row_words;
+    params->layout[1] = (uint32_t)(2 * selection->word_count);
+    float* vertices = (float*)(bytes + sizeof(DvzSelectionGpuParams));
+    for (uint32_t i = 0; polygon != NULL && i < 2 * vertex_count; i++)
+        vertices[i] = (float)polygon[i];
+    bool ok = dvz_drp2_stream_write_buffer_bytes(stream, selection->gpu_params_id, 0, size, bytes);
+    dvz_free(bytes);
+    return ok;
+}
+
+
+
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+/**
+ * Compute the region bits of every position with the selection compute pass.
+ *
+ * The bits are downloaded into `selection->gpu_bits`, one bit per item, set for the drawn items
+ * inside the region.
+ *
+ * @param selection the selection state, with a runtime and a sized mask
+ * @param visual the visual
+ * @param attr the position attribute
+ * @param min lower region corner
+ * @param max upper region corner
+ * @param polygon optional polygon as xy pairs, or NULL
+ * @param vertex_count polygon vertex count
+ * @return true when the pass executed and its bits were downloaded
+ */
+bool _scene_region_selection_gpu_bits(
+    DvzSceneRegionSelection* selection, const DvzVisual* visual, const DvzVisualAttr* attr,
+    const double min[2], const double max[2], const double* polygon, uint32_t vertex_count)
+{
+    ANN(selection);
+    ANN(visual);
+    ANN(attr);
+    if (selection->runtime == NULL || selection->word_count == 0)
+        return false;
+    if (attr->item_count > UINT32_MAX / 3)
+    {
+        log_error("region selection compute pass supports at most %u items", UINT32_MAX / 3);
+        return false;
+    }
+    if (selection->gpu_bits == NULL)
+    {
+        selection->gpu_bits = (uint64_t*)dvz_calloc(selection->word_count, sizeof(uint64_t));
+        if (selection->gpu_bits == NULL)
+            return false;
+    }
+
+    uint32_t word_count = (uint32_t)(2 * selection->word_count);
+    uint32_t groups =
+        (word_count + SELECTION_GPU_WORKGROUP_SIZE - 1) / SELECTION_GPU_WORKGROUP_SIZE;
+    uint32_t groups_x = groups < SELECTION_GPU_MAX_GROUPS ? groups : SELECTION_GPU_MAX_GROUPS;
+    uint32_t groups_y = (groups + groups_x - 1) / groups_x;
+    uint64_t mask_size = selection->word_count * sizeof(uint64_t);
+
+    DvzDrp2CommandStream* stream = dvz_drp2_stream();
+    if (stream == NULL)
+        return false;
+    bool ok = _selection_gpu_pipeline(selection, stream) &&
+              _selection_gpu_buffers(selection, stream, attr->item_count, vertex_count);
+    if (ok && selection->gpu_position_version != attr->version)
+    {
+        ok = dvz_drp2_stream_write_buffer_bytes(
+            stream, selection->gpu_positions_id, 0, attr->item_count * sizeof(vec3), attr->data);
+        selection->gpu_position_version = attr->version;
+    }
+    ok = ok && _selection_gpu_params(
+                   selection, stream, visual, min, max, polygon, vertex_count,
+                   groups_x * SELECTION_GPU_WORKGROUP_SIZE);
+
+    uint64_t encoder_id = _selection_gpu_id(selection);
+    uint64_t pass_id = _selection_gpu_id(selection);
+    uint64_t command_buffer_id = _selection_gpu_id(selection);
+    uint64_t submission_id = _selection_gpu_id(selection);
+    ok = ok && dvz_drp2_stream_begin_command_encoder(stream, encoder_id) &&
+         dvz_drp2_stream_begin_compute_pass(stream, pass_id, encoder_id) &&
+         dvz_drp2_stream_set_pipeline(stream, pass_id, selection->gpu_pipeline_id) &&
+         dvz_drp2_stream_set_bind_group(stream, pass_id, 0, selection->gpu_bind_group_id) &&
+         dvz_drp2_stream_dispatch_workgroups(stream, pass_id, groups_x, groups_y, 1) &&
+         dvz_drp2_stream_end_compute_pass(stream, pass_id) &&
+         dvz_drp2_stream_resource_barrier(
+             stream, encoder_id, selection->gpu_mask_id, "COMPUTE", "STORAGE_WRITE", "COPY",
+             "COPY_READ", 0, mask_size) &&
+         dvz_drp2_stream_copy_buffer_to_buffer(
+             stream, encoder_id, selection->gpu_mask_id, 0, selection->gpu_readback_id, 0,
+             mask_size) &&
+         dvz_drp2_stream_finish_command_encoder(stream, encoder_id, command_buffer_id) &&
+         dvz_drp2_stream_queue_submit_readback(
+             stream, command_buffer_id, submission_id, selection->gpu_readback_id, 0, mask_size);
+
+    if (ok)
+    {
+        DvzDrp2ValidationResult result = dvz_drp2_runtime_execute(selection->runtime, stream);
+        ok = result.ok;
+        if (!ok)
+        {
+            log_error(
+                "region selection compute pass failed (code=%d command=%u)", (int)result.code,
+                result.command_index);
+        }
+    }
+    dvz_drp2_stream_destroy(stream);
+    return ok && dvz_drp2_runtime_download_buffer(
+                     selection->runtime, selection->gpu_readback_id, 0, mask_size,
+                     selection->gpu_bits);
+}
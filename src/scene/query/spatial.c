@@ -0,0 +1,1502 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Scene query CPU spatial index                                                                */
+/*************************************************************************************************/
+
+/* The spatial index answers item picks and region selections on the CPU from the retained dense
+ * positions, so hosts without a cheap GPU readback (headless servers, the WASM bridge) skip the
+ * query render and readback. Point-like visuals use a uniform grid, triangle geometry a BVH. Both
+ * work in the 2D coordinates the positions are expressed in: panel data coordinates for the
+ * default DATA attachment. */
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "_alloc.h"
+#include "_assertions.h"
+#include "_log.h"
+#include "_overflow.h"
+#include "datoviz/scene.h"
+#include "internal.h"
+#include "query_geometry.h"
+#include "registry/registry.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define SPATIAL_GRID_ITEMS_PER_CELL 2
+#define SPATIAL_GRID_MAX_DIM        4096
+#define SPATIAL_NO_CELL             UINT32_MAX
+#define SPATIAL_BVH_LEAF_SIZE       4
+#define SPATIAL_BVH_STACK_SIZE      64
+#define SPATIAL_PICK_TOLERANCE_PX   0.5
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct DvzSpatialPick
+{
+    double point[2];
+    double weight[2];     /* distance units per position unit along x and y */
+    double max_distance;  /* in weighted units, on top of the item radius */
+    const float* sizes;   /* optional per-item diameters in weighted units */
+    bool square;          /* whether items cover a square rather than a disc */
+} DvzSpatialPick;
+
+
+typedef struct DvzSpatialRegion
+{
+    double min[2];
+    double max[2];
+    const double* polygon; /* optional lasso, xy pairs */
+    uint32_t vertex_count;
+    uint64_t* mask;        /* one bit per item id */
+    bool toggle;           /* flip the bits of selected items instead of setting them */
+} DvzSpatialRegion;
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Return the spatial index kind a visual type supports.
+ *
+ * @param type the visual type
+ * @return the index kind, or DVZ_SCENE_SPATIAL_INDEX_NONE
+ */
+static DvzSceneSpatialIndexKind _spatial_kind(DvzVisualType type)
+{
+    switch (type)
+    {
+    case DVZ_VISUAL_TYPE_POINT:
+    case DVZ_VISUAL_TYPE_PIXEL:
+    case DVZ_VISUAL_TYPE_MARKER:
+        return DVZ_SCENE_SPATIAL_INDEX_GRID;
+    case DVZ_VISUAL_TYPE_MESH:
+    case DVZ_VISUAL_TYPE_PRIMITIVE:
+        return DVZ_SCENE_SPATIAL_INDEX_BVH;
+    default:
+        return DVZ_SCENE_SPATIAL_INDEX_NONE;
+    }
+}
+
+
+
+/**
+ * Return whether an item id is drawn under the visual item range.
+ *
+ * @param visual the visual
+ * @param item the item id
+ * @return true when the item is drawn
+ */
+static inline bool _spatial_item_drawn(const DvzVisual* visual, uint64_t item)
+{
+    return !visual->has_item_range ||
+           (item >= visual->item_range_first &&
+            item - visual->item_range_first < visual->item_range_count);
+}
+
+
+
+/**
+ * Return the version of an optional dense attribute, 0 when absent.
+ *
+ * @param visual the visual
+ * @param attr_name attribute name
+ * @return the attribute version
+ */
+static uint64_t _spatial_attr_version(const DvzVisual* visual, const char* attr_name)
+{
+    int attr_idx = _attr_index(visual, attr_name);
+    return attr_idx >= 0 ? visual->attrs[attr_idx].version : 0;
+}
+
+
+
+/**
+ * Return whether a horizontal ray from a point to +x crosses a polygon edge.
+ *
+ * The edge is taken bottom to top and its crossing abscissa is clamped to the edge extent, so the
+ * answer does not depend on the edge direction and never lies outside the polygon bounds. Parities
+ * of polygons sharing edges then combine exactly, which incremental lasso updates rely on.
+ *
+ * @param a first edge vertex
+ * @param b second edge vertex
+ * @param x point x
+ * @param y point y
+ * @return true when the ray crosses the edge
+ */
+static inline bool _spatial_edge_crosses(const double* a, const double* b, double x, double y)
+{
+    if ((a[1] > y) == (b[1] > y))
+        return false;
+    const double* lo = a[1] < b[1] ? a : b;
+    const double* hi = a[1] < b[1] ? b : a;
+    double cross = (hi[0] - lo[0]) * (y - lo[1]) / (hi[1] - lo[1]) + lo[0];
+    cross = fmin(fmax(cross, fmin(lo[0], hi[0])), fmax(lo[0], hi[0]));
+    return x < cross;
+}
+
+
+
+/**
+ * Return whether a point lies inside a selection region.
+ *
+ * @param region the region
+ * @param x point x
+ * @param y point y
+ * @return true when the point is selected
+ */
+static inline bool _spatial_region_contains(const DvzSpatialRegion* region, double x, double y)
+{
+    if (x < region->min[0] || x > region->max[0] || y < region->min[1] || y > region->max[1])
+        return false;
+    return region->polygon == NULL ||
+           _scene_point_in_polygon(region->polygon, region->vertex_count, x, y);
+}
+
+
+
+/*************************************************************************************************/
+/*  Uniform grid                                                                                 */
+/*************************************************************************************************/
+
+/**
+ * Release the grid arrays.
+ *
+ * @param index the spatial index
+ */
+static void _spatial_grid_free(DvzSceneSpatialIndex* index)
+{
+    dvz_free(index->item_cell);
+    dvz_free(index->cell_start);
+    dvz_free(index->cell_items);
+    index->item_cell = NULL;
+    index->cell_start = NULL;
+    index->cell_items = NULL;
+}
+
+
+
+/**
+ * Return the grid cell holding one position.
+ *
+ * Non-finite positions map to SPATIAL_NO_CELL and are never reported.
+ *
+ * @param index the spatial index
+ * @param pos the position
+ * @param out_cell output cell index
+ * @return false when a finite position falls outside the grid bounds
+ */
+static bool
+_spatial_grid_cell(const DvzSceneSpatialIndex* index, const float* pos, uint32_t* out_cell)
+{
+    if (!isfinite(pos[0]) || !isfinite(pos[1]))
+    {
+        *out_cell = SPATIAL_NO_CELL;
+        return true;
+    }
+    double fx = floor(((double)pos[0] - index->origin[0]) / index->cell_size[0]);
+    double fy = floor(((double)pos[1] - index->origin[1]) / index->cell_size[1]);
+    // The upper bound belongs to the last cell.
+    if (fx == (double)index->dims[0])
+        fx -= 1.0;
+    if (fy == (double)index->dims[1])
+        fy -= 1.0;
+    if (fx < 0.0 || fy < 0.0 || fx >= (double)index->dims[0] || fy >= (double)index->dims[1])
+        return false;
+    *out_cell = (uint32_t)fy * index->dims[0] + (uint32_t)fx;
+    return true;
+}
+
+
+
+/**
+ * Bucket the items by cell with a counting sort.
+ *
+ * Items stay in increasing id order inside each cell.
+ *
+ * @param index the spatial index
+ */
+static void _spatial_grid_sort(DvzSceneSpatialIndex* index)
+{
+    uint32_t cell_count = index->dims[0] * index->dims[1];
+    dvz_memset(
+        index->cell_start, (cell_count + 1) * sizeof(uint32_t), 0,
+        (cell_count + 1) * sizeof(uint32_t));
+    for (uint64_t i = 0; i < index->item_count; i++)
+        if (index->item_cell[i] != SPATIAL_NO_CELL)
+            index->cell_start[index->item_cell[i] + 1]++;
+    for (uint32_t c = 0; c < cell_count; c++)
+        index->cell_start[c + 1] += index->cell_start[c];
+    for (uint64_t i = 0; i < index->item_count; i++)
+    {
+        uint32_t cell = index->item_cell[i];
+        if (cell != SPATIAL_NO_CELL)
+            index->cell_items[index->cell_start[cell]++] = (uint32_t)i;
+    }
+    // The fill advanced every start to the next cell's start: shift them back.
+    for (uint32_t c = cell_count; c > 0; c--)
+        index->cell_start[c] = index->cell_start[c - 1];
+    index->cell_start[0] = 0;
+}
+
+
+
+/**
+ * Build the grid from scratch over the position bounds.
+ *
+ * @param index the spatial index
+ * @param attr the dense position attribute
+ * @return true when the grid was built
+ */
+static bool _spatial_grid_build(DvzSceneSpatialIndex* index, const DvzVisualAttr* attr)
+{
+    if (attr->item_count >= UINT32_MAX)
+    {
+        log_error("spatial index supports at most %u items", UINT32_MAX - 1);
+        return false;
+    }
+    uint32_t count = (uint32_t)attr->item_count;
+    const float* pos = (const float*)attr->data;
+
+    double lo[2] = {INFINITY, INFINITY};
+    double hi[2] = {-INFINITY, -INFINITY};
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const float* p = &pos[3 * i];
+        if (!isfinite(p[0]) || !isfinite(p[1]))
+            continue;
+        lo[0] = fmin(lo[0], p[0]);
+        lo[1] = fmin(lo[1], p[1]);
+        hi[0] = fmax(hi[0], p[0]);
+        hi[1] = fmax(hi[1], p[1]);
+    }
+    if (lo[0] > hi[0])
+    {
+        lo[0] = lo[1] = 0.0;
+        hi[0] = hi[1] = 0.0;
+    }
+
+    // Aim for a few items per cell with cells roughly square in position space.
+    double extent[2] = {hi[0] - lo[0], hi[1] - lo[1]};
+    double target = fmax(1.0, (double)count / SPATIAL_GRID_ITEMS_PER_CELL);
+    double nx = 1.0, ny = 1.0;
+    if (extent[0] > 0.0 && extent[1] > 0.0)
+    {
+        nx = ceil(sqrt(target * extent[0] / extent[1]));
+        ny = ceil(target / fmin(nx, SPATIAL_GRID_MAX_DIM));
+    }
+    else if (extent[0] > 0.0)
+        nx = target;
+    else if (extent[1] > 0.0)
+        ny = target;
+    index->dims[0] = (uint32_t)fmax(1.0, fmin(nx, SPATIAL_GRID_MAX_DIM));
+    index->dims[1] = (uint32_t)fmax(1.0, fmin(ny, SPATIAL_GRID_MAX_DIM));
+    for (uint32_t d = 0; d < 2; d++)
+    {
+        index->origin[d] = lo[d];
+        index->cell_size[d] = extent[d] > 0.0 ? extent[d] / index->dims[d] : 1.0;
+    }
+
+    uint32_t cell_count = index->dims[0] * index->dims[1];
+    _spatial_grid_free(index);
+    index->item_cell = (uint32_t*)dvz_calloc(count > 0 ? count : 1, sizeof(uint32_t));
+    index->cell_items = (uint32_t*)dvz_calloc(count > 0 ? count : 1, sizeof(uint32_t));
+    index->cell_start = (uint32_t*)dvz_calloc((uint64_t)cell_count + 1, sizeof(uint32_t));
+    if (index->item_cell == NULL || index->cell_items == NULL || index->cell_start == NULL)
+    {
+        log_error("spatial index allocation failed for %u items", count);
+        _spatial_grid_free(index);
+        return false;
+    }
+
+    index->item_count = count;
+    index->item_bound = count;
+    for (uint32_t i = 0; i < count; i++)
+        (void)_spatial_grid_cell(index, &pos[3 * i], &index->item_cell[i]);
+    _spatial_grid_sort(index);
+    return true;
+}
+
+
+
+/**
+ * Move the items of the noted dirty range to their new cells.
+ *
+ * Items that stay in their cell need no work since queries read positions from the attribute.
+ *
+ * @param index the spatial index
+ * @param attr the dense position attribute
+ * @return false when an item left the grid bounds and the grid must be rebuilt
+ */
+static bool _spatial_grid_update(DvzSceneSpatialIndex* index, const DvzVisualAttr* attr)
+{
+    const float* pos = (const float*)attr->data;
+    uint64_t end = index->dirty_first + index->dirty_count;
+    bool moved = false;
+    for (uint64_t i = index->dirty_first; i < end && i < index->item_count; i++)
+    {
+        uint32_t cell = SPATIAL_NO_CELL;
+        if (!_spatial_grid_cell(index, &pos[3 * i], &cell))
+            return false;
+        if (cell != index->item_cell[i])
+        {
+            index->item_cell[i] = cell;
+            moved = true;
+        }
+    }
+    if (moved)
+        _spatial_grid_sort(index);
+    return true;
+}
+
+
+
+/**
+ * Refresh the largest item radius from the optional size attribute.
+ *
+ * @param visual the visual
+ * @param index the spatial index
+ */
+static void _spatial_grid_sync_radius(const DvzVisual* visual, DvzSceneSpatialIndex* index)
+{
+    const DvzVisualAttr* size_attr = NULL;
+    if (!_dvz_scene_query_dense_attr(visual, "size", sizeof(float), &size_attr))
+    {
+        index->max_radius_px = 0.0f;
+        index->size_version = 0;
+        return;
+    }
+    if (index->size_version == size_attr->version)
+        return;
+    const float* size = (const float*)size_attr->data;
+    float max_size = 0.0f;
+    for (uint64_t i = 0; i < size_attr->item_count; i++)
+        if (isfinite(size[i]) && size[i] > max_size)
+            max_size = size[i];
+    index->max_radius_px = 0.5f * max_size;
+    index->size_version = size_attr->version;
+}
+
+
+
+/**
+ * Find the nearest drawn item in the grid by expanding rings of cells around the pick point.
+ *
+ * @param visual the visual
+ * @param index the spatial index
+ * @param pick the pick parameters
+ * @param out_item output item id
+ * @return true when an item lies within the pick distance
+ */
+static bool _spatial_grid_nearest(
+    const DvzVisual* visual, const DvzSceneSpatialIndex* index, const DvzSpatialPick* pick,
+    uint64_t* out_item)
+{
+    const DvzVisualAttr* attr = NULL;
+    if (!_dvz_scene_query_dense_attr(visual, "position", sizeof(vec3), &attr))
+        return false;
+    const float* pos = (const float*)attr->data;
+
+    int64_t center[2] = {0};
+    for (uint32_t d = 0; d < 2; d++)
+    {
+        double c = floor((pick->point[d] - index->origin[d]) / index->cell_size[d]);
+        c = fmax(0.0, fmin(c, (double)index->dims[d] - 1.0));
+        center[d] = (int64_t)c;
+    }
+    double step = fmin(
+        index->cell_size[0] * pick->weight[0], index->cell_size[1] * pick->weight[1]);
+    double max_radius = pick->sizes != NULL ? index->max_radius_px : 0.0;
+    uint32_t ring_count = index->dims[0] > index->dims[1] ? index->dims[0] : index->dims[1];
+
+    bool found = false;
+    double best = INFINITY;
+    uint64_t best_item = 0;
+    for (int64_t r = 0; r <= (int64_t)ring_count; r++)
+    {
+        // Items in ring r lie at least r-1 cells away from the pick point.
+        double bound = (double)(r > 0 ? r - 1 : 0) * step - max_radius;
+        if (bound > pick->max_distance || (found && bound > best))
+            break;
+        for (int64_t j = center[1] - r; j <= center[1] + r; j++)
+        {
+            if (j < 0 || j >= (int64_t)index->dims[1])
+                continue;
+            bool edge_row = j == center[1] - r || j == center[1] + r;
+            for (int64_t i = center[0] - r; i <= center[0] + r; i += edge_row ? 1 : 2 * r)
+            {
+                if (i >= 0 && i < (int64_t)index->dims[0])
+                {
+                    uint32_t cell = (uint32_t)j * index->dims[0] + (uint32_t)i;
+                    for (uint32_t k = index->cell_start[cell]; k < index->cell_start[cell + 1];
+                         k++)
+                    {
+                        uint32_t item = index->cell_items[k];
+                        if (!_spatial_item_drawn(visual, item))
+                            continue;
+                        double dx = fabs(((double)pos[3 * item + 0] - pick->point[0]) *
+                                         pick->weight[0]);
+                        double dy = fabs(((double)pos[3 * item + 1] - pick->point[1]) *
+                                         pick->weight[1]);
+                        double dist = pick->square ? fmax(dx, dy) : sqrt(dx * dx + dy * dy);
+                        if (pick->sizes != NULL && item < attr->item_count)
+                            dist -= 0.5 * (double)pick->sizes[item];
+                        // Ties resolve to the later item, which is drawn on top.
+                        if (dist <= pick->max_distance &&
+                            (dist < best || (dist == best && item > best_item)))
+                        {
+                            found = true;
+                            best = dist;
+                            best_item = item;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    *out_item = best_item;
+    return found;
+}
+
+
+
+/**
+ * Mark the drawn items of a region in the grid.
+ *
+ * @param visual the visual
+ * @param index the spatial index
+ * @param region the selection region
+ */
+static void _spatial_grid_select(
+    const DvzVisual* visual, const DvzSceneSpatialIndex* index, DvzSpatialRegion* region)
+{
+    const DvzVisualAttr* attr = NULL;
+    if (!_dvz_scene_query_dense_attr(visual, "position", sizeof(vec3), &attr))
+        return;
+    const float* pos = (const float*)attr->data;
+
+    uint32_t lo[2] = {0}, hi[2] = {0};
+    for (uint32_t d = 0; d < 2; d++)
+    {
+        double a = floor((region->min[d] - index->origin[d]) / index->cell_size[d]);
+        double b = floor((region->max[d] - index->origin[d]) / index->cell_size[d]);
+        if (b < 0.0 || a >= (double)index->dims[d])
+            return;
+        lo[d] = (uint32_t)fmax(0.0, a);
+        hi[d] = (uint32_t)fmin(b, (double)index->dims[d] - 1.0);
+    }
+    for (uint32_t j = lo[1]; j <= hi[1]; j++)
+    {
+        for (uint32_t i = lo[0]; i <= hi[0]; i++)
+        {
+            uint32_t cell = j * index->dims[0] + i;
+            for (uint32_t k = index->cell_start[cell]; k < index->cell_start[cell + 1]; k++)
+            {
+                uint32_t item = index->cell_items[k];
+                if (!_spatial_item_drawn(visual, item) ||
+                    !_spatial_region_contains(region, pos[3 * item + 0], pos[3 * item + 1]))
+                {
+                    continue;
+                }
+                if (region->toggle)
+                    region->mask[item / 64] ^= 1ull << (item % 64);
+                else
+                    region->mask[item / 64] |= 1ull << (item % 64);
+            }
+        }
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Triangle BVH                                                                                 */
+/*************************************************************************************************/
+
+/**
+ * Release the BVH arrays.
+ *
+ * @param index the spatial index
+ */
+static void _spatial_bvh_free(DvzSceneSpatialIndex* index)
+{
+    dvz_free(index->triangles);
+    dvz_free(index->triangle_items);
+    dvz_free(index->triangle_order);
+    dvz_free(index->nodes);
+    index->triangles = NULL;
+    index->triangle_items = NULL;
+    index->triangle_order = NULL;
+    index->nodes = NULL;
+    index->node_count = 0;
+}
+
+
+
+/**
+ * Expand the visual geometry into a triangle soup with per-triangle item ids.
+ *
+ * The expansion reuses the GPU query geometry so that CPU and GPU picks report the same ids:
+ * primitive index for primitives, instance index for instanced meshes, 0 for plain meshes.
+ *
+ * @param visual the visual
+ * @param index the spatial index, whose triangle arrays are reused when the count is unchanged
+ * @return true when the soup was written
+ */
+static bool _spatial_bvh_soup(const DvzVisual* visual, DvzSceneSpatialIndex* index)
+{
+    DvzSceneQueryScratch scratch = {0};
+    uint64_t vertex_count = 0;
+    uint32_t topology = 0;
+    bool ok = visual->type == DVZ_VISUAL_TYPE_MESH
+                  ? _scene_query_mesh_item_geometry(
+                        "spatial index", visual, &scratch, &vertex_count, &topology)
+                  : _scene_query_indexed_primitive_geometry(
+                        "spatial index", visual, &scratch, &vertex_count, &topology);
+    if (!ok)
+        return false;
+    if (topology != DVZ_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST)
+    {
+        log_error("spatial index requires triangle geometry");
+        _scene_query_scratch_destroy(&scratch);
+        return false;
+    }
+
+    uint64_t count = vertex_count / 3;
+    if (index->triangles == NULL || count != index->item_count)
+    {
+        _spatial_bvh_free(index);
+        index->triangles = (float*)dvz_calloc(count, 6 * sizeof(float));
+        index->triangle_items = (uint32_t*)dvz_calloc(count, sizeof(uint32_t));
+        if (index->triangles == NULL || index->triangle_items == NULL)
+        {
+            log_error("spatial index allocation failed for %" PRIu64 " triangles", count);
+            _spatial_bvh_free(index);
+            _scene_query_scratch_destroy(&scratch);
+            return false;
+        }
+    }
+    uint64_t item_bound = 0;
+    for (uint64_t t = 0; t < count; t++)
+    {
+        for (uint32_t v = 0; v < 3; v++)
+        {
+            index->triangles[6 * t + 2 * v + 0] = scratch.query_positions[3 * t + v][0];
+            index->triangles[6 * t + 2 * v + 1] = scratch.query_positions[3 * t + v][1];
+        }
+        index->triangle_items[t] = scratch.query_ids[3 * t] - 1u;
+        if (index->triangle_items[t] >= item_bound)
+            item_bound = (uint64_t)index->triangle_items[t] + 1;
+    }
+    index->item_count = count;
+    index->item_bound = item_bound;
+    _scene_query_scratch_destroy(&scratch);
+    return true;
+}
+
+
+
+/**
+ * Return the xy bounds of one triangle.
+ *
+ * @param tri the triangle corners
+ * @param out_min output lower corner
+ * @param out_max output upper corner
+ */
+static void _spatial_triangle_bounds(const float* tri, float* out_min, float* out_max)
+{
+    for (uint32_t d = 0; d < 2; d++)
+    {
+        out_min[d] = fminf(tri[d], fminf(tri[2 + d], tri[4 + d]));
+        out_max[d] = fmaxf(tri[d], fmaxf(tri[2 + d], tri[4 + d]));
+    }
+}
+
+
+
+/**
+ * Recompute every node box bottom-up without changing the tree topology.
+ *
+ * Children are always stored after their parent, so a reverse sweep visits them first.
+ *
+ * @param index the spatial index
+ */
+static void _spatial_bvh_refit(DvzSceneSpatialIndex* index)
+{
+    for (uint32_t n = index->node_count; n > 0; n--)
+    {
+        DvzSceneSpatialNode* node = &index->nodes[n - 1];
+        node->min[0] = node->min[1] = INFINITY;
+        node->max[0] = node->max[1] = -INFINITY;
+        for (uint32_t c = 0; c < (node->count > 0 ? node->count : 2); c++)
+        {
+            float lo[2], hi[2];
+            if (node->count > 0)
+            {
+                uint32_t tri = index->triangle_order[node->first + c];
+                _spatial_triangle_bounds(&index->triangles[6 * tri], lo, hi);
+            }
+            else
+            {
+                const DvzSceneSpatialNode* child = &index->nodes[node->first + c];
+                lo[0] = child->min[0], lo[1] = child->min[1];
+                hi[0] = child->max[0], hi[1] = child->max[1];
+            }
+            for (uint32_t d = 0; d < 2; d++)
+            {
+                node->min[d] = fminf(node->min[d], lo[d]);
+                node->max[d] = fmaxf(node->max[d], hi[d]);
+            }
+        }
+    }
+}
+
+
+
+/**
+ * Partially order a slot range so the k-th smallest centroid lands at slot k.
+ *
+ * @param order triangle order
+ * @param centroid per-triangle centroids, xy pairs
+ * @param axis split axis
+ * @param first first slot
+ * @param last one past the last slot
+ * @param k target slot
+ */
+static void _spatial_bvh_select(
+    uint32_t* order, const float* centroid, uint32_t axis, uint32_t first, uint32_t last,
+    uint32_t k)
+{
+    int64_t lo = first, hi = (int64_t)last - 1, target = k;
+    while (lo < hi)
+    {
+        float pivot = centroid[2 * order[lo + (hi - lo) / 2] + axis];
+        int64_t i = lo, j = hi;
+        while (i <= j)
+        {
+            while (centroid[2 * order[i] + axis] < pivot)
+                i++;
+            while (centroid[2 * order[j] + axis] > pivot)
+                j--;
+            if (i <= j)
+            {
+                uint32_t tmp = order[i];
+                order[i] = order[j];
+                order[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+        if (target <= j)
+            hi = j;
+        else if (target >= i)
+            lo = i;
+        else
+            return;
+    }
+}
+
+
+
+/**
+ * Build the BVH topology with median splits along the widest centroid axis.
+ *
+ * @param index the spatial index with a fresh triangle soup
+ * @return true when the tree was built
+ */
+static bool _spatial_bvh_build(DvzSceneSpatialIndex* index)
+{
+    if (index->item_count == 0 || index->item_count >= UINT32_MAX / 2)
+    {
+        log_error("spatial index needs between 1 and %u triangles", UINT32_MAX / 2 - 1);
+        return false;
+    }
+    uint32_t count = (uint32_t)index->item_count;
+    dvz_free(index->triangle_order);
+    dvz_free(index->nodes);
+    index->triangle_order = (uint32_t*)dvz_calloc(count, sizeof(uint32_t));
+    index->nodes = (DvzSceneSpatialNode*)dvz_calloc(2 * count, sizeof(DvzSceneSpatialNode));
+    float* centroid = (float*)dvz_calloc(count, 2 * sizeof(float));
+    if (index->triangle_order == NULL || index->nodes == NULL || centroid == NULL)
+    {
+        log_error("spatial index allocation failed for %u triangles", count);
+        dvz_free(centroid);
+        return false;
+    }
+    for (uint32_t t = 0; t < count; t++)
+    {
+        const float* tri = &index->triangles[6 * t];
+        index->triangle_order[t] = t;
+        centroid[2 * t + 0] = (tri[0] + tri[2] + tri[4]) / 3.0f;
+        centroid[2 * t + 1] = (tri[1] + tri[3] + tri[5]) / 3.0f;
+    }
+
+    uint32_t stack[SPATIAL_BVH_STACK_SIZE] = {0};
+    uint32_t depth = 0;
+    index->node_count = 1;
+    index->nodes[0] = (DvzSceneSpatialNode){.first = 0, .count = count};
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        DvzSceneSpatialNode* node = &index->nodes[stack[--depth]];
+        if (node->count <= SPATIAL_BVH_LEAF_SIZE || depth + 2 > SPATIAL_BVH_STACK_SIZE)
+            continue;
+        float lo[2] = {INFINITY, INFINITY}, hi[2] = {-INFINITY, -INFINITY};
+        for (uint32_t s = node->first; s < node->first + node->count; s++)
+        {
+            for (uint32_t d = 0; d < 2; d++)
+            {
+                lo[d] = fminf(lo[d], centroid[2 * index->triangle_order[s] + d]);
+                hi[d] = fmaxf(hi[d], centroid[2 * index->triangle_order[s] + d]);
+            }
+        }
+        uint32_t axis = hi[0] - lo[0] >= hi[1] - lo[1] ? 0 : 1;
+        uint32_t half = node->count / 2;
+        _spatial_bvh_select(
+            index->triangle_order, centroid, axis, node->first, node->first + node->count,
+            node->first + half);
+
+        uint32_t left = index->node_count;
+        index->nodes[left] = (DvzSceneSpatialNode){.first = node->first, .count = half};
+        index->nodes[left + 1] = (DvzSceneSpatialNode){
+            .first = node->first + half, .count = node->count - half};
+        index->node_count += 2;
+        node->first = left;
+        node->count = 0;
+        stack[depth++] = left;
+        stack[depth++] = left + 1;
+    }
+    dvz_free(centroid);
+    _spatial_bvh_refit(index);
+    return true;
+}
+
+
+
+/**
+ * Return the distance from the origin to a triangle, 0 when the origin is inside.
+ *
+ * @param a first corner
+ * @param b second corner
+ * @param c third corner
+ * @return the distance
+ */
+static double _spatial_triangle_distance(const double* a, const double* b, const double* c)
+{
+    double ab = a[0] * b[1] - a[1] * b[0];
+    double bc = b[0] * c[1] - b[1] * c[0];
+    double ca = c[0] * a[1] - c[1] * a[0];
+    if ((ab >= 0 && bc >= 0 && ca >= 0) || (ab <= 0 && bc <= 0 && ca <= 0))
+        return 0.0;
+    const double* edges[3][2] = {{a, b}, {b, c}, {c, a}};
+    double best = INFINITY;
+    for (uint32_t e = 0; e < 3; e++)
+    {
+        const double* p = edges[e][0];
+        const double* q = edges[e][1];
+        double dx = q[0] - p[0], dy = q[1] - p[1];
+        double len2 = dx * dx + dy * dy;
+        double t = len2 > 0.0 ? -(p[0] * dx + p[1] * dy) / len2 : 0.0;
+        t = fmax(0.0, fmin(1.0, t));
+        double x = p[0] + t * dx, y = p[1] + t * dy;
+        best = fmin(best, sqrt(x * x + y * y));
+    }
+    return best;
+}
+
+
+
+/**
+ * Find the triangle nearest to the pick point.
+ *
+ * @param visual the visual
+ * @param index the spatial index
+ * @param pick the pick parameters
+ * @param out_triangle output triangle index
+ * @return true when a drawn triangle lies within the pick distance
+ */
+static bool _spatial_bvh_nearest(
+    const DvzVisual* visual, const DvzSceneSpatialIndex* index, const DvzSpatialPick* pick,
+    uint64_t* out_triangle)
+{
+    bool found = false;
+    double best = INFINITY;
+    uint32_t best_tri = 0;
+    uint32_t stack[SPATIAL_BVH_STACK_SIZE] = {0};
+    uint32_t depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        const DvzSceneSpatialNode* node = &index->nodes[stack[--depth]];
+        double gap[2] = {0};
+        for (uint32_t d = 0; d < 2; d++)
+        {
+            double p = pick->point[d];
+            gap[d] = fmax(0.0, fmax(node->min[d] - p, p - node->max[d])) * pick->weight[d];
+        }
+        double bound = sqrt(gap[0] * gap[0] + gap[1] * gap[1]);
+        if (bound > pick->max_distance || (found && bound > best))
+            continue;
+        if (node->count == 0)
+        {
+            stack[depth++] = node->first;
+            stack[depth++] = node->first + 1;
+            continue;
+        }
+        for (uint32_t s = node->first; s < node->first + node->count; s++)
+        {
+            uint32_t tri = index->triangle_order[s];
+            if (!_spatial_item_drawn(visual, index->triangle_items[tri]))
+                continue;
+            double corner[3][2];
+            for (uint32_t v = 0; v < 3; v++)
+                for (uint32_t d = 0; d < 2; d++)
+                    corner[v][d] =
+                        ((double)index->triangles[6 * tri + 2 * v + d] - pick->point[d]) *
+                        pick->weight[d];
+            double dist = _spatial_triangle_distance(corner[0], corner[1], corner[2]);
+            // Ties resolve to the later triangle, which is drawn on top.
+            if (dist <= pick->max_distance && (dist < best || (dist == best && tri > best_tri)))
+            {
+                found = true;
+                best = dist;
+                best_tri = tri;
+            }
+        }
+    }
+    *out_triangle = best_tri;
+    return found;
+}
+
+
+
+/**
+ * Mark the items owning a triangle whose centroid lies in a region.
+ *
+ * @param visual the visual
+ * @param index the spatial index
+ * @param region the selection region
+ */
+static void _spatial_bvh_select_region(
+    const DvzVisual* visual, const DvzSceneSpatialIndex* index, DvzSpatialRegion* region)
+{
+    uint32_t stack[SPATIAL_BVH_STACK_SIZE] = {0};
+    uint32_t depth = 0;
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        const DvzSceneSpatialNode* node = &index->nodes[stack[--depth]];
+        if (node->max[0] < region->min[0] || node->min[0] > region->max[0] ||
+            node->max[1] < region->min[1] || node->min[1] > region->max[1])
+        {
+            continue;
+        }
+        if (node->count == 0)
+        {
+            stack[depth++] = node->first;
+            stack[depth++] = node->first + 1;
+            continue;
+        }
+        for (uint32_t s = node->first; s < node->first + node->count; s++)
+        {
+            uint32_t tri = index->triangle_order[s];
+            uint32_t item = index->triangle_items[tri];
+            const float* t = &index->triangles[6 * tri];
+            double cx = ((double)t[0] + t[2] + t[4]) / 3.0;
+            double cy = ((double)t[1] + t[3] + t[5]) / 3.0;
+            if (_spatial_item_drawn(visual, item) && _spatial_region_contains(region, cx, cy))
+                region->mask[item / 64] |= 1ull << (item % 64);
+        }
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Index maintenance                                                                            */
+/*************************************************************************************************/
+
+/**
+ * Bring the spatial index of a visual in line with its retained geometry.
+ *
+ * The grid moves only the items of the noted dirty ranges to their new cells and rebuilds on a
+ * full upload, a count change, or an item leaving the bounds. The BVH keeps its topology and
+ * refits its boxes while the triangle count and index buffer stay the same.
+ *
+ * @param visual the visual
+ * @return true when the index is ready for queries
+ */
+static bool _spatial_index_refresh(DvzVisual* visual)
+{
+    DvzSceneSpatialIndex* index = visual->spatial_index;
+    ANN(index);
+    const DvzVisualAttr* attr = NULL;
+    if (!_dvz_scene_query_dense_attr(visual, "position", sizeof(vec3), &attr))
+        return false;
+
+    if (index->kind == DVZ_SCENE_SPATIAL_INDEX_GRID)
+    {
+        bool current = index->built && index->item_count == attr->item_count;
+        if (current && attr->version == index->position_version)
+        {
+            _spatial_grid_sync_radius(visual, index);
+            return true;
+        }
+        bool updated = current && attr->version == index->noted_version &&
+                       _spatial_grid_update(index, attr);
+        if (!updated && !_spatial_grid_build(index, attr))
+        {
+            index->built = false;
+            return false;
+        }
+        _spatial_grid_sync_radius(visual, index);
+    }
+    else
+    {
+        DvzVisualFamilyState* state = _visual_family_state(visual);
+        const DvzSceneBuffer* buffer = state != NULL ? state->buffer : NULL;
+        uint64_t index_revision = buffer != NULL ? buffer->content_revision : 0;
+        uint64_t instance_version = _spatial_attr_version(visual, "instance_transform");
+        uint32_t topology = state != NULL ? (uint32_t)state->topology : 0;
+        bool same_shape = index->built && index->index_buffer == buffer &&
+                          index->index_revision == index_revision &&
+                          index->instance_version == instance_version &&
+                          index->topology == topology;
+        if (same_shape && attr->version == index->position_version)
+            return true;
+        uint64_t previous_count = index->built ? index->item_count : 0;
+        if (!_spatial_bvh_soup(visual, index))
+        {
+            index->built = false;
+            return false;
+        }
+        if (same_shape && index->item_count == previous_count && index->nodes != NULL)
+            _spatial_bvh_refit(index);
+        else if (!_spatial_bvh_build(index))
+        {
+            index->built = false;
+            return false;
+        }
+        index->index_buffer = buffer;
+        index->index_revision = index_revision;
+        index->instance_version = instance_version;
+        index->topology = topology;
+    }
+    index->built = true;
+    index->position_version = attr->version;
+    index->noted_version = attr->version;
+    index->dirty_first = 0;
+    index->dirty_count = 0;
+    return true;
+}
+
+
+
+/**
+ * Fill the identity fields of a spatial hit.
+ *
+ * @param visual the visual
+ * @param index the spatial index
+ * @param slot the hit item (grid) or triangle (BVH)
+ * @param data_space whether visual positions are panel data coordinates
+ * @param out_result output result
+ */
+static void _spatial_fill_hit(
+    const DvzVisual* visual, const DvzSceneSpatialIndex* index, uint64_t slot, bool data_space,
+    DvzQueryResult* out_result)
+{
+    uint64_t item_id = slot;
+    if (index->kind == DVZ_SCENE_SPATIAL_INDEX_BVH)
+    {
+        item_id = index->triangle_items[slot];
+        out_result->primitive_id = slot;
+    }
+    out_result->status = DVZ_QUERY_STATUS_HIT;
+    out_result->hit = true;
+    out_result->visual_id = _scene_visual_public_id(visual->scene, visual);
+    out_result->visual_family = visual->ops != NULL ? visual->ops->family : 0;
+    out_result->payload_version = 1;
+    out_result->raw_target = DVZ_SCENE_TARGET_ITEM;
+    out_result->raw_id = item_id;
+    out_result->resolved_target = DVZ_SCENE_TARGET_ITEM;
+    out_result->resolved_id = item_id;
+    out_result->item_id = item_id;
+    out_result->value_kind = DVZ_QUERY_VALUE_NONE;
+    if (visual->link_keys != NULL && item_id < visual->link_key_count)
+        out_result->link_key = visual->link_keys[item_id];
+
+    const DvzVisualAttr* attr = NULL;
+    if (index->kind == DVZ_SCENE_SPATIAL_INDEX_GRID &&
+        _dvz_scene_query_dense_attr(visual, "position", sizeof(vec3), &attr))
+    {
+        const float* pos = &((const float*)attr->data)[3 * slot];
+        out_result->has_visual_position = true;
+        out_result->has_data_position = data_space;
+        for (uint32_t d = 0; d < 3; d++)
+        {
+            out_result->visual_position[d] = pos[d];
+            if (data_space)
+                out_result->data_position[d] = pos[d];
+        }
+    }
+}
+
+
+
+/**
+ * Select the drawn items of a region and report them as sorted item ids.
+ *
+ * @param visual the visual
+ * @param region the region, whose mask is allocated here
+ * @param out_items output item ids, or NULL
+ * @param capacity output capacity
+ * @param out_count output number of selected items, which may exceed the capacity
+ * @return 0 on success, -1 on failure
+ */
+static DvzResult _spatial_select(
+    DvzVisual* visual, DvzSpatialRegion* region, uint64_t* out_items, uint64_t capacity,
+    uint64_t* out_count)
+{
+    *out_count = 0;
+    if (!_spatial_index_refresh(visual))
+        return -1;
+    DvzSceneSpatialIndex* index = visual->spatial_index;
+    uint64_t word_count = (index->item_bound + 63) / 64;
+    if (word_count == 0)
+        return 0;
+    region->mask = (uint64_t*)dvz_calloc(word_count, sizeof(uint64_t));
+    if (region->mask == NULL)
+    {
+        log_error("spatial selection allocation failed for %" PRIu64 " items", index->item_bound);
+        return -1;
+    }
+    if (index->kind == DVZ_SCENE_SPATIAL_INDEX_GRID)
+        _spatial_grid_select(visual, index, region);
+    else
+        _spatial_bvh_select_region(visual, index, region);
+
+    uint64_t count = 0;
+    for (uint64_t w = 0; w < word_count; w++)
+    {
+        for (uint64_t bits = region->mask[w]; bits != 0; bits &= bits - 1)
+        {
+            if (out_items != NULL && count < capacity)
+            {
+                uint64_t bit = 0;
+                while (((bits >> bit) & 1u) == 0)
+                    bit++;
+                out_items[count] = 64 * w + bit;
+            }
+            count++;
+        }
+    }
+    dvz_free(region->mask);
+    region->mask = NULL;
+    *out_count = count;
+    return 0;
+}
+
+
+
+/**
+ * Return the visual spatial index, logging when it was not enabled.
+ *
+ * @param visual the visual
+ * @return the spatial index, or NULL
+ */
+static DvzSceneSpatialIndex* _spatial_index_required(const DvzVisual* visual)
+{
+    if (visual->spatial_index == NULL)
+        log_error("visual has no spatial index, call dvz_visual_set_spatial_index() first");
+    return visual->spatial_index;
+}
+
+
+
+/*************************************************************************************************/
+/*  Internal functions                                                                           */
+/*************************************************************************************************/
+
+/**
+ * Destroy a spatial index.
+ *
+ * @param index the spatial index, or NULL
+ */
+void _scene_spatial_index_destroy(DvzSceneSpatialIndex* index)
+{
+    if (index == NULL)
+        return;
+    _spatial_grid_free(index);
+    _spatial_bvh_free(index);
+    dvz_free(index);
+}
+
+
+
+/**
+ * Record a partial position update so the next query refreshes only that range.
+ *
+ * Updates that do not follow the version the index last saw leave the range untouched, and the
+ * version mismatch then forces a full rebuild.
+ *
+ * @param visual the visual
+ * @param attr the updated attribute
+ * @param previous_version the attribute version before the update
+ * @param first_item first updated item
+ * @param item_count updated item count
+ */
+void _scene_spatial_index_note_range(
+    DvzVisual* visual, const DvzVisualAttr* attr, uint64_t previous_version, uint64_t first_item,
+    uint64_t item_count)
+{
+    ANN(visual);
+    ANN(attr);
+    DvzSceneSpatialIndex* index = visual->spatial_index;
+    if (index == NULL || !index->built || index->noted_version != previous_version)
+        return;
+    int attr_idx = _attr_index(visual, "position");
+    if (attr_idx < 0 || &visual->attrs[attr_idx] != attr)
+        return;
+    if (index->dirty_count == 0)
+    {
+        index->dirty_first = first_item;
+        index->dirty_count = item_count;
+    }
+    else
+    {
+        uint64_t end = index->dirty_first + index->dirty_count;
+        uint64_t new_end = first_item + item_count;
+        index->dirty_first = first_item < index->dirty_first ? first_item : index->dirty_first;
+        index->dirty_count = (new_end > end ? new_end : end) - index->dirty_first;
+    }
+    index->noted_version = attr->version;
+}
+
+
+
+/**
+ * Return whether a point lies inside a polygon with the even-odd rule.
+ *
+ * @param xy polygon vertices as xy pairs
+ * @param count vertex count
+ * @param x point x
+ * @param y point y
+ * @return true when the point is inside
+ */
+bool _scene_point_in_polygon(const double* xy, uint32_t count, double x, double y)
+{
+    ANN(xy);
+    bool inside = false;
+    for (uint32_t i = 0, j = count - 1; i < count; j = i++)
+    {
+        if (_spatial_edge_crosses(&xy[2 * j], &xy[2 * i], x, y))
+            inside = !inside;
+    }
+    return inside;
+}
+
+
+
+/**
+ * Flip the mask bits of the drawn items of a region through the visual uniform grid.
+ *
+ * Only the grid cells overlapping the region bounds are visited, so a small region costs far less
+ * than a scan over every position.
+ *
+ * @param visual the visual
+ * @param min lower region corner
+ * @param max upper region corner
+ * @param polygon optional polygon vertices as xy pairs inside the bounds, or NULL
+ * @param vertex_count polygon vertex count
+ * @param mask the mask to update, one bit per position
+ * @return false when the visual has no usable grid, leaving the mask untouched
+ */
+bool _scene_spatial_index_toggle_region(
+    DvzVisual* visual, const double min[2], const double max[2], const double* polygon,
+    uint32_t vertex_count, uint64_t* mask)
+{
+    ANN(visual);
+    ANN(mask);
+    DvzSceneSpatialIndex* index = visual->spatial_index;
+    if (index == NULL || index->kind != DVZ_SCENE_SPATIAL_INDEX_GRID ||
+        !_spatial_index_refresh(visual))
+    {
+        return false;
+    }
+    DvzSpatialRegion region = {
+        .min = {min[0], min[1]},
+        .max = {max[0], max[1]},
+        .polygon = polygon,
+        .vertex_count = vertex_count,
+        .mask = mask,
+        .toggle = true,
+    };
+    _spatial_grid_select(visual, index, &region);
+    return true;
+}
+
+
+
+/**
+ * Resolve a pending item query on the CPU when the visual carries a spatial index.
+ *
+ * The pointer is mapped into the attachment coordinate space, and the pick tolerance is
+ * converted from logical pixels with the local scale of that mapping. Visuals with a local
+ * transform or normalized panel coordinates keep the GPU path.
+ *
+ * @param figure the figure
+ * @param pending pending query request
+ * @param attach the panel attachment of the candidate visual
+ * @param out_result output result, initialized by the caller
+ * @param out_hit output whether the visual was hit
+ * @return true when the spatial index handled the visual
+ */
+bool _dvz_scene_query_spatial_pick(
+    const DvzFigure* figure, const DvzPendingQueryRequest* pending, const DvzPanelAttach* attach,
+    DvzQueryResult* out_result, bool* out_hit)
+{
+    ANN(figure);
+    ANN(pending);
+    ANN(attach);
+    ANN(out_result);
+    ANN(out_hit);
+    *out_hit = false;
+    DvzVisual* visual = attach->visual;
+    if (visual == NULL || visual->spatial_index == NULL || visual->has_local_transform ||
+        pending->request.target != DVZ_SCENE_TARGET_ITEM)
+    {
+        return false;
+    }
+
+    DvzPanelCoordSpace space = DVZ_PANEL_COORD_DATA;
+    switch (attach->coord_space)
+    {
+    case DVZ_VISUAL_COORD_DATA:
+        space = DVZ_PANEL_COORD_DATA;
+        break;
+    case DVZ_VISUAL_COORD_VIEW:
+        space = DVZ_PANEL_COORD_VIEW;
+        break;
+    case DVZ_VISUAL_COORD_PANEL_PIXEL:
+        space = DVZ_PANEL_COORD_PANEL_PX;
+        break;
+    default:
+        return false;
+    }
+
+    double px[3][2] = {
+        {pending->x, pending->y}, {pending->x + 1.0, pending->y}, {pending->x, pending->y + 1.0}};
+    double pos[3][2] = {{0}};
+    for (uint32_t i = 0; i < 3; i++)
+        if (!dvz_panel_transform_point(
+                pending->panel, DVZ_PANEL_COORD_PANEL_PX, space, px[i], pos[i]))
+            return false;
+    DvzSpatialPick pick = {
+        .point = {pos[0][0], pos[0][1]},
+        .weight = {1.0 / fabs(pos[1][0] - pos[0][0]), 1.0 / fabs(pos[2][1] - pos[0][1])},
+        .max_distance = SPATIAL_PICK_TOLERANCE_PX,
+        .square = visual->type == DVZ_VISUAL_TYPE_PIXEL,
+    };
+    if (!isfinite(pick.weight[0]) || !isfinite(pick.weight[1]))
+        return false;
+    if (!_spatial_index_refresh(visual))
+        return false;
+
+    DvzSceneSpatialIndex* index = visual->spatial_index;
+    const DvzVisualAttr* size_attr = NULL;
+    if (index->kind == DVZ_SCENE_SPATIAL_INDEX_GRID &&
+        _dvz_scene_query_dense_attr(visual, "size", sizeof(float), &size_attr) &&
+        size_attr->item_count >= index->item_count)
+    {
+        pick.sizes = (const float*)size_attr->data;
+    }
+
+    uint64_t slot = 0;
+    *out_hit = index->kind == DVZ_SCENE_SPATIAL_INDEX_GRID
+                   ? _spatial_grid_nearest(visual, index, &pick, &slot)
+                   : _spatial_bvh_nearest(visual, index, &pick, &slot);
+    if (*out_hit)
+        _spatial_fill_hit(visual, index, slot, space == DVZ_PANEL_COORD_DATA, out_result);
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Enable or disable the CPU spatial index of a visual.
+ *
+ * @param visual the visual
+ * @param enabled whether item queries should use the index
+ * @return 0 on success, -1 when the visual type has no spatial index
+ */
+DvzResult dvz_visual_set_spatial_index(DvzVisual* visual, bool enabled)
+{
+    ANN(visual);
+    if (!enabled)
+    {
+        _scene_spatial_index_destroy(visual->spatial_index);
+        visual->spatial_index = NULL;
+        return 0;
+    }
+    DvzSceneSpatialIndexKind kind = _spatial_kind(visual->type);
+    if (kind == DVZ_SCENE_SPATIAL_INDEX_NONE)
+    {
+        log_error("%s visuals have no CPU spatial index", _visual_type_name(visual->type));
+        return -1;
+    }
+    if (visual->spatial_index != NULL)
+        return 0;
+    visual->spatial_index = (DvzSceneSpatialIndex*)dvz_calloc(1, sizeof(DvzSceneSpatialIndex));
+    if (visual->spatial_index == NULL)
+        return -1;
+    visual->spatial_index->kind = kind;
+    return 0;
+}
+
+
+
+/**
+ * Find the item nearest to a point in visual position coordinates.
+ *
+ * @param visual the visual
+ * @param point the point
+ * @param max_distance the largest accepted distance, INFINITY for no limit
+ * @param out_result output result, a HIT or a MISS
+ * @return 0 on success, -1 on failure
+ */
+DvzResult dvz_visual_query_nearest(
+    DvzVisual* visual, const double point[2], double max_distance, DvzQueryResult* out_result)
+{
+    ANN(visual);
+    ANN(point);
+    ANN(out_result);
+    *out_result = (DvzQueryResult){0};
+    DvzSceneSpatialIndex* index = _spatial_index_required(visual);
+    if (index == NULL || isnan(max_distance) || max_distance < 0.0)
+        return -1;
+    if (!_spatial_index_refresh(visual))
+        return -1;
+
+    DvzSpatialPick pick = {
+        .point = {point[0], point[1]},
+        .weight = {1.0, 1.0},
+        .max_distance = max_distance,
+    };
+    uint64_t slot = 0;
+    bool hit = index->kind == DVZ_SCENE_SPATIAL_INDEX_GRID
+                   ? _spatial_grid_nearest(visual, index, &pick, &slot)
+                   : _spatial_bvh_nearest(visual, index, &pick, &slot);
+    out_result->scene_id = dvz_scene_id(visual->scene);
+    out_result->raw_target = DVZ_SCENE_TARGET_ITEM;
+    out_result->resolved_target = DVZ_SCENE_TARGET_ITEM;
+    if (hit)
+        _spatial_fill_hit(visual, index, slot, true, out_result);
+    else
+    {
+        out_result->status = DVZ_QUERY_STATUS_MISS;
+        out_result->visual_id = _scene_visual_public_id(visual->scene, visual);
+    }
+    return 0;
+}
+
+
+
+/**
+ * Select the items inside an axis-aligned rectangle in visual position coordinates.
+ *
+ * @param visual the visual
+ * @param min lower rectangle corner
+ * @param max upper rectangle corner
+ * @param out_items output item ids in increasing order, or NULL to only count
+ * @param capacity output capacity
+ * @param out_count output number of selected items, which may exceed the capacity
+ * @return 0 on success, -1 on failure
+ */
+DvzResult dvz_visual_query_rect(
+    DvzVisual* visual, const double min[2], const double max[2], uint64_t* out_items,
+    uint64_t capacity, uint64_t* out_count)
+{
+    ANN(visual);
+    ANN(min);
+    ANN(max);
+    ANN(out_count);
+    *out_count = 0;
+    if (_spatial_index_required(visual) == NULL)
+        return -1;
+    DvzSpatialRegion region = {
+        .min = {fmin(min[0], max[0]), fmin(min[1], max[1])},
+        .max = {fmax(min[0], max[0]), fmax(min[1], max[1])},
+    };
+    return _spatial_select(visual, &region, out_items, capacity, out_count);
+}
+
+
+
+/**
+ * Select the items inside a lasso polygon in visual position coordinates.
+ *
+ * @param visual the visual
+ * @param polygon polygon vertices as xy pairs
+ * @param vertex_count polygon vertex count, at least 3
+ * @param out_items output item ids in increasing order, or NULL to only count
+ * @param capacity output capacity
+ * @param out_count output number of selected items, which may exceed the capacity
+ * @return 0 on success, -1 on failure
+ */
+DvzResult dvz_visual_query_lasso(
+    DvzVisual* visual, const double* polygon, uint32_t vertex_count, uint64_t* out_items,
+    uint64_t capacity, uint64_t* out_count)
+{
+    ANN(visual);
+    ANN(out_count);
+    *out_count = 0;
+    if (polygon == NULL || vertex_count < 3)
+    {
+        log_error("lasso selection needs at least 3 vertices");
+        return -1;
+    }
+    if (_spatial_index_required(visual) == NULL)
+        return -1;
+    DvzSpatialRegion region = {
+        .min = {INFINITY, INFINITY},
+        .max = {-INFINITY, -INFINITY},
+        .polygon = polygon,
+        .vertex_count = vertex_count,
+    };
+    for (uint32_t i = 0; i < vertex_count; i++)
+    {
+        for (uint32_t d = 0; d < 2; d++)
+        {
+            region.min[d] = fmin(region.min[d], polygon[2 * i + d]);
+            region.max[d] = fmax(region.max[d], polygon[2 * i + d]);
+        }
+    }
+    return _spatial_select(visual, &region, out_items, capacity, out_count);
+}
@@ -85,6 +85,342 @@ bool _contract_validate_graph_backed_render_nodes(
 
 
 
+/*************************************************************************************************/
+/*  Contract memoization                                                                         */
+/*************************************************************************************************/
+
+static uint64_t _contract_hash_u32(uint64_t hash, uint32_t value)
+{
+    for (uint32_t i = 0; i < sizeof(value); i++)
+    {
+        hash ^= (value >> (8u * i)) & 0xffu;
+        hash *= UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+
+
+static uint64_t _contract_hash_str(uint64_t hash, const char* value)
+{
+    ANN(value);
+    for (const char* c = value; *c != '\0'; c++)
+    {
+        hash ^= (uint8_t)*c;
+        hash *= UINT64_C(1099511628211);
+    }
+    return _contract_hash_u32(hash, 0);
+}
+
+
+
+static uint64_t _contract_hash_attachment(uint64_t hash, const DvzFrameGraphAttachment* attachment)
+{
+    ANN(attachment);
+    hash = _contract_hash_str(hash, attachment->resource_id);
+    hash = _contract_hash_u32(hash, (uint32_t)attachment->load_op);
+    hash = _contract_hash_u32(hash, (uint32_t)attachment->store_op);
+    return _contract_hash_u32(hash, (uint32_t)attachment->access);
+}
+
+
+
+/* Hashed lookups of the graph resources and dependencies of one FramePlan, so that a pass hash
+   only visits the entries its pass touches. */
+typedef struct ContractLookup
+{
+    uint32_t resource_mask;
+    uint32_t* resources; /* graph resource index + 1, 0 when empty */
+    uint32_t dependency_mask;
+    uint32_t* dependencies; /* first dependency index + 1 per consumer/resource pair */
+} ContractLookup;
+
+
+
+static uint32_t _contract_lookup_mask(uint32_t count)
+{
+    uint32_t capacity = 16;
+    while (capacity < 2 * count && capacity < (UINT32_C(1) << 30))
+        capacity *= 2;
+    return capacity - 1;
+}
+
+
+
+static uint64_t _contract_dependency_key(const char* consumer_pass_id, const char* resource_id)
+{
+    uint64_t hash = _contract_hash_str(UINT64_C(1469598103934665603), consumer_pass_id);
+    return _contract_hash_str(hash, resource_id);
+}
+
+
+
+/**
+ * Index the graph resources by id and the graph dependencies by consumer pass and resource.
+ *
+ * @param plan the FramePlan
+ * @param lookup the lookup to fill, released by _contract_lookup_destroy()
+ * @return whether the lookup tables were allocated
+ */
+static bool _contract_lookup_init(const DvzFramePlan* plan, ContractLookup* lookup)
+{
+    ANN(plan);
+    ANN(lookup);
+    dvz_memset(lookup, sizeof(*lookup), 0, sizeof(*lookup));
+    uint32_t resource_count = dvz_frame_plan_graph_resource_count(plan);
+    uint32_t dependency_count = dvz_frame_plan_graph_dependency_count(plan);
+    lookup->resource_mask = _contract_lookup_mask(resource_count);
+    lookup->dependency_mask = _contract_lookup_mask(dependency_count);
+    lookup->resources =
+        (uint32_t*)dvz_calloc((size_t)lookup->resource_mask + 1, sizeof(uint32_t));
+    lookup->dependencies =
+        (uint32_t*)dvz_calloc((size_t)lookup->dependency_mask + 1, sizeof(uint32_t));
+    if (lookup->resources == NULL || lookup->dependencies == NULL)
+        return false;
+
+    for (uint32_t i = 0; i < resource_count; i++)
+    {
+        const DvzFrameGraphResource* resource = dvz_frame_plan_graph_resource_get(plan, i);
+        if (resource == NULL)
+            continue;
+        uint32_t slot =
+            (uint32_t)_contract_hash_str(UINT64_C(1469598103934665603), resource->id) &
+            lookup->resource_mask;
+        while (lookup->resources[slot] != 0 &&
+               strcmp(dvz_frame_plan_graph_resource_get(plan, lookup->resources[slot] - 1)->id,
+                      resource->id) != 0)
+            slot = (slot + 1) & lookup->resource_mask;
+        if (lookup->resources[slot] == 0)
+            lookup->resources[slot] = i + 1;
+    }
+
+    DvzFrameGraphDependency dependency = {0};
+    DvzFrameGraphDependency other = {0};
+    for (uint32_t i = 0; i < dependency_count; i++)
+    {
+        if (!dvz_frame_plan_graph_dependency_get(plan, i, &dependency))
+            continue;
+        uint32_t slot = (uint32_t)_contract_dependency_key(
+                            dependency.consumer_pass_id, dependency.resource_id) &
+                        lookup->dependency_mask;
+        while (lookup->dependencies[slot] != 0 &&
+               dvz_frame_plan_graph_dependency_get(
+                   plan, lookup->dependencies[slot] - 1, &other) &&
+               (strcmp(other.consumer_pass_id, dependency.consumer_pass_id) != 0 ||
+                strcmp(other.resource_id, dependency.resource_id) != 0))
+            slot = (slot + 1) & lookup->dependency_mask;
+        if (lookup->dependencies[slot] == 0)
+            lookup->dependencies[slot] = i + 1;
+    }
+    return true;
+}
+
+
+
+static void _contract_lookup_destroy(ContractLookup* lookup)
+{
+    ANN(lookup);
+    dvz_free(lookup->resources);
+    dvz_free(lookup->dependencies);
+    dvz_memset(lookup, sizeof(*lookup), 0, sizeof(*lookup));
+}
+
+
+
+/**
+ * Hash the facts of one graph resource that a pass contract copies into an attachment use.
+ *
+ * @param hash running hash
+ * @param plan the FramePlan
+ * @param lookup the plan lookups
+ * @param resource_id the graph resource id
+ * @return the updated hash
+ */
+static uint64_t _contract_hash_resource(
+    uint64_t hash, const DvzFramePlan* plan, const ContractLookup* lookup,
+    const char* resource_id)
+{
+    ANN(plan);
+    ANN(lookup);
+    ANN(resource_id);
+    hash = _contract_hash_str(hash, resource_id);
+    uint32_t slot =
+        (uint32_t)_contract_hash_str(UINT64_C(1469598103934665603), resource_id) &
+        lookup->resource_mask;
+    while (lookup->resources[slot] != 0)
+    {
+        const DvzFrameGraphResource* resource =
+            dvz_frame_plan_graph_resource_get(plan, lookup->resources[slot] - 1);
+        if (resource != NULL && strcmp(resource->id, resource_id) == 0)
+        {
+            hash = _contract_hash_u32(hash, 1u);
+            hash = _contract_hash_u32(hash, resource->format);
+            hash = _contract_hash_u32(hash, resource->sample_count);
+            return _contract_hash_u32(hash, resource->usage_flags);
+        }
+        slot = (slot + 1) & lookup->resource_mask;
+    }
+    return _contract_hash_u32(hash, 0u);
+}
+
+
+
+/**
+ * Hash the producer that a pass contract records for one sampled read.
+ *
+ * @param hash running hash
+ * @param plan the FramePlan
+ * @param lookup the plan lookups
+ * @param consumer_pass_id the reading graph pass id
+ * @param resource_id the sampled graph resource id
+ * @return the updated hash
+ */
+static uint64_t _contract_hash_read_producer(
+    uint64_t hash, const DvzFramePlan* plan, const ContractLookup* lookup,
+    const char* consumer_pass_id, const char* resource_id)
+{
+    ANN(plan);
+    ANN(lookup);
+    uint32_t slot = (uint32_t)_contract_dependency_key(consumer_pass_id, resource_id) &
+                    lookup->dependency_mask;
+    DvzFrameGraphDependency dependency = {0};
+    while (lookup->dependencies[slot] != 0)
+    {
+        if (dvz_frame_plan_graph_dependency_get(
+                plan, lookup->dependencies[slot] - 1, &dependency) &&
+            strcmp(dependency.consumer_pass_id, consumer_pass_id) == 0 &&
+            strcmp(dependency.resource_id, resource_id) == 0)
+            return _contract_hash_str(hash, dependency.producer_pass_id);
+        slot = (slot + 1) & lookup->dependency_mask;
+    }
+    return _contract_hash_str(hash, "");
+}
+
+
+
+/**
+ * Hash every input of one render pass contract.
+ *
+ * Only the graph resources and dependencies the pass touches are hashed, so a change elsewhere
+ * in the FramePlan leaves the hash, and the memoized validation, of this pass untouched.
+ *
+ * @param plan the FramePlan
+ * @param lookup the plan lookups
+ * @param caps the active capability snapshot, or NULL
+ * @param render the render node
+ * @param graph_pass the matching graph pass
+ * @return the structural hash of the pass contract, never zero
+ */
+static uint64_t _contract_pass_hash(
+    const DvzFramePlan* plan, const ContractLookup* lookup, const DvzCapabilitySnapshot* caps,
+    const DvzFramePlanNode* render, const DvzFrameGraphPass* graph_pass)
+{
+    ANN(plan);
+    ANN(lookup);
+    ANN(render);
+    ANN(graph_pass);
+    uint64_t hash = UINT64_C(1469598103934665603);
+    hash = _contract_hash_u32(hash, caps != NULL ? 1u : 0u);
+    if (caps != NULL)
+    {
+        hash = _contract_hash_u32(hash, caps->max_color_sample_count);
+        hash = _contract_hash_u32(hash, caps->max_depth_sample_count);
+    }
+    hash = _contract_hash_u32(hash, (uint32_t)render->u.render.pass_role);
+    hash = _contract_hash_str(hash, render->u.render.panel_id);
+    hash = _contract_hash_str(hash, graph_pass->id);
+    hash = _contract_hash_u32(hash, render->u.render.visual_count);
+    for (uint32_t i = 0; i < render->u.render.visual_count; i++)
+    {
+        const DvzFramePlanVisualMeta* meta = &render->u.render.visual_metadata[i];
+        hash = _contract_hash_u32(hash, meta->has_metadata ? 1u : 0u);
+        hash = _contract_hash_u32(hash, meta->has_draw_contract ? 1u : 0u);
+        hash = _contract_hash_u32(hash, meta->visual_type);
+        hash = _contract_hash_u32(hash, (uint32_t)meta->alpha_mode);
+        hash = _contract_hash_u32(hash, meta->draw_depth_policy);
+        hash = _contract_hash_u32(hash, meta->draw_blend_policy);
+        hash = _contract_hash_u32(hash, meta->draw_blend_mode);
+        hash = _contract_hash_u32(hash, meta->draw_shader_feature_mask);
+        hash = _contract_hash_u32(hash, meta->draw_bind_group_layout_mask);
+        hash = _contract_hash_u32(hash, meta->draw_overlay_composite ? 1u : 0u);
+        hash = _contract_hash_u32(hash, meta->draw_has_raster_state ? 1u : 0u);
+        hash = _contract_hash_u32(hash, meta->draw_cull_mode);
+        hash = _contract_hash_u32(hash, meta->draw_front_face);
+        hash = _contract_hash_str(hash, meta->draw_volume_occlusion_resource_id);
+        hash = _contract_hash_str(hash, meta->draw_volume_occlusion_producer_pass_id);
+        hash = _contract_hash_u32(hash, meta->draw_volume_occlusion_bind_set);
+        hash = _contract_hash_u32(hash, meta->draw_volume_occlusion_bind_binding);
+        hash = _contract_hash_str(hash, meta->draw_scene_occlusion_resource_id);
+        hash = _contract_hash_str(hash, meta->draw_scene_occlusion_producer_pass_id);
+        hash = _contract_hash_u32(hash, meta->draw_scene_occlusion_bind_set);
+        hash = _contract_hash_u32(hash, meta->draw_scene_occlusion_bind_binding);
+    }
+    hash = _contract_hash_u32(hash, graph_pass->color_attachment_count);
+    for (uint32_t i = 0; i < graph_pass->color_attachment_count; i++)
+    {
+        const DvzFrameGraphAttachment* attachment = &graph_pass->color_attachments[i];
+        hash = _contract_hash_attachment(hash, attachment);
+        hash = _contract_hash_resource(hash, plan, lookup, attachment->resource_id);
+    }
+    hash = _contract_hash_u32(hash, graph_pass->has_depth_attachment ? 1u : 0u);
+    if (graph_pass->has_depth_attachment)
+    {
+        hash = _contract_hash_attachment(hash, &graph_pass->depth_attachment);
+        hash = _contract_hash_resource(
+            hash, plan, lookup, graph_pass->depth_attachment.resource_id);
+    }
+    hash = _contract_hash_u32(hash, graph_pass->read_count);
+    for (uint32_t i = 0; i < graph_pass->read_count; i++)
+    {
+        const char* resource_id = graph_pass->reads[i].resource_id;
+        hash = _contract_hash_resource(hash, plan, lookup, resource_id);
+        hash = _contract_hash_read_producer(hash, plan, lookup, graph_pass->id, resource_id);
+    }
+    return hash != 0 ? hash : 1;
+}
+
+
+
+static bool _contract_memo_contains(const DvzSceneContractMemo* memo, uint64_t hash)
+{
+    ANN(memo);
+    uint32_t mask = DVZ_SCENE_CONTRACT_MEMO_CAPACITY - 1;
+    for (uint32_t probe = 0; probe < DVZ_SCENE_CONTRACT_MEMO_CAPACITY; probe++)
+    {
+        uint64_t entry = memo->hashes[(uint32_t)(hash + probe) & mask];
+        if (entry == hash)
+            return true;
+        if (entry == 0)
+            return false;
+    }
+    return false;
+}
+
+
+
+static void _contract_memo_insert(DvzSceneContractMemo* memo, uint64_t hash)
+{
+    ANN(memo);
+    /* Keep the table at most half full; dropping every entry only costs one revalidation. */
+    if (memo->count >= DVZ_SCENE_CONTRACT_MEMO_CAPACITY / 2)
+        dvz_memset(memo, sizeof(*memo), 0, sizeof(*memo));
+    uint32_t mask = DVZ_SCENE_CONTRACT_MEMO_CAPACITY - 1;
+    for (uint32_t probe = 0; probe < DVZ_SCENE_CONTRACT_MEMO_CAPACITY; probe++)
+    {
+        uint64_t* entry = &memo->hashes[(uint32_t)(hash + probe) & mask];
+        if (*entry == hash)
+            return;
+        if (*entry == 0)
+        {
+            *entry = hash;
+            memo->count++;
+            return;
+        }
+    }
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -92,21 +428,36 @@ bool _contract_validate_graph_backed_render_nodes(
 
 
 /**
- * Validate all graph-backed render contracts in one FramePlan.
+ * Validate all graph-backed render contracts in one FramePlan, memoizing clean validations.
+ *
+ * Each graph-backed pass is keyed by a structural hash of its render node, its graph pass, the
+ * graph resources and dependencies that pass touches, and the capabilities. Passes whose hash
+ * is in the memo skip contract resolution and validation; passes that validate cleanly are
+ * added. This is contract memoization, not plan reuse: the FramePlan and every panel subgraph
+ * are still rebuilt by every emission.
  *
  * @param figure the figure that produced the FramePlan
  * @param plan the completed FramePlan
  * @param caps the active capability snapshot, or NULL to preserve requested sample counts
+ * @param memo optional memo of previously validated contract hashes
  * @param report optional diagnostic report
+ * @param out_pass_count optional number of graph-backed passes checked
+ * @param out_memo_hit_count optional number of passes whose validation was skipped by the memo
  * @return whether all graph-backed render contracts are valid
  */
-bool _scene_frame_plan_contracts_validate_ex(
+bool _scene_frame_plan_contracts_validate_memo(
     const DvzFigure* figure, const DvzFramePlan* plan, const DvzCapabilitySnapshot* caps,
-    DvzDiagnosticReport* report)
+    DvzSceneContractMemo* memo, DvzDiagnosticReport* report, uint32_t* out_pass_count,
+    uint32_t* out_memo_hit_count)
 {
     ANN(figure);
     ANN(plan);
     bool ok = _contract_validate_graph_backed_render_nodes(plan, report);
+    ContractLookup lookup = {0};
+    if (memo != NULL && !_contract_lookup_init(plan, &lookup))
+        memo = NULL;
+    uint32_t pass_count = 0;
+    uint32_t memo_hit_count = 0;
     for (uint32_t i = 0; i < plan->count; i++)
     {
         const DvzFramePlanNode* render = &plan->nodes[i];
@@ -117,6 +468,19 @@ bool _scene_frame_plan_contracts_validate_ex(
         if (graph_pass == NULL)
             continue;
 
+        pass_count++;
+        uint64_t pass_hash = 0;
+        if (memo != NULL)
+        {
+            pass_hash = _contract_pass_hash(plan, &lookup, caps, render, graph_pass);
+            if (_contract_memo_contains(memo, pass_hash))
+            {
+                memo_hit_count++;
+                continue;
+            }
+        }
+        uint32_t report_start = report != NULL ? dvz_diagnostic_report_count(report) : 0;
+
         const DvzPanel* panel = _contract_panel_for_render(figure, plan, render);
         if (panel == NULL)
         {
@@ -141,15 +505,44 @@ bool _scene_frame_plan_contracts_validate_ex(
             dvz_free(contract);
             continue;
         }
-        if (!_scene_pass_contract_validate(contract, report))
-            ok = false;
+        bool pass_ok = _scene_pass_contract_validate(contract, report);
         dvz_free(contract);
+        if (!pass_ok)
+            ok = false;
+        else if (
+            memo != NULL &&
+            (report == NULL || dvz_diagnostic_report_count(report) == report_start))
+            _contract_memo_insert(memo, pass_hash);
     }
+    _contract_lookup_destroy(&lookup);
+    if (out_pass_count != NULL)
+        *out_pass_count = pass_count;
+    if (out_memo_hit_count != NULL)
+        *out_memo_hit_count = memo_hit_count;
     return ok;
 }
 
 
 
+/**
+ * Validate all graph-backed render contracts in one FramePlan.
+ *
+ * @param figure the figure that produced the FramePlan
+ * @param plan the completed FramePlan
+ * @param caps the active capability snapshot, or NULL to preserve requested sample counts
+ * @param report optional diagnostic report
+ * @return whether all graph-backed render contracts are valid
+ */
+bool _scene_frame_plan_contracts_validate_ex(
+    const DvzFigure* figure, const DvzFramePlan* plan, const DvzCapabilitySnapshot* caps,
+    DvzDiagnosticReport* report)
+{
+    return _scene_frame_plan_contracts_validate_memo(
+        figure, plan, caps, NULL, report, NULL, NULL);
+}
+
+
+
 /**
  * Validate all graph-backed render contracts in one FramePlan.
  *
@@ -1207,6 +1207,8 @@ bool _scene_frame_plan_drp2_contracts_validate(
             break;
         case DVZ_DRP2_COMMAND_DRAW:
         case DVZ_DRP2_COMMAND_DRAW_INDEXED:
+        case DVZ_DRP2_COMMAND_DRAW_INDIRECT:
+        case DVZ_DRP2_COMMAND_DRAW_INDEXED_INDIRECT:
             if (active_render == NULL)
                 break;
             if (active_render->u.render.visual_count == 0)
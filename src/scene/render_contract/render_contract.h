@@ -281,5 +281,10 @@ bool _scene_frame_plan_contracts_validate_ex(
     const DvzFigure* figure, const DvzFramePlan* plan, const DvzCapabilitySnapshot* caps,
     DvzDiagnosticReport* report);
 
+bool _scene_frame_plan_contracts_validate_memo(
+    const DvzFigure* figure, const DvzFramePlan* plan, const DvzCapabilitySnapshot* caps,
+    DvzSceneContractMemo* memo, DvzDiagnosticReport* report, uint32_t* out_pass_count,
+    uint32_t* out_memo_hit_count);
+
 bool _scene_frame_plan_drp2_contracts_validate(
     const DvzFramePlan* plan, const DvzDrp2CommandStream* stream, DvzDiagnosticReport* report);
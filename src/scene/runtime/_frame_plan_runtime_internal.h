@@ -81,6 +81,7 @@ struct SceneDrawPacket
     DvzSceneVisualDescKind kind;
     uint64_t pipeline_id;
     uint64_t bg_set0; /* MVP bg; 0 = none */
+    uint64_t set0_offset; /* common uniform ring offset, shared by both set-0 bindings */
     uint64_t bg_set1; /* image texture or material bg; 0 = none */
     uint64_t bg_set2; /* scene occlusion bg; 0 = none */
     uint64_t bg_set3; /* depth-peel sampled bg; 0 = none */
@@ -229,11 +230,11 @@ bool _resolve_item_state_style_bind_group(
 bool _resolve_textured_mesh_bind_group(
     DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, uint64_t bind_group_layout_id,
     uint64_t material_buffer_id, uint64_t panel_light_buffer_id, uint64_t texture_id,
-    uint64_t sampler_id, DvzColorRole color_role, uint64_t* out_id);
+    uint64_t sampler_id, DvzColorRole color_role, const float ring_origin[4], uint64_t* out_id);
 bool _resolve_image_bind_group(
     DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, uint64_t bind_group_layout_id,
     uint64_t texture_id, uint64_t sampler_id, bool nearest, DvzColorRole color_role,
-    uint64_t* out_id);
+    const float ring_origin[4], uint64_t* out_id);
 bool _create_glyph_bind_group_layout(DvzDrp2CommandStream* stream, uint64_t id);
 bool _create_labels_bind_group_layout(DvzDrp2CommandStream* stream, uint64_t id);
 bool _create_volume_bind_group_layout(DvzDrp2CommandStream* stream, uint64_t id);
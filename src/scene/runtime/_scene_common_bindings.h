@@ -37,8 +37,10 @@ bool _scene_common_bindings_resolve_panel_sets(
 bool _scene_common_bindings_resolve_visual_set(
     DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, const DvzFramePlanNode* render,
     DvzSceneWorkProviderKey provider, uint32_t visual_index, uint64_t common_bgl_id,
-    DvzFramePlanViewportRect viewport_rect, uint64_t* out_bg_id);
+    DvzFramePlanViewportRect viewport_rect, uint64_t* out_bg_id, uint64_t* out_offset);
 
 bool _scene_common_bindings_resolve_single_set(
     DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, const DvzFramePlanNode* render,
-    uint64_t* out_bgl_id, uint64_t* out_bg_id);
+    uint64_t* out_bgl_id, uint64_t* out_bg_id, uint64_t* out_offset);
+
+bool _scene_common_bindings_flush(DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream);
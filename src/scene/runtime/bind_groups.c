@@ -618,19 +618,22 @@ bool _resolve_labels_bind_group(
     DvzSceneLabelsUniform* slot = _emitter_labels_slot(emitter, params_slot_key);
     if (slot == NULL)
         return false;
-    _labels_uniform_from_state(&bind->labels_state, slot);
+    DvzSceneLabelsUniform uniform = *slot;
+    _labels_uniform_from_state(&bind->labels_state, &uniform);
     uint32_t lookup_count = bind->labels_lookup_count;
     if (lookup_count > DVZ_SCENE_LABELS_LOOKUP_CAPACITY)
         lookup_count = DVZ_SCENE_LABELS_LOOKUP_CAPACITY;
     for (uint32_t i = 0; i < lookup_count; i++)
     {
-        slot->label_lookup[i][0] = bind->labels_lookup[i][0];
-        slot->label_lookup[i][1] = bind->labels_lookup[i][1];
-        slot->label_lookup[i][2] = bind->labels_lookup[i][2];
-        slot->label_lookup[i][3] = bind->labels_lookup[i][3];
+        uniform.label_lookup[i][0] = bind->labels_lookup[i][0];
+        uniform.label_lookup[i][1] = bind->labels_lookup[i][1];
+        uniform.label_lookup[i][2] = bind->labels_lookup[i][2];
+        uniform.label_lookup[i][3] = bind->labels_lookup[i][3];
     }
+    uint64_t version = _emitter_uniform_store(emitter, slot, &uniform, sizeof(uniform));
     if (!dvz_drp2_stream_write_buffer_bytes(
-            stream, params_buf_id, 0, sizeof(DvzSceneLabelsUniform), slot))
+            stream, params_buf_id, 0, sizeof(DvzSceneLabelsUniform), slot) ||
+        !dvz_drp2_stream_set_payload_version(stream, version))
         return false;
 
     *out_bg_id = bg_id;
@@ -1023,13 +1026,18 @@ bool _resolve_volume_bind_group(
     DvzSceneVolumeUniform* slot = _emitter_volume_slot(emitter, params_slot_key);
     if (slot == NULL)
         return false;
+    DvzSceneVolumeUniform uniform = *slot;
     _volume_uniform_from_state(
         &bind->volume_state, bind->volume_transfer_rgba, bind->volume_color_role,
-        &bind->volume_occlusion, slot);
-    slot->texture_params[1] = bind->sampled_panel_origin[0];
-    slot->texture_params[2] = bind->sampled_panel_origin[1];
+        &bind->volume_occlusion, &uniform);
+    uniform.texture_params[1] = bind->sampled_panel_origin[0];
+    uniform.texture_params[2] = bind->sampled_panel_origin[1];
+    for (uint32_t i = 0; i < 4; i++)
+        uniform.ring_origin[i] = bind->field_ring_origin[i];
+    uint64_t version = _emitter_uniform_store(emitter, slot, &uniform, sizeof(uniform));
     if (!dvz_drp2_stream_write_buffer_bytes(
-            stream, params_buf_id, 0, sizeof(DvzSceneVolumeUniform), slot))
+            stream, params_buf_id, 0, sizeof(DvzSceneVolumeUniform), slot) ||
+        !dvz_drp2_stream_set_payload_version(stream, version))
         return false;
 
     *out_bg_id = bg_id;
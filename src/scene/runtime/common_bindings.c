@@ -15,6 +15,7 @@
 /*************************************************************************************************/
 
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #include "_alloc.h"
@@ -37,6 +38,8 @@
 /**
  * Create the shared scene-common bind group layout.
  *
+ * Both uniforms are bound with dynamic offsets into the common uniform ring.
+ *
  * @param stream the DRP2 command stream
  * @param id the bind group layout id
  * @return whether the command was appended
@@ -52,11 +55,13 @@ static bool _create_common_bind_group_layout(DvzDrp2CommandStream* stream, uint6
             .binding = DVZ_SCENE_SHADER_BINDING_COMMON_MVP,
             .binding_type = DVZ_DRP2_BINDING_TYPE_UNIFORM_BUFFER,
             .visibility = visibility,
+            .has_dynamic_offset = true,
         },
         {
             .binding = DVZ_SCENE_SHADER_BINDING_COMMON_VIEWPORT,
             .binding_type = DVZ_DRP2_BINDING_TYPE_UNIFORM_BUFFER,
             .visibility = visibility,
+            .has_dynamic_offset = true,
         },
     };
     return dvz_drp2_stream_create_bind_group_layout_entries(stream, id, 2, entries);
@@ -176,76 +181,70 @@ static void _mvp_uniform_copy(DvzMVP* dst, const DvzMVP* src)
 
 
 /**
- * Resolve one scene-common bind group for a panel/controller-mode pair.
+ * Build the object keys of the current common ring region.
+ *
+ * @param emitter the persistent emitter
+ * @param ring_key output key of the region uniform buffer
+ * @param bg_key output key of the region bind group
+ */
+static void _common_region_keys(
+    const DvzFramePlanEmitter* emitter, char ring_key[DVZ_SCENE_LABEL_SIZE],
+    char bg_key[DVZ_SCENE_LABEL_SIZE])
+{
+    ANN(emitter);
+    ANN(ring_key);
+    ANN(bg_key);
+    dvz_snprintf(
+        ring_key, DVZ_SCENE_LABEL_SIZE, "%s_r%u", DVZ_SCENE_COMMON_RING_KEY,
+        emitter->common.region);
+    dvz_snprintf(bg_key, DVZ_SCENE_LABEL_SIZE, "_common_ring_bg_r%u", emitter->common.region);
+}
+
+
+
+/**
+ * Resolve the common ring buffer of the current region and its bind group.
+ *
+ * The buffer is recreated under the same id when the region grows; its previous contents are
+ * lost, so the whole allocated range is marked for upload again.
  *
  * @param emitter the persistent emitter
  * @param stream the DRP2 command stream
- * @param render the render node
- * @param provider typed work provider owning the draw
  * @param common_bgl_id the shared common bind group layout id
- * @param mode_tag the controller mode tag
- * @param viewport_rect viewport rectangle selection
- * @param fixed whether the MVP should be identity
- * @param mvp_flags extra MVP flags to OR into the uploaded uniform
- * @param out_bg_id the resolved bind group id
- * @return whether the common bind group was resolved
+ * @param out_bg_id the region bind group id
+ * @return whether the region buffer and its bind group were resolved
  */
-static bool _resolve_common_set(
-    DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, const DvzFramePlanNode* render,
-    uint64_t common_bgl_id, const char* mode_tag, DvzFramePlanViewportRect viewport_rect,
-    bool fixed, uint32_t mvp_flags, const DvzMVP* override_mvp, uint64_t* out_bg_id)
+static bool _resolve_common_ring(
+    DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, uint64_t common_bgl_id,
+    uint64_t* out_bg_id)
 {
     ANN(emitter);
     ANN(stream);
-    ANN(render);
-    ANN(mode_tag);
     ANN(out_bg_id);
 
     *out_bg_id = 0;
-
-    char mvp_buf_key[256], viewport_buf_key[256], bg_key[256];
-    char mvp_slot_key[256], viewport_slot_key[256];
-    const char* viewport_tag =
-        viewport_rect == DVZ_FRAME_PLAN_VIEWPORT_PLOT     ? "plot" :
-        viewport_rect == DVZ_FRAME_PLAN_VIEWPORT_TARGET   ? "target" :
-                                                            "panel";
-    dvz_snprintf(
-        mvp_buf_key, sizeof(mvp_buf_key), "_common_mvp_buf_%s_%s_%s",
-        render->u.render.panel_id, mode_tag, viewport_tag);
-    dvz_snprintf(
-        viewport_buf_key, sizeof(viewport_buf_key), "_common_viewport_buf_%s_%s_%s",
-        render->u.render.panel_id, mode_tag, viewport_tag);
-    dvz_snprintf(
-        bg_key, sizeof(bg_key), "_common_bg_%s_%s_%s", render->u.render.panel_id, mode_tag,
-        viewport_tag);
-    dvz_snprintf(
-        mvp_slot_key, sizeof(mvp_slot_key), "%s_%s_%s", render->u.render.panel_id, mode_tag,
-        viewport_tag);
-    dvz_snprintf(
-        viewport_slot_key, sizeof(viewport_slot_key), "%s_%s_%s", render->u.render.panel_id,
-        mode_tag, viewport_tag);
-
+    DvzSceneCommonRing* ring = &emitter->common;
+    DvzSceneCommonRegion* region = &ring->regions[ring->region];
+    char ring_key[DVZ_SCENE_LABEL_SIZE];
+    char bg_key[DVZ_SCENE_LABEL_SIZE];
+    _common_region_keys(emitter, ring_key, bg_key);
     bool is_new = false;
     uint32_t usage = DVZ_DRP2_BUFFER_USAGE_UNIFORM | DVZ_DRP2_BUFFER_USAGE_MAP_WRITE |
                      DVZ_DRP2_BUFFER_USAGE_COPY_DST;
-
-    uint64_t mvp_buf_id = _obj_id(emitter, mvp_buf_key, &is_new);
-    if (mvp_buf_id == 0)
-        return false;
-    bool mvp_buf_new = is_new;
-    if (mvp_buf_new && !dvz_drp2_stream_create_buffer(
-                           stream, mvp_buf_id, sizeof(DvzMVP), usage))
-        return false;
-
-    uint64_t viewport_buf_id = _obj_id(emitter, viewport_buf_key, &is_new);
-    if (viewport_buf_id == 0)
-        return false;
-    bool viewport_buf_new = is_new;
-    if (viewport_buf_new && !dvz_drp2_stream_create_buffer(
-                                stream, viewport_buf_id,
-                                sizeof(DvzSceneViewportUniform), usage))
+    uint64_t ring_size = (uint64_t)region->capacity * sizeof(DvzSceneCommonUniform);
+    uint64_t ring_id = _obj_buffer_id(emitter, ring_key, ring_size, &is_new);
+    if (ring_id == 0)
         return false;
+    if (is_new)
+    {
+        if (!dvz_drp2_stream_create_buffer(stream, ring_id, ring_size, usage))
+            return false;
+        region->synced = 0;
+        region->dirty_begin = 0;
+        region->dirty_end = DVZ_MAX(region->dirty_end, ring->count);
+    }
 
+    /* DRP2 rebuilds the bind group itself when its buffer is recreated on growth. */
     uint64_t bg_id = _obj_id(emitter, bg_key, &is_new);
     if (bg_id == 0)
         return false;
@@ -256,16 +255,16 @@ static bool _resolve_common_set(
                 .binding = DVZ_SCENE_SHADER_BINDING_COMMON_MVP,
                 .binding_type = DVZ_DRP2_BINDING_TYPE_UNIFORM_BUFFER,
                 .resource_kind = DVZ_DRP2_BINDING_RESOURCE_BUFFER,
-                .resource_id = mvp_buf_id,
-                .offset = 0,
+                .resource_id = ring_id,
+                .offset = offsetof(DvzSceneCommonUniform, mvp),
                 .size = sizeof(DvzMVP),
             },
             {
                 .binding = DVZ_SCENE_SHADER_BINDING_COMMON_VIEWPORT,
                 .binding_type = DVZ_DRP2_BINDING_TYPE_UNIFORM_BUFFER,
                 .resource_kind = DVZ_DRP2_BINDING_RESOURCE_BUFFER,
-                .resource_id = viewport_buf_id,
-                .offset = 0,
+                .resource_id = ring_id,
+                .offset = offsetof(DvzSceneCommonUniform, viewport),
                 .size = sizeof(DvzSceneViewportUniform),
             },
         };
@@ -274,11 +273,63 @@ static bool _resolve_common_set(
             return false;
     }
 
+    *out_bg_id = bg_id;
+    return true;
+}
+
+
+
+/**
+ * Resolve one scene-common ring slot for a panel/controller-mode pair.
+ *
+ * @param emitter the persistent emitter
+ * @param stream the DRP2 command stream
+ * @param render the render node
+ * @param common_bgl_id the shared common bind group layout id
+ * @param mode_tag the controller mode tag
+ * @param viewport_rect viewport rectangle selection
+ * @param fixed whether the MVP should be identity
+ * @param mvp_flags extra MVP flags to OR into the uploaded uniform
+ * @param override_mvp optional visual MVP replacing the panel MVP
+ * @param out_bg_id the bind group of the slot's ring region
+ * @param out_offset the dynamic offset of the slot in its ring region
+ * @return whether the common bind group was resolved
+ */
+static bool _resolve_common_set(
+    DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, const DvzFramePlanNode* render,
+    uint64_t common_bgl_id, const char* mode_tag, DvzFramePlanViewportRect viewport_rect,
+    bool fixed, uint32_t mvp_flags, const DvzMVP* override_mvp, uint64_t* out_bg_id,
+    uint64_t* out_offset)
+{
+    ANN(emitter);
+    ANN(stream);
+    ANN(render);
+    ANN(mode_tag);
+    ANN(out_bg_id);
+    ANN(out_offset);
+
+    *out_bg_id = 0;
+    *out_offset = 0;
+
+    char slot_key[256];
+    const char* viewport_tag =
+        viewport_rect == DVZ_FRAME_PLAN_VIEWPORT_PLOT     ? "plot" :
+        viewport_rect == DVZ_FRAME_PLAN_VIEWPORT_TARGET   ? "target" :
+                                                            "panel";
+    dvz_snprintf(
+        slot_key, sizeof(slot_key), "%s_%s_%s", render->u.render.panel_id, mode_tag,
+        viewport_tag);
+
+    uint32_t slot_index = 0;
+    DvzSceneCommonUniform* slot = _emitter_common_slot(emitter, slot_key, &slot_index);
+    if (slot == NULL)
+        return false;
+    uint64_t bg_id = 0;
+    if (!_resolve_common_ring(emitter, stream, common_bgl_id, &bg_id))
+        return false;
+
     DvzMVP local_identity = {0};
     const DvzMVP* mvp_src = &render->u.render.apply_mvp;
-    DvzMVP* mvp_slot = _emitter_mvp_slot(emitter, mvp_slot_key);
-    if (mvp_slot == NULL)
-        return false;
     if (override_mvp != NULL)
         mvp_src = override_mvp;
     else if (fixed || !render->u.render.has_mvp)
@@ -286,26 +337,14 @@ static bool _resolve_common_set(
         _identity_mvp(&local_identity);
         mvp_src = &local_identity;
     }
-    _mvp_uniform_copy(mvp_slot, mvp_src);
-    mvp_slot->flags |= mvp_flags;
-    mvp_src = mvp_slot;
-
-    DvzSceneViewportUniform local_viewport = {0};
-    _viewport_uniform_from_render(render, viewport_rect, &local_viewport);
-    DvzSceneViewportUniform* viewport_slot =
-        _emitter_viewport_slot(emitter, viewport_slot_key);
-    if (viewport_slot == NULL)
-        return false;
-    *viewport_slot = local_viewport;
-
-    if (!dvz_drp2_stream_write_buffer_bytes(
-            stream, mvp_buf_id, 0, sizeof(DvzMVP), mvp_src))
-        return false;
-    if (!dvz_drp2_stream_write_buffer_bytes(
-            stream, viewport_buf_id, 0, sizeof(DvzSceneViewportUniform), viewport_slot))
-        return false;
+    DvzSceneCommonUniform uniform = *slot;
+    _mvp_uniform_copy(&uniform.mvp, mvp_src);
+    uniform.mvp.flags |= mvp_flags;
+    _viewport_uniform_from_render(render, viewport_rect, &uniform.viewport);
+    _emitter_common_store(emitter, slot_index, &uniform);
 
     *out_bg_id = bg_id;
+    *out_offset = (uint64_t)slot_index * sizeof(DvzSceneCommonUniform);
     return true;
 }
 
@@ -369,20 +408,23 @@ bool _scene_common_bindings_resolve_panel_sets(
  * @param common_bgl_id the shared common bind group layout id
  * @param viewport_rect viewport rectangle selection
  * @param out_bg_id resolved bind group id
+ * @param out_offset dynamic offset of the visual's common ring slot
  * @return whether the common bind group was resolved
  */
 bool _scene_common_bindings_resolve_visual_set(
     DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, const DvzFramePlanNode* render,
     DvzSceneWorkProviderKey provider, uint32_t visual_index, uint64_t common_bgl_id,
-    DvzFramePlanViewportRect viewport_rect, uint64_t* out_bg_id)
+    DvzFramePlanViewportRect viewport_rect, uint64_t* out_bg_id, uint64_t* out_offset)
 {
     ANN(emitter);
     ANN(stream);
     ANN(render);
     ANN(out_bg_id);
+    ANN(out_offset);
     if (visual_index >= render->u.render.visual_count)
     {
         *out_bg_id = 0;
+        *out_offset = 0;
         return false;
     }
 
@@ -405,7 +447,7 @@ bool _scene_common_bindings_resolve_visual_set(
                                                       : NULL;
     return _resolve_common_set(
         emitter, stream, render, common_bgl_id, tag, viewport_rect, fixed, flags, override_mvp,
-        out_bg_id);
+        out_bg_id, out_offset);
 }
 
 
@@ -417,20 +459,23 @@ bool _scene_common_bindings_resolve_visual_set(
  * @param render the render node
  * @param out_bgl_id the shared common bind group layout id
  * @param out_bg_id the resolved common bind group id
+ * @param out_offset the dynamic offset of the common ring slot
  * @return whether the common binding was resolved
  */
 bool _scene_common_bindings_resolve_single_set(
     DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, const DvzFramePlanNode* render,
-    uint64_t* out_bgl_id, uint64_t* out_bg_id)
+    uint64_t* out_bgl_id, uint64_t* out_bg_id, uint64_t* out_offset)
 {
     ANN(emitter);
     ANN(stream);
     ANN(render);
     ANN(out_bgl_id);
     ANN(out_bg_id);
+    ANN(out_offset);
 
     *out_bgl_id = 0;
     *out_bg_id = 0;
+    *out_offset = 0;
 
     bool ok = true;
     bool common_bgl_new = false;
@@ -464,13 +509,58 @@ bool _scene_common_bindings_resolve_single_set(
     char tag[256];
     dvz_snprintf(tag, sizeof(tag), "%s_single_%s", mode_tag, visual_id);
     uint64_t common_bg_id = 0;
+    uint64_t common_offset = 0;
     ok = ok && _resolve_common_set(
                    emitter, stream, render, common_bgl_id, tag, viewport_rect, fixed, mvp_flags,
-                   override_mvp, &common_bg_id);
+                   override_mvp, &common_bg_id, &common_offset);
 
     if (!ok)
         return false;
     *out_bgl_id = common_bgl_id;
     *out_bg_id = common_bg_id;
+    *out_offset = common_offset;
+    return true;
+}
+
+
+
+/**
+ * Upload the common ring slots changed since the last flush with one WriteBuffer.
+ *
+ * Call once all common sets of a submission are resolved, before its command encoder begins.
+ *
+ * @param emitter the persistent emitter
+ * @param stream the DRP2 command stream
+ * @return whether the upload was appended
+ */
+bool _scene_common_bindings_flush(DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream)
+{
+    ANN(emitter);
+    ANN(stream);
+
+    if (emitter->common.region_count == 0)
+        return true;
+    DvzSceneCommonRegion* region = &emitter->common.regions[emitter->common.region];
+    uint32_t begin = region->dirty_begin;
+    uint32_t end = region->dirty_end;
+    region->dirty_begin = 0;
+    region->dirty_end = 0;
+    if (end <= begin)
+        return true;
+
+    char ring_key[DVZ_SCENE_LABEL_SIZE];
+    char bg_key[DVZ_SCENE_LABEL_SIZE];
+    _common_region_keys(emitter, ring_key, bg_key);
+    uint64_t ring_id = _resource_lookup_id(&emitter->objects, ring_key);
+    if (ring_id == 0 ||
+        !dvz_drp2_stream_write_buffer_bytes(
+            stream, ring_id, (uint64_t)begin * sizeof(DvzSceneCommonUniform),
+            (uint64_t)(end - begin) * sizeof(DvzSceneCommonUniform), &region->slots[begin]) ||
+        !dvz_drp2_stream_set_payload_version(stream, emitter->uniform_version))
+        return false;
+
+    /* Slots below the watermark are known to match the mirror on the GPU. */
+    if (begin <= region->synced)
+        region->synced = DVZ_MAX(region->synced, end);
     return true;
 }
@@ -253,6 +253,7 @@ DvzDrp2CommandStream* dvz_frame_plan_emitter_emit_drp2(
         _diagnostic(report, "failed to clone runtime emitter state");
         return NULL;
     }
+    _emitter_common_begin_frame(&candidate, cfg != NULL ? cfg->runtime_resource_scope_id : 0);
 
     DvzDrp2CommandStream* stream =
         _frame_plan_emitter_emit_drp2_candidate(&candidate, plan, caps, report, cfg);
@@ -1058,7 +1058,7 @@ bool _runtime_resolve_texture_2d(
     else if (
         width != resource->texture_width || height != resource->texture_height ||
         resource->texture_depth != 1 || format != resource->texture_format ||
-        sample_count != resource->texture_sample_count)
+        sample_count != resource->texture_sample_count || usage != resource->usage)
     {
         if (emitter->resources.next_id == UINT64_MAX)
             return false;
@@ -1070,6 +1070,7 @@ bool _runtime_resolve_texture_2d(
         resource->texture_sample_count = sample_count;
         is_new = true;
     }
+    resource->usage = usage;
 
     if (is_new)
     {
@@ -1194,7 +1195,21 @@ bool _graph_resolve_texture_2d(
         usage |= _graph_declared_texture_usage_to_drp2(plan, resource->id);
 
     char key[DVZ_SCENE_LABEL_SIZE];
-    _runtime_scope_key(cfg, resource->id, key, sizeof(key));
+    if (resource->alias_slot != 0)
+    {
+        // The slot members have disjoint pass lifetimes and one descriptor: they share the
+        // texture of the slot, created with the usages of all of them.
+        char alias_key[DVZ_SCENE_LABEL_SIZE];
+        dvz_snprintf(alias_key, sizeof(alias_key), "_alias_%" PRIu32, resource->alias_slot);
+        _runtime_scope_key(cfg, alias_key, key, sizeof(key));
+        usage = _graph_texture_usage_to_drp2(resource->alias_usage_flags);
+    }
+    else
+    {
+        _runtime_scope_key(cfg, resource->id, key, sizeof(key));
+    }
+    if (resource->transient)
+        usage |= DVZ_DRP2_TEXTURE_USAGE_TRANSIENT_ATTACHMENT;
     return _runtime_resolve_texture_2d(
         emitter, stream, key, width, height, format, usage,
         _graph_resource_lowered_sample_count(emitter, resource), out_id);
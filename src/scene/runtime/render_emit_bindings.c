@@ -28,10 +28,15 @@
 /*  Functions                                                                                    */
 /*************************************************************************************************/
 
-static void _texture_uniform_from_color_role(DvzColorRole color_role, DvzSceneTextureUniform* out)
+static void _texture_uniform_from_color_role(
+    DvzColorRole color_role, const float ring_origin[4], DvzSceneTextureUniform* out)
 {
     ANN(out);
     out->params[0] = color_role == DVZ_COLOR_ROLE_SRGB_COLOR ? 1.0f : 0.0f;
+    if (ring_origin == NULL)
+        return;
+    out->params[1] = ring_origin[0];
+    out->params[2] = ring_origin[1];
 }
 
 
@@ -142,13 +147,15 @@ bool _create_image_bind_group_layout(DvzDrp2CommandStream* stream, uint64_t id)
  * @param material_buffer_id material uniform buffer id
  * @param texture_id sampled texture id
  * @param sampler_id sampler id
+ * @param color_role sampled texture color role
+ * @param ring_origin normalized field ring origin, or NULL
  * @param out_id resolved bind group id
  * @return whether the bind group exists or was appended
  */
 bool _resolve_textured_mesh_bind_group(
     DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, uint64_t bind_group_layout_id,
     uint64_t material_buffer_id, uint64_t panel_light_buffer_id, uint64_t texture_id, uint64_t sampler_id,
-    DvzColorRole color_role, uint64_t* out_id)
+    DvzColorRole color_role, const float ring_origin[4], uint64_t* out_id)
 {
     ANN(emitter);
     ANN(stream);
@@ -227,7 +234,7 @@ bool _resolve_textured_mesh_bind_group(
     }
 
     DvzSceneTextureUniform uniform = {0};
-    _texture_uniform_from_color_role(color_role, &uniform);
+    _texture_uniform_from_color_role(color_role, ring_origin, &uniform);
     if (!dvz_drp2_stream_write_buffer_bytes(
             stream, params_buf_id, 0, sizeof(DvzSceneTextureUniform), &uniform))
         return false;
@@ -247,13 +254,14 @@ bool _resolve_textured_mesh_bind_group(
  * @param sampler_id sampler id
  * @param nearest whether the sampler uses nearest filtering
  * @param color_role sampled texture color role
+ * @param ring_origin normalized field ring origin, or NULL
  * @param out_id resolved bind group id
  * @return whether the bind group exists or was appended
  */
 bool _resolve_image_bind_group(
     DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, uint64_t bind_group_layout_id,
     uint64_t texture_id, uint64_t sampler_id, bool nearest, DvzColorRole color_role,
-    uint64_t* out_id)
+    const float ring_origin[4], uint64_t* out_id)
 {
     ANN(emitter);
     ANN(stream);
@@ -314,7 +322,7 @@ bool _resolve_image_bind_group(
     }
 
     DvzSceneTextureUniform uniform = {0};
-    _texture_uniform_from_color_role(color_role, &uniform);
+    _texture_uniform_from_color_role(color_role, ring_origin, &uniform);
     if (!dvz_drp2_stream_write_buffer_bytes(
             stream, params_buf_id, 0, sizeof(DvzSceneTextureUniform), &uniform))
         return false;
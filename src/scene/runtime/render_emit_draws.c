@@ -150,6 +150,7 @@ bool _emitter_emit_render_multi_draws(
     DvzPanelDesc active_viewport = viewport;
     uint64_t last_pipeline = (cache != NULL) ? cache->pipeline_id : 0;
     uint64_t last_bg_set0 = (cache != NULL) ? cache->bg_set0 : 0;
+    uint64_t last_set0_offset = (cache != NULL) ? cache->set0_offset : 0;
     uint64_t last_bg_set1 = 0;
     uint64_t last_bg_set2 = 0;
     uint64_t last_bg_set3 = 0;
@@ -186,10 +187,15 @@ bool _emitter_emit_render_multi_draws(
             last_bg_set2 = 0;
             last_bg_set3 = 0;
         }
-        if (draws[d].bg_set0 != 0 && draws[d].bg_set0 != last_bg_set0)
+        if (draws[d].bg_set0 != 0 &&
+            (draws[d].bg_set0 != last_bg_set0 || draws[d].set0_offset != last_set0_offset))
         {
-            ok = ok && dvz_drp2_stream_set_bind_group(stream, render_pass_id, 0, draws[d].bg_set0);
+            /* Set 0 is the common ring: both bindings move to the draw's slot. */
+            uint64_t offsets[2] = {draws[d].set0_offset, draws[d].set0_offset};
+            ok = ok && dvz_drp2_stream_set_bind_group_dynamic(
+                           stream, render_pass_id, 0, draws[d].bg_set0, 2, offsets);
             last_bg_set0 = draws[d].bg_set0;
+            last_set0_offset = draws[d].set0_offset;
         }
         if (draws[d].bg_set1 != 0 && draws[d].bg_set1 != last_bg_set1)
         {
@@ -215,6 +221,7 @@ bool _emitter_emit_render_multi_draws(
     {
         cache->pipeline_id = last_pipeline;
         cache->bg_set0 = last_bg_set0;
+        cache->set0_offset = last_set0_offset;
     }
 
     return ok;
@@ -667,7 +667,7 @@ bool _emitter_emit_render_multi(
         color_target_formats, color_target_count, sampled_depth_id, false, 0, 0, 0, 0, 0, 0,
         pass_sample_count, graph_pass != NULL && graph_pass->alpha_to_coverage, report, draws,
         &draw_count);
-    if (!ok)
+    if (!ok || !_scene_common_bindings_flush(emitter, stream))
         return false;
 
     ok = dvz_drp2_stream_begin_command_encoder(stream, encoder_id) &&
@@ -743,7 +743,7 @@ bool _emitter_emit_scene_figure_renders(
     float ca = cfg ? cfg->clear_color[3] : 1.0f;
 
     SceneRenderBatch* batches =
-        (SceneRenderBatch*)dvz_calloc(plan->count, sizeof(SceneRenderBatch));
+        (SceneRenderBatch*)_frame_plan_calloc(plan, plan->count, sizeof(SceneRenderBatch));
     if (batches == NULL)
         return false;
     uint32_t batch_count = 0;
@@ -769,7 +769,15 @@ bool _emitter_emit_scene_figure_renders(
     {
         if (ok && batch_count == 0)
             _diagnostic(report, "scene figure render prepared no draw batches");
-        dvz_free(batches);
+        _frame_plan_free(plan, batches);
+        return false;
+    }
+
+    /* Every panel's common uniforms go up in one ring upload, ahead of the shared pass. */
+    if (!_scene_common_bindings_flush(emitter, stream))
+    {
+        _diagnostic(report, "scene figure common uniform upload failed");
+        _frame_plan_free(plan, batches);
         return false;
     }
 
@@ -810,7 +818,7 @@ bool _emitter_emit_scene_figure_renders(
         _diagnostic(report, "scene figure render copy/submit failed");
         ok = false;
     }
-    dvz_free(batches);
+    _frame_plan_free(plan, batches);
     return ok;
 }
 
@@ -861,13 +869,13 @@ bool _emitter_emit_scene_graph_renders(
 
     SceneGraphRuntimeTargets graph_targets = {0};
     SceneRenderBatch* batches =
-        (SceneRenderBatch*)dvz_calloc(plan->count, sizeof(SceneRenderBatch));
+        (SceneRenderBatch*)_frame_plan_calloc(plan, plan->count, sizeof(SceneRenderBatch));
     SceneWorkRuntime* work_runtimes =
-        (SceneWorkRuntime*)dvz_calloc(plan->count, sizeof(SceneWorkRuntime));
+        (SceneWorkRuntime*)_frame_plan_calloc(plan, plan->count, sizeof(SceneWorkRuntime));
     if (batches == NULL || work_runtimes == NULL)
     {
-        dvz_free(work_runtimes);
-        dvz_free(batches);
+        _frame_plan_free(plan, work_runtimes);
+        _frame_plan_free(plan, batches);
         return false;
     }
 
@@ -1064,11 +1072,16 @@ bool _emitter_emit_scene_graph_renders(
             }
         }
     }
+    if (ok && !_scene_common_bindings_flush(emitter, stream))
+    {
+        _diagnostic(report, "scene common uniform upload failed");
+        ok = false;
+    }
     if (!ok)
     {
         _graph_runtime_targets_destroy(&graph_targets);
-        dvz_free(work_runtimes);
-        dvz_free(batches);
+        _frame_plan_free(plan, work_runtimes);
+        _frame_plan_free(plan, batches);
         return false;
     }
 
@@ -1830,8 +1843,8 @@ bool _emitter_emit_scene_graph_renders(
                    stream, encoder_id, command_buffer_id, submission_id, final_color_id, rb_id,
                    readback);
     _graph_runtime_targets_destroy(&graph_targets);
-    dvz_free(work_runtimes);
-    dvz_free(batches);
+    _frame_plan_free(plan, work_runtimes);
+    _frame_plan_free(plan, batches);
     return ok;
 }
 
@@ -231,6 +231,7 @@ bool _emitter_prepare_render_multi(
         }
 
         uint64_t vis_bg_set0 = 0;
+        uint64_t vis_set0_offset = 0;
         uint64_t vis_bg_set1 = 0;
         uint64_t vis_bg_set2 = 0;
         uint64_t vis_bg_set3 = 0;
@@ -261,7 +262,8 @@ bool _emitter_prepare_render_multi(
         if (bind.uses_common_set0)
         {
             ok = _scene_common_bindings_resolve_visual_set(
-                emitter, stream, render, provider, i, common_bgl_id, viewport_rect, &vis_bg_set0);
+                emitter, stream, render, provider, i, common_bgl_id, viewport_rect, &vis_bg_set0,
+                &vis_set0_offset);
             if (!ok)
                 break;
         }
@@ -775,7 +777,7 @@ bool _emitter_prepare_render_multi(
                  _resolve_textured_mesh_bind_group(
                      emitter, stream, textured_mesh_bgl_id, bind.material_buffer_id,
                      bind.panel_light_buffer_id, bind.image_texture_id, *mesh_sampler_id,
-                     bind.image_color_role, &mesh_bg_id);
+                     bind.image_color_role, bind.field_ring_origin, &mesh_bg_id);
             vis_bg_set1 = mesh_bg_id;
         }
         else if (bind.uses_image_set1)
@@ -815,7 +817,8 @@ bool _emitter_prepare_render_multi(
             uint64_t img_bg_id = 0;
             ok = ok && _resolve_image_bind_group(
                            emitter, stream, img_bgl_id, bind.image_texture_id, *img_sampler_id,
-                           bind.image_nearest_sampler, bind.image_color_role, &img_bg_id);
+                           bind.image_nearest_sampler, bind.image_color_role,
+                           bind.field_ring_origin, &img_bg_id);
             vis_bg_set1 = img_bg_id;
         }
         if (bind.uses_labels_set1)
@@ -982,6 +985,7 @@ bool _emitter_prepare_render_multi(
             vis_bg_set3, clip_rect, viewport_rect, shader_format, report, &draws[draw_count]);
         if (!ok)
             break;
+        draws[draw_count].set0_offset = vis_set0_offset;
         draw_count++;
     }
 
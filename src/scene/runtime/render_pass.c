@@ -366,7 +366,8 @@ bool _render_pass_resolve_readback_buffer(
         return true;
 
     bool is_new = false;
-    uint64_t rb_id = _obj_buffer_id(emitter, "_rb", copy->u.copy.byte_size, &is_new);
+    uint64_t rb_id = _obj_buffer_id(
+        emitter, _emitter_readback_key(emitter), copy->u.copy.byte_size, &is_new);
     if (rb_id == 0)
         return false;
     if (is_new)
@@ -115,6 +115,61 @@ static bool _state_clone(const ConverterState* src, ConverterState* dst)
 
 
 
+/**
+ * Release the heap storage of a common uniform ring.
+ *
+ * @param ring the common ring
+ */
+static void _common_ring_destroy(DvzSceneCommonRing* ring)
+{
+    ANN(ring);
+    for (uint32_t i = 0; i < ring->region_count; i++)
+        dvz_free(ring->regions[i].slots);
+    dvz_free(ring->keys);
+    dvz_free(ring->index);
+    dvz_memset(ring, sizeof(DvzSceneCommonRing), 0, sizeof(DvzSceneCommonRing));
+}
+
+
+
+/**
+ * Deep-copy the mirrors of a common uniform ring.
+ *
+ * The per-frame key table is reset by _emitter_common_begin_frame(), so only its capacity is
+ * carried over.
+ *
+ * @param src the source ring
+ * @param dst the destination ring, a shallow copy of src
+ * @return whether the ring was copied successfully
+ */
+static bool _common_ring_clone(const DvzSceneCommonRing* src, DvzSceneCommonRing* dst)
+{
+    ANN(src);
+    ANN(dst);
+    for (uint32_t i = 0; i < src->region_count; i++)
+        dst->regions[i].slots = NULL;
+    dst->keys = NULL;
+    dst->index = NULL;
+    dst->key_capacity = 0;
+    dst->index_capacity = 0;
+    dst->count = 0;
+
+    for (uint32_t i = 0; i < src->region_count; i++)
+    {
+        const DvzSceneCommonRegion* region = &src->regions[i];
+        if (region->capacity == 0)
+            continue;
+        size_t bytes = (size_t)region->capacity * sizeof(DvzSceneCommonUniform);
+        dst->regions[i].slots = (DvzSceneCommonUniform*)dvz_malloc(bytes);
+        if (dst->regions[i].slots == NULL)
+            return false;
+        dvz_memcpy(dst->regions[i].slots, bytes, region->slots, bytes);
+    }
+    return true;
+}
+
+
+
 /*************************************************************************************************/
 /*  Functions                                                                                    */
 /*************************************************************************************************/
@@ -165,7 +220,8 @@ bool _emitter_state_clone(
     candidate->resources.resources = NULL;
     candidate->objects.resources = NULL;
     if (!_state_clone(&emitter->resources, &candidate->resources) ||
-        !_state_clone(&emitter->objects, &candidate->objects))
+        !_state_clone(&emitter->objects, &candidate->objects) ||
+        !_common_ring_clone(&emitter->common, &candidate->common))
     {
         _emitter_state_discard(candidate);
         return false;
@@ -188,6 +244,7 @@ void _emitter_state_commit(
     ANN(candidate);
     _state_destroy(&emitter->resources);
     _state_destroy(&emitter->objects);
+    _common_ring_destroy(&emitter->common);
     *emitter = *candidate;
     dvz_memset(candidate, sizeof(DvzFramePlanEmitter), 0, sizeof(DvzFramePlanEmitter));
 }
@@ -205,6 +262,7 @@ void _emitter_state_discard(DvzFramePlanEmitter* candidate)
         return;
     _state_destroy(&candidate->resources);
     _state_destroy(&candidate->objects);
+    _common_ring_destroy(&candidate->common);
     dvz_memset(candidate, sizeof(DvzFramePlanEmitter), 0, sizeof(DvzFramePlanEmitter));
 }
 
@@ -225,55 +283,215 @@ uint64_t _emitter_next_transient_id(DvzFramePlanEmitter* emitter)
 
 
 /**
- * Return the MVP cache slot for a panel key, creating it when capacity allows.
+ * Bind the common uniform ring to the region of a frame-slot scope and reset its bump allocator.
+ *
+ * A new scope takes a free region, or the least recently used one once all regions are taken.
  *
  * @param emitter the persistent emitter
- * @param key the MVP cache key
- * @return the cached MVP slot, or NULL when the cache is full
+ * @param scope the runtime resource scope of the frame, 0 when unscoped
  */
-DvzMVP* _emitter_mvp_slot(DvzFramePlanEmitter* emitter, const char* key)
+void _emitter_common_begin_frame(DvzFramePlanEmitter* emitter, uint64_t scope)
 {
     ANN(emitter);
+    DvzSceneCommonRing* ring = &emitter->common;
+    ring->frame++;
+
+    uint32_t region = 0;
+    while (region < ring->region_count && ring->regions[region].scope != scope)
+        region++;
+    if (region == ring->region_count)
+    {
+        if (ring->region_count < DVZ_SCENE_COMMON_RING_MAX_REGIONS)
+            ring->region_count++;
+        else
+        {
+            region = 0;
+            for (uint32_t i = 1; i < ring->region_count; i++)
+            {
+                if (ring->regions[i].last_frame < ring->regions[region].last_frame)
+                    region = i;
+            }
+        }
+        ring->regions[region].scope = scope;
+    }
+    ring->regions[region].last_frame = ring->frame;
+    ring->region = region;
+
+    ring->count = 0;
+    if (ring->index != NULL)
+    {
+        size_t bytes = (size_t)ring->index_capacity * sizeof(uint32_t);
+        dvz_memset(ring->index, bytes, 0, bytes);
+    }
+    ring->regions[region].dirty_begin = 0;
+    ring->regions[region].dirty_end = 0;
+}
+
+
+
+static uint64_t _common_key_hash(const char* key)
+{
     ANN(key);
-    for (uint32_t i = 0; i < emitter->mvp_panel_count; i++)
+    uint64_t hash = UINT64_C(1469598103934665603);
+    for (const char* c = key; *c != '\0'; c++)
+        hash = (hash ^ (uint8_t)*c) * UINT64_C(1099511628211);
+    return hash;
+}
+
+
+
+/**
+ * Grow the per-frame key table and rebuild the hashed index of the keys allocated so far.
+ *
+ * @param ring the common ring
+ * @return whether the key table grew
+ */
+static bool _common_keys_grow(DvzSceneCommonRing* ring)
+{
+    ANN(ring);
+    uint32_t capacity =
+        ring->key_capacity != 0 ? 2 * ring->key_capacity : DVZ_SCENE_COMMON_KEY_MIN_CAPACITY;
+    if (capacity > UINT32_MAX / 2)
+        return false;
+
+    char(*keys)[DVZ_SCENE_LABEL_SIZE] = (char(*)[DVZ_SCENE_LABEL_SIZE])dvz_realloc(
+        ring->keys, (size_t)capacity * DVZ_SCENE_LABEL_SIZE);
+    if (keys == NULL)
+        return false;
+    ring->keys = keys;
+    ring->key_capacity = capacity;
+
+    uint32_t* index = (uint32_t*)dvz_calloc(2 * (size_t)capacity, sizeof(uint32_t));
+    if (index == NULL)
+        return false;
+    dvz_free(ring->index);
+    ring->index = index;
+    ring->index_capacity = 2 * capacity;
+    uint32_t mask = ring->index_capacity - 1;
+    for (uint32_t slot = 0; slot < ring->count; slot++)
     {
-        if (strncmp(emitter->mvp_panel_ids[i], key, DVZ_SCENE_LABEL_SIZE) == 0)
-            return &emitter->mvp_cache[i];
+        uint32_t i = (uint32_t)_common_key_hash(ring->keys[slot]) & mask;
+        while (index[i] != 0)
+            i = (i + 1) & mask;
+        index[i] = slot + 1;
     }
-    if (emitter->mvp_panel_count >= DVZ_SCENE_COMMON_CACHE_CAPACITY)
-        return NULL;
-    uint32_t slot = emitter->mvp_panel_count++;
-    strncpy(emitter->mvp_panel_ids[slot], key, DVZ_SCENE_LABEL_SIZE - 1);
-    return &emitter->mvp_cache[slot];
+    return true;
 }
 
 
 
 /**
- * Return the viewport cache slot for a panel key, creating it when capacity allows.
+ * Return the common uniform ring slot for a common-set key in the current frame.
+ *
+ * The first lookup of a key in a frame bump-allocates the next slot of the frame's region,
+ * doubling the region when it is full. The slot is only uploaded if _emitter_common_store()
+ * changes it.
  *
  * @param emitter the persistent emitter
- * @param key the viewport cache key
- * @return the cached viewport slot, or NULL when the cache is full
+ * @param key the common-set key
+ * @param out_index the slot index in the current region
+ * @return the mirrored common uniform slot, or NULL on allocation failure
  */
-DvzSceneViewportUniform*
-_emitter_viewport_slot(DvzFramePlanEmitter* emitter, const char* key)
+DvzSceneCommonUniform*
+_emitter_common_slot(DvzFramePlanEmitter* emitter, const char* key, uint32_t* out_index)
 {
     ANN(emitter);
     ANN(key);
-    for (uint32_t i = 0; i < emitter->viewport_panel_count; i++)
+    ANN(out_index);
+    DvzSceneCommonRing* ring = &emitter->common;
+    if (ring->region_count == 0)
+        _emitter_common_begin_frame(emitter, 0);
+
+    uint64_t hash = _common_key_hash(key);
+    uint32_t slot = UINT32_MAX;
+    uint32_t mask = ring->index_capacity - 1;
+    uint32_t i = (uint32_t)hash & mask;
+    while (ring->index != NULL && ring->index[i] != 0)
     {
-        if (strncmp(emitter->viewport_panel_ids[i], key, DVZ_SCENE_LABEL_SIZE) == 0)
-            return &emitter->viewport_cache[i];
+        if (strncmp(ring->keys[ring->index[i] - 1], key, DVZ_SCENE_LABEL_SIZE) == 0)
+        {
+            slot = ring->index[i] - 1;
+            break;
+        }
+        i = (i + 1) & mask;
     }
-    if (emitter->viewport_panel_count >= DVZ_SCENE_COMMON_CACHE_CAPACITY)
-        return NULL;
-    uint32_t slot = emitter->viewport_panel_count++;
-    strncpy(emitter->viewport_panel_ids[slot], key, DVZ_SCENE_LABEL_SIZE - 1);
-    return &emitter->viewport_cache[slot];
+
+    DvzSceneCommonRegion* region = &ring->regions[ring->region];
+    if (slot == UINT32_MAX)
+    {
+        if (ring->count == ring->key_capacity)
+        {
+            if (!_common_keys_grow(ring))
+                return NULL;
+            mask = ring->index_capacity - 1;
+            i = (uint32_t)hash & mask;
+            while (ring->index[i] != 0)
+                i = (i + 1) & mask;
+        }
+        slot = ring->count;
+        if (slot >= region->capacity)
+        {
+            uint32_t capacity =
+                region->capacity != 0 ? 2 * region->capacity : DVZ_SCENE_COMMON_MIN_SLOTS;
+            DvzSceneCommonUniform* slots = (DvzSceneCommonUniform*)dvz_realloc(
+                region->slots, (size_t)capacity * sizeof(DvzSceneCommonUniform));
+            if (slots == NULL)
+                return NULL;
+            dvz_memset(
+                &slots[region->capacity],
+                (size_t)(capacity - region->capacity) * sizeof(DvzSceneCommonUniform), 0,
+                (size_t)(capacity - region->capacity) * sizeof(DvzSceneCommonUniform));
+            region->slots = slots;
+            region->capacity = capacity;
+        }
+        _state_copy_key(ring->keys[slot], DVZ_SCENE_LABEL_SIZE, key);
+        ring->index[i] = slot + 1;
+        ring->count++;
+    }
+
+    *out_index = slot;
+    return &region->slots[slot];
+}
+
+
+
+/**
+ * Store a common uniform value into a slot of the current region.
+ *
+ * The slot joins the dirty range of the next flush only when its contents change, or when its
+ * uploaded copy is not known to match the mirror yet.
+ *
+ * @param emitter the persistent emitter
+ * @param index the slot index in the current region
+ * @param value the new common uniform value
+ */
+void _emitter_common_store(
+    DvzFramePlanEmitter* emitter, uint32_t index, const DvzSceneCommonUniform* value)
+{
+    ANN(emitter);
+    ANN(value);
+    DvzSceneCommonRegion* region = &emitter->common.regions[emitter->common.region];
+    ASSERT(index < region->capacity);
+    DvzSceneCommonUniform* slot = &region->slots[index];
+    bool changed =
+        index >= region->synced || memcmp(slot, value, sizeof(DvzSceneCommonUniform)) != 0;
+    (void)_emitter_uniform_store(emitter, slot, value, sizeof(DvzSceneCommonUniform));
+    if (!changed)
+        return;
+
+    if (region->dirty_end == region->dirty_begin)
+    {
+        region->dirty_begin = index;
+        region->dirty_end = index + 1;
+    }
+    else if (index < region->dirty_begin)
+        region->dirty_begin = index;
+    else if (index >= region->dirty_end)
+        region->dirty_end = index + 1;
 }
 
 
+
 /**
  * Return the volume uniform cache slot for a visual key, creating it when capacity allows.
  *
@@ -325,6 +543,61 @@ _emitter_labels_slot(DvzFramePlanEmitter* emitter, const char* key)
 
 
 
+/**
+ * Store a uniform value into its persistent cache slot.
+ *
+ * @param emitter the persistent emitter
+ * @param slot the cache slot
+ * @param value the new uniform value
+ * @param size uniform byte size
+ * @return the payload version to declare on the write of this uniform
+ */
+uint64_t _emitter_uniform_store(
+    DvzFramePlanEmitter* emitter, void* slot, const void* value, uint64_t size)
+{
+    ANN(emitter);
+    ANN(slot);
+    ANN(value);
+    if (emitter->uniform_version == 0 || memcmp(slot, value, (size_t)size) != 0)
+    {
+        memcpy(slot, value, (size_t)size);
+        emitter->uniform_version++;
+    }
+    return emitter->uniform_version;
+}
+
+
+
+/**
+ * Select the object key of the buffer receiving subsequent readback copies.
+ *
+ * @param emitter the persistent emitter
+ * @param key the readback buffer key, or NULL to restore the default "_rb"
+ */
+void _emitter_set_readback_key(DvzFramePlanEmitter* emitter, const char* key)
+{
+    ANN(emitter);
+    dvz_memset(emitter->readback_key, DVZ_SCENE_LABEL_SIZE, 0, DVZ_SCENE_LABEL_SIZE);
+    if (key != NULL)
+        strncpy(emitter->readback_key, key, DVZ_SCENE_LABEL_SIZE - 1);
+}
+
+
+
+/**
+ * Return the object key of the buffer receiving readback copies.
+ *
+ * @param emitter the persistent emitter
+ * @return the readback buffer key
+ */
+const char* _emitter_readback_key(const DvzFramePlanEmitter* emitter)
+{
+    ANN(emitter);
+    return emitter->readback_key[0] != '\0' ? emitter->readback_key : "_rb";
+}
+
+
+
 /**
  * Return a deterministic DRP2 id for a scene resource key.
  *
@@ -799,6 +1072,7 @@ void dvz_frame_plan_emitter_destroy(DvzFramePlanEmitter* emitter)
         return;
     _state_destroy(&emitter->resources);
     _state_destroy(&emitter->objects);
+    _common_ring_destroy(&emitter->common);
     dvz_free(emitter);
 }
 
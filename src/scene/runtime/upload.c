@@ -51,7 +51,7 @@ static DvzDrp2ColorRole _drp2_color_role(DvzColorRole role)
 
 
 /**
- * Emit runtime-mode upload commands.
+ * Emit the create and write commands of one upload node.
  *
  * @param emitter the persistent emitter
  * @param stream the DRP2 command stream
@@ -59,7 +59,7 @@ static DvzDrp2ColorRole _drp2_color_role(DvzColorRole role)
  * @param out_id the emitted resource id
  * @return whether the commands were emitted
  */
-bool _emitter_emit_upload(
+static bool _emit_upload_commands(
     DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, const DvzFramePlanNode* node,
     uint64_t* out_id)
 {
@@ -287,6 +287,43 @@ bool _emitter_emit_upload(
 
 
 
+/**
+ * Emit runtime-mode upload commands.
+ *
+ * Every emitted write declares a new payload version of its resource, so frame fingerprints
+ * detect the upload without reading its bytes.
+ *
+ * @param emitter the persistent emitter
+ * @param stream the DRP2 command stream
+ * @param node the upload node
+ * @param out_id the emitted resource id
+ * @return whether the commands were emitted
+ */
+bool _emitter_emit_upload(
+    DvzFramePlanEmitter* emitter, DvzDrp2CommandStream* stream, const DvzFramePlanNode* node,
+    uint64_t* out_id)
+{
+    ANN(emitter);
+    ANN(stream);
+    ANN(node);
+    const uint32_t count = dvz_drp2_stream_count(stream);
+    if (!_emit_upload_commands(emitter, stream, node, out_id))
+        return false;
+    if (dvz_drp2_stream_count(stream) == count)
+        return true;
+
+    /* The write is the last command of every branch that appends one. */
+    ResourceId* resource = _resource_find(&emitter->resources, node->u.upload.resource_id);
+    if (resource != NULL)
+    {
+        resource->payload_version++;
+        (void)dvz_drp2_stream_set_payload_version(stream, resource->payload_version);
+    }
+    return true;
+}
+
+
+
 /**
  * Create or reuse a persistent texture and copy an uploaded buffer into it.
  *
@@ -46,8 +46,11 @@ static bool _scene_emit_compute_buffer_upload(
     if ((has_cpu_data && !buffer->dirty) || buffer->desc.byte_size == 0)
         return true;
 
+    uint64_t byte_offset = 0, byte_size = 0;
+    _scene_buffer_dirty_range(buffer, &byte_offset, &byte_size);
+    const void* data = has_cpu_data ? (const uint8_t*)buffer->data + byte_offset : NULL;
     if (!dvz_frame_plan_upload_bytes(
-            plan, resource_id, 0, buffer->desc.byte_size, "compute.buffer", buffer->data))
+            plan, resource_id, byte_offset, byte_size, "compute.buffer", data))
         return false;
 
     DvzFramePlanNode* node = &plan->nodes[plan->count - 1];
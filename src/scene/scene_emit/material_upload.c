@@ -55,13 +55,13 @@ bool _scene_emit_visual_material_upload(
         return false;
     }
     DvzSceneMaterialParams* params =
-        (DvzSceneMaterialParams*)dvz_malloc(sizeof(DvzSceneMaterialParams));
+        (DvzSceneMaterialParams*)_frame_plan_calloc(plan, 1, sizeof(DvzSceneMaterialParams));
     if (params == NULL)
         return false;
     DvzVisualLowering lowering = {0};
     if (!_scene_visual_lowering_resolve(visual, &lowering))
     {
-        dvz_free(params);
+        _frame_plan_free(plan, params);
         return false;
     }
     DvzSceneMaterialParams authored = {0};
@@ -70,14 +70,14 @@ bool _scene_emit_visual_material_upload(
             figure, &authored, sizeof(DvzSceneMaterialParams), lowering.material_param_fields,
             lowering.material_param_field_count, params))
     {
-        dvz_free(params);
+        _frame_plan_free(plan, params);
         return false;
     }
     if (!dvz_frame_plan_upload_bytes(
             plan, material_resource_id, 0, sizeof(DvzSceneMaterialParams), "material_params",
             params))
     {
-        dvz_free(params);
+        _frame_plan_free(plan, params);
         return false;
     }
     plan->nodes[plan->count - 1].u.upload.owned_data = params;
@@ -117,7 +117,8 @@ bool _scene_emit_visual_item_state_style_upload(
         return false;
     }
     DvzSceneItemStateStyleParams* params =
-        (DvzSceneItemStateStyleParams*)dvz_malloc(sizeof(DvzSceneItemStateStyleParams));
+        (DvzSceneItemStateStyleParams*)_frame_plan_calloc(
+            plan, 1, sizeof(DvzSceneItemStateStyleParams));
     if (params == NULL)
         return false;
     *params = _visual_family_state(visual)->item_state_style_params;
@@ -125,7 +126,7 @@ bool _scene_emit_visual_item_state_style_upload(
             plan, resource_id, 0, sizeof(DvzSceneItemStateStyleParams), "item_state_style",
             params))
     {
-        dvz_free(params);
+        _frame_plan_free(plan, params);
         return false;
     }
     plan->nodes[plan->count - 1].u.upload.owned_data = params;
@@ -36,6 +36,7 @@
 #include "_visual_internal.h"
 #include "annotation/scale_internal.h"
 #include "domain/buffer_internal.h"
+#include "domain/field_internal.h"
 #include "scene_emit/visual_lowering.h"
 #include "datoviz/drp2/runtime.h"
 #include "render_contract/render_contract.h"
@@ -100,6 +101,7 @@ bool _scene_visual_frame_plan_metadata(
         metadata->field_width = _visual_family_state(visual)->field->desc.width;
         metadata->field_height = _visual_family_state(visual)->field->desc.height;
         metadata->field_depth = _visual_family_state(visual)->field->desc.depth;
+        _field_ring_origin_uvw(_visual_family_state(visual)->field, metadata->field_ring_origin);
     }
 
     const char* vertex_count_attr =
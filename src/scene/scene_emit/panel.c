@@ -609,7 +609,6 @@ static bool _scene_append_visual_to_render_pass(
                 figure, visual, visual_index, visual_id, sizeof(visual_id)))
             return false;
     }
-    (void)plan;
     if (node->u.render.visual_count >= DVZ_SCENE_MAX_RENDER_VISUALS)
         return false;
 
@@ -717,7 +716,7 @@ static bool _scene_append_visual_to_render_pass(
     if (!_scene_panel_attachment_mvp(
             panel, visual, attach, &node->u.render.apply_mvp, &visual_mvp))
         return false;
-    if (!_frame_plan_render_visual_reserve(node, node->u.render.visual_count + 1))
+    if (!_frame_plan_render_visual_reserve(plan, node, node->u.render.visual_count + 1))
         return false;
     uint32_t slot = node->u.render.visual_count;
     dvz_strlcpy(node->u.render.visuals[slot], visual_id, sizeof(node->u.render.visuals[slot]));
@@ -68,8 +68,8 @@ void _scene_emit_panel_light_uploads(
         if (!needed)
             continue;
 
-        DvzScenePanelLightsGpu* payload = (DvzScenePanelLightsGpu*)dvz_calloc(
-            1, sizeof(DvzScenePanelLightsGpu));
+        DvzScenePanelLightsGpu* payload = (DvzScenePanelLightsGpu*)_frame_plan_calloc(
+            plan, 1, sizeof(DvzScenePanelLightsGpu));
         if (payload == NULL)
         {
             (void)dvz_diagnostic_report_add(report, "panel light payload allocation failed");
@@ -86,7 +86,7 @@ void _scene_emit_panel_light_uploads(
             !dvz_frame_plan_upload_bytes(
                 plan, resource_id, 0, sizeof(DvzScenePanelLightsGpu), "panel_lights", payload))
         {
-            dvz_free(payload);
+            _frame_plan_free(plan, payload);
             (void)dvz_diagnostic_report_add(report, "panel light upload planning failed");
             continue;
         }
@@ -267,7 +267,7 @@ bool _scene_frame_plan_upload_style_bytes(
     {
         if (byte_size % sizeof(float) != 0 || byte_size > SIZE_MAX)
             return false;
-        owned = dvz_malloc((size_t)byte_size);
+        owned = _frame_plan_calloc(plan, 1, byte_size);
         if (owned == NULL)
             return false;
         DvzScenePayloadFieldDesc field = {
@@ -279,7 +279,7 @@ bool _scene_frame_plan_upload_style_bytes(
         };
         if (!_scene_payload_lower_fields(figure, data, byte_size, &field, 1, owned))
         {
-            dvz_free(owned);
+            _frame_plan_free(plan, owned);
             return false;
         }
         upload_data = owned;
@@ -289,7 +289,7 @@ bool _scene_frame_plan_upload_style_bytes(
         plan, resource_id, byte_offset, byte_size, data_tag, upload_data);
     if (!ok)
     {
-        dvz_free(owned);
+        _frame_plan_free(plan, owned);
         return false;
     }
     if (owned != NULL)
@@ -471,7 +471,7 @@ static bool _scene_emit_scalar_color_upload(
         return false;
     }
 
-    DvzColor* colors = (DvzColor*)dvz_malloc((DvzSize)byte_size);
+    DvzColor* colors = (DvzColor*)_frame_plan_calloc(plan, 1, byte_size);
     if (colors == NULL)
         return false;
 
@@ -500,7 +500,7 @@ static bool _scene_emit_scalar_color_upload(
     if (!dvz_frame_plan_upload_bytes(
             plan, resource_id, byte_offset, byte_size, attr->name, colors))
     {
-        dvz_free(colors);
+        _frame_plan_free(plan, colors);
         return false;
     }
     _scene_attach_upload_metadata(
@@ -575,9 +575,11 @@ void _scene_emit_visual_dense_attr_uploads(
             bool has_cpu_data = attr->buffer->data != NULL;
             if ((has_cpu_data && attr->buffer->dirty) || !has_cpu_data)
             {
+                uint64_t byte_offset = 0, byte_size = 0;
+                _scene_buffer_dirty_range(attr->buffer, &byte_offset, &byte_size);
                 dvz_frame_plan_upload_bytes(
-                    plan, buffer_resource_id, 0, attr->buffer->desc.byte_size, attr->name,
-                    attr->buffer->data);
+                    plan, buffer_resource_id, byte_offset, byte_size, attr->name,
+                    has_cpu_data ? (const uint8_t*)attr->buffer->data + byte_offset : NULL);
                 _scene_attach_upload_metadata(
                     plan, visual, visual_index, _scene_attr_frame_plan_role(attr->name),
                     DVZ_FRAME_PLAN_RESOURCE_KIND_BUFFER, buffer_idx, attr->item_count);
@@ -658,9 +660,11 @@ void _scene_emit_visual_index_buffer_upload(
             _visual_family_state(visual)->buffer->id, buffer_resource_id,
             sizeof(buffer_resource_id)))
         return;
+    uint64_t byte_offset = 0, byte_size = 0;
+    _scene_buffer_dirty_range(_visual_family_state(visual)->buffer, &byte_offset, &byte_size);
     dvz_frame_plan_upload_bytes(
-        plan, buffer_resource_id, 0, _visual_family_state(visual)->buffer->desc.byte_size, "index",
-        _visual_family_state(visual)->buffer->data);
+        plan, buffer_resource_id, byte_offset, byte_size, "index",
+        (const uint8_t*)_visual_family_state(visual)->buffer->data + byte_offset);
     _scene_attach_upload_metadata(
         plan, visual, visual_index, DVZ_FRAME_PLAN_RESOURCE_ROLE_INDEX,
         DVZ_FRAME_PLAN_RESOURCE_KIND_BUFFER, buffer_idx,
@@ -25,4 +25,11 @@ vec4 sampledTextureColorToLinear(vec4 color, vec4 params)
     return vec4(color.rgb, clamp(color.a, 0.0, 1.0));
 }
 
+// Map logical texture coordinates into a circular field whose origin is params.yz.
+vec2 sampledTextureRingUV(vec2 uv, vec4 params)
+{
+    vec2 shifted = uv + params.yz;
+    return shifted - vec2(greaterThan(shifted, vec2(1.0)));
+}
+
 #endif
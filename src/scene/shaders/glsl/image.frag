@@ -17,7 +17,8 @@ layout(location = 0) out vec4 outColor;
 
 void main()
 {
-    vec4 texel = texture(sampler2D(tex, samp), fragUV);
+    vec2 uv = sampledTextureRingUV(fragUV, textureParams.params);
+    vec4 texel = texture(sampler2D(tex, samp), uv);
     outColor = sampledTextureColorToLinear(texel, textureParams.params);
 #ifdef DVZ_SCENE_OCCLUSION
     applySceneOcclusion(outColor);
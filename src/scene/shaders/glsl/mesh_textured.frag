@@ -23,8 +23,9 @@ layout(location = 0) out vec4 outColor;
 
 void main()
 {
+    vec2 uv = sampledTextureRingUV(fragUV, textureParams.params);
     vec4 texel = sampledTextureColorToLinear(
-        texture(sampler2D(tex, samp), fragUV), textureParams.params);
+        texture(sampler2D(tex, samp), uv), textureParams.params);
     vec4 base = texel * semanticColorToLinear(fragColor);
     vec4 shaded = evaluateSceneMaterialLinearItem(base, fragNormal, fragWorldPos, fragCameraPos);
     vec3 cue = vec3(fragDepth, length(fragCameraPos - fragWorldPos), length(fragWorldPos));
@@ -37,6 +37,7 @@ layout(set = 1, binding = 2) uniform VolumeParams {
     vec4 value_range;
     vec4 occlusion;
     vec4 texture_params;
+    vec4 ring_origin;
 } volume;
 
 layout(location = 0) in vec3 fragUVW;
@@ -101,7 +102,10 @@ vec3 texture_uvw(vec3 uvw)
     int ax2 = int(clamp(volume.axis_order.z, 0.0, 2.0));
     vec3 out_uvw = vec3(axis_value(ax0, uvw), axis_value(ax1, uvw), axis_value(ax2, uvw));
     out_uvw = mix(out_uvw, vec3(1.0) - out_uvw, step(vec3(0.5), volume.axis_flip.xyz));
-    return clamp(out_uvw, vec3(0.0), vec3(1.0));
+    out_uvw = clamp(out_uvw, vec3(0.0), vec3(1.0));
+    // Circular fields store logical sample 0 at the ring origin.
+    out_uvw += volume.ring_origin.xyz;
+    return out_uvw - vec3(greaterThan(out_uvw, vec3(1.0)));
 }
 
 vec4 transfer_value(float value)
@@ -19,3 +19,9 @@ fn sampled_texture_color_to_linear(color: vec4f, params: vec4f) -> vec4f {
     }
     return vec4f(color.rgb, clamp(color.a, 0.0, 1.0));
 }
+
+// Map logical texture coordinates into a circular field whose origin is params.yz.
+fn sampled_texture_ring_uv(uv: vec2f, params: vec4f) -> vec2f {
+    let shifted = uv + params.yz;
+    return select(shifted, shifted - vec2f(1.0), shifted > vec2f(1.0));
+}
@@ -10,6 +10,7 @@ struct FragmentIn {
 
 @fragment
 fn main(input: FragmentIn) -> @location(0) vec4f {
-    let texel = textureSample(tex, samp, input.uv);
+    let uv = sampled_texture_ring_uv(input.uv, texture_params);
+    let texel = textureSample(tex, samp, uv);
     return sampled_texture_color_to_linear(texel, texture_params);
 }
@@ -17,7 +17,8 @@ struct FragmentIn {
 
 @fragment
 fn main(input: FragmentIn) -> @location(0) vec4f {
-    let texel = sampled_texture_color_to_linear(textureSample(tex, samp, input.uv), texture_params);
+    let uv = sampled_texture_ring_uv(input.uv, texture_params);
+    let texel = sampled_texture_color_to_linear(textureSample(tex, samp, uv), texture_params);
     let base = texel * semantic_color_to_linear(input.color);
     let shaded = evaluate_scene_material_linear_item(
         base, input.normal, input.world_position, input.camera_position);
@@ -123,21 +123,6 @@ static int test_scene_dpi_physical_viewport_and_screen_scale(
             AC(cmd->u.set_scissor.scissor[3], 600.0f, 1e-6f);
             found_scissor = true;
         }
-        else if (
-            cmd->type == DVZ_DRP2_COMMAND_WRITE_BUFFER &&
-            cmd->u.write_buffer.size == sizeof(DvzSceneViewportUniform))
-        {
-            const DvzSceneViewportUniform* viewport =
-                (const DvzSceneViewportUniform*)cmd->u.write_buffer.data_raw;
-            ANN(viewport);
-            if (fabsf(viewport->width - 400.0f) <= 1e-6f &&
-                fabsf(viewport->height - 600.0f) <= 1e-6f)
-            {
-                AC(viewport->x, 200.0f, 1e-6f);
-                AC(viewport->y, 0.0f, 1e-6f);
-                found_viewport_uniform = true;
-            }
-        }
         else if (
             cmd->type == DVZ_DRP2_COMMAND_WRITE_BUFFER &&
             cmd->u.write_buffer.size == sizeof(float))
@@ -171,6 +156,19 @@ static int test_scene_dpi_physical_viewport_and_screen_scale(
             }
         }
     }
+    DvzSceneViewportUniform viewports[DVZ_SCENE_COMMON_MIN_SLOTS] = {0};
+    uint32_t viewport_count =
+        _stream_common_viewports(stream, viewports, DVZ_SCENE_COMMON_MIN_SLOTS);
+    for (uint32_t i = 0; i < viewport_count; i++)
+    {
+        const DvzSceneViewportUniform* viewport = &viewports[i];
+        if (fabsf(viewport->width - 400.0f) <= 1e-6f && fabsf(viewport->height - 600.0f) <= 1e-6f)
+        {
+            AC(viewport->x, 200.0f, 1e-6f);
+            AC(viewport->y, 0.0f, 1e-6f);
+            found_viewport_uniform = true;
+        }
+    }
 
     AT(found_viewport);
     AT(found_scissor);
@@ -2870,6 +2870,71 @@ int test_scene_sampled_field_update_region(TstContext* suite, const TstCase* ite
 }
 
 
+int test_scene_sampled_field_ring_origin_updates_logical_rows(
+    TstContext* suite, const TstCase* item)
+{
+    tst_log_capture_begin(suite);
+    (void)item;
+
+    DvzScene* scene = dvz_scene();
+    ANN(scene);
+
+    DvzSampledField* field = dvz_sampled_field(
+        scene, &(DvzSampledFieldDesc){DVZ_STRUCT_INIT_FIELDS(DvzSampledFieldDesc),
+                   .dim = DVZ_FIELD_DIM_2D,
+                   .format = DVZ_FIELD_FORMAT_R8_UINT,
+                   .semantic = DVZ_FIELD_SEMANTIC_LABEL,
+                   .width = 4,
+                   .height = 4,
+                   .depth = 1,
+               });
+    ANN(field);
+    uint8_t base[16] = {0};
+    DvzFieldDataView view = dvz_field_data_view();
+    view.data = base;
+    AT(dvz_sampled_field_set_data(field, &view) == DVZ_OK);
+    uint8_t* data = (uint8_t*)field->data;
+
+    // Appending a row advances the origin and writes the last logical row at the old head.
+    AT(dvz_sampled_field_set_ring_origin(field, 0, 1, 0) == DVZ_OK);
+    field->dirty = false;
+    uint8_t row[4] = {1, 2, 3, 4};
+    view.data = row;
+    AT(dvz_sampled_field_update_region(
+           field, (DvzFieldRegion){.x = 0, .y = 3, .z = 0, .width = 4, .height = 1, .depth = 1},
+           &view) == DVZ_OK);
+    AT(data[0] == 1 && data[3] == 4);
+    AT(data[12] == 0);
+    AT(field->dirty && !field->dirty_full);
+    AT(field->dirty_region.y == 0 && field->dirty_region.height == 1);
+
+    float uvw[4] = {0};
+    _field_ring_origin_uvw(field, uvw);
+    AT(uvw[0] == 0.0f && uvw[1] == 0.25f && uvw[2] == 0.0f);
+
+    // A logical span crossing the seam is split into two physical spans.
+    AT(dvz_sampled_field_set_ring_origin(field, 2, 0, 0) == DVZ_OK);
+    uint8_t wrap[3] = {5, 6, 7};
+    view.data = wrap;
+    AT(dvz_sampled_field_update_region(
+           field, (DvzFieldRegion){.x = 1, .y = 2, .z = 0, .width = 3, .height = 1, .depth = 1},
+           &view) == DVZ_OK);
+    AT(data[11] == 5 && data[8] == 6 && data[9] == 7);
+
+    AT_EXPECTED_ERROR_STRICT(
+        suite, dvz_sampled_field_set_ring_origin(field, 4, 0, 0) == DVZ_ERROR);
+    AT(_captured_log_contains(suite, "ring origin exceeds"));
+
+    // Full replacements are logical and reset the origin.
+    view.data = base;
+    AT(dvz_sampled_field_set_data(field, &view) == DVZ_OK);
+    AT(field->ring_origin[0] == 0 && field->ring_origin[1] == 0);
+
+    dvz_scene_destroy(scene);
+    return 0;
+}
+
+
 int test_scene_sampled_field_rejects_unsupported_format(TstContext* suite, const TstCase* item)
 {
     tst_log_capture_begin(suite);
@@ -5195,6 +5260,7 @@ int test_scene_fields(TstSuite* suite)
     TST_CASE(test_scene_image_r16_snorm_field_uses_bound_scale);
     TST_CASE(test_scene_visual_field_rejects_cross_scene_field);
     TST_CASE(test_scene_sampled_field_update_region);
+    TST_CASE(test_scene_sampled_field_ring_origin_updates_logical_rows);
     TST_CASE(test_scene_sampled_field_rejects_unsupported_format);
     TST_CASE(test_scene_image_visual_rejects_3d_field);
     TST_CASE(test_scene_mesh_visual_binds_texture_field);
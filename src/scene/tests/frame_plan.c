@@ -2510,6 +2510,143 @@ int test_frame_plan_graph_validation_pass_kind(TstContext* suite, const TstCase*
 }
 
 
+/**
+ * Add one fixed-extent per-frame texture to a FramePlan graph.
+ *
+ * @param plan the FramePlan
+ * @param id graph resource id
+ * @param format texture format token
+ * @param usage_flags graph resource usage flags
+ * @return whether the resource was added
+ */
+static bool
+_alias_texture(DvzFramePlan* plan, const char* id, uint32_t format, uint32_t usage_flags)
+{
+    DvzFrameGraphResource resource = {0};
+    dvz_strlcpy(resource.id, id, sizeof(resource.id));
+    resource.kind = DVZ_FRAME_GRAPH_RESOURCE_TEXTURE;
+    resource.format = format;
+    resource.extent_kind = DVZ_FRAME_GRAPH_EXTENT_FIXED;
+    resource.width = 64;
+    resource.height = 64;
+    resource.depth = 1;
+    resource.usage_flags = usage_flags;
+    resource.lifetime = DVZ_FRAME_GRAPH_RESOURCE_LIFETIME_PER_FRAME;
+    return dvz_frame_plan_graph_resource(plan, &resource);
+}
+
+
+
+/**
+ * Add one render pass writing a color attachment and sampling another texture.
+ *
+ * @param plan the FramePlan
+ * @param id graph pass id
+ * @param sampled sampled resource id, or NULL
+ * @param color color attachment resource id
+ * @param load_op color attachment load operation
+ * @param depth depth attachment resource id, or NULL
+ * @return whether the pass was added
+ */
+static bool _alias_pass(
+    DvzFramePlan* plan, const char* id, const char* sampled, const char* color,
+    DvzFrameGraphAttachmentLoadOp load_op, const char* depth)
+{
+    DvzFrameGraphPass pass = {0};
+    dvz_strlcpy(pass.id, id, sizeof(pass.id));
+    pass.kind = DVZ_FRAME_GRAPH_PASS_RENDER;
+    if (sampled != NULL &&
+        !dvz_frame_graph_pass_read(&pass, sampled, DVZ_FRAME_GRAPH_ACCESS_SAMPLED))
+        return false;
+
+    DvzFrameGraphAttachment attachment = {0};
+    dvz_strlcpy(attachment.resource_id, color, sizeof(attachment.resource_id));
+    attachment.load_op = load_op;
+    attachment.store_op = DVZ_FRAME_GRAPH_ATTACHMENT_STORE_STORE;
+    attachment.access = DVZ_FRAME_GRAPH_ATTACHMENT_ACCESS_WRITE;
+    if (!dvz_frame_graph_pass_color_attachment(&pass, &attachment))
+        return false;
+    if (depth != NULL)
+    {
+        DvzFrameGraphAttachment depth_attachment = attachment;
+        dvz_strlcpy(depth_attachment.resource_id, depth, sizeof(depth_attachment.resource_id));
+        depth_attachment.load_op = DVZ_FRAME_GRAPH_ATTACHMENT_LOAD_CLEAR;
+        depth_attachment.store_op = DVZ_FRAME_GRAPH_ATTACHMENT_STORE_DONT_CARE;
+        depth_attachment.clear_depth = 1.0f;
+        if (!dvz_frame_graph_pass_depth_attachment(&pass, &depth_attachment))
+            return false;
+    }
+    return dvz_frame_plan_graph_pass(plan, &pass);
+}
+
+
+
+/**
+ * Ensure per-frame textures with disjoint pass lifetimes share an alias slot.
+ *
+ * @param suite the active test suite
+ * @param item the active test item
+ * @return 0 on success
+ */
+int test_frame_plan_graph_alias_disjoint_targets(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzFramePlan* plan = dvz_frame_plan("figure.graph.alias", 18);
+    ANN(plan);
+
+    const uint32_t color_usage =
+        DVZ_FRAME_GRAPH_RESOURCE_USAGE_COLOR_ATTACHMENT | DVZ_FRAME_GRAPH_RESOURCE_USAGE_SAMPLED;
+    AT(_alias_texture(plan, "blur.ping", DVZ_FORMAT_R16G16B16A16_SFLOAT, color_usage));
+    AT(_alias_texture(plan, "blur.pong", DVZ_FORMAT_R16G16B16A16_SFLOAT, color_usage));
+    AT(_alias_texture(plan, "blur.final", DVZ_FORMAT_R16G16B16A16_SFLOAT, color_usage));
+    AT(_alias_texture(plan, "blur.history", DVZ_FORMAT_R16G16B16A16_SFLOAT, color_usage));
+    AT(_alias_texture(
+        plan, "blur.depth", DVZ_FORMAT_D32_SFLOAT,
+        DVZ_FRAME_GRAPH_RESOURCE_USAGE_DEPTH_ATTACHMENT));
+
+    // ping [0, 1], pong [1, 2], final [2, 3]: ping and final never hold data at the same time.
+    // history is loaded by its first pass, so its previous contents must survive.
+    AT(_alias_pass(
+        plan, "blur.0", NULL, "blur.ping", DVZ_FRAME_GRAPH_ATTACHMENT_LOAD_CLEAR, "blur.depth"));
+    AT(_alias_pass(
+        plan, "blur.1", "blur.ping", "blur.pong", DVZ_FRAME_GRAPH_ATTACHMENT_LOAD_CLEAR, NULL));
+    AT(_alias_pass(
+        plan, "blur.2", "blur.pong", "blur.final", DVZ_FRAME_GRAPH_ATTACHMENT_LOAD_CLEAR, NULL));
+    AT(_alias_pass(
+        plan, "blur.3", "blur.final", "blur.history", DVZ_FRAME_GRAPH_ATTACHMENT_LOAD_LOAD,
+        NULL));
+
+    AT(dvz_frame_plan_graph_alias(plan));
+    const DvzFrameGraphResource* ping = dvz_frame_plan_graph_resource_get(plan, 0);
+    const DvzFrameGraphResource* pong = dvz_frame_plan_graph_resource_get(plan, 1);
+    const DvzFrameGraphResource* final = dvz_frame_plan_graph_resource_get(plan, 2);
+    const DvzFrameGraphResource* history = dvz_frame_plan_graph_resource_get(plan, 3);
+    const DvzFrameGraphResource* depth = dvz_frame_plan_graph_resource_get(plan, 4);
+    AT(ping->alias_slot == 1);
+    AT(final->alias_slot == 1);
+    AT(ping->alias_usage_flags == color_usage);
+    AT(pong->alias_slot == 0);
+    AT(history->alias_slot == 0);
+    AT(depth->alias_slot == 0);
+    AT(!ping->transient && !pong->transient);
+    AT(depth->transient);
+
+    DvzFrameGraphAliasStats stats = dvz_frame_plan_graph_alias_stats(plan, 800, 600);
+    AT(stats.texture_count == 5);
+    AT(stats.aliased_count == 2);
+    AT(stats.slot_count == 1);
+    AT(stats.transient_count == 1);
+    AT(stats.bytes == 4 * 64 * 64 * 8 + 64 * 64 * 4);
+    AT(stats.aliased_bytes == 3 * 64 * 64 * 8 + 64 * 64 * 4);
+    AT(stats.transient_bytes == 64 * 64 * 4);
+
+    dvz_frame_plan_destroy(plan);
+    return 0;
+}
+
+
 /**
  * Ensure graph dependencies expose ordered WBOIT-style producers and consumers.
  *
@@ -3193,6 +3330,7 @@ int test_scene_frame_plan(TstSuite* suite)
     TST_CASE(test_frame_plan_graph_validation_attachment_kind);
     TST_CASE(test_frame_plan_graph_validation_attachment_extent);
     TST_CASE(test_frame_plan_graph_validation_pass_kind);
+    TST_CASE(test_frame_plan_graph_alias_disjoint_targets);
 
     return 0;
 }
@@ -1677,16 +1677,19 @@ int test_frame_plan_emit_drp2_defaults_missing_mvp_to_identity(
         const DvzDrp2Command* command = dvz_drp2_stream_get(stream, i);
         ANN(command);
         if (
-            command->type == DVZ_DRP2_COMMAND_WRITE_BUFFER &&
-            command->u.write_buffer.size == sizeof(DvzMVP))
+            command->type == DVZ_DRP2_COMMAND_SET_BIND_GROUP &&
+            command->u.set_bind_group.slot == 0 &&
+            command->u.set_bind_group.dynamic_offset_count > 0)
         {
-            const DvzMVP* mvp = (const DvzMVP*)command->u.write_buffer.data_raw;
-            ANN(mvp);
+            DvzSceneCommonUniform common = {0};
+            AT(_stream_common_uniform(
+                stream, command->u.set_bind_group.bind_group_id,
+                command->u.set_bind_group.dynamic_offsets[0], &common));
             for (uint32_t axis = 0; axis < 4; axis++)
             {
-                AC(mvp->model[axis][axis], 1.0f, 1e-6f);
-                AC(mvp->view[axis][axis], 1.0f, 1e-6f);
-                AC(mvp->proj[axis][axis], 1.0f, 1e-6f);
+                AC(common.mvp.model[axis][axis], 1.0f, 1e-6f);
+                AC(common.mvp.view[axis][axis], 1.0f, 1e-6f);
+                AC(common.mvp.proj[axis][axis], 1.0f, 1e-6f);
             }
             found_mvp = true;
         }
@@ -1790,8 +1793,7 @@ static int test_frame_plan_emitter_failure_rolls_back_state(
     AT(emitter->next_transient_id == DRP2_RUNTIME_TRANSIENT_ID_BASE);
     AT(emitter->max_color_sample_count == 16);
     AT(emitter->max_depth_sample_count == 16);
-    AT(emitter->mvp_panel_count == 0);
-    AT(emitter->viewport_panel_count == 0);
+    AT(emitter->common.region_count == 0);
     AT(emitter->volume_count == 0);
     AT(emitter->labels_count == 0);
 
@@ -1831,6 +1833,82 @@ static int test_frame_plan_emitter_failure_rolls_back_state(
 
 
 
+/**
+ * Ensure the common uniform ring grows its region, marks only changed slots, and keeps one
+ * region per frame-slot scope.
+ *
+ * @param suite the active test suite
+ * @param item the active test item
+ * @return 0 on success
+ */
+static int test_frame_plan_emitter_common_ring_grows(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzFramePlanEmitter* emitter = dvz_frame_plan_emitter();
+    ANN(emitter);
+    const uint32_t key_count = 5 * DVZ_SCENE_COMMON_MIN_SLOTS / 2;
+    char key[DVZ_SCENE_LABEL_SIZE];
+    uint32_t index = 0;
+
+    // Every key takes the next slot of the frame, doubling the region past its first size.
+    _emitter_common_begin_frame(emitter, 0x11);
+    for (uint32_t i = 0; i < key_count; i++)
+    {
+        dvz_snprintf(key, sizeof(key), "panel.%u_apply_provider_0_visual.%u", i / 2, i);
+        ANN(_emitter_common_slot(emitter, key, &index));
+        AT(index == i);
+    }
+    DvzSceneCommonRegion* region = &emitter->common.regions[0];
+    AT(emitter->common.count == key_count);
+    AT(region->capacity == 4 * DVZ_SCENE_COMMON_MIN_SLOTS);
+    AT(region->dirty_end == region->dirty_begin);
+
+    // A known key resolves to its slot of this frame.
+    dvz_snprintf(key, sizeof(key), "panel.%u_apply_provider_0_visual.%u", 50, 101);
+    DvzSceneCommonUniform* slot = _emitter_common_slot(emitter, key, &index);
+    AT(slot == &region->slots[101]);
+    AT(index == 101);
+    AT(emitter->common.count == key_count);
+
+    // Slots not yet uploaded are always dirty; uploaded ones only when their contents change.
+    DvzSceneCommonUniform uniform = *slot;
+    uniform.viewport.width = 640;
+    _emitter_common_store(emitter, index, &uniform);
+    AT(region->dirty_begin == 101 && region->dirty_end == 102);
+    region->dirty_begin = region->dirty_end = 0;
+    region->synced = key_count;
+    _emitter_common_store(emitter, index, &uniform);
+    AT(region->dirty_end == region->dirty_begin);
+    uniform.viewport.width = 800;
+    _emitter_common_store(emitter, index, &uniform);
+    AT(region->dirty_begin == 101 && region->dirty_end == 102);
+
+    // Another frame slot gets its own region; the first scope finds its region again.
+    _emitter_common_begin_frame(emitter, 0x22);
+    AT(emitter->common.region == 1);
+    AT(emitter->common.count == 0);
+    ANN(_emitter_common_slot(emitter, key, &index));
+    AT(index == 0);
+    _emitter_common_begin_frame(emitter, 0x11);
+    AT(emitter->common.region == 0);
+    AT(emitter->common.regions[0].capacity == 4 * DVZ_SCENE_COMMON_MIN_SLOTS);
+
+    // Once every region is taken, a new scope reuses the least recently used one.
+    for (uint32_t i = 2; i < DVZ_SCENE_COMMON_RING_MAX_REGIONS; i++)
+        _emitter_common_begin_frame(emitter, 0x100 + i);
+    _emitter_common_begin_frame(emitter, 0x11);
+    _emitter_common_begin_frame(emitter, 0x999);
+    AT(emitter->common.region_count == DVZ_SCENE_COMMON_RING_MAX_REGIONS);
+    AT(emitter->common.region == 1);
+
+    dvz_frame_plan_emitter_destroy(emitter);
+    return 0;
+}
+
+
+
 int test_frame_plan_emit_drp2_rejects_unsupported_shader_format(TstContext* suite, const TstCase* item)
 {
     ANN(suite);
@@ -3706,6 +3784,7 @@ int test_scene_frame_plan_emit(TstSuite* suite)
     TST_CASE(test_frame_plan_emit_drp2_split_packets);
     TST_CASE(test_frame_plan_emitter_rejects_untyped_visual_metadata);
     TST_CASE(test_frame_plan_emitter_failure_rolls_back_state);
+    TST_CASE(test_frame_plan_emitter_common_ring_grows);
     TST_CASE(test_frame_plan_emit_drp2_rejects_unsupported_shader_format);
     TST_CASE(test_frame_plan_emit_drp2_rejects_small_caps);
 #if defined(DVZ_DRP2_HAS_VKLITE) && DVZ_DRP2_HAS_VKLITE
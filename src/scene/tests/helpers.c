@@ -320,11 +320,151 @@ uint32_t _stream_write_buffer_count(const DvzDrp2CommandStream* stream)
 }
 
 
+/**
+ * Return whether a command uploads slots of the scene common uniform ring.
+ *
+ * @param stream the command stream carrying emitter labels
+ * @param cmd the command
+ * @return whether the command is a WRITE_BUFFER into one of the common ring regions
+ */
+bool _stream_is_common_uniform_write(
+    const DvzDrp2CommandStream* stream, const DvzDrp2Command* cmd)
+{
+    ANN(stream);
+    ANN(cmd);
+    if (cmd->type != DVZ_DRP2_COMMAND_WRITE_BUFFER)
+        return false;
+    const char* label = dvz_drp2_stream_label(stream, cmd->u.write_buffer.buffer_id);
+    return label != NULL &&
+           strncmp(label, DVZ_SCENE_COMMON_RING_KEY, strlen(DVZ_SCENE_COMMON_RING_KEY)) == 0;
+}
+
+
+/**
+ * Return the common ring region buffer bound by a common bind group created in a DRP2 stream.
+ *
+ * @param stream the command stream
+ * @param bg_id the common bind group id
+ * @return the region buffer id, or 0 when the stream does not create the bind group
+ */
+static uint64_t _stream_common_ring_buffer(const DvzDrp2CommandStream* stream, uint64_t bg_id)
+{
+    ANN(stream);
+    for (uint32_t i = 0; i < dvz_drp2_stream_count(stream); i++)
+    {
+        const DvzDrp2Command* cmd = dvz_drp2_stream_get(stream, i);
+        if (cmd->type == DVZ_DRP2_COMMAND_CREATE_BIND_GROUP &&
+            cmd->u.create_bind_group.id == bg_id && cmd->u.create_bind_group.entry_count > 0)
+            return cmd->u.create_bind_group.entries[0].resource_id;
+    }
+    return 0;
+}
+
+
+/**
+ * Copy the common uniform slot last uploaded at a ring region offset.
+ *
+ * @param stream the command stream
+ * @param bg_id the common bind group of the region, as bound to set 0
+ * @param offset the slot byte offset, as bound by the set-0 dynamic offsets
+ * @param out the uploaded slot
+ * @return whether a ring upload covers the slot
+ */
+bool _stream_common_uniform(
+    const DvzDrp2CommandStream* stream, uint64_t bg_id, uint64_t offset,
+    DvzSceneCommonUniform* out)
+{
+    ANN(stream);
+    ANN(out);
+
+    uint64_t ring_id = _stream_common_ring_buffer(stream, bg_id);
+    bool found = false;
+    for (uint32_t i = 0; ring_id != 0 && i < dvz_drp2_stream_count(stream); i++)
+    {
+        const DvzDrp2Command* cmd = dvz_drp2_stream_get(stream, i);
+        if (!_stream_is_common_uniform_write(stream, cmd) ||
+            cmd->u.write_buffer.buffer_id != ring_id || cmd->u.write_buffer.data_raw == NULL ||
+            offset < cmd->u.write_buffer.offset ||
+            offset + sizeof(DvzSceneCommonUniform) >
+                cmd->u.write_buffer.offset + cmd->u.write_buffer.size)
+            continue;
+        const uint8_t* data = (const uint8_t*)cmd->u.write_buffer.data_raw;
+        memcpy(out, data + (offset - cmd->u.write_buffer.offset), sizeof(DvzSceneCommonUniform));
+        found = true;
+    }
+    return found;
+}
+
+
+/**
+ * Collect the viewport uniforms of every common ring slot uploaded in a DRP2 stream.
+ *
+ * @param stream the command stream
+ * @param out the output viewports
+ * @param capacity the output capacity
+ * @return number of viewports written to out
+ */
+uint32_t _stream_common_viewports(
+    const DvzDrp2CommandStream* stream, DvzSceneViewportUniform* out, uint32_t capacity)
+{
+    ANN(stream);
+    ANN(out);
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < dvz_drp2_stream_count(stream); i++)
+    {
+        const DvzDrp2Command* cmd = dvz_drp2_stream_get(stream, i);
+        if (!_stream_is_common_uniform_write(stream, cmd) || cmd->u.write_buffer.data_raw == NULL)
+            continue;
+        const DvzSceneCommonUniform* slots =
+            (const DvzSceneCommonUniform*)cmd->u.write_buffer.data_raw;
+        uint64_t slot_count = cmd->u.write_buffer.size / sizeof(DvzSceneCommonUniform);
+        for (uint64_t s = 0; s < slot_count && count < capacity; s++)
+            out[count++] = slots[s].viewport;
+    }
+    return count;
+}
+
+
+/**
+ * Count the distinct common ring slots bound to set 0 in a DRP2 stream.
+ *
+ * @param stream the command stream
+ * @return number of distinct set-0 bind group and dynamic offset pairs
+ */
+uint32_t _stream_common_slot_count(const DvzDrp2CommandStream* stream)
+{
+    ANN(stream);
+
+    uint64_t bg_ids[DVZ_SCENE_COMMON_MIN_SLOTS] = {0};
+    uint64_t offsets[DVZ_SCENE_COMMON_MIN_SLOTS] = {0};
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < dvz_drp2_stream_count(stream); i++)
+    {
+        const DvzDrp2Command* cmd = dvz_drp2_stream_get(stream, i);
+        if (cmd->type != DVZ_DRP2_COMMAND_SET_BIND_GROUP || cmd->u.set_bind_group.slot != 0 ||
+            cmd->u.set_bind_group.dynamic_offset_count == 0)
+            continue;
+        uint64_t bg_id = cmd->u.set_bind_group.bind_group_id;
+        uint64_t offset = cmd->u.set_bind_group.dynamic_offsets[0];
+        uint32_t j = 0;
+        while (j < count && (bg_ids[j] != bg_id || offsets[j] != offset))
+            j++;
+        if (j == count && count < DVZ_SCENE_COMMON_MIN_SLOTS)
+        {
+            bg_ids[count] = bg_id;
+            offsets[count++] = offset;
+        }
+    }
+    return count;
+}
+
+
 /**
  * Count visual-data WRITE_BUFFER commands in a DRP2 stream.
  *
  * @param stream the command stream
- * @return number of WRITE_BUFFER commands excluding per-panel common uniform uploads
+ * @return number of WRITE_BUFFER commands excluding common uniform ring uploads
  */
 uint32_t _stream_visual_write_buffer_count(const DvzDrp2CommandStream* stream)
 {
@@ -335,8 +475,7 @@ uint32_t _stream_visual_write_buffer_count(const DvzDrp2CommandStream* stream)
     {
         const DvzDrp2Command* cmd = dvz_drp2_stream_get(stream, i);
         if (cmd->type == DVZ_DRP2_COMMAND_WRITE_BUFFER &&
-            cmd->u.write_buffer.size != sizeof(DvzMVP) &&
-            cmd->u.write_buffer.size != sizeof(DvzSceneViewportUniform))
+            !_stream_is_common_uniform_write(stream, cmd))
         {
             count++;
         }
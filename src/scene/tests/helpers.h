@@ -76,6 +76,18 @@ int _assert_stream_matches_fixture(DvzDrp2CommandStream* stream, const char* nam
 
 uint32_t _stream_write_buffer_count(const DvzDrp2CommandStream* stream);
 
+bool _stream_is_common_uniform_write(
+    const DvzDrp2CommandStream* stream, const DvzDrp2Command* cmd);
+
+bool _stream_common_uniform(
+    const DvzDrp2CommandStream* stream, uint64_t bg_id, uint64_t offset,
+    DvzSceneCommonUniform* out);
+
+uint32_t _stream_common_viewports(
+    const DvzDrp2CommandStream* stream, DvzSceneViewportUniform* out, uint32_t capacity);
+
+uint32_t _stream_common_slot_count(const DvzDrp2CommandStream* stream);
+
 uint32_t _stream_visual_write_buffer_count(const DvzDrp2CommandStream* stream);
 
 uint32_t _stream_write_buffer_range_count(
@@ -40,6 +40,7 @@
 #include "helpers.h"
 #include "shaders/_scene_shader_abi.h"
 #include "text/internal.h"
+#include "text/text_ft_cache.h"
 #include "text/text_internal.h"
 #include "test_scene.h"
 #include "testing.h"
@@ -126,71 +127,14 @@ static bool _interaction_viewport_uniform_matches(
 }
 
 
-static bool _interaction_stream_buffer_viewport(
-    const DvzDrp2CommandStream* stream, uint64_t buffer_id, DvzSceneViewportUniform* out)
-{
-    ANN(stream);
-    ANN(out);
-    bool found = false;
-    for (uint32_t i = 0; i < dvz_drp2_stream_count(stream); i++)
-    {
-        const DvzDrp2Command* cmd = dvz_drp2_stream_get(stream, i);
-        if (
-            cmd == NULL || cmd->type != DVZ_DRP2_COMMAND_WRITE_BUFFER ||
-            cmd->u.write_buffer.buffer_id != buffer_id ||
-            cmd->u.write_buffer.size != sizeof(DvzSceneViewportUniform))
-        {
-            continue;
-        }
-        const DvzSceneViewportUniform* viewport =
-            (const DvzSceneViewportUniform*)cmd->u.write_buffer.data_raw;
-        ANN(viewport);
-        *out = *viewport;
-        found = true;
-    }
-    return found;
-}
-
-
-static bool _interaction_stream_common_bind_group_viewport_buffer(
-    const DvzDrp2CommandStream* stream, uint64_t bind_group_id, uint64_t* out_buffer_id)
-{
-    ANN(stream);
-    ANN(out_buffer_id);
-    for (uint32_t i = 0; i < dvz_drp2_stream_count(stream); i++)
-    {
-        const DvzDrp2Command* cmd = dvz_drp2_stream_get(stream, i);
-        if (
-            cmd == NULL || cmd->type != DVZ_DRP2_COMMAND_CREATE_BIND_GROUP ||
-            cmd->u.create_bind_group.id != bind_group_id)
-        {
-            continue;
-        }
-        for (uint32_t j = 0; j < cmd->u.create_bind_group.entry_count; j++)
-        {
-            const DvzDrp2BindGroupEntry* entry = &cmd->u.create_bind_group.entries[j];
-            if (
-                entry->binding == DVZ_SCENE_SHADER_BINDING_COMMON_VIEWPORT &&
-                entry->binding_type == DVZ_DRP2_BINDING_TYPE_UNIFORM_BUFFER &&
-                entry->resource_kind == DVZ_DRP2_BINDING_RESOURCE_BUFFER &&
-                entry->size == sizeof(DvzSceneViewportUniform))
-            {
-                *out_buffer_id = entry->resource_id;
-                return true;
-            }
-        }
-    }
-    return false;
-}
-
-
 static bool _interaction_stream_glyph_draw_uses_plot_viewport(
     const DvzDrp2CommandStream* stream, const DvzRect* plot_rect)
 {
     ANN(stream);
     ANN(plot_rect);
     uint64_t active_pipeline_id = 0;
-    uint64_t active_bg_set0 = 0;
+    uint64_t active_set0_bg_id = 0;
+    uint64_t active_set0_offset = UINT64_MAX;
     bool saw_glyph_draw = false;
     for (uint32_t i = 0; i < dvz_drp2_stream_count(stream); i++)
     {
@@ -200,13 +144,15 @@ static bool _interaction_stream_glyph_draw_uses_plot_viewport(
         if (cmd->type == DVZ_DRP2_COMMAND_SET_PIPELINE)
         {
             active_pipeline_id = cmd->u.set_pipeline.pipeline_id;
-            active_bg_set0 = 0;
+            active_set0_offset = UINT64_MAX;
         }
         else if (
             cmd->type == DVZ_DRP2_COMMAND_SET_BIND_GROUP &&
-            cmd->u.set_bind_group.slot == DVZ_SCENE_SHADER_SET_COMMON)
+            cmd->u.set_bind_group.slot == DVZ_SCENE_SHADER_SET_COMMON &&
+            cmd->u.set_bind_group.dynamic_offset_count > 0)
         {
-            active_bg_set0 = cmd->u.set_bind_group.bind_group_id;
+            active_set0_bg_id = cmd->u.set_bind_group.bind_group_id;
+            active_set0_offset = cmd->u.set_bind_group.dynamic_offsets[0];
         }
         else if (cmd->type == DVZ_DRP2_COMMAND_DRAW || cmd->type == DVZ_DRP2_COMMAND_DRAW_INDEXED)
         {
@@ -215,14 +161,12 @@ static bool _interaction_stream_glyph_draw_uses_plot_viewport(
                 continue;
 
             saw_glyph_draw = true;
-            uint64_t viewport_buffer_id = 0;
-            DvzSceneViewportUniform viewport = {0};
-            if (!_interaction_stream_common_bind_group_viewport_buffer(
-                    stream, active_bg_set0, &viewport_buffer_id))
-                return false;
-            if (!_interaction_stream_buffer_viewport(stream, viewport_buffer_id, &viewport))
+            DvzSceneCommonUniform common = {0};
+            if (active_set0_offset == UINT64_MAX ||
+                !_stream_common_uniform(
+                    stream, active_set0_bg_id, active_set0_offset, &common))
                 return false;
-            if (!_interaction_viewport_uniform_matches(&viewport, plot_rect))
+            if (!_interaction_viewport_uniform_matches(&common.viewport, plot_rect))
                 return false;
         }
     }
@@ -5233,6 +5177,17 @@ int test_scene_text_block_measure(TstContext* suite, const TstCase* item)
     AT(scientific.layout_glyph_index[1] != 0);
     AT(scientific.layout_glyph_index[2] != 0);
 
+    /* Re-measuring reuses the scene's cached faces and glyph metrics. */
+    DvzTextFtCacheStats before = {0};
+    DvzTextFtCacheStats after = {0};
+    AT(_scene_text_ft_cache_stats(scene, &before));
+    AT(before.face_count > 0);
+    AT(_scene_text_block_measure(&wide, &ft_layout) == 0);
+    AT(_scene_text_ft_cache_stats(scene, &after));
+    AT(after.face_loads == before.face_loads);
+    AT(after.glyph_loads == before.glyph_loads);
+    AT(after.hits > before.hits);
+
     _scene_text_block_destroy(&narrow);
     _scene_text_block_destroy(&wide);
     _scene_text_block_destroy(&bold);
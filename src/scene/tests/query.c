@@ -14,6 +14,8 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include <math.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "_assertions.h"
@@ -548,6 +550,291 @@ int test_scene_query_rejects_family_unsupported_profile(TstContext* suite, const
 
 
 
+/**
+ * Ensure item queries and region selections resolve on the CPU through a visual spatial index.
+ *
+ * @param suite test context
+ * @param item test case
+ * @return 0 on success
+ */
+int test_scene_query_spatial_index_resolves_without_gpu(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    ANN(item);
+
+    DvzScene* scene = dvz_scene();
+    ANN(scene);
+    DvzFigure* figure = dvz_figure(scene, 100, 100, 0);
+    ANN(figure);
+    DvzPanel* panel = dvz_panel(
+        figure, &(DvzPanelDesc){.x = 0.0f, .y = 0.0f, .width = 1.0f, .height = 1.0f});
+    ANN(panel);
+    AT(dvz_panel_set_domain(panel, DVZ_DIM_X, 0.0, 10.0) == 0);
+    AT(dvz_panel_set_domain(panel, DVZ_DIM_Y, 0.0, 10.0) == 0);
+
+    DvzVisual* points = dvz_point(scene, 0);
+    ANN(points);
+    dvz_visual_set_query_capabilities(points, DVZ_QUERY_CAPABILITY_ITEM);
+    vec3 position[3] = {{2.0f, 5.0f, 0.0f}, {5.0f, 5.0f, 0.0f}, {8.0f, 5.0f, 0.0f}};
+    DvzColor color[3] = {{255, 0, 0, 255}, {0, 255, 0, 255}, {0, 0, 255, 255}};
+    float size[3] = {8.0f, 12.0f, 8.0f};
+    AT(dvz_visual_set_data(points, "position", position, 3) == 0);
+    AT(dvz_visual_set_data(points, "color", color, 3) == 0);
+    AT(dvz_visual_set_data(points, "size", size, 3) == 0);
+    AT(dvz_visual_set_spatial_index(points, true) == 0);
+    AT(dvz_panel_add_visual(panel, points, NULL) == 0);
+
+    // Without readback support the index is the only way to resolve the pick.
+    DvzCapabilitySnapshot caps = dvz_capability_snapshot();
+    caps.supports_readback = false;
+    DvzQueryRequest request = dvz_query_request();
+    request.request_id = 41;
+    request.target = DVZ_SCENE_TARGET_ITEM;
+
+    DvzQueryResult query = {0};
+    AT(dvz_panel_query_px(panel, 50.0, 50.0, &request) == 0);
+    AT(dvz_figure_process_queries(figure, NULL, &caps) == 1);
+    AT(dvz_scene_poll_query(scene, &query));
+    AT(query.hit);
+    AT(query.status == DVZ_QUERY_STATUS_HIT);
+    AT(query.visual_id == _scene_visual_public_id(scene, points));
+    AT(query.visual_family == DVZ_SCENE_VISUAL_FAMILY_POINT);
+    AT(query.item_id == 1);
+    AT(query.has_data_position);
+    AC(query.data_position[0], 5.0, 1e-6);
+    AC(query.data_position[1], 5.0, 1e-6);
+
+    // 8 px right of the middle point lies outside its 6 px radius.
+    AT(dvz_panel_query_px(panel, 58.0, 50.0, &request) == 0);
+    AT(dvz_figure_process_queries(figure, NULL, &caps) == 1);
+    AT(dvz_scene_poll_query(scene, &query));
+    AT(!query.hit);
+    AT(query.status == DVZ_QUERY_STATUS_MISS);
+
+    // A range update moves the last point under the pointer.
+    vec3 moved = {5.8f, 5.0f, 0.0f};
+    AT(dvz_visual_set_data_range(points, "position", 2, moved, 1) == 0);
+    AT(dvz_panel_query_px(panel, 58.0, 50.0, &request) == 0);
+    AT(dvz_figure_process_queries(figure, NULL, &caps) == 1);
+    AT(dvz_scene_poll_query(scene, &query));
+    AT(query.hit);
+    AT(query.item_id == 2);
+
+    AT(dvz_visual_query_nearest(points, (double[2]){2.4, 5.3}, INFINITY, &query) == 0);
+    AT(query.hit);
+    AT(query.item_id == 0);
+    AT(dvz_visual_query_nearest(points, (double[2]){2.4, 9.0}, 1.0, &query) == 0);
+    AT(query.status == DVZ_QUERY_STATUS_MISS);
+
+    uint64_t selected[3] = {0};
+    uint64_t count = 0;
+    AT(dvz_visual_query_rect(
+           points, (double[2]){1.0, 4.0}, (double[2]){5.5, 6.0}, selected, 3, &count) == 0);
+    AT(count == 2);
+    AT(selected[0] == 0);
+    AT(selected[1] == 1);
+    AT(dvz_visual_query_rect(
+           points, (double[2]){0.0, 0.0}, (double[2]){10.0, 10.0}, selected, 1, &count) == 0);
+    AT(count == 3);
+    AT(selected[0] == 0);
+
+    double lasso[8] = {4.5, 4.0, 7.0, 4.0, 7.0, 6.0, 4.5, 6.0};
+    AT(dvz_visual_query_lasso(points, lasso, 4, selected, 3, &count) == 0);
+    AT(count == 2);
+    AT(selected[0] == 1);
+    AT(selected[1] == 2);
+
+    DvzVisual* mesh = dvz_mesh(scene, 0);
+    ANN(mesh);
+    vec3 mesh_pos[4] = {
+        {1.0f, 1.0f, 0.0f}, {1.0f, 3.0f, 0.0f}, {3.0f, 1.0f, 0.0f}, {3.0f, 3.0f, 0.0f}};
+    vec3 mesh_normals[4] = {
+        {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f}};
+    DvzVisualDataUpdate mesh_updates[] = {
+        {.attr_name = "position", .data = mesh_pos, .item_count = 4},
+        {.attr_name = "normal", .data = mesh_normals, .item_count = 4},
+    };
+    DvzIndex mesh_indices[6] = {0, 1, 2, 2, 1, 3};
+    DvzSceneBuffer* index_buffer = dvz_scene_buffer(
+        scene, &(DvzSceneBufferDesc){DVZ_STRUCT_INIT_FIELDS(DvzSceneBufferDesc),
+                   .usage = DVZ_SCENE_BUFFER_USAGE_INDEX,
+                   .stride = sizeof(DvzIndex),
+               });
+    ANN(index_buffer);
+    AT(dvz_scene_buffer_set_data(index_buffer, mesh_indices, sizeof(mesh_indices)) == DVZ_OK);
+    AT(dvz_visual_set_data_many(mesh, mesh_updates, 2) == 0);
+    AT(dvz_visual_set_buffer(mesh, "index", index_buffer) == DVZ_OK);
+    AT(dvz_visual_set_spatial_index(mesh, true) == 0);
+    AT(dvz_visual_query_nearest(mesh, (double[2]){1.5, 1.5}, 0.0, &query) == 0);
+    AT(query.hit);
+    AT(query.visual_family == DVZ_SCENE_VISUAL_FAMILY_MESH);
+    AT(query.item_id == 0);
+    AT(query.primitive_id == 0);
+    AT(dvz_visual_query_nearest(mesh, (double[2]){4.0, 1.5}, 0.5, &query) == 0);
+    AT(query.status == DVZ_QUERY_STATUS_MISS);
+
+    DvzVisual* image = dvz_image(scene, 0);
+    ANN(image);
+    AT(dvz_visual_set_spatial_index(image, true) != 0);
+
+    dvz_scene_destroy(scene);
+    return 0;
+}
+
+
+
+/**
+ * Fill deterministic pseudo-random positions in the square [0, 10]^2.
+ *
+ * @param position output positions
+ * @param count position count
+ */
+static void _test_region_selection_positions(vec3* position, uint32_t count)
+{
+    uint32_t state = 12345u;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (uint32_t k = 0; k < 2; k++)
+        {
+            state = state * 1664525u + 1013904223u;
+            position[i][k] = 10.0f * (float)(state >> 8) / (float)(1u << 24);
+        }
+        position[i][2] = 0.0f;
+    }
+}
+
+
+
+/**
+ * Compare a region selection mask against a brute-force scan.
+ *
+ * @param visual the visual
+ * @param position the visual positions
+ * @param count position count
+ * @param min lower region corner
+ * @param max upper region corner
+ * @param polygon optional polygon as xy pairs, or NULL
+ * @param vertex_count polygon vertex count
+ * @return whether every bit and the selected count match
+ */
+static bool _test_region_selection_matches(
+    const DvzVisual* visual, const vec3* position, uint32_t count, const double min[2],
+    const double max[2], const double* polygon, uint32_t vertex_count)
+{
+    uint64_t mask_count = 0;
+    const uint64_t* mask = dvz_visual_region_selection_mask(visual, &mask_count);
+    if (mask == NULL || mask_count != count)
+        return false;
+    uint64_t expected_count = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        double x = position[i][0], y = position[i][1];
+        bool expected = x >= min[0] && x <= max[0] && y >= min[1] && y <= max[1] &&
+                        (polygon == NULL || _scene_point_in_polygon(polygon, vertex_count, x, y));
+        if (expected != (((mask[i / 64] >> (i % 64)) & 1u) != 0))
+            return false;
+        expected_count += expected ? 1 : 0;
+    }
+    return dvz_visual_region_selection_count(visual) == expected_count;
+}
+
+
+
+/**
+ * Ensure rectangle and lasso region selections produce exact bitmasks, grow lassos
+ * incrementally, and honor the spatial index and the drawn item range.
+ *
+ * @param suite test context
+ * @param item test case
+ * @return 0 on success
+ */
+int test_scene_query_region_selection_bitmask(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    ANN(item);
+
+    const uint32_t count = 5000;
+    vec3* position = (vec3*)calloc(count, sizeof(vec3));
+    ANN(position);
+    _test_region_selection_positions(position, count);
+
+    DvzScene* scene = dvz_scene();
+    ANN(scene);
+    DvzVisual* points = dvz_point(scene, 0);
+    ANN(points);
+    AT(dvz_visual_set_data(points, "position", position, count) == 0);
+    AT(dvz_visual_region_selection_mask(points, NULL) == NULL);
+
+    double rect_min[2] = {2.0, 3.0}, rect_max[2] = {6.5, 7.0};
+    AT(dvz_visual_select_rect(points, rect_max, rect_min) == 0);
+    AT(_test_region_selection_matches(points, position, count, rect_min, rect_max, NULL, 0));
+    uint64_t selected_count = 0;
+    AT(dvz_visual_region_selection_items(points, NULL, 0, &selected_count) == 0);
+    AT(selected_count == dvz_visual_region_selection_count(points));
+    AT(selected_count > 0);
+    uint64_t* selected = (uint64_t*)calloc(selected_count, sizeof(uint64_t));
+    ANN(selected);
+    AT(dvz_visual_region_selection_items(points, selected, selected_count, &selected_count) == 0);
+    for (uint64_t i = 1; i < selected_count; i++)
+        AT(selected[i - 1] < selected[i]);
+    free(selected);
+
+    // A lasso drawn one vertex at a time only tests the wedge each new vertex adds.
+    double lasso[2 * 16] = {0};
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        double angle = 2.0 * DVZ_PI * i / 16.0;
+        double radius = i % 2 == 0 ? 4.0 : 2.0;
+        lasso[2 * i + 0] = 5.0 + radius * cos(angle);
+        lasso[2 * i + 1] = 5.0 + radius * sin(angle);
+    }
+    double lasso_min[2] = {0.0, 0.0}, lasso_max[2] = {10.0, 10.0};
+    for (uint32_t n = 3; n <= 16; n++)
+    {
+        AT(dvz_visual_select_lasso(points, lasso, n) == 0);
+        AT(points->region_selection->last_incremental == (n > 3));
+        AT(_test_region_selection_matches(
+            points, position, count, lasso_min, lasso_max, lasso, n));
+    }
+    // Moving a vertex restarts the lasso from scratch.
+    lasso[2] += 0.5;
+    AT(dvz_visual_select_lasso(points, lasso, 16) == 0);
+    AT(!points->region_selection->last_incremental);
+    AT(_test_region_selection_matches(points, position, count, lasso_min, lasso_max, lasso, 16));
+
+    // The spatial index answers the same selection from its grid cells.
+    AT(dvz_visual_set_spatial_index(points, true) == 0);
+    AT(dvz_visual_select_rect(points, rect_min, rect_max) == 0);
+    AT(_test_region_selection_matches(points, position, count, rect_min, rect_max, NULL, 0));
+    AT(dvz_visual_select_lasso(points, lasso, 16) == 0);
+    AT(_test_region_selection_matches(points, position, count, lasso_min, lasso_max, lasso, 16));
+
+    // Items outside the drawn range are never selected.
+    AT(dvz_visual_set_item_range(points, 1000, 2000) == 0);
+    AT(dvz_visual_select_rect(points, lasso_min, lasso_max) == 0);
+    AT(dvz_visual_region_selection_count(points) == 2000);
+    const uint64_t* mask = dvz_visual_region_selection_mask(points, NULL);
+    ANN(mask);
+    AT((mask[999 / 64] >> (999 % 64) & 1u) == 0);
+    AT((mask[1000 / 64] >> (1000 % 64) & 1u) == 1);
+
+    dvz_visual_clear_region_selection(points);
+    AT(dvz_visual_region_selection_count(points) == 0);
+    AT(dvz_visual_region_selection_items(points, NULL, 0, &selected_count) == 0);
+    AT(selected_count == 0);
+
+    AT(dvz_visual_select_lasso(points, lasso, 2) != 0);
+    DvzVisual* image = dvz_image(scene, 0);
+    ANN(image);
+    AT(dvz_visual_select_rect(image, rect_min, rect_max) != 0);
+
+    dvz_scene_destroy(scene);
+    free(position);
+    return 0;
+}
+
+
+
 /**
  * Ensure image sample queries resolve through the native GPU value path.
  *
@@ -1162,6 +1449,227 @@ int test_scene_image_query_reuses_retained_request_executor(
 
 
 
+/**
+ * Ensure pipelined image queries deliver their readbacks a fixed number of frames later.
+ *
+ * @param suite the active test suite
+ * @param item the active test item
+ * @return 0 on success
+ */
+int test_scene_image_query_pipelines_readbacks(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    ANN(item);
+    TST_SCENE_QUERY_REQUIRE_VKLITE(suite);
+
+    DvzGpuCtxConfig gpu_cfg = dvz_testing_gpu_ctx_config(suite);
+    VkPhysicalDeviceVulkan13Features features13 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+    features13.dynamicRendering = true;
+    features13.synchronization2 = true;
+    dvz_gpu_ctx_config_features13(&gpu_cfg, &features13);
+    DvzGpuCtx* ctx = dvz_gpu_ctx(&gpu_cfg);
+    if (ctx == NULL)
+    {
+        tst_skip(suite, "GPU context creation failed");
+        return 0;
+    }
+
+    DvzScene* scene = dvz_scene();
+    ANN(scene);
+    DvzFigure* figure = dvz_figure(scene, 64, 64, 0);
+    ANN(figure);
+    DvzPanel* panel = dvz_panel(
+        figure, &(DvzPanelDesc){.x = 0.0f, .y = 0.0f, .width = 1.0f, .height = 1.0f});
+    ANN(panel);
+
+    DvzVisual* image = dvz_image(scene, 0);
+    ANN(image);
+    dvz_visual_set_query_capabilities(image, DVZ_QUERY_CAPABILITY_SAMPLE);
+    vec3 image_pos[4] = {
+        {-1.0f, -1.0f, 0.0f},
+        {-1.0f, 1.0f, 0.0f},
+        {1.0f, -1.0f, 0.0f},
+        {1.0f, 1.0f, 0.0f},
+    };
+    vec2 texcoords[4] = {
+        {0.0f, 0.0f},
+        {0.0f, 1.0f},
+        {1.0f, 0.0f},
+        {1.0f, 1.0f},
+    };
+    uint8_t pixels[4 * 4 * 4] = {0};
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        pixels[4 * i + 0] = 64;
+        pixels[4 * i + 1] = 128;
+        pixels[4 * i + 2] = 255;
+        pixels[4 * i + 3] = 255;
+    }
+    AT(dvz_visual_set_data(image, "position", image_pos, 4) == 0);
+    AT(dvz_visual_set_data(image, "texcoords", texcoords, 4) == 0);
+    AT(_scene_visual_set_texture_rgba8(image, (const uint8_t*)pixels, 4, 4, 4u * 4u * 4u) == 0);
+    AT(dvz_panel_add_visual(panel, image, NULL) == 0);
+
+    DvzDrp2RuntimeConfig runtime_cfg =
+        dvz_drp2_runtime_vklite_config(dvz_gpu_ctx_device(ctx), dvz_gpu_ctx_alloc(ctx));
+    DvzDrp2Runtime* runtime = dvz_drp2_runtime_vklite(&runtime_cfg);
+    ANN(runtime);
+
+    DvzCapabilitySnapshot caps = dvz_capability_snapshot();
+    caps.shader_format_glsl = true;
+
+    AT(dvz_scene_set_query_latency(scene, 4) != 0);
+    AT(dvz_scene_set_query_latency(scene, 2) == 0);
+
+    // Two hover moves in one frame coalesce into one in-flight readback.
+    DvzQueryRequest request = {
+        DVZ_STRUCT_INIT_FIELDS(DvzQueryRequest), .request_id = 701,
+        .target = DVZ_SCENE_TARGET_SAMPLE};
+    AT(dvz_panel_query_px(panel, 16.0, 16.0, &request) == 0);
+    AT(dvz_panel_query_px(panel, 32.0, 32.0, &request) == 0);
+    AT(dvz_figure_process_queries(figure, runtime, &caps) == 1);
+    AT(scene->query_executor.pipeline_submit_count == 1);
+    AT(scene->query_executor.pipeline_collect_count == 0);
+
+    DvzQueryResult query = {0};
+    AT(!dvz_scene_poll_query(scene, &query));
+    AT(dvz_figure_process_queries(figure, runtime, &caps) == 0);
+    AT(!dvz_scene_poll_query(scene, &query));
+    AT(dvz_figure_process_queries(figure, runtime, &caps) == 0);
+    AT(scene->query_executor.pipeline_collect_count == 1);
+    AT(dvz_scene_poll_query(scene, &query));
+    AT(query.request_id == 701);
+    AT(query.hit);
+    AC(query.panel_position[0], 32.0, 1e-9);
+    AT(!dvz_scene_poll_query(scene, &query));
+
+    // Synchronous queries still resolve immediately under a pipelined scene.
+    DvzQueryResult now = {0};
+    request.request_id = 702;
+    AT(dvz_panel_query_now_px(panel, runtime, 32.0, 32.0, &request, &now) == 0);
+    AT(now.request_id == 702);
+    AT(now.hit);
+    AT(scene->query_latency == 2);
+    AT(scene->query_executor.runtime_create_count == 1);
+
+    dvz_scene_destroy(scene);
+    dvz_drp2_runtime_destroy(runtime);
+    dvz_gpu_ctx_destroy(ctx);
+    return 0;
+}
+
+
+
+/**
+ * Ensure a pipelined query that misses the top visual falls back to the next one like sync mode.
+ *
+ * @param suite the active test suite
+ * @param item the active test item
+ * @return 0 on success
+ */
+int test_scene_point_query_pipelined_falls_back_like_sync(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    ANN(item);
+    TST_SCENE_QUERY_REQUIRE_VKLITE(suite);
+
+    DvzGpuCtxConfig gpu_cfg = dvz_testing_gpu_ctx_config(suite);
+    VkPhysicalDeviceVulkan13Features features13 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+    features13.dynamicRendering = true;
+    features13.synchronization2 = true;
+    dvz_gpu_ctx_config_features13(&gpu_cfg, &features13);
+    DvzGpuCtx* ctx = dvz_gpu_ctx(&gpu_cfg);
+    if (ctx == NULL)
+    {
+        tst_skip(suite, "GPU context creation failed");
+        return 0;
+    }
+
+    DvzScene* scene = dvz_scene();
+    ANN(scene);
+    DvzFigure* figure = dvz_figure(scene, 64, 64, 0);
+    ANN(figure);
+    DvzPanel* panel = dvz_panel(
+        figure, &(DvzPanelDesc){.x = 0.0f, .y = 0.0f, .width = 1.0f, .height = 1.0f});
+    ANN(panel);
+
+    // The lower visual covers the panel center; the upper one, added last, does not.
+    DvzVisual* lower = dvz_point(scene, 0);
+    ANN(lower);
+    dvz_visual_set_query_capabilities(lower, DVZ_QUERY_CAPABILITY_ITEM);
+    vec3 lower_position[1] = {{0.0f, 0.0f, 0.0f}};
+    DvzColor lower_color[1] = {{255, 255, 255, 255}};
+    float lower_size[1] = {24.0f};
+    AT(dvz_visual_set_data(lower, "position", lower_position, 1) == 0);
+    AT(dvz_visual_set_data(lower, "color", lower_color, 1) == 0);
+    AT(dvz_visual_set_data(lower, "size", lower_size, 1) == 0);
+    AT(dvz_panel_add_visual(panel, lower, NULL) == 0);
+
+    DvzVisual* upper = dvz_point(scene, 0);
+    ANN(upper);
+    dvz_visual_set_query_capabilities(upper, DVZ_QUERY_CAPABILITY_ITEM);
+    vec3 upper_position[1] = {{-0.6f, 0.0f, 0.0f}};
+    DvzColor upper_color[1] = {{255, 0, 0, 255}};
+    float upper_size[1] = {8.0f};
+    AT(dvz_visual_set_data(upper, "position", upper_position, 1) == 0);
+    AT(dvz_visual_set_data(upper, "color", upper_color, 1) == 0);
+    AT(dvz_visual_set_data(upper, "size", upper_size, 1) == 0);
+    AT(dvz_panel_add_visual(panel, upper, NULL) == 0);
+
+    DvzDrp2RuntimeConfig runtime_cfg =
+        dvz_drp2_runtime_vklite_config(dvz_gpu_ctx_device(ctx), dvz_gpu_ctx_alloc(ctx));
+    DvzDrp2Runtime* runtime = dvz_drp2_runtime_vklite(&runtime_cfg);
+    ANN(runtime);
+
+    DvzCapabilitySnapshot caps = dvz_capability_snapshot();
+    caps.shader_format_glsl = true;
+
+    DvzQueryRequest request = {
+        DVZ_STRUCT_INIT_FIELDS(DvzQueryRequest), .request_id = 801,
+        .target = DVZ_SCENE_TARGET_ITEM};
+    AT(dvz_panel_query_px(panel, 32.0, 32.0, &request) == 0);
+    AT(dvz_figure_process_queries(figure, runtime, &caps) == 1);
+    DvzQueryResult sync = {0};
+    AT(dvz_scene_poll_query(scene, &sync));
+    AT(sync.hit);
+    AT(sync.visual_id == _scene_visual_public_id(scene, lower));
+
+    // The upper readback misses one frame after submission, the request is queued again below
+    // it, and the lower readback is delivered one frame after that.
+    AT(dvz_scene_set_query_latency(scene, 1) == 0);
+    request.request_id = 802;
+    AT(dvz_panel_query_px(panel, 32.0, 32.0, &request) == 0);
+    DvzQueryResult pipelined = {0};
+    AT(dvz_figure_process_queries(figure, runtime, &caps) == 1);
+    AT(dvz_figure_process_queries(figure, runtime, &caps) == 0);
+    AT(!dvz_scene_poll_query(scene, &pipelined));
+    AT(scene->pending_query_count == 1);
+    AT(scene->pending_queries[0].resume_after == upper);
+    AT(dvz_figure_process_queries(figure, runtime, &caps) == 1);
+    AT(!dvz_scene_poll_query(scene, &pipelined));
+    AT(dvz_figure_process_queries(figure, runtime, &caps) == 0);
+    AT(dvz_scene_poll_query(scene, &pipelined));
+    AT(scene->query_executor.pipeline_submit_count == 2);
+    AT(scene->query_executor.pipeline_collect_count == 2);
+
+    AT(pipelined.request_id == 802);
+    AT(pipelined.status == sync.status);
+    AT(pipelined.hit == sync.hit);
+    AT(pipelined.visual_id == sync.visual_id);
+    AT(pipelined.visual_family == sync.visual_family);
+    AT(pipelined.item_id == sync.item_id);
+    AT(!dvz_scene_poll_query(scene, &pipelined));
+
+    dvz_scene_destroy(scene);
+    dvz_drp2_runtime_destroy(runtime);
+    dvz_gpu_ctx_destroy(ctx);
+    return 0;
+}
+
+
+
 /**
  * Ensure image sample queries fail explicitly when GPU readback fails.
  *
@@ -4050,6 +4558,86 @@ int test_scene_query_processes_item_and_pixel_results(TstContext* suite, const T
 
 
 
+/**
+ * Ensure the region selection compute pass matches the CPU selection bitmask.
+ *
+ * @param suite the active test suite
+ * @param item the active test item
+ * @return 0 on success
+ */
+int test_scene_query_region_selection_gpu_matches_cpu(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    ANN(item);
+    TST_SCENE_QUERY_REQUIRE_VKLITE(suite);
+
+    DvzGpuCtxConfig gpu_cfg = dvz_testing_gpu_ctx_config(suite);
+    VkPhysicalDeviceVulkan13Features features13 = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
+    features13.dynamicRendering = true;
+    features13.synchronization2 = true;
+    dvz_gpu_ctx_config_features13(&gpu_cfg, &features13);
+    DvzGpuCtx* ctx = dvz_gpu_ctx(&gpu_cfg);
+    if (ctx == NULL)
+    {
+        tst_skip(suite, "GPU context creation failed");
+        return 0;
+    }
+    DvzDrp2RuntimeConfig runtime_cfg =
+        dvz_drp2_runtime_vklite_config(dvz_gpu_ctx_device(ctx), dvz_gpu_ctx_alloc(ctx));
+    DvzDrp2Runtime* runtime = dvz_drp2_runtime_vklite(&runtime_cfg);
+    ANN(runtime);
+
+    const uint32_t count = 5000;
+    vec3* position = (vec3*)calloc(count, sizeof(vec3));
+    ANN(position);
+    _test_region_selection_positions(position, count);
+
+    DvzScene* scene = dvz_scene();
+    ANN(scene);
+    DvzVisual* points = dvz_point(scene, 0);
+    ANN(points);
+    AT(dvz_visual_set_data(points, "position", position, count) == 0);
+    AT(dvz_visual_set_region_selection_runtime(points, runtime) == 0);
+    // The selection keeps its own runtime on the same device.
+    dvz_drp2_runtime_destroy(runtime);
+
+    double rect_min[2] = {2.0, 3.0}, rect_max[2] = {6.5, 7.0};
+    AT(dvz_visual_select_rect(points, rect_min, rect_max) == 0);
+    AT(_test_region_selection_matches(points, position, count, rect_min, rect_max, NULL, 0));
+
+    double lasso[2 * 12] = {0};
+    for (uint32_t i = 0; i < 12; i++)
+    {
+        double angle = 2.0 * DVZ_PI * i / 12.0;
+        double radius = i % 2 == 0 ? 4.0 : 2.5;
+        lasso[2 * i + 0] = 5.0 + radius * cos(angle);
+        lasso[2 * i + 1] = 5.0 + radius * sin(angle);
+    }
+    double lasso_min[2] = {0.0, 0.0}, lasso_max[2] = {10.0, 10.0};
+    for (uint32_t n = 3; n <= 12; n++)
+    {
+        AT(dvz_visual_select_lasso(points, lasso, n) == 0);
+        AT(_test_region_selection_matches(
+            points, position, count, lasso_min, lasso_max, lasso, n));
+    }
+
+    // New positions are uploaded again before the next pass.
+    position[0][0] = 5.0f;
+    position[0][1] = 5.0f;
+    AT(dvz_visual_set_data_range(points, "position", 0, position, 1) == 0);
+    AT(dvz_visual_select_lasso(points, lasso, 12) == 0);
+    AT(_test_region_selection_matches(points, position, count, lasso_min, lasso_max, lasso, 12));
+    AT((dvz_visual_region_selection_mask(points, NULL)[0] & 1u) == 1);
+
+    dvz_scene_destroy(scene);
+    free(position);
+    dvz_gpu_ctx_destroy(ctx);
+    return 0;
+}
+
+
+
 /**
  * Register scene query tests.
  *
@@ -4075,12 +4663,16 @@ int test_scene_query(TstSuite* suite)
     TST_CASE(test_scene_query_rejects_missing_query_profile);
     TST_CASE(test_scene_query_does_not_auto_select_2xr32_profile);
     TST_CASE(test_scene_query_rejects_family_unsupported_profile);
+    TST_CASE(test_scene_query_spatial_index_resolves_without_gpu);
+    TST_CASE(test_scene_query_region_selection_bitmask);
     TST_CASE(test_scene_image_query_plan_preserves_linear_color_role);
     TST_SCENE_QUERY_GPU_CASE(test_scene_image_query_resolves_sample);
     TST_SCENE_QUERY_GPU_CASE(test_scene_image_query_linear_color_sample_not_decoded);
     TST_SCENE_QUERY_GPU_CASE(test_scene_image_query_generated_rect_samples_position);
     TST_SCENE_QUERY_GPU_CASE(test_scene_image_query_panzoom_samples_transformed_position);
     TST_SCENE_QUERY_GPU_CASE(test_scene_image_query_reuses_retained_request_executor);
+    TST_SCENE_QUERY_GPU_CASE(test_scene_image_query_pipelines_readbacks);
+    TST_SCENE_QUERY_GPU_CASE(test_scene_point_query_pipelined_falls_back_like_sync);
     TST_SCENE_QUERY_GPU_CASE(test_scene_image_sample_query_readback_failure);
     TST_SCENE_QUERY_GPU_CASE(test_scene_point_query_misses_empty_pixel);
     TST_SCENE_QUERY_GPU_CASE(test_scene_point_query_item_range_global_identity);
@@ -4114,6 +4706,7 @@ int test_scene_query(TstSuite* suite)
     TST_CASE(test_scene_labels_query_rejects_unsupported_format);
     TST_SCENE_QUERY_GPU_CASE(test_scene_labels_query_readback_failure);
     TST_SCENE_QUERY_GPU_CASE(test_scene_query_processes_item_and_pixel_results);
+    TST_SCENE_QUERY_GPU_CASE(test_scene_query_region_selection_gpu_matches_cpu);
 
     return 0;
 }
@@ -60,6 +60,7 @@ int test_scene_graph(TstSuite* suite)
     TST_CASE(test_scene_mesh_geometry_replacement_uses_logical_index_count);
     TST_CASE(test_scene_mesh_geometry_unchanged_indices_skip_upload);
     TST_CASE(test_scene_mesh_geometry_replacement_switches_indexing);
+    TST_CASE(test_scene_mesh_surface_field_uploads_dirty_rows);
     TST_CASE(test_scene_mesh_instance_count_shrink_uses_logical_extent);
     TST_CASE(test_scene_mesh_geometry_replacement_failure_rolls_back);
     TST_CASE(test_scene_mesh_instance_transform_emits_instanced_draw);
@@ -139,6 +140,8 @@ int test_scene_graph(TstSuite* suite)
     TST_CASE(test_scene_frame_plan_missing_graph_pass_fails_contract);
     TST_CASE(test_scene_panel_composition_binding_is_one_to_one);
     TST_CASE(test_scene_render_contract_rejects_untyped_visual_metadata);
+    TST_CASE(test_scene_render_contract_memo_reuses_clean_passes);
+    TST_CASE(test_scene_frame_arena_steady_state);
     TST_CASE(test_scene_panel_graph_failure_reports_specific_diagnostic);
     TST_CASE(test_scene_gbuffer_runtime_lowering);
     TST_CASE(test_scene_surface_products_single_sample_contract);
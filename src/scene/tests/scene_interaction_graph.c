@@ -1354,26 +1354,23 @@ int test_scene_panel_plot_clip_rect_metadata(TstContext* suite, const TstCase* i
                 fabsf(cmd->u.set_scissor.scissor[3] - plot_rect.height) < 1e-6f)
                 saw_plot_scissor = true;
         }
-        else if (
-            cmd->type == DVZ_DRP2_COMMAND_WRITE_BUFFER &&
-            cmd->u.write_buffer.size == sizeof(DvzSceneViewportUniform))
+    }
+    DvzSceneViewportUniform viewports[DVZ_SCENE_COMMON_MIN_SLOTS] = {0};
+    uint32_t viewport_uniform_count =
+        _stream_common_viewports(stream, viewports, DVZ_SCENE_COMMON_MIN_SLOTS);
+    for (uint32_t i = 0; i < viewport_uniform_count; i++)
+    {
+        const DvzSceneViewportUniform* viewport = &viewports[i];
+        if (fabsf(viewport->x) < 1e-6f && fabsf(viewport->y) < 1e-6f &&
+            fabsf(viewport->width - 128.0f) < 1e-6f && fabsf(viewport->height - 96.0f) < 1e-6f)
         {
-            const DvzSceneViewportUniform* viewport =
-                (const DvzSceneViewportUniform*)cmd->u.write_buffer.data_raw;
-            ANN(viewport);
-            if (fabsf(viewport->x) < 1e-6f && fabsf(viewport->y) < 1e-6f &&
-                fabsf(viewport->width - 128.0f) < 1e-6f &&
-                fabsf(viewport->height - 96.0f) < 1e-6f)
-            {
-                saw_panel_viewport_uniform = true;
-            }
-            if (fabsf(viewport->x - plot_rect.x) < 1e-6f &&
-                fabsf(viewport->y - plot_rect.y) < 1e-6f &&
-                fabsf(viewport->width - plot_rect.width) < 1e-6f &&
-                fabsf(viewport->height - plot_rect.height) < 1e-6f)
-            {
-                saw_plot_viewport_uniform = true;
-            }
+            saw_panel_viewport_uniform = true;
+        }
+        if (fabsf(viewport->x - plot_rect.x) < 1e-6f && fabsf(viewport->y - plot_rect.y) < 1e-6f &&
+            fabsf(viewport->width - plot_rect.width) < 1e-6f &&
+            fabsf(viewport->height - plot_rect.height) < 1e-6f)
+        {
+            saw_plot_viewport_uniform = true;
         }
     }
     AT(viewport_count >= 2);
@@ -2143,22 +2140,11 @@ int test_scene_controller_mode_fixed_emits_separate_mvp(TstContext* suite, const
     AT(dvz_diagnostic_report_count(&report) == 0);
     ANN(stream);
 
-    char* json = dvz_drp2_stream_json(stream, "controller_mode_test");
-    ANN(json);
-
-    /* Two distinct MVP UBOs (size 208 = sizeof(DvzMVP) + std140 padding) must be
-     * created, one for APPLY and one for FIXED. The common set now also carries a
-     * panel viewport uniform, so FIXED common bind groups are panel-scoped. */
-    uint32_t mvp_buffers = 0;
-    const char* p = json;
-    while ((p = strstr(p, "\"size\": 208, \"usage\": [\"COPY_DST\"")) != NULL)
-    {
-        mvp_buffers++;
-        p += 1;
-    }
-    AT(mvp_buffers == 2);
+    /* Two distinct common uniform ring slots must be bound, one for APPLY and one for
+     * FIXED. The common set also carries a panel viewport uniform, so FIXED common slots
+     * are panel-scoped. */
+    AT(_stream_common_slot_count(stream) == 2);
 
-    dvz_drp2_stream_json_destroy(json);
     _test_scene_stream_destroy(stream);
     dvz_scene_destroy(scene);
     return 0;
@@ -2171,7 +2157,7 @@ int test_scene_split_pass_visuals_emit_separate_common_mvp(TstContext* suite, co
     (void)item;
 
     /* Opaque and blended visuals are emitted in separate render nodes. Both become
-     * local visual slot 0 in their pass, so common binding identity must include
+     * local visual slot 0 in their pass, so common ring slot identity must include
      * stable visual/pass identity and not just the local slot index. */
     DvzScene* scene = dvz_scene();
     DvzFigure* figure = dvz_figure(scene, 64, 64, 0);
@@ -2218,7 +2204,7 @@ int test_scene_split_pass_visuals_emit_separate_common_mvp(TstContext* suite, co
     AT(common_layout_id != 0);
 
     uint32_t common_bg_count = 0;
-    uint64_t mvp_buffers[2] = {0};
+    uint64_t ring_id = 0;
     for (uint32_t i = 0; i < dvz_drp2_stream_count(stream); i++)
     {
         const DvzDrp2Command* cmd = dvz_drp2_stream_get(stream, i);
@@ -2232,19 +2218,24 @@ int test_scene_split_pass_visuals_emit_separate_common_mvp(TstContext* suite, co
         AT(mvp->binding == DVZ_SCENE_SHADER_BINDING_COMMON_MVP);
         AT(mvp->binding_type == DVZ_DRP2_BINDING_TYPE_UNIFORM_BUFFER);
         AT(mvp->resource_kind == DVZ_DRP2_BINDING_RESOURCE_BUFFER);
+        ring_id = mvp->resource_id;
+        const char* ring_label = dvz_drp2_stream_label(stream, ring_id);
+        ANN(ring_label);
+        AT(strncmp(ring_label, DVZ_SCENE_COMMON_RING_KEY, strlen(DVZ_SCENE_COMMON_RING_KEY)) == 0);
+        AT(mvp->offset == 0);
         AT(mvp->size == sizeof(DvzMVP));
         AT(viewport->binding == DVZ_SCENE_SHADER_BINDING_COMMON_VIEWPORT);
         AT(viewport->binding_type == DVZ_DRP2_BINDING_TYPE_UNIFORM_BUFFER);
         AT(viewport->resource_kind == DVZ_DRP2_BINDING_RESOURCE_BUFFER);
+        AT(viewport->resource_id == ring_id);
+        AT(viewport->offset == DVZ_SCENE_COMMON_UNIFORM_ALIGNMENT);
         AT(viewport->size == sizeof(DvzSceneViewportUniform));
-        AT(common_bg_count < DVZ_ARRAY_COUNT(mvp_buffers));
-        mvp_buffers[common_bg_count++] = mvp->resource_id;
+        common_bg_count++;
     }
 
-    AT(common_bg_count == 2);
-    AT(mvp_buffers[0] != 0);
-    AT(mvp_buffers[1] != 0);
-    AT(mvp_buffers[0] != mvp_buffers[1]);
+    /* Both passes share the ring bind group and select distinct slots by dynamic offset. */
+    AT(common_bg_count == 1);
+    AT(_stream_common_slot_count(stream) == 2);
 
     _test_scene_stream_destroy(stream);
     dvz_scene_destroy(scene);
@@ -14,6 +14,7 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include "core/figure_emit_internal.h"
 #include "frame_plan/internal.h"
 #include "render_contract/internal.h"
 #include "runtime/_frame_plan_runtime_internal.h"
@@ -2056,6 +2057,167 @@ int test_scene_render_contract_rejects_untyped_visual_metadata(
 }
 
 
+/**
+ * Verify clean render contracts are memoized across figure emissions.
+ *
+ * @param suite the active test suite
+ * @param item the active test item
+ * @return 0 on success
+ */
+int test_scene_render_contract_memo_reuses_clean_passes(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzScene* scene = dvz_scene();
+    ANN(scene);
+    DvzFigure* figure = dvz_figure(scene, 128, 128, 0);
+    ANN(figure);
+
+    vec3 pos[1] = {{0.25f, 0.25f, 0.0f}};
+    DvzColor col[1] = {{255, 0, 0, 255}};
+    float sz[1] = {8.0f};
+    DvzVisual* visuals[4] = {0};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        DvzPanel* panel = dvz_panel(
+            figure, &(DvzPanelDesc){0.5f * (float)(i % 2), 0.5f * (float)(i / 2), 0.5f, 0.5f});
+        ANN(panel);
+        visuals[i] = dvz_point(scene, 0);
+        ANN(visuals[i]);
+        AT(dvz_visual_set_data(visuals[i], "position", pos, 1) == 0);
+        AT(dvz_visual_set_data(visuals[i], "color", col, 1) == 0);
+        AT(dvz_visual_set_data(visuals[i], "size", sz, 1) == 0);
+        AT(dvz_panel_add_visual(panel, visuals[i], NULL) == 0);
+    }
+
+    DvzCapabilitySnapshot caps = dvz_capability_snapshot();
+    caps.shader_format_glsl = true;
+    caps.max_vertex_buffers = 16;
+    caps.max_bind_groups = 4;
+    caps.max_buffer_size = 256 * 1024 * 1024;
+    DvzFramePlanEmitConfig cfg = dvz_frame_plan_emit_config();
+    cfg.shader_format = DVZ_SCENE_SHADER_FORMAT_GLSL;
+    _scene_figure_emit_timing_enable(figure, true);
+
+    /* The first emission validates every contract. */
+    DvzDiagnosticReport report = {0};
+    dvz_diagnostic_report_init(&report);
+    DvzDrp2CommandStream* stream = _test_scene_emit_stream_ex(figure, &caps, &report, &cfg);
+    ANN(stream);
+    AT(dvz_diagnostic_report_count(&report) == 0);
+    DvzSceneEmitTiming timing = {0};
+    AT(_scene_figure_emit_timing_get(figure, &timing));
+    uint32_t pass_count = timing.contract_pass_count;
+    AT(pass_count >= 4);
+    AT(timing.contract_memo_hit_count == 0);
+    _test_scene_stream_destroy(stream);
+
+    /* Data-only edits leave every pass contract structurally unchanged. */
+    vec3 moved[1] = {{-0.5f, 0.5f, 0.0f}};
+    AT(dvz_visual_set_data(visuals[0], "position", moved, 1) == 0);
+    dvz_diagnostic_report_init(&report);
+    stream = _test_scene_emit_stream_ex(figure, &caps, &report, &cfg);
+    ANN(stream);
+    AT(dvz_diagnostic_report_count(&report) == 0);
+    AT(_scene_figure_emit_timing_get(figure, &timing));
+    AT(timing.contract_pass_count == pass_count);
+    AT(timing.contract_memo_hit_count == pass_count);
+    _test_scene_stream_destroy(stream);
+
+    /* Capability changes alter the resolved sample counts, so nothing is reused. */
+    caps.max_color_sample_count = 1;
+    caps.max_depth_sample_count = 1;
+    dvz_diagnostic_report_init(&report);
+    stream = _test_scene_emit_stream_ex(figure, &caps, &report, &cfg);
+    ANN(stream);
+    AT(_scene_figure_emit_timing_get(figure, &timing));
+    AT(timing.contract_memo_hit_count == 0);
+    _test_scene_stream_destroy(stream);
+
+    dvz_scene_destroy(scene);
+    return 0;
+}
+
+
+
+/**
+ * Verify camera-only emissions reuse the figure frame arena without growing it.
+ *
+ * @param suite the active test suite
+ * @param item the active test item
+ * @return 0 on success
+ */
+int test_scene_frame_arena_steady_state(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzScene* scene = dvz_scene();
+    ANN(scene);
+    DvzFigure* figure = dvz_figure(scene, 128, 128, 0);
+    ANN(figure);
+    DvzPanel* panel = dvz_panel(figure, &(DvzPanelDesc){0.0f, 0.0f, 1.0f, 1.0f});
+    ANN(panel);
+
+    vec3 pos[2] = {{0.25f, 0.25f, 0.0f}, {-0.25f, -0.25f, 0.0f}};
+    DvzColor col[2] = {{255, 0, 0, 255}, {0, 255, 0, 255}};
+    float sz[2] = {8.0f, 8.0f};
+    DvzVisual* points = dvz_point(scene, 0);
+    ANN(points);
+    AT(dvz_visual_set_data(points, "position", pos, 2) == 0);
+    AT(dvz_visual_set_data(points, "color", col, 2) == 0);
+    AT(dvz_visual_set_data(points, "size", sz, 2) == 0);
+    AT(dvz_panel_add_visual(panel, points, NULL) == 0);
+
+    DvzCapabilitySnapshot caps = dvz_capability_snapshot();
+    caps.shader_format_glsl = true;
+    caps.max_vertex_buffers = 16;
+    caps.max_bind_groups = 4;
+    caps.max_buffer_size = 256 * 1024 * 1024;
+    DvzFramePlanEmitConfig cfg = dvz_frame_plan_emit_config();
+    cfg.shader_format = DVZ_SCENE_SHADER_FORMAT_GLSL;
+
+    /* The first emission sizes the arena on its full upload set. */
+    DvzDiagnosticReport report = {0};
+    dvz_diagnostic_report_init(&report);
+    DvzDrp2CommandStream* stream = _test_scene_emit_stream_ex(figure, &caps, &report, &cfg);
+    ANN(stream);
+    AT(dvz_diagnostic_report_count(&report) == 0);
+    _test_scene_stream_destroy(stream);
+    ANN(figure->frame_arena);
+    DvzArenaStats stats = dvz_arena_stats(figure->frame_arena);
+    AT(stats.used > 0);
+    uint64_t reset_count = stats.reset_count;
+
+    /* One more emission lets a cycle that overflowed its first chunk coalesce on reset. */
+    dvz_diagnostic_report_init(&report);
+    stream = _test_scene_emit_stream_ex(figure, &caps, &report, &cfg);
+    ANN(stream);
+    _test_scene_stream_destroy(stream);
+    uint64_t chunk_allocs = dvz_arena_stats(figure->frame_arena).chunk_allocs;
+
+    /* Camera-only frames rebuild the FramePlan in place. */
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        double shift = 0.1 * (double)(i + 1);
+        AT(dvz_panel_set_domain(panel, DVZ_DIM_X, -1.0 + shift, 1.0 + shift) == 0);
+        dvz_diagnostic_report_init(&report);
+        stream = _test_scene_emit_stream_ex(figure, &caps, &report, &cfg);
+        ANN(stream);
+        AT(dvz_diagnostic_report_count(&report) == 0);
+        _test_scene_stream_destroy(stream);
+    }
+    stats = dvz_arena_stats(figure->frame_arena);
+    AT(stats.chunk_allocs == chunk_allocs);
+    AT(stats.chunk_count == 1);
+    AT(stats.reset_count == reset_count + 9);
+
+    dvz_scene_destroy(scene);
+    return 0;
+}
+
+
 /**
  * Verify panel graph-emission failures are threaded into diagnostics.
  *
@@ -373,6 +373,8 @@ int test_frame_plan_graph_validation_attachment_extent(TstContext* suite, const
 
 int test_frame_plan_graph_validation_pass_kind(TstContext* suite, const TstCase* item);
 
+int test_frame_plan_graph_alias_disjoint_targets(TstContext* suite, const TstCase* item);
+
 int test_frame_plan_emit_drp2_static_render(TstContext* suite, const TstCase* item);
 
 int test_frame_plan_emit_drp2_static_render_glsl(TstContext* suite, const TstCase* item);
@@ -468,6 +470,8 @@ int test_scene_mesh_geometry_unchanged_indices_skip_upload(
 int test_scene_mesh_geometry_replacement_switches_indexing(
     TstContext* suite, const TstCase* item);
 
+int test_scene_mesh_surface_field_uploads_dirty_rows(TstContext* suite, const TstCase* item);
+
 int test_scene_mesh_instance_count_shrink_uses_logical_extent(
     TstContext* suite, const TstCase* item);
 
@@ -796,6 +800,9 @@ int test_scene_visual_field_rejects_cross_scene_field(TstContext* suite, const T
 
 int test_scene_sampled_field_update_region(TstContext* suite, const TstCase* item);
 
+int test_scene_sampled_field_ring_origin_updates_logical_rows(
+    TstContext* suite, const TstCase* item);
+
 int test_scene_sampled_field_rejects_unsupported_format(TstContext* suite, const TstCase* item);
 
 int test_scene_image_visual_rejects_3d_field(TstContext* suite, const TstCase* item);
@@ -888,6 +895,10 @@ int test_scene_panel_local_resize_refresh(TstContext* suite, const TstCase* item
 int test_scene_render_contract_rejects_untyped_visual_metadata(
     TstContext* suite, const TstCase* item);
 
+int test_scene_render_contract_memo_reuses_clean_passes(TstContext* suite, const TstCase* item);
+
+int test_scene_frame_arena_steady_state(TstContext* suite, const TstCase* item);
+
 int test_scene_panel_graph_failure_reports_specific_diagnostic(
     TstContext* suite, const TstCase* item);
 
@@ -1073,6 +1084,11 @@ int test_scene_query_registry_covers_active_visual_families(
 int test_scene_image_query_reuses_retained_request_executor(
     TstContext* suite, const TstCase* item);
 
+int test_scene_image_query_pipelines_readbacks(TstContext* suite, const TstCase* item);
+
+int test_scene_point_query_pipelined_falls_back_like_sync(
+    TstContext* suite, const TstCase* item);
+
 int test_scene_query_rejects_untyped_render_plan(TstContext* suite, const TstCase* item);
 
 int test_scene_query_queue_processes_native_results(TstContext* suite, const TstCase* item);
@@ -1096,6 +1112,12 @@ int test_scene_query_does_not_auto_select_2xr32_profile(TstContext* suite, const
 
 int test_scene_query_rejects_family_unsupported_profile(TstContext* suite, const TstCase* item);
 
+int test_scene_query_spatial_index_resolves_without_gpu(TstContext* suite, const TstCase* item);
+
+int test_scene_query_region_selection_bitmask(TstContext* suite, const TstCase* item);
+
+int test_scene_query_region_selection_gpu_matches_cpu(TstContext* suite, const TstCase* item);
+
 int test_scene_image_query_resolves_sample(TstContext* suite, const TstCase* item);
 
 int test_scene_image_query_plan_preserves_linear_color_role(
@@ -1330,11 +1352,15 @@ int test_scene_text_atlas_product_builds_source_ascii(TstContext* suite, const T
 
 int test_scene_text_atlas_product_is_deterministic(TstContext* suite, const TstCase* item);
 
+int test_scene_text_atlas_product_pool_cache(TstContext* suite, const TstCase* item);
+
 int test_scene_text_atlas_product_budget_failure_is_empty(TstContext* suite, const TstCase* item);
 
 int test_scene_text_atlas_capacity_failure_rolls_back(
     TstContext* suite, const TstCase* item);
 
+int test_scene_text_atlas_incremental_append(TstContext* suite, const TstCase* item);
+
 int test_scene_text_scientific_fallback_all_backends(TstContext* suite, const TstCase* item);
 
 int test_scene_text_public_font_atlas_api(TstContext* suite, const TstCase* item);
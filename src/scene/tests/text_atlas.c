@@ -16,6 +16,7 @@
 
 #include <limits.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <string.h>
 
 #include "_alloc.h"
@@ -32,6 +33,7 @@
 #include "text/internal.h"
 #include "text/text_atlas_product_internal.h"
 #include "text/text_internal.h"
+#include "thread_internal.h"
 #include "test_scene.h"
 #include "testing.h"
 
@@ -519,6 +521,81 @@ int test_scene_text_atlas_product_is_deterministic(TstContext* suite, const TstC
 
 
 
+/**
+ * Verify pool-generated products match serial ones and round-trip through the disk cache.
+ *
+ * @param suite the active test suite
+ * @param item the active test item
+ * @return 0 on success
+ */
+int test_scene_text_atlas_product_pool_cache(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+    if (!_text_atlas_product_msdf_available())
+    {
+        tst_skip(suite, "MSDF atlas generation unavailable");
+        return 0;
+    }
+
+    DvzScene* scene = NULL;
+    DvzTextAtlasFontView primary = {0};
+    AT(_text_atlas_product_source_view(&scene, &primary));
+    uint32_t codepoints[94] = {0};
+    for (uint32_t i = 0; i < 94; i++)
+        codepoints[i] = 0x21u + i;
+    DvzTextAtlasSpec spec = _scene_text_atlas_spec(DVZ_TEXT_ATLAS_BACKEND_MSDF, 32.0f);
+    DvzTextAtlasProductBudget budget = _text_atlas_product_budget_default();
+    DvzTextAtlasProductParams params = _text_atlas_product_params_default();
+    params.thread_count = 1;
+    DvzThreadPool* pool = dvz_thread_pool(4);
+    ANN(pool);
+    DvzTextAtlasProduct serial = {0};
+    DvzTextAtlasProduct pooled = {0};
+    DvzTextAtlasProduct loaded = {0};
+
+    AT(_text_atlas_product_build_msdf(
+        &primary, NULL, &spec, codepoints, 94, &budget, &params, &serial));
+    AT(_text_atlas_product_build_msdf_pool(
+        &primary, NULL, &spec, codepoints, 94, &budget, &params, pool, &pooled));
+    AT(serial.rgba_size == pooled.rgba_size);
+    AT(serial.glyph_count == pooled.glyph_count);
+    AT(memcmp(serial.rgba, pooled.rgba, (size_t)serial.rgba_size) == 0);
+    AT(memcmp(
+           serial.glyphs, pooled.glyphs,
+           (size_t)serial.glyph_count * sizeof(DvzTextAtlasGlyph)) == 0);
+
+    // The thread count does not change the product, so it does not change the key either.
+    uint64_t key = _text_atlas_product_cache_key(&primary, NULL, &spec, codepoints, 94, &params);
+    params.thread_count = 8;
+    AT(_text_atlas_product_cache_key(&primary, NULL, &spec, codepoints, 94, &params) == key);
+    AT(_text_atlas_product_cache_key(&primary, NULL, &spec, codepoints, 93, &params) != key);
+
+    char path[TST_PATH_MAX] = {0};
+    AT(tst_tmp_path("dvz_text_atlas_product.dtap", path, sizeof(path)) == 0);
+    AT(_text_atlas_product_save(&pooled, key, path));
+    AT(!_text_atlas_product_load(path, key + 1, &budget, &loaded));
+    AT(loaded.rgba == NULL);
+    AT(_text_atlas_product_load(path, key, &budget, &loaded));
+    AT(loaded.width == pooled.width);
+    AT(loaded.height == pooled.height);
+    AT(loaded.coverage_count == pooled.coverage_count);
+    AT(memcmp(loaded.rgba, pooled.rgba, (size_t)pooled.rgba_size) == 0);
+    AT(memcmp(
+           loaded.coverage, pooled.coverage,
+           (size_t)pooled.coverage_count * sizeof(DvzTextAtlasProductCoverage)) == 0);
+    remove(path);
+
+    _text_atlas_product_destroy(&loaded);
+    _text_atlas_product_destroy(&pooled);
+    _text_atlas_product_destroy(&serial);
+    dvz_thread_pool_destroy(pool);
+    dvz_scene_destroy(scene);
+    return 0;
+}
+
+
+
 /**
  * Verify a CPU atlas product budget failure leaves the output object empty.
  *
@@ -623,6 +700,101 @@ int test_scene_text_atlas_capacity_failure_rolls_back(TstContext* suite, const T
 }
 
 
+/**
+ * Verify new glyphs are appended to a live atlas without moving existing glyphs.
+ *
+ * @param suite the active test suite
+ * @param item the active test item
+ * @return 0 on success
+ */
+int test_scene_text_atlas_incremental_append(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    DvzScene* scene = dvz_scene();
+    ANN(scene);
+    DvzFontDesc desc = dvz_font_desc();
+    desc.family = "Source Sans 3";
+    desc.style = "Regular";
+    DvzFont* font = dvz_font(scene, &desc);
+    ANN(font);
+
+    DvzTextAtlasSpec spec = _scene_text_atlas_spec(DVZ_TEXT_ATLAS_BACKEND_STB_SDF, 32.0f);
+    AT(_scene_text_atlas_ensure_string(font, &spec, "ASCII"));
+    DvzTextAtlas* atlas = _scene_text_atlas_get(font, &spec);
+    ANN(atlas);
+    ANN(atlas->field);
+    const DvzSampledField* field = atlas->field;
+    uint32_t width = atlas->width;
+    uint32_t height = atlas->height;
+    uint32_t glyph_count = atlas->glyph_count;
+    uint64_t generation = atlas->generation;
+    const DvzTextAtlasGlyph* initial_a = _scene_text_atlas_glyph(atlas, 'A');
+    ANN(initial_a);
+    DvzTextAtlasGlyph a = *initial_a;
+    uint32_t a_x = (uint32_t)a.atlas_bounds[0];
+    uint32_t a_y = (uint32_t)a.atlas_bounds[1];
+    uint32_t a_w = (uint32_t)(a.atlas_bounds[2] - a.atlas_bounds[0]);
+    uint32_t a_h = (uint32_t)(a.atlas_bounds[3] - a.atlas_bounds[1]);
+    AT(a_w > 0 && a_w <= 128);
+    AT(a_h > 0 && a_h <= 128);
+    uint8_t a_pixels[128 * 128 * 4] = {0};
+    const uint8_t* data = (const uint8_t*)field->data;
+    for (uint32_t y = 0; y < a_h; y++)
+        memcpy(
+            a_pixels + (uint64_t)y * a_w * 4u,
+            data + ((uint64_t)(a_y + y) * width + a_x) * 4u, (size_t)a_w * 4u);
+
+    // One glyph lands on the first shelf below the rows of the initial build.
+    AT(_scene_text_atlas_ensure_string(font, &spec, "caf" "\xC3" "\xA9"));
+    AT(_scene_text_atlas_get(font, &spec) == atlas);
+    AT(atlas->field == field);
+    AT(atlas->glyph_count == glyph_count + 1);
+    AT(atlas->generation > generation);
+    AT(atlas->width == width);
+    AT(atlas->shelves.count == 1);
+    const DvzTextAtlasGlyph* e_acute = _scene_text_atlas_glyph(atlas, 0x00E9u);
+    ANN(e_acute);
+    AT(e_acute->valid);
+    AT(e_acute->atlas_bounds[1] >= (float)height);
+    AT(e_acute->uv[3] <= 1.0f);
+
+    // Enough glyphs to fill the shelves force the atlas to grow in place.
+    char encoded[96][3] = {{0}};
+    for (uint32_t i = 0; i < 96; i++)
+    {
+        uint32_t codepoint = 0x0100u + i;
+        encoded[i][0] = (char)(0xC0u | (codepoint >> 6));
+        encoded[i][1] = (char)(0x80u | (codepoint & 0x3Fu));
+        AT(_scene_text_atlas_ensure_string(font, &spec, encoded[i]));
+    }
+    AT(_scene_text_atlas_get(font, &spec) == atlas);
+    AT(atlas->field == field);
+    AT(atlas->glyph_count == glyph_count + 97);
+    AT(atlas->height > height);
+    AT(field->desc.height == atlas->height);
+
+    const DvzTextAtlasGlyph* moved_a = _scene_text_atlas_glyph(atlas, 'A');
+    ANN(moved_a);
+    for (uint32_t j = 0; j < 4; j++)
+        AC(moved_a->atlas_bounds[j], a.atlas_bounds[j], 1e-6f);
+    AC(moved_a->uv[0], a.uv[0], 1e-6f);
+    AC(moved_a->uv[2], a.uv[2], 1e-6f);
+    AC(moved_a->uv[1] * (float)atlas->height, a.uv[1] * (float)height, 1e-3f);
+    AC(moved_a->uv[3] * (float)atlas->height, a.uv[3] * (float)height, 1e-3f);
+    data = (const uint8_t*)field->data;
+    for (uint32_t y = 0; y < a_h; y++)
+        AT(memcmp(
+               a_pixels + (uint64_t)y * a_w * 4u,
+               data + ((uint64_t)(a_y + y) * width + a_x) * 4u, (size_t)a_w * 4u) == 0);
+
+    dvz_scene_destroy(scene);
+    return 0;
+}
+
+
+
 /**
  * Verify Source scene text falls back to Noto Sans Math for scientific symbols.
  *
@@ -890,8 +1062,10 @@ int test_scene_text_atlas(TstSuite* suite)
     TST_CASE(test_scene_text_atlas_product_defaults);
     TST_CASE(test_scene_text_atlas_product_builds_source_ascii);
     TST_CASE(test_scene_text_atlas_product_is_deterministic);
+    TST_CASE(test_scene_text_atlas_product_pool_cache);
     TST_CASE(test_scene_text_atlas_product_budget_failure_is_empty);
     TST_CASE(test_scene_text_atlas_capacity_failure_rolls_back);
+    TST_CASE(test_scene_text_atlas_incremental_append);
     TST_CASE(test_scene_text_scientific_fallback_all_backends);
     TST_CASE(test_scene_text_public_font_atlas_api);
     TST_SCENE_TEXT_ATLAS_GPU_CASE(test_scene_text_atlas_utf8_runtime_readback);
@@ -1494,19 +1494,18 @@ int test_scene_image_emit_uses_common_and_texture_sets(TstContext* suite, const
             if (cmd->u.set_bind_group.slot == 1)
                 found_texture_bind = true;
         }
-        else if (cmd->type == DVZ_DRP2_COMMAND_WRITE_BUFFER &&
-                 cmd->u.write_buffer.size == sizeof(DvzSceneViewportUniform))
+    }
+    DvzSceneViewportUniform viewports[DVZ_SCENE_COMMON_MIN_SLOTS] = {0};
+    uint32_t viewport_count =
+        _stream_common_viewports(stream, viewports, DVZ_SCENE_COMMON_MIN_SLOTS);
+    for (uint32_t i = 0; i < viewport_count; i++)
+    {
+        const DvzSceneViewportUniform* viewport = &viewports[i];
+        if (fabsf(viewport->width - 64.0f) <= 1e-6f && fabsf(viewport->height - 64.0f) <= 1e-6f)
         {
-            const DvzSceneViewportUniform* viewport =
-                (const DvzSceneViewportUniform*)cmd->u.write_buffer.data_raw;
-            ANN(viewport);
-            if (fabsf(viewport->width - 64.0f) <= 1e-6f &&
-                fabsf(viewport->height - 64.0f) <= 1e-6f)
-            {
-                AC(viewport->x, 0.0f, 1e-6f);
-                AC(viewport->y, 0.0f, 1e-6f);
-                found_viewport_write = true;
-            }
+            AC(viewport->x, 0.0f, 1e-6f);
+            AC(viewport->y, 0.0f, 1e-6f);
+            found_viewport_write = true;
         }
     }
     AT(found_pipeline);
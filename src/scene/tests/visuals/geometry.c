@@ -1020,6 +1020,117 @@ int test_scene_mesh_geometry_replacement_switches_indexing(TstContext* suite, co
 
 
 
+int test_scene_mesh_surface_field_uploads_dirty_rows(TstContext* suite, const TstCase* item)
+{
+    ANN(suite);
+    (void)item;
+
+    const uint32_t rows = 40;
+    const uint32_t cols = 24;
+    DvzScene* scene = dvz_scene();
+    ANN(scene);
+    DvzFigure* figure = dvz_figure(scene, 64, 64, 0);
+    ANN(figure);
+    DvzPanel* panel = dvz_panel(figure, &(DvzPanelDesc){0.0f, 0.0f, 1.0f, 1.0f});
+    ANN(panel);
+    DvzVisual* mesh = dvz_mesh(scene, 0);
+    ANN(mesh);
+    AT(dvz_panel_add_visual(panel, mesh, NULL) == DVZ_OK);
+
+    DvzGeometrySurfaceGridDesc grid_desc = dvz_geometry_surface_grid_desc();
+    grid_desc.rows = rows;
+    grid_desc.cols = cols;
+    DvzGeometry* grid = dvz_geometry_surface_grid(&grid_desc);
+    ANN(grid);
+    DvzSampledField* field = dvz_sampled_field(
+        scene, &(DvzSampledFieldDesc){
+                   DVZ_STRUCT_INIT_FIELDS(DvzSampledFieldDesc),
+                   .dim = DVZ_FIELD_DIM_2D,
+                   .format = DVZ_FIELD_FORMAT_R32_FLOAT,
+                   .semantic = DVZ_FIELD_SEMANTIC_SCALAR,
+                   .width = cols,
+                   .height = rows,
+                   .depth = 1,
+               });
+    ANN(field);
+    float heights[40 * 24] = {0};
+    DvzFieldDataView view = {DVZ_STRUCT_INIT_FIELDS(DvzFieldDataView), .data = heights};
+    AT(dvz_sampled_field_set_data(field, &view) == DVZ_OK);
+
+    // Mismatched fields and non-grid geometries are rejected.
+    DvzGeometry* other = _mesh_replacement_geometry(4, 6);
+    ANN(other);
+    AT(dvz_mesh_set_surface_field(mesh, other, field, DVZ_SCENE_SHADER_FORMAT_GLSL) == NULL);
+    grid_desc.rows = rows + 1;
+    DvzGeometry* taller = dvz_geometry_surface_grid(&grid_desc);
+    ANN(taller);
+    AT(dvz_mesh_set_surface_field(mesh, taller, field, DVZ_SCENE_SHADER_FORMAT_GLSL) == NULL);
+
+    DvzSceneCompute* compute =
+        dvz_mesh_set_surface_field(mesh, grid, field, DVZ_SCENE_SHADER_FORMAT_GLSL);
+    ANN(compute);
+    AT(compute->dispatch[0] == 2);
+    AT(compute->dispatch[1] == 3);
+    AT(compute->dispatch[2] == 1);
+    const DvzMeshSurfaceState* state = &_visual_family_state(mesh)->mesh_surface;
+    AT(state->field == field);
+    ANN(state->heights);
+    int position_idx = _attr_index(mesh, "position");
+    int normal_idx = _attr_index(mesh, "normal");
+    AT(position_idx >= 0 && mesh->attrs[position_idx].buffer == state->positions);
+    AT(normal_idx >= 0 && mesh->attrs[normal_idx].buffer == state->normals);
+    AT(mesh->attrs[position_idx].data == NULL);
+    AT(dvz_figure_add_compute(figure, compute) == DVZ_OK);
+
+    DvzDrp2CommandStream* stream = _emit_mesh_replacement_stream(figure);
+    ANN(stream);
+    _test_scene_stream_destroy(stream);
+    AT(!state->heights->dirty);
+
+    // A one-row field update dirties exactly that row of the storage mirror.
+    float row[24] = {0};
+    for (uint32_t c = 0; c < cols; c++)
+        row[c] = 0.25f * (float)c;
+    DvzFieldRegion region = {.x = 0, .y = 7, .z = 0, .width = cols, .height = 1, .depth = 1};
+    view.data = row;
+    AT(dvz_sampled_field_update_region(field, region, &view) == DVZ_OK);
+    AT(state->heights->dirty);
+    AT(state->heights->dirty_offset == 7ull * cols * sizeof(float));
+    AT(state->heights->dirty_size == cols * sizeof(float));
+    const float* mirror = (const float*)state->heights->data;
+    AT(mirror[7 * cols + 5] == row[5]);
+    AT(mirror[6 * cols + 5] == 0.0f);
+
+    // Moving the ring origin rewrites the stride-aligned extent word of the kernel parameters:
+    // rows, cols, origin row, origin col, after the four vec4 grid vectors.
+    ANN(state->grid);
+    AT(!state->grid->dirty);
+    AT(dvz_sampled_field_set_ring_origin(field, 3, 11, 0) == DVZ_OK);
+    const uint64_t extent_offset = 16 * sizeof(float);
+    AT(state->grid->dirty);
+    AT(state->grid->dirty_offset == extent_offset);
+    AT(state->grid->dirty_size == 4 * sizeof(uint32_t));
+    const uint32_t* extent = (const uint32_t*)((const uint8_t*)state->grid->data + extent_offset);
+    AT(extent[0] == rows);
+    AT(extent[1] == cols);
+    AT(extent[2] == 11);
+    AT(extent[3] == 3);
+
+    // Replacing the geometry leaves the GPU surface mode.
+    AT(dvz_mesh_set_geometry(mesh, grid) == DVZ_OK);
+    AT(state->compute == NULL && state->field == NULL);
+    AT(mesh->attrs[position_idx].buffer == NULL);
+    AT(mesh->attrs[position_idx].data != NULL);
+
+    dvz_geometry_destroy(grid);
+    dvz_geometry_destroy(other);
+    dvz_geometry_destroy(taller);
+    dvz_scene_destroy(scene);
+    return 0;
+}
+
+
+
 int test_scene_mesh_instance_count_shrink_uses_logical_extent(TstContext* suite, const TstCase* item)
 {
     ANN(suite);
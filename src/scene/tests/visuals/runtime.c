@@ -555,8 +555,7 @@ int test_scene_second_emit_no_uploads_when_not_dirty(TstContext* suite, const Ts
     {
         const DvzDrp2Command* cmd = dvz_drp2_stream_get(stream2, i);
         if (cmd->type == DVZ_DRP2_COMMAND_WRITE_BUFFER &&
-            cmd->u.write_buffer.size != sizeof(DvzMVP) &&
-            cmd->u.write_buffer.size != sizeof(DvzSceneViewportUniform))
+            !_stream_is_common_uniform_write(stream2, cmd))
         {
             wb_count2++;
         }
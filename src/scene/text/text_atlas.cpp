@@ -14,11 +14,19 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include <errno.h>
 #include <float.h>
 #include <limits.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#if defined(_WIN32)
+#include <direct.h>
+#endif
 
 #include "_alloc.h"
 #include "_assertions.h"
@@ -30,7 +38,9 @@
 #include "datoviz/fileio/fileio.h"
 #include "datoviz/scene.h"
 #include "text/text_atlas_product_internal.h"
+#include "text/text_ft_cache.h"
 #include "text/text_internal.h"
+#include "thread_internal.h"
 
 #if defined(DVZ_HAS_ZLIB) && DVZ_HAS_ZLIB
 #include <zlib.h>
@@ -84,6 +94,7 @@
 #define DVZ_TEXT_MSDF_MAX_RANGE_PX 16.0f
 #define DVZ_TEXT_SDF_REFERENCE_RANGE_PX ((float)DVZ_TEXT_SDF_PADDING)
 #define DVZ_TEXT_SDF_MAX_RANGE_PX 32.0f
+#define DVZ_TEXT_ATLAS_CACHE_PATH_SIZE 1024
 
 
 
@@ -218,6 +229,112 @@ static bool _text_atlas_extent_within_budget(
 
 
 #if defined(DVZ_HAS_MSDF_ATLAS) && DVZ_HAS_MSDF_ATLAS
+/**
+ * Return the scene thread pool generating runtime MSDF glyphs, creating it on first use.
+ *
+ * @param scene the scene, or NULL
+ * @return thread pool, or NULL to generate on transient threads
+ */
+static DvzThreadPool* _text_msdf_pool(DvzScene* scene)
+{
+    if (scene == NULL)
+        return NULL;
+    if (scene->text_atlas_pool == NULL)
+        scene->text_atlas_pool = dvz_thread_pool(0);
+    return scene->text_atlas_pool;
+}
+
+
+
+/**
+ * Create a directory and its missing parents.
+ *
+ * @param path directory path
+ * @return whether the directory exists or was created
+ */
+static bool _text_atlas_cache_mkdirs(const char* path)
+{
+    ANN(path);
+    char partial[DVZ_TEXT_ATLAS_CACHE_PATH_SIZE] = {};
+    size_t length = strnlen(path, sizeof(partial));
+    if (length == 0 || length >= sizeof(partial))
+        return false;
+    for (size_t i = 1; i <= length; i++)
+    {
+        if (i < length && path[i] != '/' && path[i] != '\\')
+            continue;
+        dvz_memcpy(partial, sizeof(partial), path, i);
+        partial[i] = '\0';
+#if defined(_WIN32)
+        int rc = _mkdir(partial);
+#else
+        int rc = mkdir(partial, 0755);
+#endif
+        if (rc != 0 && errno != EEXIST)
+        {
+            // Drive roots and existing parents may report other errors; only the leaf matters.
+            if (i == length)
+                return false;
+        }
+    }
+    return true;
+}
+
+
+
+/**
+ * Return the runtime MSDF product cache file for a key.
+ *
+ * The directory is `DVZ_TEXT_ATLAS_CACHE_DIR` when set, or `datoviz/text_atlas` under the user
+ * cache directory. Setting `DVZ_TEXT_ATLAS_CACHE_DIR=0` disables the cache.
+ *
+ * @param key product cache key
+ * @param out_path output file path
+ * @param path_size output buffer size
+ * @param create whether to create the cache directory
+ * @return whether the cache is enabled and the path fits
+ */
+static bool _text_atlas_cache_path(uint64_t key, char* out_path, size_t path_size, bool create)
+{
+    ANN(out_path);
+    char dir[DVZ_TEXT_ATLAS_CACHE_PATH_SIZE] = {};
+    const char* env = getenv("DVZ_TEXT_ATLAS_CACHE_DIR");
+    int written = 0;
+    if (env != NULL && env[0] != '\0')
+    {
+        if (strcmp(env, "0") == 0)
+            return false;
+        written = snprintf(dir, sizeof(dir), "%s", env);
+    }
+    else
+    {
+#if defined(_WIN32)
+        const char* base = getenv("LOCALAPPDATA");
+        const char* suffix = "";
+#else
+        const char* base = getenv("XDG_CACHE_HOME");
+        const char* suffix = "";
+        if (base == NULL || base[0] == '\0')
+        {
+            base = getenv("HOME");
+            suffix = "/.cache";
+        }
+#endif
+        if (base == NULL || base[0] == '\0')
+            return false;
+        written = snprintf(dir, sizeof(dir), "%s%s/datoviz/text_atlas", base, suffix);
+    }
+    if (written <= 0 || (size_t)written >= sizeof(dir))
+        return false;
+    if (create && !_text_atlas_cache_mkdirs(dir))
+        return false;
+    written = snprintf(
+        out_path, path_size, "%s/msdf-%016llx.dtap", dir, (unsigned long long)key);
+    return written > 0 && (size_t)written < path_size;
+}
+
+
+
 /**
  * Copy a build set into canonical increasing codepoint order.
  *
@@ -291,8 +408,21 @@ static bool _text_msdf_build_atlas(
     DvzTextAtlasProductBudget budget = _text_atlas_product_budget_default();
     DvzTextAtlasProductParams params = _text_atlas_product_params_default();
     DvzTextAtlasProduct product = {};
-    bool built = _text_atlas_product_build_msdf(
-        &primary_view, fallback, spec, codepoints, set->count, &budget, &params, &product);
+    uint64_t key = _text_atlas_product_cache_key(
+        &primary_view, fallback, spec, codepoints, set->count, &params);
+    char cache_path[DVZ_TEXT_ATLAS_CACHE_PATH_SIZE] = {};
+    bool cached = _text_atlas_cache_path(key, cache_path, sizeof(cache_path), false) &&
+                  _text_atlas_product_load(cache_path, key, &budget, &product);
+    bool built = cached;
+    if (!cached)
+    {
+        built = _text_atlas_product_build_msdf_pool(
+            &primary_view, fallback, spec, codepoints, set->count, &budget, &params,
+            _text_msdf_pool(font->scene), &product);
+        if (built && _text_atlas_cache_path(key, cache_path, sizeof(cache_path), true) &&
+            !_text_atlas_product_save(&product, key, cache_path))
+            log_debug("text atlas: could not write MSDF product cache %s", cache_path);
+    }
     dvz_free(fallback_bytes);
     if (!built)
     {
@@ -350,11 +480,11 @@ static bool _text_msdf_build_atlas(
 
     *out_atlas = atlas;
     log_debug(
-        "text atlas: runtime MSDF product ready em=%.3f range=%.3f glyphs=%u size=%ux%u "
+        "text atlas: runtime MSDF product %s em=%.3f range=%.3f glyphs=%u size=%ux%u "
         "rgba=%llu in %.3f ms",
-        (double)atlas->em_px, (double)atlas->distance_range_px, atlas->glyph_count,
-        atlas->width, atlas->height, (unsigned long long)rgba_size,
-        _text_atlas_elapsed_ms(start_ns));
+        cached ? "loaded from cache" : "ready", (double)atlas->em_px,
+        (double)atlas->distance_range_px, atlas->glyph_count, atlas->width, atlas->height,
+        (unsigned long long)rgba_size, _text_atlas_elapsed_ms(start_ns));
     return true;
 }
 #endif
@@ -1936,6 +2066,269 @@ static bool _text_atlas_build_backend(
 
 
 
+/**
+ * Reserve a rectangle on the shelves of an atlas, opening a new shelf when none fits.
+ *
+ * @param shelves the shelf state
+ * @param width atlas width
+ * @param height atlas height
+ * @param w reserved rectangle width
+ * @param h reserved rectangle height
+ * @param shelf_height height of a newly opened shelf, at least h
+ * @param out_x output rectangle x
+ * @param out_y output rectangle y
+ * @return whether the rectangle was reserved
+ */
+static bool _text_atlas_shelf_place(
+    DvzTextAtlasShelves* shelves, uint32_t width, uint32_t height, uint32_t w, uint32_t h,
+    uint32_t shelf_height, uint32_t* out_x, uint32_t* out_y)
+{
+    ANN(shelves);
+    ANN(out_x);
+    ANN(out_y);
+
+    // Best fit: the lowest shelf that is tall enough and has room left.
+    DvzTextAtlasShelf* best = NULL;
+    for (uint32_t i = 0; i < shelves->count; i++)
+    {
+        DvzTextAtlasShelf* shelf = &shelves->items[i];
+        if (shelf->height < h || shelf->x + w > width)
+            continue;
+        if (best == NULL || shelf->height < best->height)
+            best = shelf;
+    }
+    if (best == NULL)
+    {
+        if (shelves->count >= DVZ_SCENE_TEXT_ATLAS_MAX_SHELVES ||
+            (uint64_t)shelves->top + shelf_height > height)
+        {
+            return false;
+        }
+        best = &shelves->items[shelves->count++];
+        best->y = shelves->top;
+        best->height = shelf_height;
+        best->x = 0;
+        shelves->top += shelf_height;
+    }
+    *out_x = best->x;
+    *out_y = best->y;
+    best->x += w;
+    return true;
+}
+
+
+
+/**
+ * Return the texel rectangle sampled by one glyph of a built atlas.
+ *
+ * @param atlas the atlas
+ * @param glyph the glyph
+ * @param out_rect output rectangle as x0, y0, x1, y1
+ * @return whether the glyph samples a non-empty rectangle
+ */
+static bool _text_atlas_glyph_rect(
+    const DvzTextAtlas* atlas, const DvzTextAtlasGlyph* glyph, uint32_t* out_rect)
+{
+    ANN(atlas);
+    ANN(glyph);
+    ANN(out_rect);
+    if (!glyph->valid || glyph->uv[2] <= glyph->uv[0] || glyph->uv[3] <= glyph->uv[1])
+        return false;
+    float x0 = fminf(glyph->atlas_bounds[0], glyph->uv[0] * atlas->width);
+    float y0 = fminf(glyph->atlas_bounds[1], glyph->uv[1] * atlas->height);
+    float x1 = fmaxf(glyph->atlas_bounds[2], glyph->uv[2] * atlas->width);
+    float y1 = fmaxf(glyph->atlas_bounds[3], glyph->uv[3] * atlas->height);
+    out_rect[0] = (uint32_t)_text_atlas_clamp(floorf(x0), 0.0f, (float)atlas->width);
+    out_rect[1] = (uint32_t)_text_atlas_clamp(floorf(y0), 0.0f, (float)atlas->height);
+    out_rect[2] = (uint32_t)_text_atlas_clamp(ceilf(x1), 0.0f, (float)atlas->width);
+    out_rect[3] = (uint32_t)_text_atlas_clamp(ceilf(y1), 0.0f, (float)atlas->height);
+    return out_rect[2] > out_rect[0] && out_rect[3] > out_rect[1];
+}
+
+
+
+/**
+ * Grow a live atlas to a larger height, keeping existing texels in place.
+ *
+ * @param atlas the live atlas
+ * @param height new atlas height
+ * @return whether the atlas field was resized
+ */
+static bool _text_atlas_grow(DvzTextAtlas* atlas, uint32_t height)
+{
+    ANN(atlas);
+    ANN(atlas->field);
+    uint64_t byte_size = 0;
+    if (!_text_atlas_extent_within_budget(atlas->width, height, &byte_size))
+        return false;
+    uint8_t* rgba = (uint8_t*)dvz_calloc(byte_size, 1);
+    if (rgba == NULL)
+        return false;
+    dvz_memcpy(rgba, byte_size, atlas->field->data, (DvzSize)atlas->width * atlas->height * 4u);
+
+    DvzFieldDataView view = dvz_field_data_view();
+    view.data = rgba;
+    view.bytes_per_row = (uint64_t)atlas->width * 4u;
+    view.rows_per_image = height;
+    bool ok = dvz_sampled_field_resize(atlas->field, atlas->width, height, 1, &view) == DVZ_OK;
+    dvz_free(rgba);
+    if (!ok)
+        return false;
+
+    // Texels keep their rows, so only the normalized v coordinates shrink.
+    float scale = (float)atlas->height / (float)height;
+    for (uint32_t i = 0; i < atlas->glyph_count; i++)
+    {
+        atlas->glyphs[i].uv[1] *= scale;
+        atlas->glyphs[i].uv[3] *= scale;
+    }
+    atlas->height = height;
+    return true;
+}
+
+
+
+/**
+ * Append missing glyphs to a live atlas without rebuilding it.
+ *
+ * Only the missing codepoints are rasterized, into a temporary atlas of the same backend. Each
+ * glyph is then shelf-packed below the rows of the last full build and uploaded as a subregion.
+ * The atlas height doubles when the shelves are full. Any mismatch, such as a different backend
+ * after a fallback or exhausted capacity, leaves the atlas untouched so that the caller can
+ * rebuild it.
+ *
+ * @param font the font
+ * @param atlas the live atlas
+ * @param missing codepoints absent from the atlas
+ * @return whether all missing glyphs were appended
+ */
+static bool _text_atlas_append_glyphs(
+    DvzFont* font, DvzTextAtlas* atlas, const DvzTextAtlasBuildSet* missing)
+{
+    ANN(font);
+    ANN(atlas);
+    ANN(missing);
+    if (missing->count == 0 || atlas->field == NULL || atlas->field->data == NULL ||
+        atlas->field->desc.format != DVZ_FIELD_FORMAT_RGBA8_UNORM ||
+        atlas->field->desc.dim != DVZ_FIELD_DIM_2D ||
+        atlas->glyph_count + missing->count > DVZ_SCENE_TEXT_ATLAS_MAX_GLYPHS)
+    {
+        return false;
+    }
+
+    DvzTextAtlas* added = NULL;
+    if (!_text_atlas_build_backend(font, &atlas->spec, missing, &added))
+        return false;
+    ANN(added);
+    if (added->field == NULL || added->field->data == NULL ||
+        atlas->glyph_count + added->glyph_count > DVZ_SCENE_TEXT_ATLAS_MAX_GLYPHS ||
+        added->backend != atlas->backend ||
+        added->encoding != atlas->encoding || added->channels != atlas->channels ||
+        fabsf(added->em_px - atlas->em_px) > 1e-3f ||
+        fabsf(added->distance_range_px - atlas->distance_range_px) > 1e-3f)
+    {
+        _scene_text_atlas_destroy(added);
+        return false;
+    }
+
+    // Plan every placement first so that a capacity failure leaves the atlas unchanged.
+    uint32_t rects[DVZ_SCENE_TEXT_ATLAS_MAX_GLYPHS][4] = {{0}};
+    bool has_rect[DVZ_SCENE_TEXT_ATLAS_MAX_GLYPHS] = {false};
+    uint32_t shelf_height = 0;
+    for (uint32_t i = 0; i < added->glyph_count; i++)
+    {
+        has_rect[i] = _text_atlas_glyph_rect(added, &added->glyphs[i], rects[i]);
+        if (has_rect[i] && rects[i][3] - rects[i][1] + DVZ_TEXT_SDF_CELL_GAP > shelf_height)
+            shelf_height = rects[i][3] - rects[i][1] + DVZ_TEXT_SDF_CELL_GAP;
+    }
+    DvzTextAtlasShelves shelves = atlas->shelves;
+    if (shelves.count == 0 && shelves.top == 0)
+        shelves.top = atlas->height;
+    uint32_t height = atlas->height;
+    uint32_t origins[DVZ_SCENE_TEXT_ATLAS_MAX_GLYPHS][2] = {{0}};
+    bool ok = true;
+    for (uint32_t i = 0; i < added->glyph_count && ok; i++)
+    {
+        if (!has_rect[i])
+            continue;
+        uint32_t w = rects[i][2] - rects[i][0] + DVZ_TEXT_SDF_CELL_GAP;
+        uint32_t h = rects[i][3] - rects[i][1] + DVZ_TEXT_SDF_CELL_GAP;
+        ok = w <= atlas->width;
+        while (ok && !_text_atlas_shelf_place(
+                         &shelves, atlas->width, height, w, h, shelf_height, &origins[i][0],
+                         &origins[i][1]))
+        {
+            uint64_t byte_size = 0;
+            ok = shelves.count < DVZ_SCENE_TEXT_ATLAS_MAX_SHELVES &&
+                 _text_atlas_extent_within_budget(atlas->width, 2ull * height, &byte_size);
+            height *= 2u;
+        }
+    }
+    if (!ok || (height != atlas->height && !_text_atlas_grow(atlas, height)))
+    {
+        _scene_text_atlas_destroy(added);
+        return false;
+    }
+
+    const uint8_t* src = (const uint8_t*)added->field->data;
+    uint32_t margin = DVZ_TEXT_SDF_CELL_GAP / 2u;
+    for (uint32_t i = 0; i < added->glyph_count; i++)
+    {
+        DvzTextAtlasGlyph glyph = added->glyphs[i];
+        if (_text_atlas_find_glyph(atlas, glyph.codepoint) != NULL)
+            continue;
+        if (!has_rect[i])
+        {
+            for (uint32_t j = 0; j < 4; j++)
+                glyph.atlas_bounds[j] = glyph.uv[j] = 0.0f;
+        }
+        else
+        {
+            uint32_t x = origins[i][0] + margin;
+            uint32_t y = origins[i][1] + margin;
+            DvzFieldRegion region = {};
+            region.x = x;
+            region.y = y;
+            region.width = rects[i][2] - rects[i][0];
+            region.height = rects[i][3] - rects[i][1];
+            region.depth = 1;
+            DvzFieldDataView view = dvz_field_data_view();
+            view.data = src + ((uint64_t)rects[i][1] * added->width + rects[i][0]) * 4u;
+            view.bytes_per_row = (uint64_t)added->width * 4u;
+            view.rows_per_image = region.height;
+            if (dvz_sampled_field_update_region(atlas->field, region, &view) != DVZ_OK)
+            {
+                ok = false;
+                break;
+            }
+
+            float dx = (float)x - (float)rects[i][0];
+            float dy = (float)y - (float)rects[i][1];
+            glyph.atlas_bounds[0] += dx;
+            glyph.atlas_bounds[1] += dy;
+            glyph.atlas_bounds[2] += dx;
+            glyph.atlas_bounds[3] += dy;
+            glyph.uv[0] = (glyph.uv[0] * added->width + dx) / atlas->width;
+            glyph.uv[1] = (glyph.uv[1] * added->height + dy) / atlas->height;
+            glyph.uv[2] = (glyph.uv[2] * added->width + dx) / atlas->width;
+            glyph.uv[3] = (glyph.uv[3] * added->height + dy) / atlas->height;
+        }
+        atlas->glyphs[atlas->glyph_count++] = glyph;
+    }
+    atlas->missing_glyph_count += added->missing_glyph_count;
+    atlas->shelves = shelves;
+    _scene_text_atlas_destroy(added);
+
+    font->version++;
+    atlas->generation = font->version;
+    log_debug(
+        "text atlas: appended %u glyphs backend=%d size=%ux%u shelves=%u", missing->count,
+        (int)atlas->backend, atlas->width, atlas->height, atlas->shelves.count);
+    return ok;
+}
+
+
+
 /**
  * Store a newly built atlas in the font cache.
  *
@@ -2011,6 +2404,15 @@ static bool _text_atlas_ensure_exact_set(
             set.count);
         return true;
     }
+    if (existing != NULL)
+    {
+        DvzTextAtlasBuildSet missing = {};
+        for (uint32_t i = 0; i < set.count; i++)
+            if (!_text_atlas_contains_codepoint(existing, set.codepoints[i]))
+                missing.codepoints[missing.count++] = set.codepoints[i];
+        if (_text_atlas_append_glyphs(font, existing, &missing))
+            return true;
+    }
     DvzTextAtlas* atlas = NULL;
     if (_text_default_msdf_build_atlas(font, spec, &set, &atlas))
     {
@@ -2431,6 +2833,7 @@ void _scene_font_release(DvzFont* font)
 {
     if (font == NULL)
         return;
+    _scene_text_ft_cache_forget_font(font->scene, font);
     for (uint32_t i = 0; i < font->atlas_count && i < DVZ_SCENE_MAX_TEXT_ATLASES_PER_FONT; i++)
     {
         DvzTextAtlasCacheEntry* entry = &font->atlas_entries[i];
@@ -14,15 +14,27 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include <atomic>
 #include <limits.h>
 #include <math.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <string.h>
 #include <vector>
 
 #include "_alloc.h"
 #include "_overflow.h"
 #include "text_atlas_product_internal.h"
+#include "thread_internal.h"
+
+#if defined(_WIN32)
+#include <process.h>
+#define DVZ_TEXT_ATLAS_PRODUCT_PID() ((unsigned long)_getpid())
+#else
+#include <unistd.h>
+#define DVZ_TEXT_ATLAS_PRODUCT_PID() ((unsigned long)getpid())
+#endif
 
 #if defined(DVZ_HAS_MSDF_ATLAS) && DVZ_HAS_MSDF_ATLAS
 #include <ft2build.h>
@@ -55,6 +67,32 @@
 #define DVZ_TEXT_ATLAS_PRODUCT_DEFAULT_MAX_GLYPHS 256u
 #define DVZ_TEXT_ATLAS_PRODUCT_DEFAULT_MAX_DIMENSION 4096u
 #define DVZ_TEXT_ATLAS_PRODUCT_DEFAULT_MAX_RGBA_BYTES (64ull * 1024ull * 1024ull)
+#define DVZ_TEXT_ATLAS_PRODUCT_FILE_MAGIC 0x50415444u /* "DTAP" */
+#define DVZ_TEXT_ATLAS_PRODUCT_FILE_VERSION 1u
+#define DVZ_TEXT_ATLAS_PRODUCT_HASH_SEED 0x9E3779B97F4A7C15ull
+#define DVZ_TEXT_ATLAS_PRODUCT_HASH_PRIME 0xFF51AFD7ED558CCDull
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+/**
+ * Fixed header of a cached atlas product file, followed by the product record, the glyphs, the
+ * coverage, and the RGBA pixels.
+ */
+typedef struct DvzTextAtlasProductFileHeader DvzTextAtlasProductFileHeader;
+struct DvzTextAtlasProductFileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t product_size;
+    uint32_t glyph_size;
+    uint32_t coverage_size;
+    uint32_t reserved;
+};
 
 
 
@@ -195,6 +233,98 @@ static uint32_t _text_atlas_product_find_glyph(
 
 
 
+/**
+ * Mix bytes into a 64-bit product hash, one machine word at a time.
+ *
+ * @param hash running hash
+ * @param data bytes to mix, may be NULL when `size` is zero
+ * @param size number of bytes
+ * @return updated hash
+ */
+static uint64_t _text_atlas_product_hash(uint64_t hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word = 0;
+        memcpy(&word, bytes + i, sizeof(uint64_t));
+        hash = (hash ^ word) * DVZ_TEXT_ATLAS_PRODUCT_HASH_PRIME;
+        hash ^= hash >> 32;
+    }
+    for (; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * DVZ_TEXT_ATLAS_PRODUCT_HASH_PRIME;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+
+
+/**
+ * Mix one 64-bit value into a product hash.
+ *
+ * @param hash running hash
+ * @param value value to mix
+ * @return updated hash
+ */
+static uint64_t _text_atlas_product_hash_u64(uint64_t hash, uint64_t value)
+{
+    return _text_atlas_product_hash(hash, &value, sizeof(value));
+}
+
+
+
+/**
+ * Mix one optional font view into a product hash.
+ *
+ * @param hash running hash
+ * @param view font view, or NULL
+ * @return updated hash
+ */
+static uint64_t _text_atlas_product_hash_font(uint64_t hash, const DvzTextAtlasFontView* view)
+{
+    if (view == NULL)
+        return _text_atlas_product_hash_u64(hash, UINT64_MAX);
+    hash = _text_atlas_product_hash_u64(hash, view->size);
+    hash = _text_atlas_product_hash(hash, view->bytes, (size_t)view->size);
+    hash = _text_atlas_product_hash_u64(hash, (uint64_t)(int64_t)view->face_index);
+    return _text_atlas_product_hash_u64(hash, view->load_flags);
+}
+
+
+
+/**
+ * Read exactly one block from a cache file.
+ *
+ * @param fp open file
+ * @param data destination
+ * @param size number of bytes
+ * @return whether the whole block was read
+ */
+static bool _text_atlas_product_read(FILE* fp, void* data, size_t size)
+{
+    return size == 0 || fread(data, 1, size, fp) == size;
+}
+
+
+
+/**
+ * Write exactly one block to a cache file.
+ *
+ * @param fp open file
+ * @param data source
+ * @param size number of bytes
+ * @return whether the whole block was written
+ */
+static bool _text_atlas_product_write(FILE* fp, const void* data, size_t size)
+{
+    return size == 0 || fwrite(data, 1, size, fp) == size;
+}
+
+
+
 #if defined(DVZ_HAS_MSDF_ATLAS) && DVZ_HAS_MSDF_ATLAS
 
 typedef struct DvzTextAtlasProductLoadedFont DvzTextAtlasProductLoadedFont;
@@ -433,6 +563,105 @@ static bool _text_atlas_product_fill_glyph(
 
 
 
+/**
+ * Shared state of the per-glyph edge coloring and generation tasks.
+ */
+typedef struct DvzTextAtlasProductGenerate DvzTextAtlasProductGenerate;
+struct DvzTextAtlasProductGenerate
+{
+    msdf_atlas::GlyphGeometry* glyphs;
+    double max_corner_angle;
+    unsigned long long seed;
+    const msdf_atlas::GeneratorAttributes* attributes;
+    uint8_t* rgba;
+    uint32_t width;
+    uint32_t height;
+    std::atomic<bool> failed;
+};
+
+
+
+/**
+ * Assign edge colors to a range of glyphs.
+ *
+ * @param begin first glyph
+ * @param end one past the last glyph
+ * @param user_data generation state
+ */
+static void _text_atlas_product_color_range(uint32_t begin, uint32_t end, void* user_data)
+{
+    DvzTextAtlasProductGenerate* job = (DvzTextAtlasProductGenerate*)user_data;
+    for (uint32_t i = begin; i < end; i++)
+        job->glyphs[i].edgeColoring(
+            &msdfgen::edgeColoringInkTrap, job->max_corner_angle, job->seed);
+}
+
+
+
+/**
+ * Generate the distance fields of a range of glyphs into the flipped RGBA atlas.
+ *
+ * This matches `ImmediateAtlasGenerator` with `BitmapAtlasStorage`, followed by the vertical
+ * flip, byte for byte.
+ *
+ * @param begin first glyph
+ * @param end one past the last glyph
+ * @param user_data generation state
+ */
+static void _text_atlas_product_generate_range(uint32_t begin, uint32_t end, void* user_data)
+{
+    DvzTextAtlasProductGenerate* job = (DvzTextAtlasProductGenerate*)user_data;
+    try
+    {
+        std::vector<float> pixels;
+        std::vector<msdfgen::byte> correction;
+        for (uint32_t i = begin; i < end && !job->failed.load(std::memory_order_relaxed); i++)
+        {
+            const msdf_atlas::GlyphGeometry& glyph = job->glyphs[i];
+            if (glyph.isWhitespace())
+                continue;
+            int x = 0;
+            int y = 0;
+            int w = 0;
+            int h = 0;
+            glyph.getBoxRect(x, y, w, h);
+            if (w <= 0 || h <= 0)
+                continue;
+            if (x < 0 || y < 0 || (uint32_t)x + (uint32_t)w > job->width ||
+                (uint32_t)y + (uint32_t)h > job->height)
+            {
+                job->failed.store(true);
+                return;
+            }
+
+            size_t area = (size_t)w * (size_t)h;
+            pixels.resize(area * DVZ_TEXT_ATLAS_PRODUCT_CHANNELS);
+            correction.resize(area);
+            msdf_atlas::GeneratorAttributes attributes = *job->attributes;
+            attributes.config.errorCorrection.buffer = correction.data();
+            msdfgen::BitmapRef<float, 4> bitmap(pixels.data(), w, h);
+            msdf_atlas::mtsdfGenerator(bitmap, glyph, attributes);
+
+            for (int row = 0; row < h; row++)
+            {
+                const float* src = bitmap(0, row);
+                uint8_t* dst = job->rgba + ((size_t)(job->height - 1u - (uint32_t)(y + row)) *
+                                                job->width +
+                                            (size_t)x) *
+                                               DVZ_TEXT_ATLAS_PRODUCT_CHANNELS;
+                for (size_t k = 0; k < (size_t)w * DVZ_TEXT_ATLAS_PRODUCT_CHANNELS; k++)
+                    dst[k] = msdfgen::pixelFloatToByte(src[k]);
+            }
+        }
+    }
+    catch (...)
+    {
+        job->failed.store(true);
+    }
+}
+
+
+
 /**
  * Build one staged CPU MSDF product.
  *
@@ -443,6 +672,7 @@ static bool _text_atlas_product_fill_glyph(
  * @param codepoint_count codepoint count
  * @param budget hard product budget
  * @param params generation parameters
+ * @param pool optional thread pool generating one glyph per task
  * @param product staged output product
  * @return whether generation succeeded
  */
@@ -450,7 +680,7 @@ static bool _text_atlas_product_build_enabled(
     const DvzTextAtlasFontView* primary, const DvzTextAtlasFontView* fallback,
     const DvzTextAtlasSpec* spec, const uint32_t* codepoints, uint32_t codepoint_count,
     const DvzTextAtlasProductBudget* budget, const DvzTextAtlasProductParams* params,
-    DvzTextAtlasProduct* product)
+    DvzThreadPool* pool, DvzTextAtlasProduct* product)
 {
     DvzTextAtlasProductFontGuard fonts;
     if (!fonts.init() || !fonts.load(primary, &fonts.primary) ||
@@ -495,10 +725,12 @@ static bool _text_atlas_product_build_enabled(
         generated.size() > (size_t)UINT32_MAX || generated.size() > (size_t)INT_MAX)
         return false;
 
-    for (msdf_atlas::GlyphGeometry& glyph : generated)
-        glyph.edgeColoring(
-            &msdfgen::edgeColoringInkTrap, params->max_corner_angle,
-            (unsigned long long)params->edge_coloring_seed);
+    DvzTextAtlasProductGenerate job = {};
+    job.glyphs = generated.data();
+    job.max_corner_angle = params->max_corner_angle;
+    job.seed = (unsigned long long)params->edge_coloring_seed;
+    dvz_thread_pool_parallel_for(
+        pool, (uint32_t)generated.size(), 1, _text_atlas_product_color_range, &job);
 
     msdf_atlas::TightAtlasPacker packer;
     packer.setDimensionsConstraint(msdf_atlas::DimensionsConstraint::SQUARE);
@@ -522,20 +754,6 @@ static bool _text_atlas_product_build_enabled(
         rgba_size > budget->max_rgba_bytes || rgba_size > SIZE_MAX)
         return false;
 
-    msdf_atlas::ImmediateAtlasGenerator<
-        float, 4, &msdf_atlas::mtsdfGenerator,
-        msdf_atlas::BitmapAtlasStorage<uint8_t, 4>>
-        generator(width, height);
-    msdf_atlas::GeneratorAttributes attributes;
-    attributes.config.overlapSupport = params->overlap_support;
-    attributes.scanlinePass = params->scanline_pass;
-    generator.setAttributes(attributes);
-    generator.setThreadCount((int)params->thread_count);
-    generator.generate(generated.data(), generated.size());
-    msdfgen::BitmapConstRef<uint8_t, 4> bitmap = generator.atlasStorage();
-    if (bitmap.pixels == NULL)
-        return false;
-
     uint64_t glyph_bytes = 0;
     if (_dvz_mul_u64_overflows(
             (uint64_t)generated.size(), sizeof(DvzTextAtlasGlyph), &glyph_bytes) ||
@@ -548,17 +766,38 @@ static bool _text_atlas_product_build_enabled(
 
     uint32_t atlas_width = (uint32_t)width;
     uint32_t atlas_height = (uint32_t)height;
-    for (uint32_t y = 0; y < atlas_height; y++)
+    msdf_atlas::GeneratorAttributes attributes;
+    attributes.config.overlapSupport = params->overlap_support;
+    attributes.scanlinePass = params->scanline_pass;
+    if (pool != NULL)
     {
-        for (uint32_t x = 0; x < atlas_width; x++)
-        {
-            uint64_t source = ((uint64_t)y * atlas_width + x) * 4u;
-            uint64_t target = ((uint64_t)(atlas_height - 1u - y) * atlas_width + x) * 4u;
-            product->rgba[target + 0] = bitmap.pixels[source + 0];
-            product->rgba[target + 1] = bitmap.pixels[source + 1];
-            product->rgba[target + 2] = bitmap.pixels[source + 2];
-            product->rgba[target + 3] = bitmap.pixels[source + 3];
-        }
+        // Glyph boxes are disjoint, so the workers write the flipped atlas rows directly.
+        job.attributes = &attributes;
+        job.rgba = product->rgba;
+        job.width = atlas_width;
+        job.height = atlas_height;
+        dvz_thread_pool_parallel_for(
+            pool, (uint32_t)generated.size(), 1, _text_atlas_product_generate_range, &job);
+        if (job.failed.load())
+            return false;
+    }
+    else
+    {
+        msdf_atlas::ImmediateAtlasGenerator<
+            float, 4, &msdf_atlas::mtsdfGenerator,
+            msdf_atlas::BitmapAtlasStorage<uint8_t, 4>>
+            generator(width, height);
+        generator.setAttributes(attributes);
+        generator.setThreadCount((int)params->thread_count);
+        generator.generate(generated.data(), generated.size());
+        msdfgen::BitmapConstRef<uint8_t, 4> bitmap = generator.atlasStorage();
+        if (bitmap.pixels == NULL)
+            return false;
+        size_t row_size = (size_t)atlas_width * DVZ_TEXT_ATLAS_PRODUCT_CHANNELS;
+        for (uint32_t y = 0; y < atlas_height; y++)
+            memcpy(
+                product->rgba + (size_t)(atlas_height - 1u - y) * row_size,
+                bitmap.pixels + (size_t)y * row_size, row_size);
     }
 
     product->spec = *spec;
@@ -777,6 +1016,176 @@ void _text_atlas_product_destroy(DvzTextAtlasProduct* product)
 
 
 
+/**
+ * Hash every input that determines the bytes of an MSDF atlas product.
+ *
+ * @param primary borrowed primary font bytes and face metadata
+ * @param fallback optional borrowed fallback font bytes and face metadata
+ * @param spec requested MSDF atlas specification
+ * @param codepoints canonical strictly increasing codepoint array
+ * @param codepoint_count number of requested codepoints
+ * @param params deterministic generation parameters
+ * @return 64-bit product cache key
+ */
+uint64_t _text_atlas_product_cache_key(
+    const DvzTextAtlasFontView* primary, const DvzTextAtlasFontView* fallback,
+    const DvzTextAtlasSpec* spec, const uint32_t* codepoints, uint32_t codepoint_count,
+    const DvzTextAtlasProductParams* params)
+{
+    uint64_t hash = DVZ_TEXT_ATLAS_PRODUCT_HASH_SEED;
+    hash = _text_atlas_product_hash_u64(hash, DVZ_TEXT_ATLAS_PRODUCT_FILE_VERSION);
+    hash = _text_atlas_product_hash_font(hash, primary);
+    hash = _text_atlas_product_hash_font(hash, fallback);
+    if (spec != NULL)
+    {
+        hash = _text_atlas_product_hash_u64(hash, (uint64_t)spec->backend);
+        hash = _text_atlas_product_hash(hash, &spec->em_px, sizeof(spec->em_px));
+        hash = _text_atlas_product_hash(
+            hash, &spec->distance_range_px, sizeof(spec->distance_range_px));
+        hash = _text_atlas_product_hash_u64(hash, spec->flags);
+    }
+    hash = _text_atlas_product_hash_u64(hash, codepoint_count);
+    if (codepoints != NULL)
+        hash = _text_atlas_product_hash(
+            hash, codepoints, (size_t)codepoint_count * sizeof(uint32_t));
+    if (params != NULL)
+    {
+        hash = _text_atlas_product_hash_u64(hash, params->fallback_codepoint);
+        hash = _text_atlas_product_hash_u64(hash, params->edge_coloring_seed);
+        hash = _text_atlas_product_hash(
+            hash, &params->max_corner_angle, sizeof(params->max_corner_angle));
+        hash = _text_atlas_product_hash(hash, &params->miter_limit, sizeof(params->miter_limit));
+        hash = _text_atlas_product_hash_u64(
+            hash, (uint64_t)params->overlap_support | (uint64_t)params->scanline_pass << 1 |
+                      (uint64_t)params->preprocess_geometry << 2 |
+                      (uint64_t)params->enable_kerning << 3);
+    }
+    return hash;
+}
+
+
+
+/**
+ * Write an atlas product to a cache file.
+ *
+ * @param product validated atlas product
+ * @param key product cache key
+ * @param path destination file path
+ * @return whether the file was written
+ */
+bool _text_atlas_product_save(const DvzTextAtlasProduct* product, uint64_t key, const char* path)
+{
+    if (product == NULL || path == NULL || product->rgba == NULL || product->glyphs == NULL ||
+        product->coverage == NULL)
+        return false;
+
+    char tmp_path[1024] = {0};
+    int written = snprintf(
+        tmp_path, sizeof(tmp_path), "%s.%lu.tmp", path, DVZ_TEXT_ATLAS_PRODUCT_PID());
+    if (written <= 0 || (size_t)written >= sizeof(tmp_path))
+        return false;
+    FILE* fp = fopen(tmp_path, "wb");
+    if (fp == NULL)
+        return false;
+
+    DvzTextAtlasProductFileHeader header = {};
+    header.magic = DVZ_TEXT_ATLAS_PRODUCT_FILE_MAGIC;
+    header.version = DVZ_TEXT_ATLAS_PRODUCT_FILE_VERSION;
+    header.key = key;
+    header.product_size = (uint32_t)sizeof(DvzTextAtlasProduct);
+    header.glyph_size = (uint32_t)sizeof(DvzTextAtlasGlyph);
+    header.coverage_size = (uint32_t)sizeof(DvzTextAtlasProductCoverage);
+    DvzTextAtlasProduct record = *product;
+    record.rgba = NULL;
+    record.glyphs = NULL;
+    record.coverage = NULL;
+
+    bool ok = _text_atlas_product_write(fp, &header, sizeof(header)) &&
+              _text_atlas_product_write(fp, &record, sizeof(record)) &&
+              _text_atlas_product_write(
+                  fp, product->glyphs, (size_t)product->glyph_count * sizeof(DvzTextAtlasGlyph)) &&
+              _text_atlas_product_write(
+                  fp, product->coverage,
+                  (size_t)product->coverage_count * sizeof(DvzTextAtlasProductCoverage)) &&
+              _text_atlas_product_write(fp, product->rgba, (size_t)product->rgba_size);
+    ok = fclose(fp) == 0 && ok;
+    if (ok && rename(tmp_path, path) != 0)
+    {
+        // Windows does not replace an existing destination.
+        remove(path);
+        ok = rename(tmp_path, path) == 0;
+    }
+    if (!ok)
+        remove(tmp_path);
+    return ok;
+}
+
+
+
+/**
+ * Read an atlas product from a cache file.
+ *
+ * @param path cache file path
+ * @param key expected product cache key
+ * @param budget hard output and allocation limits
+ * @param out_product zero-initialized output product
+ * @return whether a matching, valid product was read
+ */
+bool _text_atlas_product_load(
+    const char* path, uint64_t key, const DvzTextAtlasProductBudget* budget,
+    DvzTextAtlasProduct* out_product)
+{
+    if (path == NULL || budget == NULL || out_product == NULL || out_product->rgba != NULL ||
+        out_product->glyphs != NULL || out_product->coverage != NULL)
+        return false;
+    FILE* fp = fopen(path, "rb");
+    if (fp == NULL)
+        return false;
+
+    DvzTextAtlasProductFileHeader header = {};
+    DvzTextAtlasProduct staged = {};
+    bool ok = _text_atlas_product_read(fp, &header, sizeof(header)) &&
+              header.magic == DVZ_TEXT_ATLAS_PRODUCT_FILE_MAGIC &&
+              header.version == DVZ_TEXT_ATLAS_PRODUCT_FILE_VERSION && header.key == key &&
+              header.product_size == sizeof(DvzTextAtlasProduct) &&
+              header.glyph_size == sizeof(DvzTextAtlasGlyph) &&
+              header.coverage_size == sizeof(DvzTextAtlasProductCoverage) &&
+              _text_atlas_product_read(fp, &staged, sizeof(staged));
+    staged.rgba = NULL;
+    staged.glyphs = NULL;
+    staged.coverage = NULL;
+    ok = ok && staged.glyph_count > 0 && staged.glyph_count <= budget->max_glyphs &&
+         staged.coverage_count > 0 && staged.coverage_count <= budget->max_glyphs &&
+         staged.rgba_size > 0 && staged.rgba_size <= budget->max_rgba_bytes &&
+         staged.rgba_size <= SIZE_MAX;
+    if (ok)
+    {
+        staged.glyphs =
+            (DvzTextAtlasGlyph*)dvz_calloc(staged.glyph_count, sizeof(DvzTextAtlasGlyph));
+        staged.coverage = (DvzTextAtlasProductCoverage*)dvz_calloc(
+            staged.coverage_count, sizeof(DvzTextAtlasProductCoverage));
+        staged.rgba = (uint8_t*)dvz_malloc((size_t)staged.rgba_size);
+        ok = staged.glyphs != NULL && staged.coverage != NULL && staged.rgba != NULL &&
+             _text_atlas_product_read(
+                 fp, staged.glyphs, (size_t)staged.glyph_count * sizeof(DvzTextAtlasGlyph)) &&
+             _text_atlas_product_read(
+                 fp, staged.coverage,
+                 (size_t)staged.coverage_count * sizeof(DvzTextAtlasProductCoverage)) &&
+             _text_atlas_product_read(fp, staged.rgba, (size_t)staged.rgba_size) &&
+             fgetc(fp) == EOF;
+    }
+    fclose(fp);
+    if (!ok || !_text_atlas_product_validate(&staged, budget))
+    {
+        _text_atlas_product_destroy(&staged);
+        return false;
+    }
+    *out_product = staged;
+    return true;
+}
+
+
+
 /**
  * Build a complete owned MSDF atlas product without scene or GPU state.
  *
@@ -795,6 +1204,32 @@ bool _text_atlas_product_build_msdf(
     const DvzTextAtlasSpec* spec, const uint32_t* codepoints, uint32_t codepoint_count,
     const DvzTextAtlasProductBudget* budget, const DvzTextAtlasProductParams* params,
     DvzTextAtlasProduct* out_product)
+{
+    return _text_atlas_product_build_msdf_pool(
+        primary, fallback, spec, codepoints, codepoint_count, budget, params, NULL, out_product);
+}
+
+
+
+/**
+ * Build a complete owned MSDF atlas product, generating glyphs on a thread pool.
+ *
+ * @param primary borrowed primary font bytes and face metadata
+ * @param fallback optional borrowed fallback font bytes and face metadata
+ * @param spec requested MSDF atlas specification
+ * @param codepoints canonical strictly increasing codepoint array
+ * @param codepoint_count number of requested codepoints
+ * @param budget hard output and allocation limits
+ * @param params deterministic generation parameters
+ * @param pool thread pool, or NULL to generate with `params->thread_count` transient threads
+ * @param out_product zero-initialized output product
+ * @return whether every codepoint was generated exactly or explicitly mapped to the fallback glyph
+ */
+bool _text_atlas_product_build_msdf_pool(
+    const DvzTextAtlasFontView* primary, const DvzTextAtlasFontView* fallback,
+    const DvzTextAtlasSpec* spec, const uint32_t* codepoints, uint32_t codepoint_count,
+    const DvzTextAtlasProductBudget* budget, const DvzTextAtlasProductParams* params,
+    DvzThreadPool* pool, DvzTextAtlasProduct* out_product)
 {
     if (!_text_atlas_product_request_valid(
             primary, fallback, spec, codepoints, codepoint_count, budget, params, out_product))
@@ -804,7 +1239,8 @@ bool _text_atlas_product_build_msdf(
     try
     {
         bool built = _text_atlas_product_build_enabled(
-            primary, fallback, spec, codepoints, codepoint_count, budget, params, &staged);
+            primary, fallback, spec, codepoints, codepoint_count, budget, params, pool,
+            &staged);
         if (!built || !_text_atlas_product_validate(&staged, budget))
         {
             _text_atlas_product_destroy(&staged);
@@ -819,6 +1255,7 @@ bool _text_atlas_product_build_msdf(
     *out_product = staged;
     return true;
 #else
+    (void)pool;
     return false;
 #endif
 }
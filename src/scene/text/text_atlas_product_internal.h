@@ -24,6 +24,14 @@
 
 
 
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzThreadPool DvzThreadPool;
+
+
+
 /*************************************************************************************************/
 /*  Enums                                                                                        */
 /*************************************************************************************************/
@@ -187,6 +195,75 @@ bool _text_atlas_product_build_msdf(
     const DvzTextAtlasProductBudget* budget, const DvzTextAtlasProductParams* params,
     DvzTextAtlasProduct* out_product);
 
+/**
+ * Build a complete owned MSDF atlas product, generating glyphs on a thread pool.
+ *
+ * Edge coloring and distance-field generation run one glyph per task on the pool workers, which
+ * write straight into disjoint rectangles of the final atlas. The result is byte-identical to
+ * `_text_atlas_product_build_msdf()`.
+ *
+ * @param primary borrowed primary font bytes and face metadata
+ * @param fallback optional borrowed fallback font bytes and face metadata
+ * @param spec requested MSDF atlas specification
+ * @param codepoints canonical strictly increasing codepoint array
+ * @param codepoint_count number of requested codepoints
+ * @param budget hard output and allocation limits
+ * @param params deterministic generation parameters
+ * @param pool thread pool, or NULL to generate with `params->thread_count` transient threads
+ * @param out_product zero-initialized output product
+ * @return whether every codepoint was generated exactly or explicitly mapped to the fallback glyph
+ */
+bool _text_atlas_product_build_msdf_pool(
+    const DvzTextAtlasFontView* primary, const DvzTextAtlasFontView* fallback,
+    const DvzTextAtlasSpec* spec, const uint32_t* codepoints, uint32_t codepoint_count,
+    const DvzTextAtlasProductBudget* budget, const DvzTextAtlasProductParams* params,
+    DvzThreadPool* pool, DvzTextAtlasProduct* out_product);
+
+/**
+ * Hash every input that determines the bytes of an MSDF atlas product.
+ *
+ * The thread count is excluded since it does not change the product.
+ *
+ * @param primary borrowed primary font bytes and face metadata
+ * @param fallback optional borrowed fallback font bytes and face metadata
+ * @param spec requested MSDF atlas specification
+ * @param codepoints canonical strictly increasing codepoint array
+ * @param codepoint_count number of requested codepoints
+ * @param params deterministic generation parameters
+ * @return 64-bit product cache key
+ */
+uint64_t _text_atlas_product_cache_key(
+    const DvzTextAtlasFontView* primary, const DvzTextAtlasFontView* fallback,
+    const DvzTextAtlasSpec* spec, const uint32_t* codepoints, uint32_t codepoint_count,
+    const DvzTextAtlasProductParams* params);
+
+/**
+ * Write an atlas product to a cache file.
+ *
+ * The file is written next to its destination and renamed into place, so concurrent readers
+ * never observe a partial product.
+ *
+ * @param product validated atlas product
+ * @param key product cache key
+ * @param path destination file path
+ * @return whether the file was written
+ */
+bool _text_atlas_product_save(const DvzTextAtlasProduct* product, uint64_t key, const char* path);
+
+/**
+ * Read an atlas product from a cache file.
+ *
+ * @param path cache file path
+ * @param key expected product cache key
+ * @param budget hard output and allocation limits
+ * @param out_product zero-initialized output product
+ * @return whether a matching, valid product was read
+ * @note Failure leaves `out_product` empty, including for missing, stale, or corrupt files.
+ */
+bool _text_atlas_product_load(
+    const char* path, uint64_t key, const DvzTextAtlasProductBudget* budget,
+    DvzTextAtlasProduct* out_product);
+
 /**
  * Validate the ownership, bounds, metrics, glyphs, and strict coverage of an atlas product.
  *
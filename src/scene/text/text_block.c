@@ -26,13 +26,9 @@
 #include "_overflow.h"
 #include "_scene.h"
 #include "datoviz/scene/text.h"
+#include "text/text_ft_cache.h"
 #include "text/text_internal.h"
 
-#if defined(DVZ_HAS_FREETYPE) && DVZ_HAS_FREETYPE
-#include <ft2build.h>
-#include FT_FREETYPE_H
-#endif
-
 
 
 /*************************************************************************************************/
@@ -373,12 +369,11 @@ typedef struct DvzTextBlockLayoutItem DvzTextBlockLayoutItem;
 
 struct DvzTextBlockFtCtx
 {
-    FT_Library library;
-    FT_Face faces[DVZ_TEXT_BLOCK_FACE_COUNT];
+    DvzTextFtCache* cache;
+    DvzTextFtFace faces[DVZ_TEXT_BLOCK_FACE_COUNT];
     DvzFont* fonts[DVZ_TEXT_BLOCK_FACE_COUNT];
-    FT_Face fallback_face;
+    DvzTextFtFace fallback_face;
     DvzFont* fallback_font;
-    bool owns_library;
     float scale;
     float ascender;
     float descender;
@@ -403,9 +398,6 @@ struct DvzTextBlockLayoutItem
 };
 
 
-static uint8_t _text_block_ft_coverage(const FT_Bitmap* bitmap, uint32_t x, uint32_t y);
-
-
 /**
  * Return an existing scene font matching a descriptor.
  *
@@ -681,7 +673,7 @@ static bool _text_block_utf8_next(
 
 
 /**
- * Open all resolved FreeType faces for a text block.
+ * Acquire the resolved FreeType faces of a text block from the scene cache.
  *
  * @param block the text block
  * @param scale raster scale applied to the requested font size
@@ -693,9 +685,14 @@ static bool _text_block_ft_open(DvzTextBlock* block, float scale, DvzTextBlockFt
     ANN(block);
     ANN(out);
     dvz_memset(out, sizeof(DvzTextBlockFtCtx), 0, sizeof(DvzTextBlockFtCtx));
-    if (FT_Init_FreeType(&out->library) != 0)
+    DvzScene* scene = block->layout.scene;
+    if (scene == NULL && block->layout_fonts[DVZ_TEXT_BLOCK_FACE_REGULAR] != NULL)
+        scene = block->layout_fonts[DVZ_TEXT_BLOCK_FACE_REGULAR]->scene;
+    if (scene == NULL)
+        return false;
+    out->cache = _scene_text_ft_cache(scene);
+    if (out->cache == NULL)
         return false;
-    out->owns_library = true;
     out->scale = scale > 0.0f ? scale : 1.0f;
 
     float font_size = block->layout.font_size_px > 0.0f ? block->layout.font_size_px :
@@ -707,49 +704,19 @@ static bool _text_block_ft_open(DvzTextBlock* block, float scale, DvzTextBlockFt
     for (uint32_t i = 0; i < DVZ_TEXT_BLOCK_FACE_COUNT; i++)
     {
         DvzFont* font = block->layout_fonts[i];
-        if (font == NULL || !_scene_font_ensure_bytes(font))
-            continue;
-
-        if (FT_New_Memory_Face(
-                out->library, (const FT_Byte*)font->ttf_bytes, (FT_Long)font->ttf_size,
-                (FT_Long)font->face_index, &out->faces[i]) != 0)
-        {
-            out->faces[i] = NULL;
-            continue;
-        }
-        if (FT_Set_Pixel_Sizes(out->faces[i], 0, (FT_UInt)font_px) != 0)
-        {
-            FT_Done_Face(out->faces[i]);
-            out->faces[i] = NULL;
-            continue;
-        }
-        out->fonts[i] = font;
+        if (font != NULL &&
+            _scene_text_ft_face(out->cache, font, font->face_index, font_px, &out->faces[i]))
+            out->fonts[i] = font;
     }
 
     DvzFontDesc fallback_desc = {
         DVZ_STRUCT_INIT_FIELDS(DvzFontDesc), .family = "Noto Sans Math", .style = "Regular"};
-    out->fallback_font = _text_block_get_font(block->layout.scene, &fallback_desc);
-    if (out->fallback_font != NULL && _scene_font_ensure_bytes(out->fallback_font) &&
-        FT_New_Memory_Face(
-            out->library, (const FT_Byte*)out->fallback_font->ttf_bytes,
-            (FT_Long)out->fallback_font->ttf_size, 0, &out->fallback_face) == 0)
-    {
-        if (FT_Set_Pixel_Sizes(out->fallback_face, 0, (FT_UInt)font_px) != 0)
-        {
-            FT_Done_Face(out->fallback_face);
-            out->fallback_face = NULL;
-        }
-    }
+    out->fallback_font = _text_block_get_font(scene, &fallback_desc);
+    _scene_text_ft_face(out->cache, out->fallback_font, 0, font_px, &out->fallback_face);
 
-    FT_Face face = out->faces[DVZ_TEXT_BLOCK_FACE_REGULAR];
+    FT_Face face = out->faces[DVZ_TEXT_BLOCK_FACE_REGULAR].face;
     if (face == NULL)
     {
-        for (uint32_t i = 0; i < DVZ_TEXT_BLOCK_FACE_COUNT; i++)
-        {
-            if (out->faces[i] != NULL)
-                FT_Done_Face(out->faces[i]);
-        }
-        FT_Done_FreeType(out->library);
         dvz_memset(out, sizeof(DvzTextBlockFtCtx), 0, sizeof(DvzTextBlockFtCtx));
         return false;
     }
@@ -763,27 +730,20 @@ static bool _text_block_ft_open(DvzTextBlock* block, float scale, DvzTextBlockFt
 
 
 /**
- * Release FreeType faces opened for a text block.
+ * Return the face of a layout face slot, including the fallback slot.
  *
  * @param ctx FreeType context
+ * @param face_slot face slot, or DVZ_TEXT_BLOCK_FACE_COUNT for the fallback face
+ * @return the cached face, or NULL
  */
-static void _text_block_ft_close(DvzTextBlockFtCtx* ctx)
+static const DvzTextFtFace* _text_block_ft_slot(const DvzTextBlockFtCtx* ctx, uint32_t face_slot)
 {
-    if (ctx == NULL)
-        return;
-    for (uint32_t i = 0; i < DVZ_TEXT_BLOCK_FACE_COUNT; i++)
-    {
-        if (ctx->faces[i] != NULL)
-        {
-            FT_Done_Face(ctx->faces[i]);
-            ctx->faces[i] = NULL;
-        }
-    }
-    if (ctx->fallback_face != NULL)
-        FT_Done_Face(ctx->fallback_face);
-    if (ctx->owns_library)
-        FT_Done_FreeType(ctx->library);
-    dvz_memset(ctx, sizeof(DvzTextBlockFtCtx), 0, sizeof(DvzTextBlockFtCtx));
+    ANN(ctx);
+    if (face_slot == DVZ_TEXT_BLOCK_FACE_COUNT)
+        return ctx->fallback_face.face != NULL ? &ctx->fallback_face : NULL;
+    if (face_slot > DVZ_TEXT_BLOCK_FACE_COUNT || ctx->faces[face_slot].face == NULL)
+        return NULL;
+    return &ctx->faces[face_slot];
 }
 
 
@@ -802,14 +762,10 @@ static float _text_block_kerning(
     ANN(ctx);
     if (face_slot >= DVZ_TEXT_BLOCK_FACE_COUNT || left == 0 || right == 0)
         return 0.0f;
-    FT_Face face = ctx->faces[face_slot];
-    if (face == NULL || !FT_HAS_KERNING(face))
-        return 0.0f;
-
-    FT_Vector kerning = {0};
-    if (FT_Get_Kerning(face, left, right, FT_KERNING_DEFAULT, &kerning) != 0)
+    const DvzTextFtFace* face = _text_block_ft_slot(ctx, face_slot);
+    if (face == NULL)
         return 0.0f;
-    return (float)kerning.x / 64.0f;
+    return _scene_text_ft_kerning(ctx->cache, face, left, right);
 }
 
 
@@ -847,27 +803,28 @@ static float _text_block_item_range_width(
 
 
 /**
- * Draw one rendered FreeType glyph bitmap into a text-block raster.
+ * Draw one cached glyph coverage bitmap into a text-block raster.
  *
  * @param block the text block
- * @param bitmap source glyph bitmap
+ * @param glyph source glyph with rendered coverage
  * @param dst_x destination x origin, signed before clipping
  * @param dst_y destination y origin, signed before clipping
  * @param color text color
  */
-static void _text_block_draw_ft_bitmap(
-    DvzTextBlock* block, const FT_Bitmap* bitmap, int32_t dst_x, int32_t dst_y,
+static void _text_block_draw_ft_glyph(
+    DvzTextBlock* block, const DvzTextFtGlyph* glyph, int32_t dst_x, int32_t dst_y,
     const DvzColor color)
 {
     ANN(block);
-    ANN(bitmap);
-    uint32_t rows = (uint32_t)bitmap->rows;
-    uint32_t width = (uint32_t)bitmap->width;
-    for (uint32_t y = 0; y < rows; y++)
+    ANN(glyph);
+    if (glyph->coverage == NULL)
+        return;
+    for (uint32_t y = 0; y < glyph->rows; y++)
     {
-        for (uint32_t x = 0; x < width; x++)
+        const uint8_t* row = glyph->coverage + (uint64_t)y * glyph->width;
+        for (uint32_t x = 0; x < glyph->width; x++)
         {
-            uint8_t coverage = _text_block_ft_coverage(bitmap, x, y);
+            uint8_t coverage = row[x];
             if (coverage == 0)
                 continue;
             int32_t px = dst_x + (int32_t)x;
@@ -880,36 +837,6 @@ static void _text_block_draw_ft_bitmap(
 }
 
 
-/**
- * Return one FreeType bitmap coverage sample.
- *
- * @param bitmap source glyph bitmap
- * @param x x coordinate in the bitmap
- * @param y y coordinate in the bitmap
- * @return coverage in the range 0..255
- */
-static uint8_t _text_block_ft_coverage(const FT_Bitmap* bitmap, uint32_t x, uint32_t y)
-{
-    ANN(bitmap);
-    if (x >= (uint32_t)bitmap->width || y >= (uint32_t)bitmap->rows || bitmap->buffer == NULL)
-        return 0;
-
-    int pitch = bitmap->pitch;
-    uint32_t row_index = y;
-    if (pitch < 0)
-    {
-        pitch = -pitch;
-        row_index = (uint32_t)bitmap->rows - 1u - y;
-    }
-    const uint8_t* row = bitmap->buffer + (uint64_t)row_index * (uint32_t)pitch;
-    if (bitmap->pixel_mode == FT_PIXEL_MODE_GRAY)
-        return row[x];
-    if (bitmap->pixel_mode == FT_PIXEL_MODE_MONO)
-        return (row[x / 8u] & (uint8_t)(0x80u >> (x % 8u))) != 0 ? 255 : 0;
-    return 0;
-}
-
-
 /**
  * Resolve text-block fonts and record real faces available to layout.
  *
@@ -990,7 +917,7 @@ static bool _text_block_measure_freetype(DvzTextBlock* block, DvzColor text_colo
         return false;
     for (uint32_t i = 0; i < DVZ_TEXT_BLOCK_FACE_COUNT; i++)
     {
-        if (ctx.faces[i] == NULL)
+        if (ctx.faces[i].face == NULL)
             block->layout_fonts[i] = NULL;
     }
 
@@ -1008,7 +935,6 @@ static bool _text_block_measure_freetype(DvzTextBlock* block, DvzColor text_colo
         if (item_count >= DVZ_SCENE_TEXT_BLOCK_TEXT_SIZE)
         {
             _text_block_diag(block, "text block layout capacity exceeded", start);
-            _text_block_ft_close(&ctx);
             return false;
         }
 
@@ -1025,18 +951,18 @@ static bool _text_block_measure_freetype(DvzTextBlock* block, DvzColor text_colo
         if (item->newline)
             continue;
 
-        FT_Face item_face = ctx.faces[item->face_slot];
+        const DvzTextFtFace* item_face = _text_block_ft_slot(&ctx, item->face_slot);
         if (item_face == NULL)
             continue;
-        item->glyph_index = FT_Get_Char_Index(item_face, (FT_ULong)cp);
-        if (item->glyph_index == 0 && ctx.fallback_face != NULL)
+        item->glyph_index = FT_Get_Char_Index(item_face->face, (FT_ULong)cp);
+        if (item->glyph_index == 0 && ctx.fallback_face.face != NULL)
         {
-            FT_UInt fallback_glyph = FT_Get_Char_Index(ctx.fallback_face, (FT_ULong)cp);
+            FT_UInt fallback_glyph = FT_Get_Char_Index(ctx.fallback_face.face, (FT_ULong)cp);
             if (fallback_glyph != 0)
             {
                 item->face_slot = DVZ_TEXT_BLOCK_FACE_COUNT;
                 item->glyph_index = fallback_glyph;
-                item_face = ctx.fallback_face;
+                item_face = &ctx.fallback_face;
             }
         }
         if (item->glyph_index == 0 && !item->whitespace)
@@ -1045,10 +971,13 @@ static bool _text_block_measure_freetype(DvzTextBlock* block, DvzColor text_colo
             log_warn("rich text block skipped missing glyph U+%04X", cp);
             continue;
         }
-        if (item->glyph_index != 0 &&
-            FT_Load_Glyph(item_face, item->glyph_index, FT_LOAD_DEFAULT) == 0)
+        const DvzTextFtGlyph* glyph =
+            item->glyph_index != 0 ?
+                _scene_text_ft_glyph(ctx.cache, item_face, item->glyph_index, false) :
+                NULL;
+        if (glyph != NULL)
         {
-            item->advance = (float)item_face->glyph->advance.x / 64.0f;
+            item->advance = glyph->advance;
             item->visible = !item->whitespace;
         }
         if (item->whitespace && item->advance <= 0.0f)
@@ -1134,10 +1063,7 @@ static bool _text_block_measure_freetype(DvzTextBlock* block, DvzColor text_colo
             cursor_x += kern;
             float baseline_y = pad_y + ascender + (float)line * line_height;
             if (!_text_block_append_layout_item(block, item, pad_x + cursor_x, baseline_y))
-            {
-                _text_block_ft_close(&ctx);
                 return false;
-            }
             cursor_x += item->advance;
             previous_slot = item->visible ? item->face_slot : UINT32_MAX;
             previous_glyph = item->visible ? item->glyph_index : 0;
@@ -1169,8 +1095,6 @@ static bool _text_block_measure_freetype(DvzTextBlock* block, DvzColor text_colo
     block->metrics.ascender = ascender;
     block->metrics.descender = ctx.descender;
     block->metrics.line_height = line_height;
-
-    _text_block_ft_close(&ctx);
     return true;
 }
 
@@ -1198,24 +1122,18 @@ static bool _text_block_rasterize_freetype(
         if (!block->layout_visible[i])
             continue;
         uint32_t face_slot = block->layout_face_slot[i];
-        FT_Face face = face_slot == DVZ_TEXT_BLOCK_FACE_COUNT ? ctx.fallback_face :
-                                                               (face_slot < DVZ_TEXT_BLOCK_FACE_COUNT ? ctx.faces[face_slot] : NULL);
+        const DvzTextFtFace* face = _text_block_ft_slot(&ctx, face_slot);
         if (face == NULL)
             continue;
-        if (FT_Load_Glyph(face, block->layout_glyph_index[i], FT_LOAD_DEFAULT) != 0 ||
-            FT_Render_Glyph(face->glyph, FT_RENDER_MODE_NORMAL) != 0)
-        {
-            _text_block_ft_close(&ctx);
+        const DvzTextFtGlyph* glyph =
+            _scene_text_ft_glyph(ctx.cache, face, block->layout_glyph_index[i], true);
+        if (glyph == NULL)
             return false;
-        }
 
         float scale = desc->scale > 0.0f ? desc->scale : 1.0f;
-        int32_t dst_x = (int32_t)lroundf(block->layout_pos_x[i] * scale) +
-                        face->glyph->bitmap_left;
-        int32_t dst_y = (int32_t)lroundf(block->layout_baseline_y[i] * scale) -
-                        face->glyph->bitmap_top;
-        _text_block_draw_ft_bitmap(
-            block, &face->glyph->bitmap, dst_x, dst_y, block->layout_color[i]);
+        int32_t dst_x = (int32_t)lroundf(block->layout_pos_x[i] * scale) + glyph->left;
+        int32_t dst_y = (int32_t)lroundf(block->layout_baseline_y[i] * scale) - glyph->top;
+        _text_block_draw_ft_glyph(block, glyph, dst_x, dst_y, block->layout_color[i]);
 
         if ((block->layout_style_flags[i] & DVZ_TEXT_BLOCK_STYLE_UNDERLINE) != 0)
         {
@@ -1233,8 +1151,6 @@ static bool _text_block_rasterize_freetype(
             }
         }
     }
-
-    _text_block_ft_close(&ctx);
     return true;
 }
 #endif
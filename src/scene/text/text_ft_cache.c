@@ -0,0 +1,523 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Scene FreeType face and glyph cache                                                          */
+/*************************************************************************************************/
+
+/*
+ * One FreeType library per scene, a small LRU of faces opened per (font, face index, pixel size),
+ * and an LRU hash table of glyph advances, rendered coverage bitmaps, and kerning pairs. Text
+ * blocks used to open FreeType and every face on each measure and rasterize call.
+ */
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "_alloc.h"
+#include "_assertions.h"
+#include "_log.h"
+#include "text/text_ft_cache.h"
+#include "text/text_internal.h"
+
+
+
+#if defined(DVZ_HAS_FREETYPE) && DVZ_HAS_FREETYPE
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define TEXT_FT_NIL          UINT32_MAX
+#define TEXT_FT_BUCKET_COUNT (2 * DVZ_TEXT_FT_MAX_ENTRIES)
+#define TEXT_FT_GLYPH_KEY    UINT32_MAX
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct DvzTextFtFaceSlot DvzTextFtFaceSlot;
+typedef struct DvzTextFtEntry DvzTextFtEntry;
+
+struct DvzTextFtFaceSlot
+{
+    const DvzFont* font;
+    const void* ttf_bytes;
+    uint32_t face_index;
+    uint32_t px;
+    DvzTextFtFace face;
+    uint64_t stamp;
+};
+
+// A glyph (b == TEXT_FT_GLYPH_KEY) or a kerning pair (a, b) of one face.
+struct DvzTextFtEntry
+{
+    uint32_t face_id;
+    uint32_t a;
+    uint32_t b;
+    uint32_t bucket_next;
+    uint32_t lru_prev;
+    uint32_t lru_next;
+    bool rendered;
+    float kerning;
+    DvzTextFtGlyph glyph;
+    uint8_t* bitmap;
+};
+
+struct DvzTextFtCache
+{
+    FT_Library library;
+    DvzTextFtFaceSlot faces[DVZ_TEXT_FT_MAX_FACES];
+    uint32_t next_face_id;
+    uint64_t clock;
+
+    DvzTextFtEntry* entries;
+    uint32_t* buckets;
+    uint32_t entry_count;
+    uint32_t lru_head; /* most recently used */
+    uint32_t lru_tail; /* least recently used */
+
+    DvzTextFtCacheStats stats;
+};
+
+
+
+/*************************************************************************************************/
+/*  Entry table                                                                                  */
+/*************************************************************************************************/
+
+static uint32_t _text_ft_hash(uint32_t face_id, uint32_t a, uint32_t b)
+{
+    uint64_t h = ((uint64_t)face_id << 32) ^ ((uint64_t)a * 0x9E3779B97F4A7C15ull) ^ b;
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    return (uint32_t)(h % TEXT_FT_BUCKET_COUNT);
+}
+
+
+
+static void _text_ft_lru_unlink(DvzTextFtCache* cache, uint32_t idx)
+{
+    DvzTextFtEntry* entry = &cache->entries[idx];
+    if (entry->lru_prev != TEXT_FT_NIL)
+        cache->entries[entry->lru_prev].lru_next = entry->lru_next;
+    else
+        cache->lru_head = entry->lru_next;
+    if (entry->lru_next != TEXT_FT_NIL)
+        cache->entries[entry->lru_next].lru_prev = entry->lru_prev;
+    else
+        cache->lru_tail = entry->lru_prev;
+    entry->lru_prev = entry->lru_next = TEXT_FT_NIL;
+}
+
+
+
+static void _text_ft_lru_push_front(DvzTextFtCache* cache, uint32_t idx)
+{
+    DvzTextFtEntry* entry = &cache->entries[idx];
+    entry->lru_prev = TEXT_FT_NIL;
+    entry->lru_next = cache->lru_head;
+    if (cache->lru_head != TEXT_FT_NIL)
+        cache->entries[cache->lru_head].lru_prev = idx;
+    cache->lru_head = idx;
+    if (cache->lru_tail == TEXT_FT_NIL)
+        cache->lru_tail = idx;
+}
+
+
+
+/**
+ * Remove one entry from its bucket and the LRU list and release its bitmap.
+ *
+ * @param cache the cache
+ * @param idx entry index
+ */
+static void _text_ft_entry_release(DvzTextFtCache* cache, uint32_t idx)
+{
+    DvzTextFtEntry* entry = &cache->entries[idx];
+    uint32_t* link = &cache->buckets[_text_ft_hash(entry->face_id, entry->a, entry->b)];
+    while (*link != TEXT_FT_NIL && *link != idx)
+        link = &cache->entries[*link].bucket_next;
+    if (*link == idx)
+        *link = entry->bucket_next;
+    _text_ft_lru_unlink(cache, idx);
+
+    if (entry->bitmap != NULL)
+    {
+        cache->stats.bitmap_bytes -= (uint64_t)entry->glyph.width * entry->glyph.rows;
+        dvz_free(entry->bitmap);
+    }
+    dvz_memset(entry, sizeof(DvzTextFtEntry), 0, sizeof(DvzTextFtEntry));
+    entry->bucket_next = entry->lru_prev = entry->lru_next = TEXT_FT_NIL;
+}
+
+
+
+static DvzTextFtEntry* _text_ft_entry_find(
+    DvzTextFtCache* cache, uint32_t face_id, uint32_t a, uint32_t b)
+{
+    uint32_t idx = cache->buckets[_text_ft_hash(face_id, a, b)];
+    while (idx != TEXT_FT_NIL)
+    {
+        DvzTextFtEntry* entry = &cache->entries[idx];
+        if (entry->face_id == face_id && entry->a == a && entry->b == b)
+        {
+            _text_ft_lru_unlink(cache, idx);
+            _text_ft_lru_push_front(cache, idx);
+            cache->stats.hits++;
+            return entry;
+        }
+        idx = entry->bucket_next;
+    }
+    return NULL;
+}
+
+
+
+/**
+ * Insert a new entry, evicting the least recently used one when the table is full.
+ *
+ * @param cache the cache
+ * @param face_id owning face identifier
+ * @param a glyph index, or left glyph of a kerning pair
+ * @param b TEXT_FT_GLYPH_KEY, or right glyph of a kerning pair
+ * @return the new entry
+ */
+static DvzTextFtEntry* _text_ft_entry_insert(
+    DvzTextFtCache* cache, uint32_t face_id, uint32_t a, uint32_t b)
+{
+    uint32_t idx = TEXT_FT_NIL;
+    if (cache->entry_count < DVZ_TEXT_FT_MAX_ENTRIES)
+    {
+        idx = cache->entry_count++;
+    }
+    else
+    {
+        idx = cache->lru_tail;
+        _text_ft_entry_release(cache, idx);
+    }
+
+    DvzTextFtEntry* entry = &cache->entries[idx];
+    entry->face_id = face_id;
+    entry->a = a;
+    entry->b = b;
+    uint32_t bucket = _text_ft_hash(face_id, a, b);
+    entry->bucket_next = cache->buckets[bucket];
+    cache->buckets[bucket] = idx;
+    _text_ft_lru_push_front(cache, idx);
+    return entry;
+}
+
+
+
+/**
+ * Drop the least recently used glyph bitmaps until the bitmap budget is met.
+ *
+ * @param cache the cache
+ * @param keep entry that must stay resident
+ */
+static void _text_ft_trim_bitmaps(DvzTextFtCache* cache, const DvzTextFtEntry* keep)
+{
+    uint32_t idx = cache->lru_tail;
+    while (cache->stats.bitmap_bytes > DVZ_TEXT_FT_BITMAP_BUDGET && idx != TEXT_FT_NIL)
+    {
+        DvzTextFtEntry* entry = &cache->entries[idx];
+        idx = entry->lru_prev;
+        if (entry == keep || entry->bitmap == NULL)
+            continue;
+        cache->stats.bitmap_bytes -= (uint64_t)entry->glyph.width * entry->glyph.rows;
+        dvz_free(entry->bitmap);
+        entry->bitmap = NULL;
+        entry->glyph.coverage = NULL;
+        entry->rendered = false;
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Faces                                                                                        */
+/*************************************************************************************************/
+
+static void _text_ft_face_close(DvzTextFtCache* cache, DvzTextFtFaceSlot* slot)
+{
+    ANN(cache);
+    ANN(slot);
+    // Glyph entries of a closed face are keyed by a retired identifier and age out of the LRU.
+    if (slot->face.face != NULL)
+    {
+        FT_Done_Face(slot->face.face);
+        cache->stats.face_count--;
+    }
+    dvz_memset(slot, sizeof(DvzTextFtFaceSlot), 0, sizeof(DvzTextFtFaceSlot));
+}
+
+
+
+DvzTextFtCache* _scene_text_ft_cache(DvzScene* scene)
+{
+    ANN(scene);
+    if (scene->text_ft_cache != NULL)
+        return scene->text_ft_cache;
+
+    DvzTextFtCache* cache = (DvzTextFtCache*)dvz_calloc(1, sizeof(DvzTextFtCache));
+    ANN(cache);
+    if (FT_Init_FreeType(&cache->library) != 0)
+    {
+        log_error("unable to initialize FreeType");
+        dvz_free(cache);
+        return NULL;
+    }
+    cache->entries =
+        (DvzTextFtEntry*)dvz_calloc(DVZ_TEXT_FT_MAX_ENTRIES, sizeof(DvzTextFtEntry));
+    cache->buckets = (uint32_t*)dvz_malloc(TEXT_FT_BUCKET_COUNT * sizeof(uint32_t));
+    ANN(cache->entries);
+    ANN(cache->buckets);
+    dvz_memset(
+        cache->buckets, TEXT_FT_BUCKET_COUNT * sizeof(uint32_t), 0xFF,
+        TEXT_FT_BUCKET_COUNT * sizeof(uint32_t));
+    cache->lru_head = cache->lru_tail = TEXT_FT_NIL;
+    cache->next_face_id = 1;
+    scene->text_ft_cache = cache;
+    return cache;
+}
+
+
+
+bool _scene_text_ft_face(
+    DvzTextFtCache* cache, DvzFont* font, uint32_t face_index, uint32_t px, DvzTextFtFace* out)
+{
+    ANN(cache);
+    ANN(out);
+    out->face = NULL;
+    out->id = 0;
+    if (font == NULL || px == 0 || !_scene_font_ensure_bytes(font))
+        return false;
+
+    cache->clock++;
+    DvzTextFtFaceSlot* victim = &cache->faces[0];
+    for (uint32_t i = 0; i < DVZ_TEXT_FT_MAX_FACES; i++)
+    {
+        DvzTextFtFaceSlot* slot = &cache->faces[i];
+        if (slot->face.face != NULL && slot->font == font && slot->ttf_bytes == font->ttf_bytes &&
+            slot->face_index == face_index && slot->px == px)
+        {
+            slot->stamp = cache->clock;
+            *out = slot->face;
+            return true;
+        }
+        if (victim->face.face != NULL && (slot->face.face == NULL || slot->stamp < victim->stamp))
+            victim = slot;
+    }
+
+    _text_ft_face_close(cache, victim);
+    FT_Face face = NULL;
+    if (FT_New_Memory_Face(
+            cache->library, (const FT_Byte*)font->ttf_bytes, (FT_Long)font->ttf_size,
+            (FT_Long)face_index, &face) != 0)
+        return false;
+    cache->stats.face_loads++;
+    if (FT_Set_Pixel_Sizes(face, 0, (FT_UInt)px) != 0)
+    {
+        FT_Done_Face(face);
+        return false;
+    }
+
+    victim->font = font;
+    victim->ttf_bytes = font->ttf_bytes;
+    victim->face_index = face_index;
+    victim->px = px;
+    victim->face.face = face;
+    victim->face.id = cache->next_face_id++;
+    victim->stamp = cache->clock;
+    cache->stats.face_count++;
+    *out = victim->face;
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Glyphs                                                                                       */
+/*************************************************************************************************/
+
+/**
+ * Copy a rendered FreeType bitmap into tightly packed 8-bit coverage.
+ *
+ * @param bitmap rendered glyph bitmap
+ * @param dst destination with `width * rows` bytes
+ */
+static void _text_ft_copy_coverage(const FT_Bitmap* bitmap, uint8_t* dst)
+{
+    ANN(bitmap);
+    ANN(dst);
+    const uint32_t width = (uint32_t)bitmap->width;
+    const uint32_t rows = (uint32_t)bitmap->rows;
+    const int pitch = bitmap->pitch;
+    const uint32_t stride = (uint32_t)(pitch < 0 ? -pitch : pitch);
+    for (uint32_t y = 0; y < rows; y++)
+    {
+        uint32_t row_index = pitch < 0 ? rows - 1u - y : y;
+        const uint8_t* row = bitmap->buffer + (uint64_t)row_index * stride;
+        uint8_t* out = dst + (uint64_t)y * width;
+        for (uint32_t x = 0; x < width; x++)
+        {
+            if (bitmap->pixel_mode == FT_PIXEL_MODE_GRAY)
+                out[x] = row[x];
+            else if (bitmap->pixel_mode == FT_PIXEL_MODE_MONO)
+                out[x] = (row[x / 8u] & (uint8_t)(0x80u >> (x % 8u))) != 0 ? 255 : 0;
+            else
+                out[x] = 0;
+        }
+    }
+}
+
+
+
+const DvzTextFtGlyph* _scene_text_ft_glyph(
+    DvzTextFtCache* cache, const DvzTextFtFace* face, uint32_t glyph_index, bool render)
+{
+    ANN(cache);
+    ANN(face);
+    if (face->face == NULL)
+        return NULL;
+
+    DvzTextFtEntry* entry = _text_ft_entry_find(cache, face->id, glyph_index, TEXT_FT_GLYPH_KEY);
+    if (entry != NULL && (!render || entry->rendered))
+        return &entry->glyph;
+
+    if (FT_Load_Glyph(face->face, glyph_index, FT_LOAD_DEFAULT) != 0)
+        return NULL;
+    cache->stats.glyph_loads++;
+    if (entry == NULL)
+    {
+        entry = _text_ft_entry_insert(cache, face->id, glyph_index, TEXT_FT_GLYPH_KEY);
+        entry->glyph.advance = (float)face->face->glyph->advance.x / 64.0f;
+    }
+    if (!render)
+        return &entry->glyph;
+
+    if (FT_Render_Glyph(face->face->glyph, FT_RENDER_MODE_NORMAL) != 0)
+        return NULL;
+    cache->stats.glyph_renders++;
+    const FT_GlyphSlot slot = face->face->glyph;
+    const FT_Bitmap* bitmap = &slot->bitmap;
+    entry->glyph.left = slot->bitmap_left;
+    entry->glyph.top = slot->bitmap_top;
+    entry->glyph.width = (uint32_t)bitmap->width;
+    entry->glyph.rows = (uint32_t)bitmap->rows;
+    const uint64_t size = (uint64_t)entry->glyph.width * entry->glyph.rows;
+    if (size > 0 && bitmap->buffer != NULL)
+    {
+        entry->bitmap = (uint8_t*)dvz_malloc((size_t)size);
+        ANN(entry->bitmap);
+        _text_ft_copy_coverage(bitmap, entry->bitmap);
+        cache->stats.bitmap_bytes += size;
+    }
+    else
+    {
+        entry->glyph.width = entry->glyph.rows = 0;
+    }
+    entry->glyph.coverage = entry->bitmap;
+    entry->rendered = true;
+    _text_ft_trim_bitmaps(cache, entry);
+    return &entry->glyph;
+}
+
+
+
+float _scene_text_ft_kerning(
+    DvzTextFtCache* cache, const DvzTextFtFace* face, uint32_t left, uint32_t right)
+{
+    ANN(cache);
+    ANN(face);
+    if (face->face == NULL || left == 0 || right == 0 || !FT_HAS_KERNING(face->face))
+        return 0.0f;
+
+    DvzTextFtEntry* entry = _text_ft_entry_find(cache, face->id, left, right);
+    if (entry != NULL)
+        return entry->kerning;
+
+    FT_Vector kerning = {0};
+    float value = 0.0f;
+    if (FT_Get_Kerning(face->face, left, right, FT_KERNING_DEFAULT, &kerning) == 0)
+        value = (float)kerning.x / 64.0f;
+    entry = _text_ft_entry_insert(cache, face->id, left, right);
+    entry->kerning = value;
+    return value;
+}
+
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Lifetime                                                                                     */
+/*************************************************************************************************/
+
+void _scene_text_ft_cache_forget_font(DvzScene* scene, const DvzFont* font)
+{
+#if defined(DVZ_HAS_FREETYPE) && DVZ_HAS_FREETYPE
+    if (scene == NULL || scene->text_ft_cache == NULL || font == NULL)
+        return;
+    DvzTextFtCache* cache = scene->text_ft_cache;
+    for (uint32_t i = 0; i < DVZ_TEXT_FT_MAX_FACES; i++)
+    {
+        if (cache->faces[i].font == font)
+            _text_ft_face_close(cache, &cache->faces[i]);
+    }
+#else
+    (void)scene;
+    (void)font;
+#endif
+}
+
+
+
+bool _scene_text_ft_cache_stats(const DvzScene* scene, DvzTextFtCacheStats* out)
+{
+    if (scene == NULL || out == NULL)
+        return false;
+    dvz_memset(out, sizeof(DvzTextFtCacheStats), 0, sizeof(DvzTextFtCacheStats));
+#if defined(DVZ_HAS_FREETYPE) && DVZ_HAS_FREETYPE
+    if (scene->text_ft_cache == NULL)
+        return false;
+    *out = scene->text_ft_cache->stats;
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+
+void _scene_text_ft_cache_destroy(DvzTextFtCache* cache)
+{
+#if defined(DVZ_HAS_FREETYPE) && DVZ_HAS_FREETYPE
+    if (cache == NULL)
+        return;
+    for (uint32_t i = 0; i < DVZ_TEXT_FT_MAX_FACES; i++)
+        _text_ft_face_close(cache, &cache->faces[i]);
+    for (uint32_t i = 0; i < cache->entry_count; i++)
+        dvz_free(cache->entries[i].bitmap);
+    dvz_free(cache->entries);
+    dvz_free(cache->buckets);
+    FT_Done_FreeType(cache->library);
+    dvz_free(cache);
+#else
+    (void)cache;
+#endif
+}
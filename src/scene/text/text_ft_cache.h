@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Scene FreeType face and glyph cache                                                          */
+/*************************************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "_scene.h"
+
+#if defined(DVZ_HAS_FREETYPE) && DVZ_HAS_FREETYPE
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_TEXT_FT_MAX_FACES      32
+#define DVZ_TEXT_FT_MAX_ENTRIES    8192
+#define DVZ_TEXT_FT_BITMAP_BUDGET  (16u << 20)
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct DvzTextFtCacheStats DvzTextFtCacheStats;
+
+struct DvzTextFtCacheStats
+{
+    uint32_t face_count;    /* currently open faces */
+    uint64_t face_loads;    /* FT_New_Memory_Face() calls */
+    uint64_t glyph_loads;   /* FT_Load_Glyph() calls */
+    uint64_t glyph_renders; /* FT_Render_Glyph() calls */
+    uint64_t hits;          /* glyph and kerning lookups served from the cache */
+    uint64_t bitmap_bytes;  /* resident glyph bitmap bytes */
+};
+
+
+
+#if defined(DVZ_HAS_FREETYPE) && DVZ_HAS_FREETYPE
+typedef struct DvzTextFtFace DvzTextFtFace;
+typedef struct DvzTextFtGlyph DvzTextFtGlyph;
+
+struct DvzTextFtFace
+{
+    FT_Face face; /* sized to the requested pixel size; do not change its size */
+    uint32_t id;  /* unique for the lifetime of the cache */
+};
+
+struct DvzTextFtGlyph
+{
+    float advance;            /* pixels */
+    int32_t left;             /* bitmap left bearing in pixels */
+    int32_t top;              /* bitmap top bearing in pixels */
+    uint32_t width;           /* bitmap width in pixels */
+    uint32_t rows;            /* bitmap height in pixels */
+    const uint8_t* coverage;  /* tightly packed 8-bit coverage, NULL until rendered */
+};
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+EXTERN_C_ON
+
+void _scene_text_ft_cache_destroy(DvzTextFtCache* cache);
+
+void _scene_text_ft_cache_forget_font(DvzScene* scene, const DvzFont* font);
+
+bool _scene_text_ft_cache_stats(const DvzScene* scene, DvzTextFtCacheStats* out);
+
+#if defined(DVZ_HAS_FREETYPE) && DVZ_HAS_FREETYPE
+DvzTextFtCache* _scene_text_ft_cache(DvzScene* scene);
+
+bool _scene_text_ft_face(
+    DvzTextFtCache* cache, DvzFont* font, uint32_t face_index, uint32_t px, DvzTextFtFace* out);
+
+const DvzTextFtGlyph* _scene_text_ft_glyph(
+    DvzTextFtCache* cache, const DvzTextFtFace* face, uint32_t glyph_index, bool render);
+
+float _scene_text_ft_kerning(
+    DvzTextFtCache* cache, const DvzTextFtFace* face, uint32_t left, uint32_t right);
+#endif
+
+EXTERN_C_OFF
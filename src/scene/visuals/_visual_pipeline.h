@@ -131,6 +131,7 @@ typedef struct DvzSceneVisualDesc
     bool image_pixel_space;
     bool image_nearest_sampler;
     DvzColorRole image_color_role;
+    float field_ring_origin[4];
     uint32_t labels_visual_index;
     DvzLabelsState labels_state;
     uint32_t labels_lookup_count;
@@ -263,6 +264,7 @@ typedef struct DvzSceneVisualBindDesc
     bool image_nearest_sampler;
     uint64_t image_texture_id;
     DvzColorRole image_color_role;
+    float field_ring_origin[4];
     bool uses_labels_set1;
     uint64_t labels_texture_id;
     uint32_t labels_visual_index;
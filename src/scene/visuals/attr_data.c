@@ -30,6 +30,7 @@
 #include "_visual_family.h"
 #include "_visual_internal.h"
 #include "datoviz/scene.h"
+#include "query/internal.h"
 #include "registry/registry.h"
 #include "sample_profile.h"
 #include "text/text_internal.h"
@@ -902,7 +903,9 @@ DvzResult dvz_visual_set_data_range(
         if (!visual->ops->after_attr_set(visual, attr_name, item_count))
             return -1;
     }
+    uint64_t previous_version = attr->version;
     _visual_bump_version(&attr->version);
+    _scene_spatial_index_note_range(visual, attr, previous_version, first_item, item_count);
     _scene_notify_visual_changed(visual);
     return 0;
 }
@@ -38,7 +38,9 @@
 #include "datoviz/scene.h"
 #include "domain/buffer_internal.h"
 #include "domain/field_internal.h"
+#include "domain/mesh_surface_internal.h"
 #include "image/cache.h"
+#include "query/internal.h"
 #include "registry/registry.h"
 #include "stroke/cache.h"
 #include "stroke/state.h"
@@ -432,6 +434,8 @@ void _scene_visual_reset(DvzVisual* visual, bool release_owned_resources)
             visual->attrs[i].data = NULL;
         }
     }
+    if (state != NULL)
+        _scene_mesh_surface_release(visual, release_owned_resources);
     if (release_owned_resources)
     {
         _scene_release_visual_field(visual);
@@ -456,6 +460,10 @@ void _scene_visual_reset(DvzVisual* visual, bool release_owned_resources)
         dvz_free(visual->link_keys);
         visual->link_keys = NULL;
     }
+    _scene_spatial_index_destroy(visual->spatial_index);
+    visual->spatial_index = NULL;
+    _scene_region_selection_destroy(visual->region_selection);
+    visual->region_selection = NULL;
     if (state != NULL && state->texture.rgba != NULL)
     {
         dvz_free(state->texture.rgba);
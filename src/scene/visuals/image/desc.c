@@ -60,6 +60,8 @@ bool _scene_image_visual_desc_from_metadata(
     out->image_color_role = _scene_visual_desc_resource_color_role(emitter, tex_id);
     if (out->image_color_role == DVZ_COLOR_ROLE_NONE)
         out->image_color_role = meta->image_color_role;
+    for (uint32_t i = 0; i < 4; i++)
+        out->field_ring_origin[i] = meta->field_ring_origin[i];
     out->vbuf_ids[out->vbuf_count++] = uv_id;
     out->image_texture_id = tex_id;
     uint64_t pos_buf = out->vbuf_ids[0];
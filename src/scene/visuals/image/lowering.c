@@ -112,5 +112,7 @@ bool _scene_image_visual_bind_desc(
     out->image_texture_id = visual->image_texture_id;
     out->image_nearest_sampler = visual->image_nearest_sampler;
     out->image_color_role = visual->image_color_role;
+    for (uint32_t i = 0; i < 4; i++)
+        out->field_ring_origin[i] = visual->field_ring_origin[i];
     return true;
 }
@@ -374,6 +374,8 @@ bool _scene_image_query_plan(
         .image_nearest_sampler = pending->request.target == DVZ_SCENE_TARGET_PIXEL,
         .image_color_role = texture_color_role,
     };
+    // Field textures are uploaded in physical order, so the query samples through the ring origin.
+    _field_ring_origin_uvw(_visual_family_state(visual)->field, metadata.field_ring_origin);
     dvz_strlcpy(metadata.position_id, "query0_position", sizeof(metadata.position_id));
     dvz_strlcpy(metadata.texcoords_id, "query0_texcoords", sizeof(metadata.texcoords_id));
     dvz_strlcpy(metadata.texture_id, "query0_texture", sizeof(metadata.texture_id));
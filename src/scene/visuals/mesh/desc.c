@@ -79,6 +79,8 @@ bool _scene_mesh_visual_desc_from_metadata(
         out->image_color_role = _scene_visual_desc_resource_color_role(emitter, texture_id);
         if (out->image_color_role == DVZ_COLOR_ROLE_NONE)
             out->image_color_role = meta->image_color_role;
+        for (uint32_t i = 0; i < 4; i++)
+            out->field_ring_origin[i] = meta->field_ring_origin[i];
     }
 
     uint64_t instance_transform_id =
@@ -45,7 +45,7 @@ bool _scene_mesh_visual_lowering(const DvzVisual* visual, DvzVisualLowering* out
                          ? _scene_visual_family_desc_kind(DVZ_VISUAL_TYPE_MESH)
                          : _scene_visual_family_desc_kind(DVZ_VISUAL_TYPE_PRIMITIVE);
     out->needs_material_params =
-        _scene_visual_has_dense_attr(visual, "normal") ||
+        _scene_visual_has_attr_source(visual, "normal") ||
         _scene_visual_has_dense_attr(visual, "item_state");
     return true;
 }
@@ -88,6 +88,8 @@ bool _scene_mesh_visual_bind_desc(
         out->image_texture_id = visual->image_texture_id;
         out->image_nearest_sampler = visual->image_nearest_sampler;
         out->image_color_role = visual->image_color_role;
+        for (uint32_t i = 0; i < 4; i++)
+            out->field_ring_origin[i] = visual->field_ring_origin[i];
     }
     return true;
 }
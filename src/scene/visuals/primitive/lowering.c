@@ -41,7 +41,7 @@ bool _scene_primitive_visual_lowering(const DvzVisual* visual, DvzVisualLowering
     out->draw_position_attr = "position";
     out->renderable_kind = DVZ_RENDERABLE_INDEXED_MESH;
     out->desc_kind = DVZ_SCENE_VISUAL_DESC_PRIMITIVE;
-    out->needs_material_params = _scene_visual_has_dense_attr(visual, "normal");
+    out->needs_material_params = _scene_visual_has_attr_source(visual, "normal");
     return true;
 }
 
@@ -201,6 +201,24 @@ bool _scene_visual_has_dense_attr(const DvzVisual* visual, const char* name)
 }
 
 
+/**
+ * Return whether one retained visual has dense data or a bound buffer for an attribute.
+ *
+ * @param visual the retained visual
+ * @param name the attribute name
+ * @return whether the attribute has a data source
+ */
+bool _scene_visual_has_attr_source(const DvzVisual* visual, const char* name)
+{
+    ANN(visual);
+    ANN(name);
+    int attr_idx = _attr_index(visual, name);
+    return attr_idx >= 0 &&
+           (visual->attrs[attr_idx].data != NULL || visual->attrs[attr_idx].buffer != NULL) &&
+           visual->attrs[attr_idx].item_count > 0;
+}
+
+
 /**
  * Return whether a visual descriptor uses the primitive pipeline family.
  *
@@ -202,7 +202,7 @@ bool _scene_visual_default_pass_caps(
     DvzSceneVisualDescKind kind = lowering->desc_kind;
     bool has_normals =
         (_scene_visual_desc_is_primitive(kind) || kind == DVZ_SCENE_VISUAL_DESC_TEXTURED_MESH) &&
-        _scene_visual_has_dense_attr(visual, "normal");
+        _scene_visual_has_attr_source(visual, "normal");
 
     bool point_like = kind == DVZ_SCENE_VISUAL_DESC_POINT || kind == DVZ_SCENE_VISUAL_DESC_PIXEL ||
                       kind == DVZ_SCENE_VISUAL_DESC_MARKER;
@@ -92,6 +92,8 @@ bool _scene_volume_visual_desc_from_metadata(
     out->volume_occluded = meta->volume_occluded;
     out->volume_occlusion = meta->volume_occlusion;
     out->volume_state = meta->volume_state;
+    for (uint32_t i = 0; i < 4; i++)
+        out->field_ring_origin[i] = meta->field_ring_origin[i];
     out->topology = DVZ_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     return true;
 }
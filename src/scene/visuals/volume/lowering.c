@@ -152,6 +152,8 @@ bool _scene_volume_visual_bind_desc(
     out->volume_occluded = visual->volume_occluded;
     out->volume_occlusion = visual->volume_occlusion;
     out->volume_state = visual->volume_state;
+    for (uint32_t i = 0; i < 4; i++)
+        out->field_ring_origin[i] = visual->field_ring_origin[i];
     if (
         visual->kind == DVZ_SCENE_VISUAL_DESC_VOLUME_LABELS_SINT ||
         visual->kind == DVZ_SCENE_VISUAL_DESC_VOLUME_LABELS_UINT)
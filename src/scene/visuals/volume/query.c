@@ -488,6 +488,7 @@ static bool _volume_query_build_sample(
     metadata.field_width = field->desc.width;
     metadata.field_height = field->desc.height;
     metadata.field_depth = field->desc.depth;
+    _field_ring_origin_uvw(field, metadata.field_ring_origin);
     metadata.has_volume = true;
     metadata.volume_state = _visual_family_state(ctx->visual)->volume;
     metadata.volume_transfer_rgba = false;
@@ -15,6 +15,7 @@
 /*************************************************************************************************/
 
 #include <stddef.h>
+#include <stdlib.h>
 
 #include "../atomic_internal.h"
 #include "../thread_internal.h"
@@ -208,6 +209,112 @@ int test_thread_log_concurrent(TstContext* suite, const TstCase* tstitem)
 
 
 
+/*************************************************************************************************/
+/*  Thread pool tests                                                                            */
+/*************************************************************************************************/
+
+static void _pool_fill_callback(uint32_t begin, uint32_t end, void* user_data)
+{
+    ANN(user_data);
+    uint32_t* values = (uint32_t*)user_data;
+    for (uint32_t i = begin; i < end; i++)
+        values[i] += i + 1;
+}
+
+static void* _pool_future_callback(void* user_data)
+{
+    ANN(user_data);
+    *((int*)user_data) *= 2;
+    return user_data;
+}
+
+int test_thread_pool_1(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+
+    enum
+    {
+        COUNT = 10000,
+    };
+    DvzThreadPool* pool = dvz_thread_pool(3);
+    ANN(pool);
+    AT(dvz_thread_pool_size(pool) == 3);
+    AT(dvz_thread_pool_default_size() >= 1);
+
+    /* Every index is visited exactly once, whatever the grain. */
+    uint32_t* values = (uint32_t*)calloc(COUNT, sizeof(uint32_t));
+    ANN(values);
+    dvz_thread_pool_parallel_for(pool, COUNT, 0, _pool_fill_callback, values);
+    dvz_thread_pool_parallel_for(pool, COUNT, 7, _pool_fill_callback, values);
+    dvz_thread_pool_parallel_for(NULL, COUNT, 0, _pool_fill_callback, values);
+    for (uint32_t i = 0; i < COUNT; i++)
+        AT(values[i] == 3 * (i + 1));
+    free(values);
+
+    /* Futures return the task result. */
+    int data[8] = {0};
+    DvzFuture* futures[8] = {0};
+    for (int i = 0; i < 8; i++)
+    {
+        data[i] = i;
+        futures[i] = dvz_thread_pool_submit(pool, _pool_future_callback, &data[i]);
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        AT(dvz_future_wait(futures[i]) == &data[i]);
+        AT(data[i] == 2 * i);
+    }
+
+    dvz_thread_pool_destroy(pool);
+    return 0;
+}
+
+
+
+typedef struct
+{
+    DvzThreadPool* pool;
+    uint32_t values[256];
+} PoolNestedData;
+
+static void* _pool_nested_callback(void* user_data)
+{
+    ANN(user_data);
+    PoolNestedData* data = (PoolNestedData*)user_data;
+    dvz_thread_pool_parallel_for(data->pool, 256, 16, _pool_fill_callback, data->values);
+    return NULL;
+}
+
+int test_thread_pool_nested(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+
+    /* Tasks waiting on nested work help run it, so a single worker cannot deadlock. */
+    DvzThreadPool* pool = dvz_thread_pool(1);
+    ANN(pool);
+    DvzTaskGroup* group = dvz_task_group(pool);
+    ANN(group);
+
+    PoolNestedData* data = (PoolNestedData*)calloc(16, sizeof(PoolNestedData));
+    ANN(data);
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        data[i].pool = pool;
+        dvz_task_group_run(group, _pool_nested_callback, &data[i]);
+    }
+    dvz_task_group_wait(group);
+    for (uint32_t i = 0; i < 16; i++)
+        for (uint32_t j = 0; j < 256; j++)
+            AT(data[i].values[j] == j + 1);
+
+    dvz_task_group_destroy(group);
+    dvz_thread_pool_destroy(pool);
+    free(data);
+    return 0;
+}
+
+
+
 /*************************************************************************************************/
 /*  Entry-point                                                                                  */
 /*************************************************************************************************/
@@ -225,6 +332,8 @@ int test_thread(TstSuite* suite)
     TST_CASE(test_cond_1);
     TST_CASE(test_atomic_1);
     TST_CASE(test_thread_log_concurrent);
+    TST_CASE(test_thread_pool_1);
+    TST_CASE(test_thread_pool_nested);
 
     return 0;
 }
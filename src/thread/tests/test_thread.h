@@ -34,6 +34,10 @@ int test_atomic_1(TstContext* suite, const TstCase* tstitem);
 
 int test_thread_log_concurrent(TstContext* suite, const TstCase* tstitem);
 
+int test_thread_pool_1(TstContext* suite, const TstCase* tstitem);
+
+int test_thread_pool_nested(TstContext* suite, const TstCase* tstitem);
+
 
 
 int test_thread(TstSuite* suite);
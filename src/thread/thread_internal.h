@@ -19,6 +19,8 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include <stdint.h>
+
 #include "datoviz/common/macros.h"
 
 
@@ -28,9 +30,15 @@
 /*************************************************************************************************/
 
 typedef struct DvzThread DvzThread;
+typedef struct DvzThreadPool DvzThreadPool;
+typedef struct DvzTaskGroup DvzTaskGroup;
+typedef struct DvzFuture DvzFuture;
 
 typedef void* (*DvzThreadCallback)(void*);
 
+// Process the half-open index range [begin, end) of a parallel-for.
+typedef void (*DvzParallelForCallback)(uint32_t begin, uint32_t end, void* user_data);
+
 
 
 EXTERN_C_ON
@@ -45,4 +53,41 @@ DVZ_EXPORT void dvz_thread_join(DvzThread* thread);
 
 
 
+/*************************************************************************************************/
+/*  Thread pool functions                                                                        */
+/*************************************************************************************************/
+
+DVZ_EXPORT uint32_t dvz_thread_pool_default_size(void);
+
+DVZ_EXPORT DvzThreadPool* dvz_thread_pool(uint32_t worker_count);
+
+DVZ_EXPORT uint32_t dvz_thread_pool_size(DvzThreadPool* pool);
+
+DVZ_EXPORT void dvz_thread_pool_parallel_for(
+    DvzThreadPool* pool, uint32_t count, uint32_t grain, DvzParallelForCallback callback,
+    void* user_data);
+
+DVZ_EXPORT DvzFuture*
+dvz_thread_pool_submit(DvzThreadPool* pool, DvzThreadCallback callback, void* user_data);
+
+DVZ_EXPORT void* dvz_future_wait(DvzFuture* future);
+
+DVZ_EXPORT void dvz_thread_pool_destroy(DvzThreadPool* pool);
+
+
+
+/*************************************************************************************************/
+/*  Task group functions                                                                         */
+/*************************************************************************************************/
+
+DVZ_EXPORT DvzTaskGroup* dvz_task_group(DvzThreadPool* pool);
+
+DVZ_EXPORT void dvz_task_group_run(DvzTaskGroup* group, DvzThreadCallback callback, void* user_data);
+
+DVZ_EXPORT void dvz_task_group_wait(DvzTaskGroup* group);
+
+DVZ_EXPORT void dvz_task_group_destroy(DvzTaskGroup* group);
+
+
+
 EXTERN_C_OFF
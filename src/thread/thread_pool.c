@@ -0,0 +1,728 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Thread pool                                                                                  */
+/*************************************************************************************************/
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "_alloc.h"
+#include "_assertions.h"
+#include "_env.h"
+#include "_log.h"
+#include "datoviz/math/parallel.h"
+#include "mutex_internal.h"
+#include "obj.h"
+#include "thread_internal.h"
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_THREAD_POOL_MAX_WORKERS     256u
+#define DVZ_THREAD_POOL_DEQUE_CAPACITY  64u
+#define DVZ_THREAD_POOL_CHUNKS_PER_WORKER 4u
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+typedef struct DvzPoolTask DvzPoolTask;
+typedef struct DvzPoolDeque DvzPoolDeque;
+typedef struct DvzPoolWorker DvzPoolWorker;
+typedef struct DvzParallelForChunk DvzParallelForChunk;
+
+
+
+struct DvzPoolTask
+{
+    DvzThreadCallback callback;
+    void* user_data;
+    DvzTaskGroup* group;
+    void** result;
+};
+
+
+
+// Ring buffer of tasks: the owner worker pops from the back, thieves pop from the front.
+struct DvzPoolDeque
+{
+    DvzMutex lock;
+    DvzPoolTask* tasks;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t count;
+};
+
+
+
+struct DvzPoolWorker
+{
+    DvzThreadPool* pool;
+    uint32_t index;
+    DvzThread* thread;
+};
+
+
+
+struct DvzThreadPool
+{
+    DvzObject obj;
+    uint32_t worker_count;
+    DvzPoolWorker* workers;
+    DvzPoolDeque* deques;
+
+    DvzMutex lock;
+    DvzCond wake;
+    int64_t pending; // may transiently dip below zero when a task is stolen before it is counted
+    uint32_t next_deque;
+    bool stop;
+};
+
+
+
+struct DvzTaskGroup
+{
+    DvzThreadPool* pool;
+    DvzMutex lock;
+    DvzCond done;
+    uint32_t outstanding;
+};
+
+
+
+struct DvzFuture
+{
+    DvzTaskGroup group;
+    void* result;
+};
+
+
+
+struct DvzParallelForChunk
+{
+    DvzParallelForCallback callback;
+    void* user_data;
+    uint32_t begin;
+    uint32_t end;
+};
+
+
+
+/*************************************************************************************************/
+/*  Deque helpers                                                                                */
+/*************************************************************************************************/
+
+static bool _deque_init(DvzPoolDeque* deque)
+{
+    ANN(deque);
+    dvz_mutex_init(&deque->lock);
+    deque->tasks = (DvzPoolTask*)dvz_calloc(DVZ_THREAD_POOL_DEQUE_CAPACITY, sizeof(DvzPoolTask));
+    deque->capacity = deque->tasks != NULL ? DVZ_THREAD_POOL_DEQUE_CAPACITY : 0;
+    deque->head = 0;
+    deque->count = 0;
+    return deque->tasks != NULL;
+}
+
+
+
+static void _deque_destroy(DvzPoolDeque* deque)
+{
+    ANN(deque);
+    dvz_free(deque->tasks);
+    deque->tasks = NULL;
+    deque->capacity = 0;
+    deque->count = 0;
+    dvz_mutex_destroy(&deque->lock);
+}
+
+
+
+static bool _deque_push(DvzPoolDeque* deque, const DvzPoolTask* task)
+{
+    ANN(deque);
+    ANN(task);
+
+    dvz_mutex_lock(&deque->lock);
+    if (deque->count == deque->capacity)
+    {
+        uint32_t capacity = deque->capacity > 0 ? 2 * deque->capacity : DVZ_THREAD_POOL_DEQUE_CAPACITY;
+        DvzPoolTask* tasks = (DvzPoolTask*)dvz_calloc(capacity, sizeof(DvzPoolTask));
+        if (tasks == NULL)
+        {
+            dvz_mutex_unlock(&deque->lock);
+            return false;
+        }
+        for (uint32_t i = 0; i < deque->count; i++)
+            tasks[i] = deque->tasks[(deque->head + i) % deque->capacity];
+        dvz_free(deque->tasks);
+        deque->tasks = tasks;
+        deque->capacity = capacity;
+        deque->head = 0;
+    }
+    deque->tasks[(deque->head + deque->count) % deque->capacity] = *task;
+    deque->count++;
+    dvz_mutex_unlock(&deque->lock);
+    return true;
+}
+
+
+
+static bool _deque_pop(DvzPoolDeque* deque, bool back, DvzPoolTask* task)
+{
+    ANN(deque);
+    ANN(task);
+
+    dvz_mutex_lock(&deque->lock);
+    if (deque->count == 0)
+    {
+        dvz_mutex_unlock(&deque->lock);
+        return false;
+    }
+    if (back)
+    {
+        *task = deque->tasks[(deque->head + deque->count - 1) % deque->capacity];
+    }
+    else
+    {
+        *task = deque->tasks[deque->head];
+        deque->head = (deque->head + 1) % deque->capacity;
+    }
+    deque->count--;
+    dvz_mutex_unlock(&deque->lock);
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Pool helpers                                                                                 */
+/*************************************************************************************************/
+
+static uint32_t _cpu_count(void)
+{
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (info.dwNumberOfProcessors > 0) ? (uint32_t)info.dwNumberOfProcessors : 1u;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (count > 0) ? (uint32_t)count : 1u;
+#else
+    return 1u;
+#endif
+}
+
+
+
+/**
+ * Take one task, first from the back of the worker's own deque, then by stealing from the front
+ * of the other deques.
+ *
+ * @param pool the thread pool
+ * @param start index of the deque to try first
+ * @param[out] task the task taken
+ * @return whether a task was taken
+ */
+static bool _pool_take(DvzThreadPool* pool, uint32_t start, DvzPoolTask* task)
+{
+    ANN(pool);
+    ANN(task);
+
+    uint32_t n = pool->worker_count;
+    for (uint32_t k = 0; k < n; k++)
+    {
+        DvzPoolDeque* deque = &pool->deques[(start + k) % n];
+        if (_deque_pop(deque, k == 0, task))
+        {
+            dvz_mutex_lock(&pool->lock);
+            pool->pending--;
+            dvz_mutex_unlock(&pool->lock);
+            return true;
+        }
+    }
+    return false;
+}
+
+
+
+static void _pool_run(DvzPoolTask* task)
+{
+    ANN(task);
+    ANN(task->callback);
+
+    void* result = task->callback(task->user_data);
+    if (task->result != NULL)
+        *task->result = result;
+
+    DvzTaskGroup* group = task->group;
+    if (group != NULL)
+    {
+        dvz_mutex_lock(&group->lock);
+        ASSERT(group->outstanding > 0);
+        group->outstanding--;
+        if (group->outstanding == 0)
+            dvz_cond_broadcast(&group->done);
+        dvz_mutex_unlock(&group->lock);
+    }
+}
+
+
+
+static void _pool_push(DvzThreadPool* pool, const DvzPoolTask* task)
+{
+    ANN(pool);
+    ANN(task);
+
+    dvz_mutex_lock(&pool->lock);
+    uint32_t index = pool->next_deque++ % pool->worker_count;
+    dvz_mutex_unlock(&pool->lock);
+
+    if (!_deque_push(&pool->deques[index], task))
+    {
+        log_warn("thread pool deque allocation failed, running the task inline");
+        DvzPoolTask inline_task = *task;
+        _pool_run(&inline_task);
+        return;
+    }
+
+    dvz_mutex_lock(&pool->lock);
+    pool->pending++;
+    dvz_cond_signal(&pool->wake);
+    dvz_mutex_unlock(&pool->lock);
+}
+
+
+
+static void* _pool_worker(void* user_data)
+{
+    DvzPoolWorker* worker = (DvzPoolWorker*)user_data;
+    ANN(worker);
+    DvzThreadPool* pool = worker->pool;
+    ANN(pool);
+
+    DvzPoolTask task = {0};
+    for (;;)
+    {
+        if (_pool_take(pool, worker->index, &task))
+        {
+            _pool_run(&task);
+            continue;
+        }
+
+        dvz_mutex_lock(&pool->lock);
+        while (pool->pending <= 0 && !pool->stop)
+            dvz_cond_wait(&pool->wake, &pool->lock);
+        bool done = pool->stop && pool->pending <= 0;
+        dvz_mutex_unlock(&pool->lock);
+        if (done)
+            break;
+    }
+    return NULL;
+}
+
+
+
+static void _task_group_init(DvzTaskGroup* group, DvzThreadPool* pool)
+{
+    ANN(group);
+    ANN(pool);
+    group->pool = pool;
+    group->outstanding = 0;
+    dvz_mutex_init(&group->lock);
+    dvz_cond_init(&group->done);
+}
+
+
+
+static void _task_group_release(DvzTaskGroup* group)
+{
+    ANN(group);
+    dvz_task_group_wait(group);
+    dvz_cond_destroy(&group->done);
+    dvz_mutex_destroy(&group->lock);
+}
+
+
+
+static void
+_task_group_push(DvzTaskGroup* group, DvzThreadCallback callback, void* user_data, void** result)
+{
+    ANN(group);
+    ANN(callback);
+
+    dvz_mutex_lock(&group->lock);
+    group->outstanding++;
+    dvz_mutex_unlock(&group->lock);
+
+    DvzPoolTask task = {
+        .callback = callback,
+        .user_data = user_data,
+        .group = group,
+        .result = result,
+    };
+    _pool_push(group->pool, &task);
+}
+
+
+
+static void* _parallel_for_chunk(void* user_data)
+{
+    DvzParallelForChunk* chunk = (DvzParallelForChunk*)user_data;
+    ANN(chunk);
+    chunk->callback(chunk->begin, chunk->end, chunk->user_data);
+    return NULL;
+}
+
+
+
+/*************************************************************************************************/
+/*  Thread pool functions                                                                        */
+/*************************************************************************************************/
+
+/**
+ * Return the default number of thread pool workers.
+ *
+ * This is dvz_threads_default_count() for the online processors, capped at
+ * DVZ_THREAD_POOL_MAX_WORKERS.
+ *
+ * @return the default worker count, at least one
+ */
+uint32_t dvz_thread_pool_default_size(void)
+{
+    int count = dvz_threads_default_count((int)_cpu_count());
+    return DVZ_MIN((uint32_t)count, (uint32_t)DVZ_THREAD_POOL_MAX_WORKERS);
+}
+
+
+
+/**
+ * Create a persistent work-stealing thread pool.
+ *
+ * Each worker owns a task deque. Workers pop their own most recent task first and steal the
+ * oldest task of another deque when idle. Threads waiting on a task group or a future help run
+ * queued tasks, so tasks may submit and wait on nested work without deadlocking the pool.
+ *
+ * @param worker_count number of worker threads, or 0 for dvz_thread_pool_default_size()
+ * @return the thread pool, or NULL on failure
+ */
+DvzThreadPool* dvz_thread_pool(uint32_t worker_count)
+{
+    if (worker_count == 0)
+        worker_count = dvz_thread_pool_default_size();
+    worker_count = DVZ_MIN(worker_count, DVZ_THREAD_POOL_MAX_WORKERS);
+
+    DvzThreadPool* pool = (DvzThreadPool*)dvz_calloc(1, sizeof(DvzThreadPool));
+    ANN(pool);
+    pool->worker_count = worker_count;
+    pool->workers = (DvzPoolWorker*)dvz_calloc(worker_count, sizeof(DvzPoolWorker));
+    pool->deques = (DvzPoolDeque*)dvz_calloc(worker_count, sizeof(DvzPoolDeque));
+    ANN(pool->workers);
+    ANN(pool->deques);
+    dvz_mutex_init(&pool->lock);
+    dvz_cond_init(&pool->wake);
+
+    for (uint32_t i = 0; i < worker_count; i++)
+    {
+        if (!_deque_init(&pool->deques[i]))
+        {
+            log_error("thread pool deque allocation failed");
+            for (uint32_t j = 0; j <= i; j++)
+                _deque_destroy(&pool->deques[j]);
+            dvz_cond_destroy(&pool->wake);
+            dvz_mutex_destroy(&pool->lock);
+            dvz_free(pool->deques);
+            dvz_free(pool->workers);
+            dvz_free(pool);
+            return NULL;
+        }
+    }
+
+    // NOTE: the deques are complete before any worker starts so that stealing never observes a
+    // partially initialized pool.
+    for (uint32_t i = 0; i < worker_count; i++)
+    {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        pool->workers[i].thread = dvz_thread(_pool_worker, &pool->workers[i]);
+        if (pool->workers[i].thread == NULL)
+        {
+            // NOTE: the running workers read worker_count and steal from every deque without
+            // holding the pool lock, so the pool cannot be shrunk in place. Stop and join the
+            // workers started so far and tear the whole pool down instead.
+            log_error("thread pool worker %u creation failed", i);
+            dvz_thread_pool_destroy(pool);
+            return NULL;
+        }
+    }
+
+    log_trace("created thread pool with %u workers", worker_count);
+    dvz_obj_created(&pool->obj);
+    return pool;
+}
+
+
+
+/**
+ * Return the number of worker threads of a pool.
+ *
+ * @param pool the thread pool
+ * @return the worker count
+ */
+uint32_t dvz_thread_pool_size(DvzThreadPool* pool)
+{
+    ANN(pool);
+    return pool->worker_count;
+}
+
+
+
+/**
+ * Run a callback over `[0, count)` split into chunks of at least `grain` indices.
+ *
+ * The calling thread runs the first chunk itself and then helps with the queued ones, returning
+ * once every chunk has completed.
+ *
+ * @param pool the thread pool, or NULL to run the whole range on the calling thread
+ * @param count number of indices
+ * @param grain minimum chunk size, or 0 to give each worker a few chunks
+ * @param callback chunk callback
+ * @param user_data opaque pointer passed to the callback
+ */
+void dvz_thread_pool_parallel_for(
+    DvzThreadPool* pool, uint32_t count, uint32_t grain, DvzParallelForCallback callback,
+    void* user_data)
+{
+    ANN(callback);
+    if (count == 0)
+        return;
+
+    uint32_t chunk_count = 1;
+    if (pool != NULL)
+    {
+        uint32_t max_chunks = (pool->worker_count + 1) * DVZ_THREAD_POOL_CHUNKS_PER_WORKER;
+        if (grain == 0)
+            grain = (count + max_chunks - 1) / max_chunks;
+        grain = DVZ_MAX(grain, 1u);
+        chunk_count = (count + grain - 1) / grain;
+    }
+    if (chunk_count <= 1)
+    {
+        callback(0, count, user_data);
+        return;
+    }
+
+    DvzParallelForChunk* chunks =
+        (DvzParallelForChunk*)dvz_calloc(chunk_count, sizeof(DvzParallelForChunk));
+    if (chunks == NULL)
+    {
+        callback(0, count, user_data);
+        return;
+    }
+
+    DvzTaskGroup group = {0};
+    _task_group_init(&group, pool);
+    for (uint32_t i = 0; i < chunk_count; i++)
+    {
+        chunks[i].callback = callback;
+        chunks[i].user_data = user_data;
+        chunks[i].begin = i * grain;
+        chunks[i].end = DVZ_MIN(count, (i + 1) * grain);
+        if (i > 0)
+            _task_group_push(&group, _parallel_for_chunk, &chunks[i], NULL);
+    }
+    _parallel_for_chunk(&chunks[0]);
+    _task_group_release(&group);
+    dvz_free(chunks);
+}
+
+
+
+/**
+ * Submit one task and return a future holding its result.
+ *
+ * @param pool the thread pool
+ * @param callback task callback; its return value becomes the future result
+ * @param user_data opaque pointer passed to the callback
+ * @return the future, to be released with dvz_future_wait()
+ */
+DvzFuture* dvz_thread_pool_submit(DvzThreadPool* pool, DvzThreadCallback callback, void* user_data)
+{
+    ANN(pool);
+    ANN(callback);
+
+    DvzFuture* future = (DvzFuture*)dvz_calloc(1, sizeof(DvzFuture));
+    ANN(future);
+    _task_group_init(&future->group, pool);
+    _task_group_push(&future->group, callback, user_data, &future->result);
+    return future;
+}
+
+
+
+/**
+ * Wait for a future, free it, and return the task result.
+ *
+ * @param future the future
+ * @return the value returned by the task callback
+ */
+void* dvz_future_wait(DvzFuture* future)
+{
+    ANN(future);
+    _task_group_release(&future->group);
+    void* result = future->result;
+    dvz_free(future);
+    return result;
+}
+
+
+
+/**
+ * Stop and join the workers of a pool after the queued tasks have run.
+ *
+ * @param pool the thread pool
+ */
+void dvz_thread_pool_destroy(DvzThreadPool* pool)
+{
+    if (pool == NULL)
+        return;
+
+    dvz_mutex_lock(&pool->lock);
+    pool->stop = true;
+    dvz_cond_broadcast(&pool->wake);
+    dvz_mutex_unlock(&pool->lock);
+
+    for (uint32_t i = 0; i < pool->worker_count; i++)
+    {
+        if (pool->workers[i].thread != NULL)
+            dvz_thread_join(pool->workers[i].thread);
+        pool->workers[i].thread = NULL;
+    }
+
+    // Workers only exit once nothing is pending; drain anything a failed start left behind.
+    DvzPoolTask task = {0};
+    while (pool->worker_count > 0 && _pool_take(pool, 0, &task))
+        _pool_run(&task);
+
+    for (uint32_t i = 0; i < pool->worker_count; i++)
+        _deque_destroy(&pool->deques[i]);
+    dvz_cond_destroy(&pool->wake);
+    dvz_mutex_destroy(&pool->lock);
+    dvz_free(pool->deques);
+    dvz_free(pool->workers);
+    dvz_obj_destroyed(&pool->obj);
+    dvz_free(pool);
+}
+
+
+
+/*************************************************************************************************/
+/*  Task group functions                                                                         */
+/*************************************************************************************************/
+
+/**
+ * Create a task group on a thread pool.
+ *
+ * @param pool the thread pool
+ * @return the task group
+ */
+DvzTaskGroup* dvz_task_group(DvzThreadPool* pool)
+{
+    ANN(pool);
+    DvzTaskGroup* group = (DvzTaskGroup*)dvz_calloc(1, sizeof(DvzTaskGroup));
+    ANN(group);
+    _task_group_init(group, pool);
+    return group;
+}
+
+
+
+/**
+ * Queue a task in a task group.
+ *
+ * @param group the task group
+ * @param callback task callback; its return value is ignored
+ * @param user_data opaque pointer passed to the callback
+ */
+void dvz_task_group_run(DvzTaskGroup* group, DvzThreadCallback callback, void* user_data)
+{
+    _task_group_push(group, callback, user_data, NULL);
+}
+
+
+
+/**
+ * Wait until every task queued in a group has completed, running queued tasks meanwhile.
+ *
+ * @param group the task group
+ */
+void dvz_task_group_wait(DvzTaskGroup* group)
+{
+    ANN(group);
+    DvzThreadPool* pool = group->pool;
+    ANN(pool);
+
+    DvzPoolTask task = {0};
+    for (;;)
+    {
+        dvz_mutex_lock(&group->lock);
+        bool done = group->outstanding == 0;
+        dvz_mutex_unlock(&group->lock);
+        if (done)
+            return;
+
+        if (_pool_take(pool, 0, &task))
+        {
+            _pool_run(&task);
+            continue;
+        }
+
+        // Every remaining task of the group is running on another thread.
+        dvz_mutex_lock(&group->lock);
+        while (group->outstanding > 0)
+            dvz_cond_wait(&group->done, &group->lock);
+        dvz_mutex_unlock(&group->lock);
+        return;
+    }
+}
+
+
+
+/**
+ * Wait for and destroy a task group.
+ *
+ * @param group the task group
+ */
+void dvz_task_group_destroy(DvzTaskGroup* group)
+{
+    if (group == NULL)
+        return;
+    _task_group_release(group);
+    dvz_free(group);
+}
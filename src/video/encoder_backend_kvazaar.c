@@ -32,6 +32,7 @@
 #include "file_utils.h"
 #include "kvazaar.h"
 #include "thread_internal.h"
+#include "yuv_convert.h"
 
 
 
@@ -59,24 +60,12 @@ typedef struct
     uint32_t height;
     VkFormat format;
     uint32_t convert_threads;
+    DvzThreadPool* convert_pool;
+    DvzYuvConverter yuv;
 } DvzVideoBackendKvazaar;
 
 
 
-// RGBA YUV conversion job.
-typedef struct
-{
-    DvzVideoBackendKvazaar* state;
-    kvz_picture* picture;
-    const uint8_t* base;
-    size_t src_stride;
-    uint32_t row_start;
-    uint32_t row_end;
-    int result;
-} DvzKvazaarConvertJob;
-
-
-
 /*************************************************************************************************/
 /*  Helpers                                                                                      */
 /*************************************************************************************************/
@@ -104,10 +93,6 @@ static uint32_t kvazaar_min_u32(uint32_t a, uint32_t b) { return (a < b) ? a : b
 
 
 
-static uint32_t kvazaar_max_u32(uint32_t a, uint32_t b) { return (a > b) ? a : b; }
-
-
-
 static uint32_t kvazaar_cpu_core_count(void)
 {
 #if defined(_WIN32)
@@ -134,21 +119,6 @@ static uint32_t kvazaar_cpu_core_count(void)
 
 
 
-static inline uint8_t kvazaar_clamp(int value)
-{
-    if (value < 0)
-    {
-        return 0;
-    }
-    if (value > 255)
-    {
-        return 255;
-    }
-    return (uint8_t)value;
-}
-
-
-
 static bool kvazaar_is_keyframe(const kvz_frame_info* info, bool force_idr)
 {
     if (!info)
@@ -403,9 +373,8 @@ static kvz_picture* kvazaar_alloc_picture(DvzVideoBackendKvazaar* state)
 
 
 
-static bool kvazaar_convert_rgba_to_yuv_rows(
-    DvzVideoBackendKvazaar* state, kvz_picture* picture, const uint8_t* base, size_t src_stride,
-    uint32_t row_start, uint32_t row_end)
+static bool kvazaar_convert_rgba_to_yuv(
+    DvzVideoBackendKvazaar* state, kvz_picture* picture, const uint8_t* base, size_t src_stride)
 {
     ANN(state);
     ANN(picture);
@@ -424,174 +393,20 @@ static bool kvazaar_convert_rgba_to_yuv_rows(
         log_error("kvazaar picture stride (%d) smaller than width (%u)", picture->stride, width);
         return false;
     }
-    if (row_end > height)
-    {
-        row_end = height;
-    }
-    if (row_start >= row_end)
-    {
-        return true;
-    }
-    if ((row_start & 1u) != 0)
-    {
-        row_start -= 1;
-    }
-    if ((row_end & 1u) != 0)
-    {
-        row_end -= 1;
-    }
-    if (row_end <= row_start)
-    {
-        return true;
-    }
-    kvz_pixel* y_plane = picture->y;
-    kvz_pixel* u_plane = picture->u;
-    kvz_pixel* v_plane = picture->v;
-    const int y_stride = picture->stride;
-    const int uv_stride = picture->stride / 2;
-
-    for (uint32_t row = row_start; row < row_end; row += 2)
-    {
-        const uint8_t* row0 = base + (size_t)row * src_stride;
-        const uint8_t* row1 = base + (size_t)(row + 1) * src_stride;
-        kvz_pixel* y0 = y_plane + (ptrdiff_t)row * y_stride;
-        kvz_pixel* y1 = y_plane + (ptrdiff_t)(row + 1) * y_stride;
-        kvz_pixel* u_row = u_plane + (ptrdiff_t)(row / 2) * uv_stride;
-        kvz_pixel* v_row = v_plane + (ptrdiff_t)(row / 2) * uv_stride;
 
-        for (uint32_t col = 0; col < width; col += 2)
-        {
-            const uint8_t* p0 = row0 + col * 4;
-            const uint8_t* p1 = row0 + (col + 1) * 4;
-            const uint8_t* p2 = row1 + col * 4;
-            const uint8_t* p3 = row1 + (col + 1) * 4;
-
-            const uint8_t r[4] = {p0[0], p1[0], p2[0], p3[0]};
-            const uint8_t g[4] = {p0[1], p1[1], p2[1], p3[1]};
-            const uint8_t b[4] = {p0[2], p1[2], p2[2], p3[2]};
-
-            const uint8_t* px = p0;
-            int y_val = ((66 * px[0] + 129 * px[1] + 25 * px[2] + 128) >> 8) + 16;
-            y0[col] = kvazaar_clamp(y_val);
-            px = p1;
-            y_val = ((66 * px[0] + 129 * px[1] + 25 * px[2] + 128) >> 8) + 16;
-            y0[col + 1] = kvazaar_clamp(y_val);
-
-            px = p2;
-            y_val = ((66 * px[0] + 129 * px[1] + 25 * px[2] + 128) >> 8) + 16;
-            y1[col] = kvazaar_clamp(y_val);
-            px = p3;
-            y_val = ((66 * px[0] + 129 * px[1] + 25 * px[2] + 128) >> 8) + 16;
-            y1[col + 1] = kvazaar_clamp(y_val);
-
-            uint8_t u_values[4];
-            uint8_t v_values[4];
-            for (uint32_t i = 0; i < 4; ++i)
-            {
-                int r_val = r[i];
-                int g_val = g[i];
-                int b_val = b[i];
-                int u_val = ((-38 * r_val - 74 * g_val + 112 * b_val + 128) >> 8) + 128;
-                int v_val = ((112 * r_val - 94 * g_val - 18 * b_val + 128) >> 8) + 128;
-                u_values[i] = kvazaar_clamp(u_val);
-                v_values[i] = kvazaar_clamp(v_val);
-            }
-            const uint32_t chroma_col = col / 2;
-            u_row[chroma_col] =
-                kvazaar_clamp((u_values[0] + u_values[1] + u_values[2] + u_values[3]) / 4);
-            v_row[chroma_col] =
-                kvazaar_clamp((v_values[0] + v_values[1] + v_values[2] + v_values[3]) / 4);
-        }
-    }
+    DvzYuvPlanes planes = {
+        .y = picture->y,
+        .u = picture->u,
+        .v = picture->v,
+        .y_stride = (size_t)picture->stride,
+        .uv_stride = (size_t)(picture->stride / 2),
+    };
+    dvz_rgba_to_i420(&state->yuv, state->convert_pool, base, src_stride, width, height, &planes);
     return true;
 }
 
 
 
-static void* kvazaar_convert_thread(void* user_data)
-{
-    DvzKvazaarConvertJob* job = (DvzKvazaarConvertJob*)user_data;
-    ANN(job);
-    job->result =
-        kvazaar_convert_rgba_to_yuv_rows(
-            job->state, job->picture, job->base, job->src_stride, job->row_start, job->row_end)
-            ? 0
-            : -1;
-    return NULL;
-}
-
-
-
-static bool kvazaar_convert_rgba_to_yuv(
-    DvzVideoBackendKvazaar* state, kvz_picture* picture, const uint8_t* base, size_t src_stride)
-{
-    ANN(state);
-    ANN(picture);
-    if (!base)
-    {
-        return false;
-    }
-    const uint32_t height = state->height;
-    if (state->convert_threads <= 1 || height <= 2)
-    {
-        return kvazaar_convert_rgba_to_yuv_rows(state, picture, base, src_stride, 0, height);
-    }
-
-    uint32_t row_pairs = height >> 1;
-    uint32_t thread_count = kvazaar_min_u32(state->convert_threads, row_pairs);
-    if (thread_count == 0)
-    {
-        return kvazaar_convert_rgba_to_yuv_rows(state, picture, base, src_stride, 0, height);
-    }
-    uint32_t rows_per_thread = ((row_pairs + thread_count - 1) / thread_count);
-    rows_per_thread = kvazaar_max_u32(rows_per_thread, 1u) << 1u;
-
-    DvzKvazaarConvertJob* jobs =
-        (DvzKvazaarConvertJob*)dvz_calloc(thread_count, sizeof(DvzKvazaarConvertJob));
-    DvzThread** threads = (DvzThread**)dvz_calloc(thread_count, sizeof(DvzThread*));
-    ANN(jobs);
-    ANN(threads);
-
-    uint32_t launched = 0;
-    for (uint32_t row = 0; row < height && launched < thread_count; row += rows_per_thread)
-    {
-        uint32_t row_end = row + rows_per_thread;
-        if (row_end > height)
-        {
-            row_end = height;
-        }
-        DvzKvazaarConvertJob* job = &jobs[launched];
-        job->state = state;
-        job->picture = picture;
-        job->base = base;
-        job->src_stride = src_stride;
-        job->row_start = row;
-        job->row_end = row_end;
-        job->result = -1;
-        threads[launched] = dvz_thread(kvazaar_convert_thread, job);
-        launched++;
-    }
-
-    bool ok = true;
-    for (uint32_t i = 0; i < launched; ++i)
-    {
-        if (threads[i])
-        {
-            dvz_thread_join(threads[i]);
-        }
-        if (jobs[i].result != 0)
-        {
-            ok = false;
-        }
-    }
-
-    dvz_free(threads);
-    dvz_free(jobs);
-    return ok;
-}
-
-
-
 static int kvazaar_emit_sample(
     DvzVideoEncoder* enc, kvz_data_chunk* chunks, uint32_t total_size, uint32_t duration,
     bool keyframe)
@@ -782,6 +597,13 @@ static int kvazaar_start(DvzVideoEncoder* enc)
         conversion_threads = 1;
     }
     state->convert_threads = conversion_threads;
+    state->yuv =
+        dvz_yuv_converter(DVZ_YUV_MATRIX_BT601, DVZ_YUV_RANGE_LIMITED, DVZ_YUV_KERNEL_AUTO);
+    if (conversion_threads > 1 && state->convert_pool == NULL)
+    {
+        // The calling thread takes part in the conversion, hence one worker fewer.
+        state->convert_pool = dvz_thread_pool(conversion_threads - 1);
+    }
     if (state->format != VK_FORMAT_R8G8B8A8_UNORM && state->format != VK_FORMAT_R8G8B8A8_SRGB)
     {
         log_error(
@@ -821,8 +643,8 @@ static int kvazaar_start(DvzVideoEncoder* enc)
         cfg->threads = (int32_t)(cpu_threads > 0 ? cpu_threads : 1);
     }
     log_debug(
-        "kvazaar backend using %d encoder threads and %u conversion workers", cfg->threads,
-        state->convert_threads);
+        "kvazaar backend using %d encoder threads and %u %s conversion workers", cfg->threads,
+        state->convert_threads, dvz_yuv_kernel_name(state->yuv.kernel));
     cfg->aud_enable = 0;
     cfg->add_encoder_info = 0;
     cfg->enable_logging_output = 0;
@@ -967,6 +789,8 @@ static void kvazaar_destroy(DvzVideoEncoder* enc)
         state->wait_semaphore_ready = false;
     }
     kvazaar_unmap_image(enc, state);
+    dvz_thread_pool_destroy(state->convert_pool);
+    state->convert_pool = NULL;
     dvz_free(state);
     enc->backend_data = NULL;
 }
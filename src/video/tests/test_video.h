@@ -45,6 +45,11 @@ int test_video_nvenc(TstContext* suite, const TstCase* tstitem);
 int test_video_kvazaar(TstContext* suite, const TstCase* tstitem);
 int test_video_offline_headless_encode(TstContext* suite, const TstCase* tstitem);
 int test_video_output_errors_propagate(TstContext* suite, const TstCase* tstitem);
+int test_video_yuv_convert(TstContext* suite, const TstCase* tstitem);
+int test_video_yuv_bench(TstContext* suite, const TstCase* tstitem);
+int test_video_sink_sync(TstContext* suite, const TstCase* tstitem);
+int test_video_sink_queue_policies(TstContext* suite, const TstCase* tstitem);
+int test_video_sink_flush_order(TstContext* suite, const TstCase* tstitem);
 
 
 
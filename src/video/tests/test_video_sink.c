@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Video sink encoder queue tests                                                               */
+/*************************************************************************************************/
+
+#include <pthread.h>
+
+#include "_assertions.h"
+#include "_time_utils.h"
+#include "../encoder.h"
+#include "../encoder_backend.h"
+#include "../video_sink_internal.h"
+#include "mutex_internal.h"
+#include "test_video.h"
+#include "testing.h"
+#include "thread_internal.h"
+
+
+
+/*************************************************************************************************/
+/*  Fake encoder backend                                                                         */
+/*************************************************************************************************/
+
+#define SINK_TEST_MAX_FRAMES 16
+
+// Frames seen by the fake encoder backend; the gate holds the encoder thread inside a submission.
+typedef struct
+{
+    DvzMutex lock;
+    DvzCond cond;
+    bool gate_closed;
+    uint32_t entered;
+    uint8_t encoded[SINK_TEST_MAX_FRAMES];
+    uint32_t encoded_count;
+    bool encoded_off_caller;
+    pthread_t caller;
+    uint32_t released;
+    bool submitted;
+    uint8_t next_id;
+    uint8_t flush_next;
+    uint8_t flush_end;
+} SinkTestRecorder;
+
+static SinkTestRecorder _recorder;
+
+
+
+static int _fake_start(DvzVideoEncoder* enc)
+{
+    (void)enc;
+    return 0;
+}
+
+
+
+static int _fake_submit_rgba(
+    DvzVideoEncoder* enc, const uint8_t* rgba, uint32_t width, uint32_t height, size_t stride,
+    uint64_t timeline_value)
+{
+    (void)enc;
+    (void)width;
+    (void)height;
+    (void)stride;
+    (void)timeline_value;
+    dvz_mutex_lock(&_recorder.lock);
+    _recorder.entered++;
+    dvz_cond_broadcast(&_recorder.cond);
+    while (_recorder.gate_closed)
+        dvz_cond_wait(&_recorder.cond, &_recorder.lock);
+    if (_recorder.encoded_count < SINK_TEST_MAX_FRAMES)
+        _recorder.encoded[_recorder.encoded_count++] = rgba[0];
+    if (!pthread_equal(pthread_self(), _recorder.caller))
+        _recorder.encoded_off_caller = true;
+    dvz_mutex_unlock(&_recorder.lock);
+    return 0;
+}
+
+
+
+static int _fake_stop(DvzVideoEncoder* enc)
+{
+    (void)enc;
+    return 0;
+}
+
+
+
+static const DvzVideoBackend SINK_TEST_BACKEND = {
+    .name = "sink-test",
+    .start = _fake_start,
+    .submit_rgba = _fake_submit_rgba,
+    .stop = _fake_stop,
+};
+
+
+
+static uint8_t* _frame(uint8_t id, uint32_t* out_width, uint32_t* out_height, size_t* out_stride)
+{
+    uint8_t* rgba = (uint8_t*)dvz_calloc(4, sizeof(uint8_t));
+    ANN(rgba);
+    rgba[0] = id;
+    *out_width = 1;
+    *out_height = 1;
+    *out_stride = 4;
+    return rgba;
+}
+
+
+
+static int _capture(
+    void* user_data, uint32_t* out_width, uint32_t* out_height, size_t* out_stride,
+    uint8_t** out_rgba)
+{
+    SinkTestRecorder* recorder = (SinkTestRecorder*)user_data;
+    *out_rgba = _frame(recorder->next_id++, out_width, out_height, out_stride);
+    return 0;
+}
+
+
+
+static int _flush(
+    void* user_data, uint32_t* out_width, uint32_t* out_height, size_t* out_stride,
+    uint8_t** out_rgba)
+{
+    SinkTestRecorder* recorder = (SinkTestRecorder*)user_data;
+    if (recorder->flush_next == recorder->flush_end)
+        return 1;
+    *out_rgba = _frame(recorder->flush_next++, out_width, out_height, out_stride);
+    return 0;
+}
+
+
+
+static void _release(void* user_data, uint8_t* rgba)
+{
+    SinkTestRecorder* recorder = (SinkTestRecorder*)user_data;
+    dvz_mutex_lock(&recorder->lock);
+    recorder->released++;
+    dvz_mutex_unlock(&recorder->lock);
+    dvz_free(rgba);
+}
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+static void _recorder_reset(void)
+{
+    dvz_memset(&_recorder, sizeof(_recorder), 0, sizeof(_recorder));
+    dvz_mutex_init(&_recorder.lock);
+    dvz_cond_init(&_recorder.cond);
+    _recorder.caller = pthread_self();
+}
+
+
+
+static void _recorder_release(void)
+{
+    dvz_cond_destroy(&_recorder.cond);
+    dvz_mutex_destroy(&_recorder.lock);
+}
+
+
+
+static void _gate_open(void)
+{
+    dvz_mutex_lock(&_recorder.lock);
+    _recorder.gate_closed = false;
+    dvz_cond_broadcast(&_recorder.cond);
+    dvz_mutex_unlock(&_recorder.lock);
+}
+
+
+
+// Wait until the encoder thread is inside its first submission.
+static void _wait_entered(void)
+{
+    dvz_mutex_lock(&_recorder.lock);
+    while (_recorder.entered == 0)
+        dvz_cond_wait(&_recorder.cond, &_recorder.lock);
+    dvz_mutex_unlock(&_recorder.lock);
+}
+
+
+
+static int _sink_start(DvzStreamSink* sink, uint32_t queue_depth, DvzVideoQueuePolicy policy)
+{
+    DvzVideoSinkConfig cfg = dvz_video_sink_config();
+    cfg.capture_mode = DVZ_VIDEO_CAPTURE_CPU_READBACK;
+    cfg.capture_rgba = _capture;
+    cfg.release_rgba = _release;
+    cfg.flush_rgba = _flush;
+    cfg.capture_user_data = &_recorder;
+    cfg.queue_depth = queue_depth;
+    cfg.queue_policy = policy;
+
+    DvzVideoEncoder* encoder = (DvzVideoEncoder*)dvz_calloc(1, sizeof(DvzVideoEncoder));
+    ANN(encoder);
+    encoder->backend = &SINK_TEST_BACKEND;
+    encoder->memory_fd = -1;
+    encoder->wait_semaphore_fd = -1;
+    dvz_video_sink_test_init(sink, &cfg, encoder);
+
+    DvzStreamFrame frame = {0};
+    return dvz_stream_sink_video()->start(sink, &frame);
+}
+
+
+
+static void* _submit_thread(void* user_data)
+{
+    DvzStreamSink* sink = (DvzStreamSink*)user_data;
+    int rc = dvz_stream_sink_video()->submit(sink, 0);
+    dvz_mutex_lock(&_recorder.lock);
+    _recorder.submitted = rc == 0;
+    dvz_mutex_unlock(&_recorder.lock);
+    return NULL;
+}
+
+
+
+static bool _encoded_equal(const uint8_t* expected, uint32_t count)
+{
+    if (_recorder.encoded_count != count)
+        return false;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (_recorder.encoded[i] != expected[i])
+            return false;
+    }
+    return true;
+}
+
+
+
+/*************************************************************************************************/
+/*  Tests                                                                                        */
+/*************************************************************************************************/
+
+int test_video_sink_sync(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+    ANN(tstitem);
+    _recorder_reset();
+    const DvzStreamSinkBackend* backend = dvz_stream_sink_video();
+    DvzStreamSink sink = {0};
+
+    // queue_depth 0 is the default and encodes on the calling thread before submit returns.
+    AT(dvz_video_sink_config().queue_depth == 0);
+    AT(_sink_start(&sink, 0, DVZ_VIDEO_QUEUE_BLOCK) == 0);
+    AT(backend->submit(&sink, 0) == 0);
+    AT(_recorder.encoded_count == 1);
+    AT(_recorder.released == 1);
+    AT(backend->submit(&sink, 0) == 0);
+    AT(_recorder.encoded_count == 2);
+    AT(!_recorder.encoded_off_caller);
+
+    // The synchronous path has no frames in flight to flush.
+    AT(backend->stop(&sink) == 0);
+    AT(_recorder.encoded_count == 2);
+    AT(dvz_video_sink_test_dropped(&sink) == 0);
+
+    backend->destroy(&sink);
+    _recorder_release();
+    return 0;
+}
+
+
+
+int test_video_sink_queue_policies(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+    ANN(tstitem);
+    const DvzStreamSinkBackend* backend = dvz_stream_sink_video();
+    const DvzVideoQueuePolicy policies[] = {
+        DVZ_VIDEO_QUEUE_BLOCK,
+        DVZ_VIDEO_QUEUE_DROP_NEWEST,
+        DVZ_VIDEO_QUEUE_DROP_OLDEST,
+    };
+    const uint8_t expected[][4] = {{0, 1, 2, 3}, {0, 1, 2}, {0, 2, 3}};
+    const uint32_t expected_count[] = {4, 3, 3};
+
+    for (uint32_t p = 0; p < 3; p++)
+    {
+        _recorder_reset();
+        _recorder.gate_closed = true;
+        DvzStreamSink sink = {0};
+        AT(_sink_start(&sink, 2, policies[p]) == 0);
+
+        // Frame 0 holds the encoder thread, frames 1 and 2 fill the queue.
+        AT(backend->submit(&sink, 0) == 0);
+        _wait_entered();
+        AT(backend->submit(&sink, 0) == 0);
+        AT(backend->submit(&sink, 0) == 0);
+
+        if (policies[p] == DVZ_VIDEO_QUEUE_BLOCK)
+        {
+            // Frame 3 waits for room in the queue until the encoder moves on.
+            DvzThread* thread = dvz_thread(_submit_thread, &sink);
+            ANN(thread);
+            dvz_sleep(50);
+            dvz_mutex_lock(&_recorder.lock);
+            AT(!_recorder.submitted);
+            AT(_recorder.encoded_count == 0);
+            dvz_mutex_unlock(&_recorder.lock);
+            _gate_open();
+            dvz_thread_join(thread);
+            AT(_recorder.submitted);
+        }
+        else
+        {
+            // Frame 3 is accepted right away and one frame is released unencoded.
+            AT(backend->submit(&sink, 0) == 0);
+            dvz_mutex_lock(&_recorder.lock);
+            AT(_recorder.released == 1);
+            dvz_mutex_unlock(&_recorder.lock);
+            _gate_open();
+        }
+
+        AT(backend->stop(&sink) == 0);
+        AT(_encoded_equal(expected[p], expected_count[p]));
+        AT(_recorder.released == 4);
+        AT(_recorder.encoded_off_caller);
+        AT(dvz_video_sink_test_dropped(&sink) == (policies[p] == DVZ_VIDEO_QUEUE_BLOCK ? 0 : 1));
+
+        backend->destroy(&sink);
+        _recorder_release();
+    }
+    return 0;
+}
+
+
+
+int test_video_sink_flush_order(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+    ANN(tstitem);
+    _recorder_reset();
+    const DvzStreamSinkBackend* backend = dvz_stream_sink_video();
+    DvzStreamSink sink = {0};
+
+    // Frames 10 to 12 are still in flight in the capture pipeline when the sink stops.
+    _recorder.flush_next = 10;
+    _recorder.flush_end = 13;
+    _recorder.gate_closed = true;
+    AT(_sink_start(&sink, 4, DVZ_VIDEO_QUEUE_BLOCK) == 0);
+    AT(backend->submit(&sink, 0) == 0);
+    _wait_entered();
+    AT(backend->submit(&sink, 0) == 0);
+    _gate_open();
+
+    // Stopping drains them after the queued frames, in capture order, before returning.
+    AT(backend->stop(&sink) == 0);
+    const uint8_t expected[] = {0, 1, 10, 11, 12};
+    AT(_encoded_equal(expected, 5));
+    AT(_recorder.released == 5);
+    AT(dvz_video_sink_test_dropped(&sink) == 0);
+
+    backend->destroy(&sink);
+    _recorder_release();
+    return 0;
+}
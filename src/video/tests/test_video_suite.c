@@ -72,6 +72,11 @@ int test_video(TstSuite* suite)
         test_video_offline_headless_encode, TST_RES_VIDEO | TST_RES_FILESYSTEM,
         TST_ISOLATION_PROCESS, 0);
     TST_CASE(test_video_output_errors_propagate);
+    TST_CASE(test_video_yuv_convert);
+    TST_CASE(test_video_yuv_bench);
+    TST_CASE(test_video_sink_sync);
+    TST_CASE(test_video_sink_queue_policies);
+    TST_CASE(test_video_sink_flush_order);
 
     return 0;
 }
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  RGBA to I420 conversion tests                                                                */
+/*************************************************************************************************/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../yuv_convert.h"
+#include "_assertions.h"
+#include "_log.h"
+#include "_time_utils.h"
+#include "test_video.h"
+#include "testing.h"
+
+
+
+/*************************************************************************************************/
+/*  Helpers                                                                                      */
+/*************************************************************************************************/
+
+typedef struct
+{
+    uint32_t width;
+    uint32_t height;
+    size_t rgba_stride;
+    uint8_t* rgba;
+    uint8_t* yuv;
+    DvzYuvPlanes planes;
+} YuvFrame;
+
+
+
+static YuvFrame _yuv_frame(uint32_t width, uint32_t height, uint32_t seed)
+{
+    YuvFrame frame = {.width = width, .height = height};
+    /* Padded source rows exercise the stride handling. */
+    frame.rgba_stride = (size_t)width * 4 + 12;
+    frame.rgba = (uint8_t*)malloc(frame.rgba_stride * height);
+    size_t y_size = (size_t)width * height;
+    frame.yuv = (uint8_t*)calloc(y_size + y_size / 2, 1);
+    ANN(frame.rgba);
+    ANN(frame.yuv);
+
+    uint32_t state = seed;
+    for (size_t i = 0; i < frame.rgba_stride * height; i++)
+    {
+        state = state * 1664525u + 1013904223u;
+        frame.rgba[i] = (uint8_t)(state >> 24);
+    }
+
+    frame.planes.y = frame.yuv;
+    frame.planes.u = frame.yuv + y_size;
+    frame.planes.v = frame.planes.u + y_size / 4;
+    frame.planes.y_stride = width;
+    frame.planes.uv_stride = width / 2;
+    return frame;
+}
+
+
+
+static void _yuv_frame_destroy(YuvFrame* frame)
+{
+    ANN(frame);
+    free(frame->rgba);
+    free(frame->yuv);
+}
+
+
+
+static void _yuv_fill(YuvFrame* frame, uint8_t r, uint8_t g, uint8_t b)
+{
+    ANN(frame);
+    for (uint32_t row = 0; row < frame->height; row++)
+    {
+        uint8_t* px = frame->rgba + row * frame->rgba_stride;
+        for (uint32_t col = 0; col < frame->width; col++, px += 4)
+        {
+            px[0] = r;
+            px[1] = g;
+            px[2] = b;
+            px[3] = 255;
+        }
+    }
+}
+
+
+
+/*************************************************************************************************/
+/*  Tests                                                                                        */
+/*************************************************************************************************/
+
+int test_video_yuv_convert(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+    ANN(tstitem);
+
+    /* The BT.601 limited-range luma matches the historical kvazaar conversion. */
+    DvzYuvConverter conv =
+        dvz_yuv_converter(DVZ_YUV_MATRIX_BT601, DVZ_YUV_RANGE_LIMITED, DVZ_YUV_KERNEL_SCALAR);
+    AT(conv.coefs.y[0] == 66 && conv.coefs.y[1] == 129 && conv.coefs.y[2] == 25);
+    AT(conv.coefs.u[0] == -38 && conv.coefs.u[1] == -74 && conv.coefs.u[2] == 112);
+    AT(conv.coefs.v[0] == 112 && conv.coefs.v[1] == -94 && conv.coefs.v[2] == -18);
+
+    /* Range end points for every matrix and range. */
+    YuvFrame flat = _yuv_frame(8, 2, 0);
+    for (uint32_t m = 0; m < 2; m++)
+    {
+        for (uint32_t r = 0; r < 2; r++)
+        {
+            conv = dvz_yuv_converter((DvzYuvMatrix)m, (DvzYuvRange)r, DVZ_YUV_KERNEL_SCALAR);
+            bool full = r == DVZ_YUV_RANGE_FULL;
+
+            _yuv_fill(&flat, 0, 0, 0);
+            dvz_rgba_to_i420(&conv, NULL, flat.rgba, flat.rgba_stride, 8, 2, &flat.planes);
+            AT(flat.planes.y[0] == (full ? 0 : 16));
+            AT(flat.planes.u[0] == 128 && flat.planes.v[0] == 128);
+
+            _yuv_fill(&flat, 255, 255, 255);
+            dvz_rgba_to_i420(&conv, NULL, flat.rgba, flat.rgba_stride, 8, 2, &flat.planes);
+            AT(flat.planes.y[0] == (full ? 255 : 235));
+            AT(flat.planes.u[0] == 128 && flat.planes.v[0] == 128);
+
+            _yuv_fill(&flat, 0, 0, 255);
+            dvz_rgba_to_i420(&conv, NULL, flat.rgba, flat.rgba_stride, 8, 2, &flat.planes);
+            AT(flat.planes.u[0] == (full ? 255 : 240));
+        }
+    }
+    _yuv_frame_destroy(&flat);
+
+    /* Every SIMD kernel is bit-identical to the scalar reference, including the scalar tail. */
+    const uint32_t width = 262;
+    const uint32_t height = 38;
+    YuvFrame ref = _yuv_frame(width, height, 7);
+    YuvFrame out = _yuv_frame(width, height, 7);
+    size_t yuv_size = (size_t)width * height * 3 / 2;
+    DvzThreadPool* pool = dvz_thread_pool(2);
+    ANN(pool);
+    for (uint32_t m = 0; m < 2; m++)
+    {
+        for (uint32_t r = 0; r < 2; r++)
+        {
+            DvzYuvConverter scalar =
+                dvz_yuv_converter((DvzYuvMatrix)m, (DvzYuvRange)r, DVZ_YUV_KERNEL_SCALAR);
+            dvz_rgba_to_i420(
+                &scalar, NULL, ref.rgba, ref.rgba_stride, width, height, &ref.planes);
+
+            for (uint32_t k = DVZ_YUV_KERNEL_SSE41; k < DVZ_YUV_KERNEL_COUNT; k++)
+            {
+                if (!dvz_yuv_kernel_supported((DvzYuvKernel)k))
+                    continue;
+                conv = dvz_yuv_converter((DvzYuvMatrix)m, (DvzYuvRange)r, (DvzYuvKernel)k);
+                memset(out.yuv, 0, yuv_size);
+                dvz_rgba_to_i420(
+                    &conv, pool, out.rgba, out.rgba_stride, width, height, &out.planes);
+                AT(memcmp(ref.yuv, out.yuv, yuv_size) == 0);
+            }
+        }
+    }
+    dvz_thread_pool_destroy(pool);
+    _yuv_frame_destroy(&ref);
+    _yuv_frame_destroy(&out);
+    return 0;
+}
+
+
+
+int test_video_yuv_bench(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+    ANN(tstitem);
+
+    /* 4K throughput in megapixels per second: scalar, best kernel, and best kernel tiled. */
+    const uint32_t width = 3840;
+    const uint32_t height = 2160;
+    const uint32_t iterations = 5;
+    YuvFrame frame = _yuv_frame(width, height, 1);
+    DvzThreadPool* pool = dvz_thread_pool(0);
+    ANN(pool);
+
+    DvzYuvKernel kernels[3] = {DVZ_YUV_KERNEL_SCALAR, dvz_yuv_kernel_best(), dvz_yuv_kernel_best()};
+    DvzThreadPool* pools[3] = {NULL, NULL, pool};
+    double mps[3] = {0};
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        DvzYuvConverter conv =
+            dvz_yuv_converter(DVZ_YUV_MATRIX_BT601, DVZ_YUV_RANGE_LIMITED, kernels[i]);
+        DvzClock clock = dvz_clock();
+        for (uint32_t it = 0; it < iterations; it++)
+            dvz_rgba_to_i420(
+                &conv, pools[i], frame.rgba, frame.rgba_stride, width, height, &frame.planes);
+        double elapsed = dvz_clock_get(&clock);
+        mps[i] = elapsed > 0 ? (double)width * height * iterations / elapsed * 1e-6 : 0;
+        log_info(
+            "RGBA->I420 %ux%u %s%s: %.0f MP/s (%.2f ms/frame)", width, height,
+            dvz_yuv_kernel_name(kernels[i]), pools[i] ? " tiled" : "", mps[i],
+            elapsed * 1e3 / iterations);
+    }
+    AT(mps[0] > 0);
+
+    dvz_thread_pool_destroy(pool);
+    _yuv_frame_destroy(&frame);
+    return 0;
+}
@@ -12,11 +12,15 @@
 
 #include "datoviz/stream.h"
 
+#include <inttypes.h>
 #include <stdlib.h>
 
 #include "_alloc.h"
 #include "_log.h"
 #include "encoder.h"
+#include "mutex_internal.h"
+#include "thread_internal.h"
+#include "video_sink_internal.h"
 
 
 
@@ -26,6 +30,7 @@
 
 #define DVZ_VIDEO_SINK_CONFIG_KNOWN_FLAGS 0u
 #define DVZ_VIDEO_ENCODER_CONFIG_KNOWN_FLAGS 0u
+#define DVZ_VIDEO_SINK_MAX_QUEUE_DEPTH 64u
 
 
 
@@ -49,11 +54,43 @@ static bool _video_sink_config_validate(const DvzVideoSinkConfig* cfg)
 
 
 
+// CPU readback frame waiting for the encoder thread.
+typedef struct
+{
+    uint8_t* rgba;
+    uint32_t width;
+    uint32_t height;
+    size_t stride;
+    uint64_t wait_value;
+} DvzVideoSinkFrame;
+
+
+
+// Bounded frame queue drained by the encoder thread, which converts, encodes and muxes.
+typedef struct
+{
+    DvzThread* thread;
+    DvzMutex lock;
+    DvzCond cond;
+    DvzVideoSinkFrame* frames;
+    uint32_t capacity;
+    uint32_t head;
+    uint32_t count;
+    bool busy;
+    bool stop;
+    int error;
+    uint64_t dropped;
+} DvzVideoSinkQueue;
+
+
+
 typedef struct
 {
     DvzVideoEncoder* encoder;
     DvzVideoSinkConfig cfg;
     DvzVideoCaptureMode resolved_capture_mode;
+    DvzVideoSinkQueue queue;
+    bool queue_running;
 } DvzVideoSinkState;
 
 
@@ -126,6 +163,264 @@ static DvzVideoCaptureMode video_sink_resolve_capture_mode(const DvzVideoSinkCon
 
 
 
+/**
+ * Return a CPU readback frame to its producer.
+ *
+ * @param state sink state holding the release callback
+ * @param rgba pixels returned by the capture callback
+ */
+static void video_sink_release_rgba(DvzVideoSinkState* state, uint8_t* rgba)
+{
+    ANN(state);
+    if (rgba == NULL)
+    {
+        return;
+    }
+    if (state->cfg.release_rgba)
+    {
+        state->cfg.release_rgba(state->cfg.capture_user_data, rgba);
+    }
+    else
+    {
+        dvz_free(rgba);
+    }
+}
+
+
+
+/**
+ * Encoder thread: pop queued frames and encode them in order.
+ *
+ * @param user_data sink state
+ * @returns NULL
+ */
+static void* video_sink_queue_worker(void* user_data)
+{
+    DvzVideoSinkState* state = (DvzVideoSinkState*)user_data;
+    ANN(state);
+    DvzVideoSinkQueue* queue = &state->queue;
+
+    for (;;)
+    {
+        dvz_mutex_lock(&queue->lock);
+        while (queue->count == 0 && !queue->stop)
+        {
+            dvz_cond_wait(&queue->cond, &queue->lock);
+        }
+        if (queue->count == 0)
+        {
+            dvz_mutex_unlock(&queue->lock);
+            break;
+        }
+        DvzVideoSinkFrame frame = queue->frames[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        queue->busy = true;
+        dvz_mutex_unlock(&queue->lock);
+
+        int rc = dvz_video_encoder_submit_rgba(
+            state->encoder, frame.rgba, frame.width, frame.height, frame.stride,
+            frame.wait_value);
+        video_sink_release_rgba(state, frame.rgba);
+
+        dvz_mutex_lock(&queue->lock);
+        queue->busy = false;
+        if (rc != 0 && queue->error == 0)
+        {
+            queue->error = rc;
+        }
+        dvz_cond_broadcast(&queue->cond);
+        dvz_mutex_unlock(&queue->lock);
+    }
+    return NULL;
+}
+
+
+
+/**
+ * Start the encoder thread when the sink runs pipelined CPU readback.
+ *
+ * @param state sink state
+ * @returns 0 on success or -1 when the thread cannot be created
+ */
+static int video_sink_queue_start(DvzVideoSinkState* state)
+{
+    ANN(state);
+    if (state->queue_running || state->cfg.queue_depth == 0 ||
+        state->resolved_capture_mode != DVZ_VIDEO_CAPTURE_CPU_READBACK)
+    {
+        return 0;
+    }
+    DvzVideoSinkQueue* queue = &state->queue;
+    dvz_memset(queue, sizeof(*queue), 0, sizeof(*queue));
+    queue->capacity = DVZ_MIN(state->cfg.queue_depth, DVZ_VIDEO_SINK_MAX_QUEUE_DEPTH);
+    queue->frames = (DvzVideoSinkFrame*)dvz_calloc(queue->capacity, sizeof(DvzVideoSinkFrame));
+    ANN(queue->frames);
+    dvz_mutex_init(&queue->lock);
+    dvz_cond_init(&queue->cond);
+    queue->thread = dvz_thread(video_sink_queue_worker, state);
+    if (queue->thread == NULL)
+    {
+        log_error("failed to start the video encoder thread");
+        dvz_cond_destroy(&queue->cond);
+        dvz_mutex_destroy(&queue->lock);
+        dvz_free(queue->frames);
+        queue->frames = NULL;
+        return -1;
+    }
+    state->queue_running = true;
+    return 0;
+}
+
+
+
+/**
+ * Queue a frame for the encoder thread, applying the configured policy when the queue is full.
+ *
+ * @param state sink state
+ * @param frame frame to queue; ownership passes to the queue
+ * @param block whether to wait for room regardless of the policy
+ * @returns 0 on success, or the first error reported by the encoder thread
+ */
+static int video_sink_queue_push(DvzVideoSinkState* state, DvzVideoSinkFrame frame, bool block)
+{
+    ANN(state);
+    DvzVideoSinkQueue* queue = &state->queue;
+    uint8_t* dropped = NULL;
+
+    dvz_mutex_lock(&queue->lock);
+    DvzVideoQueuePolicy policy = block ? DVZ_VIDEO_QUEUE_BLOCK : state->cfg.queue_policy;
+    if (queue->count == queue->capacity)
+    {
+        if (policy == DVZ_VIDEO_QUEUE_DROP_NEWEST)
+        {
+            dropped = frame.rgba;
+            frame.rgba = NULL;
+        }
+        else if (policy == DVZ_VIDEO_QUEUE_DROP_OLDEST)
+        {
+            dropped = queue->frames[queue->head].rgba;
+            queue->head = (queue->head + 1) % queue->capacity;
+            queue->count--;
+        }
+        else
+        {
+            while (queue->count == queue->capacity)
+            {
+                dvz_cond_wait(&queue->cond, &queue->lock);
+            }
+        }
+    }
+    if (dropped != NULL)
+    {
+        queue->dropped++;
+    }
+    if (frame.rgba != NULL)
+    {
+        queue->frames[(queue->head + queue->count) % queue->capacity] = frame;
+        queue->count++;
+        dvz_cond_broadcast(&queue->cond);
+    }
+    int error = queue->error;
+    dvz_mutex_unlock(&queue->lock);
+
+    if (dropped != NULL)
+    {
+        log_debug("video encoder queue full, dropped one frame");
+        video_sink_release_rgba(state, dropped);
+    }
+    return error;
+}
+
+
+
+/**
+ * Drain the queue, stop the encoder thread and release the queue.
+ *
+ * @param state sink state
+ * @returns 0, or the first error reported by the encoder thread
+ */
+static int video_sink_queue_stop(DvzVideoSinkState* state)
+{
+    ANN(state);
+    if (!state->queue_running)
+    {
+        return 0;
+    }
+    DvzVideoSinkQueue* queue = &state->queue;
+
+    dvz_mutex_lock(&queue->lock);
+    queue->stop = true;
+    dvz_cond_broadcast(&queue->cond);
+    dvz_mutex_unlock(&queue->lock);
+    dvz_thread_join(queue->thread);
+    queue->thread = NULL;
+
+    int error = queue->error;
+    if (queue->dropped > 0)
+    {
+        log_info("video encoder queue dropped %" PRIu64 " frames", queue->dropped);
+    }
+    dvz_cond_destroy(&queue->cond);
+    dvz_mutex_destroy(&queue->lock);
+    dvz_free(queue->frames);
+    queue->frames = NULL;
+    state->queue_running = false;
+    return error;
+}
+
+
+
+/**
+ * Collect the frames still in flight in the capture pipeline and stop the encoder thread.
+ *
+ * @param state sink state
+ * @returns 0, or the first capture or encoder error
+ */
+static int video_sink_flush(DvzVideoSinkState* state)
+{
+    ANN(state);
+    int rc = 0;
+    if (state->resolved_capture_mode == DVZ_VIDEO_CAPTURE_CPU_READBACK && state->cfg.flush_rgba)
+    {
+        for (;;)
+        {
+            DvzVideoSinkFrame frame = {0};
+            int flush_rc = state->cfg.flush_rgba(
+                state->cfg.capture_user_data, &frame.width, &frame.height, &frame.stride,
+                &frame.rgba);
+            if (flush_rc != 0 || frame.rgba == NULL)
+            {
+                rc = flush_rc < 0 ? flush_rc : 0;
+                break;
+            }
+            if (frame.stride == 0)
+            {
+                frame.stride = (size_t)frame.width * 4;
+            }
+            int submit_rc = 0;
+            if (state->queue_running)
+            {
+                submit_rc = video_sink_queue_push(state, frame, true);
+            }
+            else
+            {
+                submit_rc = dvz_video_encoder_submit_rgba(
+                    state->encoder, frame.rgba, frame.width, frame.height, frame.stride, 0);
+                video_sink_release_rgba(state, frame.rgba);
+            }
+            if (submit_rc != 0)
+            {
+                rc = submit_rc;
+            }
+        }
+    }
+    int queue_rc = video_sink_queue_stop(state);
+    return rc != 0 ? rc : queue_rc;
+}
+
+
+
 /**
  * Release the encoder instance and drop the backend data blob.
  *
@@ -138,6 +433,7 @@ static void video_sink_cleanup(DvzStreamSink* sink)
         return;
     }
     DvzVideoSinkState* state = (DvzVideoSinkState*)sink->backend_data;
+    video_sink_queue_stop(state);
     if (state->encoder)
     {
         dvz_video_encoder_destroy(state->encoder);
@@ -231,8 +527,13 @@ static int video_sink_start(DvzStreamSink* sink, const DvzStreamFrame* frame)
     }
     if (state->resolved_capture_mode == DVZ_VIDEO_CAPTURE_CPU_READBACK)
     {
-        return dvz_video_encoder_start(
+        int rc = dvz_video_encoder_start(
             state->encoder, VK_NULL_HANDLE, VK_NULL_HANDLE, 0, -1, -1, state->cfg.bitstream);
+        if (rc != 0)
+        {
+            return rc;
+        }
+        return video_sink_queue_start(state);
     }
     return dvz_video_encoder_start(
         state->encoder, frame->image, frame->memory, frame->memory_size, frame->memory_fd,
@@ -267,41 +568,41 @@ static int video_sink_submit(DvzStreamSink* sink, uint64_t wait_value)
         uint32_t height = 0;
         size_t stride = 0;
         uint8_t* rgba = NULL;
-        if (state->cfg.capture_rgba(
-                state->cfg.capture_user_data, &width, &height, &stride, &rgba) != 0)
+        int capture_rc = state->cfg.capture_rgba(
+            state->cfg.capture_user_data, &width, &height, &stride, &rgba);
+        if (capture_rc > 0 && rgba == NULL)
+        {
+            // Pipelined readback still filling up.
+            return 0;
+        }
+        if (capture_rc != 0)
         {
             return -1;
         }
         if (rgba == NULL || width == 0 || height == 0)
         {
             log_error("CPU readback capture callback returned invalid frame");
-            if (rgba)
-            {
-                if (state->cfg.release_rgba)
-                {
-                    state->cfg.release_rgba(state->cfg.capture_user_data, rgba);
-                }
-                else
-                {
-                    dvz_free(rgba);
-                }
-            }
+            video_sink_release_rgba(state, rgba);
             return -1;
         }
         if (stride == 0)
         {
             stride = (size_t)width * 4;
         }
-        int rc =
-            dvz_video_encoder_submit_rgba(state->encoder, rgba, width, height, stride, wait_value);
-        if (state->cfg.release_rgba)
-        {
-            state->cfg.release_rgba(state->cfg.capture_user_data, rgba);
-        }
-        else
+        if (state->queue_running)
         {
-            dvz_free(rgba);
+            DvzVideoSinkFrame frame = {
+                .rgba = rgba,
+                .width = width,
+                .height = height,
+                .stride = stride,
+                .wait_value = wait_value,
+            };
+            return video_sink_queue_push(state, frame, false);
         }
+        int rc =
+            dvz_video_encoder_submit_rgba(state->encoder, rgba, width, height, stride, wait_value);
+        video_sink_release_rgba(state, rgba);
         return rc;
     }
     return dvz_video_encoder_submit(state->encoder, wait_value);
@@ -324,7 +625,9 @@ static int video_sink_stop(DvzStreamSink* sink)
     DvzVideoSinkState* state = (DvzVideoSinkState*)sink->backend_data;
     if (state && state->encoder)
     {
-        return dvz_video_encoder_stop(state->encoder);
+        int flush_rc = video_sink_flush(state);
+        int rc = dvz_video_encoder_stop(state->encoder);
+        return rc != 0 ? rc : flush_rc;
     }
     return 0;
 }
@@ -356,6 +659,7 @@ static int video_sink_update(DvzStreamSink* sink, const DvzStreamFrame* frame)
     {
         return -1;
     }
+    video_sink_flush(state);
     state->resolved_capture_mode = video_sink_resolve_capture_mode(&state->cfg);
     dvz_video_encoder_stop(state->encoder);
     sink->started = false;
@@ -396,6 +700,9 @@ DVZ_EXPORT DvzVideoSinkConfig dvz_video_sink_config(void)
         .capture_rgba = NULL,
         .release_rgba = NULL,
         .capture_user_data = NULL,
+        .flush_rgba = NULL,
+        .queue_depth = 0,
+        .queue_policy = DVZ_VIDEO_QUEUE_BLOCK,
     };
     return cfg;
 }
@@ -411,3 +718,31 @@ DVZ_EXPORT const DvzStreamSinkBackend* dvz_stream_sink_video(void)
 {
     return &DVZ_STREAM_SINK_VIDEO;
 }
+
+
+
+/*************************************************************************************************/
+/*  Test hooks                                                                                   */
+/*************************************************************************************************/
+
+void dvz_video_sink_test_init(
+    DvzStreamSink* sink, const DvzVideoSinkConfig* cfg, DvzVideoEncoder* encoder)
+{
+    ANN(sink);
+    ANN(cfg);
+    ANN(encoder);
+    DvzVideoSinkState* state = video_sink_state(sink);
+    ANN(state);
+    state->cfg = *cfg;
+    state->resolved_capture_mode = video_sink_resolve_capture_mode(&state->cfg);
+    state->encoder = encoder;
+}
+
+
+
+uint64_t dvz_video_sink_test_dropped(const DvzStreamSink* sink)
+{
+    ANN(sink);
+    const DvzVideoSinkState* state = (const DvzVideoSinkState*)sink->backend_data;
+    return state != NULL ? state->queue.dropped : 0;
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  Video sink internals                                                                         */
+/*************************************************************************************************/
+
+#pragma once
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdint.h>
+
+#include "datoviz/stream.h"
+#include "datoviz/video.h"
+#include "encoder.h"
+
+
+
+/*************************************************************************************************/
+/*  Test hooks                                                                                   */
+/*************************************************************************************************/
+
+/**
+ * Set up a video sink around a caller-provided encoder, bypassing backend selection.
+ *
+ * The sink callbacks of dvz_stream_sink_video() can then be driven directly, without a stream.
+ *
+ * @param sink stream sink receiving the state
+ * @param cfg sink configuration
+ * @param encoder heap-allocated encoder, destroyed with the sink
+ */
+void dvz_video_sink_test_init(
+    DvzStreamSink* sink, const DvzVideoSinkConfig* cfg, DvzVideoEncoder* encoder);
+
+
+
+/**
+ * Return the number of frames dropped by the encoder queue since the sink last started.
+ *
+ * @param sink video stream sink
+ * @returns the dropped frame count
+ */
+uint64_t dvz_video_sink_test_dropped(const DvzStreamSink* sink);
@@ -0,0 +1,650 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  RGBA to I420 conversion                                                                      */
+/*************************************************************************************************/
+
+/*
+ * Every kernel implements the same fixed-point formulas as the scalar reference, so outputs are
+ * bit-identical across CPUs:
+ *
+ *   Y = ((cy.r * R + cy.g * G + cy.b * B + 128) >> 8) + y_offset
+ *   U = (cu.r * sum(R) + cu.g * sum(G) + cu.b * sum(B) + (128 << 10) + 512) >> 10
+ *
+ * where sum() is taken over the 2x2 block of the chroma sample. The chroma bias keeps the
+ * numerator non-negative so that logical and arithmetic shifts agree.
+ */
+
+
+
+/*************************************************************************************************/
+/*  Includes                                                                                     */
+/*************************************************************************************************/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "_assertions.h"
+#include "_log.h"
+#include "yuv_convert.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DVZ_YUV_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define DVZ_YUV_TARGET(isa)
+#else
+#define DVZ_YUV_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+#define DVZ_YUV_ARM_NEON 1
+#include <arm_neon.h>
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_YUV_CHROMA_BIAS ((128 << 10) + 512)
+
+
+
+/*************************************************************************************************/
+/*  Types                                                                                        */
+/*************************************************************************************************/
+
+// Convert one row pair from column 0 and return the number of columns done; the caller finishes
+// the remaining columns with the scalar reference.
+typedef uint32_t (*DvzYuvRowPairFn)(
+    const DvzYuvCoefficients* c, const uint8_t* row0, const uint8_t* row1, uint8_t* y0,
+    uint8_t* y1, uint8_t* u, uint8_t* v, uint32_t width);
+
+
+
+typedef struct
+{
+    const DvzYuvConverter* conv;
+    const uint8_t* rgba;
+    size_t rgba_stride;
+    uint32_t width;
+    const DvzYuvPlanes* planes;
+} DvzYuvJob;
+
+
+
+/*************************************************************************************************/
+/*  Scalar reference                                                                             */
+/*************************************************************************************************/
+
+static inline uint8_t _clamp_u8(int32_t value)
+{
+    return (uint8_t)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+
+
+static inline uint8_t _luma(const DvzYuvCoefficients* c, const uint8_t* px)
+{
+    return _clamp_u8(
+        ((c->y[0] * px[0] + c->y[1] * px[1] + c->y[2] * px[2] + 128) >> 8) + c->y_offset);
+}
+
+
+
+static inline uint8_t _chroma(const int32_t* k, int32_t sr, int32_t sg, int32_t sb)
+{
+    return _clamp_u8((k[0] * sr + k[1] * sg + k[2] * sb + DVZ_YUV_CHROMA_BIAS) >> 10);
+}
+
+
+
+static void _row_pair_scalar(
+    const DvzYuvCoefficients* c, const uint8_t* row0, const uint8_t* row1, uint8_t* y0,
+    uint8_t* y1, uint8_t* u, uint8_t* v, uint32_t col, uint32_t width)
+{
+    for (; col + 1 < width; col += 2)
+    {
+        const uint8_t* p00 = row0 + 4 * (size_t)col;
+        const uint8_t* p01 = p00 + 4;
+        const uint8_t* p10 = row1 + 4 * (size_t)col;
+        const uint8_t* p11 = p10 + 4;
+
+        y0[col] = _luma(c, p00);
+        y0[col + 1] = _luma(c, p01);
+        y1[col] = _luma(c, p10);
+        y1[col + 1] = _luma(c, p11);
+
+        int32_t sr = p00[0] + p01[0] + p10[0] + p11[0];
+        int32_t sg = p00[1] + p01[1] + p10[1] + p11[1];
+        int32_t sb = p00[2] + p01[2] + p10[2] + p11[2];
+        u[col / 2] = _chroma(c->u, sr, sg, sb);
+        v[col / 2] = _chroma(c->v, sr, sg, sb);
+    }
+}
+
+
+
+static uint32_t _row_pair_none(
+    const DvzYuvCoefficients* c, const uint8_t* row0, const uint8_t* row1, uint8_t* y0,
+    uint8_t* y1, uint8_t* u, uint8_t* v, uint32_t width)
+{
+    (void)c;
+    (void)row0;
+    (void)row1;
+    (void)y0;
+    (void)y1;
+    (void)u;
+    (void)v;
+    (void)width;
+    return 0;
+}
+
+
+
+/*************************************************************************************************/
+/*  SSE4.1 kernel                                                                                */
+/*************************************************************************************************/
+
+#if DVZ_YUV_X86
+
+// Split 8 RGBA pixels into 16-bit R, G, B lanes.
+DVZ_YUV_TARGET("sse4.1")
+static inline void _sse41_split(const uint8_t* p, __m128i* r, __m128i* g, __m128i* b)
+{
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    __m128i a0 = _mm_loadu_si128((const __m128i*)p);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)(p + 16));
+    *r = _mm_packs_epi32(_mm_and_si128(a0, mask), _mm_and_si128(a1, mask));
+    *g = _mm_packs_epi32(
+        _mm_and_si128(_mm_srli_epi32(a0, 8), mask), _mm_and_si128(_mm_srli_epi32(a1, 8), mask));
+    *b = _mm_packs_epi32(
+        _mm_and_si128(_mm_srli_epi32(a0, 16), mask), _mm_and_si128(_mm_srli_epi32(a1, 16), mask));
+}
+
+
+
+// 16-bit wrap-around is harmless: the luma coefficients sum to at most 256, so the unsigned sum
+// always fits.
+DVZ_YUV_TARGET("sse4.1")
+static inline __m128i _sse41_luma(
+    __m128i r, __m128i g, __m128i b, const DvzYuvCoefficients* c)
+{
+    __m128i y = _mm_add_epi16(
+        _mm_mullo_epi16(r, _mm_set1_epi16((int16_t)c->y[0])),
+        _mm_mullo_epi16(g, _mm_set1_epi16((int16_t)c->y[1])));
+    y = _mm_add_epi16(y, _mm_mullo_epi16(b, _mm_set1_epi16((int16_t)c->y[2])));
+    y = _mm_add_epi16(y, _mm_set1_epi16(128));
+    return _mm_add_epi16(_mm_srli_epi16(y, 8), _mm_set1_epi16((int16_t)c->y_offset));
+}
+
+
+
+DVZ_YUV_TARGET("sse4.1")
+static inline __m128i _sse41_chroma(__m128i sr, __m128i sg, __m128i sb, const int32_t* k)
+{
+    __m128i acc = _mm_add_epi32(
+        _mm_mullo_epi32(sr, _mm_set1_epi32(k[0])), _mm_mullo_epi32(sg, _mm_set1_epi32(k[1])));
+    acc = _mm_add_epi32(acc, _mm_mullo_epi32(sb, _mm_set1_epi32(k[2])));
+    acc = _mm_add_epi32(acc, _mm_set1_epi32(DVZ_YUV_CHROMA_BIAS));
+    return _mm_srai_epi32(acc, 10);
+}
+
+
+
+DVZ_YUV_TARGET("sse4.1")
+static uint32_t _row_pair_sse41(
+    const DvzYuvCoefficients* c, const uint8_t* row0, const uint8_t* row1, uint8_t* y0,
+    uint8_t* y1, uint8_t* u, uint8_t* v, uint32_t width)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    uint32_t col = 0;
+    for (; col + 8 <= width; col += 8)
+    {
+        __m128i r0, g0, b0, r1, g1, b1;
+        _sse41_split(row0 + 4 * (size_t)col, &r0, &g0, &b0);
+        _sse41_split(row1 + 4 * (size_t)col, &r1, &g1, &b1);
+
+        __m128i luma = _mm_packus_epi16(_sse41_luma(r0, g0, b0, c), _sse41_luma(r1, g1, b1, c));
+        _mm_storel_epi64((__m128i*)(y0 + col), luma);
+        _mm_storel_epi64((__m128i*)(y1 + col), _mm_srli_si128(luma, 8));
+
+        // Vertical add, then horizontal pair add into 32-bit lanes: one sum per 2x2 block.
+        __m128i sr = _mm_madd_epi16(_mm_add_epi16(r0, r1), ones);
+        __m128i sg = _mm_madd_epi16(_mm_add_epi16(g0, g1), ones);
+        __m128i sb = _mm_madd_epi16(_mm_add_epi16(b0, b1), ones);
+        __m128i uv = _mm_packs_epi32(_sse41_chroma(sr, sg, sb, c->u), _sse41_chroma(sr, sg, sb, c->v));
+        uv = _mm_packus_epi16(uv, uv);
+
+        int32_t u4 = _mm_cvtsi128_si32(uv);
+        int32_t v4 = _mm_cvtsi128_si32(_mm_srli_si128(uv, 4));
+        memcpy(u + col / 2, &u4, 4);
+        memcpy(v + col / 2, &v4, 4);
+    }
+    return col;
+}
+
+
+
+/*************************************************************************************************/
+/*  AVX2 kernel                                                                                  */
+/*************************************************************************************************/
+
+// Split 16 RGBA pixels into 16-bit R, G, B lanes in pixel order.
+DVZ_YUV_TARGET("avx2")
+static inline void _avx2_split(const uint8_t* p, __m256i* r, __m256i* g, __m256i* b)
+{
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    __m256i a0 = _mm256_loadu_si256((const __m256i*)p);
+    __m256i a1 = _mm256_loadu_si256((const __m256i*)(p + 32));
+    // packs works per 128-bit lane, the permute restores the pixel order.
+    *r = _mm256_permute4x64_epi64(
+        _mm256_packs_epi32(_mm256_and_si256(a0, mask), _mm256_and_si256(a1, mask)), 0xD8);
+    *g = _mm256_permute4x64_epi64(
+        _mm256_packs_epi32(
+            _mm256_and_si256(_mm256_srli_epi32(a0, 8), mask),
+            _mm256_and_si256(_mm256_srli_epi32(a1, 8), mask)),
+        0xD8);
+    *b = _mm256_permute4x64_epi64(
+        _mm256_packs_epi32(
+            _mm256_and_si256(_mm256_srli_epi32(a0, 16), mask),
+            _mm256_and_si256(_mm256_srli_epi32(a1, 16), mask)),
+        0xD8);
+}
+
+
+
+DVZ_YUV_TARGET("avx2")
+static inline __m256i _avx2_luma(__m256i r, __m256i g, __m256i b, const DvzYuvCoefficients* c)
+{
+    __m256i y = _mm256_add_epi16(
+        _mm256_mullo_epi16(r, _mm256_set1_epi16((int16_t)c->y[0])),
+        _mm256_mullo_epi16(g, _mm256_set1_epi16((int16_t)c->y[1])));
+    y = _mm256_add_epi16(y, _mm256_mullo_epi16(b, _mm256_set1_epi16((int16_t)c->y[2])));
+    y = _mm256_add_epi16(y, _mm256_set1_epi16(128));
+    return _mm256_add_epi16(_mm256_srli_epi16(y, 8), _mm256_set1_epi16((int16_t)c->y_offset));
+}
+
+
+
+DVZ_YUV_TARGET("avx2")
+static inline __m256i _avx2_chroma(__m256i sr, __m256i sg, __m256i sb, const int32_t* k)
+{
+    __m256i acc = _mm256_add_epi32(
+        _mm256_mullo_epi32(sr, _mm256_set1_epi32(k[0])),
+        _mm256_mullo_epi32(sg, _mm256_set1_epi32(k[1])));
+    acc = _mm256_add_epi32(acc, _mm256_mullo_epi32(sb, _mm256_set1_epi32(k[2])));
+    acc = _mm256_add_epi32(acc, _mm256_set1_epi32(DVZ_YUV_CHROMA_BIAS));
+    return _mm256_srai_epi32(acc, 10);
+}
+
+
+
+DVZ_YUV_TARGET("avx2")
+static uint32_t _row_pair_avx2(
+    const DvzYuvCoefficients* c, const uint8_t* row0, const uint8_t* row1, uint8_t* y0,
+    uint8_t* y1, uint8_t* u, uint8_t* v, uint32_t width)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    uint32_t col = 0;
+    for (; col + 16 <= width; col += 16)
+    {
+        __m256i r0, g0, b0, r1, g1, b1;
+        _avx2_split(row0 + 4 * (size_t)col, &r0, &g0, &b0);
+        _avx2_split(row1 + 4 * (size_t)col, &r1, &g1, &b1);
+
+        // [row0 0-7, row1 0-7 | row0 8-15, row1 8-15] -> [row0 0-15 | row1 0-15]
+        __m256i luma = _mm256_permute4x64_epi64(
+            _mm256_packus_epi16(_avx2_luma(r0, g0, b0, c), _avx2_luma(r1, g1, b1, c)), 0xD8);
+        _mm_storeu_si128((__m128i*)(y0 + col), _mm256_castsi256_si128(luma));
+        _mm_storeu_si128((__m128i*)(y1 + col), _mm256_extracti128_si256(luma, 1));
+
+        __m256i sr = _mm256_madd_epi16(_mm256_add_epi16(r0, r1), ones);
+        __m256i sg = _mm256_madd_epi16(_mm256_add_epi16(g0, g1), ones);
+        __m256i sb = _mm256_madd_epi16(_mm256_add_epi16(b0, b1), ones);
+        // [U 0-3, V 0-3 | U 4-7, V 4-7] -> [U 0-7 | V 0-7]
+        __m256i uv = _mm256_permute4x64_epi64(
+            _mm256_packs_epi32(_avx2_chroma(sr, sg, sb, c->u), _avx2_chroma(sr, sg, sb, c->v)),
+            0xD8);
+        uv = _mm256_packus_epi16(uv, uv);
+        _mm_storel_epi64((__m128i*)(u + col / 2), _mm256_castsi256_si128(uv));
+        _mm_storel_epi64((__m128i*)(v + col / 2), _mm256_extracti128_si256(uv, 1));
+    }
+    return col;
+}
+
+#endif
+
+
+
+/*************************************************************************************************/
+/*  NEON kernel                                                                                  */
+/*************************************************************************************************/
+
+#if DVZ_YUV_ARM_NEON
+
+static inline uint8x8_t _neon_luma(uint8x8x4_t px, const DvzYuvCoefficients* c)
+{
+    uint16x8_t y = vmull_u8(px.val[0], vdup_n_u8((uint8_t)c->y[0]));
+    y = vmlal_u8(y, px.val[1], vdup_n_u8((uint8_t)c->y[1]));
+    y = vmlal_u8(y, px.val[2], vdup_n_u8((uint8_t)c->y[2]));
+    y = vaddq_u16(y, vdupq_n_u16(128));
+    return vadd_u8(vshrn_n_u16(y, 8), vdup_n_u8((uint8_t)c->y_offset));
+}
+
+
+
+static inline uint16x4_t
+_neon_chroma(int16x4_t sr, int16x4_t sg, int16x4_t sb, const int32_t* k)
+{
+    int32x4_t acc = vmull_n_s16(sr, (int16_t)k[0]);
+    acc = vmlal_n_s16(acc, sg, (int16_t)k[1]);
+    acc = vmlal_n_s16(acc, sb, (int16_t)k[2]);
+    acc = vaddq_s32(acc, vdupq_n_s32(DVZ_YUV_CHROMA_BIAS));
+    return vqmovun_s32(vshrq_n_s32(acc, 10));
+}
+
+
+
+static uint32_t _row_pair_neon(
+    const DvzYuvCoefficients* c, const uint8_t* row0, const uint8_t* row1, uint8_t* y0,
+    uint8_t* y1, uint8_t* u, uint8_t* v, uint32_t width)
+{
+    uint32_t col = 0;
+    for (; col + 8 <= width; col += 8)
+    {
+        uint8x8x4_t p0 = vld4_u8(row0 + 4 * (size_t)col);
+        uint8x8x4_t p1 = vld4_u8(row1 + 4 * (size_t)col);
+        vst1_u8(y0 + col, _neon_luma(p0, c));
+        vst1_u8(y1 + col, _neon_luma(p1, c));
+
+        int16x4_t sr = vreinterpret_s16_u16(vpadal_u8(vpaddl_u8(p0.val[0]), p1.val[0]));
+        int16x4_t sg = vreinterpret_s16_u16(vpadal_u8(vpaddl_u8(p0.val[1]), p1.val[1]));
+        int16x4_t sb = vreinterpret_s16_u16(vpadal_u8(vpaddl_u8(p0.val[2]), p1.val[2]));
+        uint8x8_t uv = vqmovn_u16(
+            vcombine_u16(_neon_chroma(sr, sg, sb, c->u), _neon_chroma(sr, sg, sb, c->v)));
+
+        uint32_t u4 = vget_lane_u32(vreinterpret_u32_u8(uv), 0);
+        uint32_t v4 = vget_lane_u32(vreinterpret_u32_u8(uv), 1);
+        memcpy(u + col / 2, &u4, 4);
+        memcpy(v + col / 2, &v4, 4);
+    }
+    return col;
+}
+
+#endif
+
+
+
+/*************************************************************************************************/
+/*  Dispatch                                                                                     */
+/*************************************************************************************************/
+
+#if DVZ_YUV_X86
+static bool _cpu_has(DvzYuvKernel kernel)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4] = {0};
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (kernel == DVZ_YUV_KERNEL_SSE41)
+        return sse41;
+    if (!osxsave || !avx || max_leaf < 7 || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    if (kernel == DVZ_YUV_KERNEL_SSE41)
+        return __builtin_cpu_supports("sse4.1");
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+
+
+static DvzYuvRowPairFn _kernel_fn(DvzYuvKernel kernel)
+{
+    switch (kernel)
+    {
+#if DVZ_YUV_X86
+    case DVZ_YUV_KERNEL_SSE41:
+        return _row_pair_sse41;
+    case DVZ_YUV_KERNEL_AVX2:
+        return _row_pair_avx2;
+#endif
+#if DVZ_YUV_ARM_NEON
+    case DVZ_YUV_KERNEL_NEON:
+        return _row_pair_neon;
+#endif
+    default:
+        return _row_pair_none;
+    }
+}
+
+
+
+static int32_t _round_i32(double value)
+{
+    return (int32_t)(value < 0 ? value - 0.5 : value + 0.5);
+}
+
+
+
+static void _convert_band(uint32_t begin, uint32_t end, void* user_data)
+{
+    DvzYuvJob* job = (DvzYuvJob*)user_data;
+    ANN(job);
+    dvz_rgba_to_i420_rows(
+        job->conv, job->rgba, job->rgba_stride, job->width, job->planes, begin << 1u,
+        end << 1u);
+}
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Return the fastest conversion kernel supported by the running CPU.
+ *
+ * @returns the kernel
+ */
+DvzYuvKernel dvz_yuv_kernel_best(void)
+{
+    if (dvz_yuv_kernel_supported(DVZ_YUV_KERNEL_AVX2))
+        return DVZ_YUV_KERNEL_AVX2;
+    if (dvz_yuv_kernel_supported(DVZ_YUV_KERNEL_NEON))
+        return DVZ_YUV_KERNEL_NEON;
+    if (dvz_yuv_kernel_supported(DVZ_YUV_KERNEL_SSE41))
+        return DVZ_YUV_KERNEL_SSE41;
+    return DVZ_YUV_KERNEL_SCALAR;
+}
+
+
+
+/**
+ * Return whether a conversion kernel was compiled in and is supported by the running CPU.
+ *
+ * @param kernel the kernel
+ * @returns whether the kernel can run
+ */
+bool dvz_yuv_kernel_supported(DvzYuvKernel kernel)
+{
+    switch (kernel)
+    {
+    case DVZ_YUV_KERNEL_SCALAR:
+        return true;
+#if DVZ_YUV_X86
+    case DVZ_YUV_KERNEL_SSE41:
+    case DVZ_YUV_KERNEL_AVX2:
+        return _cpu_has(kernel);
+#endif
+#if DVZ_YUV_ARM_NEON
+    case DVZ_YUV_KERNEL_NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+
+
+/**
+ * Return a short kernel name for logs.
+ *
+ * @param kernel the kernel
+ * @returns the kernel name
+ */
+const char* dvz_yuv_kernel_name(DvzYuvKernel kernel)
+{
+    switch (kernel)
+    {
+    case DVZ_YUV_KERNEL_AUTO:
+        return "auto";
+    case DVZ_YUV_KERNEL_SCALAR:
+        return "scalar";
+    case DVZ_YUV_KERNEL_SSE41:
+        return "sse4.1";
+    case DVZ_YUV_KERNEL_AVX2:
+        return "avx2";
+    case DVZ_YUV_KERNEL_NEON:
+        return "neon";
+    default:
+        return "unknown";
+    }
+}
+
+
+
+/**
+ * Create a converter for a color matrix and range.
+ *
+ * @param matrix color matrix
+ * @param range sample range
+ * @param kernel requested kernel; AUTO or an unsupported kernel resolves to the best one
+ * @returns the converter
+ */
+DvzYuvConverter dvz_yuv_converter(DvzYuvMatrix matrix, DvzYuvRange range, DvzYuvKernel kernel)
+{
+    DvzYuvConverter conv = {0};
+
+    if (kernel == DVZ_YUV_KERNEL_AUTO || !dvz_yuv_kernel_supported(kernel))
+    {
+        if (kernel != DVZ_YUV_KERNEL_AUTO)
+            log_warn(
+                "YUV conversion kernel %s unsupported, using %s", dvz_yuv_kernel_name(kernel),
+                dvz_yuv_kernel_name(dvz_yuv_kernel_best()));
+        kernel = dvz_yuv_kernel_best();
+    }
+    conv.kernel = kernel;
+
+    const double kr = matrix == DVZ_YUV_MATRIX_BT709 ? 0.2126 : 0.299;
+    const double kb = matrix == DVZ_YUV_MATRIX_BT709 ? 0.0722 : 0.114;
+    const bool full = range == DVZ_YUV_RANGE_FULL;
+    const double ys = (full ? 255.0 : 219.0) / 255.0 * 256.0;
+    // The chroma coefficients apply to a 2x2 sum with a >> 10, hence the same 256 scale.
+    const double cs = (full ? 255.0 : 224.0) / 255.0 * 256.0;
+
+    DvzYuvCoefficients* c = &conv.coefs;
+    c->y[0] = _round_i32(kr * ys);
+    c->y[2] = _round_i32(kb * ys);
+    // Absorb the rounding error into green so that white maps exactly to the top of the range;
+    // this also bounds the luma sum to 256, which the 16-bit SIMD lanes rely on.
+    c->y[1] = _round_i32(ys) - c->y[0] - c->y[2];
+    c->y_offset = full ? 0 : 16;
+
+    c->u[0] = _round_i32(-kr / (2.0 * (1.0 - kb)) * cs);
+    c->u[2] = _round_i32(0.5 * cs);
+    c->u[1] = -c->u[0] - c->u[2]; // grey maps exactly to 128
+
+    c->v[0] = _round_i32(0.5 * cs);
+    c->v[2] = _round_i32(-kb / (2.0 * (1.0 - kr)) * cs);
+    c->v[1] = -c->v[0] - c->v[2];
+
+    return conv;
+}
+
+
+
+/**
+ * Convert a band of row pairs from RGBA8 to I420.
+ *
+ * @param conv the converter
+ * @param rgba source pixels, RGBA8
+ * @param rgba_stride source row stride in bytes
+ * @param width frame width in pixels, must be even
+ * @param planes destination planes
+ * @param row_start first row, rounded down to an even row
+ * @param row_end one past the last row, rounded down to an even row
+ */
+void dvz_rgba_to_i420_rows(
+    const DvzYuvConverter* conv, const uint8_t* rgba, size_t rgba_stride, uint32_t width,
+    const DvzYuvPlanes* planes, uint32_t row_start, uint32_t row_end)
+{
+    ANN(conv);
+    ANN(rgba);
+    ANN(planes);
+
+    row_start &= ~1u;
+    row_end &= ~1u;
+    DvzYuvRowPairFn fn = _kernel_fn(conv->kernel);
+    const DvzYuvCoefficients* c = &conv->coefs;
+
+    for (uint32_t row = row_start; row < row_end; row += 2)
+    {
+        const uint8_t* row0 = rgba + (size_t)row * rgba_stride;
+        const uint8_t* row1 = row0 + rgba_stride;
+        uint8_t* y0 = planes->y + (size_t)row * planes->y_stride;
+        uint8_t* y1 = y0 + planes->y_stride;
+        uint8_t* u = planes->u + (size_t)(row / 2) * planes->uv_stride;
+        uint8_t* v = planes->v + (size_t)(row / 2) * planes->uv_stride;
+
+        uint32_t col = fn(c, row0, row1, y0, y1, u, v, width);
+        _row_pair_scalar(c, row0, row1, y0, y1, u, v, col, width);
+    }
+}
+
+
+
+/**
+ * Convert a full frame from RGBA8 to I420, split in bands of row pairs across a thread pool.
+ *
+ * @param conv the converter
+ * @param pool thread pool, or NULL to convert on the calling thread
+ * @param rgba source pixels, RGBA8
+ * @param rgba_stride source row stride in bytes
+ * @param width frame width in pixels, must be even
+ * @param height frame height in pixels, must be even
+ * @param planes destination planes
+ */
+void dvz_rgba_to_i420(
+    const DvzYuvConverter* conv, DvzThreadPool* pool, const uint8_t* rgba, size_t rgba_stride,
+    uint32_t width, uint32_t height, const DvzYuvPlanes* planes)
+{
+    ANN(conv);
+    DvzYuvJob job = {
+        .conv = conv,
+        .rgba = rgba,
+        .rgba_stride = rgba_stride,
+        .width = width,
+        .planes = planes,
+    };
+    dvz_thread_pool_parallel_for(pool, height >> 1u, 0, _convert_band, &job);
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2021 Cyrille Rossant and contributors. All rights reserved.
+ * Licensed under the MIT license. See LICENSE file in the project root for details.
+ * SPDX-License-Identifier: MIT
+ */
+
+/*************************************************************************************************/
+/*  RGBA to I420 conversion                                                                      */
+/*************************************************************************************************/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "thread_internal.h"
+
+
+
+/*************************************************************************************************/
+/*  Enums                                                                                        */
+/*************************************************************************************************/
+
+// YUV color matrix.
+typedef enum
+{
+    DVZ_YUV_MATRIX_BT601,
+    DVZ_YUV_MATRIX_BT709,
+} DvzYuvMatrix;
+
+
+
+// YUV sample range.
+typedef enum
+{
+    DVZ_YUV_RANGE_LIMITED, // Y in [16, 235], chroma in [16, 240]
+    DVZ_YUV_RANGE_FULL,    // all planes in [0, 255]
+} DvzYuvRange;
+
+
+
+// Conversion kernel. Every kernel produces bit-identical output to the scalar reference.
+typedef enum
+{
+    DVZ_YUV_KERNEL_AUTO,
+    DVZ_YUV_KERNEL_SCALAR,
+    DVZ_YUV_KERNEL_SSE41,
+    DVZ_YUV_KERNEL_AVX2,
+    DVZ_YUV_KERNEL_NEON,
+    DVZ_YUV_KERNEL_COUNT,
+} DvzYuvKernel;
+
+
+
+/*************************************************************************************************/
+/*  Structs                                                                                      */
+/*************************************************************************************************/
+
+// Fixed-point coefficients: luma uses 8 fractional bits per pixel, chroma uses 8 fractional bits
+// applied to the sum of a 2x2 block.
+typedef struct
+{
+    int32_t y[3];
+    int32_t u[3];
+    int32_t v[3];
+    int32_t y_offset;
+} DvzYuvCoefficients;
+
+
+
+typedef struct
+{
+    DvzYuvKernel kernel;
+    DvzYuvCoefficients coefs;
+} DvzYuvConverter;
+
+
+
+// Destination planes; the chroma planes are subsampled by two in both directions.
+typedef struct
+{
+    uint8_t* y;
+    uint8_t* u;
+    uint8_t* v;
+    size_t y_stride;
+    size_t uv_stride;
+} DvzYuvPlanes;
+
+
+
+/*************************************************************************************************/
+/*  Functions                                                                                    */
+/*************************************************************************************************/
+
+/**
+ * Return the fastest conversion kernel supported by the running CPU.
+ *
+ * @returns the kernel
+ */
+DvzYuvKernel dvz_yuv_kernel_best(void);
+
+
+
+/**
+ * Return whether a conversion kernel was compiled in and is supported by the running CPU.
+ *
+ * @param kernel the kernel
+ * @returns whether the kernel can run
+ */
+bool dvz_yuv_kernel_supported(DvzYuvKernel kernel);
+
+
+
+/**
+ * Return a short kernel name for logs.
+ *
+ * @param kernel the kernel
+ * @returns the kernel name
+ */
+const char* dvz_yuv_kernel_name(DvzYuvKernel kernel);
+
+
+
+/**
+ * Create a converter for a color matrix and range.
+ *
+ * @param matrix color matrix
+ * @param range sample range
+ * @param kernel requested kernel; AUTO or an unsupported kernel resolves to the best one
+ * @returns the converter
+ */
+DvzYuvConverter dvz_yuv_converter(DvzYuvMatrix matrix, DvzYuvRange range, DvzYuvKernel kernel);
+
+
+
+/**
+ * Convert a band of row pairs from RGBA8 to I420.
+ *
+ * @param conv the converter
+ * @param rgba source pixels, RGBA8
+ * @param rgba_stride source row stride in bytes
+ * @param width frame width in pixels, must be even
+ * @param planes destination planes
+ * @param row_start first row, rounded down to an even row
+ * @param row_end one past the last row, rounded down to an even row
+ */
+void dvz_rgba_to_i420_rows(
+    const DvzYuvConverter* conv, const uint8_t* rgba, size_t rgba_stride, uint32_t width,
+    const DvzYuvPlanes* planes, uint32_t row_start, uint32_t row_end);
+
+
+
+/**
+ * Convert a full frame from RGBA8 to I420, split in bands of row pairs across a thread pool.
+ *
+ * @param conv the converter
+ * @param pool thread pool, or NULL to convert on the calling thread
+ * @param rgba source pixels, RGBA8
+ * @param rgba_stride source row stride in bytes
+ * @param width frame width in pixels, must be even
+ * @param height frame height in pixels, must be even
+ * @param planes destination planes
+ */
+void dvz_rgba_to_i420(
+    const DvzYuvConverter* conv, DvzThreadPool* pool, const uint8_t* rgba, size_t rgba_stride,
+    uint32_t width, uint32_t height, const DvzYuvPlanes* planes);
@@ -746,6 +746,20 @@ const VkPhysicalDeviceFeatures* dvz_device_features10(DvzDevice* device)
 
 
 
+/**
+ * Return the Vulkan 1.2 feature set enabled on this device.
+ *
+ * @param device the device
+ * @return immutable pointer to enabled Vulkan 1.2 features
+ */
+const VkPhysicalDeviceVulkan12Features* dvz_device_features12(DvzDevice* device)
+{
+    ANN(device);
+    return &device->features12;
+}
+
+
+
 DvzQueue* dvz_device_queue(DvzDevice* device, DvzQueueRole role)
 {
     ANN(device);
@@ -341,6 +341,38 @@ int dvz_device_allocator(
 
 
 
+int dvz_allocator_budget(DvzVma* allocator, DvzMemoryBudget* budget)
+{
+    ANN(allocator);
+    ANN(budget);
+    dvz_memset(budget, sizeof(DvzMemoryBudget), 0, sizeof(DvzMemoryBudget));
+    if (allocator->vma == NULL)
+        return 1;
+
+    const VkPhysicalDeviceMemoryProperties* props = NULL;
+    vmaGetMemoryProperties(allocator->vma, &props);
+    ANN(props);
+    VmaBudget heaps[VK_MAX_MEMORY_HEAPS] = {0};
+    vmaGetHeapBudgets(allocator->vma, heaps);
+
+    for (uint32_t i = 0; i < props->memoryHeapCount; i++)
+    {
+        if ((props->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0)
+        {
+            budget->device_usage += heaps[i].usage;
+            budget->device_budget += heaps[i].budget;
+        }
+        else
+        {
+            budget->host_usage += heaps[i].usage;
+            budget->host_budget += heaps[i].budget;
+        }
+    }
+    return 0;
+}
+
+
+
 int dvz_allocator_buffer(
     DvzVma* allocator, VkBufferCreateInfo* info, DvzAllocationFlags flags, DvzAllocation* alloc,
     VkBuffer* vk_buffer)
@@ -413,6 +445,24 @@ int dvz_allocator_image(
     alloc->flags = flags;
     alloc_info.flags = _dvz_to_vma_allocation_flags(flags);
 
+    // Lazily-allocated memory only exists on some (mostly tiled) devices: VMA reports a missing
+    // memory type as a failure, and the image then falls back to ordinary device memory.
+    if ((flags & DVZ_ALLOC_LAZILY_ALLOCATED) != 0 &&
+        (info->usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT) != 0)
+    {
+        VmaAllocationCreateInfo lazy_info = alloc_info;
+        lazy_info.usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+        if (vmaCreateImage(
+                allocator->vma, info, &lazy_info, vk_image, &alloc->alloc, &alloc->info) ==
+            VK_SUCCESS)
+        {
+            alloc->usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED;
+            log_trace("lazily-allocated image created");
+            return 0;
+        }
+        log_trace("no lazily-allocated memory type, using device memory");
+    }
+
     log_trace("creating image...");
     VK_RETURN_RESULT(
         vmaCreateImage(allocator->vma, info, &alloc_info, vk_image, &alloc->alloc, &alloc->info));
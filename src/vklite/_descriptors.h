@@ -16,12 +16,30 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include <stdbool.h>
 #include <vulkan/vulkan_core.h>
 
 #include "datoviz/vklite/descriptors.h"
 
 
 
+/*************************************************************************************************/
+/*  Constants                                                                                    */
+/*************************************************************************************************/
+
+#define DVZ_DESCRIPTOR_CHAIN_FIRST_POOL 16 /* set groups in the first pool of a chain */
+#define DVZ_DESCRIPTOR_CHAIN_MAX_SIZES  16 /* distinct descriptor types per slots object */
+
+
+
+/*************************************************************************************************/
+/*  Typedefs                                                                                     */
+/*************************************************************************************************/
+
+typedef struct DvzDescriptorChain DvzDescriptorChain;
+
+
+
 /*************************************************************************************************/
 /*  Structs                                                                                      */
 /*************************************************************************************************/
@@ -31,6 +49,46 @@ struct DvzDescriptors
     DvzSlots* slots;
     DvzDevice* device;
     VkDescriptorPool vk_pool;
+    DvzDescriptorChain* chain; /* set when allocated by dvz_descriptors_pooled() */
     uint32_t set_count;
     VkDescriptorSet vk_descriptors[DVZ_MAX_SETS];
 };
+
+
+
+/*
+ * One chain of pools for one slots object. A group is the `set_count` sets of one wrapper; pools
+ * hold `pool_groups` groups and never free individual sets, freed groups go to `free_sets`.
+ */
+struct DvzDescriptorChain
+{
+    DvzDescriptorAllocator* allocator;
+    DvzSlots* slots;
+    bool retired; /* slots released, destroyed once `live` drops to zero */
+    uint32_t set_count;
+    uint32_t size_count;
+    VkDescriptorPoolSize sizes[DVZ_DESCRIPTOR_CHAIN_MAX_SIZES]; /* descriptors per group */
+
+    uint32_t pool_count;
+    uint32_t pool_capacity;
+    VkDescriptorPool* pools;
+    uint32_t pool_groups;    /* groups in the last pool */
+    uint32_t pool_remaining; /* groups left in the last pool */
+
+    uint32_t live;
+    uint32_t free_count;        /* recycled groups */
+    uint32_t free_capacity;     /* in groups */
+    VkDescriptorSet* free_sets; /* `set_count` handles per group */
+};
+
+
+
+struct DvzDescriptorAllocator
+{
+    DvzDevice* device;
+    uint32_t chain_count;
+    uint32_t chain_capacity;
+    DvzDescriptorChain** chains;
+    uint64_t allocations;
+    uint64_t recycled;
+};
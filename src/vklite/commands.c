@@ -14,6 +14,8 @@
 /*  Includes                                                                                     */
 /*************************************************************************************************/
 
+#include <inttypes.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <volk.h>
 
@@ -21,6 +23,7 @@
 #include "_assertions.h"
 #include "_commands.h"
 #include "_log.h"
+#include "_sync.h"
 #include "_vk_utils.h"
 #include "obj.h"
 #include "datoviz/vk/device.h"
@@ -102,14 +105,24 @@ static void _commands_release(DvzCommands* cmds)
     cmds->current = 0;
 }
 
-void dvz_commands(DvzDevice* device, DvzQueue* queue, uint32_t count, DvzCommands* cmds)
+/**
+ * Allocate command buffers of a given level into a commands wrapper.
+ *
+ * @param device the device
+ * @param queue the queue whose family selects the command pool
+ * @param count the number of command buffers
+ * @param level the command buffer level
+ * @param cmds the commands wrapper
+ */
+static void _commands_allocate(
+    DvzDevice* device, DvzQueue* queue, uint32_t count, VkCommandBufferLevel level,
+    DvzCommands* cmds)
 {
     ANN(cmds);
     ANN(device);
     ANN(queue);
 
     ASSERT(0 < count && count <= DVZ_MAX_SWAPCHAIN_IMAGES);
-    log_trace("creating commands");
 
     cmds->device = device;
     cmds->queue = queue;
@@ -118,7 +131,7 @@ void dvz_commands(DvzDevice* device, DvzQueue* queue, uint32_t count, DvzCommand
     VkCommandBufferAllocateInfo info = {0};
     info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     info.commandPool = dvz_device_command_pool(device, dvz_queue_family(queue));
-    info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    info.level = level;
     info.commandBufferCount = count;
     VkResult res = vkAllocateCommandBuffers(dvz_device_handle(device), &info, cmds->cmds);
     if (res != VK_SUCCESS)
@@ -133,6 +146,30 @@ void dvz_commands(DvzDevice* device, DvzQueue* queue, uint32_t count, DvzCommand
 
 
 
+void dvz_commands(DvzDevice* device, DvzQueue* queue, uint32_t count, DvzCommands* cmds)
+{
+    log_trace("creating commands");
+    _commands_allocate(device, queue, count, VK_COMMAND_BUFFER_LEVEL_PRIMARY, cmds);
+}
+
+
+
+/**
+ * Create a set of secondary command buffers.
+ *
+ * @param device the device
+ * @param queue the queue whose family selects the command pool
+ * @param count the number of command buffers
+ * @param cmds the commands wrapper
+ */
+void dvz_commands_secondary(DvzDevice* device, DvzQueue* queue, uint32_t count, DvzCommands* cmds)
+{
+    log_trace("creating secondary commands");
+    _commands_allocate(device, queue, count, VK_COMMAND_BUFFER_LEVEL_SECONDARY, cmds);
+}
+
+
+
 /**
  * Allocate a single primary command buffer from the device command pool of a queue family.
  *
@@ -268,6 +305,42 @@ void dvz_cmd_begin(DvzCommands* cmds)
 
 
 
+/**
+ * Start recording a secondary command buffer that continues a dynamic rendering.
+ *
+ * @param cmds the secondary commands wrapper
+ * @param rendering the inherited rendering formats and sample count
+ * @return 0 on success, non-zero on Vulkan or state failure
+ */
+int dvz_cmd_begin_rendering_secondary_result(
+    DvzCommands* cmds, const VkCommandBufferInheritanceRenderingInfo* rendering)
+{
+    ANN(cmds);
+    ANN(rendering);
+    ASSERT(cmds->count > 0);
+    if (cmds->borrowed_recording)
+    {
+        log_error("cannot begin a borrowed recording command buffer");
+        return 1;
+    }
+
+    VkCommandBufferInheritanceInfo inheritance = {0};
+    inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritance.pNext = rendering;
+
+    VkCommandBufferBeginInfo begin_info = {0};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT |
+                       VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+    begin_info.pInheritanceInfo = &inheritance;
+    VkCommandBuffer cmd = dvz_commands_handle(cmds);
+    ANNVK(cmd);
+    VkResult res = vkBeginCommandBuffer(cmd, &begin_info);
+    return vk_result_check(res, __FILE__, __LINE__);
+}
+
+
+
 /**
  * Stop recording a command buffer and report Vulkan failures.
  *
@@ -353,41 +426,46 @@ void dvz_cmd_release(DvzCommands* cmds)
 
 
 /**
- * Submit a command buffer on its queue and report Vulkan failures.
+ * Check that an owned command buffer has been recorded and can be submitted.
  *
  * @param cmds the commands wrapper
- * @return 0 on success, non-zero on Vulkan or state failure
+ * @return whether the commands can be submitted
  */
-int dvz_cmd_submit_result(DvzCommands* cmds)
+static bool _commands_submittable(DvzCommands* cmds)
 {
     ANN(cmds);
     ASSERT(cmds->count > 0);
     if (cmds->borrowed_recording)
     {
         log_error("cannot submit a borrowed recording command buffer");
-        return 1;
+        return false;
     }
     if (!dvz_obj_is_created(&cmds->obj))
     {
         log_error("cannot submit commands before recording them");
-        return 1;
+        return false;
     }
+    ANN(cmds->device);
+    ANN(cmds->queue);
+    return true;
+}
 
-    DvzDevice* device = cmds->device;
-    ANN(device);
-
-    log_trace("submit %d command buffer(s)", cmds->count);
 
-    DvzQueue* queue = cmds->queue;
-    ANN(queue);
 
-    // NOTE: inefficient device-level wait.
-    dvz_device_wait(device);
+/**
+ * Submit the recorded command buffers on their queue.
+ *
+ * @param cmds the commands wrapper
+ * @param signal optional semaphore to signal, or NULL
+ * @return 0 on success, non-zero on Vulkan failure
+ */
+static int _commands_queue_submit(DvzCommands* cmds, const VkSemaphoreSubmitInfo* signal)
+{
+    ANN(cmds);
 
-    VkQueue vk_queue = dvz_queue_handle(queue);
+    VkQueue vk_queue = dvz_queue_handle(cmds->queue);
     ANNVK(vk_queue);
 
-    // Submit.
     VkCommandBufferSubmitInfo submit_cmds[DVZ_MAX_SWAPCHAIN_IMAGES] = {0};
     for (uint32_t i = 0; i < cmds->count; ++i)
     {
@@ -400,6 +478,8 @@ int dvz_cmd_submit_result(DvzCommands* cmds)
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
         .commandBufferInfoCount = cmds->count,
         .pCommandBufferInfos = submit_cmds,
+        .signalSemaphoreInfoCount = signal != NULL ? 1 : 0,
+        .pSignalSemaphoreInfos = signal,
     };
     VkResult res = vkQueueSubmit2(vk_queue, 1, &info, VK_NULL_HANDLE);
     if (res != VK_SUCCESS)
@@ -407,14 +487,72 @@ int dvz_cmd_submit_result(DvzCommands* cmds)
         vk_result_check(res, __FILE__, __LINE__);
         return 1;
     }
+    return 0;
+}
+
+
+
+/**
+ * Submit a command buffer on its queue and report Vulkan failures.
+ *
+ * @param cmds the commands wrapper
+ * @return 0 on success, non-zero on Vulkan or state failure
+ */
+int dvz_cmd_submit_result(DvzCommands* cmds)
+{
+    if (!_commands_submittable(cmds))
+        return 1;
+
+    log_trace("submit %d command buffer(s)", cmds->count);
+
+    // NOTE: inefficient device-level wait.
+    dvz_device_wait(cmds->device);
+
+    // Submit.
+    if (_commands_queue_submit(cmds, NULL) != 0)
+        return 1;
 
     // Wait.
-    dvz_queue_wait(queue);
+    dvz_queue_wait(cmds->queue);
     return 0;
 }
 
 
 
+/**
+ * Submit a command buffer on its queue and signal a timeline value on completion.
+ *
+ * @param cmds the commands wrapper
+ * @param timeline the timeline semaphore to signal
+ * @param signal_value the timeline value to signal on completion
+ * @return 0 on success, non-zero on Vulkan or state failure
+ */
+int dvz_cmd_submit_async(DvzCommands* cmds, DvzSemaphore* timeline, uint64_t signal_value)
+{
+    ANN(timeline);
+    if (!_commands_submittable(cmds))
+        return 1;
+    if (!dvz_obj_is_created(&timeline->obj))
+    {
+        log_error("cannot signal a timeline semaphore that was not created");
+        return 1;
+    }
+
+    log_trace(
+        "submit %d command buffer(s) signaling timeline value %" PRIu64, cmds->count,
+        signal_value);
+
+    VkSemaphoreSubmitInfo signal = {
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+        .semaphore = timeline->vk_semaphore,
+        .value = signal_value,
+        .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT,
+    };
+    return _commands_queue_submit(cmds, &signal);
+}
+
+
+
 /**
  * Submit a command buffer on its queue.
  *
@@ -427,6 +565,26 @@ void dvz_cmd_submit(DvzCommands* cmds)
 
 
 
+/**
+ * Execute the currently selected secondary command buffer from a primary command buffer.
+ *
+ * @param cmds the primary commands wrapper
+ * @param secondary the recorded secondary commands wrapper
+ */
+void dvz_cmd_execute_commands(DvzCommands* cmds, DvzCommands* secondary)
+{
+    ANN(cmds);
+    ANN(secondary);
+
+    VkCommandBuffer cmd = dvz_commands_handle(cmds);
+    VkCommandBuffer child = dvz_commands_handle(secondary);
+    ANNVK(cmd);
+    ANNVK(child);
+    vkCmdExecuteCommands(cmd, 1, &child);
+}
+
+
+
 void dvz_commands_destroy(DvzCommands* cmds)
 {
     if (cmds == NULL)
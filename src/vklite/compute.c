@@ -254,3 +254,16 @@ void dvz_cmd_dispatch(DvzCommands* cmds, uint32_t nx, uint32_t ny, uint32_t nz)
 
     vkCmdDispatch(cmd, nx, ny, nz);
 }
+
+
+
+void dvz_cmd_dispatch_indirect(DvzCommands* cmds, VkBuffer indirect, DvzSize offset)
+{
+    ANN(cmds);
+    ANNVK(indirect);
+
+    VkCommandBuffer cmd = dvz_commands_handle(cmds);
+    ANNVK(cmd);
+
+    vkCmdDispatchIndirect(cmd, indirect, offset);
+}
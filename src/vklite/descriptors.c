@@ -22,6 +22,7 @@
 #include "_assertions.h"
 #include "_descriptors.h"
 #include "_log.h"
+#include "_slots.h"
 #include "datoviz/vk/device.h"
 #include "datoviz/vklite/commands.h"
 #include "datoviz/vklite/descriptors.h"
@@ -224,6 +225,379 @@ void dvz_cmd_bind_descriptors(
 
 
 
+/*************************************************************************************************/
+/*  Descriptor allocator                                                                         */
+/*************************************************************************************************/
+
+static DvzDescriptorChain*
+_descriptor_chain_find(DvzDescriptorAllocator* allocator, DvzSlots* slots)
+{
+    ANN(allocator);
+    for (uint32_t i = 0; i < allocator->chain_count; i++)
+    {
+        DvzDescriptorChain* chain = allocator->chains[i];
+        if (chain->slots == slots && !chain->retired)
+            return chain;
+    }
+    return NULL;
+}
+
+
+
+static DvzDescriptorChain*
+_descriptor_chain_create(DvzDescriptorAllocator* allocator, DvzSlots* slots)
+{
+    ANN(allocator);
+    ANN(slots);
+
+    DvzDescriptorChain* chain = (DvzDescriptorChain*)dvz_calloc(1, sizeof(DvzDescriptorChain));
+    if (chain == NULL)
+        return NULL;
+    chain->allocator = allocator;
+    chain->slots = slots;
+    chain->set_count = slots->set_count;
+    ASSERT(chain->set_count <= DVZ_MAX_SETS);
+
+    // Sum the descriptors of one group per type; a pool of N groups holds N times these sizes.
+    for (uint32_t set = 0; set < slots->set_count; set++)
+    {
+        for (uint32_t binding = 0; binding < slots->binding_counts[set]; binding++)
+        {
+            if (!slots->binding_configured[set][binding])
+                continue;
+            const VkDescriptorSetLayoutBinding* b = &slots->bindings[set][binding];
+            uint32_t k = 0;
+            while (k < chain->size_count && chain->sizes[k].type != b->descriptorType)
+                k++;
+            if (k == DVZ_DESCRIPTOR_CHAIN_MAX_SIZES)
+            {
+                log_error("too many descriptor types for one descriptor pool chain");
+                dvz_free(chain);
+                return NULL;
+            }
+            chain->sizes[k].type = b->descriptorType;
+            chain->sizes[k].descriptorCount += b->descriptorCount;
+            chain->size_count = k == chain->size_count ? k + 1 : chain->size_count;
+        }
+    }
+
+    if (allocator->chain_count == allocator->chain_capacity)
+    {
+        uint32_t capacity = allocator->chain_capacity == 0 ? 8 : allocator->chain_capacity * 2;
+        DvzDescriptorChain** chains = (DvzDescriptorChain**)dvz_realloc(
+            allocator->chains, capacity * sizeof(DvzDescriptorChain*));
+        if (chains == NULL)
+        {
+            dvz_free(chain);
+            return NULL;
+        }
+        allocator->chains = chains;
+        allocator->chain_capacity = capacity;
+    }
+    allocator->chains[allocator->chain_count++] = chain;
+    return chain;
+}
+
+
+
+static void _descriptor_chain_destroy(DvzDescriptorChain* chain)
+{
+    ANN(chain);
+    DvzDescriptorAllocator* allocator = chain->allocator;
+    ANN(allocator);
+    VkDevice vkd = dvz_device_handle(allocator->device);
+    for (uint32_t i = 0; i < chain->pool_count; i++)
+    {
+        if (vkd != VK_NULL_HANDLE)
+            vkDestroyDescriptorPool(vkd, chain->pools[i], NULL);
+    }
+    dvz_free(chain->pools);
+    dvz_free(chain->free_sets);
+
+    for (uint32_t i = 0; i < allocator->chain_count; i++)
+    {
+        if (allocator->chains[i] == chain)
+        {
+            allocator->chains[i] = allocator->chains[--allocator->chain_count];
+            break;
+        }
+    }
+    dvz_free(chain);
+}
+
+
+
+static bool _descriptor_chain_grow(DvzDescriptorChain* chain)
+{
+    ANN(chain);
+    VkDevice vkd = dvz_device_handle(chain->allocator->device);
+    ANNVK(vkd);
+
+    if (chain->pool_count == chain->pool_capacity)
+    {
+        uint32_t capacity = chain->pool_capacity == 0 ? 4 : chain->pool_capacity * 2;
+        VkDescriptorPool* pools =
+            (VkDescriptorPool*)dvz_realloc(chain->pools, capacity * sizeof(VkDescriptorPool));
+        if (pools == NULL)
+            return false;
+        chain->pools = pools;
+        chain->pool_capacity = capacity;
+    }
+
+    // Pools double in size up to DVZ_MAX_DESCRIPTOR_SETS groups.
+    uint32_t groups = chain->pool_groups == 0 ? DVZ_DESCRIPTOR_CHAIN_FIRST_POOL
+                                              : chain->pool_groups * 2;
+    groups = groups > DVZ_MAX_DESCRIPTOR_SETS ? DVZ_MAX_DESCRIPTOR_SETS : groups;
+
+    VkDescriptorPoolSize sizes[DVZ_DESCRIPTOR_CHAIN_MAX_SIZES] = {0};
+    for (uint32_t k = 0; k < chain->size_count; k++)
+    {
+        sizes[k].type = chain->sizes[k].type;
+        sizes[k].descriptorCount = chain->sizes[k].descriptorCount * groups;
+    }
+
+    VkDescriptorPoolCreateInfo info = {0};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    info.maxSets = groups * chain->set_count;
+    info.poolSizeCount = chain->size_count;
+    info.pPoolSizes = sizes;
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    log_trace("create descriptor pool with %u set groups", groups);
+    VkResult res = vkCreateDescriptorPool(vkd, &info, NULL, &pool);
+    if (res != VK_SUCCESS)
+    {
+        log_error("failed to create descriptor pool: %d", (int)res);
+        return false;
+    }
+    chain->pools[chain->pool_count++] = pool;
+    chain->pool_groups = groups;
+    chain->pool_remaining = groups;
+    return true;
+}
+
+
+
+static bool _descriptor_chain_allocate(DvzDescriptorChain* chain, VkDescriptorSet* sets)
+{
+    ANN(chain);
+    ANN(sets);
+    VkDevice vkd = dvz_device_handle(chain->allocator->device);
+    ANNVK(vkd);
+
+    VkDescriptorSetLayout set_layouts[DVZ_MAX_SETS] = {0};
+    for (uint32_t set = 0; set < chain->set_count; set++)
+        set_layouts[set] = dvz_slots_set_layout(chain->slots, set);
+
+    VkDescriptorSetAllocateInfo info = {0};
+    info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    info.descriptorSetCount = chain->set_count;
+    info.pSetLayouts = set_layouts;
+
+    // The last pool is tracked by group count; a pool error still falls through to a new pool.
+    for (uint32_t attempt = 0; attempt < 2; attempt++)
+    {
+        if (chain->pool_remaining == 0 && !_descriptor_chain_grow(chain))
+            return false;
+        info.descriptorPool = chain->pools[chain->pool_count - 1];
+        VkResult res = vkAllocateDescriptorSets(vkd, &info, sets);
+        if (res == VK_SUCCESS)
+        {
+            chain->pool_remaining--;
+            return true;
+        }
+        if (res != VK_ERROR_OUT_OF_POOL_MEMORY && res != VK_ERROR_FRAGMENTED_POOL)
+        {
+            log_error("failed to allocate descriptor sets: %d", (int)res);
+            return false;
+        }
+        chain->pool_remaining = 0;
+    }
+    return false;
+}
+
+
+
+static void _descriptor_chain_recycle(DvzDescriptorChain* chain, const VkDescriptorSet* sets)
+{
+    ANN(chain);
+    ANN(sets);
+    ASSERT(chain->live > 0);
+    chain->live--;
+    if (chain->retired)
+    {
+        if (chain->live == 0)
+            _descriptor_chain_destroy(chain);
+        return;
+    }
+
+    if (chain->free_count == chain->free_capacity)
+    {
+        uint32_t capacity = chain->free_capacity == 0 ? 64 : chain->free_capacity * 2;
+        VkDescriptorSet* free_sets = (VkDescriptorSet*)dvz_realloc(
+            chain->free_sets, (size_t)capacity * chain->set_count * sizeof(VkDescriptorSet));
+        // The sets stay owned by their pool and come back when the chain is destroyed.
+        if (free_sets == NULL)
+            return;
+        chain->free_sets = free_sets;
+        chain->free_capacity = capacity;
+    }
+    dvz_memcpy(
+        &chain->free_sets[(size_t)chain->free_count * chain->set_count],
+        chain->set_count * sizeof(VkDescriptorSet), sets,
+        chain->set_count * sizeof(VkDescriptorSet));
+    chain->free_count++;
+}
+
+
+
+/**
+ * Create a growable descriptor allocator.
+ *
+ * @param device the device
+ * @return owned allocator, or NULL on allocation failure
+ */
+DvzDescriptorAllocator* dvz_descriptor_allocator(DvzDevice* device)
+{
+    ANN(device);
+    DvzDescriptorAllocator* allocator =
+        (DvzDescriptorAllocator*)dvz_calloc(1, sizeof(DvzDescriptorAllocator));
+    if (allocator == NULL)
+        return NULL;
+    allocator->device = device;
+    return allocator;
+}
+
+
+
+/**
+ * Allocate descriptors from a growable allocator.
+ *
+ * @param allocator the descriptor allocator
+ * @param slots the slots
+ * @param[out] descriptors the created descriptors
+ * @return 0 on success, nonzero on failure
+ */
+int dvz_descriptors_pooled(
+    DvzDescriptorAllocator* allocator, DvzSlots* slots, DvzDescriptors* descriptors)
+{
+    ANN(allocator);
+    ANN(slots);
+    ANN(descriptors);
+    if (_dvz_descriptors_allocated(descriptors))
+    {
+        log_error("cannot allocate descriptors twice into the same wrapper");
+        return 1;
+    }
+    if (dvz_slots_device(slots) != allocator->device)
+    {
+        log_error("cannot allocate descriptors for slots of another device");
+        return 1;
+    }
+
+    DvzDescriptorChain* chain = _descriptor_chain_find(allocator, slots);
+    if (chain == NULL)
+        chain = _descriptor_chain_create(allocator, slots);
+    if (chain == NULL)
+        return 1;
+
+    dvz_memset(descriptors, sizeof(DvzDescriptors), 0, sizeof(DvzDescriptors));
+    if (chain->free_count > 0)
+    {
+        chain->free_count--;
+        dvz_memcpy(
+            descriptors->vk_descriptors, sizeof(descriptors->vk_descriptors),
+            &chain->free_sets[(size_t)chain->free_count * chain->set_count],
+            chain->set_count * sizeof(VkDescriptorSet));
+        allocator->recycled++;
+    }
+    else if (!_descriptor_chain_allocate(chain, descriptors->vk_descriptors))
+    {
+        return 1;
+    }
+
+    descriptors->device = allocator->device;
+    descriptors->slots = slots;
+    descriptors->chain = chain;
+    descriptors->set_count = chain->set_count;
+    chain->live++;
+    allocator->allocations++;
+    return 0;
+}
+
+
+
+/**
+ * Release the pool chain of a slots object before the slots are destroyed.
+ *
+ * @param allocator the descriptor allocator
+ * @param slots the slots about to be destroyed
+ */
+void dvz_descriptor_allocator_release(DvzDescriptorAllocator* allocator, DvzSlots* slots)
+{
+    if (allocator == NULL || slots == NULL)
+        return;
+    DvzDescriptorChain* chain = _descriptor_chain_find(allocator, slots);
+    if (chain == NULL)
+        return;
+    if (chain->live == 0)
+    {
+        _descriptor_chain_destroy(chain);
+        return;
+    }
+    chain->retired = true;
+    chain->free_count = 0;
+}
+
+
+
+/**
+ * Return descriptor allocator counters.
+ *
+ * @param allocator the descriptor allocator
+ * @return the allocator statistics
+ */
+DvzDescriptorAllocatorStats dvz_descriptor_allocator_stats(DvzDescriptorAllocator* allocator)
+{
+    ANN(allocator);
+    DvzDescriptorAllocatorStats stats = {0};
+    stats.allocations = allocator->allocations;
+    stats.recycled = allocator->recycled;
+    for (uint32_t i = 0; i < allocator->chain_count; i++)
+    {
+        DvzDescriptorChain* chain = allocator->chains[i];
+        stats.layout_count += chain->retired ? 0 : 1;
+        stats.pool_count += chain->pool_count;
+        stats.live_groups += chain->live;
+        stats.free_groups += chain->free_count;
+    }
+    return stats;
+}
+
+
+
+/**
+ * Destroy a descriptor allocator and all its pools.
+ *
+ * @param allocator the descriptor allocator
+ */
+void dvz_descriptor_allocator_destroy(DvzDescriptorAllocator* allocator)
+{
+    if (allocator == NULL)
+        return;
+    while (allocator->chain_count > 0)
+    {
+        DvzDescriptorChain* chain = allocator->chains[allocator->chain_count - 1];
+        if (chain->live > 0)
+            log_warn("destroying a descriptor pool chain with %u live wrappers", chain->live);
+        _descriptor_chain_destroy(chain);
+    }
+    dvz_free(allocator->chains);
+    dvz_free(allocator);
+}
+
+
+
 /**
  * Free a descriptor wrapper allocated by dvz_descriptors_create().
  *
@@ -235,7 +609,11 @@ void dvz_descriptors_free(DvzDescriptors* descriptors)
     {
         return;
     }
-    if (descriptors->device != NULL && descriptors->vk_pool != VK_NULL_HANDLE &&
+    if (descriptors->chain != NULL)
+    {
+        _descriptor_chain_recycle(descriptors->chain, descriptors->vk_descriptors);
+    }
+    else if (descriptors->device != NULL && descriptors->vk_pool != VK_NULL_HANDLE &&
         descriptors->set_count > 0)
     {
         VkDevice vkd = dvz_device_handle(descriptors->device);
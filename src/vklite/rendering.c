@@ -127,6 +127,20 @@ void dvz_rendering_layers(DvzRendering* rendering, uint32_t count)
 
 
 
+/**
+ * Set the Vulkan rendering flags of a rendering.
+ *
+ * @param rendering the rendering
+ * @param flags the rendering flags
+ */
+void dvz_rendering_flags(DvzRendering* rendering, VkRenderingFlags flags)
+{
+    ANN(rendering);
+    rendering->info.flags = flags;
+}
+
+
+
 /**
  * Return the number of configured color attachments.
  *
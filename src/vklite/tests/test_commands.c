@@ -229,6 +229,52 @@ int test_vklite_timeline_wait_blocks_until_signal(TstContext* suite, const TstCa
 
 
 
+int test_vklite_commands_submit_async_signals_timeline(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+    ANN(tstitem);
+
+    DvzGpuCtx* ctx = _commands_ctx(suite);
+    ANN(ctx);
+
+    DvzDevice* device = dvz_gpu_ctx_device(ctx);
+    DvzQueue* queue = dvz_device_queue(device, DVZ_QUEUE_MAIN);
+    ANN(device);
+    ANN(queue);
+
+    DvzSemaphore* timeline = dvz_semaphore_create_wrapper();
+    ANN(timeline);
+    dvz_semaphore_timeline(device, 0, timeline, 0);
+
+    DvzCommands* cmds[2] = {dvz_commands_create_wrapper(), dvz_commands_create_wrapper()};
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        ANN(cmds[i]);
+        dvz_commands(device, queue, 1, cmds[i]);
+        dvz_cmd_begin(cmds[i]);
+        dvz_cmd_end(cmds[i]);
+        AT(dvz_cmd_submit_async(cmds[i], timeline, i + 1) == 0);
+    }
+
+    // Both submissions are in flight at once; waiting on the last value covers the first.
+    dvz_semaphore_wait(timeline, 2);
+    AT(dvz_semaphore_query(timeline) == 2);
+
+    uint32_t err_count = dvz_gpu_ctx_error_count(ctx);
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        dvz_commands_destroy(cmds[i]);
+        dvz_commands_free(cmds[i]);
+    }
+    dvz_semaphore_destroy(timeline);
+    dvz_semaphore_free(timeline);
+    dvz_gpu_ctx_destroy(ctx);
+
+    return err_count > 0;
+}
+
+
+
 int test_vklite_commands_destroy_without_recording(TstContext* suite, const TstCase* tstitem)
 {
     ANN(suite);
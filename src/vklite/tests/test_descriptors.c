@@ -146,6 +146,74 @@ int test_vklite_descriptors_1(TstContext* suite, const TstCase* tstitem)
 
 
 
+int test_vklite_descriptors_pooled(TstContext* suite, const TstCase* tstitem)
+{
+    ANN(suite);
+    ANN(tstitem);
+
+    // Bootstrap.
+    DvzGpuCtxConfig cfg = dvz_testing_gpu_ctx_config(suite);
+    DvzGpuCtx* ctx = dvz_gpu_ctx(&cfg);
+    ANN(ctx);
+
+    DvzSlots* slots = dvz_slots_create_wrapper();
+    ANN(slots);
+    dvz_slots(dvz_gpu_ctx_device(ctx), slots);
+    dvz_slots_binding(slots, 0, 0, 1, VK_SHADER_STAGE_ALL, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+    dvz_slots_binding(slots, 1, 0, 1, VK_SHADER_STAGE_ALL, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER);
+    AT(dvz_slots_create(slots) == 0);
+
+    DvzDescriptorAllocator* allocator = dvz_descriptor_allocator(dvz_gpu_ctx_device(ctx));
+    ANN(allocator);
+
+    // More wrappers than the first pool holds: the chain grows a second pool.
+    DvzDescriptors* desc[40] = {0};
+    for (uint32_t i = 0; i < 40; i++)
+    {
+        desc[i] = dvz_descriptors_create_wrapper();
+        ANN(desc[i]);
+        AT(dvz_descriptors_pooled(allocator, slots, desc[i]) == 0);
+        AT(dvz_descriptors_set_count(desc[i]) == 2);
+        AT(dvz_descriptors_handle(desc[i], 1) != VK_NULL_HANDLE);
+    }
+    DvzDescriptorAllocatorStats stats = dvz_descriptor_allocator_stats(allocator);
+    AT(stats.layout_count == 1);
+    AT(stats.pool_count == 2);
+    AT(stats.live_groups == 40);
+
+    // Freed sets are handed back before any new pool is created.
+    VkDescriptorSet set0 = dvz_descriptors_handle(desc[39], 0);
+    dvz_descriptors_free(desc[39]);
+    desc[39] = dvz_descriptors_create_wrapper();
+    AT(dvz_descriptors_pooled(allocator, slots, desc[39]) == 0);
+    AT(dvz_descriptors_handle(desc[39], 0) == set0);
+    stats = dvz_descriptor_allocator_stats(allocator);
+    AT(stats.recycled == 1);
+    AT(stats.pool_count == 2);
+
+    // Releasing the slots keeps the pools until the last live wrapper is freed.
+    dvz_descriptor_allocator_release(allocator, slots);
+    stats = dvz_descriptor_allocator_stats(allocator);
+    AT(stats.layout_count == 0);
+    AT(stats.pool_count == 2);
+    for (uint32_t i = 0; i < 40; i++)
+        dvz_descriptors_free(desc[i]);
+    stats = dvz_descriptor_allocator_stats(allocator);
+    AT(stats.pool_count == 0);
+    AT(stats.live_groups == 0);
+
+    // Cleanup.
+    dvz_descriptor_allocator_destroy(allocator);
+    dvz_slots_destroy(slots);
+    dvz_slots_free(slots);
+    uint32_t err_count = dvz_gpu_ctx_error_count(ctx);
+    dvz_gpu_ctx_destroy(ctx);
+
+    return err_count > 0;
+}
+
+
+
 int test_vklite_rendering_reset(TstContext* suite, const TstCase* tstitem)
 {
     ANN(suite);
@@ -77,6 +77,7 @@ int test_vklite(TstSuite* suite)
     TST_VKLITE_CASE(test_vklite_commands_repeat_submit);
     TST_VKLITE_CASE(test_vklite_commands_destroy_idempotent);
     TST_VKLITE_CASE(test_vklite_timeline_wait_blocks_until_signal);
+    TST_VKLITE_CASE(test_vklite_commands_submit_async_signals_timeline);
     TST_VKLITE_CASE(test_vklite_commands_destroy_without_recording);
     TST_VKLITE_CASE(test_vklite_commands_borrowed_recording_rejects_lifecycle);
     TST_VKLITE_CASE(test_vklite_commands_borrowed_recording_unwrap);
@@ -96,6 +97,7 @@ int test_vklite(TstSuite* suite)
     TST_VKLITE_CASE(test_vklite_images_1);
     TST_VKLITE_CASE(test_vklite_images_create_requires_destroy);
     TST_VKLITE_CASE(test_vklite_descriptors_1);
+    TST_VKLITE_CASE(test_vklite_descriptors_pooled);
     TST_VKLITE_CASE(test_vklite_rendering_reset);
     TST_VKLITE_CASE(test_vklite_graphics_1);
     TST_VKLITE_CASE(test_vklite_graphics_spec_bounds);
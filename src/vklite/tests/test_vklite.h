@@ -85,6 +85,8 @@ int test_vklite_commands_1(TstContext* suite, const TstCase* tstitem);
 int test_vklite_commands_repeat_submit(TstContext* suite, const TstCase* tstitem);
 int test_vklite_commands_destroy_idempotent(TstContext* suite, const TstCase* tstitem);
 int test_vklite_timeline_wait_blocks_until_signal(TstContext* suite, const TstCase* tstitem);
+int test_vklite_commands_submit_async_signals_timeline(
+    TstContext* suite, const TstCase* tstitem);
 int test_vklite_commands_destroy_without_recording(TstContext* suite, const TstCase* tstitem);
 int test_vklite_commands_borrowed_recording_rejects_lifecycle(
     TstContext* suite, const TstCase* tstitem);
@@ -115,6 +117,7 @@ int test_vklite_images_1(TstContext* suite, const TstCase* tstitem);
 int test_vklite_images_create_requires_destroy(TstContext* suite, const TstCase* tstitem);
 
 int test_vklite_descriptors_1(TstContext* suite, const TstCase* tstitem);
+int test_vklite_descriptors_pooled(TstContext* suite, const TstCase* tstitem);
 int test_vklite_rendering_reset(TstContext* suite, const TstCase* tstitem);
 
 int test_vklite_graphics_1(TstContext* suite, const TstCase* tstitem);
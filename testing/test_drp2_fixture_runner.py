@@ -26,7 +26,7 @@ def test_drp2_fixture_runner_can_filter_schema_negatives() -> None:
     fixtures = runner.discover(['spec/drp2/fixtures/negative_schema'], None, ['schema'])
     results = runner.run_fixtures(fixtures)
 
-    assert len(results) == 5
+    assert len(results) == 6
     assert all(result.passed for result in results)
     assert all(result.actual_phase == 'schema_validation' for result in results)
 
@@ -1060,12 +1060,73 @@ class DRP2SemanticValidator:
                 f'render pass {pass_info["id"]} has no bound index buffer',
             )
 
+    def _check_indirect_buffer(
+        self, index: int, pass_info: Dict[str, Any], command: Dict[str, Any], record_size: int
+    ) -> None:
+        buffer_state = self._buffer_usage(index, command['buffer_id'], 'INDIRECT')
+        draw_count = command.get('draw_count', 1)
+        stride = command.get('stride', 0) or record_size
+        if stride < record_size:
+            raise SemanticFailure(
+                'DRP2_ERR_INVALID_ARGUMENT',
+                index,
+                f'indirect stride {stride} is smaller than the {record_size}-byte record',
+            )
+        self._check_buffer_range(
+            index, buffer_state, command['offset'], (draw_count - 1) * stride + record_size
+        )
+        encoder = self.encoders[pass_info['encoder_id']]
+        encoder['resources'].add(('buffer', command['buffer_id']))
+
+    def _handle_DrawIndirect(self, index: int, command: Dict[str, Any]) -> None:
+        pass_info = self._require_active_pass_for_command(
+            index, command['pass_id'], expected_kind='render'
+        )
+        self._require_bound_pipeline(index, pass_info)
+        pipeline = self._resolve_live(index, pass_info['bound_pipeline_id'], 'pipeline')
+        for slot in range(pipeline.data['vertex_buffer_slots']):
+            if slot not in pass_info['vertex_buffers']:
+                raise SemanticFailure(
+                    'DRP2_ERR_INVALID_STATE',
+                    index,
+                    f'render pass {pass_info["id"]} is missing vertex buffer slot {slot}',
+                )
+        self._check_indirect_buffer(index, pass_info, command, 16)
+
+    def _handle_DrawIndexedIndirect(self, index: int, command: Dict[str, Any]) -> None:
+        pass_info = self._require_active_pass_for_command(
+            index, command['pass_id'], expected_kind='render'
+        )
+        self._require_bound_pipeline(index, pass_info)
+        pipeline = self._resolve_live(index, pass_info['bound_pipeline_id'], 'pipeline')
+        for slot in range(pipeline.data['vertex_buffer_slots']):
+            if slot not in pass_info['vertex_buffers']:
+                raise SemanticFailure(
+                    'DRP2_ERR_INVALID_STATE',
+                    index,
+                    f'render pass {pass_info["id"]} is missing vertex buffer slot {slot}',
+                )
+        if pass_info['index_buffer'] is None:
+            raise SemanticFailure(
+                'DRP2_ERR_INVALID_STATE',
+                index,
+                f'render pass {pass_info["id"]} has no bound index buffer',
+            )
+        self._check_indirect_buffer(index, pass_info, command, 20)
+
     def _handle_DispatchWorkgroups(self, index: int, command: Dict[str, Any]) -> None:
         pass_info = self._require_active_pass_for_command(
             index, command['pass_id'], expected_kind='compute'
         )
         self._require_bound_pipeline(index, pass_info)
 
+    def _handle_DispatchWorkgroupsIndirect(self, index: int, command: Dict[str, Any]) -> None:
+        pass_info = self._require_active_pass_for_command(
+            index, command['pass_id'], expected_kind='compute'
+        )
+        self._require_bound_pipeline(index, pass_info)
+        self._check_indirect_buffer(index, pass_info, command, 12)
+
     def _handle_ResourceBarrier(self, index: int, command: Dict[str, Any]) -> None:
         encoder = self._resolve_encoder(index, command['encoder_id'])
         if encoder['open_pass'] is not None:
@@ -1079,6 +1140,8 @@ class DRP2SemanticValidator:
             self._buffer_usage(index, command['buffer_id'], 'VERTEX')
         elif command['dst_stage'] == 'COPY' and command['dst_access'] == 'COPY_READ':
             self._buffer_usage(index, command['buffer_id'], 'COPY_SRC')
+        elif command['dst_stage'] == 'DRAW_INDIRECT' and command['dst_access'] == 'INDIRECT_READ':
+            self._buffer_usage(index, command['buffer_id'], 'INDIRECT')
         else:
             raise SemanticFailure('DRP2_ERR_USAGE', index, 'unsupported ResourceBarrier destination')
         offset = command.get('offset', 0)
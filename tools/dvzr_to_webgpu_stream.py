@@ -23,6 +23,7 @@ BUFFER_USAGE = [
     (0x0020, "INDEX"),
     (0x0040, "UNIFORM"),
     (0x0080, "STORAGE"),
+    (0x0100, "INDIRECT"),
 ]
 
 TEXTURE_USAGE = [
@@ -564,6 +565,8 @@ def _convert_command(
         return [{"cmd": "Draw", "pass_id": ids.map(int(command["pass_id"])), "vertex_count": int(command["vertex_count"]), "instance_count": int(command.get("instance_count", 1)), "first_vertex": int(command.get("first_vertex", 0)), "first_instance": int(command.get("first_instance", 0))}]
     if op == "DrawIndexed":
         return [{"cmd": "DrawIndexed", "pass_id": ids.map(int(command["pass_id"])), "index_count": int(command["index_count"]), "instance_count": int(command.get("instance_count", 1)), "first_index": int(command.get("first_index", 0)), "base_vertex": int(command.get("base_vertex", 0)), "first_instance": int(command.get("first_instance", 0))}]
+    if op in ("DrawIndirect", "DrawIndexedIndirect"):
+        return [{"cmd": op, "pass_id": ids.map(int(command["pass_id"])), "buffer_id": ids.map(int(command["buffer_id"])), "offset": int(command.get("offset", 0)), "draw_count": int(command.get("draw_count", 1)), "stride": int(command.get("stride", 0))}]
     if op == "EndRenderPass":
         return [{"cmd": "EndRenderPass", "pass_id": ids.map(int(command["pass_id"]))}]
     if op == "FinishCommandEncoder":
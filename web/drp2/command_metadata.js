@@ -44,4 +44,7 @@ export const COMMAND_NAMES = [
   "FinishCommandEncoder",
   "QueueSubmit",
   "QueueSubmitReply",
+  "DrawIndirect",
+  "DrawIndexedIndirect",
+  "DispatchWorkgroupsIndirect",
 ];
@@ -277,6 +277,9 @@ function mapBufferUsage(usage) {
       case "STORAGE":
         flags |= GPUBufferUsage.STORAGE;
         break;
+      case "INDIRECT":
+        flags |= GPUBufferUsage.INDIRECT;
+        break;
       case "MAP_READ":
         flags |= GPUBufferUsage.MAP_READ;
         break;
@@ -1126,7 +1129,10 @@ const SUPPORTED_DRP2_COMMANDS = new Set([
   "SetStencilReference",
   "Draw",
   "DrawIndexed",
+  "DrawIndirect",
+  "DrawIndexedIndirect",
   "DispatchWorkgroups",
+  "DispatchWorkgroupsIndirect",
   "ResourceBarrier",
   "CopyBufferToBuffer",
   "CopyBufferToTexture",
@@ -2314,8 +2320,11 @@ const FRAME_PHASE_COMMANDS = new Set([
   "SetIndexBuffer",
   "Draw",
   "DrawIndexed",
+  "DrawIndirect",
+  "DrawIndexedIndirect",
   "EndRenderPass",
   "DispatchWorkgroups",
+  "DispatchWorkgroupsIndirect",
   "EndComputePass",
   "ResourceBarrier",
   "CopyBufferToBuffer",
@@ -3316,6 +3325,54 @@ export async function executeDrp2Stream(device, context, canvasFormat, stream, o
         break;
       }
 
+      case "DrawIndirect":
+      case "DrawIndexedIndirect": {
+        const indexed = command.cmd === "DrawIndexedIndirect";
+        const passRecord = required(passes.get(command.pass_id), `unknown pass ${command.pass_id}`);
+        if (passRecord.kind !== "render") {
+          throw new Error(`${command.cmd} requires a render pass`);
+        }
+        if (indexed) {
+          validateIndexedDrawState(passRecord);
+        } else {
+          validateRenderDrawState(passRecord);
+        }
+        const buffer = required(
+          buffers.get(command.buffer_id),
+          `unknown buffer ${command.buffer_id}`,
+        );
+        requireUsage(requireLiveRecord(state, command.buffer_id, "buffer"), "INDIRECT");
+        addEncoderRef(state, encoderRefs, passRecord.encoderId, command.buffer_id, "buffer");
+        // WebGPU has no multi-draw-indirect, so multi-draw records are replayed one by one.
+        const drawCount = command.draw_count ?? 1;
+        const stride = command.stride || (indexed ? 20 : 16);
+        for (let i = 0; i < drawCount; i++) {
+          const offset = (command.offset ?? 0) + i * stride;
+          if (indexed) {
+            passRecord.pass.drawIndexedIndirect(buffer, offset);
+          } else {
+            passRecord.pass.drawIndirect(buffer, offset);
+          }
+        }
+        break;
+      }
+
+      case "DispatchWorkgroupsIndirect": {
+        const passRecord = required(passes.get(command.pass_id), `unknown pass ${command.pass_id}`);
+        if (passRecord.kind !== "compute") {
+          throw new Error("DispatchWorkgroupsIndirect requires a compute pass");
+        }
+        requireBoundPipeline(passRecord);
+        const buffer = required(
+          buffers.get(command.buffer_id),
+          `unknown buffer ${command.buffer_id}`,
+        );
+        requireUsage(requireLiveRecord(state, command.buffer_id, "buffer"), "INDIRECT");
+        addEncoderRef(state, encoderRefs, passRecord.encoderId, command.buffer_id, "buffer");
+        passRecord.pass.dispatchWorkgroupsIndirect(buffer, command.offset ?? 0);
+        break;
+      }
+
       case "DispatchWorkgroups": {
         const passRecord = required(passes.get(command.pass_id), `unknown pass ${command.pass_id}`);
         if (passRecord.kind !== "compute") {
@@ -3358,6 +3415,11 @@ export async function executeDrp2Stream(device, context, canvasFormat, stream, o
           requireUsage(bufferRecord, "VERTEX");
         } else if (command.dst_stage === "COPY" && command.dst_access === "COPY_READ") {
           requireUsage(bufferRecord, "COPY_SRC");
+        } else if (
+          command.dst_stage === "DRAW_INDIRECT" &&
+          command.dst_access === "INDIRECT_READ"
+        ) {
+          requireUsage(bufferRecord, "INDIRECT");
         } else {
           throw new Error("unsupported ResourceBarrier destination");
         }